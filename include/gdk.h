@@ -38,9 +38,18 @@ typedef struct GA_json GA_json;
 /** An api method call that potentially requires two factor authentication to complete */
 struct GA_auth_handler;
 
+/** A read-only columnar view of a list of transactions */
+struct GA_transaction_list;
+
+/** A pre-parsed path into a JSON object */
+struct GA_json_path;
+
 /** A notification handler */
 typedef void (*GA_notification_handler)(void* context, GA_json* details);
 
+/** A completion handler for `GA_auth_handler_call_async` */
+typedef void (*GA_auth_handler_notify)(void* context, struct GA_auth_handler* call, int result, GA_json* output);
+
 /**
  * Perform one-time initialization of the library. This call must be made once
  * only before calling any other GDK functions, including any functions called
@@ -142,6 +151,44 @@ GDK_API int GA_reconnect_hint(struct GA_session* session, const GA_json* hint);
  */
 GDK_API int GA_get_proxy_settings(struct GA_session* session, GA_json** output);
 
+/**
+ * Get metrics describing the delivery of notifications for the given session.
+ *
+ * :param session: The session to use.
+ * :param output: Destination for the output :ref:`notification-metrics`.
+ *|     Returned GA_json should be freed using `GA_destroy_json`.
+ */
+GDK_API int GA_get_notification_metrics(struct GA_session* session, GA_json** output);
+
+/**
+ * Get call counts and latencies for the given session's API and server calls.
+ *
+ * :param session: The session to use.
+ * :param output: Destination for the output :ref:`session-metrics`.
+ *|     Returned GA_json should be freed using `GA_destroy_json`.
+ */
+GDK_API int GA_get_metrics(struct GA_session* session, GA_json** output);
+
+/**
+ * Get the approximate memory held by the given session's caches.
+ *
+ * :param session: The session to use.
+ * :param output: Destination for the output :ref:`session-memory-usage`.
+ *|     Returned GA_json should be freed using `GA_destroy_json`.
+ */
+GDK_API int GA_get_memory_usage(struct GA_session* session, GA_json** output);
+
+/**
+ * Release cached data held by the given session that can be recreated on demand.
+ *
+ * Intended to be called when the system is low on memory, for example from
+ * Android's ``onTrimMemory``. Subsequent calls may be slower while the released
+ * data is fetched or computed again.
+ *
+ * :param session: The session to use.
+ */
+GDK_API int GA_trim_memory(struct GA_session* session);
+
 /**
  * Compute a hashed wallet identifier from a BIP32 xpub or mnemonic.
  *
@@ -425,6 +472,19 @@ GDK_API int GA_get_unspent_outputs(struct GA_session* session, GA_json* details,
 GDK_API int GA_get_unspent_outputs_for_private_key(
     struct GA_session* session, const char* private_key, const char* password, uint32_t unused, GA_json** utxos);
 
+/**
+ * Get the unspent transaction outputs associated with several non-wallet private keys.
+ *
+ * :param session: The session to use.
+ * :param details: :ref:`sweep-private-keys-details` containing the keys to look up.
+ * :param output: Destination for the resulting :ref:`sweep-private-keys-result`.
+ *|     Returned GA_json should be freed using `GA_destroy_json`.
+ *
+ * .. note:: Neither the private keys or their derived public keys are transmitted.
+ */
+GDK_API int GA_get_unspent_outputs_for_private_keys(
+    struct GA_session* session, const GA_json* details, GA_json** output);
+
 /**
  * Change the status of a user's unspent transaction outputs.
  *
@@ -479,6 +539,26 @@ GDK_API int GA_get_available_currencies(struct GA_session* session, GA_json** cu
  */
 GDK_API int GA_convert_amount(struct GA_session* session, const GA_json* value_details, GA_json** output);
 
+/** The size of each value written by `GA_convert_amounts`, including its NUL terminator */
+#define GA_AMOUNT_STR_LEN 32
+
+/**
+ * Convert an array of satoshi values to a single denomination in one call.
+ *
+ * :param session: The session to use.
+ * :param satoshi: The satoshi values to convert.
+ * :param num_values: The number of values in ``satoshi``.
+ * :param denomination: The denomination to convert to: one of ``"btc"``, ``"mbtc"``,
+ *|     ``"ubtc"``, ``"bits"``, ``"sats"`` or ``"fiat"``.
+ * :param output: Destination for the converted values, which must hold ``num_values``
+ *|     entries of ``GA_AMOUNT_STR_LEN`` chars. Each value is written NUL terminated
+ *|     to its entry, formatted as `GA_convert_amount` formats it.
+ *
+ * Fiat values are converted using the session's current exchange rate.
+ */
+GDK_API int GA_convert_amounts(
+    struct GA_session* session, const int64_t* satoshi, size_t num_values, const char* denomination, char* output);
+
 /**
  * Encrypt JSON with a server provided key protected by a PIN.
  *
@@ -776,6 +856,17 @@ GDK_API int GA_convert_json_to_string(const GA_json* json, char** output);
 
 GDK_API int GA_convert_string_to_json(const char* input, GA_json** output);
 
+/**
+ * Serialize a JSON object as msgpack, which is faster to produce and to
+ * parse than its string representation.
+ *
+ * :param json: The JSON object to serialize.
+ * :param output: Destination for the msgpack encoded bytes.
+ *|     Returned bytes should be freed using `GA_destroy_bytes`.
+ * :param output_len: Destination for the number of bytes in ``output``.
+ */
+GDK_API int GA_convert_json_to_msgpack(const GA_json* json, unsigned char** output, size_t* output_len);
+
 GDK_API int GA_convert_json_value_to_string(const GA_json* json, const char* path, char** output);
 
 GDK_API int GA_convert_json_value_to_uint32(const GA_json* json, const char* path, uint32_t* output);
@@ -786,6 +877,64 @@ GDK_API int GA_convert_json_value_to_bool(const GA_json* json, const char* path,
 
 GDK_API int GA_convert_json_value_to_json(const GA_json* json, const char* path, GA_json** output);
 
+/**
+ * Parse a path for repeated lookups into JSON objects.
+ *
+ * :param path: The path to parse. Paths beginning with "/" are JSON pointers,
+ *|     e.g. "/satoshi/btc" or "/transactions/0/txhash". Any other non-empty
+ *|     path is a single key, as used by `GA_convert_json_value_to_string` and
+ *|     related calls. The empty path refers to the JSON object itself.
+ * :param output: Destination for the resulting path.
+ *|     Returned GA_json_path should be freed using `GA_destroy_json_path`.
+ */
+GDK_API int GA_create_json_path(const char* path, struct GA_json_path** output);
+
+GDK_API int GA_convert_json_path_value_to_string(
+    const GA_json* json, const struct GA_json_path* path, char** output);
+
+GDK_API int GA_convert_json_path_value_to_uint32(
+    const GA_json* json, const struct GA_json_path* path, uint32_t* output);
+
+GDK_API int GA_convert_json_path_value_to_uint64(
+    const GA_json* json, const struct GA_json_path* path, uint64_t* output);
+
+GDK_API int GA_convert_json_path_value_to_bool(
+    const GA_json* json, const struct GA_json_path* path, uint32_t* output);
+
+GDK_API int GA_convert_json_path_value_to_json(
+    const GA_json* json, const struct GA_json_path* path, GA_json** output);
+
+/**
+ * Get a value from each element of a JSON array in a single call.
+ *
+ * :param json: The JSON object containing the array.
+ * :param array_path: The path of the array within ``json``.
+ * :param path: The path of the value to get within each array element.
+ * :param output: Destination for the values. Elements without a value are set to 0.
+ * :param output_len: The number of values ``output`` can hold.
+ * :param written: Destination for the number of elements in the array. If this
+ *|     is greater than ``output_len``, only the first ``output_len`` values are written.
+ */
+GDK_API int GA_convert_json_path_values_to_uint64(const GA_json* json, const struct GA_json_path* array_path,
+    const struct GA_json_path* path, uint64_t* output, size_t output_len, size_t* written);
+
+GDK_API int GA_convert_json_path_values_to_uint32(const GA_json* json, const struct GA_json_path* array_path,
+    const struct GA_json_path* path, uint32_t* output, size_t output_len, size_t* written);
+
+/**
+ * As `GA_convert_json_path_values_to_uint64`, for string values.
+ * Each returned string should be freed using `GA_destroy_string`.
+ */
+GDK_API int GA_convert_json_path_values_to_string(const GA_json* json, const struct GA_json_path* array_path,
+    const struct GA_json_path* path, char** output, size_t output_len, size_t* written);
+
+/**
+ * Free a GA_json_path object.
+ *
+ * :param path: GA_json_path object to free.
+ */
+GDK_API int GA_destroy_json_path(struct GA_json_path* path);
+
 /**
  * Free a GA_json object.
  *
@@ -793,6 +942,56 @@ GDK_API int GA_convert_json_value_to_json(const GA_json* json, const char* path,
  */
 GDK_API int GA_destroy_json(GA_json* json);
 
+/**
+ * Create a columnar view of a list of transactions.
+ *
+ * :param transactions: The :ref:`tx-list` result of `GA_get_transactions`,
+ *|     or its "transactions" array.
+ * :param output: Destination for the resulting transaction list.
+ *|     Returned GA_transaction_list should be freed using `GA_destroy_transaction_list`.
+ *
+ * The list copies the commonly displayed fields of each transaction, allowing
+ * them to be accessed by index without walking or serializing the JSON.
+ * Strings returned from the accessors below are owned by the list and
+ * remain valid until it is destroyed; they must not be freed by the caller.
+ */
+GDK_API int GA_create_transaction_list(const GA_json* transactions, struct GA_transaction_list** output);
+
+GDK_API int GA_transaction_list_get_size(const struct GA_transaction_list* list, size_t* output);
+
+GDK_API int GA_transaction_list_get_txhash(const struct GA_transaction_list* list, size_t index, const char** output);
+
+GDK_API int GA_transaction_list_get_type(const struct GA_transaction_list* list, size_t index, const char** output);
+
+GDK_API int GA_transaction_list_get_spv_verified(
+    const struct GA_transaction_list* list, size_t index, const char** output);
+
+GDK_API int GA_transaction_list_get_created_at_ts(
+    const struct GA_transaction_list* list, size_t index, uint64_t* output);
+
+GDK_API int GA_transaction_list_get_block_height(
+    const struct GA_transaction_list* list, size_t index, uint32_t* output);
+
+GDK_API int GA_transaction_list_get_fee(const struct GA_transaction_list* list, size_t index, uint64_t* output);
+
+GDK_API int GA_transaction_list_get_num_assets(const struct GA_transaction_list* list, size_t index, size_t* output);
+
+GDK_API int GA_transaction_list_get_asset(const struct GA_transaction_list* list, size_t index, size_t asset_index,
+    const char** asset_id, int64_t* satoshi);
+
+/**
+ * Get the net amount of an asset for a transaction, or 0 if the transaction doesn't involve it.
+ */
+GDK_API int GA_transaction_list_get_satoshi(
+    const struct GA_transaction_list* list, size_t index, const char* asset_id, int64_t* output);
+
+/**
+ * Free a GA_transaction_list object.
+ *
+ * :param list: GA_transaction_list object to free.
+ */
+GDK_API int GA_destroy_transaction_list(struct GA_transaction_list* list);
+
 #endif /* SWIG */
 
 /**
@@ -871,6 +1070,32 @@ GDK_API int GA_auth_handler_resolve_code(struct GA_auth_handler* call, const cha
  */
 GDK_API int GA_auth_handler_call(struct GA_auth_handler* call);
 
+#ifndef SWIG
+/**
+ * Perform an action following the completion of authorization, without
+ * blocking the calling thread.
+ *
+ * :param call: The auth_handler representing the action to perform.
+ * :param handler: The handler to call when the action has been performed.
+ * :param context: A context pointer to be passed to the handler.
+ *
+ * The action is performed as `GA_auth_handler_call` would perform it, on a
+ * thread from a pool shared by all sessions (see :ref:`init-config-arg`).
+ * ``handler`` is then called from that thread with the value that
+ * `GA_auth_handler_call` would have returned. If this is ``GA_OK``, ``output``
+ * holds the new status of ``call`` as returned by `GA_auth_handler_get_status`,
+ * otherwise it holds the error details as returned by
+ * `GA_get_thread_error_details`. The ``GA_json`` object passed to the handler
+ * must be destroyed by the caller using `GA_destroy_json`.
+ *
+ * ``call`` must not be used or destroyed until its handler has been called.
+ * The handler may continue to drive ``call``, for example by calling this
+ * function again, but should not otherwise block, since this holds up other
+ * pending calls.
+ */
+GDK_API int GA_auth_handler_call_async(struct GA_auth_handler* call, GA_auth_handler_notify handler, void* context);
+#endif
+
 /**
  * Free an auth_handler after use.
  *
@@ -988,6 +1213,13 @@ GDK_API int GA_bcur_decode(struct GA_session* session, GA_json* details, struct
  * :param str: The string to free.
  */
 GDK_API void GA_destroy_string(char* str);
+
+/**
+ * Free bytes returned by the api.
+ *
+ * :param bytes: The bytes to free.
+ */
+GDK_API void GA_destroy_bytes(unsigned char* bytes);
 #endif /* SWIG */
 
 /**
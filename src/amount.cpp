@@ -1,6 +1,7 @@
 #include <cctype>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
 #include "exception.hpp"
@@ -29,10 +30,38 @@ namespace sdk {
         static const std::vector<std::string> NON_SATOSHI_KEYS{ "btc", "mbtc", "ubtc", "bits", "sats", "fiat",
             "fiat_currency", "fiat_rate", "is_current" };
 
+        static const conversion_type HALF_CENT("0.5");
+        static const conversion_type MAX_CENTS(std::numeric_limits<amount::signed_value_type>::max());
+
         template <typename T> static std::string fmt(const T& fiat, size_t dp = 2)
         {
             return fiat_type(fiat).str(dp, std::ios_base::fixed | std::ios_base::showpoint);
         }
+
+        // Format a fiat value into buf as fmt() does, rounding half to even
+        static size_t format_fiat(const conversion_type& fiat, char* buf)
+        {
+            const bool is_negative = fiat < 0;
+            const conversion_type cents = (is_negative ? conversion_type(-fiat) : fiat) * COIN_VALUE_100;
+            if (cents >= MAX_CENTS) {
+                // Too large for fixed point: format using multiprecision
+                const std::string str = fmt(fiat);
+                GDK_RUNTIME_ASSERT(str.size() < amount::str_len);
+                std::memcpy(buf, str.c_str(), str.size() + 1);
+                return str.size();
+            }
+            const conversion_type whole_cents = trunc(cents);
+            const conversion_type remainder = cents - whole_cents;
+            auto value = whole_cents.convert_to<amount::signed_value_type>();
+            if (remainder > HALF_CENT || (remainder == HALF_CENT && (value & 1))) {
+                ++value;
+            }
+            char* p = buf;
+            if (is_negative) {
+                *p++ = '-'; // Note that small negative values format as "-0.00"
+            }
+            return amount::format_fixed(value, 2, p) + (p - buf);
+        }
     } // namespace
 
     amount::amount(const nlohmann::json& json_value)
@@ -113,9 +142,10 @@ namespace sdk {
 
         // Then compute the other denominations and fiat amount
         const conversion_type satoshi_conv = conversion_type(satoshi);
-        const std::string btc = fmt(btc_type(satoshi_conv / COIN_VALUE_DECIMAL), 8);
-        const std::string mbtc = fmt(btc_type(satoshi_conv / COIN_VALUE_DECIMAL_MBTC), 5);
-        const std::string ubtc = fmt(btc_type(satoshi_conv / COIN_VALUE_DECIMAL_UBTC), 2);
+        char buf[str_len];
+        const std::string btc(buf, format_fixed(satoshi, 8, buf));
+        const std::string mbtc(buf, format_fixed(satoshi, 5, buf));
+        const std::string ubtc(buf, format_fixed(satoshi, 2, buf));
         const std::string sats = std::to_string(satoshi);
 
         nlohmann::json result = { { "satoshi", satoshi }, { "btc", btc }, { "mbtc", mbtc }, { "ubtc", ubtc },
@@ -124,8 +154,8 @@ namespace sdk {
 
         if (!fiat_rate_used.empty()) {
             result["fiat_rate"] = fiat_rate_used;
-            result["fiat"]
-                = fmt(fiat_type(conversion_type(fiat_rate_used) * conversion_type(satoshi) / COIN_VALUE_DECIMAL));
+            const auto fiat = conversion_type(fiat_rate_used) * satoshi_conv / COIN_VALUE_DECIMAL;
+            result["fiat"] = std::string(buf, format_fiat(fiat, buf));
         }
 
         if (have_asset_info) {
@@ -138,6 +168,69 @@ namespace sdk {
         return result;
     }
 
+    void amount::convert(const signed_value_type* satoshi, size_t num_values, const std::string& denomination,
+        const std::string& fiat_rate, char* output)
+    {
+        size_t dp = 0;
+        const bool is_fiat = denomination == "fiat";
+        if (denomination == "btc") {
+            dp = 8;
+        } else if (denomination == "mbtc") {
+            dp = 5;
+        } else if (denomination == "ubtc" || denomination == "bits") {
+            dp = 2;
+        } else if (!is_fiat && denomination != "sats") {
+            throw user_error("unknown denomination");
+        }
+        conversion_type rate;
+        if (is_fiat) {
+            if (fiat_rate.empty()) {
+                throw user_error(res::id_your_favourite_exchange_rate_is);
+            }
+            rate = conversion_type(fiat_rate);
+        }
+        for (size_t i = 0; i < num_values; ++i, output += str_len) {
+            if (satoshi[i] > SATOSHI_MAX || satoshi[i] < -SATOSHI_MAX) {
+                throw user_error(res::id_invalid_amount);
+            }
+            if (is_fiat) {
+                format_fiat(rate * conversion_type(satoshi[i]) / COIN_VALUE_DECIMAL, output);
+            } else {
+                format_fixed(satoshi[i], dp, output);
+            }
+        }
+    }
+
+    size_t amount::format_fixed(signed_value_type value, size_t dp, char* buf)
+    {
+        GDK_RUNTIME_ASSERT(dp <= 18);
+        // Collect the digits in reverse, padding with zeros so that there
+        // are more digits than decimal places, giving a leading integer digit
+        value_type v = value < 0 ? value_type(0) - static_cast<value_type>(value) : value;
+        char digits[str_len];
+        size_t n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v || n <= dp);
+
+        char* p = buf;
+        if (value < 0) {
+            *p++ = '-';
+        }
+        while (n > dp) {
+            *p++ = digits[--n];
+        }
+        if (dp) {
+            *p++ = '.';
+            while (n) {
+                *p++ = digits[--n];
+            }
+        }
+        *p = '\0';
+        return p - buf;
+    }
+
     void amount::strip_non_satoshi_keys(nlohmann::json& amount_json)
     {
         for (const auto& key : NON_SATOSHI_KEYS) {
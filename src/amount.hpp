@@ -18,6 +18,8 @@ namespace sdk {
 
         static constexpr value_type coin_value = 100000000;
         static constexpr value_type cent = 1000000;
+        // Buffer size for a formatted amount, including its NUL terminator
+        static constexpr size_t str_len = 32;
 
         explicit amount(value_type v = 0)
             : m_value(v)
@@ -35,6 +37,16 @@ namespace sdk {
         static nlohmann::json convert(
             const nlohmann::json& amount_json, const std::string& fiat_currency, const std::string& fiat_rate);
 
+        // Convert satoshi values to the given denomination ("btc", "mbtc", "ubtc",
+        // "bits", "sats" or "fiat"), writing each to consecutive str_len sized
+        // entries of output. Formats as convert() does, without allocating
+        static void convert(const signed_value_type* satoshi, size_t num_values, const std::string& denomination,
+            const std::string& fiat_rate, char* output);
+
+        // Format value / 10^dp with 'dp' decimal places into buf, which must
+        // hold str_len chars. Returns the length written, excluding the NUL
+        static size_t format_fixed(signed_value_type value, size_t dp, char* buf);
+
         // Remove all conversion keys except satoshi
         static void strip_non_satoshi_keys(nlohmann::json& amount_json);
 
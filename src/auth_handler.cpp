@@ -206,7 +206,10 @@ namespace sdk {
                 m_twofactor_data["code"] = m_code;
             }
             try {
-                m_state = call_impl();
+                {
+                    call_metrics::timer timer(m_session_parent.get_api_metrics(), m_name);
+                    m_state = call_impl();
+                }
                 m_attempts_remaining = TWO_FACTOR_ATTEMPTS;
             } catch (...) {
                 // Handle session level exceptions
@@ -236,7 +239,7 @@ namespace sdk {
             // FIXME: Error if the methods time limit is up or we are rate limited
             if (has_retry_counter() && --m_attempts_remaining == 0) {
                 // No more attempts left, caller should try the action again
-                set_error(res::id_invalid_twofactor_code);
+                set_error(std::string(res::id_invalid_twofactor_code));
             } else {
                 // Caller should try entering the code again
                 m_state = state_type::resolve_code;
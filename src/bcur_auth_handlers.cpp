@@ -2,14 +2,14 @@
 #include "assertion.hpp"
 #include "exception.hpp"
 
+#include <algorithm>
 #include <string>
 #ifdef USE_REAL_BCUR
 #include "ga_wally.hpp"
+#include "threading.hpp"
 #include <bc-ur/bc-ur.hpp>
 #else
 namespace ur {
-class UREncoder {
-};
 class URDecoder {
 };
 } // namespace ur
@@ -17,6 +17,15 @@ class URDecoder {
 namespace ga {
 namespace sdk {
 
+#ifdef USE_REAL_BCUR
+    namespace {
+        // Parts are generated by several encoders in parallel, each starting
+        // at the sequence number of the first part in its chunk
+        constexpr size_t MIN_PARTS_PER_THREAD = 16;
+        constexpr size_t MAX_ENCODER_THREADS = 8;
+    } // namespace
+#endif
+
     bcur_encoder_call::bcur_encoder_call(session& session, nlohmann::json details)
         : auth_handler_impl(session, "bcur_encode", std::shared_ptr<signer>())
         , m_details(std::move(details))
@@ -29,18 +38,20 @@ namespace sdk {
         throw user_error("not available");
         return state_type::error;
 #else
-        if (!m_encoder) {
-            std::string ur_type = m_details.at("ur_type");
-            auto cbor = h2b(m_details.at("data"));
-            const auto max_fragment_len = m_details.at("max_fragment_len");
-            auto ur = ur::UR(std::move(ur_type), std::move(cbor));
-            m_encoder = std::make_unique<ur::UREncoder>(std::move(ur), max_fragment_len);
-        }
-        nlohmann::json::array_t parts;
-        const size_t num_parts = m_encoder->seq_len() == 1 ? 1 : 3 * m_encoder->seq_len();
-        parts.reserve(num_parts);
-        auto& encoder = this->m_encoder;
-        std::generate_n(std::back_inserter(parts), num_parts, [&]() { return encoder->next_part(); });
+        std::string ur_type = m_details.at("ur_type");
+        auto cbor = h2b(m_details.at("data"));
+        const size_t max_fragment_len = m_details.at("max_fragment_len");
+        const auto ur = ur::UR(std::move(ur_type), std::move(cbor));
+        const size_t seq_len = ur::UREncoder(ur, max_fragment_len).seq_len();
+        const size_t num_parts = seq_len == 1 ? 1 : 3 * seq_len;
+
+        // Fountain parts depend only on their sequence number, so chunks of
+        // them can be generated independently
+        std::vector<std::string> parts(num_parts);
+        parallel_for_chunks(num_parts, MIN_PARTS_PER_THREAD, MAX_ENCODER_THREADS, [&](size_t b, size_t e) {
+            ur::UREncoder encoder(ur, max_fragment_len, b);
+            std::generate(parts.begin() + b, parts.begin() + e, [&encoder] { return encoder.next_part(); });
+        });
         m_result = { { "parts", std::move(parts) } };
         return state_type::done;
 #endif
@@ -76,8 +87,19 @@ namespace sdk {
             return state_type::done;
         }
 
+        // Keep the previous progress data, only rebuilding the received
+        // indices when a part completes a new fragment
+        auto auth_data = std::move(m_auth_data);
         signal_data_request();
-        m_auth_data = { { "received_indices", m_decoder->received_part_indexes() } };
+        m_auth_data = std::move(auth_data);
+        const auto& received = m_decoder->received_part_indexes();
+        auto& received_indices = m_auth_data["received_indices"];
+        if (received_indices.is_null() || received_indices.size() != received.size()) {
+            received_indices = received;
+        }
+        m_auth_data["expected_part_count"] = m_decoder->expected_part_count();
+        m_auth_data["estimated_percent_complete"]
+            = static_cast<uint32_t>(m_decoder->estimated_percent_complete() * 100.0);
         return m_state;
 #endif
     }
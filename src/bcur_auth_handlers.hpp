@@ -5,7 +5,6 @@
 #include "auth_handler.hpp"
 
 namespace ur {
-class UREncoder;
 class URDecoder;
 } // namespace ur
 
@@ -19,7 +18,6 @@ namespace sdk {
         state_type call_impl() override;
 
         nlohmann::json m_details;
-        std::unique_ptr<ur::UREncoder> m_encoder;
     };
 
     class bcur_decoder_call : public auth_handler_impl {
@@ -0,0 +1,68 @@
+#include <algorithm>
+
+#include "call_metrics.hpp"
+
+namespace ga {
+namespace sdk {
+
+    namespace {
+        // Bucket 0 holds latencies under 1us, bucket n holds [2^(n-1), 2^n)us
+        static size_t get_bucket(uint64_t us, size_t num_buckets)
+        {
+            size_t bucket = 0;
+            while (us && bucket < num_buckets - 1) {
+                us >>= 1;
+                ++bucket;
+            }
+            return bucket;
+        }
+    } // namespace
+
+    void call_metrics::record(std::string_view name, clock::duration elapsed, bool is_error)
+    {
+        const auto us_count = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        const uint64_t us = us_count < 0 ? 0 : static_cast<uint64_t>(us_count);
+        const size_t bucket = get_bucket(us, NUM_BUCKETS);
+
+        std::unique_lock<std::mutex> locker(m_mutex);
+        auto p = m_entries.find(name);
+        if (p == m_entries.end()) {
+            p = m_entries.emplace(std::string(name), entry()).first;
+        }
+        auto& e = p->second;
+        ++e.calls;
+        e.errors += is_error ? 1 : 0;
+        e.total_us += us;
+        e.max_us = std::max(e.max_us, us);
+        ++e.buckets[bucket];
+    }
+
+    uint64_t call_metrics::get_percentile(const entry& e, uint64_t percent)
+    {
+        // The rank of the percentile value, rounded up
+        const uint64_t rank = std::max<uint64_t>((e.calls * percent + 99) / 100, 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            seen += e.buckets[i];
+            if (seen >= rank) {
+                // Report the bucket upper bound, but never more than observed
+                return std::min(i ? uint64_t(1) << i : uint64_t(1), e.max_us);
+            }
+        }
+        return e.max_us;
+    }
+
+    nlohmann::json call_metrics::get_json() const
+    {
+        nlohmann::json result = nlohmann::json::object();
+        std::unique_lock<std::mutex> locker(m_mutex);
+        for (const auto& item : m_entries) {
+            const auto& e = item.second;
+            result[item.first] = { { "calls", e.calls }, { "errors", e.errors }, { "mean_us", e.total_us / e.calls },
+                { "p50_us", get_percentile(e, 50) }, { "p99_us", get_percentile(e, 99) }, { "max_us", e.max_us } };
+        }
+        return result;
+    }
+
+} // namespace sdk
+} // namespace ga
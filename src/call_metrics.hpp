@@ -0,0 +1,83 @@
+#ifndef GDK_CALL_METRICS_HPP
+#define GDK_CALL_METRICS_HPP
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+namespace ga {
+namespace sdk {
+
+    // Call and error counts, and latency histograms, for named operations.
+    // Latencies are recorded into power-of-two microsecond buckets, from
+    // which percentiles are estimated as the upper bound of the bucket they
+    // fall into. Thread safe.
+    class call_metrics final {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        call_metrics() = default;
+        call_metrics(const call_metrics&) = delete;
+        call_metrics& operator=(const call_metrics&) = delete;
+        call_metrics(call_metrics&&) = delete;
+        call_metrics& operator=(call_metrics&&) = delete;
+
+        void record(std::string_view name, clock::duration elapsed, bool is_error);
+
+        // Return the metrics for all operations, keyed by operation name
+        nlohmann::json get_json() const;
+
+        // Records the time until destruction as a single call, which is
+        // counted as an error if it ends due to an exception
+        class timer final {
+        public:
+            timer(call_metrics& metrics, std::string_view name)
+                : m_metrics(metrics)
+                , m_name(name)
+                , m_start(clock::now())
+                , m_num_exceptions(std::uncaught_exceptions())
+            {
+            }
+            ~timer()
+            {
+                m_metrics.record(m_name, clock::now() - m_start, std::uncaught_exceptions() > m_num_exceptions);
+            }
+
+            timer(const timer&) = delete;
+            timer& operator=(const timer&) = delete;
+
+        private:
+            call_metrics& m_metrics;
+            const std::string_view m_name;
+            const clock::time_point m_start;
+            const int m_num_exceptions;
+        };
+
+    private:
+        static constexpr size_t NUM_BUCKETS = 40;
+
+        struct entry {
+            uint64_t calls = 0;
+            uint64_t errors = 0;
+            uint64_t total_us = 0;
+            uint64_t max_us = 0;
+            std::array<uint64_t, NUM_BUCKETS> buckets{};
+        };
+
+        static uint64_t get_percentile(const entry& e, uint64_t percent);
+
+        mutable std::mutex m_mutex;
+        std::map<std::string, entry, std::less<>> m_entries;
+    };
+
+} // namespace sdk
+} // namespace ga
+
+#endif
@@ -1,3 +1,4 @@
+#include <boost/algorithm/string/find.hpp>
 #include <boost/algorithm/string/trim.hpp>
 
 #include "client_blob.hpp"
@@ -25,6 +26,11 @@ namespace sdk {
         // blob prefix: 1 byte version, 3 reserved bytes
         static const std::array<unsigned char, 4> PREFIX{ 1, 0, 0, 0 };
 
+        // zlib compression level for saved blobs. Blobs are saved whenever
+        // their data changes, so favour speed over the last few percent of
+        // compressed size
+        constexpr int COMPRESSION_LEVEL = 6;
+
         // Increment the blob version number. Returns true as the blob has changed.
         static bool increment_version(nlohmann::json& data)
         {
@@ -123,6 +129,21 @@ namespace sdk {
         return json_get_value(m_data[TX_MEMOS], txhash_hex);
     }
 
+    std::vector<std::string> client_blob::find_tx_memos(const std::string& text) const
+    {
+        std::vector<std::string> txhashes;
+        if (is_key_encrypted(TX_MEMOS)) {
+            return txhashes; // Has been made unavailable to watch only sessions
+        }
+        for (const auto& it : m_data[TX_MEMOS].items()) {
+            const auto& memo = it.value().get_ref<const std::string&>();
+            if (!boost::algorithm::ifind_first(memo, text).empty()) {
+                txhashes.push_back(it.key());
+            }
+        }
+        return txhashes;
+    }
+
     bool client_blob::set_master_blinding_key(const std::string& master_blinding_key_hex)
     {
         auto& unblinder = m_data[SLIP77KEY];
@@ -181,17 +202,13 @@ namespace sdk {
         // Only one fixed prefix value is currently allowed, check we match it
         GDK_RUNTIME_ASSERT(memcmp(decrypted.data(), PREFIX.data(), PREFIX.size()) == 0);
 
-        // Decompress the compressed representation excluding PREFIX
-        auto decompressed = decompress(gsl::make_span(decrypted).subspan(PREFIX.size()));
+        // Load our blob data from the compressed msgpack representation
+        // excluding PREFIX, decompressing it as it is parsed
+        auto new_data = decompress_msgpack(gsl::make_span(decrypted).subspan(PREFIX.size()));
 
         // Clear and free the decrypted representation immediately
         bzero_and_free(decrypted);
 
-        // Load our blob data from the uncompressed data in msgpack format
-        auto new_data = nlohmann::json::from_msgpack(decompressed.begin(), decompressed.end());
-        // Clear and free the decompressed representation immediately
-        bzero_and_free(decompressed);
-
         // Check that the new blob has a higher version number:
         // This check prevents the server maliciously returning an old blob
         const uint64_t new_version = new_data[USER_VERSION];
@@ -208,7 +225,7 @@ namespace sdk {
     {
         // Dump out data to msgpack format and compress it, prepending PREFIX
         auto msgpack_data{ nlohmann::json::to_msgpack(m_data) };
-        auto compressed{ compress(PREFIX, msgpack_data) };
+        auto compressed{ compress(PREFIX, msgpack_data, COMPRESSION_LEVEL) };
 
         // Clear and free the uncompressed representation immediately
         bzero_and_free(msgpack_data);
@@ -37,6 +37,8 @@ namespace sdk {
 
         bool set_tx_memo(const std::string& txhash_hex, const std::string& memo);
         std::string get_tx_memo(const std::string& txhash_hex) const;
+        // Return the txhashes of memos containing 'text', ignoring case
+        std::vector<std::string> find_tx_memos(const std::string& text) const;
 
         bool set_master_blinding_key(const std::string& master_blinding_key_hex);
         std::string get_master_blinding_key() const;
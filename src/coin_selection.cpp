@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <limits>
+
+#include "coin_selection.hpp"
+#include "ga_wally.hpp"
+#include "network_parameters.hpp"
+#include "transaction_utils.hpp"
+#include "utils.hpp"
+
+namespace ga {
+namespace sdk {
+    namespace {
+        // Maximum number of branches to explore in Branch and Bound
+        static constexpr size_t BNB_MAX_TRIES = 100000;
+        // Number of random subsets to try in Knapsack
+        static constexpr size_t KNAPSACK_ITERATIONS = 1000;
+
+        using value_t = amount::signed_value_type;
+
+        // Compute the value of each UTXO after paying for its own input, and
+        // return the indices of those with a positive value, largest first
+        static std::vector<size_t> get_effective_values(const std::vector<coin_selection_utxo>& utxos,
+            amount::value_type fee_rate, std::vector<value_t>& effective_values)
+        {
+            effective_values.resize(utxos.size());
+            std::vector<size_t> indices;
+            indices.reserve(utxos.size());
+            for (size_t i = 0; i < utxos.size(); ++i) {
+                const amount::value_type vsize = (utxos[i].weight + 3) / 4;
+                const auto input_fee = static_cast<value_t>((vsize * fee_rate + 999) / 1000);
+                effective_values[i] = static_cast<value_t>(utxos[i].satoshi) - input_fee;
+                if (effective_values[i] > 0) {
+                    indices.push_back(i);
+                }
+            }
+            std::stable_sort(indices.begin(), indices.end(),
+                [&effective_values](size_t lhs, size_t rhs) { return effective_values[lhs] > effective_values[rhs]; });
+            return indices;
+        }
+
+        // Find a random subset of values with the smallest total >= target
+        static void approximate_best_subset(const std::vector<value_t>& values, value_t total_lower, value_t target,
+            std::vector<bool>& best, value_t& best_value)
+        {
+            uniform_uint32_rng rng;
+            std::vector<bool> included;
+
+            best.assign(values.size(), true);
+            best_value = total_lower;
+
+            for (size_t rep = 0; rep < KNAPSACK_ITERATIONS && best_value != target; ++rep) {
+                included.assign(values.size(), false);
+                value_t total = 0;
+                bool reached_target = false;
+                for (size_t pass = 0; pass < 2 && !reached_target; ++pass) {
+                    for (size_t i = 0; i < values.size(); ++i) {
+                        // The first pass includes values at random, the
+                        // second includes all values not yet included
+                        if (pass == 0 ? (rng() & 1) : !included[i]) {
+                            total += values[i];
+                            included[i] = true;
+                            if (total >= target) {
+                                reached_target = true;
+                                if (total < best_value) {
+                                    best_value = total;
+                                    best = included;
+                                }
+                                total -= values[i];
+                                included[i] = false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    } // namespace
+
+    uint32_t get_utxo_input_weight(const std::string& addr_type)
+    {
+        // Approximate weights including the prevout, sequence and a
+        // low-R signature from each required signer
+        if (addr_type == address_type::p2pkh) {
+            return 148 * 4;
+        } else if (addr_type == address_type::p2wpkh) {
+            return 41 * 4 + 108;
+        } else if (addr_type == address_type::p2sh_p2wpkh) {
+            return 64 * 4 + 108;
+        } else if (addr_type == address_type::p2sh) {
+            return 255 * 4; // 2of2 multisig
+        } else if (addr_type == address_type::p2wsh) {
+            return 76 * 4 + 218; // 2of2 multisig
+        } else if (addr_type == address_type::csv) {
+            return 76 * 4 + 224; // 2of2 multisig with CSV
+        }
+        return 255 * 4; // Unknown: Assume the worst case
+    }
+
+    std::vector<size_t> select_coins_bnb(const std::vector<coin_selection_utxo>& utxos, amount::value_type target,
+        amount::value_type cost_of_change, amount::value_type fee_rate)
+    {
+        std::vector<value_t> effective_values;
+        const auto indices = get_effective_values(utxos, fee_rate, effective_values);
+
+        const auto selection_target = static_cast<value_t>(target);
+        const auto selection_upper = selection_target + static_cast<value_t>(cost_of_change);
+        value_t available = 0;
+        for (const auto i : indices) {
+            available += effective_values[i];
+        }
+        if (available < selection_target) {
+            return {}; // Insufficient funds
+        }
+
+        // Depth first search over include/exclude decisions for each UTXO,
+        // largest first. current holds the positions of included UTXOs.
+        std::vector<size_t> current, best;
+        value_t current_value = 0;
+        value_t best_excess = std::numeric_limits<value_t>::max();
+        auto&& value_at = [&](size_t pos) { return effective_values[indices[pos]]; };
+
+        size_t pos = 0;
+        for (size_t tries = 0; tries < BNB_MAX_TRIES; ++tries, ++pos) {
+            bool backtrack = false;
+            if (current_value + available < selection_target || current_value > selection_upper) {
+                // Cannot reach the target, or have exceeded the upper bound
+                backtrack = true;
+            } else if (current_value >= selection_target) {
+                // Found a solution, keep it if it wastes less than our best
+                const value_t excess = current_value - selection_target;
+                if (excess < best_excess) {
+                    best = current;
+                    best_excess = excess;
+                    if (!excess) {
+                        break; // Exact match, can't do better
+                    }
+                }
+                backtrack = true;
+            }
+
+            if (backtrack) {
+                if (current.empty()) {
+                    break; // Searched the entire tree
+                }
+                // Restore the UTXOs excluded after the last included one
+                for (--pos; pos > current.back(); --pos) {
+                    available += value_at(pos);
+                }
+                // Then try excluding the last included UTXO
+                current_value -= value_at(pos);
+                current.pop_back();
+            } else {
+                // Include the next UTXO, unless it has the same value as a
+                // previously excluded one, in which case the result would be
+                // the same as an already explored branch.
+                available -= value_at(pos);
+                if (current.empty() || pos - 1 == current.back() || value_at(pos) != value_at(pos - 1)) {
+                    current.push_back(pos);
+                    current_value += value_at(pos);
+                }
+            }
+        }
+
+        std::vector<size_t> ret;
+        ret.reserve(best.size());
+        for (const auto p : best) {
+            ret.push_back(indices[p]);
+        }
+        return ret;
+    }
+
+    std::vector<size_t> select_coins_knapsack(
+        const std::vector<coin_selection_utxo>& utxos, amount::value_type target, amount::value_type fee_rate)
+    {
+        std::vector<value_t> effective_values;
+        const auto indices = get_effective_values(utxos, fee_rate, effective_values);
+        const auto selection_target = static_cast<value_t>(target);
+
+        std::vector<size_t> smaller; // Indices of UTXOs below the target, largest first
+        std::vector<value_t> smaller_values;
+        value_t total_lower = 0;
+        size_t lowest_larger = utxos.size(); // Index of the smallest UTXO above the target
+        for (const auto i : indices) {
+            const auto value = effective_values[i];
+            if (value == selection_target) {
+                return { i }; // Exact match
+            } else if (value < selection_target) {
+                smaller.push_back(i);
+                smaller_values.push_back(value);
+                total_lower += value;
+            } else {
+                lowest_larger = i; // indices are sorted largest first
+            }
+        }
+        const bool have_larger = lowest_larger != utxos.size();
+
+        if (total_lower == selection_target) {
+            return smaller; // The smaller UTXOs together are an exact match
+        }
+        if (total_lower < selection_target) {
+            if (!have_larger) {
+                return {}; // Insufficient funds
+            }
+            return { lowest_larger };
+        }
+
+        std::vector<bool> best;
+        value_t best_value;
+        approximate_best_subset(smaller_values, total_lower, selection_target, best, best_value);
+
+        if (have_larger && best_value != selection_target && effective_values[lowest_larger] <= best_value) {
+            return { lowest_larger };
+        }
+        std::vector<size_t> ret;
+        for (size_t i = 0; i < smaller.size(); ++i) {
+            if (best[i]) {
+                ret.push_back(smaller[i]);
+            }
+        }
+        return ret;
+    }
+
+} // namespace sdk
+} // namespace ga
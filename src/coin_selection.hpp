@@ -0,0 +1,42 @@
+#ifndef GDK_COIN_SELECTION_HPP
+#define GDK_COIN_SELECTION_HPP
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "amount.hpp"
+
+namespace ga {
+namespace sdk {
+
+    // A UTXO as seen by coin selection. Callers select from the UTXOs of
+    // a single asset at a time, so the asset is implied by the array.
+    struct coin_selection_utxo {
+        amount::value_type satoshi; // The value of the UTXO
+        uint32_t weight; // The weight added to a tx by spending the UTXO
+    };
+
+    // Return the estimated weight of a tx input spending a UTXO of the given address type
+    uint32_t get_utxo_input_weight(const std::string& addr_type);
+
+    // Branch and Bound: Find a set of UTXOs whose value after paying for
+    // their own inputs at fee_rate (satoshi/kb) is between target and
+    // target + cost_of_change, i.e. a set that requires no change output.
+    // Returns the indices of the selected UTXOs, or an empty vector if no
+    // such set exists.
+    std::vector<size_t> select_coins_bnb(const std::vector<coin_selection_utxo>& utxos, amount::value_type target,
+        amount::value_type cost_of_change, amount::value_type fee_rate);
+
+    // Knapsack: Find the set of UTXOs whose value after paying for their own
+    // inputs at fee_rate (satoshi/kb) exceeds target by the smallest amount.
+    // Returns the indices of the selected UTXOs, or an empty vector if the
+    // UTXOs cannot cover target.
+    std::vector<size_t> select_coins_knapsack(
+        const std::vector<coin_selection_utxo>& utxos, amount::value_type target, amount::value_type fee_rate);
+
+} // namespace sdk
+} // namespace ga
+
+#endif
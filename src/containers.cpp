@@ -17,6 +17,58 @@ namespace sdk {
         return true;
     }
 
+    json_path::json_path(const std::string& path)
+    {
+        if (path.empty()) {
+            return; // The document itself
+        }
+        if (path.front() != '/') {
+            m_tokens.push_back({ path, NO_INDEX }); // A single object key
+            return;
+        }
+        size_t start = 1;
+        for (;;) {
+            const size_t end = path.find('/', start);
+            std::string key = path.substr(start, end == std::string::npos ? end : end - start);
+            // Unescape "~1" to '/' and "~0" to '~', in that order
+            for (size_t pos = 0; (pos = key.find('~', pos)) != std::string::npos; ++pos) {
+                const char next = pos + 1 < key.size() ? key[pos + 1] : 0;
+                GDK_RUNTIME_ASSERT_MSG(next == '0' || next == '1', "invalid JSON path escape");
+                key.replace(pos, 2, next == '0' ? "~" : "/");
+            }
+            size_t index = NO_INDEX;
+            // Array indices are decimal without leading zeros
+            const bool is_digits = key.find_first_not_of("0123456789") == std::string::npos;
+            if (!key.empty() && key.size() < 20 && is_digits && (key == "0" || key.front() != '0')) {
+                index = std::stoull(key);
+            }
+            m_tokens.push_back({ std::move(key), index });
+            if (end == std::string::npos) {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    const nlohmann::json* json_path::find(const nlohmann::json& data) const
+    {
+        const nlohmann::json* current = &data;
+        for (const auto& token : m_tokens) {
+            if (current->is_object()) {
+                const auto p = current->find(token.key);
+                if (p == current->end()) {
+                    return nullptr;
+                }
+                current = &*p;
+            } else if (current->is_array() && token.index < current->size()) {
+                current = &(*current)[token.index];
+            } else {
+                return nullptr;
+            }
+        }
+        return current;
+    }
+
     const nlohmann::json& get_sized_array(const nlohmann::json& json, const char* key, size_t size)
     {
         const auto& value = json.at(key);
@@ -25,6 +77,48 @@ namespace sdk {
         return value;
     }
 
+    namespace {
+        // Allowance for the allocator and tree node overhead of each object member
+        constexpr size_t JSON_NODE_OVERHEAD = 4 * sizeof(void*);
+
+        static size_t get_string_memory_usage(const std::string& s)
+        {
+            const bool is_sso = s.capacity() < sizeof(std::string);
+            return sizeof(std::string) + (is_sso ? 0 : s.capacity() + 1);
+        }
+    } // namespace
+
+    size_t json_get_memory_usage(const nlohmann::json& json)
+    {
+        size_t total = sizeof(nlohmann::json);
+        switch (json.type()) {
+        case nlohmann::json::value_t::object:
+            total += sizeof(nlohmann::json::object_t);
+            for (const auto& item : json.get_ref<const nlohmann::json::object_t&>()) {
+                total += JSON_NODE_OVERHEAD + get_string_memory_usage(item.first);
+                total += json_get_memory_usage(item.second);
+            }
+            break;
+        case nlohmann::json::value_t::array: {
+            const auto& arr = json.get_ref<const nlohmann::json::array_t&>();
+            total += sizeof(nlohmann::json::array_t) + (arr.capacity() - arr.size()) * sizeof(nlohmann::json);
+            for (const auto& item : arr) {
+                total += json_get_memory_usage(item);
+            }
+            break;
+        }
+        case nlohmann::json::value_t::string:
+            total += get_string_memory_usage(json.get_ref<const std::string&>());
+            break;
+        case nlohmann::json::value_t::binary:
+            total += sizeof(nlohmann::json::binary_t) + json.get_binary().capacity();
+            break;
+        default:
+            break; // Stored inline
+        }
+        return total;
+    }
+
     amount json_get_amount(const nlohmann::json& data, const std::string& key)
     {
         return amount(data.at(key).get<amount::value_type>());
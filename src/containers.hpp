@@ -3,7 +3,9 @@
 #pragma once
 
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace ga {
 namespace sdk {
@@ -64,6 +66,16 @@ namespace sdk {
         return p->get<T>();
     }
 
+    // Get a value if present and not null, otherwise return nullopt
+    template <typename T> std::optional<T> json_get_optional(const nlohmann::json& data, const std::string& key)
+    {
+        const auto p = data.find(key);
+        if (p == data.end() || p->is_null()) {
+            return std::nullopt;
+        }
+        return p->get<T>();
+    }
+
     amount json_get_amount(const nlohmann::json& data, const std::string& key);
     amount json_get_amount(const nlohmann::json& data, const std::string& key, const amount& default_value);
 
@@ -83,9 +95,41 @@ namespace sdk {
         return to_remove;
     }
 
+    // A pre-parsed path into a JSON document. Paths beginning with '/' are
+    // JSON pointers (RFC 6901); any other non-empty path is a single object
+    // key, and the empty path refers to the document itself.
+    class json_path {
+    public:
+        explicit json_path(const std::string& path);
+
+        // Return the value at the path, or nullptr if it is not present
+        const nlohmann::json* find(const nlohmann::json& data) const;
+
+        // Get a value if present and not null, otherwise return a default value
+        template <typename T = std::string> T get_value(const nlohmann::json& data, const T& default_value = T()) const
+        {
+            const auto p = find(data);
+            if (!p || p->is_null()) {
+                return default_value;
+            }
+            return p->get<T>();
+        }
+
+    private:
+        struct token {
+            std::string key;
+            size_t index; // The key as an array index, or NO_INDEX
+        };
+        static constexpr size_t NO_INDEX = static_cast<size_t>(-1);
+        std::vector<token> m_tokens;
+    };
+
     // Get a JSON array of a given size, otherwise fail
     const nlohmann::json& get_sized_array(const nlohmann::json& json, const char* key, size_t size);
 
+    // Return the approximate number of bytes of memory used by a JSON value
+    size_t json_get_memory_usage(const nlohmann::json& json);
+
 } // namespace sdk
 } // namespace ga
 
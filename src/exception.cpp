@@ -39,11 +39,11 @@ namespace sdk {
             // confirmed and therefore the bump tx's previous output cannot
             // be found. Remap this to a more friendly error message.
             GDK_LOG_SEV(log_level::debug) << details.second;
-            return std::make_pair(details.first, res::id_transaction_already_confirmed);
+            return std::make_pair(details.first, std::string(res::id_transaction_already_confirmed));
         } else if (details.second == "User not found or invalid password") {
-            return std::make_pair(details.first, res::id_user_not_found_or_invalid);
+            return std::make_pair(details.first, std::string(res::id_user_not_found_or_invalid));
         } else if (details.second == "Invalid PGP key") {
-            return std::make_pair(details.first, res::id_invalid_pgp_key);
+            return std::make_pair(details.first, std::string(res::id_invalid_pgp_key));
         }
         return details;
     }
@@ -3,6 +3,8 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
 
 namespace autobahn {
@@ -14,8 +16,8 @@ namespace sdk {
 
     class login_error : public std::runtime_error {
     public:
-        explicit login_error(const std::string& what)
-            : std::runtime_error(what)
+        explicit login_error(std::string_view what)
+            : std::runtime_error(std::string(what))
         {
         }
     };
@@ -46,8 +48,8 @@ namespace sdk {
 
     class user_error : public std::runtime_error {
     public:
-        explicit user_error(const std::string& what)
-            : std::runtime_error(what)
+        explicit user_error(std::string_view what)
+            : std::runtime_error(std::string(what))
         {
         }
     };
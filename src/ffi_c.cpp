@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <boost/thread/tss.hpp>
 #include <initializer_list>
 #include <type_traits>
+#include <vector>
 
 #include "amount.hpp"
 #include "assertion.hpp"
@@ -10,9 +12,12 @@
 #include "exception.hpp"
 #include "ga_auth_handlers.hpp"
 #include "gdk.h"
+#include "logging.hpp"
 #include "network_parameters.hpp"
 #include "session.hpp"
 #include "swap_auth_handlers.hpp"
+#include "thread_pool.hpp"
+#include "transaction_list.hpp"
 #include "utils.hpp"
 #include "validate.hpp"
 
@@ -96,6 +101,33 @@ template <typename T> static void json_convert(const nlohmann::json& json, const
     *value = ga::sdk::json_get_value<T>(json, path);
 }
 
+template <typename T>
+static void json_convert(const nlohmann::json& json, const ga::sdk::json_path* path, T* value)
+{
+    GDK_RUNTIME_ASSERT(value);
+    *value = path->get_value<T>(json);
+}
+
+template <typename V, typename T, typename FN>
+static void json_convert_array(const nlohmann::json& json, const ga::sdk::json_path* array_path,
+    const ga::sdk::json_path* path, T* output, size_t output_len, size_t* written, FN&& fn)
+{
+    const auto array_p = array_path->find(json);
+    GDK_RUNTIME_ASSERT_MSG(array_p && array_p->is_array(), "JSON path is not an array");
+    const size_t num_items = std::min(array_p->size(), output_len);
+    // Read every value before publishing any, so that a value which fails
+    // to convert cannot leave already allocated outputs behind
+    std::vector<V> values;
+    values.reserve(num_items);
+    for (size_t i = 0; i < num_items; ++i) {
+        values.push_back(path->get_value<V>((*array_p)[i]));
+    }
+    for (size_t i = 0; i < num_items; ++i) {
+        output[i] = fn(values[i]);
+    }
+    *written = array_p->size();
+}
+
 static struct GA_auth_handler* auth_cast(ga::sdk::auth_handler* call)
 {
     return reinterpret_cast<struct GA_auth_handler*>(call);
@@ -135,6 +167,14 @@ struct call_timer {
 struct GA_session final : public ga::sdk::session {
 };
 
+struct GA_json_path final : public ga::sdk::json_path {
+    using ga::sdk::json_path::json_path;
+};
+
+struct GA_transaction_list final : public ga::sdk::transaction_list {
+    using ga::sdk::transaction_list::transaction_list;
+};
+
 #define GDK_DEFINE_C_FUNCTION_1(NAME, T1, A1, BODY)                                                                    \
     int NAME(T1 A1)                                                                                                    \
     {                                                                                                                  \
@@ -256,6 +296,18 @@ int GA_destroy_json(GA_json* json)
     return GA_OK;
 }
 
+int GA_destroy_json_path(struct GA_json_path* path)
+{
+    delete path;
+    return GA_OK;
+}
+
+int GA_destroy_transaction_list(struct GA_transaction_list* list)
+{
+    delete list;
+    return GA_OK;
+}
+
 GDK_DEFINE_C_FUNCTION_2(
     GA_connect, struct GA_session*, session, const GA_json*, net_params, { session->connect(*json_cast(net_params)); })
 
@@ -265,6 +317,17 @@ GDK_DEFINE_C_FUNCTION_2(GA_reconnect_hint, struct GA_session*, session, const GA
 GDK_DEFINE_C_FUNCTION_2(GA_get_proxy_settings, struct GA_session*, session, GA_json**, output,
     { *json_cast(output) = new nlohmann::json(session->get_proxy_settings()); })
 
+GDK_DEFINE_C_FUNCTION_2(GA_get_notification_metrics, struct GA_session*, session, GA_json**, output,
+    { *json_cast(output) = new nlohmann::json(session->get_notification_metrics()); })
+
+GDK_DEFINE_C_FUNCTION_2(GA_get_metrics, struct GA_session*, session, GA_json**, output,
+    { *json_cast(output) = new nlohmann::json(session->get_metrics()); })
+
+GDK_DEFINE_C_FUNCTION_2(GA_get_memory_usage, struct GA_session*, session, GA_json**, output,
+    { *json_cast(output) = new nlohmann::json(session->get_memory_usage()); })
+
+GDK_DEFINE_C_FUNCTION_1(GA_trim_memory, struct GA_session*, session, { session->trim_memory(); })
+
 GDK_DEFINE_C_FUNCTION_3(
     GA_get_wallet_identifier, const GA_json*, net_params, const GA_json*, params, GA_json**, output, {
         *json_cast(output)
@@ -422,6 +485,10 @@ GDK_DEFINE_C_FUNCTION_5(GA_get_unspent_outputs_for_private_key, struct GA_sessio
             = new nlohmann::json(session->get_unspent_outputs_for_private_key(private_key, password, unused));
     })
 
+GDK_DEFINE_C_FUNCTION_3(GA_get_unspent_outputs_for_private_keys, struct GA_session*, session, const GA_json*,
+    details, GA_json**, output,
+    { *json_cast(output) = new nlohmann::json(session->get_unspent_outputs_for_private_keys(*json_cast(details))); })
+
 GDK_DEFINE_C_FUNCTION_3(GA_get_transaction_details, struct GA_session*, session, const char*, txhash_hex, GA_json**,
     transaction, { *json_cast(transaction) = new nlohmann::json(session->get_transaction_details(txhash_hex)); })
 
@@ -431,6 +498,14 @@ GDK_DEFINE_C_FUNCTION_2(GA_get_available_currencies, struct GA_session*, session
 GDK_DEFINE_C_FUNCTION_3(GA_convert_amount, struct GA_session*, session, const GA_json*, value_details, GA_json**,
     output, { *json_cast(output) = new nlohmann::json(session->convert_amount(*json_cast(value_details))); })
 
+GDK_DEFINE_C_FUNCTION_5(GA_convert_amounts, struct GA_session*, session, const int64_t*, satoshi, size_t, num_values,
+    const char*, denomination, char*, output, {
+        static_assert(GA_AMOUNT_STR_LEN == ga::sdk::amount::str_len, "amount buffer size mismatch");
+        GDK_RUNTIME_ASSERT(satoshi || !num_values);
+        GDK_RUNTIME_ASSERT(output || !num_values);
+        session->convert_amounts(satoshi, num_values, denomination, output);
+    })
+
 GDK_DEFINE_C_FUNCTION_3(GA_encrypt_with_pin, struct GA_session*, session, GA_json*, details, struct GA_auth_handler**,
     call, { *call = make_call(new ga::sdk::encrypt_with_pin_call(*session, json_move(details))); })
 
@@ -445,6 +520,15 @@ GDK_DEFINE_C_FUNCTION_2(GA_convert_string_to_json, const char*, input, GA_json**
 GDK_DEFINE_C_FUNCTION_2(GA_convert_json_to_string, const GA_json*, json, char**, output,
     { *output = to_c_string(json_cast(json)->dump()); })
 
+GDK_DEFINE_C_FUNCTION_3(GA_convert_json_to_msgpack, const GA_json*, json, unsigned char**, output, size_t*, output_len,
+    {
+        const auto msgpack = nlohmann::json::to_msgpack(*json_cast(json));
+        *output = static_cast<unsigned char*>(malloc(msgpack.size()));
+        GDK_RUNTIME_ASSERT(*output);
+        std::copy(msgpack.begin(), msgpack.end(), *output);
+        *output_len = msgpack.size();
+    })
+
 GDK_DEFINE_C_FUNCTION_2(GA_register_network, const char*, name, const GA_json*, network_details,
     { ga::sdk::network_parameters::add(name, *json_cast(network_details)); })
 
@@ -462,6 +546,34 @@ GDK_DEFINE_C_FUNCTION_2(GA_auth_handler_resolve_code, struct GA_auth_handler*, c
 
 GDK_DEFINE_C_FUNCTION_1(GA_auth_handler_call, struct GA_auth_handler*, call, { auth_cast(call)->operator()(); })
 
+int GA_auth_handler_call_async(struct GA_auth_handler* call, GA_auth_handler_notify handler, void* context)
+{
+    try {
+        g_thread_error.reset();
+        GDK_RUNTIME_ASSERT_MSG(call && handler, "null argument calling GA_auth_handler_call_async");
+        ga::sdk::get_call_pool().post([call, handler, context] {
+            nlohmann::json* output = nullptr;
+            const int ret = GA_auth_handler_call(call);
+            try {
+                if (ret == GA_OK) {
+                    output = new nlohmann::json(auth_cast(call)->get_status());
+                } else {
+                    nlohmann::json* p = g_thread_error.get();
+                    output = p ? new nlohmann::json(std::move(*p)) : new nlohmann::json();
+                }
+            } catch (const std::exception& e) {
+                GDK_LOG_SEV(ga::sdk::log_level::error) << "GA_auth_handler_call_async: " << e.what();
+            }
+            g_thread_error.reset();
+            handler(context, call, output ? ret : GA_ERROR, reinterpret_cast<GA_json*>(output));
+        });
+    } catch (const std::exception& e) {
+        set_thread_error(e.what());
+        return GA_ERROR;
+    }
+    return GA_OK;
+}
+
 GDK_DEFINE_C_FUNCTION_2(GA_auth_handler_get_status, struct GA_auth_handler*, call, GA_json**, output,
     { *json_cast(output) = new nlohmann::json(auth_cast(call)->get_status()); })
 
@@ -540,6 +652,91 @@ GDK_DEFINE_C_FUNCTION_3(GA_convert_json_value_to_json, const GA_json*, json, con
     *json_cast(output) = v;
 })
 
+GDK_DEFINE_C_FUNCTION_2(
+    GA_create_json_path, const char*, path, struct GA_json_path**, output, { *output = new GA_json_path(path); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_convert_json_path_value_to_bool, const GA_json*, json, const struct GA_json_path*, path,
+    uint32_t*, output, {
+        bool v;
+        json_convert(*json_cast(json), path, &v);
+        *output = v ? GA_TRUE : GA_FALSE;
+    })
+
+GDK_DEFINE_C_FUNCTION_3(GA_convert_json_path_value_to_string, const GA_json*, json, const struct GA_json_path*, path,
+    char**, output, {
+        std::string v;
+        *output = nullptr;
+        json_convert(*json_cast(json), path, &v);
+        *output = to_c_string(v);
+    })
+
+GDK_DEFINE_C_FUNCTION_3(GA_convert_json_path_value_to_uint32, const GA_json*, json, const struct GA_json_path*, path,
+    uint32_t*, output, { json_convert(*json_cast(json), path, output); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_convert_json_path_value_to_uint64, const GA_json*, json, const struct GA_json_path*, path,
+    uint64_t*, output, { json_convert(*json_cast(json), path, output); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_convert_json_path_value_to_json, const GA_json*, json, const struct GA_json_path*, path,
+    GA_json**, output, {
+        std::unique_ptr<nlohmann::json> v(new nlohmann::json());
+        json_convert(*json_cast(json), path, v.get());
+        *json_cast(output) = v.release();
+    })
+
+GDK_DEFINE_C_FUNCTION_6(GA_convert_json_path_values_to_uint64, const GA_json*, json, const struct GA_json_path*,
+    array_path, const struct GA_json_path*, path, uint64_t*, output, size_t, output_len, size_t*, written, {
+        json_convert_array<uint64_t>(
+            *json_cast(json), array_path, path, output, output_len, written, [](uint64_t v) { return v; });
+    })
+
+GDK_DEFINE_C_FUNCTION_6(GA_convert_json_path_values_to_uint32, const GA_json*, json, const struct GA_json_path*,
+    array_path, const struct GA_json_path*, path, uint32_t*, output, size_t, output_len, size_t*, written, {
+        json_convert_array<uint32_t>(
+            *json_cast(json), array_path, path, output, output_len, written, [](uint32_t v) { return v; });
+    })
+
+GDK_DEFINE_C_FUNCTION_6(GA_convert_json_path_values_to_string, const GA_json*, json, const struct GA_json_path*,
+    array_path, const struct GA_json_path*, path, char**, output, size_t, output_len, size_t*, written, {
+        json_convert_array<std::string>(*json_cast(json), array_path, path, output, output_len, written,
+            [](const std::string& v) { return to_c_string(v); });
+    })
+
+GDK_DEFINE_C_FUNCTION_2(GA_create_transaction_list, const GA_json*, transactions, struct GA_transaction_list**, output,
+    { *output = new GA_transaction_list(*json_cast(transactions)); })
+
+GDK_DEFINE_C_FUNCTION_2(GA_transaction_list_get_size, const struct GA_transaction_list*, list, size_t*, output,
+    { *output = list->size(); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_transaction_list_get_txhash, const struct GA_transaction_list*, list, size_t, index,
+    const char**, output, { *output = list->get_txhash(index); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_transaction_list_get_type, const struct GA_transaction_list*, list, size_t, index,
+    const char**, output, { *output = list->get_type(index); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_transaction_list_get_spv_verified, const struct GA_transaction_list*, list, size_t, index,
+    const char**, output, { *output = list->get_spv_verified(index); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_transaction_list_get_created_at_ts, const struct GA_transaction_list*, list, size_t,
+    index, uint64_t*, output, { *output = list->get_created_at_ts(index); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_transaction_list_get_block_height, const struct GA_transaction_list*, list, size_t, index,
+    uint32_t*, output, { *output = list->get_block_height(index); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_transaction_list_get_fee, const struct GA_transaction_list*, list, size_t, index,
+    uint64_t*, output, { *output = list->get_fee(index); })
+
+GDK_DEFINE_C_FUNCTION_3(GA_transaction_list_get_num_assets, const struct GA_transaction_list*, list, size_t, index,
+    size_t*, output, { *output = list->get_num_assets(index); })
+
+GDK_DEFINE_C_FUNCTION_5(GA_transaction_list_get_asset, const struct GA_transaction_list*, list, size_t, index,
+    size_t, asset_index, const char**, asset_id, int64_t*, satoshi, {
+        *asset_id = list->get_asset_id(index, asset_index);
+        *satoshi = list->get_satoshi(index, asset_index);
+    })
+
+GDK_DEFINE_C_FUNCTION_4(GA_transaction_list_get_satoshi, const struct GA_transaction_list*, list, size_t, index,
+    const char*, asset_id, int64_t*, output, { *output = list->get_satoshi(index, asset_id); })
+
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif
@@ -1,6 +1,8 @@
 #include "ga_auth_handlers.hpp"
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <future>
+#include <optional>
 #include <utility>
 
 #include "assertion.hpp"
@@ -14,6 +16,7 @@
 #include "session.hpp"
 #include "session_impl.hpp"
 #include "signer.hpp"
+#include "trace.hpp"
 #include "transaction_utils.hpp"
 #include "utils.hpp"
 #include "xpub_hdkey.hpp"
@@ -31,6 +34,19 @@ namespace sdk {
         static constexpr uint32_t USER_STATUS_DEFAULT = 0;
         static constexpr uint32_t USER_STATUS_FROZEN = 1;
 
+        // The maximum number of blinding nonces to request from the signer
+        // at once. Larger requests are split into chunks of this size, and
+        // tx pages are synced ahead until their nonces would fill one
+        static constexpr size_t MAX_BLINDING_NONCES_PER_REQUEST = 256;
+        // The maximum number of tx pages to sync ahead while they need nonces
+        static constexpr size_t MAX_TX_PAGES_PER_NONCE_REQUEST = 8;
+        // The number of subaccounts of each type to discover at once when
+        // refreshing singlesig subaccounts
+        static constexpr uint32_t SUBACCOUNTS_PER_DISCOVERY = 4;
+        // The difference between consecutive singlesig subaccount numbers of
+        // the same type (NUM_RESERVED_ACCOUNT_TYPES in gdk_electrum)
+        static constexpr uint32_t SINGLESIG_SUBACCOUNT_STRIDE = 16;
+
         // Add anti-exfil protocol host-entropy and host-commitment to the passed json
         static void add_ae_host_data(nlohmann::json& data)
         {
@@ -83,16 +99,34 @@ namespace sdk {
                 hw_reply.at("signer_commitment"), hw_reply.at("signature"), has_sighash);
         }
 
+        // Request the next chunk of nonces from 'missing', removing them from it
         static void set_blinding_nonce_request_data(const std::shared_ptr<signer>& signer,
-            const unique_pubkeys_and_scripts_t& missing, nlohmann::json& twofactor_data)
+            unique_pubkeys_and_scripts_t& missing, nlohmann::json& twofactor_data)
         {
             twofactor_data["blinding_keys_required"] = !signer->has_master_blinding_key();
             auto& scripts = twofactor_data["scripts"];
             auto& public_keys = twofactor_data["public_keys"];
-            for (const auto& m : missing) {
-                public_keys.emplace_back(b2h(m.first));
-                scripts.emplace_back(b2h(m.second));
+            auto it = missing.begin();
+            for (size_t i = 0; it != missing.end() && i < MAX_BLINDING_NONCES_PER_REQUEST; ++i, ++it) {
+                public_keys.emplace_back(b2h(it->first));
+                scripts.emplace_back(b2h(it->second));
+            }
+            missing.erase(missing.begin(), it);
+        }
+
+        // Returns the timestamp to sync the page of txs following 'page' from,
+        // or nothing if the server has no more txs
+        static std::optional<uint64_t> get_next_sync_timestamp(const nlohmann::json& page)
+        {
+            const auto& txs = page.at("list");
+            if (!page.value("more", false) || txs.empty()) {
+                return std::nullopt;
+            }
+            uint64_t timestamp = 0;
+            for (const auto& tx : txs) {
+                timestamp = std::max(timestamp, tx.at("created_at_ts").get<uint64_t>());
             }
+            return timestamp;
         }
 
         static void encache_blinding_data(
@@ -279,6 +313,7 @@ namespace sdk {
 
     auth_handler::state_type login_user_call::call_impl()
     {
+        GDK_TRACE_SPAN("login_user_call");
         const bool is_electrum = m_net_params.is_electrum();
         const bool is_liquid = m_net_params.is_liquid();
 
@@ -342,10 +377,18 @@ namespace sdk {
             const std::vector<std::string> xpubs = get_hw_reply().at("xpubs");
 
             m_master_bip32_xpub = xpubs.at(0);
-            if (!is_electrum) {
-                // Compute the login challenge with the master pubkey
-                const auto public_key = make_xpub(m_master_bip32_xpub).second;
-                m_challenge = m_session->get_challenge(public_key);
+            const auto public_key = make_xpub(m_master_bip32_xpub).second;
+            // Software wallets may be able to log in from the local cache,
+            // in which case we don't want to wait for the challenge
+            const bool try_warm_login
+                = !is_electrum && !m_signer->is_hardware() && m_net_params.is_warm_login_enabled();
+            std::future<std::string> challenge;
+            if (!is_electrum && !try_warm_login) {
+                // Fetch the login challenge for the master pubkey from the
+                // server while we load the local cache below
+                challenge = std::async(std::launch::async, [this, public_key] {
+                    return m_session->get_challenge(public_key);
+                });
             }
 
             // Set the cache keys for the wallet, loading/creating the
@@ -353,6 +396,19 @@ namespace sdk {
             const auto local_xpub = make_xpub(xpubs.at(1));
             m_session->set_local_encryption_keys(local_xpub.second, m_signer);
 
+            if (try_warm_login) {
+                m_result = m_session->warm_login(m_signer, m_master_bip32_xpub, [signer = m_signer](const auto& c) {
+                    const auto message_hash = format_bitcoin_message_hash(ustring_span(CHALLENGE_PREFIX + c));
+                    return sig_only_to_der_hex(signer->sign_hash(signer::LOGIN_PATH, message_hash));
+                });
+                if (!m_result.empty()) {
+                    return state_type::done; // Logged in, authenticating in the background
+                }
+                m_challenge = m_session->get_challenge(public_key);
+            } else if (challenge.valid()) {
+                m_challenge = challenge.get();
+            }
+
             if (is_electrum) {
                 // Skip the challenge/response steps since we have no server
                 // to authenticate to.
@@ -406,8 +462,19 @@ namespace sdk {
 
             return request_subaccount_xpubs();
         } else if (m_hw_request == hw_request::get_xpubs) {
-            // Caller has provided the xpubs for each subaccount
-            const std::vector<std::string> xpubs = get_hw_reply().at("xpubs");
+            // Caller has provided the xpubs for each subaccount we requested.
+            // Cache them, then register all subaccounts from the cache
+            const auto& paths = m_twofactor_data.at("paths");
+            const auto& reply_xpubs = get_hw_reply().at("xpubs");
+            GDK_RUNTIME_ASSERT(paths.size() == reply_xpubs.size());
+            for (size_t i = 0; i < paths.size(); ++i) {
+                m_signer->cache_bip32_xpub(paths[i].get<std::vector<uint32_t>>(), reply_xpubs[i]);
+            }
+            std::vector<std::string> xpubs;
+            xpubs.reserve(m_subaccount_pointers.size());
+            for (const auto& pointer : m_subaccount_pointers) {
+                xpubs.emplace_back(m_signer->get_bip32_xpub(m_session->get_subaccount_root_path(pointer)));
+            }
             m_session->register_subaccount_xpubs(m_subaccount_pointers, xpubs);
 
             //
@@ -416,8 +483,8 @@ namespace sdk {
         }
 
         // We are logged in
+        m_session->start_sync_threads();
         if (is_electrum) {
-            m_session->start_sync_threads();
             return state_type::done;
         }
 
@@ -442,13 +509,22 @@ namespace sdk {
 
     auth_handler::state_type login_user_call::request_subaccount_xpubs()
     {
-        // Ask the caller for the xpubs for each subaccount
+        // Ask the caller for the xpubs for each subaccount. Xpubs cached from
+        // previous logins are not requested again, so that a HWW only has to
+        // derive the xpubs of subaccounts it hasn't seen before.
         m_subaccount_pointers = m_session->get_subaccount_pointers();
 
-        std::vector<nlohmann::json> paths;
+        std::vector<nlohmann::json> paths, uncached_paths;
         paths.reserve(m_subaccount_pointers.size());
         for (const auto& pointer : m_subaccount_pointers) {
-            paths.emplace_back(m_session->get_subaccount_root_path(pointer));
+            auto path = m_session->get_subaccount_root_path(pointer);
+            if (!m_signer->has_bip32_xpub(path)) {
+                uncached_paths.emplace_back(path);
+            }
+            paths.emplace_back(std::move(path));
+        }
+        if (!uncached_paths.empty()) {
+            paths.swap(uncached_paths);
         }
         signal_hw_request(hw_request::get_xpubs);
         m_twofactor_data["paths"] = paths;
@@ -1030,51 +1106,74 @@ namespace sdk {
     //
     get_subaccounts_call::get_subaccounts_call(session& session, nlohmann::json details)
         : auth_handler_impl(session, "get_subaccounts")
-        , m_subaccount_type(address_type::p2sh_p2wpkh)
-        , m_subaccount(0)
+        , m_subaccount_types({ address_type::p2sh_p2wpkh, address_type::p2wpkh, address_type::p2pkh })
         , m_details(std::move(details))
     {
     }
 
     auth_handler::state_type get_subaccounts_call::call_impl()
     {
-        if (!m_net_params.is_electrum() || !m_details.value("refresh", false) || m_subaccount_type.empty()) {
+        if (!m_net_params.is_electrum() || !m_details.value("refresh", false) || m_subaccount_types.empty()) {
             m_result = { { "subaccounts", m_session->get_subaccounts() } };
             return state_type::done;
         }
 
-        // TODO: consider batching requests for xpubs.
-        // The current implementation asks for one xpub at the time.
-        // Depending on network connection speed and hardware signer response time,
-        // this might affect performance negatively.
-
         // BIP44 account discovery
         // Performed only for Electrum sessions and if the client requests it.
+        // The xpubs for the next few subaccounts of every type that may still
+        // have used subaccounts are requested and checked at once.
         if (m_hw_request == hw_request::get_xpubs) {
-            // Caller has provided the xpub for the subaccount
-            const std::string xpub = get_hw_reply().at("xpubs").at(0);
-            if (m_session->discover_subaccount(xpub, m_subaccount_type)) {
-                m_session->create_subaccount({ { "name", std::string() }, { "discovered", true } }, m_subaccount, xpub);
-            } else {
-                // Found an empty subaccount for the current subaccount type,
-                // step to the next subaccount type.
-                if (m_subaccount_type == address_type::p2sh_p2wpkh) {
-                    m_subaccount_type = address_type::p2wpkh;
-                } else if (m_subaccount_type == address_type::p2wpkh) {
-                    m_subaccount_type = address_type::p2pkh;
-                } else if (m_subaccount_type == address_type::p2pkh) {
-                    m_subaccount_type.clear();
-                    // No more subaccount types, ready to return
-                    return m_state;
+            // Caller has provided the xpubs for the candidate subaccounts
+            const auto& xpubs = get_hw_reply().at("xpubs");
+            GDK_RUNTIME_ASSERT(xpubs.size() == m_candidates.size());
+            nlohmann::json::array_t details;
+            details.reserve(m_candidates.size());
+            for (size_t i = 0; i < m_candidates.size(); ++i) {
+                details.push_back({ { "type", m_candidates[i].first }, { "xpub", xpubs.at(i) } });
+            }
+            const auto found = m_session->discover_subaccounts(details);
+            GDK_RUNTIME_ASSERT(found.size() == m_candidates.size());
+
+            // Candidates are grouped by type in subaccount order. Create the
+            // used subaccounts up to the first empty one of each type; a type
+            // with no empty candidate may have further used subaccounts.
+            std::vector<std::string> remaining_types;
+            for (size_t i = 0; i < m_candidates.size();) {
+                const std::string type = m_candidates[i].first;
+                bool all_found = true;
+                for (; i < m_candidates.size() && m_candidates[i].first == type; ++i) {
+                    all_found = all_found && found[i];
+                    if (all_found) {
+                        const uint32_t subaccount = m_candidates[i].second;
+                        const std::string xpub = xpubs.at(i);
+                        m_session->create_subaccount(
+                            { { "name", std::string() }, { "discovered", true } }, subaccount, xpub);
+                    }
+                }
+                if (all_found) {
+                    remaining_types.push_back(type);
                 }
             }
+            m_subaccount_types.swap(remaining_types);
+            m_candidates.clear();
+            if (m_subaccount_types.empty()) {
+                // No more subaccount types, ready to return
+                m_result = { { "subaccounts", m_session->get_subaccounts() } };
+                return state_type::done;
+            }
         }
 
-        // Ask for the xpub for the next subaccount of the current type
-        m_subaccount = m_session->get_next_subaccount(m_subaccount_type);
+        // Ask for the xpubs for the next subaccounts of the remaining types
         signal_hw_request(hw_request::get_xpubs);
         auto& paths = m_twofactor_data["paths"];
-        paths.emplace_back(m_session->get_subaccount_root_path(m_subaccount));
+        for (const auto& type : m_subaccount_types) {
+            const uint32_t next_subaccount = m_session->get_next_subaccount(type);
+            for (uint32_t i = 0; i < SUBACCOUNTS_PER_DISCOVERY; ++i) {
+                const uint32_t subaccount = next_subaccount + i * SINGLESIG_SUBACCOUNT_STRIDE;
+                m_candidates.emplace_back(type, subaccount);
+                paths.emplace_back(m_session->get_subaccount_root_path(subaccount));
+            }
+        }
         return m_state;
     }
 
@@ -1114,8 +1213,17 @@ namespace sdk {
         if (m_hw_request == hw_request::get_blinding_nonces) {
             // Parse and cache the nonces we got back
             encache_blinding_data(*m_session, m_twofactor_data, get_hw_reply());
-            // Unblind, cleanup and store the fetched txs
-            m_session->store_transactions(m_subaccount, m_result);
+            if (!m_missing.empty()) {
+                // Request the next chunk of nonces
+                signal_hw_request(hw_request::get_blinding_nonces);
+                set_blinding_nonce_request_data(get_signer(), m_missing, m_twofactor_data);
+                return m_state;
+            }
+            // Unblind, cleanup and store the fetched txs, oldest page first
+            for (auto& page : m_pages) {
+                m_session->store_transactions(m_subaccount, page);
+            }
+            m_pages.clear();
             // Make sure we don't re-encache the same nonces again next time through
             m_hw_request = hw_request::none;
             m_result.clear();
@@ -1129,22 +1237,45 @@ namespace sdk {
             auto txs = m_session->get_transactions(m_details);
             if (!txs.is_boolean()) {
                 m_session->postprocess_transactions(txs);
+                const bool is_full_page = !txs.empty() && txs.size() == m_details.at("count");
+                std::string cursor = is_full_page ? get_transactions_cursor(txs.back()) : std::string();
                 m_result = { { "transactions", std::move(txs) } };
+                if (!cursor.empty()) {
+                    // More txs may follow: allow the caller to fetch them without an offset scan
+                    m_result["cursor"] = std::move(cursor);
+                }
                 return state_type::done;
             }
             // Otherwise the cache was invalidated, continue on to resync
         }
 
         // Sync a page of txs from the server
-        unique_pubkeys_and_scripts_t missing;
-        m_result = m_session->sync_transactions(m_subaccount, missing);
-        if (!missing.empty()) {
+        m_pages.emplace_back(m_session->sync_transactions(m_subaccount, m_missing));
+        // While the synced txs need nonces, sync the pages that follow
+        // them too, so that all of their nonces are requested together
+        while (!m_missing.empty() && m_missing.size() < MAX_BLINDING_NONCES_PER_REQUEST
+            && m_pages.size() < MAX_TX_PAGES_PER_NONCE_REQUEST) {
+            const auto next_timestamp = get_next_sync_timestamp(m_pages.back());
+            if (!next_timestamp) {
+                break;
+            }
+            m_pages.emplace_back(m_session->sync_transactions(m_subaccount, *next_timestamp, m_missing));
+        }
+        if (!m_missing.empty()) {
+            const auto next_timestamp = get_next_sync_timestamp(m_pages.back());
+            if (next_timestamp) {
+                // Fetch the next page from the server while the signer computes the nonces
+                m_session->prefetch_transactions(m_subaccount, *next_timestamp);
+            }
             // We have missing nonces we need to fetch, request them
             signal_hw_request(hw_request::get_blinding_nonces);
-            set_blinding_nonce_request_data(get_signer(), missing, m_twofactor_data);
+            set_blinding_nonce_request_data(get_signer(), m_missing, m_twofactor_data);
             return m_state;
         }
         // No missing nonces, cleanup and store the fetched txs directly
+        GDK_RUNTIME_ASSERT(m_pages.size() == 1);
+        m_result = std::move(m_pages.front());
+        m_pages.clear();
         m_session->store_transactions(m_subaccount, m_result);
         // Call again to either continue fetching, or return the result
         return state_type::make_call;
@@ -1223,13 +1354,12 @@ namespace sdk {
             m_state = state_type::done;
             return;
         }
-        unique_pubkeys_and_scripts_t missing;
         // Fetch all UTXOs including frozen for caching, we filter out
         // frozen UTXOs in filter_result before returning if requested.
         auto unfiltered_details = m_details;
         unfiltered_details["all_coins"] = true;
-        auto utxos = m_session->get_unspent_outputs(unfiltered_details, missing);
-        if (missing.empty()) {
+        auto utxos = m_session->get_unspent_outputs(unfiltered_details, m_missing);
+        if (m_missing.empty()) {
             // All results are unblinded/Don't need unblinding.
             // Encache and return them
             m_session->process_unspent_outputs(utxos);
@@ -1241,7 +1371,7 @@ namespace sdk {
         // Some utxos need unblinding; ask the caller to resolve them
         m_result.swap(utxos);
         signal_hw_request(hw_request::get_blinding_nonces);
-        set_blinding_nonce_request_data(get_signer(), missing, m_twofactor_data);
+        set_blinding_nonce_request_data(get_signer(), m_missing, m_twofactor_data);
     }
 
     auth_handler::state_type get_unspent_outputs_call::call_impl()
@@ -1254,6 +1384,12 @@ namespace sdk {
 
         // Parse and cache the nonces we got back
         encache_blinding_data(*m_session, m_twofactor_data, get_hw_reply());
+        if (!m_missing.empty()) {
+            // Request the next chunk of nonces
+            signal_hw_request(hw_request::get_blinding_nonces);
+            set_blinding_nonce_request_data(get_signer(), m_missing, m_twofactor_data);
+            return m_state;
+        }
 
         // Unblind the remaining blinded outputs we have nonces for
         // and encache the result
@@ -1357,6 +1493,19 @@ namespace sdk {
 
     auth_handler::state_type get_balance_call::call_impl()
     {
+        if (!m_initialized && !m_net_params.is_electrum() && !m_details.value("confidential", false)
+            && !m_details.contains("expired_at") && !m_details.value("dust_limit", 0)) {
+            // Use the maintained totals of any cached UTXOs, if they apply
+            const uint32_t num_confs = m_details.value("num_confs", 0xff);
+            if (num_confs == 0 || num_confs == 1u) {
+                const bool all_coins = m_details.value("all_coins", false);
+                auto balance = m_session->get_cached_balance(m_details.at("subaccount"), num_confs, all_coins);
+                if (!balance.is_null()) {
+                    m_result.swap(balance);
+                    return state_type::done;
+                }
+            }
+        }
         auto state = get_unspent_outputs_call::call_impl(); // Get UTXOs using parent call
         if (state == state_type::done) {
             compute_balance();
@@ -1517,7 +1666,7 @@ namespace sdk {
                 // server.
                 // FIXME: Allow the user to specify their own seed in the future.
                 if (data != json_get_value(current_subconfig, "data")) {
-                    set_error(res::id_inconsistent_data_provided_for);
+                    set_error(std::string(res::id_inconsistent_data_provided_for));
                     return;
                 }
             }
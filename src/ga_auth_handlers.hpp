@@ -3,6 +3,7 @@
 #pragma once
 
 #include "auth_handler.hpp"
+#include "session_impl.hpp"
 
 namespace ga {
 namespace sdk {
@@ -155,8 +156,8 @@ namespace sdk {
     private:
         state_type call_impl() override;
 
-        std::string m_subaccount_type;
-        uint32_t m_subaccount;
+        std::vector<std::string> m_subaccount_types;
+        std::vector<std::pair<std::string, uint32_t>> m_candidates;
         nlohmann::json m_details;
     };
 
@@ -178,6 +179,8 @@ namespace sdk {
 
         nlohmann::json m_details;
         const uint32_t m_subaccount;
+        std::vector<nlohmann::json> m_pages; // Synced pages of txs awaiting nonces
+        unique_pubkeys_and_scripts_t m_missing; // Nonces not yet requested from the signer
     };
 
     class get_unspent_outputs_call : public auth_handler_impl {
@@ -187,13 +190,15 @@ namespace sdk {
     protected:
         state_type call_impl() override;
 
+        nlohmann::json m_details;
+        bool m_initialized;
+
     private:
         void initialize();
         void filter_result(bool encache);
         std::string get_sort_by() const;
 
-        nlohmann::json m_details;
-        bool m_initialized;
+        unique_pubkeys_and_scripts_t m_missing; // Nonces not yet requested from the signer
     };
 
     class get_balance_call : public get_unspent_outputs_call {
@@ -1,9 +1,15 @@
 #include <algorithm>
 #include <array>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <variant>
 #include <vector>
 
 #include "assertion.hpp"
+#include "containers.hpp"
 #include "ga_cache.hpp"
 #include "logging.hpp"
 #include "memory.hpp"
@@ -11,6 +17,8 @@
 #include "session.hpp"
 #include "signer.hpp"
 #include "sqlite3.h"
+#include "threading.hpp"
+#include "trace.hpp"
 #include "utils.hpp"
 
 namespace ga {
@@ -24,10 +32,18 @@ namespace sdk {
         constexpr uint32_t CT_WO = 2; // Watch-only wallet cache
 
         constexpr int VERSION = 1;
-        constexpr int MINOR_VERSION = 0x3;
+        constexpr int MINOR_VERSION = 0x5;
+
+        // Defaults for the "cache_flush_interval_ms" and "cache_flush_threshold" config
+        constexpr uint32_t DEFAULT_FLUSH_INTERVAL_MS = 2000;
+        constexpr uint32_t DEFAULT_FLUSH_THRESHOLD = 1000;
         constexpr const char* KV_SELECT = "SELECT value FROM KeyValue WHERE key = ?1;";
         constexpr const char* TX_SELECT = "SELECT timestamp, txid, block, spent, spv_status, data FROM Tx "
                                           "WHERE subaccount = ?1 ORDER BY timestamp DESC LIMIT ?2 OFFSET ?3;";
+        // Keyset pagination: seeks directly to the cursor using the primary key
+        constexpr const char* TX_SELECT_BEFORE = "SELECT timestamp, txid, block, spent, spv_status, data FROM Tx "
+                                                 "WHERE subaccount = ?1 AND timestamp < ?2 "
+                                                 "ORDER BY timestamp DESC LIMIT ?3;";
         constexpr const char* TXID_SELECT = "SELECT timestamp, txid, block, spent, spv_status, data FROM Tx "
                                             "WHERE subaccount = ?1 AND txid = ?2;";
         constexpr const char* TX_LATEST = "SELECT MAX(timestamp) FROM Tx WHERE subaccount = ?1;";
@@ -35,11 +51,32 @@ namespace sdk {
             = "SELECT MIN(timestamp) FROM Tx WHERE subaccount = ?1 AND block = 0;";
         constexpr const char* TX_EARLIEST_BLOCK
             = "SELECT MIN(timestamp) FROM Tx WHERE subaccount = ?1 AND block >= ?2;";
+        // Re-upserting a tx keeps its SPV status, unless it is now in a different block
         constexpr const char* TX_UPSERT = "INSERT INTO Tx(subaccount, timestamp, txid, block, spent, spv_status, data) "
                                           "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7) "
-                                          "ON CONFLICT(subaccount, timestamp) DO UPDATE SET data = ?4;";
+                                          "ON CONFLICT(subaccount, timestamp) DO UPDATE SET "
+                                          "txid = ?3, block = ?4, spent = ?5, data = ?7, spv_status = "
+                                          "CASE WHEN txid = ?3 AND block = ?4 THEN spv_status ELSE ?6 END;";
         constexpr const char* TX_SPV_UPDATE = "UPDATE Tx SET spv_status = ?1 WHERE txid = ?2;";
         constexpr const char* TX_DELETE_ALL = "DELETE FROM Tx WHERE subaccount = ?1 AND timestamp >= ?2;";
+        // Searchable columns derived from each cached tx, keyed by its timestamp
+        constexpr const char* TX_SEARCH_SELECT = "SELECT timestamp, txid, block, spent, spv_status, data FROM Tx "
+                                                 "WHERE subaccount = ?1";
+        // Txids to search for are staged in a temporary table, as binding
+        // each one could exceed the limit on the number of SQL parameters
+        constexpr const char* SEARCH_TXID_CREATE
+            = "CREATE TEMP TABLE IF NOT EXISTS SearchTxid(txid BLOB PRIMARY KEY) WITHOUT ROWID;";
+        constexpr const char* SEARCH_TXID_INSERT = "INSERT OR IGNORE INTO temp.SearchTxid(txid) VALUES (?1);";
+        constexpr const char* SEARCH_TXID_DELETE = "DELETE FROM temp.SearchTxid;";
+        constexpr const char* TXASSET_INSERT = "INSERT OR REPLACE INTO TxAsset(subaccount, timestamp, asset, satoshi) "
+                                               "VALUES (?1, ?2, ?3, ?4);";
+        constexpr const char* TXASSET_DELETE
+            = "DELETE FROM TxAsset WHERE subaccount = ?1 AND timestamp >= ?2 AND timestamp <= ?3;";
+        constexpr const char* TXADDRESS_INSERT = "INSERT OR IGNORE INTO TxAddress(subaccount, timestamp, address) "
+                                                 "VALUES (?1, ?2, ?3);";
+        constexpr const char* TXADDRESS_DELETE
+            = "DELETE FROM TxAddress WHERE subaccount = ?1 AND timestamp >= ?2 AND timestamp <= ?3;";
+        constexpr uint64_t MAX_TIMESTAMP = std::numeric_limits<int64_t>::max();
         constexpr const char* TXDATA_INSERT = "INSERT INTO TxData(txid, rawtx) VALUES (?1, ?2) "
                                               "ON CONFLICT(txid) DO NOTHING;";
         constexpr const char* TXDATA_SELECT = "SELECT rawtx FROM TxData WHERE txid = ?1;";
@@ -83,6 +120,13 @@ namespace sdk {
             exec_check(
                 "CREATE TABLE IF NOT EXISTS TxData(txid BLOB NOT NULL, rawtx BLOB NOT NULL, PRIMARY KEY(txid));");
 
+            exec_check("CREATE TABLE IF NOT EXISTS TxAsset(subaccount INTEGER NOT NULL, timestamp INTEGER NOT NULL, "
+                       "asset BLOB NOT NULL, satoshi INTEGER NOT NULL, PRIMARY KEY(subaccount, timestamp, asset));");
+            exec_check("CREATE INDEX IF NOT EXISTS TxAssetSatoshi ON TxAsset(subaccount, asset, satoshi);");
+
+            exec_check("CREATE TABLE IF NOT EXISTS TxAddress(subaccount INTEGER NOT NULL, timestamp INTEGER NOT NULL, "
+                       "address BLOB NOT NULL, PRIMARY KEY(subaccount, address, timestamp));");
+
             exec_check("CREATE TABLE IF NOT EXISTS ScriptPubKey("
                        "scriptpubkey BLOB NOT NULL,"
                        "subaccount INTEGER NOT NULL,"
@@ -95,11 +139,43 @@ namespace sdk {
             return db;
         }
 
-        static auto get_db()
+        static void exec_pragma(cache::sqlite3_ptr& db, const std::string& pragma)
+        {
+            char* err_msg = nullptr;
+            const int rc = sqlite3_exec(db.get(), pragma.c_str(), 0, 0, &err_msg);
+            if (rc != SQLITE_OK) {
+                GDK_LOG_SEV(log_level::info) << "Bad " << pragma << " RC " << rc << " err_msg: " << err_msg;
+                sqlite3_free(err_msg);
+                GDK_RUNTIME_ASSERT(false);
+            }
+        }
+
+        // Apply the per-connection SQLite settings from the network parameters.
+        // These must be reapplied after the DB is replaced by sqlite3_deserialize
+        static void set_db_pragmas(cache::sqlite3_ptr& db, uint32_t memory_kb, uint32_t temp_store)
+        {
+            if (memory_kb) {
+                // Negative values are sizes in KiB rather than pages
+                exec_pragma(db, "PRAGMA cache_size = -" + std::to_string(memory_kb) + ";");
+            }
+            if (temp_store) {
+                GDK_RUNTIME_ASSERT_MSG(temp_store <= 2, "invalid cache_temp_store");
+                exec_pragma(db, "PRAGMA temp_store = " + std::to_string(temp_store) + ";");
+            }
+        }
+
+        static auto get_db(uint32_t page_size, uint32_t memory_kb, uint32_t temp_store)
         {
             // Verify thread safety in the event that sqlite has been upgraded
             GDK_RUNTIME_ASSERT(sqlite3_threadsafe());
-            return create_db_schema(get_new_memory_db());
+            auto db = get_new_memory_db();
+            if (page_size) {
+                // Only takes effect before the first table is created. DBs
+                // loaded from disk keep the page size they were created with
+                exec_pragma(db, "PRAGMA page_size = " + std::to_string(page_size) + ";");
+            }
+            set_db_pragmas(db, memory_kb, temp_store);
+            return create_db_schema(std::move(db));
         }
 
         static const char* db_log_error(sqlite3* db) noexcept
@@ -144,35 +220,287 @@ namespace sdk {
             return gsl::finally([&stmt] { stmt_check_clean(stmt); });
         }
 
-        static void save_db_file(byte_span_t key, byte_span_t data, const std::string& path)
+        // The cache file is stored as a header followed by fixed size records,
+        // one per DB page. Each record holds the AES-GCM encryption of the page
+        // index followed by the page contents, so pages can be re-encrypted and
+        // rewritten in place without touching the rest of the file, and
+        // decrypted independently of each other. The header ends with an HMAC
+        // of its contents and the SHA-256 of every page, and is written last.
+        // A save interrupted part way through therefore leaves pages that do
+        // not match the header, and the file is rejected when loaded rather
+        // than yielding a mix of old and new pages.
+        // Files written with older headers (PAGED_MAGIC_V1 without a MAC, and
+        // PAGED_MAGIC_V2 with a MAC of the header fields only) are read and
+        // then rewritten in the current format.
+        constexpr const char* PAGED_MAGIC = "GDKPAGE3";
+        constexpr const char* PAGED_MAGIC_V2 = "GDKPAGE2";
+        constexpr const char* PAGED_MAGIC_V1 = "GDKPAGED";
+        constexpr size_t PAGED_MAGIC_LEN = 8;
+        constexpr size_t PAGED_FIELDS_LEN = PAGED_MAGIC_LEN + sizeof(uint32_t) * 2;
+        constexpr size_t PAGED_HEADER_LEN = PAGED_FIELDS_LEN + HMAC_SHA256_LEN;
+        constexpr size_t PAGED_HEADER_LEN_V1 = PAGED_FIELDS_LEN;
+        constexpr size_t PAGE_INDEX_LEN = sizeof(uint32_t);
+
+        // Pages are encrypted and decrypted in parallel in batches of this
+        // many pages, which also bounds the cyphertext held in memory
+        constexpr size_t PAGES_PER_BATCH = 256;
+        constexpr size_t MIN_PAGES_PER_THREAD = 16;
+        constexpr size_t MAX_PAGE_THREADS = 8;
+
+        // A decrypted DB image, allocated with sqlite3_malloc64 so that its
+        // ownership can be passed to sqlite3_deserialize without copying it
+        struct db_image {
+            struct deleter {
+                void operator()(unsigned char* p) const { sqlite3_free(p); }
+            };
+            std::unique_ptr<unsigned char, deleter> data;
+            size_t size = 0;
+
+            explicit db_image(size_t size_ = 0)
+                : data(size_ ? static_cast<unsigned char*>(sqlite3_malloc64(size_)) : nullptr)
+                , size(size_)
+            {
+                GDK_RUNTIME_ASSERT(data || !size);
+            }
+            bool empty() const { return !size; }
+            gsl::span<unsigned char> span() { return gsl::make_span(data.get(), size); }
+        };
+
+        using page_digests_t = std::vector<std::array<unsigned char, SHA256_LEN>>;
+
+        static void write_uint32_le(uint32_t value, unsigned char* dest)
+        {
+            for (size_t i = 0; i < sizeof(value); ++i) {
+                dest[i] = (value >> (i * 8)) & 0xff;
+            }
+        }
+
+        static uint32_t read_uint32_le(const unsigned char* src)
+        {
+            uint32_t value = 0;
+            for (size_t i = 0; i < sizeof(value); ++i) {
+                value |= static_cast<uint32_t>(src[i]) << (i * 8);
+            }
+            return value;
+        }
+
+        static uint32_t get_page_size(cache::sqlite3_ptr& db)
+        {
+            sqlite3_stmt* stmt = nullptr;
+            if (sqlite3_prepare_v2(db.get(), "PRAGMA page_size;", -1, &stmt, NULL) != SQLITE_OK) {
+                GDK_RUNTIME_ASSERT_MSG(false, db_log_error(db.get()));
+            }
+            const auto _ = gsl::finally([stmt] { sqlite3_finalize(stmt); });
+            GDK_RUNTIME_ASSERT(sqlite3_step(stmt) == SQLITE_ROW);
+            const auto page_size = sqlite3_column_int64(stmt, 0);
+            GDK_RUNTIME_ASSERT(page_size > 0 && page_size <= 65536);
+            return static_cast<uint32_t>(page_size);
+        }
+
+        // Make a header with the given magic, MACing the page digests after
+        // the header fields. 'digests' is empty for PAGED_MAGIC_V2 headers
+        static std::array<unsigned char, PAGED_HEADER_LEN> make_paged_header(
+            byte_span_t key, const char* magic, uint32_t page_size, uint32_t num_pages, const page_digests_t& digests)
+        {
+            std::vector<unsigned char> mac_data(PAGED_FIELDS_LEN + digests.size() * SHA256_LEN);
+            std::copy(magic, magic + PAGED_MAGIC_LEN, mac_data.begin());
+            write_uint32_le(page_size, mac_data.data() + PAGED_MAGIC_LEN);
+            write_uint32_le(num_pages, mac_data.data() + PAGED_MAGIC_LEN + sizeof(uint32_t));
+            for (size_t i = 0; i < digests.size(); ++i) {
+                std::copy(digests[i].begin(), digests[i].end(), mac_data.begin() + PAGED_FIELDS_LEN + i * SHA256_LEN);
+            }
+            std::array<unsigned char, PAGED_HEADER_LEN> header;
+            std::copy(mac_data.begin(), mac_data.begin() + PAGED_FIELDS_LEN, header.begin());
+            const auto mac = hmac_sha256(key, mac_data);
+            std::copy(mac.begin(), mac.end(), header.begin() + PAGED_FIELDS_LEN);
+            return header;
+        }
+
+        // Write the pages of 'data' whose digests differ from 'digests' to the
+        // cache file at 'path'. On entry 'digests' holds the digests of the pages
+        // currently on disk; it is updated to reflect the pages written. If
+        // 'digests' is empty the entire file is rewritten. Throws if the file
+        // cannot be written.
+        static void save_db_file(
+            byte_span_t key, byte_span_t data, uint32_t page_size, const std::string& path, page_digests_t& digests)
         {
             GDK_RUNTIME_ASSERT(!key.empty() && !data.empty());
-            const size_t encrypted_len = aes_gcm_encrypt_get_length(data);
-            std::vector<unsigned char> cyphertext(encrypted_len);
-            GDK_RUNTIME_ASSERT(aes_gcm_encrypt(key, data, cyphertext) == encrypted_len);
-
-            std::ofstream f(path, f.out | f.binary);
-            if (f.is_open()) {
-                for (size_t written = 0; written != encrypted_len; written = f.tellp()) {
-                    auto p = reinterpret_cast<const char*>(&cyphertext[written]);
-                    f.write(p, encrypted_len - written);
+            GDK_RUNTIME_ASSERT(data.size() % page_size == 0);
+            const size_t num_pages = data.size() / page_size;
+            GDK_RUNTIME_ASSERT(num_pages < 0xffffffff);
+            const size_t record_len = aes_gcm_encrypt_get_length(PAGE_INDEX_LEN + page_size);
+
+            // The on-disk contents are unknown until we finish successfully
+            const page_digests_t old_digests = std::move(digests);
+            digests.clear();
+
+            std::fstream f;
+            if (!old_digests.empty() && old_digests.size() <= num_pages) {
+                // Update the existing file in place
+                f.open(path, f.in | f.out | f.binary);
+            }
+            const bool is_rewrite = !f.is_open();
+            if (is_rewrite) {
+                // No existing file, or the DB shrank: rewrite everything
+                f.open(path, f.out | f.binary | f.trunc);
+                GDK_RUNTIME_ASSERT_MSG(f.is_open(), "unable to create cache file");
+            }
+
+            page_digests_t new_digests(num_pages);
+            std::vector<uint32_t> batch; // Indices of the changed pages to write
+            batch.reserve(PAGES_PER_BATCH);
+            std::vector<unsigned char> cyphertext(PAGES_PER_BATCH * record_len);
+            size_t pages_written = 0;
+
+            auto write_batch = [&] {
+                parallel_for_chunks(batch.size(), MIN_PAGES_PER_THREAD, MAX_PAGE_THREADS, [&](size_t b, size_t e) {
+                    std::vector<unsigned char> plaintext(PAGE_INDEX_LEN + page_size);
+                    for (size_t j = b; j < e; ++j) {
+                        const auto page = data.subspan(static_cast<size_t>(batch[j]) * page_size, page_size);
+                        write_uint32_le(batch[j], plaintext.data());
+                        std::copy(page.begin(), page.end(), plaintext.begin() + PAGE_INDEX_LEN);
+                        const auto record = gsl::make_span(cyphertext.data() + j * record_len, record_len);
+                        GDK_RUNTIME_ASSERT(aes_gcm_encrypt(key, plaintext, record) == record_len);
+                    }
+                    bzero_and_free(plaintext);
+                });
+                // Write each run of consecutive pages with a single write
+                for (size_t j = 0; j < batch.size();) {
+                    size_t run = 1;
+                    while (j + run < batch.size() && batch[j + run] == batch[j] + run) {
+                        ++run;
+                    }
+                    f.seekp(PAGED_HEADER_LEN + batch[j] * record_len);
+                    f.write(reinterpret_cast<const char*>(cyphertext.data() + j * record_len), run * record_len);
+                    j += run;
                 }
+                pages_written += batch.size();
+                batch.clear();
+            };
+
+            parallel_for_chunks(num_pages, MIN_PAGES_PER_THREAD, MAX_PAGE_THREADS, [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    new_digests[i] = sha256(data.subspan(i * page_size, page_size));
+                }
+            });
+            for (size_t i = 0; i < num_pages; ++i) {
+                if (!is_rewrite && i < old_digests.size() && old_digests[i] == new_digests[i]) {
+                    continue; // Page is unchanged on disk
+                }
+                batch.push_back(i);
+                if (batch.size() == PAGES_PER_BATCH) {
+                    write_batch();
+                }
+            }
+            if (!batch.empty()) {
+                write_batch();
             }
+
+            // Write the header last, once all pages it covers are written
+            f.flush();
+            const auto header = make_paged_header(key, PAGED_MAGIC, page_size, num_pages, new_digests);
+            f.seekp(0);
+            f.write(reinterpret_cast<const char*>(header.data()), header.size());
+            f.flush();
+            GDK_RUNTIME_ASSERT_MSG(f.good(), "error writing cache file");
+            digests = std::move(new_digests);
+            GDK_LOG_SEV(log_level::debug) << "Saved " << pages_written << "/" << num_pages << " db pages";
         }
 
-        static std::vector<unsigned char> load_db_file(byte_span_t key, const std::string& path)
+        // Returns the magic of a paged file, or nullptr if the file is
+        // in the legacy single blob format
+        static const char* get_paged_magic(std::ifstream& f)
+        {
+            std::array<char, PAGED_MAGIC_LEN> magic;
+            f.seekg(0, f.beg);
+            f.read(magic.data(), magic.size());
+            const char* paged_magic = nullptr;
+            if (f.gcount() == PAGED_MAGIC_LEN) {
+                for (const char* m : { PAGED_MAGIC, PAGED_MAGIC_V2, PAGED_MAGIC_V1 }) {
+                    if (std::equal(magic.begin(), magic.end(), m)) {
+                        paged_magic = m;
+                    }
+                }
+            }
+            f.clear();
+            f.seekg(0, f.beg);
+            return paged_magic;
+        }
+
+        static db_image load_paged_db_file(
+            byte_span_t key, std::ifstream& f, size_t file_len, const char* magic, page_digests_t& digests)
+        {
+            const bool is_v1 = magic == PAGED_MAGIC_V1;
+            const bool is_current = magic == PAGED_MAGIC;
+            const size_t header_len = is_v1 ? PAGED_HEADER_LEN_V1 : PAGED_HEADER_LEN;
+            std::array<unsigned char, PAGED_HEADER_LEN> header;
+            f.read(reinterpret_cast<char*>(header.data()), header_len);
+            GDK_RUNTIME_ASSERT(static_cast<size_t>(f.gcount()) == header_len);
+            const uint32_t page_size = read_uint32_le(header.data() + PAGED_MAGIC_LEN);
+            const uint32_t num_pages = read_uint32_le(header.data() + PAGED_MAGIC_LEN + sizeof(uint32_t));
+            GDK_RUNTIME_ASSERT(page_size > 0 && page_size <= 65536 && num_pages > 0);
+            if (magic == PAGED_MAGIC_V2) {
+                const auto expected = make_paged_header(key, magic, page_size, num_pages, {});
+                GDK_RUNTIME_ASSERT_MSG(expected == header, "bad cache header MAC");
+            }
+            const size_t record_len = aes_gcm_encrypt_get_length(PAGE_INDEX_LEN + page_size);
+            GDK_RUNTIME_ASSERT(file_len >= header_len + num_pages * record_len);
+
+            // Read the records a batch at a time, decrypting each batch in
+            // parallel directly into its place in the DB image
+            db_image plaintext(static_cast<size_t>(num_pages) * page_size);
+            std::vector<unsigned char> cyphertext(std::min<size_t>(num_pages, PAGES_PER_BATCH) * record_len);
+            page_digests_t new_digests(num_pages);
+            for (uint32_t first = 0; first < num_pages; first += PAGES_PER_BATCH) {
+                const size_t batch_size = std::min<size_t>(num_pages - first, PAGES_PER_BATCH);
+                f.read(reinterpret_cast<char*>(cyphertext.data()), batch_size * record_len);
+                GDK_RUNTIME_ASSERT(static_cast<size_t>(f.gcount()) == batch_size * record_len);
+                parallel_for_chunks(batch_size, MIN_PAGES_PER_THREAD, MAX_PAGE_THREADS, [&](size_t b, size_t e) {
+                    std::vector<unsigned char> page(PAGE_INDEX_LEN + page_size);
+                    for (size_t j = b; j < e; ++j) {
+                        const uint32_t i = first + j;
+                        const auto record = gsl::make_span(cyphertext.data() + j * record_len, record_len);
+                        GDK_RUNTIME_ASSERT(aes_gcm_decrypt(key, record, page) == page.size());
+                        GDK_RUNTIME_ASSERT(read_uint32_le(page.data()) == i);
+                        const auto dest = plaintext.data.get() + static_cast<size_t>(i) * page_size;
+                        std::copy(page.begin() + PAGE_INDEX_LEN, page.end(), dest);
+                        new_digests[i] = sha256(gsl::make_span(dest, page_size));
+                    }
+                    bzero_and_free(page);
+                });
+            }
+            if (is_current) {
+                // Reject pages not written by the save that wrote the header
+                const auto expected = make_paged_header(key, magic, page_size, num_pages, new_digests);
+                GDK_RUNTIME_ASSERT_MSG(expected == header, "bad cache header MAC");
+                // Leave 'digests' empty for older files so the next save
+                // rewrites them in the current format
+                digests.swap(new_digests);
+            }
+            return plaintext;
+        }
+
+        static db_image load_db_file(byte_span_t key, const std::string& path, page_digests_t& digests)
         {
             GDK_RUNTIME_ASSERT(!key.empty());
+            digests.clear();
             std::ifstream f(path, f.in | f.binary);
             if (!f.is_open()) {
                 GDK_LOG_SEV(log_level::info) << "Load db, no file or bad file " << path;
-                return std::vector<unsigned char>();
+                return db_image();
             }
 
             f.seekg(0, f.end);
-            std::vector<unsigned char> cyphertext(f.tellg());
+            const size_t file_len = f.tellg();
             f.seekg(0, f.beg);
 
+            if (const char* magic = get_paged_magic(f); magic != nullptr) {
+                return load_paged_db_file(key, f, file_len, magic, digests);
+            }
+
+            // Legacy format: the entire DB encrypted as a single blob.
+            // Leave 'digests' empty so the next save rewrites it as paged.
+            std::vector<unsigned char> cyphertext(file_len);
             size_t read = 0;
             while (read != cyphertext.size()) {
                 auto p = reinterpret_cast<char*>(&cyphertext[read]);
@@ -181,11 +509,10 @@ namespace sdk {
             }
 
             const size_t decrypted_len = aes_gcm_decrypt_get_length(cyphertext);
-            std::vector<unsigned char> plaintext(decrypted_len);
-            GDK_RUNTIME_ASSERT(aes_gcm_decrypt(key, cyphertext, plaintext) == decrypted_len);
+            db_image plaintext(decrypted_len);
+            GDK_RUNTIME_ASSERT(aes_gcm_decrypt(key, cyphertext, plaintext.span()) == decrypted_len);
             return plaintext;
         }
-
         static std::string get_persistent_storage_file(
             const std::string& data_dir, const std::string& db_name, int version)
         {
@@ -207,35 +534,35 @@ namespace sdk {
             }
         }
 
-        static bool load_db_impl(byte_span_t key, const std::string& path, cache::sqlite3_ptr& db)
+        static bool load_db_impl(
+            byte_span_t key, const std::string& path, cache::sqlite3_ptr& db, page_digests_t& digests)
         {
-            std::vector<unsigned char> plaintext;
+            db_image plaintext;
             try {
-                plaintext = load_db_file(key, path);
+                plaintext = load_db_file(key, path, digests);
             } catch (const std::exception& ex) {
                 GDK_LOG_SEV(log_level::info) << "Bad decryption for file " << path << " error " << ex.what();
                 unlink(path.c_str());
+                digests.clear();
             }
 
             if (plaintext.empty()) {
                 return false;
             }
 
-            const auto tmpdb = get_new_memory_db();
-            const int rc = sqlite3_deserialize(
-                tmpdb.get(), "main", plaintext.data(), plaintext.size(), plaintext.size(), SQLITE_DESERIALIZE_READONLY);
+            // Replace the contents of db with the image in place. Statements
+            // prepared on db must be prepared again afterwards. Ownership of
+            // the image passes to sqlite, which frees it when db is closed
+            // or if this fails
+            const auto size = plaintext.size;
+            const int rc = sqlite3_deserialize(db.get(), "main", plaintext.data.release(), size, size,
+                SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE);
 
             if (rc != SQLITE_OK) {
                 GDK_LOG_SEV(log_level::info) << "Bad sqlite3_deserialize for file " << path << " RC " << rc;
                 unlink(path.c_str());
-                return false;
-            }
-
-            auto backup = sqlite3_backup_init(db.get(), "main", tmpdb.get(), "main");
-            bool ok = backup != nullptr && sqlite3_backup_step(backup, -1) == SQLITE_DONE;
-            ok = ok && sqlite3_backup_finish(backup) == SQLITE_OK;
-            if (!ok) {
-                db_log_error(db.get());
+                digests.clear();
+                create_db_schema(db); // In case the previous DB was detached
                 return false;
             }
             GDK_LOG_SEV(log_level::debug) << path << " updating schema";
@@ -256,6 +583,37 @@ namespace sdk {
             step_final(stmt);
         }
 
+        // Scoped DB transaction, rolled back unless committed
+        class db_transaction final {
+        public:
+            explicit db_transaction(cache::sqlite3_ptr& db)
+                : m_db(db)
+                , m_committed(false)
+            {
+                exec_sql(m_db, "BEGIN TRANSACTION;");
+            }
+
+            ~db_transaction()
+            {
+                if (!m_committed) {
+                    no_std_exception_escape([this] { exec_sql(m_db, "ROLLBACK;"); }, "db rollback");
+                }
+            }
+
+            db_transaction(const db_transaction&) = delete;
+            db_transaction& operator=(const db_transaction&) = delete;
+
+            void commit()
+            {
+                exec_sql(m_db, "COMMIT;");
+                m_committed = true;
+            }
+
+        private:
+            cache::sqlite3_ptr& m_db;
+            bool m_committed;
+        };
+
         static uint32_t get_uint32(cache::sqlite3_stmt_ptr& stmt, int column)
         {
             const auto val = sqlite3_column_int64(stmt.get(), column);
@@ -263,6 +621,14 @@ namespace sdk {
             return static_cast<uint32_t>(val);
         }
 
+        // Get a blob column from the current row, valid until the next step
+        static byte_span_t get_row_blob(cache::sqlite3_stmt_ptr& stmt, int column)
+        {
+            const auto res = reinterpret_cast<const unsigned char*>(sqlite3_column_blob(stmt.get(), column));
+            const auto len = sqlite3_column_bytes(stmt.get(), column);
+            return gsl::make_span(res, len);
+        }
+
         static std::vector<unsigned char> get_blob(cache::sqlite3_stmt_ptr& stmt, int column)
         {
             const int rc = sqlite3_step(stmt.get());
@@ -378,89 +744,387 @@ namespace sdk {
             }
         }
 
+        static void bind_signed_int(cache::sqlite3_stmt_ptr& stmt, int column, int64_t value)
+        {
+            if (sqlite3_bind_int64(stmt.get(), column, value) != SQLITE_OK) {
+                GDK_RUNTIME_ASSERT_MSG(false, db_log_error(stmt));
+            }
+        }
+
         static void bind_blobs(cache::sqlite3_stmt_ptr& stmt, byte_span_t blob1, byte_span_t blob2)
         {
             bind_blob(stmt, 1, blob1);
             bind_blob(stmt, 2, blob2);
         }
+
+        // A compact open addressing hash map from byte string keys to byte
+        // string values. Keys may be given in two parts, which are treated as
+        // a single concatenated key. Keys and values are stored contiguously
+        // in one buffer, so entries do not require individual allocations.
+        class byte_index final {
+        public:
+            std::optional<byte_span_t> find(byte_span_t key, byte_span_t key2 = {}) const
+            {
+                if (m_slots.empty()) {
+                    return std::nullopt;
+                }
+                const uint64_t hash = hash_key(key, key2);
+                const size_t mask = m_slots.size() - 1;
+                for (size_t i = hash & mask;; i = (i + 1) & mask) {
+                    const auto& slot = m_slots[i];
+                    if (!slot.key_len) {
+                        return std::nullopt; // Empty slot: not found
+                    }
+                    if (slot.hash == hash && is_key(slot, key, key2)) {
+                        return gsl::make_span(m_data.data() + slot.offset + slot.key_len, slot.value_len);
+                    }
+                }
+            }
+
+            // Insert a value, leaving any existing value for the key unchanged
+            void insert(byte_span_t key, byte_span_t key2, byte_span_t value)
+            {
+                const size_t key_len = key.size() + key2.size();
+                GDK_RUNTIME_ASSERT(key_len && key_len <= 0xffff && value.size() <= 0xffff);
+                if (find(key, key2).has_value()) {
+                    return;
+                }
+                if ((m_size + 1) * 4 > m_slots.size() * 3) {
+                    rehash(std::max(m_slots.size() * 2, MIN_SLOTS)); // Keep the load below 75%
+                }
+                GDK_RUNTIME_ASSERT(m_data.size() + key_len + value.size() <= 0xffffffff);
+                const slot new_slot = { hash_key(key, key2), static_cast<uint32_t>(m_data.size()),
+                    static_cast<uint16_t>(key_len), static_cast<uint16_t>(value.size()) };
+                m_data.insert(m_data.end(), key.begin(), key.end());
+                m_data.insert(m_data.end(), key2.begin(), key2.end());
+                m_data.insert(m_data.end(), value.begin(), value.end());
+                place(new_slot);
+                ++m_size;
+            }
+
+            // Remove all entries, releasing their memory
+            void clear()
+            {
+                std::vector<slot>().swap(m_slots);
+                std::vector<unsigned char>().swap(m_data);
+                m_size = 0;
+            }
+
+            size_t get_memory_usage() const { return m_slots.capacity() * sizeof(slot) + m_data.capacity(); }
+
+        private:
+            struct slot {
+                uint64_t hash;
+                uint32_t offset; // Of the key, followed by the value, in m_data
+                uint16_t key_len; // Zero for an empty slot
+                uint16_t value_len;
+            };
+            static constexpr size_t MIN_SLOTS = 64; // Must be a power of 2
+
+            static uint64_t hash_key(byte_span_t key, byte_span_t key2)
+            {
+                // FNV-1a, finalized with the MurmurHash3 mixer to spread the low bits
+                uint64_t h = 0xcbf29ce484222325ull;
+                for (const auto part : { key, key2 }) {
+                    for (const auto b : part) {
+                        h = (h ^ b) * 0x100000001b3ull;
+                    }
+                }
+                h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+                h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ull;
+                return h ^ (h >> 33);
+            }
+
+            bool is_key(const slot& s, byte_span_t key, byte_span_t key2) const
+            {
+                if (s.key_len != key.size() + key2.size()) {
+                    return false;
+                }
+                const auto p = m_data.data() + s.offset;
+                return std::equal(key.begin(), key.end(), p) && std::equal(key2.begin(), key2.end(), p + key.size());
+            }
+
+            void place(const slot& s)
+            {
+                const size_t mask = m_slots.size() - 1;
+                size_t i = s.hash & mask;
+                while (m_slots[i].key_len) {
+                    i = (i + 1) & mask;
+                }
+                m_slots[i] = s;
+            }
+
+            void rehash(size_t num_slots)
+            {
+                auto old_slots = std::move(m_slots);
+                m_slots.assign(num_slots, slot{ 0, 0, 0, 0 });
+                for (const auto& s : old_slots) {
+                    if (s.key_len) {
+                        place(s);
+                    }
+                }
+            }
+
+            std::vector<slot> m_slots;
+            std::vector<unsigned char> m_data;
+            size_t m_size = 0;
+        };
+
+        static std::array<unsigned char, sizeof(cache::scriptpubkey_data)> pack_scriptpubkey_data(
+            const cache::scriptpubkey_data& data)
+        {
+            std::array<unsigned char, sizeof(cache::scriptpubkey_data)> packed;
+            std::memcpy(packed.data(), &data, packed.size());
+            return packed;
+        }
+
+        static cache::scriptpubkey_data unpack_scriptpubkey_data(byte_span_t packed)
+        {
+            cache::scriptpubkey_data data;
+            GDK_RUNTIME_ASSERT(packed.size() == sizeof(data));
+            std::memcpy(&data, packed.data(), sizeof(data));
+            return data;
+        }
     } // namespace
 
+    // Lookups of scriptpubkeys and blinding data occur once per tx output or
+    // utxo processed, often thousands at a time. These indices are loaded from
+    // the DB on first use and then updated along with it, so that lookups do
+    // not require a DB query each.
+    struct cache::lookup_index {
+        byte_index scriptpubkeys; // scriptpubkey -> packed scriptpubkey_data
+        byte_index blinding_pubkeys; // script -> blinding pubkey
+        byte_index blinding_nonces; // pubkey || script -> nonce
+        bool scriptpubkeys_loaded = false;
+        bool blinding_data_loaded = false;
+
+        void clear()
+        {
+            scriptpubkeys.clear();
+            blinding_pubkeys.clear();
+            blinding_nonces.clear();
+            scriptpubkeys_loaded = false;
+            blinding_data_loaded = false;
+        }
+
+        size_t get_memory_usage() const
+        {
+            return scriptpubkeys.get_memory_usage() + blinding_pubkeys.get_memory_usage()
+                + blinding_nonces.get_memory_usage();
+        }
+    };
+
     cache::cache(const network_parameters& net_params, const std::string& network_name)
         : m_network_name(network_name)
         , m_data_dir(gdk_config().at("datadir"))
         , m_is_liquid(net_params.is_liquid())
+        , m_db_page_size(net_params.get_cache_page_size())
+        , m_db_memory_kb(net_params.get_cache_memory_kb())
+        , m_db_temp_store(net_params.get_cache_temp_store())
         , m_type(0)
         , m_db_name()
         , m_encryption_key()
         , m_require_write(false)
-        , m_db(get_db())
-        , m_stmt_liquid_blinding_key_search(
-              get_stmt(m_is_liquid, m_db, "SELECT pubkey FROM LiquidBlindingPubKey WHERE script = ?1;"))
-        , m_stmt_liquid_blinding_key_insert(get_stmt(
-              m_is_liquid, m_db, "INSERT OR IGNORE INTO LiquidBlindingPubKey (script, pubkey) VALUES (?1, ?2);"))
-        , m_stmt_liquid_blinding_nonce_search(
-              get_stmt(m_is_liquid, m_db, "SELECT nonce FROM LiquidBlindingNonce WHERE pubkey = ?1 AND script = ?2;"))
-        , m_stmt_liquid_blinding_nonce_insert(get_stmt(m_is_liquid, m_db,
-              "INSERT OR IGNORE INTO LiquidBlindingNonce (pubkey, script, nonce) VALUES (?1, ?2, ?3);"))
-        , m_stmt_liquid_output_search(get_stmt(
-              m_is_liquid, m_db, "SELECT assetid, satoshi, abf, vbf FROM LiquidOutput WHERE txid = ?1 AND vout = ?2;"))
-        , m_stmt_liquid_output_insert(get_stmt(m_is_liquid, m_db,
-              "INSERT INTO LiquidOutput (txid, vout, assetid, satoshi, abf, vbf) VALUES (?1, ?2, ?3, ?4, ?5, ?6);"))
-        , m_stmt_key_value_upsert(get_stmt(
-              true, m_db, "INSERT INTO KeyValue(key, value) VALUES (?1, ?2) ON CONFLICT(key) DO UPDATE SET value=?2;"))
-        , m_stmt_key_value_search(get_stmt(true, m_db, KV_SELECT))
-        , m_stmt_key_value_delete(get_stmt(true, m_db, "DELETE FROM KeyValue WHERE key = ?1;"))
-        , m_stmt_tx_search(get_stmt(true, m_db, TX_SELECT))
-        , m_stmt_txid_search(get_stmt(true, m_db, TXID_SELECT))
-        , m_stmt_tx_latest_search(get_stmt(true, m_db, TX_LATEST))
-        , m_stmt_tx_earliest_mempool_search(get_stmt(true, m_db, TX_EARLIEST_MEMPOOL))
-        , m_stmt_tx_earliest_block_search(get_stmt(true, m_db, TX_EARLIEST_BLOCK))
-        , m_stmt_tx_upsert(get_stmt(true, m_db, TX_UPSERT))
-        , m_stmt_tx_spv_update(get_stmt(true, m_db, TX_SPV_UPDATE))
-        , m_stmt_tx_delete_all(get_stmt(true, m_db, TX_DELETE_ALL))
-        , m_stmt_txdata_insert(get_stmt(true, m_db, TXDATA_INSERT))
-        , m_stmt_txdata_search(get_stmt(true, m_db, TXDATA_SELECT))
-        , m_stmt_scriptpubkey_search(get_stmt(true, m_db,
-              "SELECT subaccount, branch, pointer, subtype, script_type FROM ScriptPubKey WHERE scriptpubkey = ?1;"))
-        , m_stmt_scriptpubkey_insert(get_stmt(true, m_db,
-              "INSERT OR IGNORE INTO ScriptPubKey (scriptpubkey, subaccount, branch, pointer, subtype, script_type) "
-              "VALUES (?1, ?2, ?3, ?4, ?5, ?6);"))
-        , m_stmt_scriptpubkey_latest_search(
-              get_stmt(true, m_db, "SELECT MAX(pointer) FROM ScriptPubKey WHERE subaccount = ?1;"))
-    {
-    }
-
-    cache::~cache() {}
+        , m_last_saved_changes(0)
+        , m_page_digests()
+        , m_flush_interval(json_get_value(gdk_config(), "cache_flush_interval_ms", DEFAULT_FLUSH_INTERVAL_MS))
+        , m_flush_threshold(json_get_value(gdk_config(), "cache_flush_threshold", DEFAULT_FLUSH_THRESHOLD))
+        , m_flush_pending(false)
+        , m_flush_deadline()
+        , m_flush_strand(get_call_pool())
+        , m_db(get_db(m_db_page_size, m_db_memory_kb, m_db_temp_store))
+        , m_lookup_index(std::make_unique<lookup_index>())
+    {
+        prepare_statements();
+        if (m_flush_interval.count()) {
+            // Background saves rely on the connection mutex to serialize
+            // the DB between statements issued from other threads
+            GDK_RUNTIME_ASSERT(sqlite3_db_mutex(m_db.get()) != nullptr);
+        }
+    }
+
+    void cache::prepare_statements()
+    {
+        m_stmt_liquid_blinding_key_insert = get_stmt(
+            m_is_liquid, m_db, "INSERT OR IGNORE INTO LiquidBlindingPubKey (script, pubkey) VALUES (?1, ?2);");
+        m_stmt_liquid_blinding_nonce_insert = get_stmt(m_is_liquid, m_db,
+            "INSERT OR IGNORE INTO LiquidBlindingNonce (pubkey, script, nonce) VALUES (?1, ?2, ?3);");
+        m_stmt_liquid_output_search = get_stmt(
+            m_is_liquid, m_db, "SELECT assetid, satoshi, abf, vbf FROM LiquidOutput WHERE txid = ?1 AND vout = ?2;");
+        m_stmt_liquid_output_insert = get_stmt(m_is_liquid, m_db,
+            "INSERT INTO LiquidOutput (txid, vout, assetid, satoshi, abf, vbf) VALUES (?1, ?2, ?3, ?4, ?5, ?6);");
+        m_stmt_key_value_upsert = get_stmt(
+            true, m_db, "INSERT INTO KeyValue(key, value) VALUES (?1, ?2) ON CONFLICT(key) DO UPDATE SET value=?2;");
+        m_stmt_key_value_search = get_stmt(true, m_db, KV_SELECT);
+        m_stmt_key_value_delete = get_stmt(true, m_db, "DELETE FROM KeyValue WHERE key = ?1;");
+        m_stmt_tx_search = get_stmt(true, m_db, TX_SELECT);
+        m_stmt_tx_before_search = get_stmt(true, m_db, TX_SELECT_BEFORE);
+        m_stmt_txid_search = get_stmt(true, m_db, TXID_SELECT);
+        m_stmt_tx_latest_search = get_stmt(true, m_db, TX_LATEST);
+        m_stmt_tx_earliest_mempool_search = get_stmt(true, m_db, TX_EARLIEST_MEMPOOL);
+        m_stmt_tx_earliest_block_search = get_stmt(true, m_db, TX_EARLIEST_BLOCK);
+        m_stmt_tx_upsert = get_stmt(true, m_db, TX_UPSERT);
+        m_stmt_tx_spv_update = get_stmt(true, m_db, TX_SPV_UPDATE);
+        m_stmt_tx_delete_all = get_stmt(true, m_db, TX_DELETE_ALL);
+        m_stmt_txasset_insert = get_stmt(true, m_db, TXASSET_INSERT);
+        m_stmt_txasset_delete = get_stmt(true, m_db, TXASSET_DELETE);
+        m_stmt_txaddress_insert = get_stmt(true, m_db, TXADDRESS_INSERT);
+        m_stmt_txaddress_delete = get_stmt(true, m_db, TXADDRESS_DELETE);
+        m_stmt_txdata_insert = get_stmt(true, m_db, TXDATA_INSERT);
+        m_stmt_txdata_search = get_stmt(true, m_db, TXDATA_SELECT);
+        m_stmt_scriptpubkey_insert = get_stmt(true, m_db,
+            "INSERT OR IGNORE INTO ScriptPubKey (scriptpubkey, subaccount, branch, pointer, subtype, script_type) "
+            "VALUES (?1, ?2, ?3, ?4, ?5, ?6);");
+        m_stmt_scriptpubkey_latest_search
+            = get_stmt(true, m_db, "SELECT MAX(pointer) FROM ScriptPubKey WHERE subaccount = ?1;");
+    }
+
+    cache::~cache()
+    {
+        // Wait for any background save, then save any pending changes
+        no_std_exception_escape([this] { m_flush_strand.stop(); }, "cache flush stop");
+        no_std_exception_escape([this] { flush(); }, "cache flush");
+    }
 
     const std::string& cache::get_network_name() const { return m_network_name; }
 
     bool cache::check_db_changed()
     {
         const bool changed = sqlite3_changes(m_db.get()) != 0;
-        m_require_write |= changed;
+        if (changed) {
+            m_require_write = true;
+        }
         return changed;
     }
 
     void cache::save_db()
     {
-        if (m_db_name.empty() || !m_require_write) {
+        if (!m_require_write) {
             return;
         }
+        if (!m_flush_interval.count()) {
+            flush();
+            return;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        const int unsaved_changes = sqlite3_total_changes(m_db.get()) - m_last_saved_changes;
+        {
+            std::unique_lock<std::mutex> locker(m_flush_mutex);
+            if (unsaved_changes >= m_flush_threshold) {
+                schedule_flush(now); // Save as soon as possible
+            } else if (!m_flush_pending) {
+                schedule_flush(now + m_flush_interval);
+            }
+            // Otherwise already scheduled; coalesce with the pending save
+        }
+    }
+
+    void cache::flush()
+    {
+        std::unique_lock<std::mutex> locker(m_save_mutex);
+        bool saved = false;
+        std::exception_ptr error;
+        try {
+            saved = save_db_impl();
+        } catch (const std::exception& e) {
+            GDK_LOG_SEV(log_level::error) << "cache save failed: " << e.what();
+            error = std::current_exception();
+        }
+        {
+            std::unique_lock<std::mutex> flush_locker(m_flush_mutex);
+            if (saved && !m_require_write) {
+                m_flush_pending = false; // Changes made while saving remain pending
+            } else if (!saved && m_flush_interval.count()) {
+                // Retry in the background after the next interval
+                schedule_flush(std::chrono::steady_clock::now() + m_flush_interval);
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    bool cache::save_db_impl()
+    {
+        GDK_TRACE_SPAN("cache::save_db");
+        // Caller must hold m_save_mutex. Returns false if the save must be retried later
+        if (m_db_name.empty() || !m_require_write) {
+            return true;
+        }
         sqlite3_int64 db_size;
-        void* db = sqlite3_serialize(m_db.get(), "main", &db_size, 0);
+        void* db;
+        uint32_t page_size;
+        {
+            // Hold the connection mutex so no statement can run while we
+            // check for an open transaction and take our copy of the DB
+            sqlite3_mutex* db_mutex = sqlite3_db_mutex(m_db.get());
+            sqlite3_mutex_enter(db_mutex);
+            const auto _db_mutex_leave = gsl::finally([db_mutex] { sqlite3_mutex_leave(db_mutex); });
+            if (!sqlite3_get_autocommit(m_db.get())) {
+                return false; // Don't persist a partially applied transaction
+            }
+            page_size = get_page_size(m_db);
+            // Clear before serializing so changes made after this point are saved next time
+            m_require_write = false;
+            m_last_saved_changes = sqlite3_total_changes(m_db.get());
+            db = sqlite3_serialize(m_db.get(), "main", &db_size, 0);
+        }
         const auto _stmt_clean = gsl::finally([&db] { sqlite3_free(db); });
         if (db == nullptr || db_size < 1) {
-            return;
+            return true;
         }
         const auto data = gsl::make_span(reinterpret_cast<const unsigned char*>(db), db_size);
         const auto path = get_persistent_storage_file(m_data_dir, m_db_name, VERSION);
-        save_db_file(m_encryption_key, data, path);
-        m_require_write = false;
+        try {
+            save_db_file(m_encryption_key, data, page_size, path, m_page_digests);
+        } catch (const std::exception&) {
+            m_require_write = true;
+            throw;
+        }
+        return true;
+    }
+
+    void cache::schedule_flush(std::chrono::steady_clock::time_point deadline)
+    {
+        // Caller must hold m_flush_mutex. Each deadline set has its own
+        // task, which saves only if the save is still due when it runs
+        m_flush_pending = true;
+        m_flush_deadline = deadline;
+        m_flush_strand.post_at(deadline, [this] { flush_task(); });
+    }
+
+    void cache::flush_task()
+    {
+        {
+            std::unique_lock<std::mutex> locker(m_flush_mutex);
+            if (!m_flush_pending || std::chrono::steady_clock::now() < m_flush_deadline) {
+                return; // Saved by an explicit flush() call, or rescheduled
+            }
+        }
+        bool saved = false;
+        {
+            std::unique_lock<std::mutex> save_locker(m_save_mutex);
+            try {
+                saved = save_db_impl();
+            } catch (const std::exception& e) {
+                GDK_LOG_SEV(log_level::error) << "cache save failed: " << e.what();
+            }
+        }
+        std::unique_lock<std::mutex> locker(m_flush_mutex);
+        if (saved && !m_require_write) {
+            m_flush_pending = false;
+        } else if (m_flush_pending) {
+            // The save failed, a transaction was in progress, or changes
+            // were made while saving: save again after the next interval
+            schedule_flush(std::chrono::steady_clock::now() + m_flush_interval);
+        }
     }
 
     void cache::load_db(byte_span_t encryption_key, std::shared_ptr<signer> signer)
     {
+        GDK_TRACE_SPAN("cache::load_db");
         GDK_RUNTIME_ASSERT(!encryption_key.empty());
+        std::unique_lock<std::mutex> locker(m_save_mutex);
 
         m_type = signer->is_watch_only() ? CT_WO : signer->is_hardware() ? CT_HW : CT_SW;
         const auto intermediate = hmac_sha512(encryption_key, ustring_span(m_network_name));
@@ -470,14 +1134,18 @@ namespace sdk {
         m_encryption_key = sha256(encryption_key);
 
         const auto path = get_persistent_storage_file(m_data_dir, m_db_name, VERSION);
-        if (!load_db_impl(m_encryption_key, path, m_db)) {
+        m_lookup_index->clear(); // Reloaded on next use from the loaded DB
+        const bool loaded = load_db_impl(m_encryption_key, path, m_db, m_page_digests);
+        prepare_statements(); // The DB contents have been replaced
+        if (!loaded) {
             // Failed to load the latest version.
             if (VERSION > 1) {
                 // Try to carry forward our client blob from the previous version
                 try {
                     const auto prev_path = get_persistent_storage_file(m_data_dir, m_db_name, VERSION - 1);
-                    auto db{ get_db() };
-                    if (load_db_impl(m_encryption_key, prev_path, db)) {
+                    auto db{ get_db(m_db_page_size, m_db_memory_kb, m_db_temp_store) };
+                    page_digests_t prev_digests;
+                    if (load_db_impl(m_encryption_key, prev_path, db, prev_digests)) {
                         auto stmt{ get_stmt(true, db, KV_SELECT) };
                         const auto _{ stmt_clean(stmt) };
                         const char* blob_key = "client_blob";
@@ -513,6 +1181,7 @@ namespace sdk {
             // Clean up old versions only on initial DB creation
             clean_up_old_db(m_data_dir, m_db_name);
         }
+        set_db_pragmas(m_db, m_db_memory_kb, m_db_temp_store);
     }
 
     void cache::update_to_latest_minor_version()
@@ -530,10 +1199,34 @@ namespace sdk {
                 // Delete pre-v1 blinding data, tx will be deleted below
                 exec_sql(m_db, "DELETE FROM LiquidOutput;");
                 exec_sql(m_db, "DELETE FROM LiquidBlindingNonce;");
+                m_lookup_index->clear();
             }
             if (ver < 3) {
                 // Delete pre-v3 tx's
                 exec_sql(m_db, "DELETE FROM Tx;");
+            } else if (ver < 4) {
+                // Upserting an existing tx previously replaced its msgpack data
+                // with its block height. Delete the tx's of any affected
+                // subaccounts so they are re-synced in full
+                exec_sql(m_db,
+                    "DELETE FROM Tx WHERE subaccount IN "
+                    "(SELECT DISTINCT subaccount FROM Tx WHERE typeof(data) != 'blob');");
+            }
+            if (ver < 5) {
+                // Populate the search columns of the remaining tx's
+                db_transaction txn(m_db);
+                exec_sql(m_db, "DELETE FROM TxAsset;");
+                exec_sql(m_db, "DELETE FROM TxAddress;");
+                auto stmt{ get_stmt(true, m_db, "SELECT subaccount, timestamp, data FROM Tx;") };
+                const auto _{ stmt_clean(stmt) };
+                while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+                    const uint32_t subaccount = get_uint32(stmt, 0);
+                    const uint64_t timestamp = sqlite3_column_int64(stmt.get(), 1);
+                    const auto data = get_row_blob(stmt, 2);
+                    const auto tx_json = nlohmann::json::from_msgpack(data.begin(), data.end());
+                    insert_transaction_search_impl(subaccount, timestamp, tx_json);
+                }
+                txn.commit();
             }
 
             const std::array<unsigned char, 2> new_ver = { 0x00, MINOR_VERSION };
@@ -573,6 +1266,96 @@ namespace sdk {
         }
     }
 
+    void cache::get_transactions_before(
+        uint32_t subaccount, uint64_t before_ts, size_t count, const cache::get_transactions_fn& callback)
+    {
+        const auto _{ stmt_clean(m_stmt_tx_before_search) };
+        bind_int(m_stmt_tx_before_search, 1, subaccount);
+        bind_int(m_stmt_tx_before_search, 2, before_ts);
+        bind_int(m_stmt_tx_before_search, 3, count);
+        while (get_tx(m_stmt_tx_before_search, callback)) {
+            // No-op
+        }
+    }
+
+    void cache::search_transactions(uint32_t subaccount, const transaction_search& search,
+        std::optional<uint64_t> before_ts, uint64_t start, size_t count, const cache::get_transactions_fn& callback)
+    {
+        if (search.txhashes.has_value() && search.txhashes->empty()) {
+            return; // No txs can match
+        }
+        // Build the query from the given criteria. ?1 is the subaccount
+        using param_t = std::variant<int64_t, std::string>;
+        std::vector<param_t> params;
+        const auto add_param = [&params](param_t param) {
+            params.emplace_back(std::move(param));
+            return "?" + std::to_string(params.size() + 1);
+        };
+
+        std::string sql(TX_SEARCH_SELECT);
+        if (search.address.has_value()) {
+            sql += " AND timestamp IN (SELECT timestamp FROM TxAddress WHERE subaccount = ?1 AND address = ";
+            sql += add_param(search.address.value()) + ")";
+        }
+        if (search.asset_id.has_value() || search.min_satoshi.has_value() || search.max_satoshi.has_value()) {
+            sql += " AND timestamp IN (SELECT timestamp FROM TxAsset WHERE subaccount = ?1";
+            if (search.asset_id.has_value()) {
+                sql += " AND asset = " + add_param(search.asset_id.value());
+            }
+            if (search.min_satoshi.has_value()) {
+                sql += " AND satoshi >= " + add_param(search.min_satoshi.value());
+            }
+            if (search.max_satoshi.has_value()) {
+                sql += " AND satoshi <= " + add_param(search.max_satoshi.value());
+            }
+            sql += ")";
+        }
+        if (search.min_block.has_value()) {
+            sql += " AND block >= " + add_param(int64_t{ search.min_block.value() });
+        }
+        if (search.max_block.has_value()) {
+            // Only confirmed txs are below a block height
+            sql += " AND block != 0 AND block <= " + add_param(int64_t{ search.max_block.value() });
+        }
+        const auto _clear_txids = gsl::finally([this, &search] {
+            if (search.txhashes.has_value()) {
+                no_std_exception_escape([this] { exec_sql(m_db, SEARCH_TXID_DELETE); }, "cache search");
+            }
+        });
+        if (search.txhashes.has_value()) {
+            exec_sql(m_db, SEARCH_TXID_CREATE);
+            auto insert_stmt{ get_stmt(true, m_db, SEARCH_TXID_INSERT) };
+            db_transaction txn(m_db);
+            for (const auto& txhash_hex : search.txhashes.value()) {
+                const auto _{ stmt_clean(insert_stmt) };
+                bind_blob(insert_stmt, 1, h2b_rev<WALLY_TXHASH_LEN>(txhash_hex));
+                step_final(insert_stmt);
+            }
+            txn.commit();
+            sql += " AND txid IN (SELECT txid FROM temp.SearchTxid)";
+        }
+        if (before_ts.has_value()) {
+            sql += " AND timestamp < " + add_param(static_cast<int64_t>(before_ts.value()));
+        }
+        sql += " ORDER BY timestamp DESC LIMIT " + add_param(static_cast<int64_t>(count));
+        sql += " OFFSET " + add_param(static_cast<int64_t>(start)) + ";";
+
+        auto stmt{ get_stmt(true, m_db, sql.c_str()) };
+        const auto _{ stmt_clean(stmt) };
+        bind_int(stmt, 1, subaccount);
+        for (size_t i = 0; i < params.size(); ++i) {
+            const int column = static_cast<int>(i) + 2;
+            if (const auto* v = std::get_if<int64_t>(&params[i])) {
+                bind_signed_int(stmt, column, *v);
+            } else {
+                bind_blob(stmt, column, ustring_span(std::get<std::string>(params[i])));
+            }
+        }
+        while (get_tx(stmt, callback)) {
+            // No-op
+        }
+    }
+
     void cache::get_transaction(
         uint32_t subaccount, const std::string& txhash_hex, const cache::get_transactions_fn& callback)
     {
@@ -595,6 +1378,28 @@ namespace sdk {
         get_blob(m_stmt_txdata_search, 0, callback);
     }
 
+    wally_tx_ptr cache::get_transaction_tx(const std::string& txhash_hex, uint32_t flags)
+    {
+        const auto txid = h2b_rev<WALLY_TXHASH_LEN>(txhash_hex);
+        const auto _{ stmt_clean(m_stmt_txdata_search) };
+        bind_blob(m_stmt_txdata_search, 1, txid);
+        const int rc = sqlite3_step(m_stmt_txdata_search.get());
+        if (rc == SQLITE_DONE) {
+            return {};
+        }
+        GDK_RUNTIME_ASSERT(rc == SQLITE_ROW);
+        const auto res = reinterpret_cast<const unsigned char*>(sqlite3_column_blob(m_stmt_txdata_search.get(), 0));
+        const auto len = sqlite3_column_bytes(m_stmt_txdata_search.get(), 0);
+        wally_tx_ptr tx;
+        try {
+            tx = tx_from_bin(gsl::make_span(res, len), flags);
+        } catch (const std::exception& ex) {
+            GDK_LOG_SEV(log_level::error) << "Bad cached tx " << txhash_hex << ": " << ex.what();
+        }
+        step_final(m_stmt_txdata_search);
+        return tx;
+    }
+
     void cache::insert_transaction_data(const std::string& txhash_hex, byte_span_t value)
     {
         GDK_RUNTIME_ASSERT(!txhash_hex.empty() && !value.empty());
@@ -631,11 +1436,70 @@ namespace sdk {
         return db_block;
     }
 
+    nlohmann::json cache::get_block_hashes()
+    {
+        // Stored as a msgpack array of [height, block_hash] in height order
+        nlohmann::json block_hashes = nlohmann::json::array();
+        get_key_value("block_hashes", { [&block_hashes](const auto& db_blob) {
+            if (db_blob.has_value()) {
+                block_hashes = nlohmann::json::from_msgpack(db_blob->begin(), db_blob->end());
+            }
+        } });
+        return block_hashes;
+    }
+
+    void cache::set_block_hash(uint32_t height, const std::string& block_hash, uint32_t max_blocks)
+    {
+        auto block_hashes = get_block_hashes();
+        auto& entries = block_hashes.get_ref<nlohmann::json::array_t&>();
+        // Any blocks at or above this height have been replaced
+        const auto replaced = std::find_if(entries.begin(), entries.end(),
+            [height](const nlohmann::json& e) { return e.at(0).get<uint32_t>() >= height; });
+        entries.erase(replaced, entries.end());
+        entries.push_back({ height, block_hash });
+        if (entries.size() > max_blocks) {
+            entries.erase(entries.begin(), entries.end() - max_blocks);
+        }
+        upsert_key_value("block_hashes", nlohmann::json::to_msgpack(block_hashes));
+    }
+
+    std::optional<uint32_t> cache::get_block_height(const std::string& block_hash)
+    {
+        for (const auto& e : get_block_hashes()) {
+            if (e.at(1) == block_hash) {
+                return e.at(0).get<uint32_t>();
+            }
+        }
+        return std::nullopt;
+    }
+
     void cache::insert_transaction(
         uint32_t subaccount, uint64_t timestamp, const std::string& txhash_hex, const nlohmann::json& tx_json)
     {
-        const auto txid = h2b_rev(txhash_hex);
-        const auto tx_data = nlohmann::json::to_msgpack(tx_json);
+        insert_transaction_impl(subaccount, timestamp, txhash_hex, tx_json);
+        m_require_write = true;
+    }
+
+    void cache::insert_transactions(uint32_t subaccount, const std::vector<transaction_row>& rows)
+    {
+        if (rows.empty()) {
+            return;
+        }
+        db_transaction txn(m_db);
+        for (const auto& row : rows) {
+            insert_transaction_impl(subaccount, row.timestamp, row.txhash_hex, *row.tx_json);
+        }
+        txn.commit();
+        m_require_write = true;
+    }
+
+    void cache::insert_transaction_impl(
+        uint32_t subaccount, uint64_t timestamp, const std::string& txhash_hex, const nlohmann::json& tx_json)
+    {
+        const auto txid = h2b_rev<WALLY_TXHASH_LEN>(txhash_hex);
+        // Serialize into a buffer whose capacity is reused across inserts
+        m_tx_data_buffer.clear();
+        nlohmann::json::to_msgpack(tx_json, m_tx_data_buffer);
         const auto _{ stmt_clean(m_stmt_tx_upsert) };
         bind_int(m_stmt_tx_upsert, 1, subaccount);
         bind_int(m_stmt_tx_upsert, 2, timestamp);
@@ -643,9 +1507,51 @@ namespace sdk {
         bind_int(m_stmt_tx_upsert, 4, tx_json.at("block_height"));
         bind_int(m_stmt_tx_upsert, 5, 0); // 0 = Unknown spent status
         bind_int(m_stmt_tx_upsert, 6, 3); // SPV_STATUS_DISABLED
-        bind_blob(m_stmt_tx_upsert, 7, tx_data);
+        bind_blob(m_stmt_tx_upsert, 7, m_tx_data_buffer);
         step_final(m_stmt_tx_upsert);
-        m_require_write = true;
+        delete_transaction_search_impl(subaccount, timestamp, timestamp);
+        insert_transaction_search_impl(subaccount, timestamp, tx_json);
+    }
+
+    void cache::insert_transaction_search_impl(uint32_t subaccount, uint64_t timestamp, const nlohmann::json& tx_json)
+    {
+        if (const auto satoshi_p = tx_json.find("satoshi"); satoshi_p != tx_json.end()) {
+            for (const auto& it : satoshi_p->items()) {
+                const auto _{ stmt_clean(m_stmt_txasset_insert) };
+                bind_int(m_stmt_txasset_insert, 1, subaccount);
+                bind_int(m_stmt_txasset_insert, 2, timestamp);
+                bind_blob(m_stmt_txasset_insert, 3, ustring_span(it.key()));
+                bind_signed_int(m_stmt_txasset_insert, 4, it.value().get<int64_t>());
+                step_final(m_stmt_txasset_insert);
+            }
+        }
+        for (const char* key : { "inputs", "outputs" }) {
+            const auto eps_p = tx_json.find(key);
+            if (eps_p == tx_json.end()) {
+                continue;
+            }
+            for (const auto& ep : *eps_p) {
+                const std::string address = json_get_value(ep, "address");
+                if (!address.empty()) {
+                    const auto _{ stmt_clean(m_stmt_txaddress_insert) };
+                    bind_int(m_stmt_txaddress_insert, 1, subaccount);
+                    bind_int(m_stmt_txaddress_insert, 2, timestamp);
+                    bind_blob(m_stmt_txaddress_insert, 3, ustring_span(address));
+                    step_final(m_stmt_txaddress_insert);
+                }
+            }
+        }
+    }
+
+    void cache::delete_transaction_search_impl(uint32_t subaccount, uint64_t start_ts, uint64_t end_ts)
+    {
+        for (auto* stmt : { &m_stmt_txasset_delete, &m_stmt_txaddress_delete }) {
+            const auto _{ stmt_clean(*stmt) };
+            bind_int(*stmt, 1, subaccount);
+            bind_int(*stmt, 2, start_ts);
+            bind_int(*stmt, 3, end_ts);
+            step_final(*stmt);
+        }
     }
 
     void cache::set_transaction_spv_verified(const std::string& txhash_hex)
@@ -660,6 +1566,7 @@ namespace sdk {
 
     void cache::delete_transactions(uint32_t subaccount, uint64_t start_ts)
     {
+        delete_transaction_search_impl(subaccount, start_ts, MAX_TIMESTAMP);
         const auto _{ stmt_clean(m_stmt_tx_delete_all) };
         bind_int(m_stmt_tx_delete_all, 1, subaccount);
         bind_int(m_stmt_tx_delete_all, 2, start_ts);
@@ -702,45 +1609,108 @@ namespace sdk {
 
     void cache::on_new_transaction(uint32_t subaccount, const std::string& txhash_hex)
     {
-        nlohmann::json existing_tx;
-        uint32_t existing_tx_block = 0;
+        on_new_transactions(subaccount, { txhash_hex });
+    }
 
-        get_transaction(subaccount, txhash_hex,
-            { [&existing_tx, &existing_tx_block](uint64_t /*ts*/, const std::string& /*txhash*/, uint32_t block,
-                  uint32_t /*spent*/, uint32_t /*spv_status*/, nlohmann::json& tx_json) {
-                existing_tx = std::move(tx_json);
-                existing_tx_block = block;
-            } });
+    void cache::on_new_transactions(uint32_t subaccount, const std::vector<std::string>& txhashes)
+    {
+        uint32_t min_existing_tx_block = 0;
+
+        for (const auto& txhash_hex : txhashes) {
+            get_transaction(subaccount, txhash_hex,
+                { [&min_existing_tx_block](uint64_t /*ts*/, const std::string& /*txhash*/, uint32_t block,
+                      uint32_t /*spent*/, uint32_t /*spv_status*/, nlohmann::json& /*tx_json*/) {
+                    if (block && (!min_existing_tx_block || block < min_existing_tx_block)) {
+                        min_existing_tx_block = block;
+                    }
+                } });
+        }
 
-        if (!existing_tx.empty() && existing_tx_block != 0) {
+        if (min_existing_tx_block != 0) {
             // We have been notified of a confirmed tx we already had cached as confirmed.
             // Either the tx was reorged or the server is re-processing txs; either way
-            // remove all cached txs from the block the tx was originally in onwards, along
-            // with any mempool txs.
-            delete_block_txs(subaccount, existing_tx_block);
+            // remove all cached txs from the earliest block such a tx was originally in
+            // onwards, along with any mempool txs.
+            delete_block_txs(subaccount, min_existing_tx_block);
             // Fall through to delete mempool txs
         }
-        // Otherwise, we haven't seen this tx yet, or we've been re-notified of a mempool tx.
-        // Remove any mempool txs this tx could be double spending/replacing
+        // Otherwise, we haven't seen these txs yet, or we've been re-notified of mempool txs.
+        // Remove any mempool txs they could be double spending/replacing
         delete_mempool_txs(subaccount);
     }
 
+    size_t cache::get_memory_usage()
+    {
+        size_t total = m_lookup_index->get_memory_usage() + m_tx_data_buffer.capacity();
+        for (const int op : { SQLITE_DBSTATUS_CACHE_USED, SQLITE_DBSTATUS_SCHEMA_USED, SQLITE_DBSTATUS_STMT_USED }) {
+            int current = 0, highwater = 0;
+            if (sqlite3_db_status(m_db.get(), op, &current, &highwater, 0) == SQLITE_OK) {
+                total += current;
+            }
+        }
+        // A DB loaded from disk is held in a separate buffer from the page cache
+        sqlite3_int64 db_size = 0;
+        if (sqlite3_serialize(m_db.get(), "main", &db_size, SQLITE_SERIALIZE_NOCOPY)) {
+            total += db_size;
+        }
+        return total;
+    }
+
+    void cache::trim_memory()
+    {
+        sqlite3_db_release_memory(m_db.get());
+        m_lookup_index->clear(); // Reloaded on next use
+        std::vector<unsigned char>().swap(m_tx_data_buffer);
+    }
+
+    cache::lookup_index& cache::get_lookup_index()
+    {
+        auto& index = *m_lookup_index;
+        if (!index.scriptpubkeys_loaded) {
+            auto stmt{ get_stmt(true, m_db,
+                "SELECT scriptpubkey, subaccount, branch, pointer, subtype, script_type FROM ScriptPubKey;") };
+            const auto _{ stmt_clean(stmt) };
+            while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+                const scriptpubkey_data data = { get_uint32(stmt, 1), get_uint32(stmt, 2), get_uint32(stmt, 3),
+                    get_uint32(stmt, 4), get_uint32(stmt, 5) };
+                index.scriptpubkeys.insert(get_row_blob(stmt, 0), {}, pack_scriptpubkey_data(data));
+            }
+            index.scriptpubkeys_loaded = true;
+        }
+        if (m_is_liquid && !index.blinding_data_loaded) {
+            {
+                auto stmt{ get_stmt(true, m_db, "SELECT script, pubkey FROM LiquidBlindingPubKey;") };
+                const auto _{ stmt_clean(stmt) };
+                while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+                    index.blinding_pubkeys.insert(get_row_blob(stmt, 0), {}, get_row_blob(stmt, 1));
+                }
+            }
+            auto stmt{ get_stmt(true, m_db, "SELECT pubkey, script, nonce FROM LiquidBlindingNonce;") };
+            const auto _{ stmt_clean(stmt) };
+            while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+                index.blinding_nonces.insert(get_row_blob(stmt, 0), get_row_blob(stmt, 1), get_row_blob(stmt, 2));
+            }
+            index.blinding_data_loaded = true;
+        }
+        return index;
+    }
+
     std::vector<unsigned char> cache::get_liquid_blinding_nonce(byte_span_t pubkey, byte_span_t script)
     {
         GDK_RUNTIME_ASSERT(!pubkey.empty() && !script.empty());
-        GDK_RUNTIME_ASSERT(m_stmt_liquid_blinding_nonce_search.get());
-        const auto _{ stmt_clean(m_stmt_liquid_blinding_nonce_search) };
-        bind_blobs(m_stmt_liquid_blinding_nonce_search, pubkey, script);
-        return get_blob(m_stmt_liquid_blinding_nonce_search, 0);
+        GDK_RUNTIME_ASSERT(m_is_liquid);
+        const auto nonce = get_lookup_index().blinding_nonces.find(pubkey, script);
+        return nonce.has_value() ? std::vector<unsigned char>(nonce->begin(), nonce->end())
+                                 : std::vector<unsigned char>();
     }
 
     std::vector<unsigned char> cache::get_liquid_blinding_pubkey(byte_span_t script)
     {
         GDK_RUNTIME_ASSERT(!script.empty());
-        GDK_RUNTIME_ASSERT(m_stmt_liquid_blinding_key_search.get());
-        const auto _{ stmt_clean(m_stmt_liquid_blinding_key_search) };
-        bind_blob(m_stmt_liquid_blinding_key_search, 1, script);
-        return get_blob(m_stmt_liquid_blinding_key_search, 0);
+        GDK_RUNTIME_ASSERT(m_is_liquid);
+        const auto pubkey = get_lookup_index().blinding_pubkeys.find(script);
+        return pubkey.has_value() ? std::vector<unsigned char>(pubkey->begin(), pubkey->end())
+                                  : std::vector<unsigned char>();
     }
 
     nlohmann::json cache::get_liquid_output(byte_span_t txhash, const uint32_t vout)
@@ -804,10 +1774,34 @@ namespace sdk {
             bind_blobs(m_stmt_liquid_blinding_key_insert, script, blinding_pubkey);
             step_final(m_stmt_liquid_blinding_key_insert);
         }
-        return changed | check_db_changed();
+        const bool key_changed = check_db_changed();
+        if (m_lookup_index->blinding_data_loaded) {
+            m_lookup_index->blinding_nonces.insert(pubkey, script, nonce);
+            m_lookup_index->blinding_pubkeys.insert(script, {}, blinding_pubkey);
+        }
+        return changed | key_changed;
     }
 
     void cache::insert_liquid_output(byte_span_t txhash, uint32_t vout, nlohmann::json& utxo)
+    {
+        insert_liquid_output_impl(txhash, vout, utxo);
+        m_require_write = true;
+    }
+
+    void cache::insert_liquid_outputs(const std::vector<liquid_output_row>& rows)
+    {
+        if (rows.empty()) {
+            return;
+        }
+        db_transaction txn(m_db);
+        for (const auto& row : rows) {
+            insert_liquid_output_impl(row.txhash, row.vout, *row.utxo);
+        }
+        txn.commit();
+        m_require_write = true;
+    }
+
+    void cache::insert_liquid_output_impl(byte_span_t txhash, uint32_t vout, const nlohmann::json& utxo)
     {
         GDK_RUNTIME_ASSERT(!txhash.empty() && !utxo.empty());
         GDK_RUNTIME_ASSERT(m_stmt_liquid_output_insert.get());
@@ -817,22 +1811,54 @@ namespace sdk {
         bind_blob(m_stmt_liquid_output_insert, 1, txhash);
 
         bind_int(m_stmt_liquid_output_insert, 2, vout);
-        const auto assetid = h2b_rev(utxo["asset_id"]);
+        const auto assetid = h2b_rev(utxo.at("asset_id"));
         bind_blob(m_stmt_liquid_output_insert, 3, assetid);
 
         bind_int(m_stmt_liquid_output_insert, 4, utxo.at("satoshi"));
 
-        const auto abf = h2b_rev(utxo["assetblinder"]);
+        const auto abf = h2b_rev(utxo.at("assetblinder"));
         bind_blob(m_stmt_liquid_output_insert, 5, abf);
-        const auto vbf = h2b_rev(utxo["amountblinder"]);
+        const auto vbf = h2b_rev(utxo.at("amountblinder"));
         bind_blob(m_stmt_liquid_output_insert, 6, vbf);
 
         step_final(m_stmt_liquid_output_insert);
-        m_require_write = true;
     }
 
     void cache::insert_scriptpubkey_data(byte_span_t scriptpubkey, uint32_t subaccount, uint32_t branch,
         uint32_t pointer, uint32_t subtype, uint32_t script_type)
+    {
+        insert_scriptpubkey_data_impl(scriptpubkey, subaccount, branch, pointer, subtype, script_type);
+        if (m_lookup_index->scriptpubkeys_loaded) {
+            const scriptpubkey_data data = { subaccount, branch, pointer, subtype, script_type };
+            m_lookup_index->scriptpubkeys.insert(scriptpubkey, {}, pack_scriptpubkey_data(data));
+        }
+        m_require_write = true;
+    }
+
+    void cache::insert_scriptpubkey_data(const std::vector<scriptpubkey_row>& rows)
+    {
+        if (rows.empty()) {
+            return;
+        }
+        db_transaction txn(m_db);
+        for (const auto& row : rows) {
+            insert_scriptpubkey_data_impl(
+                row.scriptpubkey, row.subaccount, row.branch, row.pointer, row.subtype, row.script_type);
+        }
+        txn.commit();
+        if (m_lookup_index->scriptpubkeys_loaded) {
+            // Only index the rows once they are committed
+            for (const auto& row : rows) {
+                const scriptpubkey_data data
+                    = { row.subaccount, row.branch, row.pointer, row.subtype, row.script_type };
+                m_lookup_index->scriptpubkeys.insert(row.scriptpubkey, {}, pack_scriptpubkey_data(data));
+            }
+        }
+        m_require_write = true;
+    }
+
+    void cache::insert_scriptpubkey_data_impl(byte_span_t scriptpubkey, uint32_t subaccount, uint32_t branch,
+        uint32_t pointer, uint32_t subtype, uint32_t script_type)
     {
         GDK_RUNTIME_ASSERT(!scriptpubkey.empty());
         GDK_RUNTIME_ASSERT(pointer > 0);
@@ -848,29 +1874,29 @@ namespace sdk {
         bind_int(m_stmt_scriptpubkey_insert, 6, script_type);
 
         step_final(m_stmt_scriptpubkey_insert);
-        m_require_write = true;
     }
 
-    nlohmann::json cache::get_scriptpubkey_data(byte_span_t scriptpubkey)
+    std::optional<cache::scriptpubkey_data> cache::find_scriptpubkey_data(byte_span_t scriptpubkey)
     {
-        nlohmann::json utxo;
-
         GDK_RUNTIME_ASSERT(!scriptpubkey.empty());
-        GDK_RUNTIME_ASSERT(m_stmt_scriptpubkey_search.get());
-        const auto _{ stmt_clean(m_stmt_scriptpubkey_search) };
-        bind_blob(m_stmt_scriptpubkey_search, 1, scriptpubkey);
-        const int rc = sqlite3_step(m_stmt_scriptpubkey_search.get());
-        if (rc == SQLITE_DONE) {
-            return utxo;
+        const auto packed = get_lookup_index().scriptpubkeys.find(scriptpubkey);
+        if (!packed.has_value()) {
+            return std::nullopt;
         }
-        GDK_RUNTIME_ASSERT(rc == SQLITE_ROW);
-        utxo["subaccount"] = get_uint32(m_stmt_scriptpubkey_search, 0);
-        utxo["branch"] = get_uint32(m_stmt_scriptpubkey_search, 1);
-        utxo["pointer"] = get_uint32(m_stmt_scriptpubkey_search, 2);
-        utxo["subtype"] = get_uint32(m_stmt_scriptpubkey_search, 3);
-        utxo["script_type"] = get_uint32(m_stmt_scriptpubkey_search, 4);
+        return unpack_scriptpubkey_data(packed.value());
+    }
 
-        step_final(m_stmt_scriptpubkey_search);
+    nlohmann::json cache::get_scriptpubkey_data(byte_span_t scriptpubkey)
+    {
+        nlohmann::json utxo;
+        const auto data = find_scriptpubkey_data(scriptpubkey);
+        if (data.has_value()) {
+            utxo["subaccount"] = data->subaccount;
+            utxo["branch"] = data->branch;
+            utxo["pointer"] = data->pointer;
+            utxo["subtype"] = data->subtype;
+            utxo["script_type"] = data->script_type;
+        }
         return utxo;
     }
 
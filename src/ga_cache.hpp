@@ -4,6 +4,10 @@
 
 #include "ga_wally.hpp"
 #include "gsl_wrapper.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <optional>
 
@@ -19,6 +23,47 @@ namespace sdk {
         using sqlite3_ptr = std::shared_ptr<struct ::sqlite3>;
         using sqlite3_stmt_ptr = std::shared_ptr<struct ::sqlite3_stmt>;
 
+        struct transaction_row {
+            uint64_t timestamp;
+            std::string txhash_hex;
+            const nlohmann::json* tx_json;
+        };
+
+        // Criteria for search_transactions. Unset criteria match any tx
+        struct transaction_search {
+            std::optional<std::string> address; // An input or output address
+            std::optional<std::string> asset_id; // An asset the tx changed the balance of
+            std::optional<int64_t> min_satoshi; // Minimum signed balance change of an asset
+            std::optional<int64_t> max_satoshi; // Maximum signed balance change of an asset
+            std::optional<uint32_t> min_block; // Minimum confirmed block height
+            std::optional<uint32_t> max_block; // Maximum confirmed block height
+            std::optional<std::vector<std::string>> txhashes; // Only these txs
+        };
+
+        struct liquid_output_row {
+            std::vector<unsigned char> txhash;
+            uint32_t vout;
+            const nlohmann::json* utxo;
+        };
+
+        // The wallet details of a cached scriptpubkey
+        struct scriptpubkey_data {
+            uint32_t subaccount;
+            uint32_t branch;
+            uint32_t pointer;
+            uint32_t subtype;
+            uint32_t script_type;
+        };
+
+        struct scriptpubkey_row {
+            std::vector<unsigned char> scriptpubkey;
+            uint32_t subaccount;
+            uint32_t branch;
+            uint32_t pointer;
+            uint32_t subtype;
+            uint32_t script_type;
+        };
+
         cache(const network_parameters& net_params, const std::string& network_name);
         ~cache();
 
@@ -26,6 +71,8 @@ namespace sdk {
 
         nlohmann::json get_liquid_output(byte_span_t txhash, const uint32_t vout);
         void insert_liquid_output(byte_span_t txhash, const uint32_t vout, nlohmann::json& utxo);
+        // Insert multiple unblinded outputs in a single database transaction
+        void insert_liquid_outputs(const std::vector<liquid_output_row>& rows);
 
         std::vector<unsigned char> get_liquid_blinding_nonce(byte_span_t pubkey, byte_span_t script);
         std::vector<unsigned char> get_liquid_blinding_pubkey(byte_span_t script);
@@ -40,49 +87,108 @@ namespace sdk {
 
         void set_latest_block(uint32_t block);
         uint32_t get_latest_block();
+        // Record the hash of the block at 'height', discarding any recorded
+        // blocks at or above it, and keeping at most 'max_blocks' hashes
+        void set_block_hash(uint32_t height, const std::string& block_hash, uint32_t max_blocks);
+        // Return the height of a recorded block, or nullopt if it is unknown
+        std::optional<uint32_t> get_block_height(const std::string& block_hash);
 
         typedef std::function<void(uint64_t ts, const std::string& txhash, uint32_t block, uint32_t spent,
             uint32_t spv_status, nlohmann::json& tx_json)>
             get_transactions_fn;
         void get_transactions(
             uint32_t subaccount, uint64_t start_ts, size_t count, const get_transactions_fn& callback);
+        // As get_transactions, returning the txs older than 'before_ts'
+        void get_transactions_before(
+            uint32_t subaccount, uint64_t before_ts, size_t count, const get_transactions_fn& callback);
+        // As get_transactions/get_transactions_before, returning only txs matching 'search'
+        void search_transactions(uint32_t subaccount, const transaction_search& search,
+            std::optional<uint64_t> before_ts, uint64_t start, size_t count, const get_transactions_fn& callback);
         void get_transaction(
             uint32_t subaccount, const std::string& txhash_hex, const cache::get_transactions_fn& callback);
         uint64_t get_latest_transaction_timestamp(uint32_t subaccount);
         void insert_transaction(
             uint32_t subaccount, uint64_t timestamp, const std::string& txhash_hex, const nlohmann::json& tx_json);
+        // Insert multiple transactions in a single DB transaction
+        void insert_transactions(uint32_t subaccount, const std::vector<transaction_row>& rows);
         void set_transaction_spv_verified(const std::string& txhash_hex);
         void delete_transactions(uint32_t subaccount, uint64_t start_ts = 0);
         bool delete_mempool_txs(uint32_t subaccount);
         bool delete_block_txs(uint32_t subaccount, uint32_t start_block);
         void on_new_transaction(uint32_t subaccount, const std::string& txhash_hex);
+        // As on_new_transaction, for multiple txs notified together
+        void on_new_transactions(uint32_t subaccount, const std::vector<std::string>& txhashes);
         void get_transaction_data(const std::string& txhash_hex, const get_key_value_fn& callback);
+        // Returns the cached raw tx parsed directly from the DB, or null if not cached
+        wally_tx_ptr get_transaction_tx(const std::string& txhash_hex, uint32_t flags);
         void insert_transaction_data(const std::string& txhash_hex, byte_span_t value);
 
         nlohmann::json get_scriptpubkey_data(byte_span_t scriptpubkey);
+        // As get_scriptpubkey_data, without building a JSON result
+        std::optional<scriptpubkey_data> find_scriptpubkey_data(byte_span_t scriptpubkey);
         void insert_scriptpubkey_data(byte_span_t scriptpubkey, uint32_t subaccount, uint32_t branch, uint32_t pointer,
             uint32_t subtype, uint32_t script_type);
+        // Insert multiple scriptpubkeys in a single DB transaction
+        void insert_scriptpubkey_data(const std::vector<scriptpubkey_row>& rows);
         uint32_t get_latest_scriptpubkey_pointer(uint32_t subaccount);
 
+        // Schedule any changes to be written to disk in the background
         void save_db();
+        // Write any changes to disk before returning
+        void flush();
         void load_db(byte_span_t encryption_key, std::shared_ptr<signer> signer);
 
         void update_to_latest_minor_version();
 
+        // Return the approximate memory used by the DB and its indices
+        size_t get_memory_usage();
+        // Release memory that can be recreated from the DB on demand
+        void trim_memory();
+
     private:
+        // In-memory indices fronting the scriptpubkey and blinding data tables
+        struct lookup_index;
+
+        // (Re-)prepare the m_stmt_* statements. Required whenever the DB is
+        // replaced, since the new DB's tables may be stored at other pages
+        void prepare_statements();
         bool check_db_changed();
+        lookup_index& get_lookup_index();
+        nlohmann::json get_block_hashes();
+        void insert_transaction_impl(
+            uint32_t subaccount, uint64_t timestamp, const std::string& txhash_hex, const nlohmann::json& tx_json);
+        void insert_transaction_search_impl(uint32_t subaccount, uint64_t timestamp, const nlohmann::json& tx_json);
+        void delete_transaction_search_impl(uint32_t subaccount, uint64_t start_ts, uint64_t end_ts);
+        void insert_liquid_output_impl(byte_span_t txhash, uint32_t vout, const nlohmann::json& utxo);
+        void insert_scriptpubkey_data_impl(byte_span_t scriptpubkey, uint32_t subaccount, uint32_t branch,
+            uint32_t pointer, uint32_t subtype, uint32_t script_type);
+        bool save_db_impl();
+        void schedule_flush(std::chrono::steady_clock::time_point deadline);
+        void flush_task();
 
         const std::string m_network_name;
         const std::string m_data_dir;
         const bool m_is_liquid;
+        const uint32_t m_db_page_size; // SQLite settings from the network parameters
+        const uint32_t m_db_memory_kb;
+        const uint32_t m_db_temp_store;
         uint32_t m_type; // Set on first call to load_db
         std::string m_db_name; // Set on first call to load_db
         std::array<unsigned char, SHA256_LEN> m_encryption_key; // Set on first call to load_db
-        bool m_require_write;
+        std::atomic_bool m_require_write;
+        std::atomic_int m_last_saved_changes; // Total DB changes as of the last save
+        std::vector<std::array<unsigned char, SHA256_LEN>> m_page_digests; // Of the DB pages as last saved to disk
+        std::mutex m_save_mutex; // Serializes writes to the DB file
+        const std::chrono::milliseconds m_flush_interval; // Zero to save synchronously
+        const int m_flush_threshold; // Changes that trigger an immediate save
+        std::mutex m_flush_mutex; // Protects the members below
+        bool m_flush_pending;
+        std::chrono::steady_clock::time_point m_flush_deadline;
+        strand m_flush_strand; // Runs background saves on the shared call pool
         sqlite3_ptr m_db;
-        sqlite3_stmt_ptr m_stmt_liquid_blinding_key_search;
+        std::unique_ptr<lookup_index> m_lookup_index;
+        std::vector<unsigned char> m_tx_data_buffer; // Reused to serialize tx data for insertion
         sqlite3_stmt_ptr m_stmt_liquid_blinding_key_insert;
-        sqlite3_stmt_ptr m_stmt_liquid_blinding_nonce_search;
         sqlite3_stmt_ptr m_stmt_liquid_blinding_nonce_insert;
         sqlite3_stmt_ptr m_stmt_liquid_output_search;
         sqlite3_stmt_ptr m_stmt_liquid_output_insert;
@@ -90,6 +196,7 @@ namespace sdk {
         sqlite3_stmt_ptr m_stmt_key_value_search;
         sqlite3_stmt_ptr m_stmt_key_value_delete;
         sqlite3_stmt_ptr m_stmt_tx_search;
+        sqlite3_stmt_ptr m_stmt_tx_before_search;
         sqlite3_stmt_ptr m_stmt_txid_search;
         sqlite3_stmt_ptr m_stmt_tx_latest_search;
         sqlite3_stmt_ptr m_stmt_tx_earliest_mempool_search;
@@ -97,9 +204,12 @@ namespace sdk {
         sqlite3_stmt_ptr m_stmt_tx_upsert;
         sqlite3_stmt_ptr m_stmt_tx_spv_update;
         sqlite3_stmt_ptr m_stmt_tx_delete_all;
+        sqlite3_stmt_ptr m_stmt_txasset_insert;
+        sqlite3_stmt_ptr m_stmt_txasset_delete;
+        sqlite3_stmt_ptr m_stmt_txaddress_insert;
+        sqlite3_stmt_ptr m_stmt_txaddress_delete;
         sqlite3_stmt_ptr m_stmt_txdata_insert;
         sqlite3_stmt_ptr m_stmt_txdata_search;
-        sqlite3_stmt_ptr m_stmt_scriptpubkey_search;
         sqlite3_stmt_ptr m_stmt_scriptpubkey_insert;
         sqlite3_stmt_ptr m_stmt_scriptpubkey_latest_search;
     };
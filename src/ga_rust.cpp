@@ -158,6 +158,12 @@ namespace sdk {
         return rust_call("discover_subaccount", details, m_session);
     }
 
+    std::vector<bool> ga_rust::discover_subaccounts(const nlohmann::json& subaccounts)
+    {
+        const auto details = nlohmann::json({ { "subaccounts", subaccounts } });
+        return rust_call("discover_subaccounts", details, m_session);
+    }
+
     uint32_t ga_rust::get_next_subaccount(const std::string& type)
     {
         return rust_call("get_next_subaccount", nlohmann::json({ { "type", type } }), m_session);
@@ -29,6 +29,7 @@ namespace sdk {
         bool remove_account(const nlohmann::json& twofactor_data);
 
         bool discover_subaccount(const std::string& xpub, const std::string& type);
+        std::vector<bool> discover_subaccounts(const nlohmann::json& subaccounts);
         uint32_t get_next_subaccount(const std::string& type);
         nlohmann::json create_subaccount(const nlohmann::json& details, uint32_t subaccount, const std::string& xpub);
 
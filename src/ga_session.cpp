@@ -28,9 +28,12 @@
 #include "ga_tx.hpp"
 #include "logging.hpp"
 #include "memory.hpp"
+#include "network_state.hpp"
 #include "signer.hpp"
+#include "thread_pool.hpp"
 #include "threading.hpp"
 #include "transaction_utils.hpp"
+#include "trace.hpp"
 #include "utils.hpp"
 #include "version.h"
 #include "wamp_transport.hpp"
@@ -57,6 +60,16 @@ namespace sdk {
         // Multi-call categories
         constexpr uint32_t MC_TX_CACHE = 0x1; // Call affects the tx cache
 
+        // How long to collect tx notifications for before processing them together
+        constexpr auto TX_NOTIFICATION_DEBOUNCE = std::chrono::milliseconds(250);
+
+        // The cache key and format version of the persisted login snapshot
+        static const std::string LOGIN_SNAPSHOT_KEY("login_snapshot");
+        constexpr uint32_t LOGIN_SNAPSHOT_VERSION = 1;
+
+        // The cache key prefix of individually fetched asset icons
+        static const std::string ASSET_ICON_KEY_PREFIX("icon_");
+
         // Transaction notification fields that we know about.
         // If we see a notification with fields other than these, we ignore
         // it so we don't process it incorrectly (forward compatibility).
@@ -237,13 +250,21 @@ namespace sdk {
             GDK_RUNTIME_ASSERT_MSG(is_valid_utf8(memo), "Transaction memo not a valid utf-8 string");
         }
 
-        static nlohmann::json get_spv_params(const network_parameters& net_params, const nlohmann::json& proxy_settings)
+        static nlohmann::json get_spv_params(const network_parameters& net_params, const nlohmann::json& proxy_settings,
+            const std::optional<pbkdf2_hmac512_t>& local_encryption_key)
         {
             auto np = net_params.get_json();
             np.update(proxy_settings);
             np.erase("wamp_cert_pins"); // WMP certs are huge & unused by SPV, remove them
             np.erase("wamp_cert_roots");
-            return { { "network", std::move(np) } };
+            nlohmann::json spv_params = { { "network", std::move(np) } };
+            if (local_encryption_key) {
+                // Persist verified txs to an encrypted on-disk cache, so that
+                // txs within reorg depth are not re-verified on the next login.
+                // The cache is invalidated beyond reorg depth if a reorg occurs.
+                spv_params["encryption_key"] = b2h(sha256(*local_encryption_key));
+            }
+            return spv_params;
         }
 
         // Get cached xpubs from a signer as a cacheable json format
@@ -257,6 +278,56 @@ namespace sdk {
             }
             return xpubs_json;
         }
+
+        // Get the cache search criteria from a GA_get_transactions "search" element
+        static cache::transaction_search get_transaction_search(const nlohmann::json& search)
+        {
+            if (!search.is_object()) {
+                throw user_error("invalid search");
+            }
+            cache::transaction_search ret;
+            ret.address = json_get_optional<std::string>(search, "address");
+            ret.asset_id = json_get_optional<std::string>(search, "asset_id");
+            ret.min_satoshi = json_get_optional<int64_t>(search, "min_satoshi");
+            ret.max_satoshi = json_get_optional<int64_t>(search, "max_satoshi");
+            ret.min_block = json_get_optional<uint32_t>(search, "min_block_height");
+            ret.max_block = json_get_optional<uint32_t>(search, "max_block_height");
+            return ret;
+        }
+
+        // A private key being swept, with the key data its UTXOs are signed with
+        struct sweep_key_t {
+            std::vector<unsigned char> private_key;
+            std::vector<unsigned char> public_key;
+            std::vector<unsigned char> script;
+            bool compressed;
+        };
+
+        static sweep_key_t get_sweep_key(const std::string& private_key, const std::string& password, bool is_main_net)
+        {
+            sweep_key_t key;
+            std::tie(key.private_key, key.compressed) = to_private_key_bytes(private_key, password, is_main_net);
+            key.public_key = ec_public_key_from_private_key(gsl::make_span(key.private_key));
+            if (!key.compressed) {
+                key.public_key = ec_public_key_decompress(key.public_key);
+            }
+            key.script = scriptpubkey_p2pkh_from_hash160(hash160(key.public_key));
+            return key;
+        }
+
+        static void set_sweep_utxos_key(nlohmann::json& utxos, const sweep_key_t& key)
+        {
+            const auto private_key_hex = b2h(key.private_key);
+            const auto public_key_hex = b2h(key.public_key);
+            const auto script_hex = b2h(key.script);
+            for (auto& utxo : utxos) {
+                utxo["private_key"] = private_key_hex;
+                utxo["compressed"] = key.compressed;
+                utxo["public_key"] = public_key_hex;
+                utxo["prevout_script"] = script_hex;
+                utxo["script_type"] = script_type::ga_pubkey_hash_out;
+            }
+        }
     } // namespace
 
     ga_session::ga_session(network_parameters&& net_params)
@@ -274,6 +345,8 @@ namespace sdk {
         , m_watch_only(true)
         , m_tx_last_notification(std::chrono::system_clock::now())
         , m_last_block_notification()
+        , m_state_snapshot()
+        , m_network_state(network_state::get(m_net_params.network()))
         , m_multi_call_category(0)
         , m_cache(std::make_shared<cache>(m_net_params, m_net_params.network()))
         , m_user_agent(std::string(GDK_COMMIT) + " " + m_net_params.user_agent())
@@ -281,13 +354,31 @@ namespace sdk {
               std::bind(&ga_session::emit_notification, this, std::placeholders::_1, std::placeholders::_2)))
         , m_spv_thread_done(false)
         , m_spv_thread_stop(false)
+        , m_tx_sync_thread_done(false)
+        , m_tx_sync_thread_stop(false)
+        , m_address_pool_requests(0)
+        , m_address_pool_refill_done(true)
+        , m_address_pool_refill_stop(false)
     {
         m_fee_estimates.assign(NUM_FEE_ESTIMATES, m_min_fee_rate);
+        locker_t locker(m_mutex);
+        publish_state_snapshot(locker);
     }
 
     ga_session::~ga_session()
     {
         m_notify = false;
+        no_std_exception_escape([this] {
+            if (m_warm_login_thread) {
+                m_warm_login_thread->join();
+            }
+        });
+        no_std_exception_escape([this] {
+            locker_t locker(m_mutex);
+            constexpr bool do_start = false;
+            tx_sync_ctl(locker, do_start);
+            address_pool_ctl(locker, do_start);
+        });
         no_std_exception_escape([this] { reset_all_session_data(true); });
         no_std_exception_escape([this] {
             locker_t locker(m_mutex);
@@ -317,21 +408,70 @@ namespace sdk {
             locker_t locker(m_mutex);
             constexpr bool do_start = false;
             download_headers_ctl(locker, do_start);
+            tx_sync_ctl(locker, do_start);
+            address_pool_ctl(locker, do_start);
         }
         m_wamp->reconnect_hint(hint, proxy);
     }
 
-    void ga_session::disconnect() { m_wamp->disconnect(); }
+    void ga_session::disconnect()
+    {
+        std::shared_ptr<cache> cache;
+        {
+            locker_t locker(m_mutex);
+            cache = m_cache;
+        }
+        // Don't leave any background cache save pending. The cache serializes
+        // its own saves, so the session lock isn't held while saving
+        no_std_exception_escape([&cache] { cache->flush(); }, "disconnect cache flush");
+        m_wamp->disconnect();
+    }
 
-    void ga_session::emit_notification(nlohmann::json details, bool async)
+    nlohmann::json ga_session::get_metrics() const
     {
-        if (m_notify) {
-            if (async) {
-                m_wamp->post([this, details] { emit_notification(details, false); });
-            } else {
-                session_impl::emit_notification(details, false);
+        auto result = session_impl::get_metrics();
+        result["wamp"] = m_wamp->get_metrics().get_json();
+        return result;
+    }
+
+    nlohmann::json ga_session::get_memory_usage()
+    {
+        auto result = session_impl::get_memory_usage();
+        locker_t locker(m_mutex);
+        size_t login_size = json_get_memory_usage(m_login_data) + json_get_memory_usage(m_limits_data)
+            + json_get_memory_usage(m_twofactor_config);
+        for (const auto& subaccount : m_subaccounts) {
+            login_size += json_get_memory_usage(subaccount.second);
+        }
+        result["login_data"] = login_size;
+        size_t derived_keys_size = result["derived_keys"];
+        derived_keys_size += m_ga_pubkeys ? m_ga_pubkeys->get_memory_usage() : 0;
+        derived_keys_size += m_recovery_pubkeys ? m_recovery_pubkeys->get_memory_usage() : 0;
+        result["derived_keys"] = derived_keys_size;
+        size_t address_pool_size = 0;
+        for (const auto& pool : m_address_pool) {
+            for (const auto& address : pool.second) {
+                address_pool_size += json_get_memory_usage(address);
             }
         }
+        result["address_pool"] = address_pool_size;
+        result["cache"] = m_cache ? m_cache->get_memory_usage() : 0;
+        return result;
+    }
+
+    void ga_session::trim_memory()
+    {
+        session_impl::trim_memory();
+        locker_t locker(m_mutex);
+        if (m_ga_pubkeys) {
+            m_ga_pubkeys->trim();
+        }
+        if (m_recovery_pubkeys) {
+            m_recovery_pubkeys->trim();
+        }
+        if (m_cache) {
+            m_cache->trim_memory();
+        }
     }
 
     std::shared_ptr<ga_session::nlocktime_t> ga_session::update_nlocktime_info(session_impl::locker_t& locker)
@@ -393,7 +533,8 @@ namespace sdk {
         return { sig_only_to_der_hex(m_signer->sign_hash(path, challenge_hash)), b2h(path_bytes) };
     }
 
-    void ga_session::set_fee_estimates(session_impl::locker_t& locker, const nlohmann::json& fee_estimates)
+    void ga_session::set_fee_estimates(session_impl::locker_t& locker, const nlohmann::json& fee_estimates,
+        std::chrono::system_clock::time_point updated)
     {
         GDK_RUNTIME_ASSERT(locker.owns_lock());
         GDK_LOG_SEV(log_level::debug) << "Set fee estimates " << fee_estimates.dump();
@@ -441,7 +582,31 @@ namespace sdk {
 
             std::swap(m_fee_estimates, new_estimates);
         }
-        m_fee_estimates_ts = std::chrono::system_clock::now();
+        m_fee_estimates_ts = updated;
+        publish_state_snapshot(locker);
+    }
+
+    void ga_session::publish_state_snapshot(session_impl::locker_t& locker)
+    {
+        GDK_RUNTIME_ASSERT(locker.owns_lock());
+        auto snapshot = std::make_shared<state_snapshot>();
+        snapshot->fee_estimates = m_fee_estimates;
+        snapshot->fee_estimates_ts = m_fee_estimates_ts;
+        snapshot->fiat_currency = m_fiat_currency;
+        snapshot->fiat_rate = m_fiat_rate;
+        snapshot->min_fee_rate = m_min_fee_rate;
+        const auto block_height_p = m_last_block_notification.find("block_height");
+        if (block_height_p != m_last_block_notification.end()) {
+            snapshot->block_height = *block_height_p;
+        } else {
+            snapshot->block_height = 0;
+        }
+        std::atomic_store(&m_state_snapshot, std::shared_ptr<const state_snapshot>(std::move(snapshot)));
+    }
+
+    std::shared_ptr<const ga_session::state_snapshot> ga_session::get_state_snapshot() const
+    {
+        return std::atomic_load(&m_state_snapshot);
     }
 
     nlohmann::json ga_session::register_user(const std::string& master_pub_key_hex,
@@ -470,6 +635,7 @@ namespace sdk {
 
         // Update required_ca
         locker_t locker(m_mutex);
+        std::unique_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
         auto& required = m_subaccounts.at(subaccount)["required_ca"];
         const uint32_t remaining = required.get<uint32_t>();
         if (remaining) {
@@ -478,8 +644,9 @@ namespace sdk {
     }
 
     nlohmann::json ga_session::on_post_login(locker_t& locker, nlohmann::json& login_data,
-        const std::string& root_bip32_xpub, bool watch_only, bool is_initial_login)
+        const std::string& root_bip32_xpub, bool watch_only, bool is_initial_login, bool is_warm_login)
     {
+        GDK_TRACE_SPAN("ga_session::on_post_login");
         GDK_RUNTIME_ASSERT(locker.owns_lock());
         GDK_RUNTIME_ASSERT(m_signer != nullptr);
 
@@ -521,7 +688,10 @@ namespace sdk {
         m_fiat_currency = m_login_data["fiat_currency"];
         update_fiat_rate(locker, json_get_value(m_login_data, "fiat_exchange"));
 
-        m_subaccounts.clear();
+        {
+            std::unique_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
+            m_subaccounts.clear();
+        }
         m_next_subaccount = 0;
         for (const auto& sa : m_login_data["subaccounts"]) {
             const uint32_t subaccount = sa["pointer"];
@@ -608,6 +778,10 @@ namespace sdk {
         }
 
         set_fee_estimates(locker, m_login_data["fee_estimates"]);
+        if (!is_warm_login) {
+            m_network_state->set("fee_estimates", m_login_data["fee_estimates"]);
+            save_login_snapshot(locker);
+        }
 
         // Notify the caller of their settings / 2fa reset status
         auto settings = get_settings(locker);
@@ -627,6 +801,13 @@ namespace sdk {
             }
         }
 
+        if (is_warm_login) {
+            // Subscriptions and block processing happen once authenticated
+            auto post_login_data = get_post_login_data();
+            locker.unlock();
+            return post_login_data;
+        }
+
         subscribe_all(locker);
 
         // Notify the caller of their current block
@@ -645,15 +826,28 @@ namespace sdk {
         // TODO: Remove None check when backends are fixed
         if (rate_str.empty() || rate_str == "None") {
             m_fiat_rate.clear(); // No rate available
-            return;
-        }
-        try {
-            m_fiat_rate = amount::format_amount(rate_str, 8);
-        } catch (const std::exception& e) {
-            m_fiat_rate.clear();
-            GDK_LOG_SEV(log_level::error)
-                << "failed to update fiat rate from string '" << rate_str << "': " << e.what();
+            // Use the rate from the latest tickers received for the network, if any
+            std::string rate;
+            const auto tickers = m_network_state->get_value("tickers");
+            if (tickers.value) {
+                const auto exchange_p = tickers.value->find(m_fiat_source);
+                if (exchange_p != tickers.value->end()) {
+                    rate = exchange_p->value(m_fiat_currency, std::string());
+                }
+            }
+            if (!rate.empty() && rate != "None") {
+                return update_fiat_rate(locker, rate);
+            }
+        } else {
+            try {
+                m_fiat_rate = amount::format_amount(rate_str, 8);
+            } catch (const std::exception& e) {
+                m_fiat_rate.clear();
+                GDK_LOG_SEV(log_level::error)
+                    << "failed to update fiat rate from string '" << rate_str << "': " << e.what();
+            }
         }
+        publish_state_snapshot(locker);
     }
 
     void ga_session::update_spending_limits(session_impl::locker_t& locker, const nlohmann::json& limits)
@@ -666,11 +860,7 @@ namespace sdk {
         }
     }
 
-    amount ga_session::get_min_fee_rate() const
-    {
-        locker_t locker(m_mutex);
-        return amount(m_min_fee_rate);
-    }
+    amount ga_session::get_min_fee_rate() const { return amount(get_state_snapshot()->min_fee_rate); }
 
     amount ga_session::get_default_fee_rate() const
     {
@@ -682,8 +872,20 @@ namespace sdk {
 
     uint32_t ga_session::get_block_height() const
     {
-        locker_t locker(m_mutex);
-        return m_last_block_notification["block_height"];
+        const uint32_t block_height = get_state_snapshot()->block_height;
+        if (block_height) {
+            return block_height;
+        }
+        {
+            locker_t locker(m_mutex);
+            if (!m_last_block_notification.empty()) {
+                return m_last_block_notification["block_height"];
+            }
+        }
+        // No block seen by this session yet: use the latest for the network
+        const auto shared = m_network_state->get_value("block");
+        GDK_RUNTIME_ASSERT_MSG(shared.value, "Block height is not known");
+        return shared.value->at("block_height");
     }
 
     nlohmann::json ga_session::get_spending_limits() const
@@ -753,18 +955,10 @@ namespace sdk {
 
     void ga_session::on_new_transaction(const std::vector<uint32_t>& subaccounts, nlohmann::json details)
     {
-        auto locker_p{ get_multi_call_locker(MC_TX_CACHE, false) };
-        auto& locker = *locker_p;
-
-        if (!locker.owns_lock()) {
-            // Try again: 'post' this to allow the competing thread to proceed.
-            m_wamp->post([this, subaccounts, details] { on_new_transaction(subaccounts, details); });
-            return;
-        }
-
         no_std_exception_escape([&]() {
             using namespace std::chrono_literals;
 
+            locker_t locker(m_mutex);
             const auto now = std::chrono::system_clock::now();
             if (now < m_tx_last_notification || now - m_tx_last_notification > 60s) {
                 // Time has adjusted, or more than 60s since last notification,
@@ -790,36 +984,84 @@ namespace sdk {
                 m_tx_notifications.erase(m_tx_notifications.begin()); // pop the oldest
             }
 
-            const std::string txhash_hex = details.at("txhash");
-            for (auto subaccount : subaccounts) {
-                const auto p = m_subaccounts.find(subaccount);
-                // TODO: Handle other logged in sessions creating subaccounts
-                GDK_RUNTIME_ASSERT_MSG(p != m_subaccounts.end(), "Unknown subaccount");
+            m_pending_tx_notifications.emplace_back(subaccounts, std::move(details));
+            if (m_pending_tx_notifications.size() == 1u) {
+                // The first notification since we last processed them: Wait
+                // for any others in the same burst, then process them together
+                m_wamp->post_after(TX_NOTIFICATION_DEBOUNCE, [this] { process_tx_notifications(); });
+            }
+        });
+    }
+
+    void ga_session::process_tx_notifications()
+    {
+        auto locker_p{ get_multi_call_locker(MC_TX_CACHE, false) };
+        auto& locker = *locker_p;
 
+        if (!locker.owns_lock()) {
+            // Try again: 'post' this to allow the competing thread to proceed.
+            m_wamp->post([this] { process_tx_notifications(); });
+            return;
+        }
+
+        no_std_exception_escape([&]() {
+            std::vector<std::pair<std::vector<uint32_t>, nlohmann::json>> pending;
+            pending.swap(m_pending_tx_notifications);
+
+            // Invalidate the tx cache once for each affected subaccount
+            std::map<uint32_t, std::vector<std::string>> subaccount_txhashes;
+            for (auto& ntf : pending) {
+                // Skip a bad notification or subaccount rather than failing the whole burst
+                const std::string txhash_hex = json_get_value(ntf.second, "txhash");
+                std::vector<uint32_t> known_subaccounts;
+                for (auto subaccount : ntf.first) {
+                    if (txhash_hex.empty() || !m_subaccounts.count(subaccount)) {
+                        // TODO: Handle other logged in sessions creating subaccounts
+                        GDK_LOG_SEV(log_level::warning)
+                            << "Tx sync(" << subaccount << "): ignoring tx notification " << txhash_hex;
+                        continue;
+                    }
+                    GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): new tx " << txhash_hex;
+                    subaccount_txhashes[subaccount].push_back(txhash_hex);
+                    known_subaccounts.push_back(subaccount);
+                }
+                if (txhash_hex.empty() || (!ntf.first.empty() && known_subaccounts.empty())) {
+                    ntf.second = nlohmann::json(); // Nothing we know about to notify
+                }
+                ntf.first.swap(known_subaccounts);
+            }
+            const auto is_ignored = [](const auto& ntf) { return ntf.second.is_null(); };
+            pending.erase(std::remove_if(pending.begin(), pending.end(), is_ignored), pending.end());
+            for (const auto& item : subaccount_txhashes) {
                 // Update affected subaccounts as required
-                GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): new tx " << txhash_hex;
-                m_cache->on_new_transaction(subaccount, txhash_hex);
-                m_synced_subaccounts.erase(subaccount);
+                m_cache->on_new_transactions(item.first, item.second);
+                m_synced_subaccounts.erase(item.first);
+                m_tx_prefetch.erase(item.first); // Fetched before the new tx
             }
             m_nlocktimes.reset();
 
-            const std::string value_str = details.value("value", std::string{});
-            if (!value_str.empty()) {
-                int64_t satoshi = strtol(value_str.c_str(), nullptr, 10);
-                details["satoshi"] = abs(satoshi);
-
-                // TODO: We can't determine if this is a re-deposit based on the
-                // information the server give us. We should fetch the tx details
-                // in tx_list format, cache them, and notify that data instead.
-                const bool is_deposit = satoshi >= 0;
-                details["type"] = is_deposit ? "incoming" : "outgoing";
-                details.erase("value");
-            } else {
-                // TODO: figure out what type is for liquid
+            for (auto& ntf : pending) {
+                auto& details = ntf.second;
+                const std::string value_str = details.value("value", std::string{});
+                if (!value_str.empty()) {
+                    int64_t satoshi = strtol(value_str.c_str(), nullptr, 10);
+                    details["satoshi"] = abs(satoshi);
+
+                    // TODO: We can't determine if this is a re-deposit based on the
+                    // information the server give us. We should fetch the tx details
+                    // in tx_list format, cache them, and notify that data instead.
+                    const bool is_deposit = satoshi >= 0;
+                    details["type"] = is_deposit ? "incoming" : "outgoing";
+                    details.erase("value");
+                } else {
+                    // TODO: figure out what type is for liquid
+                }
             }
             unique_unlock unlocker(locker);
-            remove_cached_utxos(subaccounts);
-            emit_notification({ { "event", "transaction" }, { "transaction", std::move(details) } }, false);
+            for (auto& ntf : pending) {
+                update_cached_utxos(ntf.first, ntf.second.at("txhash"));
+                emit_notification({ { "event", "transaction" }, { "transaction", std::move(ntf.second) } }, false);
+            }
         });
     }
 
@@ -881,18 +1123,41 @@ namespace sdk {
                 GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync: new n+1 block";
             }
 
+            // After a re-login without a reorg, rather than assuming every
+            // subaccount may have missed txs, ask the server which ones have
+            // txs newer than our latest cached tx and only invalidate those
+            const bool check_for_missed_txs = is_relogin && !treat_as_reorg;
+            std::vector<std::pair<uint32_t, uint64_t>> subaccounts_to_check; // subaccount, latest timestamp
+
             GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync: on new block" << (treat_as_reorg ? " (treat_as_reorg)" : "")
-                                        << (may_have_missed_tx ? " (may_have_missed_tx)" : "");
+                                        << (may_have_missed_tx ? " (may_have_missed_tx)" : "")
+                                        << (check_for_missed_txs ? " (check_for_missed_txs)" : "");
 
             std::vector<uint32_t> modified_subaccounts;
             uint32_t reorg_block = 0;
+            bool found_fork_point = false;
             if (treat_as_reorg) {
-                // Calculate the block to reorg from
+                // Calculate the block to reorg from. If the new block or its
+                // parent is one we have recorded, only txs in blocks after it
+                // can have been orphaned
                 const uint32_t last_seen_block_height = m_cache->get_latest_block();
-                const uint32_t num_reorg_blocks = std::min(m_net_params.get_max_reorg_blocks(), last_seen_block_height);
-                reorg_block = last_seen_block_height - num_reorg_blocks;
-                GDK_LOG_SEV(TX_CACHE_LEVEL)
-                    << "Tx sync: removing " << num_reorg_blocks << " blocks from cache tip " << last_seen_block_height;
+                auto fork_height = m_cache->get_block_height(details["block_hash"]);
+                if (!fork_height.has_value()) {
+                    fork_height = m_cache->get_block_height(details["previous_hash"]);
+                }
+                if (fork_height.has_value() && fork_height.value() <= last_seen_block_height) {
+                    found_fork_point = true;
+                    reorg_block = fork_height.value() + 1;
+                    GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync: removing blocks after fork point " << fork_height.value()
+                                                << " from cache tip " << last_seen_block_height;
+                } else {
+                    // Unknown fork point: assume the maximum reorg depth
+                    const uint32_t num_reorg_blocks
+                        = std::min(m_net_params.get_max_reorg_blocks(), last_seen_block_height);
+                    reorg_block = last_seen_block_height - num_reorg_blocks;
+                    GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync: removing " << num_reorg_blocks
+                                                << " blocks from cache tip " << last_seen_block_height;
+                }
 
                 // We can't trust the SPV state of any txs younger than the
                 // max reorg depth, so clear them.
@@ -913,17 +1178,30 @@ namespace sdk {
                     // tx forward in case one of them confirmed in this block.
                     removed_txs |= m_cache->delete_mempool_txs(sa.first);
                 }
-                if (removed_txs || may_have_missed_tx) {
+                if (removed_txs || (may_have_missed_tx && !check_for_missed_txs)) {
                     // If we were synced, we are no longer synced if we removed
                     // any txs or may have missed a new mempool tx
                     GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << sa.first << "): marking unsynced";
                     m_synced_subaccounts.erase(sa.first);
+                    m_tx_prefetch.erase(sa.first);
                     modified_subaccounts.push_back(sa.first);
+                } else if (check_for_missed_txs && m_synced_subaccounts.count(sa.first)) {
+                    const auto timestamp = m_cache->get_latest_transaction_timestamp(sa.first);
+                    subaccounts_to_check.emplace_back(sa.first, timestamp);
                 }
             }
 
             last = details;
+            publish_state_snapshot(locker);
+            {
+                // Share the block if it is newer than any seen on this network
+                const auto shared = m_network_state->get_value("block");
+                if (!shared.value || shared.value->value("block_height", 0u) < last.value("block_height", 0u)) {
+                    m_network_state->set("block", last);
+                }
+            }
             m_cache->set_latest_block(last["block_height"]);
+            m_cache->set_block_hash(last["block_height"], last["block_hash"], m_net_params.get_max_reorg_blocks());
             m_cache->save_db();
 
             // Start syncing headers for SPV (if enabled)
@@ -931,8 +1209,21 @@ namespace sdk {
             download_headers_ctl(locker, do_start);
 
             locker.unlock();
-            if (treat_as_reorg) {
-                // In the event of a re-org, nuke the entire UTXO cache
+            if (!subaccounts_to_check.empty()) {
+                const auto changed = get_subaccounts_with_new_txs(subaccounts_to_check);
+                if (!changed.empty()) {
+                    locker_t sync_locker(m_mutex);
+                    for (const auto subaccount : changed) {
+                        GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): missed txs, marking unsynced";
+                        m_synced_subaccounts.erase(subaccount);
+                        m_tx_prefetch.erase(subaccount);
+                    }
+                }
+                modified_subaccounts.insert(modified_subaccounts.end(), changed.begin(), changed.end());
+            }
+            if (treat_as_reorg && !found_fork_point) {
+                // In the event of a re-org from an unknown fork point,
+                // nuke the entire UTXO cache
                 remove_cached_utxos(std::vector<uint32_t>());
             } else if (!modified_subaccounts.empty()) {
                 // Otherwise just nuke the subaccounts that may have changed
@@ -942,8 +1233,37 @@ namespace sdk {
         });
     }
 
+    std::vector<uint32_t> ga_session::get_subaccounts_with_new_txs(
+        const std::vector<std::pair<uint32_t, uint64_t>>& subaccount_timestamps)
+    {
+        std::vector<uint32_t> changed;
+        try {
+            // Issue all of the server calls before waiting for any of them
+            std::vector<std::future<autobahn::wamp_call_result>> calls;
+            calls.reserve(subaccount_timestamps.size());
+            for (const auto& st : subaccount_timestamps) {
+                calls.emplace_back(m_wamp->call_async("txs.get_list_v3", st.first, st.second));
+            }
+            for (size_t i = 0; i < calls.size(); ++i) {
+                const auto ret = wamp_cast_json(calls[i].get());
+                if (!ret.at("list").empty()) {
+                    changed.push_back(subaccount_timestamps[i].first);
+                }
+            }
+        } catch (const std::exception& e) {
+            // Assume every subaccount may have missed txs
+            GDK_LOG_SEV(log_level::info) << "Tx sync: failed to check for missed txs: " << e.what();
+            changed.clear();
+            for (const auto& st : subaccount_timestamps) {
+                changed.push_back(st.first);
+            }
+        }
+        return changed;
+    }
+
     void ga_session::on_new_tickers(nlohmann::json details)
     {
+        m_network_state->set("tickers", details);
         std::string fiat_source, fiat_currency, fiat_rate;
         {
             locker_t locker(m_mutex);
@@ -1072,32 +1392,32 @@ namespace sdk {
         unique_unlock unlocker(locker);
         const bool is_initial = true;
         m_wamp->subscribe(
-            "com.greenaddress.tickers", [this](nlohmann::json event) { on_new_tickers(event); }, is_initial);
-
-        m_wamp->subscribe("com.greenaddress.cbs.wallet_" + receiving_id, [this](nlohmann::json event) {
-            const uint64_t seq = event.at("sequence");
-            if (seq != 0) {
-                // Ignore client blobs whose sequence numbers we don't understand
-                GDK_LOG_SEV(log_level::warning) << "Unexpected client blob sequence " << seq;
-                return;
-            }
-            locker_t notify_locker(m_mutex);
-            // Check the hmac as we will be notified of our own changes
-            // when more than one session is logged in at a time.
-            if (m_blob_hmac != json_get_value(event, "hmac")) {
-                // Another session has updated our client blob, mark it dirty.
-                m_blob_outdated = true;
-            }
-        });
-
-        m_wamp->subscribe("com.greenaddress.txs.wallet_" + receiving_id, [this](nlohmann::json event) {
-            if (!ignore_tx_notification(event)) {
-                std::vector<uint32_t> subaccounts = cleanup_tx_notification(event);
-                on_new_transaction(subaccounts, event);
-            }
-        });
-
-        m_wamp->subscribe("com.greenaddress.blocks", [this](nlohmann::json event) { on_new_block(event, false); });
+            { { "com.greenaddress.tickers", [this](nlohmann::json event) { on_new_tickers(event); } },
+                { "com.greenaddress.cbs.wallet_" + receiving_id,
+                    [this](nlohmann::json event) {
+                        const uint64_t seq = event.at("sequence");
+                        if (seq != 0) {
+                            // Ignore client blobs whose sequence numbers we don't understand
+                            GDK_LOG_SEV(log_level::warning) << "Unexpected client blob sequence " << seq;
+                            return;
+                        }
+                        locker_t notify_locker(m_mutex);
+                        // Check the hmac as we will be notified of our own changes
+                        // when more than one session is logged in at a time.
+                        if (m_blob_hmac != json_get_value(event, "hmac")) {
+                            // Another session has updated our client blob, mark it dirty.
+                            m_blob_outdated = true;
+                        }
+                    } },
+                { "com.greenaddress.txs.wallet_" + receiving_id,
+                    [this](nlohmann::json event) {
+                        if (!ignore_tx_notification(event)) {
+                            std::vector<uint32_t> subaccounts = cleanup_tx_notification(event);
+                            on_new_transaction(subaccounts, event);
+                        }
+                    } },
+                { "com.greenaddress.blocks", [this](nlohmann::json event) { on_new_block(event, false); } } },
+            is_initial);
     }
 
     void ga_session::get_cached_client_blob(const std::string& server_hmac)
@@ -1235,13 +1555,19 @@ namespace sdk {
     {
         GDK_RUNTIME_ASSERT(locker.owns_lock());
         swap_with_default(m_tx_notifications);
+        swap_with_default(m_pending_tx_notifications);
         m_nlocktimes.reset();
+        m_tx_prefetch.clear();
     }
 
     void ga_session::reset_all_session_data(bool in_dtor)
     {
         try {
             locker_t locker(m_mutex);
+            // Pooled addresses belong to the wallet being logged out
+            constexpr bool do_start = false;
+            address_pool_ctl(locker, do_start);
+            m_address_pool.clear();
             m_signer.reset();
             remove_cached_utxos(std::vector<uint32_t>());
             swap_with_default(m_login_data);
@@ -1253,7 +1579,10 @@ namespace sdk {
             m_blob_outdated = false; // Blob will be reloaded if needed when login succeeds
             swap_with_default(m_limits_data);
             swap_with_default(m_twofactor_config);
-            swap_with_default(m_subaccounts);
+            {
+                std::unique_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
+                swap_with_default(m_subaccounts);
+            }
             m_ga_pubkeys.reset();
             m_user_pubkeys.reset();
             m_recovery_pubkeys.reset();
@@ -1262,6 +1591,7 @@ namespace sdk {
             swap_with_default(m_tx_notifications);
             m_tx_last_notification = now;
             m_nlocktimes.reset();
+            m_tx_prefetch.clear();
             if (!in_dtor) {
                 m_cache = std::make_shared<cache>(m_net_params, m_cache->get_network_name());
                 m_synced_subaccounts.clear();
@@ -1484,17 +1814,133 @@ namespace sdk {
 
         // Note that locker is unlocked at this point
         if (m_blob_aes_key.has_value()) {
-            const auto subaccount_pointers = get_subaccount_pointers();
-            std::vector<std::string> bip32_xpubs;
-            bip32_xpubs.reserve(subaccount_pointers.size());
-            for (const auto& pointer : subaccount_pointers) {
-                bip32_xpubs.emplace_back(m_signer->get_bip32_xpub(get_subaccount_root_path(pointer)));
+            register_subaccount_xpubs_from_signer();
+        }
+        return ret;
+    }
+
+    void ga_session::register_subaccount_xpubs_from_signer()
+    {
+        const auto subaccount_pointers = get_subaccount_pointers();
+        std::vector<std::string> bip32_xpubs;
+        bip32_xpubs.reserve(subaccount_pointers.size());
+        for (const auto& pointer : subaccount_pointers) {
+            bip32_xpubs.emplace_back(m_signer->get_bip32_xpub(get_subaccount_root_path(pointer)));
+        }
+        register_subaccount_xpubs(subaccount_pointers, bip32_xpubs);
+    }
+
+    nlohmann::json ga_session::warm_login(
+        std::shared_ptr<signer> signer, const std::string& root_bip32_xpub, sign_challenge_fn_t sign_fn)
+    {
+        if (!m_net_params.is_warm_login_enabled() || m_net_params.is_liquid() || signer->is_hardware()) {
+            return {};
+        }
+
+        nlohmann::json snapshot;
+        {
+            locker_t locker(m_mutex);
+            if (m_signer) {
+                return {}; // Re-login: authenticate normally
             }
-            register_subaccount_xpubs(subaccount_pointers, bip32_xpubs);
+            snapshot = load_login_snapshot(locker);
+        }
+        if (snapshot.empty() || !set_signer(signer)) {
+            return {};
+        }
+
+        locker_t locker(m_mutex);
+        auto& login_data = snapshot["login_data"];
+        m_cache->update_to_latest_minor_version();
+        get_cached_client_blob(login_data.value("client_blob_hmac", std::string()));
+        m_twofactor_config = std::move(snapshot["twofactor_config"]);
+
+        constexpr bool watch_only = false;
+        constexpr bool is_initial_login = true;
+        constexpr bool is_warm_login = true;
+        auto ret = on_post_login(locker, login_data, root_bip32_xpub, watch_only, is_initial_login, is_warm_login);
+        // Note that locker is unlocked at this point
+        register_subaccount_xpubs_from_signer();
+
+        // Authenticate in the background. Calls to the server from other
+        // threads wait until this completes. Calls are held before the
+        // thread starts, so that it can't release them before they are held
+        m_wamp->hold_calls(std::thread::id());
+        try {
+            m_warm_login_thread = std::make_shared<std::thread>(
+                [this, signer, root_bip32_xpub, sign_fn] { warm_login_thread_fn(signer, root_bip32_xpub, sign_fn); });
+        } catch (const std::exception&) {
+            m_wamp->release_calls();
+            throw;
         }
         return ret;
     }
 
+    void ga_session::warm_login_thread_fn(
+        std::shared_ptr<signer> signer, const std::string& root_bip32_xpub, sign_challenge_fn_t sign_fn)
+    {
+        m_wamp->hold_calls(std::this_thread::get_id()); // Allow our own calls through
+        std::string error;
+        try {
+            const auto public_key = make_xpub(root_bip32_xpub).second;
+            const auto sig_der_hex = sign_fn(get_challenge(public_key));
+            // Authenticating as a re-login updates our state from the server,
+            // notifying the caller of any changes
+            authenticate(sig_der_hex, "GA", root_bip32_xpub, signer);
+            {
+                // Re-fetch the 2fa config from the server when next requested
+                locker_t locker(m_mutex);
+                m_twofactor_config = nlohmann::json();
+            }
+            register_subaccount_xpubs_from_signer();
+            start_sync_threads();
+        } catch (const std::exception& e) {
+            error = e.what();
+            GDK_LOG_SEV(log_level::error) << "warm login failed: " << error;
+        }
+        m_wamp->release_calls();
+        nlohmann::json details = { { "authenticated", error.empty() }, { "error", error } };
+        emit_notification({ { "event", "warm_login" }, { "warm_login", std::move(details) } }, false);
+    }
+
+    void ga_session::save_login_snapshot(session_impl::locker_t& locker)
+    {
+        GDK_RUNTIME_ASSERT(locker.owns_lock());
+        if (m_watch_only || !m_net_params.is_warm_login_enabled()) {
+            return;
+        }
+        const nlohmann::json snapshot = { { "version", LOGIN_SNAPSHOT_VERSION }, { "login_data", m_login_data },
+            { "twofactor_config", m_twofactor_config } };
+        m_cache->upsert_key_value(LOGIN_SNAPSHOT_KEY, nlohmann::json::to_msgpack(snapshot));
+        m_cache->save_db();
+    }
+
+    nlohmann::json ga_session::load_login_snapshot(session_impl::locker_t& locker)
+    {
+        GDK_RUNTIME_ASSERT(locker.owns_lock());
+        nlohmann::json snapshot;
+        m_cache->get_key_value(LOGIN_SNAPSHOT_KEY, { [&snapshot](const auto& db_blob) {
+            if (db_blob.has_value()) {
+                try {
+                    snapshot = nlohmann::json::from_msgpack(db_blob.value().begin(), db_blob.value().end());
+                } catch (const std::exception& e) {
+                    GDK_LOG_SEV(log_level::warning) << "Error reading login snapshot: " << e.what();
+                }
+            }
+        } });
+        if (snapshot.value("version", 0u) != LOGIN_SNAPSHOT_VERSION) {
+            return {}; // Missing, corrupt or written by an incompatible version
+        }
+        return snapshot;
+    }
+
+    void ga_session::start_sync_threads()
+    {
+        locker_t locker(m_mutex);
+        constexpr bool do_start = true;
+        tx_sync_ctl(locker, do_start);
+    }
+
     void ga_session::register_subaccount_xpubs(
         const std::vector<uint32_t>& pointers, const std::vector<std::string>& bip32_xpubs)
     {
@@ -1526,12 +1972,25 @@ namespace sdk {
     {
         const auto now = std::chrono::system_clock::now();
 
+        const auto snapshot = get_state_snapshot();
+        if (now >= snapshot->fee_estimates_ts && now - snapshot->fee_estimates_ts <= 120s) {
+            // The published estimates are current
+            return { { "fees", snapshot->fee_estimates } };
+        }
+
         locker_t locker(m_mutex);
 
         if (now < m_fee_estimates_ts || now - m_fee_estimates_ts > 120s) {
-            // Time adjusted or more than 2 minutes old: Update
-            auto fee_estimates = m_wamp->call(locker, "login.get_fee_estimates");
-            set_fee_estimates(locker, wamp_cast_json(fee_estimates));
+            // Time adjusted or more than 2 minutes old: Update, using the
+            // estimates last fetched by any session on this network if current
+            const auto shared = m_network_state->get_current("fee_estimates", m_fee_estimates_ts, 120s);
+            if (shared.value) {
+                set_fee_estimates(locker, *shared.value, shared.updated);
+            } else {
+                auto fee_estimates = wamp_cast_json(m_wamp->call(locker, "login.get_fee_estimates"));
+                set_fee_estimates(locker, fee_estimates);
+                m_network_state->set("fee_estimates", std::move(fee_estimates));
+            }
         }
 
         // TODO: augment with last_updated, user preference for display?
@@ -1591,8 +2050,8 @@ namespace sdk {
 
     nlohmann::json ga_session::convert_amount(const nlohmann::json& amount_json) const
     {
-        locker_t locker(m_mutex);
-        return convert_amount(locker, amount_json);
+        const auto snapshot = get_state_snapshot();
+        return amount::convert(amount_json, snapshot->fiat_currency, snapshot->fiat_rate);
     }
 
     nlohmann::json ga_session::convert_amount(locker_t& locker, const nlohmann::json& amount_json) const
@@ -1685,7 +2144,7 @@ namespace sdk {
     nlohmann::json ga_session::get_subaccounts()
     {
         // TODO: implement refreshing for multisig
-        locker_t locker(m_mutex);
+        std::shared_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
         nlohmann::json::array_t subaccounts;
         subaccounts.reserve(m_subaccounts.size());
 
@@ -1700,7 +2159,7 @@ namespace sdk {
     std::vector<uint32_t> ga_session::get_subaccount_pointers()
     {
         std::vector<uint32_t> ret;
-        locker_t locker(m_mutex);
+        std::shared_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
         ret.reserve(m_subaccounts.size());
         for (const auto& sa : m_subaccounts) {
             ret.emplace_back(sa.second.at("pointer"));
@@ -1710,7 +2169,7 @@ namespace sdk {
 
     nlohmann::json ga_session::get_subaccount(uint32_t subaccount)
     {
-        locker_t locker(m_mutex);
+        std::shared_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
         const auto p = m_subaccounts.find(subaccount);
         GDK_RUNTIME_ASSERT_MSG(p != m_subaccounts.end(), "Unknown subaccount");
         return p->second;
@@ -1728,6 +2187,7 @@ namespace sdk {
             nlohmann::json empty;
             update_blob(locker, std::bind(&client_blob::set_subaccount_name, &m_blob, subaccount, new_name, empty));
             // Look up our subaccount again as iterators may have been invalidated
+            std::unique_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
             m_subaccounts.find(subaccount)->second["name"] = new_name;
         }
     }
@@ -1743,6 +2203,7 @@ namespace sdk {
         if (old_hidden != is_hidden) {
             update_blob(locker, std::bind(&client_blob::set_subaccount_hidden, &m_blob, subaccount, is_hidden));
             // Look up our subaccount again as iterators may have been invalidated
+            std::unique_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
             m_subaccounts.find(subaccount)->second["hidden"] = is_hidden;
         }
     }
@@ -1764,7 +2225,10 @@ namespace sdk {
             { "type", type }, { "recovery_pub_key", recovery_pub_key }, { "recovery_chain_code", recovery_chain_code },
             { "recovery_xpub", recovery_xpub }, { "required_ca", required_ca }, { "hidden", is_hidden },
             { "user_path", ga_user_pubkeys::get_ga_subaccount_root_path(subaccount) } };
-        m_subaccounts[subaccount] = sa;
+        {
+            std::unique_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
+            m_subaccounts[subaccount] = sa;
+        }
 
         if (subaccount != 0) {
             // Add user and recovery pubkeys for the subaccount
@@ -1835,6 +2299,10 @@ namespace sdk {
         return subaccount_details;
     }
 
+    // Apply update_fn to our client blob and save it to the server. The server
+    // stores the blob as a single opaque value, replaced only if the caller
+    // knows its current HMAC, so each change must upload the whole blob. On a
+    // save race only update_fn, the delta, is re-applied to the latest blob.
     void ga_session::update_blob(locker_t& locker, std::function<bool()> update_fn)
     {
         GDK_RUNTIME_ASSERT(locker.owns_lock());
@@ -1872,6 +2340,36 @@ namespace sdk {
         update_blob(locker, std::bind(&client_blob::set_master_blinding_key, &m_blob, master_blinding_key_hex));
     }
 
+    nlohmann::json ga_session::load_asset_icons(const std::vector<std::string>& asset_ids)
+    {
+        nlohmann::json icons = nlohmann::json::object();
+        locker_t locker(m_mutex);
+        if (!m_cache) {
+            return icons;
+        }
+        for (const auto& asset_id : asset_ids) {
+            m_cache->get_key_value(ASSET_ICON_KEY_PREFIX + asset_id, { [&icons, &asset_id](const auto& db_blob) {
+                if (db_blob.has_value()) {
+                    icons[asset_id] = std::string(db_blob.value().begin(), db_blob.value().end());
+                }
+            } });
+        }
+        return icons;
+    }
+
+    void ga_session::store_asset_icons(const nlohmann::json& icons)
+    {
+        locker_t locker(m_mutex);
+        if (!m_cache) {
+            return;
+        }
+        for (const auto& item : icons.items()) {
+            const std::string& icon = item.value().get_ref<const std::string&>();
+            m_cache->upsert_key_value(ASSET_ICON_KEY_PREFIX + item.key(), ustring_span(icon));
+        }
+        m_cache->save_db();
+    }
+
     void ga_session::encache_signer_xpubs(std::shared_ptr<signer> signer)
     {
         locker_t locker(m_mutex);
@@ -1944,8 +2442,8 @@ namespace sdk {
         utxo.erase("surj_proof");
     }
 
-    bool ga_session::unblind_utxo(session_impl::locker_t& locker, nlohmann::json& utxo, const std::string& for_txhash,
-        unique_pubkeys_and_scripts_t& missing)
+    void ga_session::unblind_utxo(session_impl::locker_t& locker, nlohmann::json& utxo, const std::string& for_txhash,
+        unique_pubkeys_and_scripts_t& missing, std::vector<unblind_request>& requests)
     {
         GDK_RUNTIME_ASSERT(locker.owns_lock());
         amount::value_type value;
@@ -1958,7 +2456,7 @@ namespace sdk {
             GDK_RUNTIME_ASSERT(asset_tag.at(0) == 0x1);
             utxo["asset_id"] = b2h_rev(gsl::make_span(asset_tag).subspan(1));
             utxo["is_blinded"] = false;
-            return false; // Cache not updated
+            return;
         }
 
         // 1) get_unspent_outputs UTXOs have txhash/pt_idx and implicitly
@@ -1979,7 +2477,7 @@ namespace sdk {
             txhash = for_txhash;
         }
 
-        const auto script = h2b(utxo.at("script"));
+        auto script = h2b(utxo.at("script"));
         const bool has_address = !json_get_value(utxo, "address").empty();
 
         if (!txhash.empty()) {
@@ -1994,14 +2492,11 @@ namespace sdk {
                     GDK_RUNTIME_ASSERT(!blinding_pubkey.empty());
                     confidentialize_address(m_net_params, utxo, b2h(blinding_pubkey));
                 }
-
-                return false; // Cache not updated
+                return;
             }
         }
-        const auto rangeproof = h2b(utxo.at("range_proof"));
-        const auto commitment = h2b(utxo.at("commitment"));
-        const auto nonce_commitment = h2b(utxo.at("nonce_commitment"));
-        const auto asset_tag = h2b(utxo.at("asset_tag"));
+        auto nonce_commitment = h2b(utxo.at("nonce_commitment"));
+        auto asset_tag = h2b(utxo.at("asset_tag"));
 
         GDK_RUNTIME_ASSERT(asset_tag[0] == 0xa || asset_tag[0] == 0xb);
 
@@ -2009,52 +2504,88 @@ namespace sdk {
         if (nonce.empty()) {
             utxo["error"] = "missing blinding nonce";
             missing.emplace(std::make_pair(nonce_commitment, script));
+            return;
+        }
+
+        // Queue the rangeproof rewind to be performed by unblind_utxos
+        requests.push_back({ &utxo, std::move(txhash), pt_idx, has_address, std::move(script),
+            h2b(utxo.at("range_proof")), h2b(utxo.at("commitment")), std::move(nonce_commitment),
+            std::move(asset_tag), std::move(nonce), unblind_t(), false });
+    }
+
+    bool ga_session::unblind_utxos(session_impl::locker_t& locker, std::vector<unblind_request>& requests)
+    {
+        GDK_RUNTIME_ASSERT(locker.owns_lock());
+        if (requests.empty()) {
             return false; // Cache not updated
         }
 
-        // Make sure we can unblind the asset/amount details
-        unblind_t unblinded;
-        try {
-            unblinded = asset_unblind_with_nonce(nonce, rangeproof, commitment, script, asset_tag);
-        } catch (const std::exception&) {
-            nonce = get_alternate_blinding_nonce(locker, utxo, nonce_commitment);
-            if (!nonce.empty()) {
-                // Try the alternate nonce
-                try {
-                    unblinded = asset_unblind_with_nonce(nonce, rangeproof, commitment, script, asset_tag);
-                } catch (const std::exception&) {
-                    nonce.clear();
+        {
+            // Rewind the rangeproofs in parallel. Each request is only touched
+            // by the thread processing it. The session lock remains held: the
+            // requests point into json owned by our caller, which may have
+            // checked for tx list disruption and may be using m_cache, and
+            // neither can change safely until we return.
+            constexpr size_t min_rewinds_per_thread = 4;
+            constexpr size_t max_threads = 8;
+            parallel_for_chunks(requests.size(), min_rewinds_per_thread, max_threads, [&requests](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    auto& r = requests[i];
+                    try {
+                        r.unblinded
+                            = asset_unblind_with_nonce(r.nonce, r.rangeproof, r.commitment, r.script, r.asset_tag);
+                        r.is_unblinded = true;
+                    } catch (const std::exception&) {
+                        // Retried below with the alternate nonce if available
+                    }
                 }
-            }
-            if (nonce.empty()) {
-                utxo["error"] = "failed to unblind utxo";
-                return false; // Cache not updated
-            }
+            });
         }
 
-        // Unblind the asset/amount details
-        utxo["satoshi"] = std::get<3>(unblinded);
-        // Return in display order
-        utxo["assetblinder"] = b2h_rev(std::get<2>(unblinded));
-        utxo["amountblinder"] = b2h_rev(std::get<1>(unblinded));
-        utxo["asset_id"] = b2h_rev(std::get<0>(unblinded));
-        constexpr bool mark_unconfidential = true;
-        remove_utxo_proofs(utxo, mark_unconfidential);
+        std::vector<cache::liquid_output_row> rows;
+        for (auto& r : requests) {
+            auto& utxo = *r.utxo;
+            if (!r.is_unblinded) {
+                // Make sure we can unblind the asset/amount details
+                auto nonce = get_alternate_blinding_nonce(locker, utxo, r.nonce_commitment);
+                if (!nonce.empty()) {
+                    // Try the alternate nonce
+                    try {
+                        r.unblinded
+                            = asset_unblind_with_nonce(nonce, r.rangeproof, r.commitment, r.script, r.asset_tag);
+                        r.is_unblinded = true;
+                    } catch (const std::exception&) {
+                    }
+                }
+                if (!r.is_unblinded) {
+                    utxo["error"] = "failed to unblind utxo";
+                    continue;
+                }
+            }
 
-        bool updated_blinding_cache = false;
-        if (!txhash.empty()) {
-            m_cache->insert_liquid_output(h2b(txhash), pt_idx, utxo);
-            updated_blinding_cache = true;
-        }
+            // Unblind the asset/amount details
+            utxo["satoshi"] = std::get<3>(r.unblinded);
+            // Return in display order
+            utxo["assetblinder"] = b2h_rev(std::get<2>(r.unblinded));
+            utxo["amountblinder"] = b2h_rev(std::get<1>(r.unblinded));
+            utxo["asset_id"] = b2h_rev(std::get<0>(r.unblinded));
+            constexpr bool mark_unconfidential = true;
+            remove_utxo_proofs(utxo, mark_unconfidential);
+
+            if (!r.txhash.empty()) {
+                rows.push_back({ h2b(r.txhash), r.pt_idx, &utxo });
+            }
 
-        if (has_address) {
-            // We should now be able to make the address confidential
-            const auto blinding_pubkey = m_cache->get_liquid_blinding_pubkey(script);
-            GDK_RUNTIME_ASSERT(!blinding_pubkey.empty());
-            confidentialize_address(m_net_params, utxo, b2h(blinding_pubkey));
+            if (r.has_address) {
+                // We should now be able to make the address confidential
+                const auto blinding_pubkey = m_cache->get_liquid_blinding_pubkey(r.script);
+                GDK_RUNTIME_ASSERT(!blinding_pubkey.empty());
+                confidentialize_address(m_net_params, utxo, b2h(blinding_pubkey));
+            }
         }
 
-        return updated_blinding_cache;
+        m_cache->insert_liquid_outputs(rows);
+        return !rows.empty();
     }
 
     std::vector<unsigned char> ga_session::get_alternate_blinding_nonce(
@@ -2083,21 +2614,25 @@ namespace sdk {
     bool ga_session::cleanup_utxos(session_impl::locker_t& locker, nlohmann::json& utxos, const std::string& for_txhash,
         unique_pubkeys_and_scripts_t& missing)
     {
+        GDK_TRACE_SPAN("ga_session::cleanup_utxos");
         GDK_RUNTIME_ASSERT(locker.owns_lock());
         const bool is_liquid = m_net_params.is_liquid();
-        bool updated_blinding_cache = false;
+        std::vector<unblind_request> requests;
 
         // Standardise key names and data types of server provided UTXOs.
         // For Liquid, unblind it if possible. If not, record the pubkey
         // and script needed to generate its blinding nonce in 'missing'.
+        // UTXOs which need their rangeproofs rewinding are unblinded
+        // together in a batch once all UTXOs have been processed.
         for (auto& utxo : utxos) {
             const bool is_external = !json_get_value(utxo, "private_key").empty();
+            const size_t num_requests = requests.size();
 
             auto address_type_p = utxo.find("address_type");
             if (is_liquid && utxo.value("error", std::string()) == "missing blinding nonce") {
                 // UTXO was previously processed but could not be unblinded: try again
-                updated_blinding_cache |= unblind_utxo(locker, utxo, for_txhash, missing);
-                if (!utxo.contains("error")) {
+                unblind_utxo(locker, utxo, for_txhash, missing, requests);
+                if (requests.size() == num_requests && !utxo.contains("error")) {
                     utxo.erase("value"); // Only remove value if we unblinded it
                 }
             } else if (address_type_p == utxo.end()) {
@@ -2134,7 +2669,7 @@ namespace sdk {
                 } else {
                     if (is_liquid) {
                         if (json_get_value(utxo, "is_relevant", true)) {
-                            updated_blinding_cache |= unblind_utxo(locker, utxo, for_txhash, missing);
+                            unblind_utxo(locker, utxo, for_txhash, missing, requests);
                         } else {
                             constexpr bool mark_unconfidential = false;
                             remove_utxo_proofs(utxo, mark_unconfidential);
@@ -2146,7 +2681,7 @@ namespace sdk {
                         utxo["satoshi"] = value;
                     }
                 }
-                if (!utxo.contains("error")) {
+                if (requests.size() == num_requests && !utxo.contains("error")) {
                     utxo.erase("value"); // Only remove value if we unblinded it
                 }
                 utxo.erase("ga_asset_id");
@@ -2160,11 +2695,30 @@ namespace sdk {
             }
         }
 
+        const bool updated_blinding_cache = unblind_utxos(locker, requests);
+        for (const auto& r : requests) {
+            if (!r.utxo->contains("error")) {
+                r.utxo->erase("value"); // Only remove value if we unblinded it
+            }
+        }
         return updated_blinding_cache;
     }
 
     nlohmann::json ga_session::sync_transactions(uint32_t subaccount, unique_pubkeys_and_scripts_t& missing)
     {
+        return sync_transactions_impl(subaccount, std::nullopt, missing);
+    }
+
+    nlohmann::json ga_session::sync_transactions(
+        uint32_t subaccount, uint64_t timestamp, unique_pubkeys_and_scripts_t& missing)
+    {
+        return sync_transactions_impl(subaccount, timestamp, missing);
+    }
+
+    nlohmann::json ga_session::sync_transactions_impl(
+        uint32_t subaccount, std::optional<uint64_t> ahead_timestamp, unique_pubkeys_and_scripts_t& missing)
+    {
+        GDK_TRACE_SPAN("ga_session::sync_transactions");
         auto locker_p{ get_multi_call_locker(MC_TX_CACHE, true) };
         auto& locker = *locker_p;
 
@@ -2172,18 +2726,113 @@ namespace sdk {
         m_multi_call_category |= MC_TX_CACHE;
         const auto cleanup = gsl::finally([this]() { m_multi_call_category &= ~MC_TX_CACHE; });
 
-        const auto timestamp = m_cache->get_latest_transaction_timestamp(subaccount);
-        GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): latest timestamp = " << timestamp;
+        uint64_t timestamp;
+        if (ahead_timestamp.has_value()) {
+            timestamp = ahead_timestamp.value();
+            GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): syncing ahead from " << timestamp;
+        } else {
+            timestamp = m_cache->get_latest_transaction_timestamp(subaccount);
+            GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): latest timestamp = " << timestamp;
 
-        if (m_synced_subaccounts.count(subaccount)) {
-            // We know our cache is up to date, avoid going to the server
-            GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): already synced";
-            return { { "list", nlohmann::json::array() }, { "more", false }, { "sync_ts", timestamp } };
+            if (m_synced_subaccounts.count(subaccount)) {
+                // We know our cache is up to date, avoid going to the server
+                GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): already synced";
+                return { { "list", nlohmann::json::array() }, { "more", false }, { "sync_ts", timestamp } };
+            }
         }
 
         // Get a page of txs from the server if any are newer than our last cached one
+        nlohmann::json ret = fetch_transactions(locker, subaccount, timestamp);
+        process_synced_transactions(locker, subaccount, timestamp, ret, missing);
+        return ret;
+    }
+
+    void ga_session::prefetch_transactions(uint32_t subaccount, uint64_t timestamp)
+    {
+        std::future<autobahn::wamp_call_result> call;
+        try {
+            call = m_wamp->call_async("txs.get_list_v3", subaccount, timestamp);
+        } catch (const std::exception&) {
+            return; // Prefetching is optional, the page will be fetched when synced
+        }
+        auto page = std::async(
+            std::launch::deferred, [call = std::move(call)]() mutable { return wamp_cast_json(call.get()); });
+        locker_t locker(m_mutex);
+        m_tx_prefetch[subaccount] = { timestamp, std::move(page) };
+    }
+
+    nlohmann::json ga_session::fetch_transactions(
+        session_impl::locker_t& locker, uint32_t subaccount, uint64_t timestamp)
+    {
+        GDK_RUNTIME_ASSERT(locker.owns_lock());
+        auto prefetched_p = m_tx_prefetch.find(subaccount);
+        if (prefetched_p != m_tx_prefetch.end()) {
+            auto prefetched = std::move(prefetched_p->second);
+            m_tx_prefetch.erase(prefetched_p);
+            if (prefetched.first == timestamp) {
+                GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): using prefetched page";
+                try {
+                    unique_unlock unlocker(locker);
+                    return prefetched.second.get();
+                } catch (const std::exception&) {
+                    // Fall through to fetch the page again
+                }
+            }
+            // Otherwise the page is stale or failed to fetch: fetch it again
+        }
         auto result = m_wamp->call(locker, "txs.get_list_v3", subaccount, timestamp);
-        nlohmann::json ret = wamp_cast_json(result);
+        return wamp_cast_json(result);
+    }
+
+    std::map<uint32_t, nlohmann::json> ga_session::sync_transactions(
+        const std::vector<uint32_t>& subaccounts, unique_pubkeys_and_scripts_t& missing)
+    {
+        GDK_TRACE_SPAN("ga_session::sync_transactions");
+        auto locker_p{ get_multi_call_locker(MC_TX_CACHE, true) };
+        auto& locker = *locker_p;
+
+        // Mark for other threads that a tx cache affecting call is running
+        m_multi_call_category |= MC_TX_CACHE;
+        const auto cleanup = gsl::finally([this]() { m_multi_call_category &= ~MC_TX_CACHE; });
+
+        std::map<uint32_t, nlohmann::json> ret;
+        std::vector<std::pair<uint32_t, uint64_t>> to_fetch; // subaccount, timestamp
+        for (const auto subaccount : subaccounts) {
+            const auto timestamp = m_cache->get_latest_transaction_timestamp(subaccount);
+            GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): latest timestamp = " << timestamp;
+            if (m_synced_subaccounts.count(subaccount)) {
+                GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): already synced";
+                ret[subaccount]
+                    = { { "list", nlohmann::json::array() }, { "more", false }, { "sync_ts", timestamp } };
+            } else if (!ret.count(subaccount)) {
+                ret[subaccount] = nlohmann::json();
+                to_fetch.emplace_back(subaccount, timestamp);
+            }
+        }
+
+        {
+            // Issue all of the server calls before waiting for any of them
+            unique_unlock unlocker(locker);
+            std::vector<std::future<autobahn::wamp_call_result>> calls;
+            calls.reserve(to_fetch.size());
+            for (const auto& f : to_fetch) {
+                calls.emplace_back(m_wamp->call_async("txs.get_list_v3", f.first, f.second));
+            }
+            for (size_t i = 0; i < calls.size(); ++i) {
+                ret[to_fetch[i].first] = wamp_cast_json(calls[i].get());
+            }
+        }
+
+        for (const auto& f : to_fetch) {
+            process_synced_transactions(locker, f.first, f.second, ret[f.first], missing);
+        }
+        return ret;
+    }
+
+    void ga_session::process_synced_transactions(session_impl::locker_t& locker, uint32_t subaccount,
+        uint64_t timestamp, nlohmann::json& ret, unique_pubkeys_and_scripts_t& missing)
+    {
+        GDK_RUNTIME_ASSERT(locker.owns_lock());
         GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx sync(" << subaccount << "): server returned " << ret["list"].size()
                                     << " txs, more = " << ret["more"];
 
@@ -2209,7 +2858,6 @@ namespace sdk {
         // Store the timestamp that we started fetching from in order to detect
         // whether the cache was invalidated when we save it.
         ret["sync_ts"] = timestamp;
-        return ret;
     }
 
     void ga_session::store_transactions(uint32_t subaccount, nlohmann::json& txs)
@@ -2242,12 +2890,13 @@ namespace sdk {
             }
         }
 
+        std::vector<cache::transaction_row> tx_rows;
         for (auto& tx_details : txs["list"]) {
             const std::string txhash = tx_details["txhash"];
             const uint32_t tx_block_height = tx_details["block_height"];
 
             std::map<std::string, int64_t> totals; /* Note: signed */
-            std::map<uint32_t, nlohmann::json> in_map, out_map;
+            nlohmann::json::array_t inputs, outputs;
             std::set<std::string> unique_asset_ids;
 
             if (is_liquid) {
@@ -2278,24 +2927,25 @@ namespace sdk {
                     }
                 }
 
-                // Note pt_idx on endpoints is the index within the tx, not the previous tx!
-                const uint32_t pt_idx = ep["pt_idx"];
-                auto& m = is_tx_output ? out_map : in_map;
-                GDK_RUNTIME_ASSERT(m.emplace(pt_idx, std::move(ep)).second);
-            }
+                if (is_liquid && ep.contains("error")) {
+                    // Proofs of endpoints we failed to unblind are not used
+                    // again: don't store them in the tx cache
+                    constexpr bool mark_unconfidential = false;
+                    remove_utxo_proofs(ep, mark_unconfidential);
+                }
 
-            // Store the endpoints as inputs/outputs in tx index order
-            nlohmann::json::array_t inputs, outputs;
-            inputs.reserve(in_map.size());
-            for (auto& it : in_map) {
-                inputs.emplace_back(std::move(it.second));
+                (is_tx_output ? outputs : inputs).emplace_back(std::move(ep));
             }
-            tx_details["inputs"] = std::move(inputs);
 
-            outputs.reserve(out_map.size());
-            for (auto& it : out_map) {
-                outputs.emplace_back(std::move(it.second));
+            // Store the endpoints as inputs/outputs in tx index order.
+            // Note pt_idx on endpoints is the index within the tx, not the previous tx!
+            auto&& by_pt_idx = [](const auto& lhs, const auto& rhs) { return lhs.at("pt_idx") < rhs.at("pt_idx"); };
+            auto&& same_pt_idx = [](const auto& lhs, const auto& rhs) { return lhs.at("pt_idx") == rhs.at("pt_idx"); };
+            for (auto* eps : { &inputs, &outputs }) {
+                std::sort(eps->begin(), eps->end(), by_pt_idx);
+                GDK_RUNTIME_ASSERT(std::adjacent_find(eps->begin(), eps->end(), same_pt_idx) == eps->end());
             }
+            tx_details["inputs"] = std::move(inputs);
             tx_details["outputs"] = std::move(outputs);
             tx_details.erase("eps");
 
@@ -2370,10 +3020,11 @@ namespace sdk {
                 const uint64_t tx_timestamp = tx_details.at("created_at_ts");
                 GDK_LOG_SEV(TX_CACHE_LEVEL)
                     << "Tx sync(" << subaccount << ") inserting " << txhash << ":" << tx_timestamp;
-                m_cache->insert_transaction(subaccount, tx_timestamp, txhash, tx_details);
+                tx_rows.push_back({ tx_timestamp, txhash, &tx_details });
                 txs["sync_ts"] = tx_timestamp;
             }
         }
+        m_cache->insert_transactions(subaccount, tx_rows);
         if (!sync_disrupted && !txs["more"]) {
             // We have synced all available transactions, mark the subaccount up to date
             m_synced_subaccounts.insert(subaccount);
@@ -2405,9 +3056,13 @@ namespace sdk {
 
         nlohmann::json spv_params;
         if (m_spv_enabled) {
-            spv_params = get_spv_params(m_net_params, get_proxy_settings());
+            spv_params = get_spv_params(m_net_params, get_proxy_settings(), m_local_encryption_key);
         }
 
+        // Txs whose status must be checked, which are verified in one batch
+        std::vector<nlohmann::json*> to_verify;
+        nlohmann::json::array_t txs_to_verify;
+
         for (auto& tx_details : tx_list) {
             const uint32_t tx_block_height = tx_details["block_height"];
             auto& spv_verified = tx_details["spv_verified"];
@@ -2425,33 +3080,43 @@ namespace sdk {
             }
 
             const std::string txhash_hex = tx_details["txhash"];
-            spv_params["txid"] = txhash_hex;
-            spv_params["height"] = tx_block_height;
-
-            std::string spv_status;
             if (m_spv_verified_txs.count(txhash_hex)) {
                 GDK_LOG_SEV(log_level::debug) << txhash_hex << " cached as verified";
-                spv_status = "verified"; // Previously verified
-            } else {
-                spv_status = spv_get_status_string(spv_verify_tx(spv_params));
-                GDK_LOG_SEV(log_level::debug) << txhash_hex << " status " << spv_status;
+                spv_verified = "verified"; // Previously verified
+                continue;
             }
-            if (!are_downloading && spv_status == "in_progress") {
-                // Start syncing headers for SPV if we aren't already doing it
-                constexpr bool do_start = true;
-                download_headers_ctl(locker, do_start);
-                are_downloading = true;
-            }
-            if (spv_status == "verified") {
-                if (tx_block_height < reorg_block) {
-                    // Verified and committed beyond our reorg depth, update the cache
-                    m_cache->set_transaction_spv_verified(txhash_hex);
-                } else {
-                    // Not committed beyond reorg depth: cache in memory only
-                    m_spv_verified_txs.insert(txhash_hex);
+            to_verify.push_back(&tx_details);
+            txs_to_verify.push_back({ { "txid", txhash_hex }, { "height", tx_block_height } });
+        }
+
+        if (!to_verify.empty()) {
+            spv_params["txs"] = std::move(txs_to_verify);
+            const auto spv_statuses = spv_verify_txs(spv_params);
+
+            for (size_t i = 0; i < to_verify.size(); ++i) {
+                auto& tx_details = *to_verify[i];
+                const std::string txhash_hex = tx_details["txhash"];
+                const uint32_t tx_block_height = tx_details["block_height"];
+                std::string spv_status = spv_get_status_string(spv_statuses[i]);
+                GDK_LOG_SEV(log_level::debug) << txhash_hex << " status " << spv_status;
+
+                if (!are_downloading && spv_status == "in_progress") {
+                    // Start syncing headers for SPV if we aren't already doing it
+                    constexpr bool do_start = true;
+                    download_headers_ctl(locker, do_start);
+                    are_downloading = true;
                 }
+                if (spv_status == "verified") {
+                    if (tx_block_height < reorg_block) {
+                        // Verified and committed beyond our reorg depth, update the cache
+                        m_cache->set_transaction_spv_verified(txhash_hex);
+                    } else {
+                        // Not committed beyond reorg depth: cache in memory only
+                        m_spv_verified_txs.insert(txhash_hex);
+                    }
+                }
+                tx_details["spv_verified"] = std::move(spv_status);
             }
-            spv_verified = std::move(spv_status);
         }
         m_cache->save_db(); // No-op if unchanged
     }
@@ -2459,8 +3124,20 @@ namespace sdk {
     nlohmann::json ga_session::get_transactions(const nlohmann::json& details)
     {
         const uint32_t subaccount = details.at("subaccount");
-        const uint32_t first = details.at("first");
         const uint32_t count = details.at("count");
+        // A cursor from a previous page seeks directly to the txs after it,
+        // instead of skipping "first" txs to reach them
+        const std::string cursor = json_get_value(details, "cursor");
+        std::optional<uint64_t> before_ts;
+        if (!cursor.empty()) {
+            const auto parsed = parse_transactions_cursor(cursor);
+            if (!parsed.has_value()) {
+                throw user_error("invalid cursor");
+            }
+            before_ts = parsed;
+        }
+        const uint32_t first = before_ts.has_value() ? 0 : details.at("first").get<uint32_t>();
+        const auto search_p = details.find("search");
         nlohmann::json::array_t result;
         result.reserve(std::min(count, 1000u)); // Prevent reallocs for reasonable fetches
         locker_t locker(m_mutex);
@@ -2474,12 +3151,28 @@ namespace sdk {
             return nlohmann::json(false);
         }
 
-        m_cache->get_transactions(subaccount, first, count,
-            { [&result](uint64_t /*ts*/, const std::string& /*txhash*/, uint32_t /*block*/, uint32_t /*spent*/,
-                  uint32_t spv_status, nlohmann::json& tx_json) {
-                tx_json["spv_verified"] = spv_get_status_string(spv_status);
-                result.emplace_back(std::move(tx_json));
-            } });
+        const auto tx_fn = [&result](uint64_t /*ts*/, const std::string& /*txhash*/, uint32_t /*block*/,
+                               uint32_t /*spent*/, uint32_t spv_status, nlohmann::json& tx_json) {
+            tx_json["spv_verified"] = spv_get_status_string(spv_status);
+            result.emplace_back(std::move(tx_json));
+        };
+        if (search_p != details.end() && !search_p->is_null()) {
+            // Filter the cached txs in the DB, rather than returning them all
+            auto search = get_transaction_search(*search_p);
+            const std::string memo = json_get_value(*search_p, "memo");
+            if (!memo.empty()) {
+                // Memos are stored in the client blob, not the tx cache
+                if (m_blob_outdated) {
+                    load_client_blob(locker, true);
+                }
+                search.txhashes = m_blob.find_tx_memos(memo);
+            }
+            m_cache->search_transactions(subaccount, search, before_ts, first, count, tx_fn);
+        } else if (before_ts.has_value()) {
+            m_cache->get_transactions_before(subaccount, before_ts.value(), count, tx_fn);
+        } else {
+            m_cache->get_transactions(subaccount, first, count, tx_fn);
+        }
 
         return nlohmann::json(std::move(result));
     }
@@ -2521,14 +3214,20 @@ namespace sdk {
         }
         do {
             const nlohmann::json result = get_previous_addresses(details);
+            std::vector<cache::scriptpubkey_row> rows;
+            rows.reserve(result.at("list").size());
             for (auto& address : result.at("list")) {
                 const bool allow_unconfidential = true;
-                const auto spk = scriptpubkey_from_address(m_net_params, address.at("address"), allow_unconfidential);
+                auto spk = scriptpubkey_from_address(m_net_params, address.at("address"), allow_unconfidential);
                 const uint32_t branch = json_get_value(address, "branch", 1);
                 const uint32_t pointer = address.at("pointer");
                 const uint32_t subtype = json_get_value(address, "subtype", 0);
                 const uint32_t script_type = address.at("script_type");
-                encache_scriptpubkey_data(spk, subaccount, branch, pointer, subtype, script_type);
+                rows.push_back({ std::move(spk), subaccount, branch, pointer, subtype, script_type });
+            }
+            {
+                locker_t locker(m_mutex);
+                m_cache->insert_scriptpubkey_data(rows);
             }
             if (result.contains("last_pointer")) {
                 details["last_pointer"] = result.at("last_pointer");
@@ -2548,6 +3247,17 @@ namespace sdk {
         return m_cache->get_scriptpubkey_data(scriptpubkey);
     }
 
+    std::vector<nlohmann::json> ga_session::get_scriptpubkeys_data(const std::vector<byte_span_t>& scriptpubkeys)
+    {
+        std::vector<nlohmann::json> ret;
+        ret.reserve(scriptpubkeys.size());
+        locker_t locker(m_mutex);
+        for (const auto& scriptpubkey : scriptpubkeys) {
+            ret.emplace_back(m_cache->get_scriptpubkey_data(scriptpubkey));
+        }
+        return ret;
+    }
+
     nlohmann::json ga_session::get_unspent_outputs(const nlohmann::json& details, unique_pubkeys_and_scripts_t& missing)
     {
         const uint32_t subaccount = details.at("subaccount");
@@ -2617,14 +3327,17 @@ namespace sdk {
         }
 
         // Return the UTXOs grouped by asset id
-        // FIXME: Move the results from utxos instead of copying
         nlohmann::json asset_utxos;
-        for (const auto& utxo : utxos) {
+        for (auto& utxo : utxos) {
             if (utxo.contains("error")) {
-                asset_utxos["error"].emplace_back(utxo);
+                // Proofs of UTXOs we failed to unblind are not used again:
+                // remove them to avoid holding them in the UTXO cache
+                constexpr bool mark_unconfidential = false;
+                remove_utxo_proofs(utxo, mark_unconfidential);
+                asset_utxos["error"].emplace_back(std::move(utxo));
             } else {
                 const auto utxo_asset_id = asset_id_from_json(m_net_params, utxo);
-                asset_utxos[utxo_asset_id].emplace_back(utxo);
+                asset_utxos[utxo_asset_id].emplace_back(std::move(utxo));
             }
         }
         utxos.swap(asset_utxos);
@@ -2638,25 +3351,11 @@ namespace sdk {
         // it can't be determined from the private_key format
         GDK_RUNTIME_ASSERT(unused == 0);
 
-        std::vector<unsigned char> private_key_bytes;
-        bool compressed;
-        std::tie(private_key_bytes, compressed)
-            = to_private_key_bytes(private_key, password, m_net_params.is_main_net());
-        auto public_key_bytes = ec_public_key_from_private_key(gsl::make_span(private_key_bytes));
-        if (!compressed) {
-            public_key_bytes = ec_public_key_decompress(public_key_bytes);
-        }
-        const auto script_bytes = scriptpubkey_p2pkh_from_hash160(hash160(public_key_bytes));
-        const auto script_hash_hex = electrum_script_hash_hex(script_bytes);
+        const auto key = get_sweep_key(private_key, password, m_net_params.is_main_net());
+        const auto script_hash_hex = electrum_script_hash_hex(key.script);
 
         auto utxos = wamp_cast_json(m_wamp->call("vault.get_utxos_for_script_hash", script_hash_hex));
-        for (auto& utxo : utxos) {
-            utxo["private_key"] = b2h(private_key_bytes);
-            utxo["compressed"] = compressed;
-            utxo["public_key"] = b2h(public_key_bytes);
-            utxo["prevout_script"] = b2h(script_bytes);
-            utxo["script_type"] = script_type::ga_pubkey_hash_out;
-        }
+        set_sweep_utxos_key(utxos, key);
 
         unique_pubkeys_and_scripts_t missing; // Always empty for sweeping
         locker_t locker(m_mutex);
@@ -2664,6 +3363,61 @@ namespace sdk {
         return utxos;
     }
 
+    // Idempotent
+    nlohmann::json ga_session::get_unspent_outputs_for_private_keys(const nlohmann::json& details)
+    {
+        const auto& private_keys = details.at("private_keys");
+        GDK_RUNTIME_ASSERT(private_keys.is_array());
+        const size_t num_keys = private_keys.size();
+        const bool is_main_net = m_net_params.is_main_net();
+
+        // Decode the keys in parallel, since decrypting BIP38 keys is slow.
+        // Keys that fail to decode are left empty and reported as invalid.
+        std::vector<std::optional<sweep_key_t>> keys(num_keys);
+        constexpr size_t min_keys_per_thread = 1;
+        constexpr size_t max_threads = 8;
+        parallel_for_chunks(num_keys, min_keys_per_thread, max_threads, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                const auto& key = private_keys[i];
+                try {
+                    keys[i] = get_sweep_key(key.at("private_key"), json_get_value(key, "password"), is_main_net);
+                } catch (const std::exception&) {
+                    // Reported as invalid below
+                }
+            }
+        });
+
+        // Send the lookups for every key before waiting for any results
+        std::vector<std::future<autobahn::wamp_call_result>> calls(num_keys);
+        for (size_t i = 0; i < num_keys; ++i) {
+            if (keys[i]) {
+                const auto script_hash_hex = electrum_script_hash_hex(keys[i]->script);
+                calls[i] = m_wamp->call_async("vault.get_utxos_for_script_hash", script_hash_hex);
+            }
+        }
+
+        nlohmann::json::array_t results(num_keys);
+        for (size_t i = 0; i < num_keys; ++i) {
+            if (!keys[i]) {
+                results[i] = { { "error", std::string(res::id_invalid_private_key) } };
+                continue;
+            }
+            auto utxos = wamp_cast_json(calls[i].get());
+            set_sweep_utxos_key(utxos, *keys[i]);
+            results[i] = { { "utxos", std::move(utxos) } };
+        }
+
+        unique_pubkeys_and_scripts_t missing; // Always empty for sweeping
+        locker_t locker(m_mutex);
+        for (auto& result : results) {
+            if (auto p = result.find("utxos"); p != result.end()) {
+                // Should never do unblinding
+                GDK_RUNTIME_ASSERT(!cleanup_utxos(locker, *p, std::string(), missing));
+            }
+        }
+        return { { "results", std::move(results) } };
+    }
+
     // Idempotent
     nlohmann::json ga_session::set_unspent_outputs_status(
         const nlohmann::json& details, const nlohmann::json& twofactor_data)
@@ -2678,23 +3432,19 @@ namespace sdk {
     wally_tx_ptr ga_session::get_raw_transaction_details(const std::string& txhash_hex) const
     {
         try {
-            wally_tx_ptr tx;
             const auto flags = tx_flags(m_net_params.is_liquid());
             locker_t locker(m_mutex);
             // First, try the local cache
-            m_cache->get_transaction_data(txhash_hex, { [&tx, flags](const auto& db_blob) {
-                if (db_blob.has_value()) {
-                    tx = tx_from_bin(db_blob.value(), flags);
-                }
-            } });
+            wally_tx_ptr tx = m_cache->get_transaction_tx(txhash_hex, flags);
             if (tx) {
                 GDK_LOG_SEV(TX_CACHE_LEVEL) << "Tx cache using cached " << txhash_hex;
             } else {
                 // If not found, ask the server
                 const std::string tx_data = wamp_cast(m_wamp->call(locker, "txs.get_raw_output", txhash_hex));
-                tx = tx_from_hex(tx_data, flags);
+                const auto tx_bin = h2b(tx_data);
+                tx = tx_from_bin(tx_bin, flags);
                 // Cache the result
-                m_cache->insert_transaction_data(txhash_hex, h2b(tx_data));
+                m_cache->insert_transaction_data(txhash_hex, tx_bin);
             }
             return tx;
         } catch (const std::exception& e) {
@@ -2809,6 +3559,26 @@ namespace sdk {
         auto addresses = wamp_cast_json(m_wamp->call("addressbook.get_my_addresses", subaccount, last_pointer));
         uint32_t seen_pointer = 0;
 
+        if (!addresses.empty()) {
+            // Derive the keys for the returned pointers in parallel up front,
+            // so that verifying each address below hits the derived key cache
+            uint32_t min_pointer = std::numeric_limits<uint32_t>::max(), max_pointer = 0;
+            for (const auto& address : addresses) {
+                const uint32_t pointer = address.at("pointer");
+                min_pointer = std::min(min_pointer, pointer);
+                max_pointer = std::max(max_pointer, pointer);
+            }
+            const uint32_t count = max_pointer - min_pointer + 1;
+            locker_t locker(m_mutex);
+            if (m_user_pubkeys && m_recovery_pubkeys && count <= addresses.size() * 2) {
+                get_ga_pubkeys().derive_range(subaccount, min_pointer, count);
+                get_user_pubkeys().derive_range(subaccount, min_pointer, count);
+                if (m_recovery_pubkeys->have_subaccount(subaccount)) {
+                    m_recovery_pubkeys->derive_range(subaccount, min_pointer, count);
+                }
+            }
+        }
+
         for (auto& address : addresses) {
             address["subaccount"] = subaccount;
             update_address_info(address, true);
@@ -2832,11 +3602,45 @@ namespace sdk {
             addr_type == address_type::p2sh || addr_type == address_type::p2wsh || addr_type == address_type::csv,
             "Unknown address type");
 
+        if (m_net_params.get_address_pool_size()) {
+            // Take an address from the pool if one is available
+            nlohmann::json address;
+            locker_t locker(m_mutex);
+            auto& pool = m_address_pool[subaccount];
+            const auto p = std::find_if(
+                pool.begin(), pool.end(), [&addr_type](const auto& a) { return a.at("address_type") == addr_type; });
+            if (p != pool.end()) {
+                address = std::move(*p);
+                pool.erase(p);
+            }
+            ++m_address_pool_requests;
+            constexpr bool do_start = true;
+            address_pool_ctl(locker, do_start); // Top the pool up in the background
+            if (!address.is_null()) {
+                return address;
+            }
+        }
+        return std::move(fetch_receive_addresses(subaccount, addr_type, 1).front());
+    }
+
+    std::vector<nlohmann::json> ga_session::fetch_receive_addresses(
+        uint32_t subaccount, const std::string& addr_type, size_t count)
+    {
         constexpr bool return_pointer = true;
-        auto address = wamp_cast_json(m_wamp->call("vault.fund", subaccount, return_pointer, addr_type));
-        update_address_info(address, false);
-        GDK_RUNTIME_ASSERT(address["address_type"] == addr_type);
-        return address;
+        std::vector<std::future<autobahn::wamp_call_result>> calls;
+        calls.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            calls.emplace_back(m_wamp->call_async("vault.fund", subaccount, return_pointer, addr_type));
+        }
+        std::vector<nlohmann::json> addresses;
+        addresses.reserve(count);
+        for (auto& call : calls) {
+            auto address = wamp_cast_json(call.get());
+            update_address_info(address, false);
+            GDK_RUNTIME_ASSERT(address["address_type"] == addr_type);
+            addresses.emplace_back(std::move(address));
+        }
+        return addresses;
     }
 
     // Idempotent
@@ -2875,7 +3679,7 @@ namespace sdk {
 
     bool ga_session::subaccount_allows_csv(uint32_t subaccount) const
     {
-        locker_t locker(m_mutex);
+        std::shared_lock<std::shared_mutex> subaccounts_locker(m_subaccounts_mutex);
         const auto p = m_subaccounts.find(subaccount);
         GDK_RUNTIME_ASSERT_MSG(p != m_subaccounts.end(), "Unknown subaccount");
         return p->second.at("type") == "2of2"; // Only Green 2of2 subaccounts allow CSV
@@ -2914,6 +3718,7 @@ namespace sdk {
         if (m_twofactor_config.is_null() || reset_cached) {
             const auto config = wamp_cast_json(m_wamp->call(locker, "twofactor.get_config"));
             set_twofactor_config(locker, config);
+            save_login_snapshot(locker);
         }
         nlohmann::json ret = m_twofactor_config;
 
@@ -3331,7 +4136,7 @@ namespace sdk {
 
         // TODO: get outputs/change subaccounts also, for multi-account spends
         const auto subaccounts = get_tx_subaccounts(details);
-        remove_cached_utxos({ subaccounts.begin(), subaccounts.end() });
+        update_cached_utxos({ subaccounts.begin(), subaccounts.end() }, txhash_hex);
 
         locker_t locker(m_mutex);
         for (auto subaccount : subaccounts) {
@@ -3440,7 +4245,12 @@ namespace sdk {
 
     void ga_session::download_headers_thread_fn()
     {
-        const auto spv_params = get_spv_params(m_net_params, get_proxy_settings());
+        const auto proxy_settings = get_proxy_settings();
+        nlohmann::json spv_params;
+        {
+            locker_t locker(m_mutex);
+            spv_params = get_spv_params(m_net_params, proxy_settings, m_local_encryption_key);
+        }
         uint32_t last_fetched_height = 0;
 
         // Loop downloading block headers until we are caught up, then exit
@@ -3476,5 +4286,169 @@ namespace sdk {
         m_spv_thread_done = true;
     }
 
+    void ga_session::tx_sync_ctl(session_impl::locker_t& locker, bool do_start)
+    {
+        GDK_RUNTIME_ASSERT(locker.owns_lock());
+        if (!m_net_params.is_background_tx_sync_enabled()) {
+            return; // Background syncing is not enabled: nothing to do
+        }
+
+        if (m_tx_sync_thread) {
+            // A thread syncing txs already exists
+            if (!m_tx_sync_thread_done) {
+                // Thread is still running
+                if (do_start) {
+                    // Let the existing thread continue running
+                    return;
+                }
+                // Ask and wait for the thread to die
+                m_tx_sync_thread_stop = true;
+                while (!m_tx_sync_thread_done) {
+                    unique_unlock unlocker(locker);
+                    std::this_thread::sleep_for(100ms);
+                }
+            }
+            // Thread is finished, join and delete it
+            m_tx_sync_thread->join();
+            m_tx_sync_thread.reset();
+        }
+
+        m_tx_sync_thread_done = false;
+        m_tx_sync_thread_stop = false;
+
+        if (do_start) {
+            // Start up a new sync thread
+            GDK_RUNTIME_ASSERT(!m_tx_sync_thread);
+            m_tx_sync_thread.reset(new std::thread([this] { tx_sync_thread_fn(); }));
+        }
+    }
+
+    void ga_session::address_pool_ctl(session_impl::locker_t& locker, bool do_start)
+    {
+        GDK_RUNTIME_ASSERT(locker.owns_lock());
+        if (!m_address_pool_refill_done) {
+            // A refill is queued or running
+            if (do_start) {
+                // Let the existing refill continue
+                return;
+            }
+            // Ask and wait for the refill to finish. It marks itself done
+            // while holding m_mutex, and does not touch the session after
+            m_address_pool_refill_stop = true;
+            while (!m_address_pool_refill_done) {
+                unique_unlock unlocker(locker);
+                std::this_thread::sleep_for(100ms);
+            }
+        }
+
+        m_address_pool_refill_stop = false;
+
+        if (do_start) {
+            // Refill on the shared call pool, as fetching makes server calls
+            m_address_pool_refill_done = false;
+            get_call_pool().post([this] { address_pool_refill(); });
+        }
+    }
+
+    void ga_session::address_pool_refill()
+    {
+        const size_t pool_size = m_net_params.get_address_pool_size();
+        try {
+            // Refill the pool of every subaccount addresses have been
+            // requested from, until they are all full
+            for (;;) {
+                std::vector<uint32_t> subaccounts;
+                uint64_t requests;
+                {
+                    locker_t locker(m_mutex);
+                    for (const auto& p : m_address_pool) {
+                        subaccounts.push_back(p.first);
+                    }
+                    requests = m_address_pool_requests;
+                }
+                bool fetched = false;
+                for (const auto subaccount : subaccounts) {
+                    if (m_address_pool_refill_stop) {
+                        break;
+                    }
+                    const std::string addr_type = get_default_address_type(subaccount);
+                    size_t num_pooled;
+                    {
+                        locker_t locker(m_mutex);
+                        const auto& pool = m_address_pool[subaccount];
+                        num_pooled = std::count_if(pool.begin(), pool.end(),
+                            [&addr_type](const auto& a) { return a.at("address_type") == addr_type; });
+                    }
+                    if (num_pooled < pool_size) {
+                        auto addresses = fetch_receive_addresses(subaccount, addr_type, pool_size - num_pooled);
+                        locker_t locker(m_mutex);
+                        auto& pool = m_address_pool[subaccount];
+                        std::move(addresses.begin(), addresses.end(), std::back_inserter(pool));
+                        fetched = true;
+                    }
+                }
+                locker_t locker(m_mutex);
+                if (m_address_pool_refill_stop || (!fetched && requests == m_address_pool_requests)) {
+                    // Stopped, or every pool is full and none were taken from
+                    // since we checked: finish while holding the lock so that
+                    // get_receive_address starts a new refill if needed
+                    m_address_pool_refill_done = true;
+                    return;
+                }
+            }
+        } catch (const std::exception& e) {
+            GDK_LOG_SEV(log_level::warning) << "address_pool exception:" << e.what();
+        }
+        locker_t locker(m_mutex);
+        m_address_pool_refill_done = true;
+    }
+
+    void ga_session::tx_sync_thread_fn()
+    {
+        auto pending = get_subaccount_pointers();
+        const size_t num_subaccounts = pending.size();
+        size_t num_synced = 0;
+
+        // Loop fetching a page of txs for every unsynced subaccount at once
+        // until all subaccounts are up to date, then exit
+        GDK_LOG_SEV(log_level::info) << "tx_sync: starting sync of " << num_subaccounts << " subaccounts";
+        while (!pending.empty()) {
+            if (m_tx_sync_thread_stop) {
+                GDK_LOG_SEV(log_level::info) << "tx_sync: exit requested";
+                break; // We have been asked to terminate; do so
+            }
+            try {
+                unique_pubkeys_and_scripts_t missing;
+                auto results = sync_transactions(pending, missing);
+                if (!missing.empty()) {
+                    // Blinding nonces must be requested from the signer, which
+                    // only get_transactions can do. Leave syncing to it.
+                    GDK_LOG_SEV(log_level::info) << "tx_sync: blinding nonces required, exiting";
+                    break;
+                }
+                std::vector<uint32_t> unsynced;
+                for (auto& result : results) {
+                    store_transactions(result.first, result.second);
+                    if (result.second.value("more", false)) {
+                        unsynced.push_back(result.first);
+                    } else {
+                        ++num_synced;
+                    }
+                }
+                pending.swap(unsynced);
+                emit_notification({ { "event", "sync" },
+                                      { "sync",
+                                          { { "subaccounts_synced", num_synced },
+                                              { "subaccounts_total", num_subaccounts } } } },
+                    false);
+            } catch (const std::exception& e) {
+                GDK_LOG_SEV(log_level::warning) << "tx_sync exception:" << e.what();
+                break; // Exception, exit
+            }
+        }
+        locker_t locker(m_mutex);
+        m_tx_sync_thread_done = true;
+    }
+
 } // namespace sdk
 } // namespace ga
@@ -4,8 +4,11 @@
 
 #include <array>
 #include <chrono>
+#include <deque>
+#include <future>
 #include <map>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
@@ -18,6 +21,7 @@ namespace ga {
 namespace sdk {
     struct cache;
     class ga_user_pubkeys;
+    class network_state;
     class wamp_transport;
 
     class ga_session final : public session_impl {
@@ -31,8 +35,9 @@ namespace sdk {
         void reconnect();
         void reconnect_hint(const nlohmann::json& hint);
         void disconnect();
-
-        void emit_notification(nlohmann::json details, bool async);
+        nlohmann::json get_metrics() const;
+        nlohmann::json get_memory_usage();
+        void trim_memory();
 
         nlohmann::json register_user(const std::string& master_pub_key_hex, const std::string& master_chain_code_hex,
             const std::string& gait_path_hex, bool supports_csv);
@@ -45,6 +50,10 @@ namespace sdk {
 
         void register_subaccount_xpubs(
             const std::vector<uint32_t>& pointers, const std::vector<std::string>& bip32_xpubs);
+        nlohmann::json warm_login(
+            std::shared_ptr<signer> signer, const std::string& root_bip32_xpub, sign_challenge_fn_t sign_fn);
+        // Start background tx syncing, if enabled
+        void start_sync_threads();
 
         nlohmann::json credentials_from_pin_data(const nlohmann::json& pin_data);
         nlohmann::json login_wo(std::shared_ptr<signer> signer);
@@ -109,6 +118,7 @@ namespace sdk {
         void process_unspent_outputs(nlohmann::json& utxos);
         nlohmann::json get_unspent_outputs_for_private_key(
             const std::string& private_key, const std::string& password, uint32_t unused);
+        nlohmann::json get_unspent_outputs_for_private_keys(const nlohmann::json& details);
         nlohmann::json set_unspent_outputs_status(const nlohmann::json& details, const nlohmann::json& twofactor_data);
         wally_tx_ptr get_raw_transaction_details(const std::string& txhash_hex) const;
         nlohmann::json get_transaction_details(const std::string& txhash_hex) const;
@@ -141,6 +151,7 @@ namespace sdk {
             uint32_t subtype, uint32_t script_type);
         void encache_new_scriptpubkeys(uint32_t subaccount);
         nlohmann::json get_scriptpubkey_data(byte_span_t scriptpubkey);
+        std::vector<nlohmann::json> get_scriptpubkeys_data(const std::vector<byte_span_t>& scriptpubkeys);
 
         amount get_min_fee_rate() const;
         amount get_default_fee_rate() const;
@@ -161,15 +172,30 @@ namespace sdk {
 
         std::pair<std::string, bool> get_cached_master_blinding_key();
         void set_cached_master_blinding_key(const std::string& master_blinding_key_hex);
+        nlohmann::json load_asset_icons(const std::vector<std::string>& asset_ids);
+        void store_asset_icons(const nlohmann::json& icons);
 
         void encache_signer_xpubs(std::shared_ptr<signer> signer);
 
         nlohmann::json sync_transactions(uint32_t subaccount, unique_pubkeys_and_scripts_t& missing);
+        nlohmann::json sync_transactions(
+            uint32_t subaccount, uint64_t timestamp, unique_pubkeys_and_scripts_t& missing);
+        void prefetch_transactions(uint32_t subaccount, uint64_t timestamp);
+        // Sync several subaccounts at once, with their server calls in flight
+        // together. Returns the results of sync_transactions per subaccount.
+        std::map<uint32_t, nlohmann::json> sync_transactions(
+            const std::vector<uint32_t>& subaccounts, unique_pubkeys_and_scripts_t& missing);
         void store_transactions(uint32_t subaccount, nlohmann::json& txs);
         void postprocess_transactions(nlohmann::json& tx_list);
         nlohmann::json get_transactions(const nlohmann::json& details);
 
     private:
+        // Sync from ahead_timestamp if given, otherwise from the latest cached tx
+        nlohmann::json sync_transactions_impl(
+            uint32_t subaccount, std::optional<uint64_t> ahead_timestamp, unique_pubkeys_and_scripts_t& missing);
+        nlohmann::json fetch_transactions(locker_t& locker, uint32_t subaccount, uint64_t timestamp);
+        void process_synced_transactions(locker_t& locker, uint32_t subaccount, uint64_t timestamp,
+            nlohmann::json& txs, unique_pubkeys_and_scripts_t& missing);
         void reset_cached_session_data(locker_t& locker);
         void delete_reorg_block_txs(locker_t& locker, bool from_latest_cached);
         void reset_all_session_data(bool in_dtor);
@@ -199,15 +225,37 @@ namespace sdk {
         nlohmann::json authenticate_wo(locker_t& locker, const std::string& username, const std::string& password,
             const std::string& user_agent, bool with_blob);
         nlohmann::json on_post_login(locker_t& locker, nlohmann::json& login_data, const std::string& root_bip32_xpub,
-            bool watch_only, bool is_initial_login);
+            bool watch_only, bool is_initial_login, bool is_warm_login = false);
+        void register_subaccount_xpubs_from_signer();
+        // Persist/load the server provided login state for warm logins
+        void save_login_snapshot(locker_t& locker);
+        nlohmann::json load_login_snapshot(locker_t& locker);
+        void warm_login_thread_fn(
+            std::shared_ptr<signer> signer, const std::string& root_bip32_xpub, sign_challenge_fn_t sign_fn);
         void update_fiat_rate(locker_t& locker, const std::string& rate_str);
         void update_spending_limits(locker_t& locker, const nlohmann::json& limits);
         nlohmann::json get_spending_limits(locker_t& locker) const;
         nlohmann::json convert_amount(locker_t& locker, const nlohmann::json& amount_json) const;
         nlohmann::json convert_fiat_cents(locker_t& locker, amount::value_type fiat_cents) const;
         nlohmann::json get_settings(locker_t& locker) const;
-        bool unblind_utxo(locker_t& locker, nlohmann::json& utxo, const std::string& for_txhash,
-            unique_pubkeys_and_scripts_t& missing);
+        // A Liquid UTXO whose rangeproof must be rewound to unblind it
+        struct unblind_request {
+            nlohmann::json* utxo;
+            std::string txhash;
+            uint32_t pt_idx;
+            bool has_address;
+            std::vector<unsigned char> script;
+            std::vector<unsigned char> rangeproof;
+            std::vector<unsigned char> commitment;
+            std::vector<unsigned char> nonce_commitment;
+            std::vector<unsigned char> asset_tag;
+            std::vector<unsigned char> nonce;
+            unblind_t unblinded;
+            bool is_unblinded;
+        };
+        void unblind_utxo(locker_t& locker, nlohmann::json& utxo, const std::string& for_txhash,
+            unique_pubkeys_and_scripts_t& missing, std::vector<unblind_request>& requests);
+        bool unblind_utxos(locker_t& locker, std::vector<unblind_request>& requests);
         std::vector<unsigned char> get_alternate_blinding_nonce(
             locker_t& locker, nlohmann::json& utxo, const std::vector<unsigned char>& nonce_commitment);
         bool cleanup_utxos(session_impl::locker_t& locker, nlohmann::json& utxos, const std::string& for_txhash,
@@ -216,9 +264,12 @@ namespace sdk {
 
         std::unique_ptr<locker_t> get_multi_call_locker(uint32_t category_flags, bool wait_for_lock);
         void on_new_transaction(const std::vector<uint32_t>& subaccounts, nlohmann::json details);
+        void process_tx_notifications();
         void purge_tx_notification(const std::string& txhash_hex);
         void on_new_block(nlohmann::json details, bool is_relogin);
         void on_new_block(locker_t& locker, nlohmann::json details, bool is_relogin);
+        std::vector<uint32_t> get_subaccounts_with_new_txs(
+            const std::vector<std::pair<uint32_t, uint64_t>>& subaccount_timestamps);
         void on_new_tickers(nlohmann::json details);
         void change_settings_pricing_source(locker_t& locker, const std::string& currency, const std::string& exchange);
 
@@ -232,7 +283,22 @@ namespace sdk {
 
         std::pair<std::string, std::string> sign_challenge(locker_t& locker, const std::string& challenge);
 
-        void set_fee_estimates(locker_t& locker, const nlohmann::json& fee_estimates);
+        void set_fee_estimates(locker_t& locker, const nlohmann::json& fee_estimates,
+            std::chrono::system_clock::time_point updated = std::chrono::system_clock::now());
+
+        // Frequently read values that only change on notifications or settings
+        // changes. An immutable copy is published under m_mutex whenever they
+        // change, so that readers do not need to take m_mutex.
+        struct state_snapshot {
+            std::vector<uint32_t> fee_estimates;
+            std::chrono::system_clock::time_point fee_estimates_ts;
+            std::string fiat_currency;
+            std::string fiat_rate;
+            amount::value_type min_fee_rate;
+            uint32_t block_height; // 0 if no block has been seen yet
+        };
+        void publish_state_snapshot(locker_t& locker);
+        std::shared_ptr<const state_snapshot> get_state_snapshot() const;
 
         nlohmann::json refresh_http_data(const std::string& page, const std::string& key, bool refresh);
 
@@ -250,6 +316,17 @@ namespace sdk {
         void download_headers_ctl(locker_t& locker, bool do_start);
         void download_headers_thread_fn();
 
+        // Start/stop background syncing of subaccount transactions
+        void tx_sync_ctl(locker_t& locker, bool do_start);
+        void tx_sync_thread_fn();
+
+        // Start/stop background refilling of the receive address pool
+        void address_pool_ctl(locker_t& locker, bool do_start);
+        void address_pool_refill();
+        // Fetch new receive addresses from the server, pipelining the requests
+        std::vector<nlohmann::json> fetch_receive_addresses(
+            uint32_t subaccount, const std::string& addr_type, size_t count);
+
         const bool m_spv_enabled;
         nlohmann::json m_login_data;
         std::optional<pbkdf2_hmac512_t> m_local_encryption_key;
@@ -270,8 +347,10 @@ namespace sdk {
         uint32_t m_csv_blocks;
         std::vector<uint32_t> m_csv_buckets;
 
-        nlohmann::json m_assets;
-
+        // Subaccounts are modified with both m_mutex and m_subaccounts_mutex
+        // (exclusively) held, and may be read with either one held. This
+        // allows read-only subaccount queries to run without m_mutex.
+        mutable std::shared_mutex m_subaccounts_mutex;
         std::map<uint32_t, nlohmann::json> m_subaccounts; // Includes 0 for main
         std::unique_ptr<ga_pubkeys> m_ga_pubkeys;
         std::unique_ptr<ga_user_pubkeys> m_recovery_pubkeys;
@@ -285,7 +364,11 @@ namespace sdk {
         bool m_watch_only;
         std::vector<std::string> m_tx_notifications;
         std::chrono::system_clock::time_point m_tx_last_notification;
+        // Tx notifications received but not yet processed, with their subaccounts
+        std::vector<std::pair<std::vector<uint32_t>, nlohmann::json>> m_pending_tx_notifications;
         nlohmann::json m_last_block_notification;
+        std::shared_ptr<const state_snapshot> m_state_snapshot; // Only use std::atomic_load/store
+        const std::shared_ptr<network_state> m_network_state; // Shared with other sessions on the network
 
         uint32_t m_multi_call_category;
         std::shared_ptr<nlocktime_t> m_nlocktimes;
@@ -299,6 +382,19 @@ namespace sdk {
         std::shared_ptr<std::thread> m_spv_thread; // Header download thread
         std::atomic_bool m_spv_thread_done; // True when m_spv_thread has exited
         std::atomic_bool m_spv_thread_stop; // True when we want m_spv_thread to stop
+        // Authenticates a warm login in the background
+        std::shared_ptr<std::thread> m_warm_login_thread;
+        // Background tx syncing
+        std::shared_ptr<std::thread> m_tx_sync_thread; // Tx sync thread
+        std::atomic_bool m_tx_sync_thread_done; // True when m_tx_sync_thread has exited
+        std::atomic_bool m_tx_sync_thread_stop; // True when we want m_tx_sync_thread to stop
+        // Receive addresses fetched ahead of being requested, by subaccount
+        std::map<uint32_t, std::deque<nlohmann::json>> m_address_pool;
+        uint64_t m_address_pool_requests; // Incremented when an address is taken from the pool
+        std::atomic_bool m_address_pool_refill_done; // True when no refill is queued or running
+        std::atomic_bool m_address_pool_refill_stop; // True when we want the running refill to stop
+        // Pages of txs being fetched ahead of syncing, by subaccount: (timestamp, page)
+        std::map<uint32_t, std::pair<uint64_t, std::future<nlohmann::json>>> m_tx_prefetch;
         // Txs that are SPV verified but not yet confirmed beyond the reorg limit
         std::set<std::string> m_spv_verified_txs;
     };
@@ -6,1827 +6,1943 @@ namespace ga {
 namespace sdk {
     namespace res {
 
-        const std::string id_1030_minutes{ "id_1030_minutes" }; // ~ 10-30 Minutes
-        const std::string id_12_confirmations{ "id_12_confirmations" }; // 1/2 confirmations
-        const std::string id_12_months_51840_blocks{ "id_12_months_51840_blocks" }; // 12 months (51840 blocks)
-        const std::string id_15_months_65535_blocks{ "id_15_months_65535_blocks" }; // 15 months (65535 blocks)
-        const std::string id_1_double_check_all_of_your{
+        constexpr std::string_view id_1030_minutes{ "id_1030_minutes" }; // ~ 10-30 Minutes
+        constexpr std::string_view id_12_confirmations{ "id_12_confirmations" }; // 1/2 confirmations
+        constexpr std::string_view id_12_months_51840_blocks{ "id_12_months_51840_blocks" }; // 12 months (51840 blocks)
+        constexpr std::string_view id_15_months_65535_blocks{ "id_15_months_65535_blocks" }; // 15 months (65535 blocks)
+        constexpr std::string_view id_1_double_check_all_of_your{
             "id_1_double_check_all_of_your"
         }; // 1. Double check all of your recovery phrase word by word, are all words correct?\n2. The order of words is
            // important! Make sure you\'ve typed the words in the correct order.\n\nIf neither of these tips have helped
            // you, or if you don\'t have a 12, 24 or 27 words recovery phrase please check our help center.
-        const std::string id_1d_2s_ago{ "id_1d_2s_ago" }; // %1$d %2$s ago
-        const std::string id_1d_minutes{ "id_1d_minutes" }; // %1$d minutes
-        const std::string id_1s_blocks_left_2d{ "id_1s_blocks_left_2d" }; // %1$s blocks left %2$d
-        const std::string id_1s_twofactor_setup{ "id_1s_twofactor_setup" }; // %1$s Two-Factor setup
-        const std::string id_2_hours{ "id_2_hours" }; // ~ 2 Hours
-        const std::string id_2fa_dispute_in_progress{ "id_2fa_dispute_in_progress" }; // 2FA Dispute in Progress
-        const std::string id_2fa_expired{ "id_2fa_expired" }; // 2FA Expired
-        const std::string id_2fa_expiry{ "id_2fa_expiry" }; // 2FA Expiry
-        const std::string id_2fa_methods{ "id_2fa_methods" }; // 2FA Methods
-        const std::string id_2fa_reset_in_progress{ "id_2fa_reset_in_progress" }; // 2FA Reset in Progress
-        const std::string id_2fa_threshold{ "id_2fa_threshold" }; // 2FA Threshold
-        const std::string id_2of3_account{ "id_2of3_account" }; // 2of3 Account
-        const std::string id_4_hours{ "id_4_hours" }; // ~ 4 Hours
-        const std::string id_5_seconds_minimum{ "id_5_seconds_minimum" }; // 5 seconds minimum
-        const std::string id_6_months_25920_blocks{ "id_6_months_25920_blocks" }; // 6 months (25920 blocks)
-        const std::string id_a_2of3_account_requires_two_out{
+        constexpr std::string_view id_1d_2s_ago{ "id_1d_2s_ago" }; // %1$d %2$s ago
+        constexpr std::string_view id_1d_minutes{ "id_1d_minutes" }; // %1$d minutes
+        constexpr std::string_view id_1s_blocks_left_2d{ "id_1s_blocks_left_2d" }; // %1$s blocks left %2$d
+        constexpr std::string_view id_1s_twofactor_setup{ "id_1s_twofactor_setup" }; // %1$s Two-Factor setup
+        constexpr std::string_view id_2_hours{ "id_2_hours" }; // ~ 2 Hours
+        constexpr std::string_view id_2fa_dispute_in_progress{
+            "id_2fa_dispute_in_progress"
+        }; // 2FA Dispute in Progress
+        constexpr std::string_view id_2fa_expired{ "id_2fa_expired" }; // 2FA Expired
+        constexpr std::string_view id_2fa_expiry{ "id_2fa_expiry" }; // 2FA Expiry
+        constexpr std::string_view id_2fa_methods{ "id_2fa_methods" }; // 2FA Methods
+        constexpr std::string_view id_2fa_reset_in_progress{ "id_2fa_reset_in_progress" }; // 2FA Reset in Progress
+        constexpr std::string_view id_2fa_threshold{ "id_2fa_threshold" }; // 2FA Threshold
+        constexpr std::string_view id_2of3_account{ "id_2of3_account" }; // 2of3 Account
+        constexpr std::string_view id_4_hours{ "id_4_hours" }; // ~ 4 Hours
+        constexpr std::string_view id_5_seconds_minimum{ "id_5_seconds_minimum" }; // 5 seconds minimum
+        constexpr std::string_view id_6_months_25920_blocks{ "id_6_months_25920_blocks" }; // 6 months (25920 blocks)
+        constexpr std::string_view id_a_2of3_account_requires_two_out{
             "id_a_2of3_account_requires_two_out"
         }; // A 2of3 account requires two out of three signatures to spend coins. The third signature is from a backup
            // key known only to you. This gives you the security benefits of a standard account, while still allowing
            // you to move your coins independently at any point in time.
-        const std::string id_a_new_transaction_has_just{
+        constexpr std::string_view id_a_new_transaction_has_just{
             "id_a_new_transaction_has_just"
         }; // A new transaction has just arrived in your wallet.
-        const std::string id_a_screen_lock_must_be_enabled{
+        constexpr std::string_view id_a_screen_lock_must_be_enabled{
             "id_a_screen_lock_must_be_enabled"
         }; // A screen lock must be enabled from Android settings
-        const std::string id_a_wallet_is_detected_on_this{
+        constexpr std::string_view id_a_wallet_is_detected_on_this{
             "id_a_wallet_is_detected_on_this"
         }; // A wallet is detected on this device:
-        const std::string id_about{ "id_about" }; // About
-        const std::string id_accept{ "id_accept" }; // ACCEPT
-        const std::string id_access{ "id_access" }; // Access
-        const std::string id_account{ "id_account" }; // ACCOUNT
-        const std::string id_account_id{ "id_account_id" }; // Account ID
-        const std::string id_account_name{ "id_account_name" }; // Account Name
-        const std::string id_account_type{ "id_account_type" }; // Account Type
-        const std::string id_accounts_summary{ "id_accounts_summary" }; // Accounts summary
-        const std::string id_action_canceled{ "id_action_canceled" }; // Action canceled
-        const std::string id_add_a_note_only_you_can_see_it{
+        constexpr std::string_view id_about{ "id_about" }; // About
+        constexpr std::string_view id_accept{ "id_accept" }; // ACCEPT
+        constexpr std::string_view id_access{ "id_access" }; // Access
+        constexpr std::string_view id_account{ "id_account" }; // ACCOUNT
+        constexpr std::string_view id_account_id{ "id_account_id" }; // Account ID
+        constexpr std::string_view id_account_name{ "id_account_name" }; // Account Name
+        constexpr std::string_view id_account_type{ "id_account_type" }; // Account Type
+        constexpr std::string_view id_accounts_summary{ "id_accounts_summary" }; // Accounts summary
+        constexpr std::string_view id_action_canceled{ "id_action_canceled" }; // Action canceled
+        constexpr std::string_view id_add_a_note_only_you_can_see_it{
             "id_add_a_note_only_you_can_see_it"
         }; // Add a note (only you can see it).
-        const std::string id_add_a_pgp_public_key_to_receive{
+        constexpr std::string_view id_add_a_pgp_public_key_to_receive{
             "id_add_a_pgp_public_key_to_receive"
         }; // Add a PGP public key to receive encrypted email and keep your privacy
-        const std::string id_add_amount{ "id_add_amount" }; // Add Amount
-        const std::string id_add_amount_optional{ "id_add_amount_optional" }; // Add amount (optional)
-        const std::string id_add_an_amp_wallet{ "id_add_an_amp_wallet" }; // Add an AMP wallet
-        const std::string id_add_another_wallet{ "id_add_another_wallet" }; // Add another wallet
-        const std::string id_add_custom_network_by_qr_code{
+        constexpr std::string_view id_add_amount{ "id_add_amount" }; // Add Amount
+        constexpr std::string_view id_add_amount_optional{ "id_add_amount_optional" }; // Add amount (optional)
+        constexpr std::string_view id_add_an_amp_wallet{ "id_add_an_amp_wallet" }; // Add an AMP wallet
+        constexpr std::string_view id_add_another_wallet{ "id_add_another_wallet" }; // Add another wallet
+        constexpr std::string_view id_add_custom_network_by_qr_code{
             "id_add_custom_network_by_qr_code"
         }; // Add custom network by QR Code
-        const std::string id_add_custom_network_by_url{ "id_add_custom_network_by_url" }; // Add custom network by URL
-        const std::string id_add_new_account{ "id_add_new_account" }; // Add New Account
-        const std::string id_add_wallet{ "id_add_wallet" }; // Add Wallet
-        const std::string id_additional_networks{ "id_additional_networks" }; // Additional Networks
-        const std::string id_additional_security{ "id_additional_security" }; // Additional Security
-        const std::string id_address{ "id_address" }; // Address
-        const std::string id_address_1s{ "id_address_1s" }; // Address: %1$s
-        const std::string id_address_copied_to_clipboard{
+        constexpr std::string_view id_add_custom_network_by_url{
+            "id_add_custom_network_by_url"
+        }; // Add custom network by URL
+        constexpr std::string_view id_add_new_account{ "id_add_new_account" }; // Add New Account
+        constexpr std::string_view id_add_wallet{ "id_add_wallet" }; // Add Wallet
+        constexpr std::string_view id_additional_networks{ "id_additional_networks" }; // Additional Networks
+        constexpr std::string_view id_additional_security{ "id_additional_security" }; // Additional Security
+        constexpr std::string_view id_address{ "id_address" }; // Address
+        constexpr std::string_view id_address_1s{ "id_address_1s" }; // Address: %1$s
+        constexpr std::string_view id_address_copied_to_clipboard{
             "id_address_copied_to_clipboard"
         }; // Address copied to clipboard
-        const std::string id_address_verified{ "id_address_verified" }; // Address verified!
-        const std::string id_address_was_filled_by_a_payment{
+        constexpr std::string_view id_address_verified{ "id_address_verified" }; // Address verified!
+        constexpr std::string_view id_address_was_filled_by_a_payment{
             "id_address_was_filled_by_a_payment"
         }; // Address was filled by a Payment URI
-        const std::string id_addresses{ "id_addresses" }; // Addresses
-        const std::string id_advanced{ "id_advanced" }; // Advanced
-        const std::string id_advanced_network_settings{ "id_advanced_network_settings" }; // Advanced network settings
-        const std::string id_advanced_options_for_your_third{
+        constexpr std::string_view id_addresses{ "id_addresses" }; // Addresses
+        constexpr std::string_view id_advanced{ "id_advanced" }; // Advanced
+        constexpr std::string_view id_advanced_network_settings{
+            "id_advanced_network_settings"
+        }; // Advanced network settings
+        constexpr std::string_view id_advanced_options_for_your_third{
             "id_advanced_options_for_your_third"
         }; // Advanced options for your third recovery key
-        const std::string id_all{ "id_all" }; // All
-        const std::string id_all_assets{ "id_all_assets" }; // All Assets
-        const std::string id_all_of_the_accounts_in_your{
+        constexpr std::string_view id_all{ "id_all" }; // All
+        constexpr std::string_view id_all_assets{ "id_all_assets" }; // All Assets
+        constexpr std::string_view id_all_of_the_accounts_in_your{
             "id_all_of_the_accounts_in_your"
         }; // All of the accounts in your wallet need to be empty before deleting it.
-        const std::string id_all_the_coins_received_or{
+        constexpr std::string_view id_all_the_coins_received_or{
             "id_all_the_coins_received_or"
         }; // All the coins received or created as change.
-        const std::string id_all_wallets{ "id_all_wallets" }; // All wallets
-        const std::string id_allows_you_to_quickly_check{
+        constexpr std::string_view id_all_wallets{ "id_all_wallets" }; // All wallets
+        constexpr std::string_view id_allows_you_to_quickly_check{
             "id_allows_you_to_quickly_check"
         }; // Allows you to quickly check your balance, receive funds or sweep a paper wallet. You can\'t send funds in
            // watch-only mode.
-        const std::string id_always{ "id_always" }; // Always
-        const std::string id_amount{ "id_amount" }; // Amount
-        const std::string id_amount_in_s{ "id_amount_in_s" }; // Amount in %s
-        const std::string id_amp_account{ "id_amp_account" }; // AMP Account
-        const std::string id_amp_accounts_are_only_available{
+        constexpr std::string_view id_always{ "id_always" }; // Always
+        constexpr std::string_view id_amount{ "id_amount" }; // Amount
+        constexpr std::string_view id_amount_in_s{ "id_amount_in_s" }; // Amount in %s
+        constexpr std::string_view id_amp_account{ "id_amp_account" }; // AMP Account
+        constexpr std::string_view id_amp_accounts_are_only_available{
             "id_amp_accounts_are_only_available"
         }; // AMP accounts are only available on Liquid wallets. You may be required to provide your account ID to
            // issuers to receive an AMP Asset.
-        const std::string id_amp_id{ "id_amp_id" }; // AMP ID
-        const std::string id_another_2fa_method_is_already{
+        constexpr std::string_view id_amp_id{ "id_amp_id" }; // AMP ID
+        constexpr std::string_view id_another_2fa_method_is_already{
             "id_another_2fa_method_is_already"
         }; // Another 2FA method is already active. Confirm via 2FA that you authorize this change.
-        const std::string id_app_settings{ "id_app_settings" }; // App Settings
-        const std::string id_are_you_sure_you_want_to_view{
+        constexpr std::string_view id_app_settings{ "id_app_settings" }; // App Settings
+        constexpr std::string_view id_are_you_sure_you_want_to_view{
             "id_are_you_sure_you_want_to_view"
         }; // Are you sure you want to view the transaction using %s?
-        const std::string id_as_easy_as_snapping_a_photo{
+        constexpr std::string_view id_as_easy_as_snapping_a_photo{
             "id_as_easy_as_snapping_a_photo"
         }; // As easy as snapping a photo with your phone. If you have an existing wallet, scan your recovery phrase
            // from settings.
-        const std::string id_asset{ "id_asset" }; // Asset
-        const std::string id_asset_details{ "id_asset_details" }; // Asset Details
-        const std::string id_asset_icons_are_missing_try{
+        constexpr std::string_view id_asset{ "id_asset" }; // Asset
+        constexpr std::string_view id_asset_details{ "id_asset_details" }; // Asset Details
+        constexpr std::string_view id_asset_icons_are_missing_try{
             "id_asset_icons_are_missing_try"
         }; // Asset icons are missing, try reloading them.
-        const std::string id_asset_id{ "id_asset_id" }; // Asset ID
-        const std::string id_asset_name{ "id_asset_name" }; // Asset Name
-        const std::string id_assets{ "id_assets" }; // Assets
-        const std::string id_assets_cannot_be_used_on_bitcoin{
+        constexpr std::string_view id_asset_id{ "id_asset_id" }; // Asset ID
+        constexpr std::string_view id_asset_name{ "id_asset_name" }; // Asset Name
+        constexpr std::string_view id_assets{ "id_assets" }; // Assets
+        constexpr std::string_view id_assets_cannot_be_used_on_bitcoin{
             "id_assets_cannot_be_used_on_bitcoin"
         }; // Assets cannot be used on Bitcoin
-        const std::string id_attempts_remaining_d{ "id_attempts_remaining_d" }; // Attempts remaining: %d
-        const std::string id_authenticate_to_view_the{
+        constexpr std::string_view id_attempts_remaining_d{ "id_attempts_remaining_d" }; // Attempts remaining: %d
+        constexpr std::string_view id_authenticate_to_view_the{
             "id_authenticate_to_view_the"
         }; // Authenticate to view the recovery phrase
-        const std::string id_authentication_error_s{ "id_authentication_error_s" }; // Authentication error: %s
-        const std::string id_authentication_failed{ "id_authentication_failed" }; // Authentication failed
-        const std::string id_authenticator_app{ "id_authenticator_app" }; // Authenticator app
-        const std::string id_authenticator_qr_code{ "id_authenticator_qr_code" }; // Authenticator QR Code
-        const std::string id_authenticator_secret_key{ "id_authenticator_secret_key" }; // Authenticator secret key
-        const std::string id_auto_logout_timeout{ "id_auto_logout_timeout" }; // Auto logout timeout
-        const std::string id_auto_logout_timeout_expired{
+        constexpr std::string_view id_authentication_error_s{ "id_authentication_error_s" }; // Authentication error: %s
+        constexpr std::string_view id_authentication_failed{ "id_authentication_failed" }; // Authentication failed
+        constexpr std::string_view id_authenticator_app{ "id_authenticator_app" }; // Authenticator app
+        constexpr std::string_view id_authenticator_qr_code{ "id_authenticator_qr_code" }; // Authenticator QR Code
+        constexpr std::string_view id_authenticator_secret_key{
+            "id_authenticator_secret_key"
+        }; // Authenticator secret key
+        constexpr std::string_view id_auto_logout_timeout{ "id_auto_logout_timeout" }; // Auto logout timeout
+        constexpr std::string_view id_auto_logout_timeout_expired{
             "id_auto_logout_timeout_expired"
         }; // Auto logout timeout expired
-        const std::string id_autolock_after{ "id_autolock_after" }; // Autolock After
-        const std::string id_back{ "id_back" }; // Back
-        const std::string id_back_up_recovery_phrase{ "id_back_up_recovery_phrase" }; // Back Up Recovery Phrase
-        const std::string id_backup_the_recovery_mnemonic{
+        constexpr std::string_view id_autolock_after{ "id_autolock_after" }; // Autolock After
+        constexpr std::string_view id_back{ "id_back" }; // Back
+        constexpr std::string_view id_back_up_recovery_phrase{
+            "id_back_up_recovery_phrase"
+        }; // Back Up Recovery Phrase
+        constexpr std::string_view id_backup_the_recovery_mnemonic{
             "id_backup_the_recovery_mnemonic"
         }; // Backup the recovery mnemonic and recovery xpub to recover funds from your 2of3 account.
-        const std::string id_backup_your_mnemonic_before{
+        constexpr std::string_view id_backup_your_mnemonic_before{
             "id_backup_your_mnemonic_before"
         }; // Backup your mnemonic before removing the wallet from this device.
-        const std::string id_be_aware_other_apps_can_read_or{
+        constexpr std::string_view id_be_aware_other_apps_can_read_or{
             "id_be_aware_other_apps_can_read_or"
         }; // Be aware, other apps can read or change the clipboard
-        const std::string id_be_sure_your_recovery_phrase_is{
+        constexpr std::string_view id_be_sure_your_recovery_phrase_is{
             "id_be_sure_your_recovery_phrase_is"
         }; // Be sure your recovery phrase is backed up before removing this wallet.
-        const std::string id_biometric_login_is_disabled{
+        constexpr std::string_view id_biometric_login_is_disabled{
             "id_biometric_login_is_disabled"
         }; // Biometric Login is Disabled
-        const std::string id_biometric_login_is_enabled{
+        constexpr std::string_view id_biometric_login_is_enabled{
             "id_biometric_login_is_enabled"
         }; // Biometric Login is Enabled
-        const std::string id_biometrics_authentication{ "id_biometrics_authentication" }; // Biometrics Authentication
-        const std::string id_bip49_accounts_allow_you_to{
+        constexpr std::string_view id_biometrics_authentication{
+            "id_biometrics_authentication"
+        }; // Biometrics Authentication
+        constexpr std::string_view id_bip49_accounts_allow_you_to{
             "id_bip49_accounts_allow_you_to"
         }; // BIP49 accounts allow you to segregate funds, and to receive on wrapped segwit addresses, thus ensuring the
            // highest backwards compatibility when receiving funds from anyone on the network.
-        const std::string id_bip84_accounts_allow_you_to{
+        constexpr std::string_view id_bip84_accounts_allow_you_to{
             "id_bip84_accounts_allow_you_to"
         }; // BIP84 accounts allow you to segregate your funds, and to receive on bech32 native segwit addresses. This
            // account type ensures cheaper transactions when sending funds, but not all services support bech32
            // addresses yet.
-        const std::string id_bitcoin_denomination{ "id_bitcoin_denomination" }; // Bitcoin denomination
-        const std::string id_bitcoin_electrum_server{ "id_bitcoin_electrum_server" }; // Bitcoin Electrum server
-        const std::string id_bitcoin_is_the_worlds_leading{
+        constexpr std::string_view id_bitcoin_denomination{ "id_bitcoin_denomination" }; // Bitcoin denomination
+        constexpr std::string_view id_bitcoin_electrum_server{
+            "id_bitcoin_electrum_server"
+        }; // Bitcoin Electrum server
+        constexpr std::string_view id_bitcoin_is_the_worlds_leading{
             "id_bitcoin_is_the_worlds_leading"
         }; // Bitcoin is the world\'s leading P2P cryptocurrency network. Select to send and receive bitcoin.
-        const std::string id_bitcoin_wallet{ "id_bitcoin_wallet" }; // Bitcoin wallet.
-        const std::string id_bitcoin_wallets{ "id_bitcoin_wallets" }; // Bitcoin wallets
-        const std::string id_block{ "id_block" }; // block
-        const std::string id_block_d{ "id_block_d" }; // Block %d
-        const std::string id_block_height_1d{ "id_block_height_1d" }; // Block height: %1$d
-        const std::string id_blocks{ "id_blocks" }; // blocks
-        const std::string id_blocks_confirmed{ "id_blocks_confirmed" }; // blocks confirmed
-        const std::string id_blockstream_does_not_have{
+        constexpr std::string_view id_bitcoin_wallet{ "id_bitcoin_wallet" }; // Bitcoin wallet.
+        constexpr std::string_view id_bitcoin_wallets{ "id_bitcoin_wallets" }; // Bitcoin wallets
+        constexpr std::string_view id_block{ "id_block" }; // block
+        constexpr std::string_view id_block_d{ "id_block_d" }; // Block %d
+        constexpr std::string_view id_block_height_1d{ "id_block_height_1d" }; // Block height: %1$d
+        constexpr std::string_view id_blocks{ "id_blocks" }; // blocks
+        constexpr std::string_view id_blocks_confirmed{ "id_blocks_confirmed" }; // blocks confirmed
+        constexpr std::string_view id_blockstream_does_not_have{
             "id_blockstream_does_not_have"
         }; // Blockstream does not have access to your wallet backup and will not be able to help you in case you lose
            // it
-        const std::string id_blockstream_green_needs_access{
+        constexpr std::string_view id_blockstream_green_needs_access{
             "id_blockstream_green_needs_access"
         }; // Blockstream Green needs access to Bluetooth in order to connect to hardware wallets. Location data is not
            // used or kept by Blockstream.
-        const std::string id_blockstream_green_supports_both{
+        constexpr std::string_view id_blockstream_green_supports_both{
             "id_blockstream_green_supports_both"
         }; // Blockstream Green supports both Bitcoin and the Liquid Network. Don\'t worry, you can create another
            // wallet for a different network at any time.
-        const std::string id_blockstream_greennsimple_and{
+        constexpr std::string_view id_blockstream_greennsimple_and{
             "id_blockstream_greennsimple_and"
         }; // Blockstream Green:\nSimple and Secure
-        const std::string id_blockstream_store{ "id_blockstream_store" }; // Blockstream Store
-        const std::string id_btchip_is_not_set_up_please_set{
+        constexpr std::string_view id_blockstream_store{ "id_blockstream_store" }; // Blockstream Store
+        constexpr std::string_view id_btchip_is_not_set_up_please_set{
             "id_btchip_is_not_set_up_please_set"
         }; // BTChip is not set up. Please set it up using a desktop client to be able to use it.
-        const std::string id_by_proceeding_to_the_next_steps{
+        constexpr std::string_view id_by_proceeding_to_the_next_steps{
             "id_by_proceeding_to_the_next_steps"
         }; // By proceeding to the next steps you agree to the %s
-        const std::string id_cable{ "id_cable" }; // Cable
-        const std::string id_call{ "id_call" }; // Call
-        const std::string id_camera_problem{ "id_camera_problem" }; // Camera problem
-        const std::string id_cancel{ "id_cancel" }; // Cancel
-        const std::string id_cancel_2fa_reset{ "id_cancel_2fa_reset" }; // Cancel 2FA reset
-        const std::string id_cancel_a_reset_to_unlock_your{
+        constexpr std::string_view id_cable{ "id_cable" }; // Cable
+        constexpr std::string_view id_call{ "id_call" }; // Call
+        constexpr std::string_view id_camera_problem{ "id_camera_problem" }; // Camera problem
+        constexpr std::string_view id_cancel{ "id_cancel" }; // Cancel
+        constexpr std::string_view id_cancel_2fa_reset{ "id_cancel_2fa_reset" }; // Cancel 2FA reset
+        constexpr std::string_view id_cancel_a_reset_to_unlock_your{
             "id_cancel_a_reset_to_unlock_your"
         }; // Cancel a reset to unlock your wallet if you recovered access to an old Two-Factor Authentication method.
-        const std::string id_cancel_twofactor_reset{ "id_cancel_twofactor_reset" }; // Cancel Two-Factor reset
-        const std::string id_cannot_remove_enabled_network{
+        constexpr std::string_view id_cancel_twofactor_reset{ "id_cancel_twofactor_reset" }; // Cancel Two-Factor reset
+        constexpr std::string_view id_cannot_remove_enabled_network{
             "id_cannot_remove_enabled_network"
         }; // Cannot remove enabled network, please disable it first
-        const std::string id_cant_connect_to_this_url{ "id_cant_connect_to_this_url" }; // Can\'t connect to this URL
-        const std::string id_change{ "id_change" }; // Change
-        const std::string id_change_address{ "id_change_address" }; // Change address
-        const std::string id_change_pin{ "id_change_pin" }; // Change PIN
-        const std::string id_changing_reference_exchange{
+        constexpr std::string_view id_cant_connect_to_this_url{
+            "id_cant_connect_to_this_url"
+        }; // Can\'t connect to this URL
+        constexpr std::string_view id_change{ "id_change" }; // Change
+        constexpr std::string_view id_change_address{ "id_change_address" }; // Change address
+        constexpr std::string_view id_change_pin{ "id_change_pin" }; // Change PIN
+        constexpr std::string_view id_changing_reference_exchange{
             "id_changing_reference_exchange"
         }; // Changing reference exchange rate will reset your 2FA threshold to 0. Remember to adjust the 2FA threshold
            // after spending.
-        const std::string id_check_for_updates{ "id_check_for_updates" }; // Check for updates
-        const std::string id_check_for_updates_on_startup{
+        constexpr std::string_view id_check_for_updates{ "id_check_for_updates" }; // Check for updates
+        constexpr std::string_view id_check_for_updates_on_startup{
             "id_check_for_updates_on_startup"
         }; // Check for updates on startup
-        const std::string id_check_your_backup{ "id_check_your_backup" }; // Check your backup
-        const std::string id_choose{ "id_choose" }; // Choose
-        const std::string id_choose_a_name_for_your_new{
+        constexpr std::string_view id_check_your_backup{ "id_check_your_backup" }; // Check your backup
+        constexpr std::string_view id_choose{ "id_choose" }; // Choose
+        constexpr std::string_view id_choose_a_name_for_your_new{
             "id_choose_a_name_for_your_new"
         }; // Choose a name for your new Blockstream Green wallet.
-        const std::string id_choose_a_name_for_your_wallet{
+        constexpr std::string_view id_choose_a_name_for_your_wallet{
             "id_choose_a_name_for_your_wallet"
         }; // Choose a name for your wallet
-        const std::string id_choose_method_to_authorize_the{
+        constexpr std::string_view id_choose_method_to_authorize_the{
             "id_choose_method_to_authorize_the"
         }; // Choose method to authorize the action
-        const std::string id_choose_recovery_phrase_length{
+        constexpr std::string_view id_choose_recovery_phrase_length{
             "id_choose_recovery_phrase_length"
         }; // Choose recovery phrase length
-        const std::string id_choose_security_policy{ "id_choose_security_policy" }; // Choose Security Policy
-        const std::string id_choose_the_electrum_servers_you{
+        constexpr std::string_view id_choose_security_policy{ "id_choose_security_policy" }; // Choose Security Policy
+        constexpr std::string_view id_choose_the_electrum_servers_you{
             "id_choose_the_electrum_servers_you"
         }; // Choose the Electrum servers you trust
-        const std::string id_choose_this_version_to_connect{
+        constexpr std::string_view id_choose_this_version_to_connect{
             "id_choose_this_version_to_connect"
         }; // Choose this version to connect to your Blockstream Jade with both a usb cable and wireless
-        const std::string id_choose_this_version_to_disable{
+        constexpr std::string_view id_choose_this_version_to_disable{
             "id_choose_this_version_to_disable"
         }; // Choose this version to disable all radio connections on your Blockstream Jade. This will make your
            // Blockstream Jade incompatible with iOS devices
-        const std::string id_choose_twofactor_authentication{
+        constexpr std::string_view id_choose_twofactor_authentication{
             "id_choose_twofactor_authentication"
         }; // Choose Two-Factor authentication method
-        const std::string id_choose_watchonly{ "id_choose_watchonly" }; // Choose Watch-Only
-        const std::string id_choose_your_network{ "id_choose_your_network" }; // Choose Your Network
-        const std::string id_clear{ "id_clear" }; // Clear
-        const std::string id_click_to_copy{ "id_click_to_copy" }; // Click to copy
-        const std::string id_click_to_receive_an_email_with{
+        constexpr std::string_view id_choose_watchonly{ "id_choose_watchonly" }; // Choose Watch-Only
+        constexpr std::string_view id_choose_your_network{ "id_choose_your_network" }; // Choose Your Network
+        constexpr std::string_view id_clear{ "id_clear" }; // Clear
+        constexpr std::string_view id_click_to_copy{ "id_click_to_copy" }; // Click to copy
+        constexpr std::string_view id_click_to_receive_an_email_with{
             "id_click_to_receive_an_email_with"
         }; // Click to receive an email with your encrypted recovery data.
-        const std::string id_code{ "id_code" }; // Code
-        const std::string id_coins{ "id_coins" }; // Coins
-        const std::string id_coins_for_which_2fa_protection{
+        constexpr std::string_view id_code{ "id_code" }; // Code
+        constexpr std::string_view id_coins{ "id_coins" }; // Coins
+        constexpr std::string_view id_coins_for_which_2fa_protection{
             "id_coins_for_which_2fa_protection"
         }; // Coins for which 2FA protection is expired.
-        const std::string id_coins_locked{ "id_coins_locked" }; // Coins locked
-        const std::string id_coins_protected_by_the_legacy{
+        constexpr std::string_view id_coins_locked{ "id_coins_locked" }; // Coins locked
+        constexpr std::string_view id_coins_protected_by_the_legacy{
             "id_coins_protected_by_the_legacy"
         }; // Coins protected by the legacy script recoverable with your nlocktimes.zip file.
-        const std::string id_coins_protected_by_the_new{
+        constexpr std::string_view id_coins_protected_by_the_new{
             "id_coins_protected_by_the_new"
         }; // Coins protected by the new script with embedded 2FA expiry through CheckSequenceVerify.
-        const std::string id_coins_unlocked{ "id_coins_unlocked" }; // Coins unlocked
-        const std::string id_coins_whose_asset_and_amount{
+        constexpr std::string_view id_coins_unlocked{ "id_coins_unlocked" }; // Coins unlocked
+        constexpr std::string_view id_coins_whose_asset_and_amount{
             "id_coins_whose_asset_and_amount"
         }; // Coins whose asset and amount are publicly visible.
-        const std::string id_coins_with_a_value_lower_than{
+        constexpr std::string_view id_coins_with_a_value_lower_than{
             "id_coins_with_a_value_lower_than"
         }; // Coins with a value lower than 1092 satoshis that are uneconomic to spend; these coins can be generated by
            // your wallet as change or sent to you by third parties trying to spam or deanonymize your wallet.
-        const std::string id_collapse_sidebar{ "id_collapse_sidebar" }; // Collapse sidebar
-        const std::string id_coming_soon{ "id_coming_soon" }; // Coming Soon!
-        const std::string id_communication_timed_out_make{
+        constexpr std::string_view id_collapse_sidebar{ "id_collapse_sidebar" }; // Collapse sidebar
+        constexpr std::string_view id_coming_soon{ "id_coming_soon" }; // Coming Soon!
+        constexpr std::string_view id_communication_timed_out_make{
             "id_communication_timed_out_make"
         }; // Communication timed out. Make sure the device is powered on and try again.
-        const std::string id_completed{ "id_completed" }; // Completed
-        const std::string id_confidential{ "id_confidential" }; // Confidential
-        const std::string id_confidential_transaction{ "id_confidential_transaction" }; // Confidential Transaction
-        const std::string id_confirm_action{ "id_confirm_action" }; // Confirm action
-        const std::string id_confirm_by_typing_the_wallet{
+        constexpr std::string_view id_completed{ "id_completed" }; // Completed
+        constexpr std::string_view id_confidential{ "id_confidential" }; // Confidential
+        constexpr std::string_view id_confidential_transaction{
+            "id_confidential_transaction"
+        }; // Confidential Transaction
+        constexpr std::string_view id_confirm_action{ "id_confirm_action" }; // Confirm action
+        constexpr std::string_view id_confirm_by_typing_the_wallet{
             "id_confirm_by_typing_the_wallet"
         }; // Confirm by typing the wallet name
-        const std::string id_confirm_code{ "id_confirm_code" }; // Confirm Code
-        const std::string id_confirm_passphrase{ "id_confirm_passphrase" }; // Confirm passphrase
-        const std::string id_confirm_transaction{ "id_confirm_transaction" }; // Confirm transaction
-        const std::string id_confirm_transaction_details_on{
+        constexpr std::string_view id_confirm_code{ "id_confirm_code" }; // Confirm Code
+        constexpr std::string_view id_confirm_passphrase{ "id_confirm_passphrase" }; // Confirm passphrase
+        constexpr std::string_view id_confirm_transaction{ "id_confirm_transaction" }; // Confirm transaction
+        constexpr std::string_view id_confirm_transaction_details_on{
             "id_confirm_transaction_details_on"
         }; // Confirm transaction details on your harware wallet
-        const std::string id_confirm_update_on_your_jade{
+        constexpr std::string_view id_confirm_update_on_your_jade{
             "id_confirm_update_on_your_jade"
         }; // Confirm update on your Jade
-        const std::string id_confirm_via_2fa_that_you{
+        constexpr std::string_view id_confirm_via_2fa_that_you{
             "id_confirm_via_2fa_that_you"
         }; // Confirm via 2FA that you authorize this change.
-        const std::string id_confirmation_in_d_blocks{ "id_confirmation_in_d_blocks" }; // Confirmation in %d blocks
-        const std::string id_confirmations{ "id_confirmations" }; // Confirmations
-        const std::string id_congratulations{ "id_congratulations" }; // Congratulations!
-        const std::string id_connect_hardware_wallet{ "id_connect_hardware_wallet" }; // Connect hardware wallet
-        const std::string id_connect_jade_with_a_usb_cable{
+        constexpr std::string_view id_confirmation_in_d_blocks{
+            "id_confirmation_in_d_blocks"
+        }; // Confirmation in %d blocks
+        constexpr std::string_view id_confirmations{ "id_confirmations" }; // Confirmations
+        constexpr std::string_view id_congratulations{ "id_congratulations" }; // Congratulations!
+        constexpr std::string_view id_connect_hardware_wallet{
+            "id_connect_hardware_wallet"
+        }; // Connect hardware wallet
+        constexpr std::string_view id_connect_jade_with_a_usb_cable{
             "id_connect_jade_with_a_usb_cable"
         }; // Connect Jade with a USB cable to download the latest firmware update
-        const std::string id_connect_through_a_proxy{ "id_connect_through_a_proxy" }; // Connect through a proxy
-        const std::string id_connect_with_tor{ "id_connect_with_tor" }; // Connect with Tor
-        const std::string id_connect_your_jade_to_use_it{
+        constexpr std::string_view id_connect_through_a_proxy{
+            "id_connect_through_a_proxy"
+        }; // Connect through a proxy
+        constexpr std::string_view id_connect_with_tor{ "id_connect_with_tor" }; // Connect with Tor
+        constexpr std::string_view id_connect_your_jade_to_use_it{
             "id_connect_your_jade_to_use_it"
         }; // Connect your Jade to use it with Green
-        const std::string id_connect_your_ledger_to_use_it{
+        constexpr std::string_view id_connect_your_ledger_to_use_it{
             "id_connect_your_ledger_to_use_it"
         }; // Connect your Ledger to use it in Green
-        const std::string id_connected_to_jade{ "id_connected_to_jade" }; // Connected to Jade
-        const std::string id_connecting{ "id_connecting" }; // Connecting…
-        const std::string id_connecting_through_tor{ "id_connecting_through_tor" }; // Connecting through Tor
-        const std::string id_connecting_to_a_trusted_node{
+        constexpr std::string_view id_connected_to_jade{ "id_connected_to_jade" }; // Connected to Jade
+        constexpr std::string_view id_connecting{ "id_connecting" }; // Connecting…
+        constexpr std::string_view id_connecting_through_tor{ "id_connecting_through_tor" }; // Connecting through Tor
+        constexpr std::string_view id_connecting_to_a_trusted_node{
             "id_connecting_to_a_trusted_node"
         }; // Connecting to a trusted node through Tor requires enabling proxy settings in the app before logging in and
            // a Socks5 proxy (Orbot app for Android)
-        const std::string id_connecting_to_peers{ "id_connecting_to_peers" }; // Connecting to peers...
-        const std::string id_connecting_to_tor_onion_nodes{
+        constexpr std::string_view id_connecting_to_peers{ "id_connecting_to_peers" }; // Connecting to peers...
+        constexpr std::string_view id_connecting_to_tor_onion_nodes{
             "id_connecting_to_tor_onion_nodes"
         }; // Connecting to Tor (.onion) nodes allows maximum privacy and security. Press "OK" to continue.
-        const std::string id_connecting_to_your_device{ "id_connecting_to_your_device" }; // Connecting to your device
-        const std::string id_connection{ "id_connection" }; // Connection
-        const std::string id_connection_amp_validation{
+        constexpr std::string_view id_connecting_to_your_device{
+            "id_connecting_to_your_device"
+        }; // Connecting to your device
+        constexpr std::string_view id_connection{ "id_connection" }; // Connection
+        constexpr std::string_view id_connection_amp_validation{
             "id_connection_amp_validation"
         }; // Connection &amp; Validation Settings
-        const std::string id_connection_failed{ "id_connection_failed" }; // Connection failed
-        const std::string id_connection_to_device_failed{
+        constexpr std::string_view id_connection_failed{ "id_connection_failed" }; // Connection failed
+        constexpr std::string_view id_connection_to_device_failed{
             "id_connection_to_device_failed"
         }; // Connection to device failed! Move closer to the device and try again.
-        const std::string id_contact_support_at_s_or_visit_s{
+        constexpr std::string_view id_contact_support_at_s_or_visit_s{
             "id_contact_support_at_s_or_visit_s"
         }; // Contact support at %s or visit %s
-        const std::string id_continue{ "id_continue" }; // Continue
-        const std::string id_continue_with_1s{ "id_continue_with_1s" }; // Continue with %1$s
-        const std::string id_copied_to_clipboard{ "id_copied_to_clipboard" }; // Copied to clipboard
-        const std::string id_copy{ "id_copy" }; // Copy
-        const std::string id_copy_address{ "id_copy_address" }; // Copy address
-        const std::string id_copy_details{ "id_copy_details" }; // Copy details
-        const std::string id_copy_raw_transaction{ "id_copy_raw_transaction" }; // Copy raw transaction
-        const std::string id_copy_to_clipboard{ "id_copy_to_clipboard" }; // Copy To Clipboard
-        const std::string id_copy_transaction_id{ "id_copy_transaction_id" }; // Copy transaction ID
-        const std::string id_copy_unblinded_link{ "id_copy_unblinded_link" }; // Copy unblinded link
-        const std::string id_copy_unblinding_data{ "id_copy_unblinding_data" }; // Copy unblinding data
-        const std::string id_copy_uri{ "id_copy_uri" }; // Copy URI
-        const std::string id_copy_xpub{ "id_copy_xpub" }; // Copy xpub
-        const std::string id_country{ "id_country" }; // Country
-        const std::string id_create{ "id_create" }; // Create
-        const std::string id_create_a_pin_to_access_your{
+        constexpr std::string_view id_continue{ "id_continue" }; // Continue
+        constexpr std::string_view id_continue_with_1s{ "id_continue_with_1s" }; // Continue with %1$s
+        constexpr std::string_view id_copied_to_clipboard{ "id_copied_to_clipboard" }; // Copied to clipboard
+        constexpr std::string_view id_copy{ "id_copy" }; // Copy
+        constexpr std::string_view id_copy_address{ "id_copy_address" }; // Copy address
+        constexpr std::string_view id_copy_details{ "id_copy_details" }; // Copy details
+        constexpr std::string_view id_copy_raw_transaction{ "id_copy_raw_transaction" }; // Copy raw transaction
+        constexpr std::string_view id_copy_to_clipboard{ "id_copy_to_clipboard" }; // Copy To Clipboard
+        constexpr std::string_view id_copy_transaction_id{ "id_copy_transaction_id" }; // Copy transaction ID
+        constexpr std::string_view id_copy_unblinded_link{ "id_copy_unblinded_link" }; // Copy unblinded link
+        constexpr std::string_view id_copy_unblinding_data{ "id_copy_unblinding_data" }; // Copy unblinding data
+        constexpr std::string_view id_copy_uri{ "id_copy_uri" }; // Copy URI
+        constexpr std::string_view id_copy_xpub{ "id_copy_xpub" }; // Copy xpub
+        constexpr std::string_view id_country{ "id_country" }; // Country
+        constexpr std::string_view id_create{ "id_create" }; // Create
+        constexpr std::string_view id_create_a_pin_to_access_your{
             "id_create_a_pin_to_access_your"
         }; // Create a PIN to access your wallet
-        const std::string id_create_a_wallet_for_bitcoin{
+        constexpr std::string_view id_create_a_wallet_for_bitcoin{
             "id_create_a_wallet_for_bitcoin"
         }; // Create a wallet for Bitcoin, Liquid or Testnet
-        const std::string id_create_new_wallet{ "id_create_new_wallet" }; // Create New Wallet
-        const std::string id_create_temporary_wallet{ "id_create_temporary_wallet" }; // Create temporary wallet
-        const std::string id_create_wallet{ "id_create_wallet" }; // Create Wallet
-        const std::string id_creating_wallet{ "id_creating_wallet" }; // Creating wallet…
-        const std::string id_csv{ "id_csv" }; // Csv
-        const std::string id_currency{ "id_currency" }; // Currency
-        const std::string id_current_version{ "id_current_version" }; // Current version
-        const std::string id_custom{ "id_custom" }; // Custom
-        const std::string id_custom_network_added_enable_it{
+        constexpr std::string_view id_create_new_wallet{ "id_create_new_wallet" }; // Create New Wallet
+        constexpr std::string_view id_create_temporary_wallet{
+            "id_create_temporary_wallet"
+        }; // Create temporary wallet
+        constexpr std::string_view id_create_wallet{ "id_create_wallet" }; // Create Wallet
+        constexpr std::string_view id_creating_wallet{ "id_creating_wallet" }; // Creating wallet…
+        constexpr std::string_view id_csv{ "id_csv" }; // Csv
+        constexpr std::string_view id_currency{ "id_currency" }; // Currency
+        constexpr std::string_view id_current_version{ "id_current_version" }; // Current version
+        constexpr std::string_view id_custom{ "id_custom" }; // Custom
+        constexpr std::string_view id_custom_network_added_enable_it{
             "id_custom_network_added_enable_it"
         }; // Custom network added, enable it in the network settings
-        const std::string id_custom_network_not_found{ "id_custom_network_not_found" }; // Custom network not found
-        const std::string id_custom_network_with_this_name{
+        constexpr std::string_view id_custom_network_not_found{
+            "id_custom_network_not_found"
+        }; // Custom network not found
+        constexpr std::string_view id_custom_network_with_this_name{
             "id_custom_network_with_this_name"
         }; // Custom network with this name already present
-        const std::string id_custom_servers_and_validation{
+        constexpr std::string_view id_custom_servers_and_validation{
             "id_custom_servers_and_validation"
         }; // Custom servers and validation
-        const std::string id_customize_2fa_expiration_of{
+        constexpr std::string_view id_customize_2fa_expiration_of{
             "id_customize_2fa_expiration_of"
         }; // Customize 2FA expiration of your coins
-        const std::string id_d6_confirmations{ "id_d6_confirmations" }; // %d/6 confirmations
-        const std::string id_d_asset_in_this_account{ "id_d_asset_in_this_account" }; // %d asset in this account
-        const std::string id_d_assets{ "id_d_assets" }; // %d assets
-        const std::string id_d_assets_in_this_account{ "id_d_assets_in_this_account" }; // %d assets in this account
-        const std::string id_data_directory{ "id_data_directory" }; // Data directory
-        const std::string id_date{ "id_date" }; // Date
-        const std::string id_day{ "id_day" }; // day
-        const std::string id_days{ "id_days" }; // days
-        const std::string id_days_remaining_s{ "id_days_remaining_s" }; // Days remaining: %s
-        const std::string id_default_custom_fee_rate{ "id_default_custom_fee_rate" }; // Default custom fee rate
-        const std::string id_default_transaction_priority{
+        constexpr std::string_view id_d6_confirmations{ "id_d6_confirmations" }; // %d/6 confirmations
+        constexpr std::string_view id_d_asset_in_this_account{
+            "id_d_asset_in_this_account"
+        }; // %d asset in this account
+        constexpr std::string_view id_d_assets{ "id_d_assets" }; // %d assets
+        constexpr std::string_view id_d_assets_in_this_account{
+            "id_d_assets_in_this_account"
+        }; // %d assets in this account
+        constexpr std::string_view id_data_directory{ "id_data_directory" }; // Data directory
+        constexpr std::string_view id_date{ "id_date" }; // Date
+        constexpr std::string_view id_day{ "id_day" }; // day
+        constexpr std::string_view id_days{ "id_days" }; // days
+        constexpr std::string_view id_days_remaining_s{ "id_days_remaining_s" }; // Days remaining: %s
+        constexpr std::string_view id_default_custom_fee_rate{
+            "id_default_custom_fee_rate"
+        }; // Default custom fee rate
+        constexpr std::string_view id_default_transaction_priority{
             "id_default_transaction_priority"
         }; // Default transaction priority
-        const std::string id_delete{ "id_delete" }; // Delete
-        const std::string id_delete_permanently_your_wallet{
+        constexpr std::string_view id_delete{ "id_delete" }; // Delete
+        constexpr std::string_view id_delete_permanently_your_wallet{
             "id_delete_permanently_your_wallet"
         }; // Delete permanently your wallet from the Blockstream Green database. You will never be able to log in to it
            // thereafter.
-        const std::string id_delete_s_twofactor{ "id_delete_s_twofactor" }; // Delete %s Two-Factor
-        const std::string id_delete_wallet{ "id_delete_wallet" }; // Delete Wallet
-        const std::string id_deleting_your_pin_will_remove{
+        constexpr std::string_view id_delete_s_twofactor{ "id_delete_s_twofactor" }; // Delete %s Two-Factor
+        constexpr std::string_view id_delete_wallet{ "id_delete_wallet" }; // Delete Wallet
+        constexpr std::string_view id_deleting_your_pin_will_remove{
             "id_deleting_your_pin_will_remove"
         }; // Deleting your PIN will remove wallet access permanently unless you have your mnemonic available. Press
            // "OK" to continue.
-        const std::string id_denomination{ "id_denomination" }; // Denomination
-        const std::string id_deposit{ "id_deposit" }; // Deposit
-        const std::string id_details{ "id_details" }; // Details
-        const std::string id_device{ "id_device" }; // Device
-        const std::string id_devices{ "id_devices" }; // Devices
-        const std::string id_disable{ "id_disable" }; // Disable
-        const std::string id_disable_pin_access{ "id_disable_pin_access" }; // Disable PIN access
-        const std::string id_disable_pin_access_for_this{
+        constexpr std::string_view id_denomination{ "id_denomination" }; // Denomination
+        constexpr std::string_view id_deposit{ "id_deposit" }; // Deposit
+        constexpr std::string_view id_details{ "id_details" }; // Details
+        constexpr std::string_view id_device{ "id_device" }; // Device
+        constexpr std::string_view id_devices{ "id_devices" }; // Devices
+        constexpr std::string_view id_disable{ "id_disable" }; // Disable
+        constexpr std::string_view id_disable_pin_access{ "id_disable_pin_access" }; // Disable PIN access
+        constexpr std::string_view id_disable_pin_access_for_this{
             "id_disable_pin_access_for_this"
         }; // Disable PIN access for this wallet on all devices
-        const std::string id_disable_s_twofactor{ "id_disable_s_twofactor" }; // Disable %s Two-Factor Authentication
-        const std::string id_disabled{ "id_disabled" }; // Disabled
-        const std::string id_displays_the_progress_of_spv{
+        constexpr std::string_view id_disable_s_twofactor{
+            "id_disable_s_twofactor"
+        }; // Disable %s Two-Factor Authentication
+        constexpr std::string_view id_disabled{ "id_disabled" }; // Disabled
+        constexpr std::string_view id_displays_the_progress_of_spv{
             "id_displays_the_progress_of_spv"
         }; // Displays the progress of SPV synchronization
-        const std::string id_dispute_twofactor_reset{ "id_dispute_twofactor_reset" }; // Dispute Two-Factor reset
-        const std::string id_disputed{ "id_disputed" }; // Disputed
-        const std::string id_distributed_under_the_s_see{
+        constexpr std::string_view id_dispute_twofactor_reset{
+            "id_dispute_twofactor_reset"
+        }; // Dispute Two-Factor reset
+        constexpr std::string_view id_disputed{ "id_disputed" }; // Disputed
+        constexpr std::string_view id_distributed_under_the_s_see{
             "id_distributed_under_the_s_see"
         }; // Distributed under the %s, see LICENSE for more information or visit %s
-        const std::string id_do_you_have_the_backup{ "id_do_you_have_the_backup" }; // Do you have the backup?
-        const std::string id_domain{ "id_domain" }; // Domain
-        const std::string id_done{ "id_done" }; // Done
-        const std::string id_dont_ask_me_again{ "id_dont_ask_me_again" }; // Don\'t ask me again
-        const std::string id_dont_show_this_again{ "id_dont_show_this_again" }; // Don\'t show this again
-        const std::string id_dont_store_your_recovery_phrase{
+        constexpr std::string_view id_do_you_have_the_backup{ "id_do_you_have_the_backup" }; // Do you have the backup?
+        constexpr std::string_view id_domain{ "id_domain" }; // Domain
+        constexpr std::string_view id_done{ "id_done" }; // Done
+        constexpr std::string_view id_dont_ask_me_again{ "id_dont_ask_me_again" }; // Don\'t ask me again
+        constexpr std::string_view id_dont_show_this_again{ "id_dont_show_this_again" }; // Don\'t show this again
+        constexpr std::string_view id_dont_store_your_recovery_phrase{
             "id_dont_store_your_recovery_phrase"
         }; // Don\'t store your recovery phrase on your phone, computer, or any online services.
-        const std::string id_dont_take_screenshots_of_your{
+        constexpr std::string_view id_dont_take_screenshots_of_your{
             "id_dont_take_screenshots_of_your"
         }; // Don\'t take screenshots of your recovery phrase!
-        const std::string id_double_check_spv_with_other{
+        constexpr std::string_view id_double_check_spv_with_other{
             "id_double_check_spv_with_other"
         }; // Double check SPV with other servers
-        const std::string id_double_spend{ "id_double_spend" }; // double spend
-        const std::string id_double_spend_by{ "id_double_spend_by" }; // Double spend by
-        const std::string id_download_finished{ "id_download_finished" }; // Download finished
-        const std::string id_dust{ "id_dust" }; // Dust
-        const std::string id_edit{ "id_edit" }; // Edit
-        const std::string id_email{ "id_email" }; // Email
-        const std::string id_email_address{ "id_email_address" }; // email address
-        const std::string id_empty{ "id_empty" }; // Empty
-        const std::string id_enable{ "id_enable" }; // Enable
-        const std::string id_enable_bluetooth{ "id_enable_bluetooth" }; // Enable Bluetooth
-        const std::string id_enable_custom_networks_debug{
+        constexpr std::string_view id_double_spend{ "id_double_spend" }; // double spend
+        constexpr std::string_view id_double_spend_by{ "id_double_spend_by" }; // Double spend by
+        constexpr std::string_view id_download_finished{ "id_download_finished" }; // Download finished
+        constexpr std::string_view id_dust{ "id_dust" }; // Dust
+        constexpr std::string_view id_edit{ "id_edit" }; // Edit
+        constexpr std::string_view id_email{ "id_email" }; // Email
+        constexpr std::string_view id_email_address{ "id_email_address" }; // email address
+        constexpr std::string_view id_empty{ "id_empty" }; // Empty
+        constexpr std::string_view id_enable{ "id_enable" }; // Enable
+        constexpr std::string_view id_enable_bluetooth{ "id_enable_bluetooth" }; // Enable Bluetooth
+        constexpr std::string_view id_enable_custom_networks_debug{
             "id_enable_custom_networks_debug"
         }; // Enable custom networks debug options
-        const std::string id_enable_email_notifications_to{
+        constexpr std::string_view id_enable_email_notifications_to{
             "id_enable_email_notifications_to"
         }; // Enable email notifications to change nlocktime
-        const std::string id_enable_experimental_features{
+        constexpr std::string_view id_enable_experimental_features{
             "id_enable_experimental_features"
         }; // Enable experimental features
-        const std::string id_enable_face_id{ "id_enable_face_id" }; // Enable Face ID
-        const std::string id_enable_location_services{ "id_enable_location_services" }; // Enable location services
-        const std::string id_enable_or_change_your_pin_to{
+        constexpr std::string_view id_enable_face_id{ "id_enable_face_id" }; // Enable Face ID
+        constexpr std::string_view id_enable_location_services{
+            "id_enable_location_services"
+        }; // Enable location services
+        constexpr std::string_view id_enable_or_change_your_pin_to{
             "id_enable_or_change_your_pin_to"
         }; // Enable or change your PIN to quickly access your wallet
-        const std::string id_enable_spv{ "id_enable_spv" }; // Enable SPV
-        const std::string id_enable_spv_and_modify_spv{
+        constexpr std::string_view id_enable_spv{ "id_enable_spv" }; // Enable SPV
+        constexpr std::string_view id_enable_spv_and_modify_spv{
             "id_enable_spv_and_modify_spv"
         }; // Enable SPV and modify SPV settings
-        const std::string id_enable_testnet{ "id_enable_testnet" }; // Enable testnet
-        const std::string id_enable_touch_id{ "id_enable_touch_id" }; // Enable Touch ID
-        const std::string id_enable_twofactor_authentication{
+        constexpr std::string_view id_enable_testnet{ "id_enable_testnet" }; // Enable testnet
+        constexpr std::string_view id_enable_touch_id{ "id_enable_touch_id" }; // Enable Touch ID
+        constexpr std::string_view id_enable_twofactor_authentication{
             "id_enable_twofactor_authentication"
         }; // Enable Two-Factor Authentication to protect your wallet from unauthorized transactions or changes to
            // critical security settings
-        const std::string id_enabled{ "id_enabled" }; // Enabled
-        const std::string id_enabled_1s{ "id_enabled_1s" }; // Enabled: %1$s
-        const std::string id_encryption_passphrase{ "id_encryption_passphrase" }; // Encryption passphrase
-        const std::string id_enter{ "id_enter" }; // Enter
-        const std::string id_enter_a_pgp_public_key_to_have{
+        constexpr std::string_view id_enabled{ "id_enabled" }; // Enabled
+        constexpr std::string_view id_enabled_1s{ "id_enabled_1s" }; // Enabled: %1$s
+        constexpr std::string_view id_encryption_passphrase{ "id_encryption_passphrase" }; // Encryption passphrase
+        constexpr std::string_view id_enter{ "id_enter" }; // Enter
+        constexpr std::string_view id_enter_a_pgp_public_key_to_have{
             "id_enter_a_pgp_public_key_to_have"
         }; // Enter a PGP public key to have emails encrypted for better privacy.
-        const std::string id_enter_a_private_key_to_sweep{
+        constexpr std::string_view id_enter_a_private_key_to_sweep{
             "id_enter_a_private_key_to_sweep"
         }; // Enter a private key to sweep into this wallet
-        const std::string id_enter_a_valid_onion_or_ip{
+        constexpr std::string_view id_enter_a_valid_onion_or_ip{
             "id_enter_a_valid_onion_or_ip"
         }; // Enter a valid .onion or IP address (.onion preferred)
-        const std::string id_enter_a_valid_username{ "id_enter_a_valid_username" }; // Enter a valid username
-        const std::string id_enter_an_address{ "id_enter_an_address" }; // Enter an address
-        const std::string id_enter_an_address_or_sweep_paper{
+        constexpr std::string_view id_enter_a_valid_username{ "id_enter_a_valid_username" }; // Enter a valid username
+        constexpr std::string_view id_enter_an_address{ "id_enter_an_address" }; // Enter an address
+        constexpr std::string_view id_enter_an_address_or_sweep_paper{
             "id_enter_an_address_or_sweep_paper"
         }; // Enter an address or sweep paper wallet
-        const std::string id_enter_new_email{ "id_enter_new_email" }; // Enter new email
-        const std::string id_enter_phone_number{ "id_enter_phone_number" }; // Enter phone number
-        const std::string id_enter_pin{ "id_enter_pin" }; // Enter PIN
-        const std::string id_enter_pin_on_jade{ "id_enter_pin_on_jade" }; // Enter PIN on Jade
-        const std::string id_enter_the_email_for_which_you{
+        constexpr std::string_view id_enter_new_email{ "id_enter_new_email" }; // Enter new email
+        constexpr std::string_view id_enter_phone_number{ "id_enter_phone_number" }; // Enter phone number
+        constexpr std::string_view id_enter_pin{ "id_enter_pin" }; // Enter PIN
+        constexpr std::string_view id_enter_pin_on_jade{ "id_enter_pin_on_jade" }; // Enter PIN on Jade
+        constexpr std::string_view id_enter_the_email_for_which_you{
             "id_enter_the_email_for_which_you"
         }; // Enter the email for which you want to delete a dispute request
-        const std::string id_enter_the_matching_words{ "id_enter_the_matching_words" }; // Enter The Matching Words
-        const std::string id_enter_the_pin_for_your_hardware{
+        constexpr std::string_view id_enter_the_matching_words{
+            "id_enter_the_matching_words"
+        }; // Enter The Matching Words
+        constexpr std::string_view id_enter_the_pin_for_your_hardware{
             "id_enter_the_pin_for_your_hardware"
         }; // Enter the PIN for your hardware wallet
-        const std::string id_enter_your_12_24_or_27_words{
+        constexpr std::string_view id_enter_your_12_24_or_27_words{
             "id_enter_your_12_24_or_27_words"
         }; // Enter your 12, 24 or 27 words recovery phrase
-        const std::string id_enter_your_24_or_27_words{
+        constexpr std::string_view id_enter_your_24_or_27_words{
             "id_enter_your_24_or_27_words"
         }; // Enter your 24 or 27 words recovery phrase
-        const std::string id_enter_your_27_words_recovery{
+        constexpr std::string_view id_enter_your_27_words_recovery{
             "id_enter_your_27_words_recovery"
         }; // Enter your 27 words recovery phrase
-        const std::string id_enter_your_email_address{ "id_enter_your_email_address" }; // Enter your email address
-        const std::string id_enter_your_pin{ "id_enter_your_pin" }; // Enter Your PIN
-        const std::string id_enter_your_recovery_phrase{
+        constexpr std::string_view id_enter_your_email_address{
+            "id_enter_your_email_address"
+        }; // Enter your email address
+        constexpr std::string_view id_enter_your_pin{ "id_enter_your_pin" }; // Enter Your PIN
+        constexpr std::string_view id_enter_your_recovery_phrase{
             "id_enter_your_recovery_phrase"
         }; // Enter your recovery phrase
-        const std::string id_enter_your_s_wallet_mnemonic{
+        constexpr std::string_view id_enter_your_s_wallet_mnemonic{
             "id_enter_your_s_wallet_mnemonic"
         }; // Enter your %s wallet mnemonic
-        const std::string id_enter_your_wallet_mnemonic{
+        constexpr std::string_view id_enter_your_wallet_mnemonic{
             "id_enter_your_wallet_mnemonic"
         }; // Enter your wallet mnemonic
-        const std::string id_enter_your_xpub{ "id_enter_your_xpub" }; // Enter your xpub
-        const std::string id_enter_your_xpub_to_add_a{
+        constexpr std::string_view id_enter_your_xpub{ "id_enter_your_xpub" }; // Enter your xpub
+        constexpr std::string_view id_enter_your_xpub_to_add_a{
             "id_enter_your_xpub_to_add_a"
         }; // Enter your xPub to add a watch-only wallet where you can receive funds and check your balance without
            // importing your private keys.
-        const std::string id_enter_yournrecovery_phrase{
+        constexpr std::string_view id_enter_yournrecovery_phrase{
             "id_enter_yournrecovery_phrase"
         }; // Enter your\nRecovery Phrase
-        const std::string id_entity{ "id_entity" }; // Entity
-        const std::string id_error{ "id_error" }; // Error
-        const std::string id_error_logging_in_with_hardware{
+        constexpr std::string_view id_entity{ "id_entity" }; // Entity
+        constexpr std::string_view id_error{ "id_error" }; // Error
+        constexpr std::string_view id_error_logging_in_with_hardware{
             "id_error_logging_in_with_hardware"
         }; // Error logging in with Hardware Wallet
-        const std::string id_error_nfc_tag_not_writable{
+        constexpr std::string_view id_error_nfc_tag_not_writable{
             "id_error_nfc_tag_not_writable"
         }; // Error: NFC tag not writable
-        const std::string id_error_nfc_tag_too_small{ "id_error_nfc_tag_too_small" }; // Error: NFC tag too small
-        const std::string id_error_passphrases_do_not_match{
+        constexpr std::string_view id_error_nfc_tag_too_small{
+            "id_error_nfc_tag_too_small"
+        }; // Error: NFC tag too small
+        constexpr std::string_view id_error_passphrases_do_not_match{
             "id_error_passphrases_do_not_match"
         }; // Error: passphrases do not match
-        const std::string id_error_setting_fee_rate{ "id_error_setting_fee_rate" }; // Error setting Fee Rate
-        const std::string id_establishing_session{ "id_establishing_session" }; // Establishing session
-        const std::string id_estimated_blocks_until{
+        constexpr std::string_view id_error_setting_fee_rate{ "id_error_setting_fee_rate" }; // Error setting Fee Rate
+        constexpr std::string_view id_establishing_session{ "id_establishing_session" }; // Establishing session
+        constexpr std::string_view id_estimated_blocks_until{
             "id_estimated_blocks_until"
         }; // Estimated blocks until confirmation: %d
-        const std::string id_example_89014283334011612858333{
+        constexpr std::string_view id_example_89014283334011612858333{
             "id_example_89014283334011612858333"
         }; // Example: 8.90.14.2:8333,40.116.12.85:8333
-        const std::string id_existing_recovery_phrase{ "id_existing_recovery_phrase" }; // Existing recovery phrase
-        const std::string id_expand_sidebar{ "id_expand_sidebar" }; // Expand sidebar
-        const std::string id_explore_your_wallet{ "id_explore_your_wallet" }; // Explore Your Wallet
-        const std::string id_export_transactions_to_csv_file{
+        constexpr std::string_view id_existing_recovery_phrase{
+            "id_existing_recovery_phrase"
+        }; // Existing recovery phrase
+        constexpr std::string_view id_expand_sidebar{ "id_expand_sidebar" }; // Expand sidebar
+        constexpr std::string_view id_explore_your_wallet{ "id_explore_your_wallet" }; // Explore Your Wallet
+        constexpr std::string_view id_export_transactions_to_csv_file{
             "id_export_transactions_to_csv_file"
         }; // Export transactions to CSV file
-        const std::string id_face_id{ "id_face_id" }; // Face ID
-        const std::string id_failed_to_load_asset_icons{
+        constexpr std::string_view id_face_id{ "id_face_id" }; // Face ID
+        constexpr std::string_view id_failed_to_load_asset_icons{
             "id_failed_to_load_asset_icons"
         }; // Failed to load asset icons
-        const std::string id_failed_to_load_asset_registry{
+        constexpr std::string_view id_failed_to_load_asset_registry{
             "id_failed_to_load_asset_registry"
         }; // Failed to Load Asset Registry
-        const std::string id_fast{ "id_fast" }; // Fast
-        const std::string id_faster_more_confidential{
+        constexpr std::string_view id_fast{ "id_fast" }; // Fast
+        constexpr std::string_view id_faster_more_confidential{
             "id_faster_more_confidential"
         }; // Faster, more confidential Bitcoin transactions
-        const std::string id_fee{ "id_fee" }; // Fee
-        const std::string id_fee_amount_size_fee_rate{ "id_fee_amount_size_fee_rate" }; // Fee Amount, Size, Fee Rate
-        const std::string id_fee_rate{ "id_fee_rate" }; // Fee rate
-        const std::string id_fee_rate_is_above_maximum{
+        constexpr std::string_view id_fee{ "id_fee" }; // Fee
+        constexpr std::string_view id_fee_amount_size_fee_rate{
+            "id_fee_amount_size_fee_rate"
+        }; // Fee Amount, Size, Fee Rate
+        constexpr std::string_view id_fee_rate{ "id_fee_rate" }; // Fee rate
+        constexpr std::string_view id_fee_rate_is_above_maximum{
             "id_fee_rate_is_above_maximum"
         }; // Fee rate is above maximum accepted fee rate.
-        const std::string id_fee_rate_is_below_minimum{
+        constexpr std::string_view id_fee_rate_is_below_minimum{
             "id_fee_rate_is_below_minimum"
         }; // Fee rate is below minimum accepted fee rate
-        const std::string id_fee_rate_must_be_at_least_s{
+        constexpr std::string_view id_fee_rate_must_be_at_least_s{
             "id_fee_rate_must_be_at_least_s"
         }; // Fee rate must be at least %s satoshi/vbyte.
-        const std::string id_fee_rate_s{ "id_fee_rate_s" }; // Fee rate: %s
-        const std::string id_fee_s__s{ "id_fee_s__s" }; // Fee: %s / %s
-        const std::string id_fees_are_too_low{ "id_fees_are_too_low" }; // Fees are too low
-        const std::string id_fetching_new_firmware{ "id_fetching_new_firmware" }; // Fetching new firmware
-        const std::string id_filters{ "id_filters" }; // Filters
-        const std::string id_finishing_up{ "id_finishing_up" }; // Finishing Up
-        const std::string id_firmware{ "id_firmware" }; // Firmware
-        const std::string id_firmware_update{ "id_firmware_update" }; // Firmware update
-        const std::string id_firmware_update_completed{ "id_firmware_update_completed" }; // Firmware update completed
-        const std::string id_follow_the_instructions_on_your{
+        constexpr std::string_view id_fee_rate_s{ "id_fee_rate_s" }; // Fee rate: %s
+        constexpr std::string_view id_fee_s__s{ "id_fee_s__s" }; // Fee: %s / %s
+        constexpr std::string_view id_fees_are_too_low{ "id_fees_are_too_low" }; // Fees are too low
+        constexpr std::string_view id_fetching_new_firmware{ "id_fetching_new_firmware" }; // Fetching new firmware
+        constexpr std::string_view id_filters{ "id_filters" }; // Filters
+        constexpr std::string_view id_finishing_up{ "id_finishing_up" }; // Finishing Up
+        constexpr std::string_view id_firmware{ "id_firmware" }; // Firmware
+        constexpr std::string_view id_firmware_update{ "id_firmware_update" }; // Firmware update
+        constexpr std::string_view id_firmware_update_completed{
+            "id_firmware_update_completed"
+        }; // Firmware update completed
+        constexpr std::string_view id_follow_the_instructions_on_your{
             "id_follow_the_instructions_on_your"
         }; // Follow the instructions on your device.
-        const std::string id_for_investors{ "id_for_investors" }; // For investors
-        const std::string id_for_long_term_storage{ "id_for_long_term_storage" }; // For long term storage
-        const std::string id_for_most_users{ "id_for_most_users" }; // For most users
-        const std::string id_from{ "id_from" }; // FROM
-        const std::string id_funds_received_in_this{
+        constexpr std::string_view id_for_investors{ "id_for_investors" }; // For investors
+        constexpr std::string_view id_for_long_term_storage{ "id_for_long_term_storage" }; // For long term storage
+        constexpr std::string_view id_for_most_users{ "id_for_most_users" }; // For most users
+        constexpr std::string_view id_from{ "id_from" }; // FROM
+        constexpr std::string_view id_funds_received_in_this{
             "id_funds_received_in_this"
         }; // Funds received in this transaction are not confidential.
-        const std::string id_general{ "id_general" }; // General
-        const std::string id_generate{ "id_generate" }; // Generate
-        const std::string id_generate_a_new_recovery_phrase{
+        constexpr std::string_view id_general{ "id_general" }; // General
+        constexpr std::string_view id_generate{ "id_generate" }; // Generate
+        constexpr std::string_view id_generate_a_new_recovery_phrase{
             "id_generate_a_new_recovery_phrase"
         }; // Generate a new recovery phrase as your third recovery key.
-        const std::string id_generate_new_address{ "id_generate_new_address" }; // Generate New Address
-        const std::string id_get_code{ "id_get_code" }; // Get Code
-        const std::string id_get_id{ "id_get_id" }; // Get ID
-        const std::string id_get_jade{ "id_get_jade" }; // Get Jade
-        const std::string id_give_bluetooth_permissions{
+        constexpr std::string_view id_generate_new_address{ "id_generate_new_address" }; // Generate New Address
+        constexpr std::string_view id_get_code{ "id_get_code" }; // Get Code
+        constexpr std::string_view id_get_id{ "id_get_id" }; // Get ID
+        constexpr std::string_view id_get_jade{ "id_get_jade" }; // Get Jade
+        constexpr std::string_view id_give_bluetooth_permissions{
             "id_give_bluetooth_permissions"
         }; // Give Bluetooth Permissions
-        const std::string id_go_to_account{ "id_go_to_account" }; // Go to Account
-        const std::string id_go_to_receive_to_get_your{
+        constexpr std::string_view id_go_to_account{ "id_go_to_account" }; // Go to Account
+        constexpr std::string_view id_go_to_receive_to_get_your{
             "id_go_to_receive_to_get_your"
         }; // Go to Receive to get your Account ID.
-        const std::string id_go_to_wallet{ "id_go_to_wallet" }; // Go to Wallet
-        const std::string id_got_it_written_down_great_you{
+        constexpr std::string_view id_go_to_wallet{ "id_go_to_wallet" }; // Go to Wallet
+        constexpr std::string_view id_got_it_written_down_great_you{
             "id_got_it_written_down_great_you"
         }; // Got it written down? Great. You can enter it here. Don’t lose it, it’ll stay the same.
-        const std::string id_green_is_a_noncustodial_wallet{
+        constexpr std::string_view id_green_is_a_noncustodial_wallet{
             "id_green_is_a_noncustodial_wallet"
         }; // Green is a non-custodial wallet
-        const std::string id_green_logo{ "id_green_logo" }; // Green Logo
-        const std::string id_green_mnemonic_qr_code{ "id_green_mnemonic_qr_code" }; // Green Mnemonic QR Code
-        const std::string id_green_only_supports_one_pin_for{
+        constexpr std::string_view id_green_logo{ "id_green_logo" }; // Green Logo
+        constexpr std::string_view id_green_mnemonic_qr_code{ "id_green_mnemonic_qr_code" }; // Green Mnemonic QR Code
+        constexpr std::string_view id_green_only_supports_one_pin_for{
             "id_green_only_supports_one_pin_for"
         }; // Green only supports one PIN for each network. New wallets will require a mnemonic every time you log in.
-        const std::string id_green_only_supports_one_pin_per{
+        constexpr std::string_view id_green_only_supports_one_pin_per{
             "id_green_only_supports_one_pin_per"
         }; // Green only supports one PIN per network. To set a PIN for this wallet, disable the PIN on your original
            // wallet first.
-        const std::string id_green_uses_biometric{
+        constexpr std::string_view id_green_uses_biometric{
             "id_green_uses_biometric"
         }; // Green uses biometric authentication to allow easy access to the wallet
-        const std::string id_green_uses_bluetooth_for{
+        constexpr std::string_view id_green_uses_bluetooth_for{
             "id_green_uses_bluetooth_for"
         }; // Green uses Bluetooth for communication with hardware wallets
-        const std::string id_green_uses_bluetooth_to_connect{
+        constexpr std::string_view id_green_uses_bluetooth_to_connect{
             "id_green_uses_bluetooth_to_connect"
         }; // Green uses Bluetooth to connect to hardware wallets
-        const std::string id_green_uses_multisig_with_one{
+        constexpr std::string_view id_green_uses_multisig_with_one{
             "id_green_uses_multisig_with_one"
         }; // Green uses multisig with one signature generated by your device, and one by Blockstream’s servers. Setting
            // up your Two-Factor Authentication enables an extra layer of security for the server-side signature.
-        const std::string id_hardware_wallet{ "id_hardware_wallet" }; // Hardware wallet
-        const std::string id_hardware_wallet_support_for{
+        constexpr std::string_view id_hardware_wallet{ "id_hardware_wallet" }; // Hardware wallet
+        constexpr std::string_view id_hardware_wallet_support_for{
             "id_hardware_wallet_support_for"
         }; // Hardware wallet support for Confidential Transactions coming soon.
-        const std::string id_hash{ "id_hash" }; // Hash
-        const std::string id_help{ "id_help" }; // Help
-        const std::string id_here{ "id_here" }; // here
-        const std::string id_hex{ "id_hex" }; // HEX
-        const std::string id_hide_assets{ "id_hide_assets" }; // Hide assets
-        const std::string id_high{ "id_high" }; // High
-        const std::string id_hold_your_nfc_tag_close_to_the{
+        constexpr std::string_view id_hash{ "id_hash" }; // Hash
+        constexpr std::string_view id_help{ "id_help" }; // Help
+        constexpr std::string_view id_here{ "id_here" }; // here
+        constexpr std::string_view id_hex{ "id_hex" }; // HEX
+        constexpr std::string_view id_hide_assets{ "id_hide_assets" }; // Hide assets
+        constexpr std::string_view id_high{ "id_high" }; // High
+        constexpr std::string_view id_hold_your_nfc_tag_close_to_the{
             "id_hold_your_nfc_tag_close_to_the"
         }; // Hold your NFC tag close to the device
-        const std::string id_hour{ "id_hour" }; // hour
-        const std::string id_hours{ "id_hours" }; // hours
-        const std::string id_how_to_stop_this_reset{ "id_how_to_stop_this_reset" }; // How to Stop This Reset
-        const std::string id_i_agree_to_the{ "id_i_agree_to_the" }; // I agree to the
-        const std::string id_i_confirm_i_have_read_and{
+        constexpr std::string_view id_hour{ "id_hour" }; // hour
+        constexpr std::string_view id_hours{ "id_hours" }; // hours
+        constexpr std::string_view id_how_to_stop_this_reset{ "id_how_to_stop_this_reset" }; // How to Stop This Reset
+        constexpr std::string_view id_i_agree_to_the{ "id_i_agree_to_the" }; // I agree to the
+        constexpr std::string_view id_i_confirm_i_have_read_and{
             "id_i_confirm_i_have_read_and"
         }; // I confirm I have read and understood the above message
-        const std::string id_i_confirm_i_want_to_delete_this{
+        constexpr std::string_view id_i_confirm_i_want_to_delete_this{
             "id_i_confirm_i_want_to_delete_this"
         }; // I confirm I want to delete this wallet
-        const std::string id_i_confirm_i_want_to_disable_pin{
+        constexpr std::string_view id_i_confirm_i_want_to_disable_pin{
             "id_i_confirm_i_want_to_disable_pin"
         }; // I confirm I want to disable PIN access on all my devices.
-        const std::string id_i_forgot_my_password{ "id_i_forgot_my_password" }; // I forgot my password
-        const std::string id_i_lost_my_2fa{ "id_i_lost_my_2fa" }; // I lost my 2FA
-        const std::string id_i_secured_the_mnemonic_and_i{
+        constexpr std::string_view id_i_forgot_my_password{ "id_i_forgot_my_password" }; // I forgot my password
+        constexpr std::string_view id_i_lost_my_2fa{ "id_i_lost_my_2fa" }; // I lost my 2FA
+        constexpr std::string_view id_i_secured_the_mnemonic_and_i{
             "id_i_secured_the_mnemonic_and_i"
         }; // I secured the mnemonic and I have read the ToS
-        const std::string id_i_typed_all_my_recovery_phrase{
+        constexpr std::string_view id_i_typed_all_my_recovery_phrase{
             "id_i_typed_all_my_recovery_phrase"
         }; // I typed all my recovery phrase why can\'t I continue?
-        const std::string id_i_understand_amounts_could_be{
+        constexpr std::string_view id_i_understand_amounts_could_be{
             "id_i_understand_amounts_could_be"
         }; // I understand amounts could be incorrect
-        const std::string id_id{ "id_id" }; // ID
-        const std::string id_if_you_are_the_rightful_owner{
+        constexpr std::string_view id_id{ "id_id" }; // ID
+        constexpr std::string_view id_if_you_are_the_rightful_owner{
             "id_if_you_are_the_rightful_owner"
         }; // If you are the rightful owner of this wallet, and you still possess one of its active 2FA methods, cancel
            // the reset to be able to spend and empty this wallet.
-        const std::string id_if_you_did_not_request_the{
+        constexpr std::string_view id_if_you_did_not_request_the{
             "id_if_you_did_not_request_the"
         }; // If you did not request the reset, but you cannot cancel the reset process because you can\'t access any
            // existing Two-Factor Authorization methods, dispute this 2FA reset. This will permanently block your
            // wallet, but you can undo this action.
-        const std::string id_if_you_have_access_to_a{
+        constexpr std::string_view id_if_you_have_access_to_a{
             "id_if_you_have_access_to_a"
         }; // If you have access to a Two-Factor method for this wallet, cancel the reset to be able to spend and
            // receive immediately, or wait %d days.
-        const std::string id_if_you_have_some_coins_on_the{
+        constexpr std::string_view id_if_you_have_some_coins_on_the{
             "id_if_you_have_some_coins_on_the"
         }; // If you have some coins on the legacy address type, and you won\'t spend them shortly, you might need to
            // setup an email and receive your recovery transactions to be sure you are always in control of your funds.
-        const std::string id_if_you_initiated_the_2fa_reset{
+        constexpr std::string_view id_if_you_initiated_the_2fa_reset{
             "id_if_you_initiated_the_2fa_reset"
         }; // If you initiated the 2FA reset dispute by mistake, you can undo it and set the wallet back to 2FA reset
            // state.
-        const std::string id_import_a_multisig_shield_wallet{
+        constexpr std::string_view id_import_a_multisig_shield_wallet{
             "id_import_a_multisig_shield_wallet"
         }; // Import a Multisig Shield wallet created on Blockstream Green.
-        const std::string id_import_a_wallet_created_on{
+        constexpr std::string_view id_import_a_wallet_created_on{
             "id_import_a_wallet_created_on"
         }; // Import a wallet created on Blockstream Green.
-        const std::string id_import_a_wallet_created_with{
+        constexpr std::string_view id_import_a_wallet_created_with{
             "id_import_a_wallet_created_with"
         }; // Import a wallet created with other apps. This option only works with singlesig wallets using BIP39
            // mnemonics, and following the BIP44, BIP49, or BIP84 derivations.
-        const std::string id_incoming{ "id_incoming" }; // Incoming
-        const std::string id_inconsistent_data_provided_for{
+        constexpr std::string_view id_incoming{ "id_incoming" }; // Incoming
+        constexpr std::string_view id_inconsistent_data_provided_for{
             "id_inconsistent_data_provided_for"
         }; // Inconsistent data provided for enabling Authenticator 2FA
-        const std::string id_increase_fee{ "id_increase_fee" }; // Increase fee
-        const std::string id_information_not_available{ "id_information_not_available" }; // Information not available.
-        const std::string id_initialized{ "id_initialized" }; // Initialized
-        const std::string id_initializing_tor{ "id_initializing_tor" }; // Initializing Tor…
-        const std::string id_insert_your_email_to_receive{
+        constexpr std::string_view id_increase_fee{ "id_increase_fee" }; // Increase fee
+        constexpr std::string_view id_information_not_available{
+            "id_information_not_available"
+        }; // Information not available.
+        constexpr std::string_view id_initialized{ "id_initialized" }; // Initialized
+        constexpr std::string_view id_initializing_tor{ "id_initializing_tor" }; // Initializing Tor…
+        constexpr std::string_view id_insert_your_email_to_receive{
             "id_insert_your_email_to_receive"
         }; // Insert your email to receive 2FA codes to authorize transfers and other operations.
-        const std::string id_install_version_s{ "id_install_version_s" }; // Install version: %s?
-        const std::string id_insufficient_funds{ "id_insufficient_funds" }; // Insufficient funds
-        const std::string id_insufficient_lbtc_for_fees{
+        constexpr std::string_view id_install_version_s{ "id_install_version_s" }; // Install version: %s?
+        constexpr std::string_view id_insufficient_funds{ "id_insufficient_funds" }; // Insufficient funds
+        constexpr std::string_view id_insufficient_lbtc_for_fees{
             "id_insufficient_lbtc_for_fees"
         }; // Insufficient L-BTC for fees
-        const std::string id_insufficient_lbtc_to_send_a{
+        constexpr std::string_view id_insufficient_lbtc_to_send_a{
             "id_insufficient_lbtc_to_send_a"
         }; // Insufficient L-BTC to send a transaction. In Liquid, L-BTC are needed to pay transaction fees. Generate an
            // address to receive L-BTC
-        const std::string id_invalid_address{ "id_invalid_address" }; // Invalid address
-        const std::string id_invalid_amount{ "id_invalid_amount" }; // Invalid amount
-        const std::string id_invalid_asset_id{ "id_invalid_asset_id" }; // Invalid Asset ID
-        const std::string id_invalid_clipboard_contents{
+        constexpr std::string_view id_invalid_address{ "id_invalid_address" }; // Invalid address
+        constexpr std::string_view id_invalid_amount{ "id_invalid_amount" }; // Invalid amount
+        constexpr std::string_view id_invalid_asset_id{ "id_invalid_asset_id" }; // Invalid Asset ID
+        constexpr std::string_view id_invalid_clipboard_contents{
             "id_invalid_clipboard_contents"
         }; // Invalid clipboard contents
-        const std::string id_invalid_merkle_proof{ "id_invalid_merkle_proof" }; // Invalid Merkle proof
-        const std::string id_invalid_mnemonic{ "id_invalid_mnemonic" }; // Invalid mnemonic
-        const std::string id_invalid_mnemonic_continue{
+        constexpr std::string_view id_invalid_merkle_proof{ "id_invalid_merkle_proof" }; // Invalid Merkle proof
+        constexpr std::string_view id_invalid_mnemonic{ "id_invalid_mnemonic" }; // Invalid mnemonic
+        constexpr std::string_view id_invalid_mnemonic_continue{
             "id_invalid_mnemonic_continue"
         }; // Invalid mnemonic. Continue typing or ask for help
-        const std::string id_invalid_mnemonic_must_be_24_or{
+        constexpr std::string_view id_invalid_mnemonic_must_be_24_or{
             "id_invalid_mnemonic_must_be_24_or"
         }; // Invalid mnemonic (must be 24 or 27 words)
-        const std::string id_invalid_network_configuration{
+        constexpr std::string_view id_invalid_network_configuration{
             "id_invalid_network_configuration"
         }; // Invalid network configuration
-        const std::string id_invalid_payment_request_assetid{
+        constexpr std::string_view id_invalid_payment_request_assetid{
             "id_invalid_payment_request_assetid"
         }; // Invalid payment request, AssetID has to be specified
-        const std::string id_invalid_pgp_key{ "id_invalid_pgp_key" }; // Invalid PGP key
-        const std::string id_invalid_phone_number_format{
+        constexpr std::string_view id_invalid_pgp_key{ "id_invalid_pgp_key" }; // Invalid PGP key
+        constexpr std::string_view id_invalid_phone_number_format{
             "id_invalid_phone_number_format"
         }; // Invalid phone number format
-        const std::string id_invalid_pin{ "id_invalid_pin" }; // Invalid PIN
-        const std::string id_invalid_pin_remaining_attempts{
+        constexpr std::string_view id_invalid_pin{ "id_invalid_pin" }; // Invalid PIN
+        constexpr std::string_view id_invalid_pin_remaining_attempts{
             "id_invalid_pin_remaining_attempts"
         }; // Invalid PIN. Remaining attempts: %1$d.
-        const std::string id_invalid_pin_you_dont_have_any{
+        constexpr std::string_view id_invalid_pin_you_dont_have_any{
             "id_invalid_pin_you_dont_have_any"
         }; // Invalid PIN, you don\'t have any attempts left. Please log in using your mnemonic.
-        const std::string id_invalid_pin_you_have_1d{
+        constexpr std::string_view id_invalid_pin_you_have_1d{
             "id_invalid_pin_you_have_1d"
         }; // Invalid PIN, you have %1$d attempts left
-        const std::string id_invalid_private_key{ "id_invalid_private_key" }; // Invalid private key
-        const std::string id_invalid_recovery_phrase{ "id_invalid_recovery_phrase" }; // Invalid recovery phrase
-        const std::string id_invalid_replacement_fee_rate{
+        constexpr std::string_view id_invalid_private_key{ "id_invalid_private_key" }; // Invalid private key
+        constexpr std::string_view id_invalid_recovery_phrase{
+            "id_invalid_recovery_phrase"
+        }; // Invalid recovery phrase
+        constexpr std::string_view id_invalid_replacement_fee_rate{
             "id_invalid_replacement_fee_rate"
         }; // Invalid replacement fee rate
-        const std::string id_invalid_status_check_that_your{
+        constexpr std::string_view id_invalid_status_check_that_your{
             "id_invalid_status_check_that_your"
         }; // Invalid status. Check that your device is unlocked and try again.
-        const std::string id_invalid_twofactor_code{ "id_invalid_twofactor_code" }; // Invalid Two-Factor code
-        const std::string id_invalid_url{ "id_invalid_url" }; // Invalid URL
-        const std::string id_invalid_xpub{ "id_invalid_xpub" }; // Invalid xpub
-        const std::string id_is_a_noncustodial{ "id_is_a_noncustodial" }; // is a non-custodial
-        const std::string id_issuer{ "id_issuer" }; // Issuer
-        const std::string id_issuer_domain_s{ "id_issuer_domain_s" }; // Issuer Domain: %s
-        const std::string id_it_looks_like_you_have_no{
+        constexpr std::string_view id_invalid_twofactor_code{ "id_invalid_twofactor_code" }; // Invalid Two-Factor code
+        constexpr std::string_view id_invalid_url{ "id_invalid_url" }; // Invalid URL
+        constexpr std::string_view id_invalid_xpub{ "id_invalid_xpub" }; // Invalid xpub
+        constexpr std::string_view id_is_a_noncustodial{ "id_is_a_noncustodial" }; // is a non-custodial
+        constexpr std::string_view id_issuer{ "id_issuer" }; // Issuer
+        constexpr std::string_view id_issuer_domain_s{ "id_issuer_domain_s" }; // Issuer Domain: %s
+        constexpr std::string_view id_it_looks_like_you_have_no{
             "id_it_looks_like_you_have_no"
         }; // It looks like you have no wallets. Click below to add one.
-        const std::string id_jade_unlocked{ "id_jade_unlocked" }; // Jade unlocked
-        const std::string id_just_a_few_more_steps_to_get{
+        constexpr std::string_view id_jade_unlocked{ "id_jade_unlocked" }; // Jade unlocked
+        constexpr std::string_view id_just_a_few_more_steps_to_get{
             "id_just_a_few_more_steps_to_get"
         }; // Just a few more steps to get you set up.
-        const std::string id_label{ "id_label" }; // Label
-        const std::string id_language{ "id_language" }; // Language
-        const std::string id_last_attempt_if_failed_you_will{
+        constexpr std::string_view id_label{ "id_label" }; // Label
+        constexpr std::string_view id_language{ "id_language" }; // Language
+        constexpr std::string_view id_last_attempt_if_failed_you_will{
             "id_last_attempt_if_failed_you_will"
         }; // Last attempt: if failed, you will have to restore your wallet with your recovery phrase.
-        const std::string id_last_ping_1d_ms{ "id_last_ping_1d_ms" }; // Last ping: %1$d ms
-        const std::string id_later{ "id_later" }; // LATER
-        const std::string id_lbtc_has_no_issuer_and_is{
+        constexpr std::string_view id_last_ping_1d_ms{ "id_last_ping_1d_ms" }; // Last ping: %1$d ms
+        constexpr std::string_view id_later{ "id_later" }; // LATER
+        constexpr std::string_view id_lbtc_has_no_issuer_and_is{
             "id_lbtc_has_no_issuer_and_is"
         }; // L-BTC has no issuer and is instead created on the network via a peg-in.
-        const std::string id_learn_more{ "id_learn_more" }; // Learn more
-        const std::string id_learn_more_about_s{ "id_learn_more_about_s" }; // Learn more about %s.
-        const std::string id_ledger_dashboard_detected{
+        constexpr std::string_view id_learn_more{ "id_learn_more" }; // Learn more
+        constexpr std::string_view id_learn_more_about_s{ "id_learn_more_about_s" }; // Learn more about %s.
+        constexpr std::string_view id_ledger_dashboard_detected{
             "id_ledger_dashboard_detected"
         }; // Ledger Dashboard detected, please open the correct app to access.
-        const std::string id_ledger_devices{ "id_ledger_devices" }; // Ledger devices
-        const std::string id_ledger_supports_a_limited_set{
+        constexpr std::string_view id_ledger_devices{ "id_ledger_devices" }; // Ledger devices
+        constexpr std::string_view id_ledger_supports_a_limited_set{
             "id_ledger_supports_a_limited_set"
         }; // Ledger supports a limited set of assets: tap here to check the list.
-        const std::string id_legacy_account{ "id_legacy_account" }; // Legacy Account
-        const std::string id_legacy_script_coins{ "id_legacy_script_coins" }; // Legacy script coins
-        const std::string id_lets_get_you_set_up{ "id_lets_get_you_set_up" }; // Let\'s get you set up.
-        const std::string id_liquid_electrum_server{ "id_liquid_electrum_server" }; // Liquid Electrum server
-        const std::string id_liquid_is_a_sidechainbased{
+        constexpr std::string_view id_legacy_account{ "id_legacy_account" }; // Legacy Account
+        constexpr std::string_view id_legacy_script_coins{ "id_legacy_script_coins" }; // Legacy script coins
+        constexpr std::string_view id_lets_get_you_set_up{ "id_lets_get_you_set_up" }; // Let\'s get you set up.
+        constexpr std::string_view id_liquid_electrum_server{ "id_liquid_electrum_server" }; // Liquid Electrum server
+        constexpr std::string_view id_liquid_is_a_sidechainbased{
             "id_liquid_is_a_sidechainbased"
         }; // Liquid is a sidechain-based settlement network for traders and exchanges, enabling faster, more
            // confidential Bitcoin transactions and the issuance of digital assets.
-        const std::string id_liquid_securities{ "id_liquid_securities" }; // Liquid Securities
-        const std::string id_liquid_testnet_electrum_server{
+        constexpr std::string_view id_liquid_securities{ "id_liquid_securities" }; // Liquid Securities
+        constexpr std::string_view id_liquid_testnet_electrum_server{
             "id_liquid_testnet_electrum_server"
         }; // Liquid Testnet Electrum Server
-        const std::string id_liquid_testnet_wallets{ "id_liquid_testnet_wallets" }; // Liquid testnet wallets
-        const std::string id_liquid_wallets{ "id_liquid_wallets" }; // Liquid wallets
-        const std::string id_loading{ "id_loading" }; // Loading
-        const std::string id_loading_accounts{ "id_loading_accounts" }; // Loading accounts…
-        const std::string id_loading_assets{ "id_loading_assets" }; // Loading assets…
-        const std::string id_loading_transactions{ "id_loading_transactions" }; // Loading transactions…
-        const std::string id_loading_wallet{ "id_loading_wallet" }; // Loading wallet…
-        const std::string id_location_services_are_disabled{
+        constexpr std::string_view id_liquid_testnet_wallets{ "id_liquid_testnet_wallets" }; // Liquid testnet wallets
+        constexpr std::string_view id_liquid_wallets{ "id_liquid_wallets" }; // Liquid wallets
+        constexpr std::string_view id_loading{ "id_loading" }; // Loading
+        constexpr std::string_view id_loading_accounts{ "id_loading_accounts" }; // Loading accounts…
+        constexpr std::string_view id_loading_assets{ "id_loading_assets" }; // Loading assets…
+        constexpr std::string_view id_loading_transactions{ "id_loading_transactions" }; // Loading transactions…
+        constexpr std::string_view id_loading_wallet{ "id_loading_wallet" }; // Loading wallet…
+        constexpr std::string_view id_location_services_are_disabled{
             "id_location_services_are_disabled"
         }; // Location services are disabled, do you want to enable them?
-        const std::string id_lock{ "id_lock" }; // Lock
-        const std::string id_locked{ "id_locked" }; // Locked
-        const std::string id_locked_coins_will_not_be_spent{
+        constexpr std::string_view id_lock{ "id_lock" }; // Lock
+        constexpr std::string_view id_locked{ "id_locked" }; // Locked
+        constexpr std::string_view id_locked_coins_will_not_be_spent{
             "id_locked_coins_will_not_be_spent"
         }; // Locked coins will not be spent nor included in your balance.
-        const std::string id_locking_coins{ "id_locking_coins" }; // Locking coins
-        const std::string id_locking_coins_can_help_protect{
+        constexpr std::string_view id_locking_coins{ "id_locking_coins" }; // Locking coins
+        constexpr std::string_view id_locking_coins_can_help_protect{
             "id_locking_coins_can_help_protect"
         }; // Locking coins can help protect your privacy and save on transaction fees. Locked coins are deducted from
            // your balance and are not used when sending transactions. You can only lock coins labeled as dust and
            // unlock them later at any time.
-        const std::string id_log_file{ "id_log_file" }; // Log file
-        const std::string id_log_in{ "id_log_in" }; // Log In
-        const std::string id_log_in_into_your_s_wallet{ "id_log_in_into_your_s_wallet" }; // Log in into your %s wallet
-        const std::string id_log_in_to_your_multisig_shield{
+        constexpr std::string_view id_log_file{ "id_log_file" }; // Log file
+        constexpr std::string_view id_log_in{ "id_log_in" }; // Log In
+        constexpr std::string_view id_log_in_into_your_s_wallet{
+            "id_log_in_into_your_s_wallet"
+        }; // Log in into your %s wallet
+        constexpr std::string_view id_log_in_to_your_multisig_shield{
             "id_log_in_to_your_multisig_shield"
         }; // Log in to your Multisig Shield watch-only wallet with a username and password. You can create your
            // watch-only credentials after logging into your Multisig Shield wallet.
-        const std::string id_log_in_using_mnemonic{ "id_log_in_using_mnemonic" }; // Log in using mnemonic
-        const std::string id_log_in_via_watchonly_to_receive{
+        constexpr std::string_view id_log_in_using_mnemonic{ "id_log_in_using_mnemonic" }; // Log in using mnemonic
+        constexpr std::string_view id_log_in_via_watchonly_to_receive{
             "id_log_in_via_watchonly_to_receive"
         }; // Log in via Watch-only to receive funds and check balance.
-        const std::string id_log_out{ "id_log_out" }; // Log out
-        const std::string id_logged_in_wallets{ "id_logged_in_wallets" }; // Logged in wallets
-        const std::string id_logging_in{ "id_logging_in" }; // Logging in…
-        const std::string id_login{ "id_login" }; // Login
-        const std::string id_login_failed{ "id_login_failed" }; // Login Failed
-        const std::string id_login_options{ "id_login_options" }; // Login options
-        const std::string id_login_with_biometrics{ "id_login_with_biometrics" }; // Login with Biometrics
-        const std::string id_logout{ "id_logout" }; // Logout
-        const std::string id_logout_and_switch{ "id_logout_and_switch" }; // Logout and Switch
-        const std::string id_look_at_the_device_for_the{
+        constexpr std::string_view id_log_out{ "id_log_out" }; // Log out
+        constexpr std::string_view id_logged_in_wallets{ "id_logged_in_wallets" }; // Logged in wallets
+        constexpr std::string_view id_logging_in{ "id_logging_in" }; // Logging in…
+        constexpr std::string_view id_login{ "id_login" }; // Login
+        constexpr std::string_view id_login_failed{ "id_login_failed" }; // Login Failed
+        constexpr std::string_view id_login_options{ "id_login_options" }; // Login options
+        constexpr std::string_view id_login_with_biometrics{ "id_login_with_biometrics" }; // Login with Biometrics
+        constexpr std::string_view id_logout{ "id_logout" }; // Logout
+        constexpr std::string_view id_logout_and_switch{ "id_logout_and_switch" }; // Logout and Switch
+        constexpr std::string_view id_look_at_the_device_for_the{
             "id_look_at_the_device_for_the"
         }; // Look at the device for the number positions
-        const std::string id_looks_like_you_havent_used_a{
+        constexpr std::string_view id_looks_like_you_havent_used_a{
             "id_looks_like_you_havent_used_a"
         }; // Looks like you haven\'t used a wallet yet. Try creating a new one.
-        const std::string id_low{ "id_low" }; // Low
-        const std::string id_main_account{ "id_main_account" }; // Main Account
-        const std::string id_make_sure_you_have_enabled_otg{
+        constexpr std::string_view id_low{ "id_low" }; // Low
+        constexpr std::string_view id_main_account{ "id_main_account" }; // Main Account
+        constexpr std::string_view id_make_sure_you_have_enabled_otg{
             "id_make_sure_you_have_enabled_otg"
         }; // Make sure you have enabled OTG option in Android Settings
-        const std::string id_make_sure_you_made_a_proper{
+        constexpr std::string_view id_make_sure_you_made_a_proper{
             "id_make_sure_you_made_a_proper"
         }; // Make sure you made a proper backup of your wallet mnemonic.
-        const std::string id_malleated{ "id_malleated" }; // malleated
-        const std::string id_managed_assets{ "id_managed_assets" }; // Managed Assets
-        const std::string id_managed_assets_account{ "id_managed_assets_account" }; // Managed Assets Account
-        const std::string id_managed_assets_accounts_are{
+        constexpr std::string_view id_malleated{ "id_malleated" }; // malleated
+        constexpr std::string_view id_managed_assets{ "id_managed_assets" }; // Managed Assets
+        constexpr std::string_view id_managed_assets_account{ "id_managed_assets_account" }; // Managed Assets Account
+        constexpr std::string_view id_managed_assets_accounts_are{
             "id_managed_assets_accounts_are"
         }; // Managed assets accounts are only available on Liquid wallets. You may be required to provide your account
            // ID to issuers to receive a Managed Asset.
-        const std::string id_medium{ "id_medium" }; // Medium
-        const std::string id_memo{ "id_memo" }; // Memo
-        const std::string id_message{ "id_message" }; // Message
-        const std::string id_message_hash{ "id_message_hash" }; // Message hash
-        const std::string id_migrate_another_wallet{ "id_migrate_another_wallet" }; // Migrate Another Wallet
-        const std::string id_migrating_to_blockstream_green{
+        constexpr std::string_view id_medium{ "id_medium" }; // Medium
+        constexpr std::string_view id_memo{ "id_memo" }; // Memo
+        constexpr std::string_view id_message{ "id_message" }; // Message
+        constexpr std::string_view id_message_hash{ "id_message_hash" }; // Message hash
+        constexpr std::string_view id_migrate_another_wallet{ "id_migrate_another_wallet" }; // Migrate Another Wallet
+        constexpr std::string_view id_migrating_to_blockstream_green{
             "id_migrating_to_blockstream_green"
         }; // Migrating to Blockstream Green? Have an existing Blockstream Green wallet you’d like to import? Let\'s go!
-        const std::string id_minute{ "id_minute" }; // minute
-        const std::string id_minutes{ "id_minutes" }; // minutes
-        const std::string id_mnemonic{ "id_mnemonic" }; // Mnemonic
-        const std::string id_mnemonic_not_available{ "id_mnemonic_not_available" }; // Mnemonic not available
-        const std::string id_model{ "id_model" }; // Model
-        const std::string id_month{ "id_month" }; // month
-        const std::string id_months{ "id_months" }; // months
-        const std::string id_more_info{ "id_more_info" }; // More Info
-        const std::string id_more_options{ "id_more_options" }; // More Options
-        const std::string id_multi_server_validation{ "id_multi_server_validation" }; // Multi Server Validation
-        const std::string id_multiple_assets{ "id_multiple_assets" }; // Multiple Assets
-        const std::string id_multisig_shield{ "id_multisig_shield" }; // Multisig Shield
-        const std::string id_my_notes{ "id_my_notes" }; // MY NOTES
-        const std::string id_name{ "id_name" }; // Name
-        const std::string id_need_help{ "id_need_help" }; // Need help?
-        const std::string id_network{ "id_network" }; // Network
-        const std::string id_network_configuration{ "id_network_configuration" }; // Network Configuration
-        const std::string id_network_fee{ "id_network_fee" }; // NETWORK FEE
-        const std::string id_network_monitor{ "id_network_monitor" }; // Network Monitor
-        const std::string id_new_account_created{ "id_new_account_created" }; // New account created
-        const std::string id_new_accounts_functionality{
+        constexpr std::string_view id_minute{ "id_minute" }; // minute
+        constexpr std::string_view id_minutes{ "id_minutes" }; // minutes
+        constexpr std::string_view id_mnemonic{ "id_mnemonic" }; // Mnemonic
+        constexpr std::string_view id_mnemonic_not_available{ "id_mnemonic_not_available" }; // Mnemonic not available
+        constexpr std::string_view id_model{ "id_model" }; // Model
+        constexpr std::string_view id_month{ "id_month" }; // month
+        constexpr std::string_view id_months{ "id_months" }; // months
+        constexpr std::string_view id_more_info{ "id_more_info" }; // More Info
+        constexpr std::string_view id_more_options{ "id_more_options" }; // More Options
+        constexpr std::string_view id_multi_server_validation{
+            "id_multi_server_validation"
+        }; // Multi Server Validation
+        constexpr std::string_view id_multiple_assets{ "id_multiple_assets" }; // Multiple Assets
+        constexpr std::string_view id_multisig_shield{ "id_multisig_shield" }; // Multisig Shield
+        constexpr std::string_view id_my_notes{ "id_my_notes" }; // MY NOTES
+        constexpr std::string_view id_name{ "id_name" }; // Name
+        constexpr std::string_view id_need_help{ "id_need_help" }; // Need help?
+        constexpr std::string_view id_network{ "id_network" }; // Network
+        constexpr std::string_view id_network_configuration{ "id_network_configuration" }; // Network Configuration
+        constexpr std::string_view id_network_fee{ "id_network_fee" }; // NETWORK FEE
+        constexpr std::string_view id_network_monitor{ "id_network_monitor" }; // Network Monitor
+        constexpr std::string_view id_new_account_created{ "id_new_account_created" }; // New account created
+        constexpr std::string_view id_new_accounts_functionality{
             "id_new_accounts_functionality"
         }; // New accounts functionality coming soon!
-        const std::string id_new_fee{ "id_new_fee" }; // New fee
-        const std::string id_new_incoming_transaction_in{
+        constexpr std::string_view id_new_fee{ "id_new_fee" }; // New fee
+        constexpr std::string_view id_new_incoming_transaction_in{
             "id_new_incoming_transaction_in"
         }; // New incoming transaction in account %s (%s).
-        const std::string id_new_jade_firmware_available{
+        constexpr std::string_view id_new_jade_firmware_available{
             "id_new_jade_firmware_available"
         }; // New Jade Firmware Available
-        const std::string id_new_jade_firmware_required{
+        constexpr std::string_view id_new_jade_firmware_required{
             "id_new_jade_firmware_required"
         }; // New Jade Firmware Required
-        const std::string id_new_outgoing_transaction_from{
+        constexpr std::string_view id_new_outgoing_transaction_from{
             "id_new_outgoing_transaction_from"
         }; // New outgoing transaction from account %s (%s).
-        const std::string id_new_recovery_phrase{ "id_new_recovery_phrase" }; // New recovery phrase
-        const std::string id_new_s_transaction_of_s_in{
+        constexpr std::string_view id_new_recovery_phrase{ "id_new_recovery_phrase" }; // New recovery phrase
+        constexpr std::string_view id_new_s_transaction_of_s_in{
             "id_new_s_transaction_of_s_in"
         }; // New %s transaction of %s in account %s.
-        const std::string id_new_transaction{ "id_new_transaction" }; // New transaction
-        const std::string id_new_transaction_involving{
+        constexpr std::string_view id_new_transaction{ "id_new_transaction" }; // New transaction
+        constexpr std::string_view id_new_transaction_involving{
             "id_new_transaction_involving"
         }; // New transaction involving accounts %s.
-        const std::string id_new_version{ "id_new_version" }; // New version
-        const std::string id_new_wallet{ "id_new_wallet" }; // New Wallet
-        const std::string id_next{ "id_next" }; // Next
-        const std::string id_nfc_logo{ "id_nfc_logo" }; // NFC Logo
-        const std::string id_nfc_tags_written{ "id_nfc_tags_written" }; // NFC TAGs Written:
-        const std::string id_no_amount_specified{ "id_no_amount_specified" }; // No amount specified
-        const std::string id_no_asset_in_this_account{ "id_no_asset_in_this_account" }; // No asset in this account
-        const std::string id_no_attempts_remaining{ "id_no_attempts_remaining" }; // No attempts remaining
-        const std::string id_no_device_connected{ "id_no_device_connected" }; // No device connected
-        const std::string id_no_more_assets{ "id_no_more_assets" }; // No more assets.
-        const std::string id_no_peers_connected{ "id_no_peers_connected" }; // No Peers Connected
-        const std::string id_no_pin_provided_exiting{ "id_no_pin_provided_exiting" }; // No PIN provided, exiting.
-        const std::string id_no_recipients{ "id_no_recipients" }; // No recipients
-        const std::string id_no_registered_name_for_this{
+        constexpr std::string_view id_new_version{ "id_new_version" }; // New version
+        constexpr std::string_view id_new_wallet{ "id_new_wallet" }; // New Wallet
+        constexpr std::string_view id_next{ "id_next" }; // Next
+        constexpr std::string_view id_nfc_logo{ "id_nfc_logo" }; // NFC Logo
+        constexpr std::string_view id_nfc_tags_written{ "id_nfc_tags_written" }; // NFC TAGs Written:
+        constexpr std::string_view id_no_amount_specified{ "id_no_amount_specified" }; // No amount specified
+        constexpr std::string_view id_no_asset_in_this_account{
+            "id_no_asset_in_this_account"
+        }; // No asset in this account
+        constexpr std::string_view id_no_attempts_remaining{ "id_no_attempts_remaining" }; // No attempts remaining
+        constexpr std::string_view id_no_device_connected{ "id_no_device_connected" }; // No device connected
+        constexpr std::string_view id_no_more_assets{ "id_no_more_assets" }; // No more assets.
+        constexpr std::string_view id_no_peers_connected{ "id_no_peers_connected" }; // No Peers Connected
+        constexpr std::string_view id_no_pin_provided_exiting{
+            "id_no_pin_provided_exiting"
+        }; // No PIN provided, exiting.
+        constexpr std::string_view id_no_recipients{ "id_no_recipients" }; // No recipients
+        constexpr std::string_view id_no_registered_name_for_this{
             "id_no_registered_name_for_this"
         }; // No registered name for this asset.
-        const std::string id_no_registered_ticker_for_this{
+        constexpr std::string_view id_no_registered_ticker_for_this{
             "id_no_registered_ticker_for_this"
         }; // No registered ticker for this asset.
-        const std::string id_no_utxos_found{ "id_no_utxos_found" }; // No UTXOs found
-        const std::string id_non_confidential{ "id_non_confidential" }; // Non Confidential
-        const std::string id_non_confidential_transaction{
+        constexpr std::string_view id_no_utxos_found{ "id_no_utxos_found" }; // No UTXOs found
+        constexpr std::string_view id_non_confidential{ "id_non_confidential" }; // Non Confidential
+        constexpr std::string_view id_non_confidential_transaction{
             "id_non_confidential_transaction"
         }; // Non Confidential Transaction
-        const std::string id_nonconfidential_addresses_not{
+        constexpr std::string_view id_nonconfidential_addresses_not{
             "id_nonconfidential_addresses_not"
         }; // Non-confidential addresses not supported
-        const std::string id_noradio_firmware{ "id_noradio_firmware" }; // No-radio firmware
-        const std::string id_normal{ "id_normal" }; // Normal
-        const std::string id_not_a_valid_email_address{ "id_not_a_valid_email_address" }; // Not a valid email address
-        const std::string id_not_a_valid_phone_number{ "id_not_a_valid_phone_number" }; // Not a valid phone number
-        const std::string id_not_a_valid_word{ "id_not_a_valid_word" }; // Not a valid word
-        const std::string id_not_confidential{ "id_not_confidential" }; // Not confidential
-        const std::string id_not_connected_connecting_in_ds_{
+        constexpr std::string_view id_noradio_firmware{ "id_noradio_firmware" }; // No-radio firmware
+        constexpr std::string_view id_normal{ "id_normal" }; // Normal
+        constexpr std::string_view id_not_a_valid_email_address{
+            "id_not_a_valid_email_address"
+        }; // Not a valid email address
+        constexpr std::string_view id_not_a_valid_phone_number{
+            "id_not_a_valid_phone_number"
+        }; // Not a valid phone number
+        constexpr std::string_view id_not_a_valid_word{ "id_not_a_valid_word" }; // Not a valid word
+        constexpr std::string_view id_not_confidential{ "id_not_confidential" }; // Not confidential
+        constexpr std::string_view id_not_connected_connecting_in_ds_{
             "id_not_connected_connecting_in_ds_"
         }; // Not connected. Connecting in %ds …
-        const std::string id_not_initialized{ "id_not_initialized" }; // Not initialized
-        const std::string id_not_on_longest_chain{ "id_not_on_longest_chain" }; // Not on longest chain
-        const std::string id_notifications{ "id_notifications" }; // Notifications
-        const std::string id_now{ "id_now" }; // Now
-        const std::string id_of_24{ "id_of_24" }; // of 24
-        const std::string id_of_s{ "id_of_s" }; // of %s
-        const std::string id_ok{ "id_ok" }; // Ok
-        const std::string id_on_average{ "id_on_average" }; // on average
-        const std::string id_once_selected_this_spending{
+        constexpr std::string_view id_not_initialized{ "id_not_initialized" }; // Not initialized
+        constexpr std::string_view id_not_on_longest_chain{ "id_not_on_longest_chain" }; // Not on longest chain
+        constexpr std::string_view id_notifications{ "id_notifications" }; // Notifications
+        constexpr std::string_view id_now{ "id_now" }; // Now
+        constexpr std::string_view id_of_24{ "id_of_24" }; // of 24
+        constexpr std::string_view id_of_s{ "id_of_s" }; // of %s
+        constexpr std::string_view id_ok{ "id_ok" }; // Ok
+        constexpr std::string_view id_on_average{ "id_on_average" }; // on average
+        constexpr std::string_view id_once_selected_this_spending{
             "id_once_selected_this_spending"
         }; // Once selected, this spending policy cannot be changed. For tips on what type of security is best for you,
            // visit our Help Center.
-        const std::string id_one_attempt_remaining{ "id_one_attempt_remaining" }; // One attempt remaining
-        const std::string id_one_network_must_be_selected{
+        constexpr std::string_view id_one_attempt_remaining{ "id_one_attempt_remaining" }; // One attempt remaining
+        constexpr std::string_view id_one_network_must_be_selected{
             "id_one_network_must_be_selected"
         }; // One network must be selected. Selecting Bitcoin by default
-        const std::string id_onion_addresses_require_tor{
+        constexpr std::string_view id_onion_addresses_require_tor{
             "id_onion_addresses_require_tor"
         }; // Onion addresses require Tor connectivity. Enable it in the network settings.
-        const std::string id_only_connect_to_trusted_nodes{
+        constexpr std::string_view id_only_connect_to_trusted_nodes{
             "id_only_connect_to_trusted_nodes"
         }; // Only connect to trusted node(s) for SPV
-        const std::string id_only_this_time{ "id_only_this_time" }; // Only this time
-        const std::string id_open{ "id_open" }; // Open
-        const std::string id_operation_failure{ "id_operation_failure" }; // Operation failure
-        const std::string id_optimal_if_you_rarely_spend{
+        constexpr std::string_view id_only_this_time{ "id_only_this_time" }; // Only this time
+        constexpr std::string_view id_open{ "id_open" }; // Open
+        constexpr std::string_view id_operation_failure{ "id_operation_failure" }; // Operation failure
+        constexpr std::string_view id_optimal_if_you_rarely_spend{
             "id_optimal_if_you_rarely_spend"
         }; // Optimal if you rarely spend coins. Wallet coins will require two-factor reactivation every 455 days to
            // remain protected by two-factor authentication
-        const std::string id_optimal_if_you_spend_coins{
+        constexpr std::string_view id_optimal_if_you_spend_coins{
             "id_optimal_if_you_spend_coins"
         }; // Optimal if you spend coins every 6 months. Wallet coins will require two-factor reactivation every 6
            // months to remain protected by two-factor authentication.
-        const std::string id_optional{ "id_optional" }; // Optional
-        const std::string id_optional_memo{ "id_optional_memo" }; // Optional memo
-        const std::string id_optional_password{ "id_optional_password" }; // Optional password
-        const std::string id_or{ "id_or" }; // OR
-        const std::string id_our_support_page{ "id_our_support_page" }; // our support page
-        const std::string id_outdated_hardware_wallet{
+        constexpr std::string_view id_optional{ "id_optional" }; // Optional
+        constexpr std::string_view id_optional_memo{ "id_optional_memo" }; // Optional memo
+        constexpr std::string_view id_optional_password{ "id_optional_password" }; // Optional password
+        constexpr std::string_view id_or{ "id_or" }; // OR
+        constexpr std::string_view id_our_support_page{ "id_our_support_page" }; // our support page
+        constexpr std::string_view id_outdated_hardware_wallet{
             "id_outdated_hardware_wallet"
         }; // Outdated hardware wallet firmware. Please upgrade to the latest firmware from your desktop.
-        const std::string id_outgoing{ "id_outgoing" }; // Outgoing
-        const std::string id_overview{ "id_overview" }; // Overview
-        const std::string id_p2wsh{ "id_p2wsh" }; // P2wsh
-        const std::string id_password{ "id_password" }; // Password
-        const std::string id_password_protected{ "id_password_protected" }; // Password protected
-        const std::string id_paste{ "id_paste" }; // Paste
-        const std::string id_path_used_for_signing{ "id_path_used_for_signing" }; // Path used for signing
-        const std::string id_pending_confirmation{ "id_pending_confirmation" }; // Pending confirmation
-        const std::string id_permanently_block_this_wallet{
+        constexpr std::string_view id_outgoing{ "id_outgoing" }; // Outgoing
+        constexpr std::string_view id_overview{ "id_overview" }; // Overview
+        constexpr std::string_view id_p2wsh{ "id_p2wsh" }; // P2wsh
+        constexpr std::string_view id_password{ "id_password" }; // Password
+        constexpr std::string_view id_password_protected{ "id_password_protected" }; // Password protected
+        constexpr std::string_view id_paste{ "id_paste" }; // Paste
+        constexpr std::string_view id_path_used_for_signing{ "id_path_used_for_signing" }; // Path used for signing
+        constexpr std::string_view id_pending_confirmation{ "id_pending_confirmation" }; // Pending confirmation
+        constexpr std::string_view id_permanently_block_this_wallet{
             "id_permanently_block_this_wallet"
         }; // Permanently Block This Wallet
-        const std::string id_personal_electrum_server{ "id_personal_electrum_server" }; // Personal Electrum Server
-        const std::string id_pgp_key{ "id_pgp_key" }; // PGP key
-        const std::string id_phone_call{ "id_phone_call" }; // Phone call
-        const std::string id_phone_number{ "id_phone_number" }; // phone number
-        const std::string id_pin{ "id_pin" }; // PIN
-        const std::string id_pin_access_disabled{ "id_pin_access_disabled" }; // PIN access disabled
-        const std::string id_pin_has_to_be_between_4_and_15{
+        constexpr std::string_view id_personal_electrum_server{
+            "id_personal_electrum_server"
+        }; // Personal Electrum Server
+        constexpr std::string_view id_pgp_key{ "id_pgp_key" }; // PGP key
+        constexpr std::string_view id_phone_call{ "id_phone_call" }; // Phone call
+        constexpr std::string_view id_phone_number{ "id_phone_number" }; // phone number
+        constexpr std::string_view id_pin{ "id_pin" }; // PIN
+        constexpr std::string_view id_pin_access_disabled{ "id_pin_access_disabled" }; // PIN access disabled
+        constexpr std::string_view id_pin_has_to_be_between_4_and_15{
             "id_pin_has_to_be_between_4_and_15"
         }; // PIN has to be between 4 and 15 digits
-        const std::string id_pins_do_not_match_please_try{
+        constexpr std::string_view id_pins_do_not_match_please_try{
             "id_pins_do_not_match_please_try"
         }; // PINs do not match, please try again.
-        const std::string id_please_activate_at_least_one{
+        constexpr std::string_view id_please_activate_at_least_one{
             "id_please_activate_at_least_one"
         }; // Please activate at least one fingerprint in Android settings in order to use biometric login
-        const std::string id_please_contribute_if_you_find{
+        constexpr std::string_view id_please_contribute_if_you_find{
             "id_please_contribute_if_you_find"
         }; // Please contribute if you find Blockstream Green useful
-        const std::string id_please_disable_biometric{
+        constexpr std::string_view id_please_disable_biometric{
             "id_please_disable_biometric"
         }; // Please disable biometric authentication before deleting PIN
-        const std::string id_please_disconnect_your_ledger{
+        constexpr std::string_view id_please_disconnect_your_ledger{
             "id_please_disconnect_your_ledger"
         }; // Please disconnect your Ledger Nano X, power it off by long-pressing both buttons, then reconnect it and
            // enter its PIN
-        const std::string id_please_enable_another{
+        constexpr std::string_view id_please_enable_another{
             "id_please_enable_another"
         }; // Please enable another authentication method to avoid losing access to your funds.
-        const std::string id_please_enable_camera{
+        constexpr std::string_view id_please_enable_camera{
             "id_please_enable_camera"
         }; // Please enable camera permissions to use the camera.
-        const std::string id_please_enable_pin{
+        constexpr std::string_view id_please_enable_pin{
             "id_please_enable_pin"
         }; // Please enable PIN authentication before adding or removing biometric authentication
-        const std::string id_please_enter_the_passphrase_for{
+        constexpr std::string_view id_please_enter_the_passphrase_for{
             "id_please_enter_the_passphrase_for"
         }; // Please enter the passphrase for your hardware wallet.
-        const std::string id_please_follow_the_instructions{
+        constexpr std::string_view id_please_follow_the_instructions{
             "id_please_follow_the_instructions"
         }; // Please follow the instructions on your hardware wallet
-        const std::string id_please_hold_on_while_your{
+        constexpr std::string_view id_please_hold_on_while_your{
             "id_please_hold_on_while_your"
         }; // Please hold on while your address is being generated
-        const std::string id_please_provide_your_1s{ "id_please_provide_your_1s" }; // Please provide your %1$s.
-        const std::string id_please_provide_your_1s_code{
+        constexpr std::string_view id_please_provide_your_1s{
+            "id_please_provide_your_1s"
+        }; // Please provide your %1$s.
+        constexpr std::string_view id_please_provide_your_1s_code{
             "id_please_provide_your_1s_code"
         }; // Please provide your %1$s code.
-        const std::string id_please_provide_your_passphrase{
+        constexpr std::string_view id_please_provide_your_passphrase{
             "id_please_provide_your_passphrase"
         }; // Please provide your passphrase:
-        const std::string id_please_reconnect_your_hardware{
+        constexpr std::string_view id_please_reconnect_your_hardware{
             "id_please_reconnect_your_hardware"
         }; // Please re-connect your hardware wallet before trying again.
-        const std::string id_please_secure_your_mnemonic_and{
+        constexpr std::string_view id_please_secure_your_mnemonic_and{
             "id_please_secure_your_mnemonic_and"
         }; // Please secure your mnemonic and confirm you agree to the Terms of Service
-        const std::string id_please_select_the_checkbox{
+        constexpr std::string_view id_please_select_the_checkbox{
             "id_please_select_the_checkbox"
         }; // Please select the checkbox
-        const std::string id_please_set_and_enable_socks5{
+        constexpr std::string_view id_please_set_and_enable_socks5{
             "id_please_set_and_enable_socks5"
         }; // Please set and enable SOCKS5 proxy and port to use Tor
-        const std::string id_please_tap_card{ "id_please_tap_card" }; // Please tap card
-        const std::string id_please_verify_that_the_address{
+        constexpr std::string_view id_please_tap_card{ "id_please_tap_card" }; // Please tap card
+        constexpr std::string_view id_please_verify_that_the_address{
             "id_please_verify_that_the_address"
         }; // Please verify that the address shown on your hardware wallet matches the one on your phone.
-        const std::string id_please_wait_until_your_ledger{
+        constexpr std::string_view id_please_wait_until_your_ledger{
             "id_please_wait_until_your_ledger"
         }; // Please wait until your Ledger displays the address to validate it. This could take up to 20 seconds.
-        const std::string id_precision{ "id_precision" }; // Precision
-        const std::string id_previous_fee{ "id_previous_fee" }; // Previous fee
-        const std::string id_privacy_policy{ "id_privacy_policy" }; // Privacy Policy
-        const std::string id_private_but_less_stable{
+        constexpr std::string_view id_precision{ "id_precision" }; // Precision
+        constexpr std::string_view id_previous_fee{ "id_previous_fee" }; // Previous fee
+        constexpr std::string_view id_privacy_policy{ "id_privacy_policy" }; // Privacy Policy
+        constexpr std::string_view id_private_but_less_stable{
             "id_private_but_less_stable"
         }; // Private, but less stable connection
-        const std::string id_private_key{ "id_private_key" }; // Private Key
-        const std::string id_problem_with_key_1s{ "id_problem_with_key_1s" }; // Problem with key %1$s
-        const std::string id_provide_this_id_to_the_asset{
+        constexpr std::string_view id_private_key{ "id_private_key" }; // Private Key
+        constexpr std::string_view id_problem_with_key_1s{ "id_problem_with_key_1s" }; // Problem with key %1$s
+        constexpr std::string_view id_provide_this_id_to_the_asset{
             "id_provide_this_id_to_the_asset"
         }; // Provide this ID to the asset issuer if requested.
-        const std::string id_provide_your_amp_id_to_the{
+        constexpr std::string_view id_provide_your_amp_id_to_the{
             "id_provide_your_amp_id_to_the"
         }; // Provide your AMP ID to the asset issuer if requested.
-        const std::string id_proxy_host{ "id_proxy_host" }; // Proxy host
-        const std::string id_proxy_port{ "id_proxy_port" }; // Proxy port
-        const std::string id_proxy_settings{ "id_proxy_settings" }; // PROXY SETTINGS
-        const std::string id_qr_code{ "id_qr_code" }; // QR Code
-        const std::string id_qr_scanner{ "id_qr_scanner" }; // QR Scanner
-        const std::string id_radio_firmware{ "id_radio_firmware" }; // Radio firmware
-        const std::string id_read_more{ "id_read_more" }; // Read more
-        const std::string id_read_more_at_our_s{ "id_read_more_at_our_s" }; // Read more at our %s
-        const std::string id_ready_to_start{ "id_ready_to_start" }; // Ready to start
-        const std::string id_receive{ "id_receive" }; // Receive
-        const std::string id_receive_email_notifications_for{
+        constexpr std::string_view id_proxy_host{ "id_proxy_host" }; // Proxy host
+        constexpr std::string_view id_proxy_port{ "id_proxy_port" }; // Proxy port
+        constexpr std::string_view id_proxy_settings{ "id_proxy_settings" }; // PROXY SETTINGS
+        constexpr std::string_view id_qr_code{ "id_qr_code" }; // QR Code
+        constexpr std::string_view id_qr_scanner{ "id_qr_scanner" }; // QR Scanner
+        constexpr std::string_view id_radio_firmware{ "id_radio_firmware" }; // Radio firmware
+        constexpr std::string_view id_read_more{ "id_read_more" }; // Read more
+        constexpr std::string_view id_read_more_at_our_s{ "id_read_more_at_our_s" }; // Read more at our %s
+        constexpr std::string_view id_ready_to_start{ "id_ready_to_start" }; // Ready to start
+        constexpr std::string_view id_receive{ "id_receive" }; // Receive
+        constexpr std::string_view id_receive_email_notifications_for{
             "id_receive_email_notifications_for"
         }; // Receive email notifications for sent and received transactions
-        const std::string id_received{ "id_received" }; // Received
-        const std::string id_received_on{ "id_received_on" }; // Received on
-        const std::string id_recently_used_wallets{ "id_recently_used_wallets" }; // Recently used wallets
-        const std::string id_recipient{ "id_recipient" }; // Recipient
-        const std::string id_recipient_address{ "id_recipient_address" }; // Recipient address
-        const std::string id_recovery{ "id_recovery" }; // Recovery
-        const std::string id_recovery_and_notifications{
+        constexpr std::string_view id_received{ "id_received" }; // Received
+        constexpr std::string_view id_received_on{ "id_received_on" }; // Received on
+        constexpr std::string_view id_recently_used_wallets{ "id_recently_used_wallets" }; // Recently used wallets
+        constexpr std::string_view id_recipient{ "id_recipient" }; // Recipient
+        constexpr std::string_view id_recipient_address{ "id_recipient_address" }; // Recipient address
+        constexpr std::string_view id_recovery{ "id_recovery" }; // Recovery
+        constexpr std::string_view id_recovery_and_notifications{
             "id_recovery_and_notifications"
         }; // Recovery and Notifications
-        const std::string id_recovery_mnemonic{ "id_recovery_mnemonic" }; // Recovery mnemonic
-        const std::string id_recovery_phrase{ "id_recovery_phrase" }; // Recovery Phrase
-        const std::string id_recovery_phrase_check{ "id_recovery_phrase_check" }; // Recovery Phrase Check
-        const std::string id_recovery_tool{ "id_recovery_tool" }; // Recovery Tool
-        const std::string id_recovery_transaction_emails{
+        constexpr std::string_view id_recovery_mnemonic{ "id_recovery_mnemonic" }; // Recovery mnemonic
+        constexpr std::string_view id_recovery_phrase{ "id_recovery_phrase" }; // Recovery Phrase
+        constexpr std::string_view id_recovery_phrase_check{ "id_recovery_phrase_check" }; // Recovery Phrase Check
+        constexpr std::string_view id_recovery_tool{ "id_recovery_tool" }; // Recovery Tool
+        constexpr std::string_view id_recovery_transaction_emails{
             "id_recovery_transaction_emails"
         }; // Recovery transaction emails
-        const std::string id_recovery_transaction_request{
+        constexpr std::string_view id_recovery_transaction_request{
             "id_recovery_transaction_request"
         }; // Recovery transaction request sent
-        const std::string id_recovery_transactions{ "id_recovery_transactions" }; // Recovery transactions
-        const std::string id_recovery_words{ "id_recovery_words" }; // Recovery words
-        const std::string id_recovery_xpub{ "id_recovery_xpub" }; // Recovery xpub
-        const std::string id_redeem_your_deposited_funds{
+        constexpr std::string_view id_recovery_transactions{ "id_recovery_transactions" }; // Recovery transactions
+        constexpr std::string_view id_recovery_words{ "id_recovery_words" }; // Recovery words
+        constexpr std::string_view id_recovery_xpub{ "id_recovery_xpub" }; // Recovery xpub
+        constexpr std::string_view id_redeem_your_deposited_funds{
             "id_redeem_your_deposited_funds"
         }; // Redeem your deposited funds without Blockstream Green signature after a pre-defined period of time.
-        const std::string id_redeposited{ "id_redeposited" }; // Redeposited
-        const std::string id_reference_exchange_rate{ "id_reference_exchange_rate" }; // Reference exchange rate
-        const std::string id_refresh{ "id_refresh" }; // Refresh
-        const std::string id_reload{ "id_reload" }; // Reload
-        const std::string id_remember_me{ "id_remember_me" }; // Remember me
-        const std::string id_remove{ "id_remove" }; // Remove
-        const std::string id_remove_custom_network{ "id_remove_custom_network" }; // Remove custom network
-        const std::string id_remove_wallet{ "id_remove_wallet" }; // Remove wallet
-        const std::string id_rename_account{ "id_rename_account" }; // Rename account
-        const std::string id_rename_wallet{ "id_rename_wallet" }; // Rename Wallet
-        const std::string id_replaceable{ "id_replaceable" }; // replaceable
-        const std::string id_request_amount{ "id_request_amount" }; // Request Amount
-        const std::string id_request_failed{ "id_request_failed" }; // Request Failed
-        const std::string id_request_recovery_transactions{
+        constexpr std::string_view id_redeposited{ "id_redeposited" }; // Redeposited
+        constexpr std::string_view id_reference_exchange_rate{
+            "id_reference_exchange_rate"
+        }; // Reference exchange rate
+        constexpr std::string_view id_refresh{ "id_refresh" }; // Refresh
+        constexpr std::string_view id_reload{ "id_reload" }; // Reload
+        constexpr std::string_view id_remember_me{ "id_remember_me" }; // Remember me
+        constexpr std::string_view id_remove{ "id_remove" }; // Remove
+        constexpr std::string_view id_remove_custom_network{ "id_remove_custom_network" }; // Remove custom network
+        constexpr std::string_view id_remove_wallet{ "id_remove_wallet" }; // Remove wallet
+        constexpr std::string_view id_rename_account{ "id_rename_account" }; // Rename account
+        constexpr std::string_view id_rename_wallet{ "id_rename_wallet" }; // Rename Wallet
+        constexpr std::string_view id_replaceable{ "id_replaceable" }; // replaceable
+        constexpr std::string_view id_request_amount{ "id_request_amount" }; // Request Amount
+        constexpr std::string_view id_request_failed{ "id_request_failed" }; // Request Failed
+        constexpr std::string_view id_request_recovery_transactions{
             "id_request_recovery_transactions"
         }; // Request recovery transactions
-        const std::string id_request_sent{ "id_request_sent" }; // Request Sent
-        const std::string id_request_twofactor_reset{ "id_request_twofactor_reset" }; // Request Two-Factor reset
-        const std::string id_requested_fee_rate_too_low{
+        constexpr std::string_view id_request_sent{ "id_request_sent" }; // Request Sent
+        constexpr std::string_view id_request_twofactor_reset{
+            "id_request_twofactor_reset"
+        }; // Request Two-Factor reset
+        constexpr std::string_view id_requested_fee_rate_too_low{
             "id_requested_fee_rate_too_low"
         }; // Requested fee rate too low
-        const std::string id_reset{ "id_reset" }; // Reset
-        const std::string id_reset_spv{ "id_reset_spv" }; // Reset SPV
-        const std::string id_resetting_your_twofactor_takes{
+        constexpr std::string_view id_reset{ "id_reset" }; // Reset
+        constexpr std::string_view id_reset_spv{ "id_reset_spv" }; // Reset SPV
+        constexpr std::string_view id_resetting_your_twofactor_takes{
             "id_resetting_your_twofactor_takes"
         }; // Resetting your Two-Factor takes 12 months minimum. If you are sure you have lost your Two-Factor, please
            // provide a new email address below to receive the reset.
-        const std::string id_restore{ "id_restore" }; // Restore
-        const std::string id_restore_a_blockstream_green{
+        constexpr std::string_view id_restore{ "id_restore" }; // Restore
+        constexpr std::string_view id_restore_a_blockstream_green{
             "id_restore_a_blockstream_green"
         }; // Restore a Blockstream Green wallet using your 24 words mnemonic backup. You can find it in the settings of
            // any Blockstream Green app.
-        const std::string id_restore_a_singlesig_wallet{
+        constexpr std::string_view id_restore_a_singlesig_wallet{
             "id_restore_a_singlesig_wallet"
         }; // Restore a Singlesig wallet created on Blockstream Green, or import a wallet created with other apps. This
            // option only works with singlesig wallets using BIP39 mnemonics, and following the BIP44, BIP49, or BIP84
            // derivations.
-        const std::string id_restore_a_wallet{ "id_restore_a_wallet" }; // Restore a Wallet
-        const std::string id_restore_green_wallet{ "id_restore_green_wallet" }; // Restore Green Wallet
-        const std::string id_restore_temporary_wallet{ "id_restore_temporary_wallet" }; // Restore temporary wallet
-        const std::string id_restore_wallet{ "id_restore_wallet" }; // Restore Wallet
-        const std::string id_restore_with_recovery_phrase{
+        constexpr std::string_view id_restore_a_wallet{ "id_restore_a_wallet" }; // Restore a Wallet
+        constexpr std::string_view id_restore_green_wallet{ "id_restore_green_wallet" }; // Restore Green Wallet
+        constexpr std::string_view id_restore_temporary_wallet{
+            "id_restore_temporary_wallet"
+        }; // Restore temporary wallet
+        constexpr std::string_view id_restore_wallet{ "id_restore_wallet" }; // Restore Wallet
+        constexpr std::string_view id_restore_with_recovery_phrase{
             "id_restore_with_recovery_phrase"
         }; // Restore with recovery phrase
-        const std::string id_restoring_your_wallet{ "id_restoring_your_wallet" }; // Restoring Your Wallet
-        const std::string id_review{ "id_review" }; // Review
-        const std::string id_review_account_information{
+        constexpr std::string_view id_restoring_your_wallet{ "id_restoring_your_wallet" }; // Restoring Your Wallet
+        constexpr std::string_view id_review{ "id_review" }; // Review
+        constexpr std::string_view id_review_account_information{
             "id_review_account_information"
         }; // Review account information
-        const std::string id_review_output_s{ "id_review_output_s" }; // Review output %s
-        const std::string id_s_blocks_left{ "id_s_blocks_left" }; // %s blocks left
-        const std::string id_s_from_s{ "id_s_from_s" }; // %s from %s
-        const std::string id_s_network{ "id_s_network" }; // %s network
-        const std::string id_save{ "id_save" }; // Save
-        const std::string id_save_a_summary_of_your_accounts{
+        constexpr std::string_view id_review_output_s{ "id_review_output_s" }; // Review output %s
+        constexpr std::string_view id_s_blocks_left{ "id_s_blocks_left" }; // %s blocks left
+        constexpr std::string_view id_s_from_s{ "id_s_from_s" }; // %s from %s
+        constexpr std::string_view id_s_network{ "id_s_network" }; // %s network
+        constexpr std::string_view id_save{ "id_save" }; // Save
+        constexpr std::string_view id_save_a_summary_of_your_accounts{
             "id_save_a_summary_of_your_accounts"
         }; // Save a summary of your accounts to speed up recovery in case you need to use our recovery tool.
-        const std::string id_save_your_mnemonic{ "id_save_your_mnemonic" }; // Save your mnemonic
-        const std::string id_scan_a_qr_code_for_spv_pairing{
+        constexpr std::string_view id_save_your_mnemonic{ "id_save_your_mnemonic" }; // Save your mnemonic
+        constexpr std::string_view id_scan_a_qr_code_for_spv_pairing{
             "id_scan_a_qr_code_for_spv_pairing"
         }; // Scan a QR code for SPV pairing
-        const std::string id_scan_qr_code{ "id_scan_qr_code" }; // Scan QR code
-        const std::string id_scan_the_qr_code_with_an{
+        constexpr std::string_view id_scan_qr_code{ "id_scan_qr_code" }; // Scan QR code
+        constexpr std::string_view id_scan_the_qr_code_with_an{
             "id_scan_the_qr_code_with_an"
         }; // Scan the QR Code with an Authenticator app
-        const std::string id_scan_to_send_here{ "id_scan_to_send_here" }; // Scan to send here
-        const std::string id_screen_lock{ "id_screen_lock" }; // Screen Lock
-        const std::string id_search{ "id_search" }; // Search
-        const std::string id_search_address{ "id_search_address" }; // Search address
-        const std::string id_second{ "id_second" }; // second
-        const std::string id_seconds{ "id_seconds" }; // seconds
-        const std::string id_security{ "id_security" }; // Security
-        const std::string id_security_change{ "id_security_change" }; // Security Change
-        const std::string id_see_our_privacy_policy_s{ "id_see_our_privacy_policy_s" }; // See our privacy policy %s
-        const std::string id_see_our_terms_of_service_s{
+        constexpr std::string_view id_scan_to_send_here{ "id_scan_to_send_here" }; // Scan to send here
+        constexpr std::string_view id_screen_lock{ "id_screen_lock" }; // Screen Lock
+        constexpr std::string_view id_search{ "id_search" }; // Search
+        constexpr std::string_view id_search_address{ "id_search_address" }; // Search address
+        constexpr std::string_view id_second{ "id_second" }; // second
+        constexpr std::string_view id_seconds{ "id_seconds" }; // seconds
+        constexpr std::string_view id_security{ "id_security" }; // Security
+        constexpr std::string_view id_security_change{ "id_security_change" }; // Security Change
+        constexpr std::string_view id_see_our_privacy_policy_s{
+            "id_see_our_privacy_policy_s"
+        }; // See our privacy policy %s
+        constexpr std::string_view id_see_our_terms_of_service_s{
             "id_see_our_terms_of_service_s"
         }; // See our Terms of Service %s
-        const std::string id_segwit_account{ "id_segwit_account" }; // SegWit Account
-        const std::string id_select_a_fiat_currency_and{
+        constexpr std::string_view id_segwit_account{ "id_segwit_account" }; // SegWit Account
+        constexpr std::string_view id_select_a_fiat_currency_and{
             "id_select_a_fiat_currency_and"
         }; // Select a fiat currency and bitcoin denomination to show amounts in your wallet
-        const std::string id_select_account{ "id_select_account" }; // Select Account
-        const std::string id_select_an_app_on_s{ "id_select_an_app_on_s" }; // Select an app on %s
-        const std::string id_select_asset{ "id_select_asset" }; // Select asset
-        const std::string id_select_duration_of_twofactor{
+        constexpr std::string_view id_select_account{ "id_select_account" }; // Select Account
+        constexpr std::string_view id_select_an_app_on_s{ "id_select_an_app_on_s" }; // Select an app on %s
+        constexpr std::string_view id_select_asset{ "id_select_asset" }; // Select asset
+        constexpr std::string_view id_select_duration_of_twofactor{
             "id_select_duration_of_twofactor"
         }; // Select duration of Two-Factor Authentication protection for your coins. The new option applies to newly
            // received coins.
-        const std::string id_select_network{ "id_select_network" }; // Select network
-        const std::string id_select_the_s_app_on_your_ledger{
+        constexpr std::string_view id_select_network{ "id_select_network" }; // Select network
+        constexpr std::string_view id_select_the_s_app_on_your_ledger{
             "id_select_the_s_app_on_your_ledger"
         }; // Select the %s app on your Ledger and retry.
-        const std::string id_select_wallet{ "id_select_wallet" }; // Select Wallet
-        const std::string id_select_word_number_d{ "id_select_word_number_d" }; // Select word number %d
-        const std::string id_select_your_jade_to_login{ "id_select_your_jade_to_login" }; // Select your Jade to login
-        const std::string id_send{ "id_send" }; // Send
-        const std::string id_send_all_funds{ "id_send_all_funds" }; // Send All Funds
-        const std::string id_send_all_requires_a_single{
+        constexpr std::string_view id_select_wallet{ "id_select_wallet" }; // Select Wallet
+        constexpr std::string_view id_select_word_number_d{ "id_select_word_number_d" }; // Select word number %d
+        constexpr std::string_view id_select_your_jade_to_login{
+            "id_select_your_jade_to_login"
+        }; // Select your Jade to login
+        constexpr std::string_view id_send{ "id_send" }; // Send
+        constexpr std::string_view id_send_all_funds{ "id_send_all_funds" }; // Send All Funds
+        constexpr std::string_view id_send_all_requires_a_single{
             "id_send_all_requires_a_single"
         }; // Send All requires a single recipient
-        const std::string id_send_and_receive_liquidbased{
+        constexpr std::string_view id_send_and_receive_liquidbased{
             "id_send_and_receive_liquidbased"
         }; // Send and receive Liquid-based Managed Assets
-        const std::string id_send_to{ "id_send_to" }; // Send To
-        const std::string id_sending{ "id_sending" }; // SENDING
-        const std::string id_sending_request{ "id_sending_request" }; // Sending Request…
-        const std::string id_sent{ "id_sent" }; // Sent
-        const std::string id_sent_to{ "id_sent_to" }; // Sent to
-        const std::string id_server_ip_and_port_ipport{
+        constexpr std::string_view id_send_to{ "id_send_to" }; // Send To
+        constexpr std::string_view id_sending{ "id_sending" }; // SENDING
+        constexpr std::string_view id_sending_request{ "id_sending_request" }; // Sending Request…
+        constexpr std::string_view id_sent{ "id_sent" }; // Sent
+        constexpr std::string_view id_sent_to{ "id_sent_to" }; // Sent to
+        constexpr std::string_view id_server_ip_and_port_ipport{
             "id_server_ip_and_port_ipport"
         }; // Server IP and port (ip:port)
-        const std::string id_set_2fa_expiry{ "id_set_2fa_expiry" }; // Set 2FA expiry
-        const std::string id_set_a_limit_to_spend_without{
+        constexpr std::string_view id_set_2fa_expiry{ "id_set_2fa_expiry" }; // Set 2FA expiry
+        constexpr std::string_view id_set_a_limit_to_spend_without{
             "id_set_a_limit_to_spend_without"
         }; // Set a limit to spend without two-factor authentication
-        const std::string id_set_a_new_pin{ "id_set_a_new_pin" }; // Set a new PIN
-        const std::string id_set_a_pin{ "id_set_a_pin" }; // Set a PIN
-        const std::string id_set_a_timeout_to_logout_after{
+        constexpr std::string_view id_set_a_new_pin{ "id_set_a_new_pin" }; // Set a new PIN
+        constexpr std::string_view id_set_a_pin{ "id_set_a_pin" }; // Set a PIN
+        constexpr std::string_view id_set_a_timeout_to_logout_after{
             "id_set_a_timeout_to_logout_after"
         }; // Set a timeout to logout after prolonged inactivity
-        const std::string id_set_an_email_address_to_receive{
+        constexpr std::string_view id_set_an_email_address_to_receive{
             "id_set_an_email_address_to_receive"
         }; // Set an email address to receive transaction notifications
-        const std::string id_set_an_email_for_recovery{ "id_set_an_email_for_recovery" }; // Set an email for recovery
-        const std::string id_set_custom_fee_rate{ "id_set_custom_fee_rate" }; // Set custom fee rate
-        const std::string id_set_locktime{ "id_set_locktime" }; // Set Locktime
-        const std::string id_set_timelock{ "id_set_timelock" }; // Set timelock
-        const std::string id_set_twofactor_threshold{ "id_set_twofactor_threshold" }; // Set Two-Factor threshold
-        const std::string id_set_up_a_passcode_for_your_ios{
+        constexpr std::string_view id_set_an_email_for_recovery{
+            "id_set_an_email_for_recovery"
+        }; // Set an email for recovery
+        constexpr std::string_view id_set_custom_fee_rate{ "id_set_custom_fee_rate" }; // Set custom fee rate
+        constexpr std::string_view id_set_locktime{ "id_set_locktime" }; // Set Locktime
+        constexpr std::string_view id_set_timelock{ "id_set_timelock" }; // Set timelock
+        constexpr std::string_view id_set_twofactor_threshold{
+            "id_set_twofactor_threshold"
+        }; // Set Two-Factor threshold
+        constexpr std::string_view id_set_up_a_passcode_for_your_ios{
             "id_set_up_a_passcode_for_your_ios"
         }; // Set up a passcode for your iOS device to set a PIN for Blockstream Green
-        const std::string id_set_up_a_screen_lock_for_your{
+        constexpr std::string_view id_set_up_a_screen_lock_for_your{
             "id_set_up_a_screen_lock_for_your"
         }; // Set up a screen lock for your Android device to unlock your wallet using Android screen lock
-        const std::string id_set_up_an_email_to_get{
+        constexpr std::string_view id_set_up_an_email_to_get{
             "id_set_up_an_email_to_get"
         }; // Set up an email to get pre-signed transactions for recovery. Email notifications contain your encrypted
            // recovery data.
-        const std::string id_set_up_credentials_to_access_in{
+        constexpr std::string_view id_set_up_credentials_to_access_in{
             "id_set_up_credentials_to_access_in"
         }; // Set up credentials to access in watch-only mode to receive coins without putting your private keys at
            // risk. Access from any device using a Blockstream Green app
-        const std::string id_set_up_pgp_key_for{ "id_set_up_pgp_key_for" }; // Set up PGP key for communications
-        const std::string id_set_up_twofactor_authentication{
+        constexpr std::string_view id_set_up_pgp_key_for{
+            "id_set_up_pgp_key_for"
+        }; // Set up PGP key for communications
+        constexpr std::string_view id_set_up_twofactor_authentication{
             "id_set_up_twofactor_authentication"
         }; // Set up Two-Factor authentication
-        const std::string id_set_up_watchonly{ "id_set_up_watchonly" }; // Set up watch-only
-        const std::string id_set_up_watchonly_credentials{
+        constexpr std::string_view id_set_up_watchonly{ "id_set_up_watchonly" }; // Set up watch-only
+        constexpr std::string_view id_set_up_watchonly_credentials{
             "id_set_up_watchonly_credentials"
         }; // Set up watch-only credentials for this wallet
-        const std::string id_set_wallet_name{ "id_set_wallet_name" }; // Set wallet name
-        const std::string id_setting_up_your_wallet{ "id_setting_up_your_wallet" }; // Setting Up Your Wallet
-        const std::string id_setting_updated{ "id_setting_updated" }; // Setting updated
-        const std::string id_settings{ "id_settings" }; // Settings
-        const std::string id_setup_jade{ "id_setup_jade" }; // Setup Jade
-        const std::string id_setup_pin{ "id_setup_pin" }; // Setup PIN
-        const std::string id_setup_pin_and_s{ "id_setup_pin_and_s" }; // Setup PIN and %s
-        const std::string id_share{ "id_share" }; // Share
-        const std::string id_share_address{ "id_share_address" }; // Share Address
-        const std::string id_share_nonconfidential{ "id_share_nonconfidential" }; // Share non-confidential transaction
-        const std::string id_share_unblinding_data{ "id_share_unblinding_data" }; // Share unblinding data
-        const std::string id_show{ "id_show" }; // Show
-        const std::string id_show_all_assets{ "id_show_all_assets" }; // Show all assets
-        const std::string id_show_bitcoin_amounts_in{ "id_show_bitcoin_amounts_in" }; // Show bitcoin amounts in
-        const std::string id_show_coins_with_expiring{
+        constexpr std::string_view id_set_wallet_name{ "id_set_wallet_name" }; // Set wallet name
+        constexpr std::string_view id_setting_up_your_wallet{ "id_setting_up_your_wallet" }; // Setting Up Your Wallet
+        constexpr std::string_view id_setting_updated{ "id_setting_updated" }; // Setting updated
+        constexpr std::string_view id_settings{ "id_settings" }; // Settings
+        constexpr std::string_view id_setup_jade{ "id_setup_jade" }; // Setup Jade
+        constexpr std::string_view id_setup_pin{ "id_setup_pin" }; // Setup PIN
+        constexpr std::string_view id_setup_pin_and_s{ "id_setup_pin_and_s" }; // Setup PIN and %s
+        constexpr std::string_view id_share{ "id_share" }; // Share
+        constexpr std::string_view id_share_address{ "id_share_address" }; // Share Address
+        constexpr std::string_view id_share_nonconfidential{
+            "id_share_nonconfidential"
+        }; // Share non-confidential transaction
+        constexpr std::string_view id_share_unblinding_data{ "id_share_unblinding_data" }; // Share unblinding data
+        constexpr std::string_view id_show{ "id_show" }; // Show
+        constexpr std::string_view id_show_all_assets{ "id_show_all_assets" }; // Show all assets
+        constexpr std::string_view id_show_bitcoin_amounts_in{
+            "id_show_bitcoin_amounts_in"
+        }; // Show bitcoin amounts in
+        constexpr std::string_view id_show_coins_with_expiring{
             "id_show_coins_with_expiring"
         }; // Show coins with expiring Two-Factor authentication protection.
-        const std::string id_show_fiat{ "id_show_fiat" }; // Show fiat
-        const std::string id_show_my_wallet_backup{ "id_show_my_wallet_backup" }; // Show my wallet backup
-        const std::string id_show_qr_code{ "id_show_qr_code" }; // Show QR code
-        const std::string id_signature_validation_failed_if{
+        constexpr std::string_view id_show_fiat{ "id_show_fiat" }; // Show fiat
+        constexpr std::string_view id_show_my_wallet_backup{ "id_show_my_wallet_backup" }; // Show my wallet backup
+        constexpr std::string_view id_show_qr_code{ "id_show_qr_code" }; // Show QR code
+        constexpr std::string_view id_signature_validation_failed_if{
             "id_signature_validation_failed_if"
         }; // Signature validation failed. If this error is unexpected and has happened repeatedly, it is possible the
            // hardware wallet is faulty or has been compromised. It could be leaking your keys, which could lead to loss
            // of funds. Please consider replacing the hardware wallet.
-        const std::string id_signup_in_progress{ "id_signup_in_progress" }; // Signup in progress
-        const std::string id_simplified_payment_verification{
+        constexpr std::string_view id_signup_in_progress{ "id_signup_in_progress" }; // Signup in progress
+        constexpr std::string_view id_simplified_payment_verification{
             "id_simplified_payment_verification"
         }; // Simplified Payment Verification verifies your transactions and balance using the Bitcoin network, outside
            // of Green\'s servers. Enabling adds bandwidth and processing requirements
-        const std::string id_singlesig{ "id_singlesig" }; // Singlesig
-        const std::string id_singlesig_wallets_are_not_yet{
+        constexpr std::string_view id_singlesig{ "id_singlesig" }; // Singlesig
+        constexpr std::string_view id_singlesig_wallets_are_not_yet{
             "id_singlesig_wallets_are_not_yet"
         }; // Singlesig wallets are not yet supported for use with hardware devices. By continuing you\'ll access a
            // Multisig Shield wallet.
-        const std::string id_skip{ "id_skip" }; // SKIP
-        const std::string id_skip_not_recommended{ "id_skip_not_recommended" }; // Skip (Not Recommended)
-        const std::string id_slide_to_send{ "id_slide_to_send" }; // Slide to Send
-        const std::string id_slow{ "id_slow" }; // Slow
-        const std::string id_sms{ "id_sms" }; // SMS
-        const std::string id_snnreset_this_setting_and_then{
+        constexpr std::string_view id_skip{ "id_skip" }; // SKIP
+        constexpr std::string_view id_skip_not_recommended{ "id_skip_not_recommended" }; // Skip (Not Recommended)
+        constexpr std::string_view id_slide_to_send{ "id_slide_to_send" }; // Slide to Send
+        constexpr std::string_view id_slow{ "id_slow" }; // Slow
+        constexpr std::string_view id_sms{ "id_sms" }; // SMS
+        constexpr std::string_view id_snnreset_this_setting_and_then{
             "id_snnreset_this_setting_and_then"
         }; // %s.\n\nReset this setting and then re-activate it.
-        const std::string id_socks5_hostname{ "id_socks5_hostname" }; // Socks5 Hostname
-        const std::string id_socks5_port{ "id_socks5_port" }; // Socks5 Port
-        const std::string id_socks5_proxy_and_port_must_be{
+        constexpr std::string_view id_socks5_hostname{ "id_socks5_hostname" }; // Socks5 Hostname
+        constexpr std::string_view id_socks5_port{ "id_socks5_port" }; // Socks5 Port
+        constexpr std::string_view id_socks5_proxy_and_port_must_be{
             "id_socks5_proxy_and_port_must_be"
         }; // SOCKS5 proxy and port must be set
-        const std::string id_something_went_wrong{ "id_something_went_wrong" }; // Something went wrong
-        const std::string id_spend_your_bitcoin_without_2fa{
+        constexpr std::string_view id_something_went_wrong{ "id_something_went_wrong" }; // Something went wrong
+        constexpr std::string_view id_spend_your_bitcoin_without_2fa{
             "id_spend_your_bitcoin_without_2fa"
         }; // Spend your bitcoin without 2FA up to a certain threshold. After spending bitcoin up to this amount, you
            // will need to reset your threshold to continue spending without 2FA.
-        const std::string id_spv_is_always_synchronized_on{
+        constexpr std::string_view id_spv_is_always_synchronized_on{
             "id_spv_is_always_synchronized_on"
         }; // SPV is always synchronized on non-mobile networks like WiFi or Ethernet. This setting also synchronizes
            // when using mobile data. This can be expensive depending on your data plan so take care when enabling.
-        const std::string id_spv_mode_is_currently_available{
+        constexpr std::string_view id_spv_mode_is_currently_available{
             "id_spv_mode_is_currently_available"
         }; // SPV mode is currently available for singlesig bitcoin wallets only.
-        const std::string id_spv_not_fully_synced{ "id_spv_not_fully_synced" }; // SPV not fully synced
-        const std::string id_spv_notifications{ "id_spv_notifications" }; // SPV notifications
-        const std::string id_spv_reset_and_restarted{ "id_spv_reset_and_restarted" }; // SPV reset and restarted
-        const std::string id_spv_synchronization{ "id_spv_synchronization" }; // SPV synchronization
-        const std::string id_spv_synchronization_using_tor{
+        constexpr std::string_view id_spv_not_fully_synced{ "id_spv_not_fully_synced" }; // SPV not fully synced
+        constexpr std::string_view id_spv_notifications{ "id_spv_notifications" }; // SPV notifications
+        constexpr std::string_view id_spv_reset_and_restarted{
+            "id_spv_reset_and_restarted"
+        }; // SPV reset and restarted
+        constexpr std::string_view id_spv_synchronization{ "id_spv_synchronization" }; // SPV synchronization
+        constexpr std::string_view id_spv_synchronization_using_tor{
             "id_spv_synchronization_using_tor"
         }; // SPV synchronization using Tor requires a trusted node onion URL
-        const std::string id_spv_unverified{ "id_spv_unverified" }; // SPV unverified
-        const std::string id_spv_verification{ "id_spv_verification" }; // SPV verification
-        const std::string id_standard_account{ "id_standard_account" }; // Standard Account
-        const std::string id_standard_accounts_allow_you_to{
+        constexpr std::string_view id_spv_unverified{ "id_spv_unverified" }; // SPV unverified
+        constexpr std::string_view id_spv_verification{ "id_spv_verification" }; // SPV verification
+        constexpr std::string_view id_standard_account{ "id_standard_account" }; // Standard Account
+        constexpr std::string_view id_standard_accounts_allow_you_to{
             "id_standard_accounts_allow_you_to"
         }; // Standard accounts allow you to separate your funds. Each account will have its own receiving addresses,
            // and moving funds across accounts requires a transaction.
-        const std::string id_standard_wallet{ "id_standard_wallet" }; // Standard Wallet
-        const std::string id_start_a_2fa_reset_process_if{
+        constexpr std::string_view id_standard_wallet{ "id_standard_wallet" }; // Standard Wallet
+        constexpr std::string_view id_start_a_2fa_reset_process_if{
             "id_start_a_2fa_reset_process_if"
         }; // Start a 2FA reset process if you lost access to all your two-factor authentication methods.
-        const std::string id_start_receiving_funds_and_set{
+        constexpr std::string_view id_start_receiving_funds_and_set{
             "id_start_receiving_funds_and_set"
         }; // Start receiving funds and set an email to receive recovery data for your wallet
-        const std::string id_status{ "id_status" }; // Status
-        const std::string id_success{ "id_success" }; // Success
-        const std::string id_support{ "id_support" }; // Support
-        const std::string id_support_page{ "id_support_page" }; // Support Page
-        const std::string id_sweep{ "id_sweep" }; // Sweep
-        const std::string id_sweep_from_paper_wallet{ "id_sweep_from_paper_wallet" }; // Sweep From Paper Wallet
-        const std::string id_sweep_into_s{ "id_sweep_into_s" }; // Sweep into %s
-        const std::string id_switch_network{ "id_switch_network" }; // Switch Network
-        const std::string id_synchronize_spv_on_mobile{ "id_synchronize_spv_on_mobile" }; // Synchronize SPV on mobile
-        const std::string id_syou_need_ton1_reset_greens{
+        constexpr std::string_view id_status{ "id_status" }; // Status
+        constexpr std::string_view id_success{ "id_success" }; // Success
+        constexpr std::string_view id_support{ "id_support" }; // Support
+        constexpr std::string_view id_support_page{ "id_support_page" }; // Support Page
+        constexpr std::string_view id_sweep{ "id_sweep" }; // Sweep
+        constexpr std::string_view id_sweep_from_paper_wallet{
+            "id_sweep_from_paper_wallet"
+        }; // Sweep From Paper Wallet
+        constexpr std::string_view id_sweep_into_s{ "id_sweep_into_s" }; // Sweep into %s
+        constexpr std::string_view id_switch_network{ "id_switch_network" }; // Switch Network
+        constexpr std::string_view id_synchronize_spv_on_mobile{
+            "id_synchronize_spv_on_mobile"
+        }; // Synchronize SPV on mobile
+        constexpr std::string_view id_syou_need_ton1_reset_greens{
             "id_syou_need_ton1_reset_greens"
         }; // %s.You need to:\n1. Reset Green\'s Face/TouchID login,\n2. Log in with PIN,\n3. Re-activate Face/TouchID
            // from Green Settings.
-        const std::string id_system_location{ "id_system_location" }; // System location
-        const std::string id_system_message{ "id_system_message" }; // System Message
-        const std::string id_tap_on_the_card_to_view{
+        constexpr std::string_view id_system_location{ "id_system_location" }; // System location
+        constexpr std::string_view id_system_message{ "id_system_message" }; // System Message
+        constexpr std::string_view id_tap_on_the_card_to_view{
             "id_tap_on_the_card_to_view"
         }; // Tap on the card to view transactions.
-        const std::string id_tap_to_restart_the_simplified{
+        constexpr std::string_view id_tap_to_restart_the_simplified{
             "id_tap_to_restart_the_simplified"
         }; // Tap to restart the Simplified Payment Verification
-        const std::string id_tap_to_scan_a_qr_code_and{
+        constexpr std::string_view id_tap_to_scan_a_qr_code_and{
             "id_tap_to_scan_a_qr_code_and"
         }; // Tap to scan a QR code and connect to a node for SPV
-        const std::string id_telegram{ "id_telegram" }; // Telegram
-        const std::string id_terms_of_service{ "id_terms_of_service" }; // Terms of Service
-        const std::string id_terms_of_use{ "id_terms_of_use" }; // Terms of Use
-        const std::string id_testnet_electrum_server{ "id_testnet_electrum_server" }; // Testnet Electrum server
-        const std::string id_testnet_wallets{ "id_testnet_wallets" }; // Testnet wallets
-        const std::string id_thank_you_for_downloading_green{
+        constexpr std::string_view id_telegram{ "id_telegram" }; // Telegram
+        constexpr std::string_view id_terms_of_service{ "id_terms_of_service" }; // Terms of Service
+        constexpr std::string_view id_terms_of_use{ "id_terms_of_use" }; // Terms of Use
+        constexpr std::string_view id_testnet_electrum_server{
+            "id_testnet_electrum_server"
+        }; // Testnet Electrum server
+        constexpr std::string_view id_testnet_wallets{ "id_testnet_wallets" }; // Testnet wallets
+        constexpr std::string_view id_thank_you_for_downloading_green{
             "id_thank_you_for_downloading_green"
         }; // Thank you for downloading Green! Please leave us a review when you get a chance
-        const std::string id_the_1_year_2fa_reset_process{
+        constexpr std::string_view id_the_1_year_2fa_reset_process{
             "id_the_1_year_2fa_reset_process"
         }; // The 1 year 2FA reset process was ongoing, but someone blocked it by disputing the 2FA reset.
-        const std::string id_the_address_is_valid{ "id_the_address_is_valid" }; // The address is valid.
-        const std::string id_the_addresses_dont_match{ "id_the_addresses_dont_match" }; // The addresses don\'t match.
-        const std::string id_the_asset_registry_is_currently{
+        constexpr std::string_view id_the_address_is_valid{ "id_the_address_is_valid" }; // The address is valid.
+        constexpr std::string_view id_the_addresses_dont_match{
+            "id_the_addresses_dont_match"
+        }; // The addresses don\'t match.
+        constexpr std::string_view id_the_asset_registry_is_currently{
             "id_the_asset_registry_is_currently"
         }; // The asset registry is currently unavailable: proceed carefully since asset amounts might be shown with a
            // decimal precision different from what intended by the issuers.
-        const std::string id_the_camera_has_a_problem_you{
+        constexpr std::string_view id_the_camera_has_a_problem_you{
             "id_the_camera_has_a_problem_you"
         }; // The camera has a problem. You probably need to restart the device.
-        const std::string id_the_default_value_is_90_days_if{
+        constexpr std::string_view id_the_default_value_is_90_days_if{
             "id_the_default_value_is_90_days_if"
         }; // The default value is 90 days. If you set an email, you will receive an updated copy of your recovery data.
-        const std::string id_the_easier_safer_and_faster{
+        constexpr std::string_view id_the_easier_safer_and_faster{
             "id_the_easier_safer_and_faster"
         }; // the easier, safer and faster wallet
-        const std::string id_the_email_will_also_be_used_to{
+        constexpr std::string_view id_the_email_will_also_be_used_to{
             "id_the_email_will_also_be_used_to"
         }; // The email will also be used to receive recovery data and transaction notifications
-        const std::string id_the_hardware_wallet_you_are{
+        constexpr std::string_view id_the_hardware_wallet_you_are{
             "id_the_hardware_wallet_you_are"
         }; // The hardware wallet you are using is not yet supported
-        const std::string id_the_liquid_network_is_a_bitcoin{
+        constexpr std::string_view id_the_liquid_network_is_a_bitcoin{
             "id_the_liquid_network_is_a_bitcoin"
         }; // The Liquid Network is a Bitcoin sidechain. Select to send and receive Liquid Bitcoin (L-BTC), Tether
            // (USDt), and other Liquid assets.
-        const std::string id_the_network_selected_on_the{
+        constexpr std::string_view id_the_network_selected_on_the{
             "id_the_network_selected_on_the"
         }; // The network selected on the Green app is different from the one selected on the hardware wallet. Select
            // the same network on both devices.
-        const std::string id_the_new_email_will_be_used_for{
+        constexpr std::string_view id_the_new_email_will_be_used_for{
             "id_the_new_email_will_be_used_for"
         }; // The new email will be used for Two-Factor Authentication when the reset is complete. The reset takes 12
            // months plus any remaining timelock.
-        const std::string id_the_password_cant_be_empty{
+        constexpr std::string_view id_the_password_cant_be_empty{
             "id_the_password_cant_be_empty"
         }; // The password can\'t be empty
-        const std::string id_the_recovery_key_below_will_not{
+        constexpr std::string_view id_the_recovery_key_below_will_not{
             "id_the_recovery_key_below_will_not"
         }; // The recovery key below will not be shown again. Please make a safe backup of it now to ensure you can
            // always access your funds.
-        const std::string id_the_recovery_phrase_can_be_used{
+        constexpr std::string_view id_the_recovery_phrase_can_be_used{
             "id_the_recovery_phrase_can_be_used"
         }; // The recovery phrase can be used to claim your funds at any point. Keep it safe, keep it private.
-        const std::string id_the_recovery_phrase_doesnt{
+        constexpr std::string_view id_the_recovery_phrase_doesnt{
             "id_the_recovery_phrase_doesnt"
         }; // The recovery phrase doesn\'t match the previously existing wallet. Please retry with a different recovery
            // phrase.
-        const std::string id_the_source_code_is_available_at{
+        constexpr std::string_view id_the_source_code_is_available_at{
             "id_the_source_code_is_available_at"
         }; // The source code is available at %s
-        const std::string id_the_transaction_contains{
+        constexpr std::string_view id_the_transaction_contains{
             "id_the_transaction_contains"
         }; // The transaction contains non-confidential funds.
-        const std::string id_the_waiting_period_is_necessary{
+        constexpr std::string_view id_the_waiting_period_is_necessary{
             "id_the_waiting_period_is_necessary"
         }; // The waiting period is necessary to ensure the security of your wallet, to prevent thieves from getting
            // around your Two-Factor protection.
-        const std::string id_there_are_no_results_for_the{
+        constexpr std::string_view id_there_are_no_results_for_the{
             "id_there_are_no_results_for_the"
         }; // There are no results for the applied filter
-        const std::string id_there_is_already_a_pin_set_for{
+        constexpr std::string_view id_there_is_already_a_pin_set_for{
             "id_there_is_already_a_pin_set_for"
         }; // There is already a PIN set for a %s wallet. Proceeding will not allow setting a PIN and login will require
            // the 24 words mnemonic. You can disable PIN from settings or with 3 failed attempts.
-        const std::string id_these_are_some_compatible{
+        constexpr std::string_view id_these_are_some_compatible{
             "id_these_are_some_compatible"
         }; // These are some compatible wallets:
-        const std::string id_these_settings_apply_for_every{
+        constexpr std::string_view id_these_settings_apply_for_every{
             "id_these_settings_apply_for_every"
         }; // These settings apply for every wallet you use on Blockstream Green.
-        const std::string id_this_feature_is_coming_soon{
+        constexpr std::string_view id_this_feature_is_coming_soon{
             "id_this_feature_is_coming_soon"
         }; // This feature is coming soon, stay tuned!
-        const std::string id_this_transaction_spent{
+        constexpr std::string_view id_this_transaction_spent{
             "id_this_transaction_spent"
         }; // This transaction spent non-confidential funds.
-        const std::string id_this_wallet_operates_on_a_test{
+        constexpr std::string_view id_this_wallet_operates_on_a_test{
             "id_this_wallet_operates_on_a_test"
         }; // This wallet operates on a test network. Anything you receive or send here has no value
-        const std::string id_this_will_disable_pin_login_for{
+        constexpr std::string_view id_this_will_disable_pin_login_for{
             "id_this_will_disable_pin_login_for"
         }; // This will disable PIN login for this wallet on all your devices. You will need your recovery phrase to
            // access your wallet.
-        const std::string id_this_will_log_you_out_and{
+        constexpr std::string_view id_this_will_log_you_out_and{
             "id_this_will_log_you_out_and"
         }; // This will log you out and delete this wallet from the app and the Blockstream servers database.
-        const std::string id_ticker{ "id_ticker" }; // Ticker
-        const std::string id_time_s{ "id_time_s" }; // Time: %s
-        const std::string id_tip_we_recommend_you_enable{
+        constexpr std::string_view id_ticker{ "id_ticker" }; // Ticker
+        constexpr std::string_view id_time_s{ "id_time_s" }; // Time: %s
+        constexpr std::string_view id_tip_we_recommend_you_enable{
             "id_tip_we_recommend_you_enable"
         }; // Tip: We recommend you enable more than one 2FA method. If you only set up one 2FA method and then lose it,
            // you\'ll have to wait at least one year until the 2FA expires.
-        const std::string id_to{ "id_to" }; // TO
-        const std::string id_to_keep_you_in_control_of_your{
+        constexpr std::string_view id_to{ "id_to" }; // TO
+        constexpr std::string_view id_to_keep_you_in_control_of_your{
             "id_to_keep_you_in_control_of_your"
         }; // To keep you in control of your funds, Two-Factor Authentication protection expires after roughly %d days
            // since your last payment. You will be prompted to make a Two-Factor Reactivation transaction, if you don\'t
            // move funds often enough.
-        const std::string id_too_many_pin_attempts{ "id_too_many_pin_attempts" }; // Too many PIN attempts
-        const std::string id_tor{ "id_tor" }; // Tor
-        const std::string id_tor_connectivity_disabled{ "id_tor_connectivity_disabled" }; // Tor Connectivity Disabled!
-        const std::string id_tor_is_connected{ "id_tor_is_connected" }; // Tor is connected
-        const std::string id_tor_is_not_yet_available_for{
+        constexpr std::string_view id_too_many_pin_attempts{ "id_too_many_pin_attempts" }; // Too many PIN attempts
+        constexpr std::string_view id_tor{ "id_tor" }; // Tor
+        constexpr std::string_view id_tor_connectivity_disabled{
+            "id_tor_connectivity_disabled"
+        }; // Tor Connectivity Disabled!
+        constexpr std::string_view id_tor_is_connected{ "id_tor_is_connected" }; // Tor is connected
+        constexpr std::string_view id_tor_is_not_yet_available_for{
             "id_tor_is_not_yet_available_for"
         }; // Tor is not yet available for singlesig wallets
-        const std::string id_tor_status{ "id_tor_status" }; // Tor status
-        const std::string id_tor_will_use_1s_and_only_work{
+        constexpr std::string_view id_tor_status{ "id_tor_status" }; // Tor status
+        constexpr std::string_view id_tor_will_use_1s_and_only_work{
             "id_tor_will_use_1s_and_only_work"
         }; // Tor will use %1$s and only work if your proxy is Orbot or Tor enabled
-        const std::string id_total_assets{ "id_total_assets" }; // Total Assets
-        const std::string id_total_balance{ "id_total_balance" }; // Total Balance
-        const std::string id_total_with_fee{ "id_total_with_fee" }; // Total with Fee
-        const std::string id_touch_id{ "id_touch_id" }; // Touch ID
-        const std::string id_touch_to_display{ "id_touch_to_display" }; // Touch to display
-        const std::string id_touchface_id_not_available{
+        constexpr std::string_view id_total_assets{ "id_total_assets" }; // Total Assets
+        constexpr std::string_view id_total_balance{ "id_total_balance" }; // Total Balance
+        constexpr std::string_view id_total_with_fee{ "id_total_with_fee" }; // Total with Fee
+        constexpr std::string_view id_touch_id{ "id_touch_id" }; // Touch ID
+        constexpr std::string_view id_touch_to_display{ "id_touch_to_display" }; // Touch to display
+        constexpr std::string_view id_touchface_id_not_available{
             "id_touchface_id_not_available"
         }; // Touch/Face ID not available
-        const std::string id_transaction_already_confirmed{
+        constexpr std::string_view id_transaction_already_confirmed{
             "id_transaction_already_confirmed"
         }; // Transaction already confirmed
-        const std::string id_transaction_copied_to_clipboard{
+        constexpr std::string_view id_transaction_copied_to_clipboard{
             "id_transaction_copied_to_clipboard"
         }; // Transaction copied to clipboard
-        const std::string id_transaction_details{ "id_transaction_details" }; // Transaction details
-        const std::string id_transaction_id{ "id_transaction_id" }; // Transaction ID
-        const std::string id_transaction_sent{ "id_transaction_sent" }; // Transaction Sent
-        const std::string id_transaction_status{ "id_transaction_status" }; // Transaction status
-        const std::string id_transactions{ "id_transactions" }; // Transactions
-        const std::string id_try_again{ "id_try_again" }; // Try Again
-        const std::string id_try_now{ "id_try_now" }; // Try now
-        const std::string id_turn_on_bluetooth_to_connect{
+        constexpr std::string_view id_transaction_details{ "id_transaction_details" }; // Transaction details
+        constexpr std::string_view id_transaction_id{ "id_transaction_id" }; // Transaction ID
+        constexpr std::string_view id_transaction_sent{ "id_transaction_sent" }; // Transaction Sent
+        constexpr std::string_view id_transaction_status{ "id_transaction_status" }; // Transaction status
+        constexpr std::string_view id_transactions{ "id_transactions" }; // Transactions
+        constexpr std::string_view id_try_again{ "id_try_again" }; // Try Again
+        constexpr std::string_view id_try_now{ "id_try_now" }; // Try now
+        constexpr std::string_view id_turn_on_bluetooth_to_connect{
             "id_turn_on_bluetooth_to_connect"
         }; // Turn on bluetooth to connect your hardware wallet.
-        const std::string id_two_factor_authentication{ "id_two_factor_authentication" }; // TWO FACTOR AUTHENTICATION
-        const std::string id_twofactor{ "id_twofactor" }; // Two-Factor
-        const std::string id_twofactor_authentication{ "id_twofactor_authentication" }; // Two-Factor authentication
-        const std::string id_twofactor_authentication_expiry{
+        constexpr std::string_view id_two_factor_authentication{
+            "id_two_factor_authentication"
+        }; // TWO FACTOR AUTHENTICATION
+        constexpr std::string_view id_twofactor{ "id_twofactor" }; // Two-Factor
+        constexpr std::string_view id_twofactor_authentication{
+            "id_twofactor_authentication"
+        }; // Two-Factor authentication
+        constexpr std::string_view id_twofactor_authentication_expiry{
             "id_twofactor_authentication_expiry"
         }; // Two-Factor authentication expiry
-        const std::string id_twofactor_expiration_period{
+        constexpr std::string_view id_twofactor_expiration_period{
             "id_twofactor_expiration_period"
         }; // Two-Factor expiration period
-        const std::string id_twofactor_protection_does_not{
+        constexpr std::string_view id_twofactor_protection_does_not{
             "id_twofactor_protection_does_not"
         }; // Two-Factor protection does not expire on this account, enable 2 separate Two-Factor methods as backup in
            // case you lose access to one.
-        const std::string id_twofactor_reset_in_progress{
+        constexpr std::string_view id_twofactor_reset_in_progress{
             "id_twofactor_reset_in_progress"
         }; // Two-Factor reset in progress, your wallet is currently locked.
-        const std::string id_twofactor_settings{ "id_twofactor_settings" }; // Two-Factor Settings
-        const std::string id_twofactor_threshold{ "id_twofactor_threshold" }; // Two-Factor threshold
-        const std::string id_txid{ "id_txid" }; // TXID
-        const std::string id_unable_to_contact_the_green{
+        constexpr std::string_view id_twofactor_settings{ "id_twofactor_settings" }; // Two-Factor Settings
+        constexpr std::string_view id_twofactor_threshold{ "id_twofactor_threshold" }; // Two-Factor threshold
+        constexpr std::string_view id_txid{ "id_txid" }; // TXID
+        constexpr std::string_view id_unable_to_contact_the_green{
             "id_unable_to_contact_the_green"
         }; // Unable to contact the Green service. Please check your network connection and wait to be reconnected.
-        const std::string id_unblinding_data{ "id_unblinding_data" }; // Unblinding data
-        const std::string id_unconfirmed{ "id_unconfirmed" }; // Unconfirmed
-        const std::string id_undo_2fa_dispute{ "id_undo_2fa_dispute" }; // Undo 2FA dispute
-        const std::string id_unknown{ "id_unknown" }; // Unknown
-        const std::string id_unknown_bip21_parameter{ "id_unknown_bip21_parameter" }; // Unknown bip21 parameter
-        const std::string id_unknown_custom{ "id_unknown_custom" }; // Unknown (Custom)
-        const std::string id_unknown_firmware{ "id_unknown_firmware" }; // Unknown firmware
-        const std::string id_unlock{ "id_unlock" }; // Unlock
-        const std::string id_unlock_jade_to_continue{ "id_unlock_jade_to_continue" }; // Unlock Jade to continue
-        const std::string id_unlocked_coins_can_be_spent_and{
+        constexpr std::string_view id_unblinding_data{ "id_unblinding_data" }; // Unblinding data
+        constexpr std::string_view id_unconfirmed{ "id_unconfirmed" }; // Unconfirmed
+        constexpr std::string_view id_undo_2fa_dispute{ "id_undo_2fa_dispute" }; // Undo 2FA dispute
+        constexpr std::string_view id_unknown{ "id_unknown" }; // Unknown
+        constexpr std::string_view id_unknown_bip21_parameter{
+            "id_unknown_bip21_parameter"
+        }; // Unknown bip21 parameter
+        constexpr std::string_view id_unknown_custom{ "id_unknown_custom" }; // Unknown (Custom)
+        constexpr std::string_view id_unknown_firmware{ "id_unknown_firmware" }; // Unknown firmware
+        constexpr std::string_view id_unlock{ "id_unlock" }; // Unlock
+        constexpr std::string_view id_unlock_jade_to_continue{
+            "id_unlock_jade_to_continue"
+        }; // Unlock Jade to continue
+        constexpr std::string_view id_unlocked_coins_can_be_spent_and{
             "id_unlocked_coins_can_be_spent_and"
         }; // Unlocked coins can be spent and are included in your balance.
-        const std::string id_unlocking_coins{ "id_unlocking_coins" }; // Unlocking coins
-        const std::string id_unstable_internet_connection{
+        constexpr std::string_view id_unlocking_coins{ "id_unlocking_coins" }; // Unlocking coins
+        constexpr std::string_view id_unstable_internet_connection{
             "id_unstable_internet_connection"
         }; // Unstable internet connection
-        const std::string id_update{ "id_update" }; // Update
-        const std::string id_updated{ "id_updated" }; // updated
-        const std::string id_updating_firmware{ "id_updating_firmware" }; // Updating firmware…
-        const std::string id_uploading_firmware{ "id_uploading_firmware" }; // Uploading firmware
-        const std::string id_use_a_hardware_wallet_as_your{
+        constexpr std::string_view id_update{ "id_update" }; // Update
+        constexpr std::string_view id_updated{ "id_updated" }; // updated
+        constexpr std::string_view id_updating_firmware{ "id_updating_firmware" }; // Updating firmware…
+        constexpr std::string_view id_uploading_firmware{ "id_uploading_firmware" }; // Uploading firmware
+        constexpr std::string_view id_use_a_hardware_wallet_as_your{
             "id_use_a_hardware_wallet_as_your"
         }; // Use a hardware wallet as your third recovery key.
-        const std::string id_use_a_public_key{ "id_use_a_public_key" }; // Use a public key
-        const std::string id_use_an_existing_recovery_phrase{
+        constexpr std::string_view id_use_a_public_key{ "id_use_a_public_key" }; // Use a public key
+        constexpr std::string_view id_use_an_existing_recovery_phrase{
             "id_use_an_existing_recovery_phrase"
         }; // Use an existing recovery phrase as your third recovery key.
-        const std::string id_use_an_xpub_for_which_you_own{
+        constexpr std::string_view id_use_an_xpub_for_which_you_own{
             "id_use_an_xpub_for_which_you_own"
         }; // Use an xpub for which you own the corresponding private key as your third recovery key.
-        const std::string id_use_android_screen_lock_to_log{
+        constexpr std::string_view id_use_android_screen_lock_to_log{
             "id_use_android_screen_lock_to_log"
         }; // Use Android screen lock to log in
-        const std::string id_use_your_email_to_receive{
+        constexpr std::string_view id_use_your_email_to_receive{
             "id_use_your_email_to_receive"
         }; // Use your email to receive recovery transactions and transactions notifications
-        const std::string id_user_not_found_or_invalid{
+        constexpr std::string_view id_user_not_found_or_invalid{
             "id_user_not_found_or_invalid"
         }; // User not found or invalid password
-        const std::string id_username{ "id_username" }; // Username
-        const std::string id_username_not_available{ "id_username_not_available" }; // Username not available
-        const std::string id_value_must_be_between_144_and{
+        constexpr std::string_view id_username{ "id_username" }; // Username
+        constexpr std::string_view id_username_not_available{ "id_username_not_available" }; // Username not available
+        constexpr std::string_view id_value_must_be_between_144_and{
             "id_value_must_be_between_144_and"
         }; // Value must be between 144 and 200000
-        const std::string id_verified{ "id_verified" }; // Verified
-        const std::string id_verify_on_device{ "id_verify_on_device" }; // Verify on Device
-        const std::string id_verify_your_bitcoin{
+        constexpr std::string_view id_verified{ "id_verified" }; // Verified
+        constexpr std::string_view id_verify_on_device{ "id_verify_on_device" }; // Verify on Device
+        constexpr std::string_view id_verify_your_bitcoin{
             "id_verify_your_bitcoin"
         }; // Verify your bitcoin transactions are included on the blockchain
-        const std::string id_verify_your_pin{ "id_verify_your_pin" }; // Verify Your PIN
-        const std::string id_verifying_transactions{ "id_verifying_transactions" }; // Verifying transactions…
-        const std::string id_version{ "id_version" }; // Version
-        const std::string id_version_1s{ "id_version_1s" }; // Version: %1$s
-        const std::string id_version_1s_2s{ "id_version_1s_2s" }; // Version %1$s %2$s
-        const std::string id_view_in_explorer{ "id_view_in_explorer" }; // View in Explorer
-        const std::string id_view_more{ "id_view_more" }; // View More
-        const std::string id_visit_s_for_further_information{
+        constexpr std::string_view id_verify_your_pin{ "id_verify_your_pin" }; // Verify Your PIN
+        constexpr std::string_view id_verifying_transactions{ "id_verifying_transactions" }; // Verifying transactions…
+        constexpr std::string_view id_version{ "id_version" }; // Version
+        constexpr std::string_view id_version_1s{ "id_version_1s" }; // Version: %1$s
+        constexpr std::string_view id_version_1s_2s{ "id_version_1s_2s" }; // Version %1$s %2$s
+        constexpr std::string_view id_view_in_explorer{ "id_view_in_explorer" }; // View in Explorer
+        constexpr std::string_view id_view_more{ "id_view_more" }; // View More
+        constexpr std::string_view id_visit_s_for_further_information{
             "id_visit_s_for_further_information"
         }; // Visit %s for further information about the software
-        const std::string id_visit_the_blockstream_help{
+        constexpr std::string_view id_visit_the_blockstream_help{
             "id_visit_the_blockstream_help"
         }; // Visit the Blockstream Help Center
-        const std::string id_waiting_for_transaction{ "id_waiting_for_transaction" }; // Waiting for transaction…
-        const std::string id_wallet_backup{ "id_wallet_backup" }; // Wallet Backup
-        const std::string id_wallet_coins_will_require{
+        constexpr std::string_view id_waiting_for_transaction{
+            "id_waiting_for_transaction"
+        }; // Waiting for transaction…
+        constexpr std::string_view id_wallet_backup{ "id_wallet_backup" }; // Wallet Backup
+        constexpr std::string_view id_wallet_coins_will_require{
             "id_wallet_coins_will_require"
         }; // Wallet coins will require two-factor reactivation once a year to remain protected by two-factor
            // authentication.
-        const std::string id_wallet_creation_failed{ "id_wallet_creation_failed" }; // Wallet creation failed
-        const std::string id_wallet_name{ "id_wallet_name" }; // Wallet Name
-        const std::string id_wallets{ "id_wallets" }; // Wallets
-        const std::string id_warning{ "id_warning" }; // Warning!
-        const std::string id_warning_no_trusted_node_set{
+        constexpr std::string_view id_wallet_creation_failed{ "id_wallet_creation_failed" }; // Wallet creation failed
+        constexpr std::string_view id_wallet_name{ "id_wallet_name" }; // Wallet Name
+        constexpr std::string_view id_wallets{ "id_wallets" }; // Wallets
+        constexpr std::string_view id_warning{ "id_warning" }; // Warning!
+        constexpr std::string_view id_warning_no_trusted_node_set{
             "id_warning_no_trusted_node_set"
         }; // Warning: No trusted node set!
-        const std::string id_warning_nononion_address{
+        constexpr std::string_view id_warning_nononion_address{
             "id_warning_nononion_address"
         }; // Warning: Non-.onion address detected!
-        const std::string id_warning_resetting_twofactor{
+        constexpr std::string_view id_warning_resetting_twofactor{
             "id_warning_resetting_twofactor"
         }; // WARNING: Resetting Two-Factor authentication will lock your wallet
-        const std::string id_warning_there_is_already_a{
+        constexpr std::string_view id_warning_there_is_already_a{
             "id_warning_there_is_already_a"
         }; // WARNING: There is already a request to reset Two-Factor authentication for your wallet. If you now request
            // with a new email address, your wallet will become disputed and likely permanently unavailable to you.
-        const std::string id_warning_wallet_locked_by{
+        constexpr std::string_view id_warning_wallet_locked_by{
             "id_warning_wallet_locked_by"
         }; // WARNING: Wallet locked by Two-Factor dispute. Contact support for more information.
-        const std::string id_warning_watchonly_credentials{
+        constexpr std::string_view id_warning_watchonly_credentials{
             "id_warning_watchonly_credentials"
         }; // Warning: Watch-only credentials will be saved on your device
-        const std::string id_warning_you_need_a_positive{
+        constexpr std::string_view id_warning_you_need_a_positive{
             "id_warning_you_need_a_positive"
         }; // Warning! You need a positive L-BTC balance to be able to send transactions.
-        const std::string id_watchonly{ "id_watchonly" }; // Watch-only
-        const std::string id_watchonly_disabled{ "id_watchonly_disabled" }; // Watch-only disabled
-        const std::string id_watchonly_login{ "id_watchonly_login" }; // Watch-only login
-        const std::string id_watchonly_mode_can_be_activated{
+        constexpr std::string_view id_watchonly{ "id_watchonly" }; // Watch-only
+        constexpr std::string_view id_watchonly_disabled{ "id_watchonly_disabled" }; // Watch-only disabled
+        constexpr std::string_view id_watchonly_login{ "id_watchonly_login" }; // Watch-only login
+        constexpr std::string_view id_watchonly_mode_can_be_activated{
             "id_watchonly_mode_can_be_activated"
         }; // Watch-only mode can be activated from settings after logging in with your PIN, mnemonic, or hardware
            // wallet.
-        const std::string id_watchonly_mode_cannot_be{
+        constexpr std::string_view id_watchonly_mode_cannot_be{
             "id_watchonly_mode_cannot_be"
         }; // Watch-only mode cannot be activated on Liquid as your funds are fully confidential.
-        const std::string id_watchonly_wallet{ "id_watchonly_wallet" }; // Watch-Only Wallet
-        const std::string id_we_use_the_camera_to_scan_qr{
+        constexpr std::string_view id_watchonly_wallet{ "id_watchonly_wallet" }; // Watch-Only Wallet
+        constexpr std::string_view id_we_use_the_camera_to_scan_qr{
             "id_we_use_the_camera_to_scan_qr"
         }; // We use the camera to scan QR codes
-        const std::string id_welcome{ "id_welcome" }; // Welcome
-        const std::string id_welcome_to{ "id_welcome_to" }; // Welcome to
-        const std::string id_well_done_you_can_continue{
+        constexpr std::string_view id_welcome{ "id_welcome" }; // Welcome
+        constexpr std::string_view id_welcome_to{ "id_welcome_to" }; // Welcome to
+        constexpr std::string_view id_well_done_you_can_continue{
             "id_well_done_you_can_continue"
         }; // Well done, you can continue
-        const std::string id_well_done_you_can_continue_with{
+        constexpr std::string_view id_well_done_you_can_continue_with{
             "id_well_done_you_can_continue_with"
         }; // Well done, you can continue with your password
-        const std::string id_well_get_you_set_up_in_no_time{
+        constexpr std::string_view id_well_get_you_set_up_in_no_time{
             "id_well_get_you_set_up_in_no_time"
         }; // We\'ll get you set up in no time. Make sure you have a pen and paper ready!
-        const std::string id_well_get_you_set_up_with_an_amp{
+        constexpr std::string_view id_well_get_you_set_up_with_an_amp{
             "id_well_get_you_set_up_with_an_amp"
         }; // We\'ll get you set up with an AMP wallet in no time. Note that you can alternatively create AMP accounts
            // in any existing Liquid wallet.
-        const std::string id_what_type_of_account_would_you{
+        constexpr std::string_view id_what_type_of_account_would_you{
             "id_what_type_of_account_would_you"
         }; // What type of account would you like to add?
-        const std::string id_whats_new{ "id_whats_new" }; // What\'s new?
-        const std::string id_where_would_you_like_to{
+        constexpr std::string_view id_whats_new{ "id_whats_new" }; // What\'s new?
+        constexpr std::string_view id_where_would_you_like_to{
             "id_where_would_you_like_to"
         }; // Where would you like to transfer the funds?
-        const std::string id_wireless{ "id_wireless" }; // Wireless
-        const std::string id_word{ "id_word" }; // Word
-        const std::string id_word_d_of_d{ "id_word_d_of_d" }; // Word %d of %d
-        const std::string id_write_down_the_words{ "id_write_down_the_words" }; // Write down the words
-        const std::string id_write_down_your_recovery_phrase{
+        constexpr std::string_view id_wireless{ "id_wireless" }; // Wireless
+        constexpr std::string_view id_word{ "id_word" }; // Word
+        constexpr std::string_view id_word_d_of_d{ "id_word_d_of_d" }; // Word %d of %d
+        constexpr std::string_view id_write_down_the_words{ "id_write_down_the_words" }; // Write down the words
+        constexpr std::string_view id_write_down_your_recovery_phrase{
             "id_write_down_your_recovery_phrase"
         }; // Write down your recovery phrase on paper and store it somewhere safe.
-        const std::string id_wrong_choice_check_your{
+        constexpr std::string_view id_wrong_choice_check_your{
             "id_wrong_choice_check_your"
         }; // Wrong choice. Check your mnemonic and try again.
-        const std::string id_year{ "id_year" }; // year
-        const std::string id_years{ "id_years" }; // years
-        const std::string id_you_are_not_connected{ "id_you_are_not_connected" }; // You are not connected
-        const std::string id_you_are_not_connected_please{
+        constexpr std::string_view id_year{ "id_year" }; // year
+        constexpr std::string_view id_years{ "id_years" }; // years
+        constexpr std::string_view id_you_are_not_connected{ "id_you_are_not_connected" }; // You are not connected
+        constexpr std::string_view id_you_are_not_connected_please{
             "id_you_are_not_connected_please"
         }; // You are not connected, please wait
-        const std::string id_you_are_now_connected{ "id_you_are_now_connected" }; // You are now connected
-        const std::string id_you_can_change_these_later_on{
+        constexpr std::string_view id_you_are_now_connected{ "id_you_are_now_connected" }; // You are now connected
+        constexpr std::string_view id_you_can_change_these_later_on{
             "id_you_can_change_these_later_on"
         }; // You can change these later on.
-        const std::string id_you_cannot_create_or_restore_a{
+        constexpr std::string_view id_you_cannot_create_or_restore_a{
             "id_you_cannot_create_or_restore_a"
         }; // You cannot create or restore a wallet on %s as you already have a PIN protected wallet.
-        const std::string id_you_have_clicked_a_payment_uri{
+        constexpr std::string_view id_you_have_clicked_a_payment_uri{
             "id_you_have_clicked_a_payment_uri"
         }; // You have clicked a Payment URI, select a wallet to handle it
-        const std::string id_you_have_control_on_your_funds{
+        constexpr std::string_view id_you_have_control_on_your_funds{
             "id_you_have_control_on_your_funds"
         }; // You have control on your funds
-        const std::string id_you_have_no_coins_to_send{
+        constexpr std::string_view id_you_have_no_coins_to_send{
             "id_you_have_no_coins_to_send"
         }; // You have no coins to send. Generate an address to receive some bitcoins.
-        const std::string id_you_have_received_s{ "id_you_have_received_s" }; // You have received %s
-        const std::string id_you_have_successfully_changed{
+        constexpr std::string_view id_you_have_received_s{ "id_you_have_received_s" }; // You have received %s
+        constexpr std::string_view id_you_have_successfully_changed{
             "id_you_have_successfully_changed"
         }; // You have successfully changed your PIN
-        const std::string id_you_have_to_authenticate_using{
+        constexpr std::string_view id_you_have_to_authenticate_using{
             "id_you_have_to_authenticate_using"
         }; // You have to Authenticate using biometrics
-        const std::string id_you_have_tor_enabled_are_you{
+        constexpr std::string_view id_you_have_tor_enabled_are_you{
             "id_you_have_tor_enabled_are_you"
         }; // You have Tor enabled, are you sure you want to open this webpage?
-        const std::string id_you_must_first_log_out_before{
+        constexpr std::string_view id_you_must_first_log_out_before{
             "id_you_must_first_log_out_before"
         }; // You must first log out before logging in.
-        const std::string id_you_must_save_this_mnemonic_now{
+        constexpr std::string_view id_you_must_save_this_mnemonic_now{
             "id_you_must_save_this_mnemonic_now"
         }; // You MUST save this mnemonic NOW
-        const std::string id_you_only_have_one_twofactor{
+        constexpr std::string_view id_you_only_have_one_twofactor{
             "id_you_only_have_one_twofactor"
         }; // You only have one Two-Factor authentication method enabled
-        const std::string id_you_will_need_to_reenter_your{
+        constexpr std::string_view id_you_will_need_to_reenter_your{
             "id_you_will_need_to_reenter_your"
         }; // You will need to re-enter your mnemonic to login again if you do not set up a PIN. Press "OK" to continue.
-        const std::string id_youll_need_to_back_up_your{
+        constexpr std::string_view id_youll_need_to_back_up_your{
             "id_youll_need_to_back_up_your"
         }; // You’ll need to back up your recovery phrase before you can send or receive funds, but you can still check
            // out the wallet for now.
-        const std::string id_youll_need_your_pin_to_log_in{
+        constexpr std::string_view id_youll_need_your_pin_to_log_in{
             "id_youll_need_your_pin_to_log_in"
         }; // You\'ll need your PIN to log in to your wallet. This PIN secures the wallet on this device only.
-        const std::string id_youll_need_your_recovery_phrase{
+        constexpr std::string_view id_youll_need_your_recovery_phrase{
             "id_youll_need_your_recovery_phrase"
         }; // You\'ll need your recovery phrase to restore this wallet
-        const std::string id_youll_see_your_coins_here_when{
+        constexpr std::string_view id_youll_see_your_coins_here_when{
             "id_youll_see_your_coins_here_when"
         }; // You\'ll see your coins here when you receive funds
-        const std::string id_your_2fa_expires_so_that_if_you{
+        constexpr std::string_view id_your_2fa_expires_so_that_if_you{
             "id_your_2fa_expires_so_that_if_you"
         }; // Your 2FA expires, so that if you lose access to your 2FA method, or the Blockstream Green service becomes
            // unavailable, you can always recover your bitcoin using this open source tool
-        const std::string id_your_device_was_disconnected{
+        constexpr std::string_view id_your_device_was_disconnected{
             "id_your_device_was_disconnected"
         }; // Your device was disconnected
-        const std::string id_your_favourite_exchange_rate_is{
+        constexpr std::string_view id_your_favourite_exchange_rate_is{
             "id_your_favourite_exchange_rate_is"
         }; // Your favourite exchange rate is not available at the moment. You can change it from settings.
-        const std::string id_your_funds_are_secured_by{
+        constexpr std::string_view id_your_funds_are_secured_by{
             "id_your_funds_are_secured_by"
         }; // Your funds are secured by multiple keys, with one key on your device and another on our servers protected
            // by your 2FA. Select this option for enhanced security.
-        const std::string id_your_funds_are_secured_by_a{
+        constexpr std::string_view id_your_funds_are_secured_by_a{
             "id_your_funds_are_secured_by_a"
         }; // Your funds are secured by a single key held on your device. Simpler to set up and operate than multisig.
            // If in doubt, select this option.
-        const std::string id_your_green_wallet_is_now_ready{
+        constexpr std::string_view id_your_green_wallet_is_now_ready{
             "id_your_green_wallet_is_now_ready"
         }; // Your Green wallet is now ready to use.
-        const std::string id_your_ios_device_might_not_be{
+        constexpr std::string_view id_your_ios_device_might_not_be{
             "id_your_ios_device_might_not_be"
         }; // Your iOS device might not be supported
-        const std::string id_your_notifications_will_be{
+        constexpr std::string_view id_your_notifications_will_be{
             "id_your_notifications_will_be"
         }; // Your notifications will be shown here.
-        const std::string id_your_pin_or_your_mnemonic_will{
+        constexpr std::string_view id_your_pin_or_your_mnemonic_will{
             "id_your_pin_or_your_mnemonic_will"
         }; // Your PIN or your mnemonic will be required to access the wallet.
-        const std::string id_your_s_sent_to_s_has_been{
+        constexpr std::string_view id_your_s_sent_to_s_has_been{
             "id_your_s_sent_to_s_has_been"
         }; // Your %s sent to %s has been confirmed
-        const std::string id_your_transactions_will_be_shown{
+        constexpr std::string_view id_your_transactions_will_be_shown{
             "id_your_transactions_will_be_shown"
         }; // Your transactions will be shown here.
-        const std::string id_your_twofactor_threshold_is_s{
+        constexpr std::string_view id_your_twofactor_threshold_is_s{
             "id_your_twofactor_threshold_is_s"
         }; // Your Two-Factor threshold is %s.
-        const std::string id_your_wallet_backup_is_made_of{
+        constexpr std::string_view id_your_wallet_backup_is_made_of{
             "id_your_wallet_backup_is_made_of"
         }; // Your wallet backup is made of 24 words, also known as your mnemonic. Make sure you have a backup and keep
            // it safe. Anyone who finds it can steal your money. You can use it to restore your Blockstream Green wallet
            // on another device in case yours is lost, damaged or stolen.
-        const std::string id_your_wallet_is_locked_for_a{
+        constexpr std::string_view id_your_wallet_is_locked_for_a{
             "id_your_wallet_is_locked_for_a"
         }; // Your wallet is locked for a Two-Factor Authentication reset. The reset will be completed in %d days.
-        const std::string id_your_wallet_is_locked_under_2fa{
+        constexpr std::string_view id_your_wallet_is_locked_under_2fa{
             "id_your_wallet_is_locked_under_2fa"
         }; // Your wallet is locked under 2FA dispute.
-        const std::string id_your_wallet_is_not_yet_fully{
+        constexpr std::string_view id_your_wallet_is_not_yet_fully{
             "id_your_wallet_is_not_yet_fully"
         }; // Your wallet is not yet fully secured.\nPlease enable Two-Factor authentication.
-        const std::string id_your_watchonly_username_and{
+        constexpr std::string_view id_your_watchonly_username_and{
             "id_your_watchonly_username_and"
         }; // Your watch-only username and password will be stored un-encrypted on this device. If your device is
            // compromised third parties can get access to your transaction history. Press "OK" to continue.
-        const std::string id_youve_entered_an_invalid_pin{
+        constexpr std::string_view id_youve_entered_an_invalid_pin{
             "id_youve_entered_an_invalid_pin"
         }; // You\'ve entered an invalid PIN too many times.
 
@@ -484,7 +484,7 @@ namespace sdk {
             GDK_RUNTIME_ASSERT(tor_conf);
             const bool quiet = gdk_config()["log_level"] == "none";
             std::vector<const char*> argv_conf;
-            argv_conf.reserve(17);
+            argv_conf.reserve(19);
             argv_conf.push_back("tor");
             if (quiet) {
                 argv_conf.push_back("--quiet"); // Silence all log output
@@ -505,6 +505,10 @@ namespace sdk {
             argv_conf.push_back("auto");
             argv_conf.push_back("DataDirectory");
             argv_conf.push_back(m_tor_datadir.c_str());
+            // Tor persists whether it was dormant when it last exited. Always
+            // start active, so that bootstrapping begins immediately
+            argv_conf.push_back("DormantCanceledByStartup");
+            argv_conf.push_back("1");
 #if not defined(NDEBUG)
             if (!quiet) {
                 argv_conf.push_back("Log");
@@ -790,6 +794,18 @@ namespace sdk {
         return shared;
     }
 
+    void tor_controller::prebootstrap()
+    {
+        // Intentionally never released, to avoid destruction order issues at exit
+        static std::shared_ptr<tor_controller>* s_prebootstrapped = nullptr;
+        GDK_RUNTIME_ASSERT(!s_prebootstrapped);
+        s_prebootstrapped = new std::shared_ptr<tor_controller>();
+        // Starting Tor waits for its control port, so do it off the caller's thread
+        std::thread([] {
+            no_std_exception_escape([] { *s_prebootstrapped = get_shared_ref(); }, "tor prebootstrap");
+        }).detach();
+    }
+
     std::string tor_controller::wait_for_socks5(
         std::function<void(std::shared_ptr<tor_bootstrap_phase>)> phase_cb, uint32_t timeout)
     {
@@ -37,6 +37,12 @@ namespace sdk {
 
         static std::shared_ptr<tor_controller> get_shared_ref();
 
+        // Start the shared controller in the background and keep it running
+        // for the life of the process, so that Tor has bootstrapped by the
+        // time a session needs it, and stays warm between sessions.
+        // GA_init calls this when given "tor_prebootstrap" in its config.
+        static void prebootstrap();
+
         std::string wait_for_socks5(std::function<void(std::shared_ptr<tor_bootstrap_phase>)> phase_cb,
             uint32_t timeout = DEFAULT_TOR_SOCKS_WAIT);
 
@@ -2,16 +2,20 @@
 #include <array>
 #include <boost/algorithm/string/predicate.hpp>
 #include <ctime>
+#include <numeric>
 #include <string>
 #include <vector>
 
 #include "amount.hpp"
+#include "coin_selection.hpp"
 #include "exception.hpp"
 #include "ga_strings.hpp"
 #include "ga_tx.hpp"
 #include "logging.hpp"
 #include "session_impl.hpp"
 #include "signer.hpp"
+#include "threading.hpp"
+#include "trace.hpp"
 #include "transaction_utils.hpp"
 #include "utils.hpp"
 #include "xpub_hdkey.hpp"
@@ -25,8 +29,40 @@ namespace sdk {
         static const std::string UTXO_SEL_DEFAULT("default"); // Use the default utxo selection strategy
         static const std::string UTXO_SEL_MANUAL("manual"); // Use manual utxo selection
 
+        static const std::string COIN_SEL_DEFAULT("default"); // Select utxos in order until the amount is covered
+        static const std::string COIN_SEL_BNB("bnb"); // Prefer changeless Branch and Bound, else knapsack
+        static const std::string COIN_SEL_KNAPSACK("knapsack"); // Select the utxos closest to the amount
+
         static const std::string ZEROS(64, '0');
 
+        // Minimum number of inputs to sign per thread when signing in parallel
+        static constexpr size_t MIN_SIGNATURES_PER_THREAD = 16;
+        // Maximum number of threads to sign with
+        static constexpr size_t MAX_SIGNING_THREADS = 8;
+        // Minimum number of outputs to generate proofs for per thread when blinding
+        static constexpr size_t MIN_BLINDED_OUTPUTS_PER_THREAD = 1;
+        // Maximum number of threads to generate blinding proofs with
+        static constexpr size_t MAX_BLINDING_THREADS = 8;
+
+        // An output to blind, with the data needed to generate its proofs
+        struct blinded_output_t {
+            size_t index;
+            std::vector<unsigned char> asset_id;
+            std::vector<unsigned char> scriptpubkey;
+            std::vector<unsigned char> blinding_pubkey;
+            uint64_t value;
+            abf_t abf;
+            vbf_t vbf;
+            std::array<unsigned char, ASSET_GENERATOR_LEN> generator;
+            std::array<unsigned char, ASSET_COMMITMENT_LEN> value_commitment;
+            priv_key_t eph_private_key;
+            std::vector<unsigned char> eph_public_key;
+            std::array<unsigned char, 32> entropy;
+            bool needs_rangeproof;
+            std::vector<unsigned char> rangeproof;
+            std::vector<unsigned char> surjectionproof;
+        };
+
         static bool is_explicit(const wally_tx_output& output)
         {
             return output.asset_len == WALLY_TX_ASSET_CT_ASSET_LEN
@@ -140,23 +176,24 @@ namespace sdk {
             utxo["subtype"] = subtype;
         }
 
-        void randomise_inputs(const wally_tx_ptr& tx, std::vector<nlohmann::json>& used_utxos)
+        void randomise_inputs(const wally_tx_ptr& tx, utxo_set& used_utxos)
         {
-            std::vector<nlohmann::json> unshuffled_utxos(used_utxos.begin(), used_utxos.end());
-            std::shuffle(used_utxos.begin(), used_utxos.end(), uniform_uint32_rng());
+            std::vector<size_t> new_order(used_utxos.size());
+            std::iota(new_order.begin(), new_order.end(), 0);
+            std::shuffle(new_order.begin(), new_order.end(), uniform_uint32_rng());
 
             // Update inputs in our created transaction to match the new random order
-            std::map<nlohmann::json, size_t> new_position_of;
-            for (size_t i = 0; i < used_utxos.size(); ++i) {
-                new_position_of.emplace(used_utxos[i], i);
-            }
             wally_tx_input* in_p = tx->inputs + (tx->num_inputs - used_utxos.size());
             std::vector<wally_tx_input> reordered_inputs(used_utxos.size());
-            for (size_t i = 0; i < unshuffled_utxos.size(); ++i) {
-                const size_t new_position = new_position_of[unshuffled_utxos[i]];
-                reordered_inputs[new_position] = in_p[i];
+            utxo_set reordered_utxos;
+            reordered_utxos.reserve(used_utxos.size());
+            for (size_t i = 0; i < new_order.size(); ++i) {
+                reordered_inputs[i] = in_p[new_order[i]];
+                reordered_utxos.coins.push_back(used_utxos.coins[new_order[i]]);
+                reordered_utxos.utxos.push_back(used_utxos.utxos[new_order[i]]);
             }
             std::copy(reordered_inputs.begin(), reordered_inputs.end(), in_p);
+            used_utxos = std::move(reordered_utxos);
         }
 
         // Check if a tx to bump is present, and if so add the details required to bump it
@@ -439,13 +476,51 @@ namespace sdk {
             result["change_index"][asset_id] = change_index;
         }
 
+        // Return the order in which to add asset_utxos to a tx, with the utxos
+        // chosen by the coin selection algorithm first. num_selected is set
+        // to the number of chosen utxos, or 0 to add them in order as needed.
+        static std::vector<size_t> get_coin_selection_order(const std::string& coin_selection,
+            const utxo_set& asset_utxos, amount target, amount dust_threshold, amount fee_rate, size_t& num_selected)
+        {
+            std::vector<size_t> order(asset_utxos.size());
+            std::iota(order.begin(), order.end(), 0);
+            num_selected = 0;
+            if (coin_selection == COIN_SEL_DEFAULT || target == 0) {
+                return order;
+            }
+
+            std::vector<size_t> selected;
+            if (coin_selection == COIN_SEL_BNB) {
+                // Any excess below the dust threshold is donated to the fee
+                // rather than creating a change output
+                const auto cost_of_change = dust_threshold.value() ? dust_threshold.value() - 1 : 0;
+                selected = select_coins_bnb(asset_utxos.coins, target.value(), cost_of_change, fee_rate.value());
+            }
+            if (selected.empty()) {
+                selected = select_coins_knapsack(asset_utxos.coins, target.value(), fee_rate.value());
+            }
+            if (selected.empty()) {
+                return order; // Insufficient funds, let the caller report it
+            }
+
+            // Move the selected utxos to the front, keeping the others in order
+            std::vector<bool> is_selected(order.size());
+            for (const auto i : selected) {
+                is_selected[i] = true;
+            }
+            std::stable_partition(order.begin(), order.end(), [&is_selected](size_t i) { return is_selected[i]; });
+            num_selected = selected.size();
+            return order;
+        }
+
         static amount create_tx_outputs(const std::string& asset_id, const std::string& policy_asset, bool is_partial,
             bool is_rbf, nlohmann::json& result, nlohmann::json::iterator addressees_p,
             std::vector<size_t>& reordered_addressees, session_impl& session, wally_tx_ptr& tx,
-            const std::set<std::string>& asset_ids, std::vector<nlohmann::json>& used_utxos)
+            const std::set<std::string>& asset_ids, utxo_set& used_utxos)
         {
-            std::vector<nlohmann::json> current_used_utxos;
+            utxo_set current_used_utxos;
             amount available_total, total, fee, v;
+            tx_weight_tracker weight_tracker;
 
             if (is_rbf) {
                 // Add all the old utxos. Note we don't add them to used_utxos
@@ -489,7 +564,21 @@ namespace sdk {
             const bool manual_selection = strategy == UTXO_SEL_MANUAL;
             const bool is_liquid = net_params.is_liquid();
             const bool send_all = json_add_if_missing(result, "send_all", false);
+            const std::string coin_selection = result.at("coin_selection");
+            utxo_set asset_utxos; // Candidate utxos for non-manual selection
+            std::vector<size_t> coin_selection_order; // Order to add asset_utxos in
+            size_t num_selected = 0; // Number of utxos chosen by coin selection
             auto& utxos = result.at("utxos");
+
+            if (result.find("fee_rate") == result.end()) {
+                result["fee_rate"] = session.get_default_fee_rate().value();
+            }
+            const amount dust_threshold = session.get_dust_threshold(asset_id);
+            const amount user_fee_rate = amount(result.at("fee_rate"));
+            const amount min_fee_rate = session.get_min_fee_rate();
+            const amount network_fee = amount(json_get_value(result, "network_fee", 0u));
+            const bool include_fee = asset_id == policy_asset && !is_partial;
+
             // TODO: filter per asset or assume always single asset
             if (manual_selection) {
                 // Add all selected utxos
@@ -508,24 +597,43 @@ namespace sdk {
                     }
                     available_total += v;
                     total += v;
-                    current_used_utxos.emplace_back(utxo);
+                    current_used_utxos.add(utxo);
                 }
             } else {
-                // Collect utxos in order until we have covered the amount to send
-                // FIXME: Better coin selection algorithms (esp. minimum size)
+                // Collect utxos in coin selection order until we have covered the amount to send
                 const auto asset_utxos_p = utxos.find(asset_id);
                 if (asset_utxos_p == utxos.end()) {
                     if (!is_rbf) {
                         set_tx_error(result, res::id_insufficient_funds); // Insufficient funds
                     }
                 } else {
-                    for (auto& utxo : utxos.at(asset_id)) {
-                        if (send_all || total < required_total) {
-                            v = add_utxo(session, tx, utxo);
+                    asset_utxos.reserve(asset_utxos_p->size());
+                    for (auto& utxo : *asset_utxos_p) {
+                        asset_utxos.add(utxo);
+                    }
+                    if (!send_all) {
+                        // Select enough to cover the amount and the fee for the tx without change
+                        amount target = required_total;
+                        if (include_fee) {
+                            target += get_tx_fee(net_params, tx, min_fee_rate, user_fee_rate, &weight_tracker);
+                            target += network_fee;
+                        }
+                        target = target > total ? target - total : amount();
+                        const amount fee_rate = user_fee_rate < min_fee_rate ? min_fee_rate : user_fee_rate;
+                        coin_selection_order = get_coin_selection_order(
+                            coin_selection, asset_utxos, target, dust_threshold, fee_rate, num_selected);
+                    } else {
+                        coin_selection_order.resize(asset_utxos.size());
+                        std::iota(coin_selection_order.begin(), coin_selection_order.end(), 0);
+                    }
+                    for (size_t i = 0; i < coin_selection_order.size(); ++i) {
+                        const size_t index = coin_selection_order[i];
+                        if (send_all || (num_selected ? i < num_selected : total < required_total)) {
+                            v = add_utxo(session, tx, *asset_utxos.utxos[index]);
                             total += v;
-                            current_used_utxos.emplace_back(utxo);
+                            current_used_utxos.add(*asset_utxos.utxos[index]);
                         } else {
-                            v = static_cast<amount::value_type>(utxo.at("satoshi"));
+                            v = asset_utxos.coins[index].satoshi;
                         }
                         available_total += v;
                     }
@@ -547,14 +655,6 @@ namespace sdk {
                 }
             }
 
-            if (result.find("fee_rate") == result.end()) {
-                result["fee_rate"] = session.get_default_fee_rate().value();
-            }
-            const amount dust_threshold = session.get_dust_threshold(asset_id);
-            const amount user_fee_rate = amount(result.at("fee_rate"));
-            const amount min_fee_rate = session.get_min_fee_rate();
-            const amount network_fee = amount(json_get_value(result, "network_fee", 0u));
-
             bool force_add_utxo = false;
 
             if (!is_partial) {
@@ -576,7 +676,6 @@ namespace sdk {
                 }
             }
 
-            const bool include_fee = asset_id == policy_asset && !is_partial;
             const size_t max_loop_iterations = std::max(size_t(8), utxos.size() * 2 + 1); // +1 in case empty+send all
             size_t loop_iterations;
             const size_t num_addressees = addressees_p->size();
@@ -596,12 +695,12 @@ namespace sdk {
                         }
                         if (!manual_selection) {
                             auto& used = result["used_utxos"];
-                            for (auto& current : current_used_utxos) {
-                                used.push_back(current);
+                            for (const auto* current : current_used_utxos.utxos) {
+                                used.push_back(*current);
                             }
                         }
                     }
-                    fee = get_tx_fee(net_params, tx, min_fee_rate, user_fee_rate);
+                    fee = get_tx_fee(net_params, tx, min_fee_rate, user_fee_rate, &weight_tracker);
                     fee += network_fee;
                 }
 
@@ -632,17 +731,15 @@ namespace sdk {
                     // We don't have enough funds to cover the fee yet, or we
                     // need to add more to avoid a dusty change output
                     force_add_utxo = false;
-                    if (manual_selection || !utxos.contains(asset_id) || utxos.at(asset_id).size() == 0
-                        || current_used_utxos.size() == utxos.at(asset_id).size()) {
+                    if (manual_selection || asset_utxos.empty() || current_used_utxos.size() == asset_utxos.size()) {
                         // Used all inputs and do not have enough funds
                         set_tx_error(result, res::id_insufficient_funds); // Insufficient funds
                         goto leave_loop;
                     }
 
-                    // FIXME: Use our strategy here when non-default implemented
-                    auto& utxo = utxos.at(asset_id).at(current_used_utxos.size());
+                    auto& utxo = *asset_utxos.utxos.at(coin_selection_order.at(current_used_utxos.size()));
                     total += add_utxo(session, tx, utxo);
-                    current_used_utxos.emplace_back(utxo);
+                    current_used_utxos.add(utxo);
                     continue;
                 }
 
@@ -689,7 +786,7 @@ namespace sdk {
             }
 
             if (!manual_selection) {
-                used_utxos.insert(used_utxos.end(), std::begin(current_used_utxos), std::end(current_used_utxos));
+                used_utxos.append(current_used_utxos);
             }
 
             if (loop_iterations >= max_loop_iterations) {
@@ -711,7 +808,7 @@ namespace sdk {
             }
 
             if (!manual_selection) {
-                result["used_utxos"] = used_utxos;
+                result["used_utxos"] = used_utxos.to_json();
             }
             result["satoshi"][asset_id] = required_total.value();
             return fee;
@@ -719,6 +816,7 @@ namespace sdk {
 
         static void create_ga_transaction_impl(session_impl& session, nlohmann::json& result)
         {
+            GDK_TRACE_SPAN("create_ga_transaction_impl");
             const auto& net_params = session.get_network_parameters();
             const bool is_liquid = net_params.is_liquid();
             const auto policy_asset = net_params.get_policy_asset();
@@ -805,6 +903,11 @@ namespace sdk {
             const std::string strategy = json_add_if_missing(result, "utxo_strategy", UTXO_SEL_DEFAULT);
             const bool manual_selection = strategy == UTXO_SEL_MANUAL;
             GDK_RUNTIME_ASSERT(strategy == UTXO_SEL_DEFAULT || manual_selection);
+            const std::string coin_selection = json_add_if_missing(result, "coin_selection", COIN_SEL_DEFAULT);
+            if (coin_selection != COIN_SEL_DEFAULT && coin_selection != COIN_SEL_BNB
+                && coin_selection != COIN_SEL_KNAPSACK) {
+                throw user_error("invalid \"coin_selection\" value");
+            }
             if (is_partial) {
                 GDK_RUNTIME_ASSERT(manual_selection);
             }
@@ -835,18 +938,20 @@ namespace sdk {
                 set_anti_snipe_locktime(tx, current_block_height);
             }
 
-            std::vector<nlohmann::json> used_utxos;
+            utxo_set used_utxos;
             used_utxos.reserve(utxos.size());
 
-            std::set<std::string> asset_ids;
-            for (auto& addressee : *addressees_p) {
-                if (auto error = validate_tx_addressee(session, addressee); !error.empty()) {
-                    set_tx_error(result, error);
-                    if (!result.contains("used_utxos")) {
-                        result.emplace("used_utxos", std::vector<nlohmann::json>());
-                    }
-                    return;
+            const auto errors = validate_tx_addressees(session, *addressees_p);
+            const auto error_p = std::find_if(errors.begin(), errors.end(), [](const auto& e) { return !e.empty(); });
+            if (error_p != errors.end()) {
+                set_tx_error(result, *error_p);
+                if (!result.contains("used_utxos")) {
+                    result.emplace("used_utxos", std::vector<nlohmann::json>());
                 }
+                return;
+            }
+            std::set<std::string> asset_ids;
+            for (const auto& addressee : *addressees_p) {
                 asset_ids.emplace(asset_id_from_json(net_params, addressee));
             }
 
@@ -902,27 +1007,101 @@ namespace sdk {
             }
         }
 
-        static std::string sign_input(
-            session_impl& session, const wally_tx_ptr& tx, uint32_t index, const nlohmann::json& u, uint32_t sighash)
+        // BIP143 hashes shared by the signature hashes of all inputs of a tx
+        struct bip143_hashes_t {
+            std::array<unsigned char, SHA256_LEN> prevouts;
+            std::array<unsigned char, SHA256_LEN> sequences;
+            std::array<unsigned char, SHA256_LEN> outputs;
+        };
+
+        static void push_le(std::vector<unsigned char>& buff, uint64_t v, size_t num_bytes)
         {
-            const auto& net_params = session.get_network_parameters();
-            const auto script_hash = get_script_hash(net_params, u, tx, index, sighash);
-            const std::string private_key_hex = json_get_value(u, "private_key");
+            for (size_t i = 0; i < num_bytes; ++i) {
+                buff.push_back(static_cast<unsigned char>((v >> (i * 8)) & 0xff));
+            }
+        }
+
+        static void push_varbuff(std::vector<unsigned char>& buff, byte_span_t data)
+        {
+            const uint64_t n = data.size();
+            if (n < 0xfd) {
+                push_le(buff, n, 1);
+            } else if (n <= 0xffff) {
+                buff.push_back(0xfd);
+                push_le(buff, n, 2);
+            } else if (n <= 0xffffffff) {
+                buff.push_back(0xfe);
+                push_le(buff, n, 4);
+            } else {
+                buff.push_back(0xff);
+                push_le(buff, n, 8);
+            }
+            buff.insert(buff.end(), data.begin(), data.end());
+        }
+
+        static bip143_hashes_t get_bip143_hashes(const wally_tx_ptr& tx)
+        {
+            std::vector<unsigned char> prevouts, sequences, outputs;
+            prevouts.reserve(tx->num_inputs * (WALLY_TXHASH_LEN + sizeof(uint32_t)));
+            sequences.reserve(tx->num_inputs * sizeof(uint32_t));
+            for (size_t i = 0; i < tx->num_inputs; ++i) {
+                const auto& input = tx->inputs[i];
+                prevouts.insert(prevouts.end(), std::begin(input.txhash), std::end(input.txhash));
+                push_le(prevouts, input.index, sizeof(uint32_t));
+                push_le(sequences, input.sequence, sizeof(uint32_t));
+            }
+            for (size_t i = 0; i < tx->num_outputs; ++i) {
+                const auto& output = tx->outputs[i];
+                push_le(outputs, output.satoshi, sizeof(uint64_t));
+                push_varbuff(outputs, gsl::make_span(output.script, output.script_len));
+            }
+            return { sha256d(prevouts), sha256d(sequences), sha256d(outputs) };
+        }
+
+        // Compute a BIP143 SIGHASH_ALL signature hash from pre-computed hashes
+        static std::array<unsigned char, SHA256_LEN> get_bip143_signature_hash(const wally_tx_ptr& tx,
+            const bip143_hashes_t& hashes, size_t index, byte_span_t script, amount::value_type satoshi)
+        {
+            const auto& input = tx->inputs[index];
+            std::vector<unsigned char> preimage;
+            preimage.reserve(156 + 9 + script.size()); // Fixed size fields, max script length prefix, script
+            push_le(preimage, tx->version, sizeof(uint32_t));
+            preimage.insert(preimage.end(), hashes.prevouts.begin(), hashes.prevouts.end());
+            preimage.insert(preimage.end(), hashes.sequences.begin(), hashes.sequences.end());
+            preimage.insert(preimage.end(), std::begin(input.txhash), std::end(input.txhash));
+            push_le(preimage, input.index, sizeof(uint32_t));
+            push_varbuff(preimage, script);
+            push_le(preimage, satoshi, sizeof(uint64_t));
+            push_le(preimage, input.sequence, sizeof(uint32_t));
+            preimage.insert(preimage.end(), hashes.outputs.begin(), hashes.outputs.end());
+            push_le(preimage, tx->locktime, sizeof(uint32_t));
+            push_le(preimage, WALLY_SIGHASH_ALL, sizeof(uint32_t));
+            return sha256d(preimage);
+        }
+
+        // As get_script_hash, using bip143_hashes for BTC segwit SIGHASH_ALL inputs if given
+        static std::array<unsigned char, SHA256_LEN> get_signing_hash(const network_parameters& net_params,
+            const nlohmann::json& utxo, const wally_tx_ptr& tx, size_t index, uint32_t sighash,
+            const bip143_hashes_t* bip143_hashes)
+        {
+            if (bip143_hashes && sighash == WALLY_SIGHASH_ALL && is_segwit_address_type(utxo)) {
+                const amount::value_type satoshi = utxo.at("satoshi");
+                const auto script = h2b(utxo.at("prevout_script"));
+                return get_bip143_signature_hash(tx, *bip143_hashes, index, script, satoshi);
+            }
+            return get_script_hash(net_params, utxo, tx, index, sighash);
+        }
+
+        static std::string set_input_signature(const wally_tx_ptr& tx, uint32_t index, const nlohmann::json& u,
+            const ecdsa_sig_t& user_sig, uint32_t sighash, bool is_low_r)
+        {
+            const auto der = ec_sig_to_der(user_sig, sighash);
 
-            if (!private_key_hex.empty()) {
-                const auto user_sig = ec_sig_from_bytes(h2b(private_key_hex), script_hash);
-                const auto der = ec_sig_to_der(user_sig, sighash);
+            if (!json_get_value(u, "private_key").empty()) {
                 tx_set_input_script(tx, index, scriptsig_p2pkh_from_der(h2b(u.at("public_key")), der));
                 return b2h(der);
             } else {
                 const auto script = h2b(u.at("prevout_script"));
-                const uint32_t subaccount = json_get_value(u, "subaccount", 0u);
-                const uint32_t pointer = json_get_value(u, "pointer", 0u);
-                const bool is_internal = json_get_value(u, "is_internal", false);
-                const auto path = session.get_subaccount_full_path(subaccount, pointer, is_internal);
-                auto signer = session.get_nonnull_signer();
-                const auto user_sig = signer->sign_hash(path, script_hash);
-                const auto der = ec_sig_to_der(user_sig, sighash);
 
                 if (is_segwit_address_type(u)) {
                     // TODO: If the UTXO is CSV and expired, spend it using the users key only (smaller)
@@ -933,7 +1112,6 @@ namespace sdk {
                     const uint32_t witness_ver = 0;
                     tx_set_input_script(tx, index, witness_script(script, witness_ver));
                 } else {
-                    const bool is_low_r = signer->supports_low_r();
                     tx_set_input_script(tx, index, input_script(is_low_r, script, user_sig, sighash));
                 }
                 return b2h(der);
@@ -1104,16 +1282,61 @@ namespace sdk {
     std::pair<std::vector<std::string>, wally_tx_ptr> sign_ga_transaction(
         session_impl& session, const nlohmann::json& details, const std::vector<nlohmann::json>& inputs)
     {
-        const bool is_liquid = session.get_network_parameters().is_liquid();
+        const auto& net_params = session.get_network_parameters();
+        const bool is_liquid = net_params.is_liquid();
         wally_tx_ptr tx = tx_from_hex(details.at("transaction"), tx_flags(is_liquid));
         std::vector<std::string> sigs(inputs.size());
 
+        // Collect the inputs to sign along with their sighashes and key paths
+        std::vector<size_t> to_sign;
+        std::vector<uint32_t> sighashes(inputs.size());
+        std::vector<std::vector<uint32_t>> paths(inputs.size());
+        std::shared_ptr<signer> signer;
         for (size_t i = 0; i < inputs.size(); ++i) {
             const auto& utxo = inputs.at(i);
             if (!utxo.value("skip_signing", false)) {
-                uint32_t sighash = json_get_value(utxo, "user_sighash", WALLY_SIGHASH_ALL);
-                sigs[i] = sign_input(session, tx, i, utxo, sighash);
+                to_sign.push_back(i);
+                sighashes[i] = json_get_value(utxo, "user_sighash", WALLY_SIGHASH_ALL);
+                if (json_get_value(utxo, "private_key").empty()) {
+                    const uint32_t subaccount = json_get_value(utxo, "subaccount", 0u);
+                    const uint32_t pointer = json_get_value(utxo, "pointer", 0u);
+                    const bool is_internal = json_get_value(utxo, "is_internal", false);
+                    paths[i] = session.get_subaccount_full_path(subaccount, pointer, is_internal);
+                    if (!signer) {
+                        signer = session.get_nonnull_signer();
+                    }
+                }
+            }
+        }
+
+        // Compute the BIP143 hashes common to all segwit inputs once
+        std::optional<bip143_hashes_t> bip143_hashes;
+        if (!is_liquid && to_sign.size() > 1) {
+            bip143_hashes = get_bip143_hashes(tx);
+        }
+        const bip143_hashes_t* bip143_hashes_p = bip143_hashes ? &*bip143_hashes : nullptr;
+
+        // Compute signatures in parallel. This only reads from tx, since
+        // signature hashes do not commit to other input's scripts/witnesses.
+        std::vector<ecdsa_sig_t> user_sigs(inputs.size());
+        parallel_for_chunks(to_sign.size(), MIN_SIGNATURES_PER_THREAD, MAX_SIGNING_THREADS, [&](size_t b, size_t e) {
+            for (size_t n = b; n < e; ++n) {
+                const size_t i = to_sign[n];
+                const auto& utxo = inputs[i];
+                const auto hash = get_signing_hash(net_params, utxo, tx, i, sighashes[i], bip143_hashes_p);
+                const std::string private_key_hex = json_get_value(utxo, "private_key");
+                if (!private_key_hex.empty()) {
+                    user_sigs[i] = ec_sig_from_bytes(h2b(private_key_hex), hash);
+                } else {
+                    user_sigs[i] = signer->sign_hash(paths[i], hash);
+                }
             }
+        });
+
+        // Set the signatures into the tx
+        const bool is_low_r = signer && signer->supports_low_r();
+        for (const auto i : to_sign) {
+            sigs[i] = set_input_signature(tx, i, inputs[i], user_sigs[i], sighashes[i], is_low_r);
         }
         return std::make_pair(sigs, std::move(tx));
     }
@@ -1246,13 +1469,15 @@ namespace sdk {
         if (blinding_nonces_required) {
             blinding_nonces.reserve(transaction_outputs.size());
         }
+        std::vector<blinded_output_t> to_blind;
+        to_blind.reserve(transaction_outputs.size());
 
         for (size_t i = 0; i < transaction_outputs.size(); ++i) {
             auto& output = transaction_outputs[i];
             if (output.value("is_fee", false)) {
                 continue;
             }
-            const auto asset_id = h2b_rev(output.at("asset_id"));
+            auto asset_id = h2b_rev(output.at("asset_id"));
             const uint64_t value = output.at("satoshi");
 
             // If an output has a vbf, it contributes to the final vbf calculation.
@@ -1324,24 +1549,25 @@ namespace sdk {
             }
 
             const auto& o = tx->outputs[i];
-            const auto generator = asset_generator_from_bytes(asset_id, abf);
-            std::array<unsigned char, 33> value_commitment;
+            blinded_output_t b;
+            b.index = i;
+            b.value = value;
+            b.abf = abf;
+            b.vbf = vbf;
+            b.generator = asset_generator_from_bytes(asset_id, abf);
             if (for_final_vbf) {
-                value_commitment = asset_value_commitment(value, vbf, generator);
+                b.value_commitment = asset_value_commitment(value, vbf, b.generator);
             } else {
-                std::copy(o.value, o.value + o.value_len, value_commitment.begin());
+                std::copy(o.value, o.value + o.value_len, b.value_commitment.begin());
             }
+            b.scriptpubkey = h2b(output.at("scriptpubkey"));
 
-            const auto scriptpubkey = h2b(output.at("scriptpubkey"));
-
-            std::vector<unsigned char> eph_public_key;
-            std::vector<unsigned char> rangeproof;
-
-            if (is_blinded(o) && !memcmp(o.asset, generator.data(), o.asset_len)
-                && !memcmp(o.value, value_commitment.data(), o.value_len)) {
+            b.needs_rangeproof = !is_blinded(o) || memcmp(o.asset, b.generator.data(), o.asset_len)
+                || memcmp(o.value, b.value_commitment.data(), o.value_len);
+            if (!b.needs_rangeproof) {
                 // Rangeproof already created for the same commitments
-                eph_public_key.assign(o.nonce, o.nonce + o.nonce_len);
-                rangeproof.assign(o.rangeproof, o.rangeproof + o.rangeproof_len);
+                b.eph_public_key.assign(o.nonce, o.nonce + o.nonce_len);
+                b.rangeproof.assign(o.rangeproof, o.rangeproof + o.rangeproof_len);
                 if (blinding_nonces_required) {
                     // Add the pre-blinded outputs blinding nonce
                     GDK_RUNTIME_ASSERT(output.contains("blinding_nonce"));
@@ -1349,30 +1575,43 @@ namespace sdk {
                 }
             } else {
                 GDK_RUNTIME_ASSERT(!output.contains("nonce_commitment"));
-                priv_key_t eph_private_key;
-                std::tie(eph_private_key, eph_public_key) = get_ephemeral_keypair();
-                output["eph_public_key"] = b2h(eph_public_key);
-                const auto blinding_pubkey = h2b(output.at("blinding_key"));
+                std::tie(b.eph_private_key, b.eph_public_key) = get_ephemeral_keypair();
+                output["eph_public_key"] = b2h(b.eph_public_key);
+                b.blinding_pubkey = h2b(output.at("blinding_key"));
                 GDK_RUNTIME_ASSERT(!output.contains("blinding_nonce"));
                 if (blinding_nonces_required) {
                     // Generate the blinding nonce for the caller
-                    const auto nonce = sha256(ecdh(blinding_pubkey, eph_private_key));
+                    const auto nonce = sha256(ecdh(b.blinding_pubkey, b.eph_private_key));
                     blinding_nonces.emplace_back(b2h(nonce));
                 }
-
-                rangeproof = asset_rangeproof(value, blinding_pubkey, eph_private_key, asset_id, abf, vbf,
-                    value_commitment, scriptpubkey, generator);
             }
-
-            std::vector<unsigned char> surjectionproof;
             if (!is_partial) {
-                const auto entropy = get_random_bytes<32>();
-                surjectionproof
-                    = asset_surjectionproof(asset_id, abf, generator, entropy, assets, all_abfs, generators);
+                b.entropy = get_random_bytes<32>();
             }
+            b.asset_id = std::move(asset_id);
+            to_blind.emplace_back(std::move(b));
+        }
+
+        // Now that the blinders are fixed, generate the proofs in parallel.
+        // This only reads the shared input data and writes to each output
+        parallel_for_chunks(
+            to_blind.size(), MIN_BLINDED_OUTPUTS_PER_THREAD, MAX_BLINDING_THREADS, [&](size_t begin, size_t end) {
+                for (size_t n = begin; n < end; ++n) {
+                    auto& b = to_blind[n];
+                    if (b.needs_rangeproof) {
+                        b.rangeproof = asset_rangeproof(b.value, b.blinding_pubkey, b.eph_private_key, b.asset_id,
+                            b.abf, b.vbf, b.value_commitment, b.scriptpubkey, b.generator);
+                    }
+                    if (!is_partial) {
+                        b.surjectionproof = asset_surjectionproof(
+                            b.asset_id, b.abf, b.generator, b.entropy, assets, all_abfs, generators);
+                    }
+                }
+            });
 
+        for (const auto& b : to_blind) {
             tx_elements_output_commitment_set(
-                tx, i, generator, value_commitment, eph_public_key, surjectionproof, rangeproof);
+                tx, b.index, b.generator, b.value_commitment, b.eph_public_key, b.surjectionproof, b.rangeproof);
         }
 
         details["is_blinded"] = true;
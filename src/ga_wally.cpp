@@ -1,5 +1,11 @@
 #include <boost/algorithm/string/predicate.hpp>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "exception.hpp"
 #include "ga_strings.hpp"
 #include "ga_wally.hpp"
@@ -16,6 +22,173 @@
 namespace ga {
 namespace sdk {
 
+    namespace {
+        constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+        // Returns the value of a hex digit, or 0xff if c is not a hex digit
+        inline unsigned char hex_nibble(unsigned char c)
+        {
+            if (c - '0' < 10u) {
+                return c - '0';
+            }
+            c |= 0x20; // Lowercase
+            if (c - 'a' < 6u) {
+                return c - 'a' + 10;
+            }
+            return 0xff;
+        }
+
+        // The SIMD kernels process whole blocks of 16 bytes and return the number
+        // of bytes/chars processed, leaving any remainder to the scalar code.
+        // Decoding stops at the first block containing a non-hex char so that
+        // the scalar code can report it.
+#if defined(__SSE2__)
+        inline __m128i hex_encode_nibbles(__m128i n)
+        {
+            const __m128i digits = _mm_add_epi8(n, _mm_set1_epi8('0'));
+            const __m128i is_alpha = _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+            return _mm_add_epi8(digits, _mm_and_si128(is_alpha, _mm_set1_epi8('a' - '0' - 10)));
+        }
+
+        inline __m128i reverse_bytes(__m128i v)
+        {
+            v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+            v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        }
+
+        inline __m128i hex_decode_nibbles(__m128i c, __m128i& valid)
+        {
+            const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+            const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+            const __m128i alpha = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            const __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+            valid = _mm_and_si128(valid, _mm_or_si128(is_digit, is_alpha));
+            const __m128i alpha_value = _mm_add_epi8(alpha, _mm_set1_epi8(10));
+            return _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_alpha, alpha_value));
+        }
+
+        size_t hex_encode_simd(const unsigned char* src, size_t len, char* dst, bool rev)
+        {
+            const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+            size_t i = 0;
+            for (; i + 16 <= len; i += 16) {
+                __m128i v;
+                if (rev) {
+                    v = reverse_bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + len - i - 16)));
+                } else {
+                    v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                }
+                const __m128i hi = hex_encode_nibbles(_mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask));
+                const __m128i lo = hex_encode_nibbles(_mm_and_si128(v, nibble_mask));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_unpacklo_epi8(hi, lo));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+            }
+            return i;
+        }
+
+        size_t hex_decode_simd(const char* src, size_t len, unsigned char* dst)
+        {
+            const __m128i low_byte = _mm_set1_epi16(0x00ff);
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32) {
+                __m128i valid = _mm_set1_epi8(-1);
+                const __m128i a = hex_decode_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), valid);
+                const __m128i b
+                    = hex_decode_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)), valid);
+                if (_mm_movemask_epi8(valid) != 0xffff) {
+                    break;
+                }
+                // Each 16 bit lane holds a high nibble in its low byte
+                const __m128i a16 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(a, low_byte), 4), _mm_srli_epi16(a, 8));
+                const __m128i b16 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b, low_byte), 4), _mm_srli_epi16(b, 8));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i / 2), _mm_packus_epi16(a16, b16));
+            }
+            return i;
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        inline uint8x16_t hex_encode_nibbles(uint8x16_t n)
+        {
+            const uint8x16_t digits = vaddq_u8(n, vdupq_n_u8('0'));
+            const uint8x16_t is_alpha = vcgtq_u8(n, vdupq_n_u8(9));
+            return vaddq_u8(digits, vandq_u8(is_alpha, vdupq_n_u8('a' - '0' - 10)));
+        }
+
+        inline uint8x16_t hex_decode_nibbles(uint8x16_t c, uint8x16_t& valid)
+        {
+            const uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+            const uint8x16_t is_digit = vcleq_u8(digit, vdupq_n_u8(9));
+            const uint8x16_t alpha = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+            const uint8x16_t is_alpha = vcleq_u8(alpha, vdupq_n_u8(5));
+            valid = vandq_u8(valid, vorrq_u8(is_digit, is_alpha));
+            const uint8x16_t alpha_value = vaddq_u8(alpha, vdupq_n_u8(10));
+            return vorrq_u8(vandq_u8(is_digit, digit), vandq_u8(is_alpha, alpha_value));
+        }
+
+        size_t hex_encode_simd(const unsigned char* src, size_t len, char* dst, bool rev)
+        {
+            size_t i = 0;
+            for (; i + 16 <= len; i += 16) {
+                uint8x16_t v;
+                if (rev) {
+                    v = vrev64q_u8(vld1q_u8(src + len - i - 16));
+                    v = vextq_u8(v, v, 8);
+                } else {
+                    v = vld1q_u8(src + i);
+                }
+                uint8x16x2_t out;
+                out.val[0] = hex_encode_nibbles(vshrq_n_u8(v, 4));
+                out.val[1] = hex_encode_nibbles(vandq_u8(v, vdupq_n_u8(0x0f)));
+                vst2q_u8(reinterpret_cast<uint8_t*>(dst + i * 2), out);
+            }
+            return i;
+        }
+
+        size_t hex_decode_simd(const char* src, size_t len, unsigned char* dst)
+        {
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32) {
+                // Loads even (high nibble) chars into val[0], odd into val[1]
+                const uint8x16x2_t in = vld2q_u8(reinterpret_cast<const uint8_t*>(src + i));
+                uint8x16_t valid = vdupq_n_u8(0xff);
+                const uint8x16_t hi = hex_decode_nibbles(in.val[0], valid);
+                const uint8x16_t lo = hex_decode_nibbles(in.val[1], valid);
+                if (vminvq_u8(valid) != 0xff) {
+                    break;
+                }
+                vst1q_u8(dst + i / 2, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+            }
+            return i;
+        }
+#else
+        size_t hex_encode_simd(const unsigned char*, size_t, char*, bool) { return 0; }
+        size_t hex_decode_simd(const char*, size_t, unsigned char*) { return 0; }
+#endif
+
+        void hex_encode(const unsigned char* src, size_t len, char* dst, bool rev)
+        {
+            for (size_t i = hex_encode_simd(src, len, dst, rev); i < len; ++i) {
+                const unsigned char b = rev ? src[len - 1 - i] : src[i];
+                dst[i * 2] = HEX_DIGITS[b >> 4];
+                dst[i * 2 + 1] = HEX_DIGITS[b & 0xf];
+            }
+        }
+
+        void hex_decode(const char* src, size_t len, unsigned char* dst, bool rev)
+        {
+            GDK_RUNTIME_ASSERT(len % 2 == 0);
+            for (size_t i = hex_decode_simd(src, len, dst); i < len; i += 2) {
+                const unsigned char hi = hex_nibble(src[i]), lo = hex_nibble(src[i + 1]);
+                GDK_RUNTIME_ASSERT(hi != 0xff && lo != 0xff);
+                dst[i / 2] = (hi << 4) | lo;
+            }
+            if (rev) {
+                std::reverse(dst, dst + len / 2);
+            }
+        }
+    } // namespace
+
     std::array<unsigned char, HASH160_LEN> hash160(byte_span_t data)
     {
         std::array<unsigned char, HASH160_LEN> ret;
@@ -420,31 +593,36 @@ namespace sdk {
     //
     std::string b2h(byte_span_t data)
     {
-        char* ret;
-        GDK_VERIFY(wally_hex_from_bytes(data.data(), data.size(), &ret));
-        return make_string(ret);
+        std::string ret(data.size() * 2, '\0');
+        hex_encode(data.data(), data.size(), &ret[0], false);
+        return ret;
     }
 
     std::string b2h_rev(byte_span_t data)
     {
-        char* ret;
-        std::vector<unsigned char> buff(data.rbegin(), data.rend());
-        GDK_VERIFY(wally_hex_from_bytes(buff.data(), buff.size(), &ret));
-        return make_string(ret);
+        std::string ret(data.size() * 2, '\0');
+        hex_encode(data.data(), data.size(), &ret[0], true);
+        return ret;
+    }
+
+    void b2h(byte_span_t data, gsl::span<char> output)
+    {
+        GDK_RUNTIME_ASSERT(static_cast<size_t>(output.size()) >= data.size() * 2);
+        hex_encode(data.data(), data.size(), output.data(), false);
+    }
+
+    void b2h_rev(byte_span_t data, gsl::span<char> output)
+    {
+        GDK_RUNTIME_ASSERT(static_cast<size_t>(output.size()) >= data.size() * 2);
+        hex_encode(data.data(), data.size(), output.data(), true);
     }
 
     static auto h2b(const char* hex, size_t siz, bool rev, uint8_t prefix = 0)
     {
         GDK_RUNTIME_ASSERT(hex != nullptr && siz != 0);
-        size_t written;
-        const size_t bytes_siz = siz / 2;
-        std::vector<unsigned char> buff(bytes_siz + (prefix != 0 ? 1 : 0));
-        auto buff_data = buff.data() + (prefix != 0 ? 1 : 0);
-        GDK_VERIFY(wally_hex_to_bytes(hex, buff_data, bytes_siz, &written));
-        GDK_RUNTIME_ASSERT(written == bytes_siz);
-        if (rev) {
-            std::reverse(buff_data, buff_data + bytes_siz);
-        }
+        const size_t offset = prefix != 0 ? 1 : 0;
+        std::vector<unsigned char> buff(siz / 2 + offset);
+        hex_decode(hex, siz, buff.data() + offset, rev);
         if (prefix != 0) {
             buff[0] = prefix;
         }
@@ -465,6 +643,18 @@ namespace sdk {
         return h2b(hex.data(), hex.size(), true, prefix);
     }
 
+    void h2b(const std::string& hex, gsl::span<unsigned char> output)
+    {
+        GDK_RUNTIME_ASSERT(hex.size() == static_cast<size_t>(output.size()) * 2);
+        hex_decode(hex.data(), hex.size(), output.data(), false);
+    }
+
+    void h2b_rev(const std::string& hex, gsl::span<unsigned char> output)
+    {
+        GDK_RUNTIME_ASSERT(hex.size() == static_cast<size_t>(output.size()) * 2);
+        hex_decode(hex.data(), hex.size(), output.data(), true);
+    }
+
     bool validate_hex(const std::string& hex, size_t len)
     {
         return hex.size() == len * 2 && wally_hex_verify(hex.c_str()) == WALLY_OK;
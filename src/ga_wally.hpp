@@ -193,44 +193,39 @@ namespace sdk {
     //
     std::string b2h(byte_span_t data);
     std::string b2h_rev(byte_span_t data);
+    // Write the hex of data to output, which must hold at least
+    // data.size() * 2 chars. No NUL terminator is written.
+    void b2h(byte_span_t data, gsl::span<char> output);
+    void b2h_rev(byte_span_t data, gsl::span<char> output);
 
     std::vector<unsigned char> h2b(const char* hex);
     std::vector<unsigned char> h2b(const std::string& hex);
     std::vector<unsigned char> h2b(const std::string& hex, uint8_t prefix);
+    // Decode hex into output, which must hold exactly hex.size() / 2 bytes
+    void h2b(const std::string& hex, gsl::span<unsigned char> output);
     template <size_t N> std::array<unsigned char, N> h2b_array(const std::string& hex)
     {
-        const auto vec = h2b(hex);
-        GDK_RUNTIME_ASSERT(vec.size() == N);
         std::array<unsigned char, N> ret;
-        std::copy(vec.begin(), vec.end(), ret.begin());
+        h2b(hex, gsl::make_span(ret));
         return ret;
     }
 
     std::vector<unsigned char> h2b_rev(const char* hex);
     std::vector<unsigned char> h2b_rev(const std::string& hex);
     std::vector<unsigned char> h2b_rev(const std::string& hex, uint8_t prefix);
+    void h2b_rev(const std::string& hex, gsl::span<unsigned char> output);
 
     template <std::size_t N> std::array<unsigned char, N> h2b(const std::string& hex)
     {
-        GDK_RUNTIME_ASSERT(hex.size() / 2 == N);
-        std::array<unsigned char, N> buff{ { 0 } };
-
-        const std::vector<unsigned char> bin = h2b(hex);
-        GDK_RUNTIME_ASSERT(bin.size() == N);
-
-        std::copy(std::begin(bin), std::end(bin), buff.begin());
+        std::array<unsigned char, N> buff;
+        h2b(hex, gsl::make_span(buff));
         return buff;
     }
 
     template <std::size_t N> std::array<unsigned char, N> h2b_rev(const std::string& hex)
     {
-        GDK_RUNTIME_ASSERT(hex.size() / 2 == N);
-        std::array<unsigned char, N> buff{ { 0 } };
-
-        const std::vector<unsigned char> bin = h2b_rev(hex);
-        GDK_RUNTIME_ASSERT(bin.size() == N);
-
-        std::copy(std::begin(bin), std::end(bin), buff.begin());
+        std::array<unsigned char, N> buff;
+        h2b_rev(hex, gsl::make_span(buff));
         return buff;
     }
 
@@ -1,3 +1,10 @@
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 
@@ -34,6 +41,167 @@ namespace sdk {
         // rather than an obvious 'timeout' error.
         constexpr auto HTTP_TIMEOUT = 30s;
 
+        // The delay before racing a connection attempt to the next endpoint
+        // when the previous attempt has not yet succeeded or failed (RFC 8305)
+        constexpr auto CONNECTION_ATTEMPT_DELAY = 250ms;
+
+        using tcp = asio::ip::tcp;
+
+        // The endpoint that last connected for each "host:port", which is
+        // tried first the next time we connect to the same host
+        static std::mutex g_preferred_mutex;
+        static std::map<std::string, tcp::endpoint> g_preferred_endpoints;
+
+        // Return the resolved endpoints in the order to try them: alternating
+        // address families starting with the resolver's first choice, with any
+        // endpoint that connected last time moved to the front
+        static std::vector<tcp::endpoint> get_connect_order(
+            const std::string& key, const tcp::resolver::results_type& results)
+        {
+            std::vector<tcp::endpoint> preferred_family, other_family;
+            const bool prefer_v6 = !results.empty() && results.begin()->endpoint().address().is_v6();
+            for (const auto& result : results) {
+                const bool is_preferred = result.endpoint().address().is_v6() == prefer_v6;
+                (is_preferred ? preferred_family : other_family).push_back(result.endpoint());
+            }
+            std::vector<tcp::endpoint> endpoints;
+            endpoints.reserve(preferred_family.size() + other_family.size());
+            for (size_t i = 0; i < std::max(preferred_family.size(), other_family.size()); ++i) {
+                for (const auto* family : { &preferred_family, &other_family }) {
+                    if (i < family->size()) {
+                        endpoints.push_back((*family)[i]);
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> locker(g_preferred_mutex);
+            const auto preferred_p = g_preferred_endpoints.find(key);
+            if (preferred_p != g_preferred_endpoints.end()) {
+                const auto p = std::find(endpoints.begin(), endpoints.end(), preferred_p->second);
+                if (p != endpoints.end()) {
+                    std::rotate(endpoints.begin(), p, p + 1);
+                }
+            }
+            return endpoints;
+        }
+
+        static void set_preferred_endpoint(const std::string& key, const tcp::endpoint& endpoint)
+        {
+            std::lock_guard<std::mutex> locker(g_preferred_mutex);
+            g_preferred_endpoints[key] = endpoint;
+        }
+
+        // Races connection attempts to a list of endpoints ("happy eyeballs").
+        // A new attempt is started every CONNECTION_ATTEMPT_DELAY, or as soon
+        // as the previous attempt fails. The first socket to connect is passed
+        // to the handler and all other attempts are abandoned. If every attempt
+        // fails or the timeout expires, the handler is passed the error.
+        // All operations run on the given executor, which must be a strand.
+        class connection_racer final : public std::enable_shared_from_this<connection_racer> {
+        public:
+            using handler_t = std::function<void(beast::error_code, tcp::socket, const tcp::endpoint&)>;
+
+            connection_racer(const asio::any_io_executor& executor, std::vector<tcp::endpoint> endpoints,
+                std::chrono::seconds timeout, handler_t handler)
+                : m_executor(executor)
+                , m_endpoints(std::move(endpoints))
+                , m_attempt_timer(executor)
+                , m_deadline_timer(executor)
+                , m_handler(std::move(handler))
+            {
+                m_deadline_timer.expires_after(timeout);
+            }
+
+            void start()
+            {
+                if (m_endpoints.empty()) {
+                    finish(asio::error::host_not_found, NO_WINNER);
+                    return;
+                }
+                m_deadline_timer.async_wait([self = shared_from_this()](beast::error_code ec) {
+                    if (!ec) {
+                        self->finish(beast::error::timeout, NO_WINNER);
+                    }
+                });
+                start_next_attempt();
+            }
+
+        private:
+            static constexpr size_t NO_WINNER = static_cast<size_t>(-1);
+
+            void start_next_attempt()
+            {
+                const size_t i = m_sockets.size();
+                if (m_is_done || i == m_endpoints.size()) {
+                    return;
+                }
+                GDK_LOG_SEV(log_level::debug) << "http_client: connecting to " << m_endpoints[i];
+                m_sockets.emplace_back(std::make_unique<tcp::socket>(m_executor));
+                ++m_num_pending;
+                m_sockets.back()->async_connect(m_endpoints[i],
+                    [self = shared_from_this(), i](beast::error_code ec) { self->on_connect(i, ec); });
+                // Start the next attempt after a delay, unless this one completes first
+                m_attempt_timer.expires_after(CONNECTION_ATTEMPT_DELAY);
+                m_attempt_timer.async_wait([self = shared_from_this()](beast::error_code ec) {
+                    if (!ec) {
+                        self->start_next_attempt();
+                    }
+                });
+            }
+
+            void on_connect(size_t i, beast::error_code ec)
+            {
+                --m_num_pending;
+                if (m_is_done) {
+                    return; // Another attempt won, or we timed out
+                }
+                if (!ec) {
+                    finish(ec, i);
+                    return;
+                }
+                GDK_LOG_SEV(log_level::debug) << "http_client: connect to " << m_endpoints[i] << " failed";
+                m_last_error = ec;
+                if (m_sockets.size() < m_endpoints.size()) {
+                    start_next_attempt(); // Don't wait for the attempt delay
+                } else if (!m_num_pending) {
+                    finish(m_last_error, NO_WINNER);
+                }
+            }
+
+            void finish(beast::error_code ec, size_t winner)
+            {
+                if (m_is_done) {
+                    return;
+                }
+                m_is_done = true;
+                m_attempt_timer.cancel();
+                m_deadline_timer.cancel();
+                tcp::socket socket(m_executor);
+                tcp::endpoint endpoint;
+                for (size_t i = 0; i < m_sockets.size(); ++i) {
+                    if (i == winner) {
+                        socket = std::move(*m_sockets[i]);
+                        endpoint = m_endpoints[i];
+                    } else {
+                        beast::error_code close_ec;
+                        m_sockets[i]->close(close_ec);
+                    }
+                }
+                auto handler = std::move(m_handler);
+                handler(ec, std::move(socket), endpoint);
+            }
+
+            asio::any_io_executor m_executor;
+            const std::vector<tcp::endpoint> m_endpoints;
+            std::vector<std::unique_ptr<tcp::socket>> m_sockets;
+            asio::steady_timer m_attempt_timer;
+            asio::steady_timer m_deadline_timer;
+            handler_t m_handler;
+            beast::error_code m_last_error;
+            size_t m_num_pending = 0;
+            bool m_is_done = false;
+        };
+
     } // namespace
 
     static X509* cert_from_pem(const std::string& pem)
@@ -194,23 +362,84 @@ namespace sdk {
         return ctx;
     }
 
+    std::shared_ptr<boost::asio::ssl::context> get_shared_tls_context(const std::string& host_name,
+        const std::vector<std::string>& roots, const std::vector<std::string>& pins, uint32_t cert_expiry_threshold)
+    {
+        static std::mutex s_mutex;
+        static std::map<std::string, std::weak_ptr<asio::ssl::context>> s_contexts;
+
+        std::string key = host_name + '\n' + std::to_string(cert_expiry_threshold);
+        for (const auto* certs : { &roots, &pins }) {
+            key.push_back('\n');
+            for (const auto& cert : *certs) {
+                key.append(cert).push_back(',');
+            }
+        }
+
+        std::lock_guard<std::mutex> locker(s_mutex);
+        auto& weak_ctx = s_contexts[key];
+        auto ctx = weak_ctx.lock();
+        if (!ctx) {
+            // Remove any contexts that are no longer in use
+            for (auto it = s_contexts.begin(); it != s_contexts.end();) {
+                it = it->second.expired() && &it->second != &weak_ctx ? s_contexts.erase(it) : std::next(it);
+            }
+            ctx = tls_init(host_name, roots, pins, cert_expiry_threshold);
+            weak_ctx = ctx;
+        }
+        return ctx;
+    }
+
     http_client::http_client(boost::asio::io_context& io)
         : m_resolver(asio::make_strand(io))
+        , m_output_max_size(0)
         , m_timeout(HTTP_TIMEOUT)
+        , m_keep_alive(false)
+        , m_is_connected(false)
+        , m_has_response(false)
         , m_io(io)
     {
     }
 
-    std::future<nlohmann::json> http_client::request(beast::http::verb verb, const nlohmann::json& params)
+    std::future<nlohmann::json> http_client::request(
+        beast::http::verb verb, const nlohmann::json& params, bool keep_alive)
     {
         GDK_LOG_SEV(log_level::debug) << "http_client";
 
+        const bool reuse_connection = m_is_connected;
+        if (reuse_connection) {
+            // Only requests to the same endpoint can reuse our connection
+            GDK_RUNTIME_ASSERT(m_host == params.at("host") && m_port == params.at("port"));
+        }
         m_host = params.at("host");
         m_port = params.at("port");
         const std::string target = params.at("target");
         const std::string proxy_uri = params.at("proxy");
 
-        GDK_LOG_SEV(log_level::debug) << "Connecting to " << m_host << ":" << m_port << " for target " << target;
+        if (reuse_connection) {
+            GDK_LOG_SEV(log_level::debug) << "Reusing connection to " << m_host << ":" << m_port << " for target "
+                                          << target;
+        } else {
+            GDK_LOG_SEV(log_level::debug) << "Connecting to " << m_host << ":" << m_port << " for target " << target;
+        }
+
+        // Reset any state from a previous request on this connection
+        m_promise = std::promise<nlohmann::json>();
+        m_request = beast::http::request<beast::http::string_body>();
+        m_response.reset();
+        m_file_response.reset();
+        m_output_file = params.value("output_file", std::string());
+        m_output_max_size = 0;
+        if (!m_output_file.empty()) {
+            // Limit how much a remote server can write to disk
+            const auto max_size_p = params.find("output_max_size");
+            GDK_RUNTIME_ASSERT_MSG(max_size_p != params.end(), "output_file requires output_max_size");
+            m_output_max_size = max_size_p->get<uint64_t>();
+        }
+        m_keep_alive = keep_alive;
+        m_is_connected = false;
+        m_has_response = false;
+        m_timeout = HTTP_TIMEOUT;
 
         const auto timeout_p = params.find("timeout");
         if (timeout_p != params.end()) {
@@ -218,12 +447,14 @@ namespace sdk {
         }
         GDK_LOG_SEV(log_level::debug) << "HTTP timeout " << m_timeout.count() << " seconds";
 
-        preamble(m_host);
+        if (!reuse_connection) {
+            preamble(m_host);
+        }
 
         m_request.version(HTTP_VERSION);
         m_request.method(verb);
         m_request.target(target);
-        m_request.set(beast::http::field::connection, "close");
+        m_request.set(beast::http::field::connection, m_keep_alive ? "keep-alive" : "close");
         m_request.set(beast::http::field::host, m_host);
         m_request.set(beast::http::field::user_agent, "GreenAddress SDK");
 
@@ -251,7 +482,10 @@ namespace sdk {
 
         m_accept = params.value("accept", "");
 
-        if (!proxy_uri.empty()) {
+        if (reuse_connection) {
+            get_lowest_layer().expires_after(m_timeout);
+            async_write();
+        } else if (!proxy_uri.empty()) {
             get_lowest_layer().expires_after(m_timeout);
             auto proxy = std::make_shared<socks_client>(m_io, get_next_layer());
             GDK_RUNTIME_ASSERT(proxy != nullptr);
@@ -274,13 +508,41 @@ namespace sdk {
         async_connect(std::move(results));
     }
 
+    void http_client::race_connect(tcp::resolver::results_type results, connect_handler_t handler)
+    {
+        std::string key = m_host + ":" + m_port;
+        auto endpoints = get_connect_order(key, results);
+        auto& stream = get_lowest_layer();
+        // handler keeps this client, and so its stream, alive until called
+        auto racer = std::make_shared<connection_racer>(stream.get_executor(), std::move(endpoints), m_timeout,
+            [&stream, key = std::move(key), handler = std::move(handler)](
+                beast::error_code ec, tcp::socket socket, const tcp::endpoint& endpoint) {
+                if (!ec) {
+                    stream.socket() = std::move(socket);
+                    set_preferred_endpoint(key, endpoint);
+                }
+                handler(ec, endpoint);
+            });
+        racer->start();
+    }
+
     void http_client::on_write(beast::error_code ec, size_t __attribute__((unused)) bytes_transferred)
     {
         GDK_LOG_SEV(log_level::debug) << "http_client:on_write";
 
         NET_ERROR_CODE_CHECK("on write", ec);
         get_lowest_layer().expires_after(m_timeout);
-        m_response.body_limit(64 * 1024 * 1024);
+        if (!m_output_file.empty()) {
+            // Stream the body directly to the output file as it arrives
+            m_file_response.emplace();
+            m_file_response->body_limit(m_output_max_size);
+            beast::error_code open_ec;
+            m_file_response->get().body().open(m_output_file.c_str(), beast::file_mode::write, open_ec);
+            NET_ERROR_CODE_CHECK("open output file", open_ec);
+        } else {
+            m_response.emplace();
+            m_response->body_limit(64 * 1024 * 1024);
+        }
         async_read();
     }
 
@@ -289,6 +551,14 @@ namespace sdk {
         GDK_LOG_SEV(log_level::debug) << "http_client:on_read";
 
         NET_ERROR_CODE_CHECK("on read", ec);
+        m_has_response = true;
+        if (m_keep_alive && is_keep_alive_response()) {
+            // Leave the connection open for the next request
+            get_lowest_layer().expires_never();
+            m_is_connected = true;
+            set_result();
+            return;
+        }
         get_lowest_layer().cancel();
         async_shutdown();
     }
@@ -307,10 +577,24 @@ namespace sdk {
 
     void http_client::preamble(__attribute__((unused)) const std::string& host) {}
 
+    bool http_client::is_connected() const { return m_is_connected; }
+
+    bool http_client::has_response() const { return m_has_response; }
+
+    bool http_client::is_keep_alive_response() const
+    {
+        return m_file_response ? m_file_response->keep_alive() : m_response->keep_alive();
+    }
+
+    std::shared_ptr<SSL_SESSION> http_client::get_tls_session() { return {}; }
+
+    void http_client::set_tls_session(__attribute__((unused)) std::shared_ptr<SSL_SESSION> session) {}
+
     void http_client::set_result()
     {
-        auto response = m_response.release();
-        const auto result = response.result();
+        const bool is_file = m_file_response.has_value();
+        const auto& header = is_file ? m_file_response->get().base() : m_response->get().base();
+        const auto result = header.result();
 
         if (result == beast::http::status::not_modified) {
             const nlohmann::json body = { { "not_modified", true } };
@@ -320,7 +604,7 @@ namespace sdk {
         }
 
         if (beast::http::to_status_class(result) == beast::http::status_class::redirection) {
-            const nlohmann::json body = { { "location", response[beast::http::field::location] } };
+            const nlohmann::json body = { { "location", header[beast::http::field::location] } };
             m_promise.set_value(body);
             return;
         }
@@ -335,15 +619,29 @@ namespace sdk {
         try {
             nlohmann::json body;
 
-            if (m_accept == "json") {
-                body["body"] = nlohmann::json::parse(response.body());
-            } else if (m_accept == "base64") {
-                body["body"] = base64_from_bytes(ustring_span(response.body()));
+            if (is_file) {
+                // The body has been written to the output file. JSON bodies
+                // are parsed from the file so the raw body is never held
+                // in memory; other bodies are left for the caller to read
+                m_file_response->get().body().close();
+                if (m_accept == "json") {
+                    std::ifstream input(m_output_file, std::ios::binary);
+                    GDK_RUNTIME_ASSERT_MSG(input.good(), "failed to open output file");
+                    body["body"] = nlohmann::json::parse(input);
+                }
             } else {
-                body["body"] = std::move(response.body());
+                auto& response_body = m_response->get().body();
+                if (m_accept == "json") {
+                    body["body"] = nlohmann::json::parse(response_body);
+                } else if (m_accept == "base64") {
+                    body["body"] = base64_from_bytes(ustring_span(response_body));
+                } else {
+                    body["body"] = std::move(response_body);
+                }
+                std::string().swap(response_body); // Free the raw body now it is no longer needed
             }
 
-            for (const auto& field : response.base()) {
+            for (const auto& field : header) {
                 const std::string field_name = field.name_string().to_string();
                 const std::string field_value = field.value().to_string();
                 body["headers"][boost::algorithm::to_lower_copy(field_name)] = field_value;
@@ -357,6 +655,7 @@ namespace sdk {
 
     void http_client::set_exception(const std::string& what)
     {
+        m_is_connected = false;
         m_promise.set_exception(std::make_exception_ptr(std::runtime_error(what)));
     }
 
@@ -385,8 +684,13 @@ namespace sdk {
     }
 
 #define ASYNC_READ                                                                                                     \
-    beast::http::async_read(                                                                                           \
-        m_stream, m_buffer, m_response, beast::bind_front_handler(&http_client::on_read, shared_from_this()));
+    if (m_file_response) {                                                                                             \
+        beast::http::async_read(m_stream, m_buffer, *m_file_response,                                                  \
+            beast::bind_front_handler(&http_client::on_read, shared_from_this()));                                     \
+    } else {                                                                                                           \
+        beast::http::async_read(                                                                                       \
+            m_stream, m_buffer, *m_response, beast::bind_front_handler(&http_client::on_read, shared_from_this()));    \
+    }
 
 #define ASYNC_RESOLVE                                                                                                  \
     m_resolver.async_resolve(host, port, beast::bind_front_handler(&http_client::on_resolve, shared_from_this()));
@@ -401,8 +705,7 @@ namespace sdk {
 
     void tls_http_client::async_connect(asio::ip::tcp::resolver::results_type results)
     {
-        get_lowest_layer().async_connect(
-            results, beast::bind_front_handler(&tls_http_client::on_connect, shared_from_this()));
+        race_connect(std::move(results), beast::bind_front_handler(&tls_http_client::on_connect, shared_from_this()));
     }
 
     void tls_http_client::async_read() { ASYNC_READ; }
@@ -429,8 +732,24 @@ namespace sdk {
             beast::error_code ec{ static_cast<int>(::ERR_get_error()), asio::error::get_ssl_category() };
             GDK_RUNTIME_ASSERT_MSG(false, ec.message());
         }
+        if (m_tls_session) {
+            // Attempt to resume the session; if the server refuses a full
+            // handshake is performed instead
+            SSL_set_session(m_stream.native_handle(), m_tls_session.get());
+        }
     }
 
+    std::shared_ptr<SSL_SESSION> tls_http_client::get_tls_session()
+    {
+        SSL_SESSION* session = SSL_get1_session(m_stream.native_handle());
+        if (!session) {
+            return {};
+        }
+        return std::shared_ptr<SSL_SESSION>(session, SSL_SESSION_free);
+    }
+
+    void tls_http_client::set_tls_session(std::shared_ptr<SSL_SESSION> session) { m_tls_session = std::move(session); }
+
     tcp_http_client::tcp_http_client(boost::asio::io_context& io)
         : http_client(io)
         , m_stream(asio::make_strand(io))
@@ -443,7 +762,7 @@ namespace sdk {
 
     void tcp_http_client::async_connect(asio::ip::tcp::resolver::results_type results)
     {
-        m_stream.async_connect(results, beast::bind_front_handler(&tcp_http_client::on_connect, shared_from_this()));
+        race_connect(std::move(results), beast::bind_front_handler(&tcp_http_client::on_connect, shared_from_this()));
     }
 
     void tcp_http_client::async_read() { ASYNC_READ; }
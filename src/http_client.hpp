@@ -2,10 +2,13 @@
 #define GDK_HTTP_CLIENT_HPP
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <future>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
 
 #include "boost_wrapper.hpp"
 #include "gsl_wrapper.hpp"
@@ -21,7 +24,22 @@ namespace sdk {
         http_client& operator=(http_client&&) = delete;
         virtual ~http_client() = default;
 
-        std::future<nlohmann::json> request(boost::beast::http::verb verb, const nlohmann::json& params);
+        // Make a request. If keep_alive is true and the server agrees, the
+        // connection is left open afterwards and is_connected() returns true,
+        // in which case the client can be used to make further requests to
+        // the same host/port/proxy without reconnecting.
+        std::future<nlohmann::json> request(
+            boost::beast::http::verb verb, const nlohmann::json& params, bool keep_alive = false);
+
+        bool is_connected() const;
+        // Whether the last request received a response from the server,
+        // i.e. any error it failed with was not a transport error
+        bool has_response() const;
+
+        // Return the TLS session negotiated by this client, if any
+        virtual std::shared_ptr<SSL_SESSION> get_tls_session();
+        // Set a previously negotiated TLS session to resume when connecting
+        virtual void set_tls_session(std::shared_ptr<SSL_SESSION> session);
 
         void on_resolve(boost::beast::error_code ec, boost::asio::ip::tcp::resolver::results_type results);
         void on_write(boost::beast::error_code ec, size_t bytes_transferred);
@@ -41,17 +59,32 @@ namespace sdk {
         virtual void async_resolve(const std::string& host, const std::string& port) = 0;
         virtual void preamble(const std::string& host);
 
+        using connect_handler_t
+            = std::function<void(boost::beast::error_code, const boost::asio::ip::tcp::endpoint& endpoint)>;
+        // Connect the lowest layer to one of the resolved endpoints, racing
+        // attempts to each endpoint in turn rather than waiting for each to
+        // time out, and preferring the endpoint that connected last time
+        void race_connect(boost::asio::ip::tcp::resolver::results_type results, connect_handler_t handler);
+
         void set_result();
         void set_exception(const std::string& what);
+        bool is_keep_alive_response() const;
 
         boost::asio::ip::tcp::resolver m_resolver;
         boost::beast::flat_buffer m_buffer;
         boost::beast::http::request<boost::beast::http::string_body> m_request;
-        boost::beast::http::response_parser<boost::beast::http::string_body> m_response;
+        std::optional<boost::beast::http::response_parser<boost::beast::http::string_body>> m_response;
+        // Used instead of m_response when streaming the body to a file
+        std::optional<boost::beast::http::response_parser<boost::beast::http::file_body>> m_file_response;
+        std::string m_output_file;
+        uint64_t m_output_max_size;
         std::chrono::seconds m_timeout;
         std::string m_host;
         std::string m_port;
         std::string m_accept;
+        bool m_keep_alive;
+        std::atomic_bool m_is_connected;
+        std::atomic_bool m_has_response;
 
         std::promise<nlohmann::json> m_promise;
 
@@ -73,11 +106,15 @@ namespace sdk {
         void async_resolve(const std::string& host, const std::string& port) override;
         void preamble(const std::string& host) override;
 
+        std::shared_ptr<SSL_SESSION> get_tls_session() override;
+        void set_tls_session(std::shared_ptr<SSL_SESSION> session) override;
+
         void on_connect(
             boost::beast::error_code ec, const boost::asio::ip::tcp::resolver::results_type::endpoint_type& type);
         void on_handshake(boost::beast::error_code ec);
 
         boost::beast::ssl_stream<boost::beast::tcp_stream> m_stream;
+        std::shared_ptr<SSL_SESSION> m_tls_session;
     };
 
     class tcp_http_client final : public std::enable_shared_from_this<tcp_http_client>, public http_client {
@@ -103,6 +140,12 @@ namespace sdk {
     std::shared_ptr<boost::asio::ssl::context> tls_init(const std::string& host_name,
         const std::vector<std::string>& roots, const std::vector<std::string>& pins, uint32_t cert_expiry_threshold);
 
+    // As tls_init, but returns the existing context for the given parameters
+    // if it is still in use, so that many connections to the same host can
+    // share a single context.
+    std::shared_ptr<boost::asio::ssl::context> get_shared_tls_context(const std::string& host_name,
+        const std::vector<std::string>& roots, const std::vector<std::string>& pins, uint32_t cert_expiry_threshold);
+
     inline std::shared_ptr<http_client> make_http_client(
         boost::asio::io_context& io, boost::asio::ssl::context* ssl_ctx)
     {
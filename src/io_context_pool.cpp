@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "assertion.hpp"
+#include "io_context_pool.hpp"
+#include "logging.hpp"
+#include "utils.hpp"
+
+namespace ga {
+namespace sdk {
+
+    namespace {
+        static thread_local bool tl_is_io_thread = false;
+    } // namespace
+
+    // An io_context and the thread running it
+    struct io_runner {
+        explicit io_runner(bool is_shared)
+            : m_io()
+            , m_work_guard(boost::asio::make_work_guard(m_io))
+            , m_is_shared(is_shared)
+        {
+            m_thread = std::thread([this] {
+                tl_is_io_thread = true;
+                m_io.run();
+            });
+        }
+
+        ~io_runner() { stop(); }
+
+        void stop()
+        {
+            if (m_thread.joinable()) {
+                m_work_guard.reset();
+                m_thread.join();
+            }
+        }
+
+        boost::asio::io_context m_io;
+        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_work_guard;
+        std::thread m_thread;
+        const bool m_is_shared;
+    };
+
+    struct io_handle_state {
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        // Protected by m_mutex
+        size_t m_num_pending = 0; // Functions posted but not yet run or cancelled
+        bool m_is_stopped = false;
+        std::set<std::shared_ptr<boost::asio::steady_timer>> m_timers;
+        std::vector<std::weak_ptr<void>> m_tracked;
+    };
+
+    namespace {
+        // How often a shutdown checks for tracked objects being released
+        constexpr auto SHUTDOWN_POLL_INTERVAL = std::chrono::milliseconds(10);
+        constexpr size_t SHUTDOWN_LOG_INTERVAL = 500;
+
+        static std::mutex g_pool_mutex;
+        // Never deleted, to avoid destruction order issues at exit
+        static std::vector<std::shared_ptr<io_runner>>* g_pool = nullptr;
+
+        static std::shared_ptr<io_runner> get_io_runner()
+        {
+            std::unique_lock<std::mutex> locker(g_pool_mutex);
+            if (!g_pool) {
+                return std::make_shared<io_runner>(false);
+            }
+            // Use the shared runner with the fewest handles
+            return *std::min_element(g_pool->begin(), g_pool->end(),
+                [](const auto& lhs, const auto& rhs) { return lhs.use_count() < rhs.use_count(); });
+        }
+
+        static void run_posted(
+            const std::shared_ptr<io_handle_state>& state, const io_context_handle::fn_t& fn, bool do_run)
+        {
+            if (do_run) {
+                no_std_exception_escape(fn, "io_context_handle");
+            }
+            std::unique_lock<std::mutex> locker(state->m_mutex);
+            if (!--state->m_num_pending) {
+                state->m_cv.notify_all();
+            }
+        }
+    } // namespace
+
+    io_context_handle::io_context_handle()
+        : m_runner(get_io_runner())
+        , m_state(std::make_shared<io_handle_state>())
+    {
+    }
+
+    io_context_handle::~io_context_handle() { shutdown(); }
+
+    boost::asio::io_context& io_context_handle::get_io_context() { return m_runner->m_io; }
+
+    void io_context_handle::post(fn_t fn)
+    {
+        {
+            std::unique_lock<std::mutex> locker(m_state->m_mutex);
+            if (m_state->m_is_stopped) {
+                return;
+            }
+            ++m_state->m_num_pending;
+        }
+        boost::asio::post(m_runner->m_io, [state = m_state, fn = std::move(fn)] { run_posted(state, fn, true); });
+    }
+
+    void io_context_handle::post_after(std::chrono::milliseconds delay, fn_t fn)
+    {
+        auto timer = std::make_shared<boost::asio::steady_timer>(m_runner->m_io, delay);
+        {
+            std::unique_lock<std::mutex> locker(m_state->m_mutex);
+            if (m_state->m_is_stopped) {
+                return;
+            }
+            ++m_state->m_num_pending;
+            m_state->m_timers.insert(timer);
+        }
+        timer->async_wait([state = m_state, timer, fn = std::move(fn)](const boost::system::error_code& ec) {
+            {
+                std::unique_lock<std::mutex> locker(state->m_mutex);
+                state->m_timers.erase(timer);
+            }
+            run_posted(state, fn, !ec);
+        });
+    }
+
+    void io_context_handle::track(std::weak_ptr<void> object)
+    {
+        std::unique_lock<std::mutex> locker(m_state->m_mutex);
+        auto& tracked = m_state->m_tracked;
+        tracked.erase(std::remove_if(tracked.begin(), tracked.end(), [](const auto& p) { return p.expired(); }),
+            tracked.end());
+        tracked.emplace_back(std::move(object));
+    }
+
+    void io_context_handle::shutdown()
+    {
+        {
+            std::unique_lock<std::mutex> locker(m_state->m_mutex);
+            if (m_state->m_is_stopped) {
+                return;
+            }
+            m_state->m_is_stopped = true;
+        }
+
+        // Timers are not thread safe, so they are cancelled on the io thread
+        auto& io = m_runner->m_io;
+        const bool is_io_thread = io.get_executor().running_in_this_thread();
+        auto&& cancel_timers = [state = m_state] {
+            std::set<std::shared_ptr<boost::asio::steady_timer>> timers;
+            {
+                std::unique_lock<std::mutex> locker(state->m_mutex);
+                timers.swap(state->m_timers);
+            }
+            for (auto& timer : timers) {
+                timer->cancel();
+            }
+        };
+        if (is_io_thread) {
+            // We can't wait for our own caller to complete
+            cancel_timers();
+            return;
+        }
+        boost::asio::post(io, cancel_timers);
+        {
+            std::unique_lock<std::mutex> locker(m_state->m_mutex);
+            m_state->m_cv.wait(locker, [this] { return !m_state->m_num_pending; });
+        }
+
+        if (!m_runner->m_is_shared) {
+            m_runner->stop();
+            return;
+        }
+        // Our users queue handlers directly on the shared io_context, which
+        // we can't stop. Run it until those holding our tracked objects have
+        // completed, as an owned io_context would be when its thread exits
+        for (size_t i = 0;; ++i) {
+            std::promise<void> done;
+            boost::asio::post(io, [&done] { done.set_value(); });
+            done.get_future().wait();
+            std::unique_lock<std::mutex> locker(m_state->m_mutex);
+            const auto& tracked = m_state->m_tracked;
+            if (std::all_of(tracked.begin(), tracked.end(), [](const auto& p) { return p.expired(); })) {
+                break;
+            }
+            if (i && i % SHUTDOWN_LOG_INTERVAL == 0) {
+                GDK_LOG_SEV(log_level::info) << "io_context_handle: waiting for tracked objects to be released";
+            }
+            locker.unlock();
+            std::this_thread::sleep_for(SHUTDOWN_POLL_INTERVAL);
+        }
+    }
+
+    void init_io_context_pool(size_t num_threads)
+    {
+        std::unique_lock<std::mutex> locker(g_pool_mutex);
+        GDK_RUNTIME_ASSERT_MSG(!g_pool, "io context pool already initialized");
+        if (num_threads) {
+            g_pool = new std::vector<std::shared_ptr<io_runner>>();
+            for (size_t i = 0; i < num_threads; ++i) {
+                g_pool->emplace_back(std::make_shared<io_runner>(true));
+            }
+        }
+    }
+
+    bool is_io_context_thread() { return tl_is_io_thread; }
+
+} // namespace sdk
+} // namespace ga
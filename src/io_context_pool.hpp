@@ -0,0 +1,72 @@
+#ifndef GDK_IO_CONTEXT_POOL_HPP
+#define GDK_IO_CONTEXT_POOL_HPP
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include "boost_wrapper.hpp"
+
+namespace ga {
+namespace sdk {
+    struct io_runner;
+    struct io_handle_state;
+
+    // A handle to an asio io_context which runs on a background thread.
+    // By default each handle owns its own io_context and thread. Once
+    // init_io_context_pool has been called, new handles instead share the
+    // io_contexts of a process-wide pool, so that many sessions can be open
+    // without each requiring its own I/O threads.
+    //
+    // Each io_context is run by a single thread, so handlers posted through
+    // a handle are never run concurrently with each other.
+    class io_context_handle final {
+    public:
+        using fn_t = std::function<void()>;
+
+        io_context_handle();
+        ~io_context_handle();
+
+        io_context_handle(const io_context_handle&) = delete;
+        io_context_handle& operator=(const io_context_handle&) = delete;
+        io_context_handle(io_context_handle&&) = delete;
+        io_context_handle& operator=(io_context_handle&&) = delete;
+
+        boost::asio::io_context& get_io_context();
+
+        // Post a function to run on the io_context thread
+        void post(fn_t fn);
+
+        // Post a function to run on the io_context thread after a delay
+        void post_after(std::chrono::milliseconds delay, fn_t fn);
+
+        // Track an object whose pending handlers run on the io_context,
+        // such as a connection. shutdown waits until it has been released.
+        void track(std::weak_ptr<void> object);
+
+        // Stop running functions for this handle: Pending delayed functions
+        // are cancelled, functions posted afterwards are discarded, and any
+        // other posted functions are waited for. If the io_context is owned,
+        // it is then stopped and its thread joined, completing all of its
+        // handlers. Otherwise, handlers are run until every tracked object
+        // has been released.
+        void shutdown();
+
+    private:
+        std::shared_ptr<io_runner> m_runner;
+        std::shared_ptr<io_handle_state> m_state;
+    };
+
+    // Share num_threads io_contexts between all subsequently created
+    // sessions. GA_init calls this from its config.
+    void init_io_context_pool(size_t num_threads);
+
+    // Whether the calling thread runs an io_context. Such threads must not
+    // wait on other threads, which may in turn be waiting for network I/O.
+    bool is_io_context_thread();
+
+} // namespace sdk
+} // namespace ga
+
+#endif
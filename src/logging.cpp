@@ -0,0 +1,67 @@
+#include <cstdlib>
+#include <iostream>
+
+#include <boost/core/null_deleter.hpp>
+#include <boost/log/attributes/clock.hpp>
+#include <boost/log/attributes/current_thread_id.hpp>
+#include <boost/log/sinks/bounded_fifo_queue.hpp>
+#include <boost/log/sinks/block_on_overflow.hpp>
+#include <boost/log/sinks/text_ostream_backend.hpp>
+#include <boost/log/support/date_time.hpp>
+
+#include "logging.hpp"
+
+namespace ga {
+namespace sdk {
+
+    namespace {
+        // Messages are queued for a dedicated thread to write. Loggers
+        // wait if the queue fills up, so no messages are lost
+        constexpr size_t LOG_QUEUE_SIZE = 4096;
+
+        namespace sinks = boost::log::sinks;
+        using log_queue_t = sinks::bounded_fifo_queue<LOG_QUEUE_SIZE, sinks::block_on_overflow>;
+        using clog_sink_t = sinks::asynchronous_sink<sinks::text_ostream_backend, log_queue_t>;
+
+        static boost::shared_ptr<clog_sink_t> g_clog_sink;
+    } // namespace
+
+    void init_logging(log_level::severity_level level)
+    {
+        namespace attrs = boost::log::attributes;
+        namespace expr = boost::log::expressions;
+
+        auto core = boost::log::core::get();
+        core->set_filter(log_level::severity >= level);
+        detail::log_level_threshold = level;
+#ifndef __ANDROID__
+        if (level == log_level::fatal || g_clog_sink) {
+            return; // Logging disabled, or already initialized
+        }
+        // Replace the default synchronous sink with an asynchronous one
+        // using the same format
+        core->add_global_attribute("TimeStamp", attrs::local_clock());
+        core->add_global_attribute("ThreadID", attrs::current_thread_id());
+
+        auto backend = boost::make_shared<sinks::text_ostream_backend>();
+        backend->add_stream(boost::shared_ptr<std::ostream>(&std::clog, boost::null_deleter()));
+        backend->auto_flush(true);
+        g_clog_sink = boost::make_shared<clog_sink_t>(backend);
+        g_clog_sink->set_formatter(expr::stream
+            << "[" << expr::format_date_time<boost::posix_time::ptime>("TimeStamp", "%Y-%m-%d %H:%M:%S.%f") << "] ["
+            << expr::attr<attrs::current_thread_id::value_type>("ThreadID") << "] [" << log_level::severity << "] "
+            << expr::smessage);
+        core->add_sink(g_clog_sink);
+        std::atexit(flush_logging);
+#endif
+    }
+
+    void flush_logging()
+    {
+        if (g_clog_sink) {
+            g_clog_sink->flush();
+        }
+    }
+
+} // namespace sdk
+} // namespace ga
@@ -6,6 +6,8 @@
 #include <android/log.h>
 #endif
 
+#include <atomic>
+
 #include <boost/log/attributes/named_scope.hpp>
 #include <boost/log/core.hpp>
 #include <boost/log/expressions.hpp>
@@ -79,7 +81,36 @@ namespace sdk {
         return gdk_logger_t{};
     }
 
-#define GDK_LOG_SEV(sev) BOOST_LOG_SEV(::ga::sdk::gdk_logger::get(), sev)
+#ifndef GDK_MIN_LOG_LEVEL
+#define GDK_MIN_LOG_LEVEL debug
+#endif
+
+    // Messages below this level are removed at compile time. Set using the
+    // MIN_LOG_LEVEL cmake option
+    constexpr auto MIN_LOG_LEVEL = log_level::GDK_MIN_LOG_LEVEL;
+
+    namespace detail {
+        // The runtime log level, set by init_logging
+        inline std::atomic_int log_level_threshold{ log_level::fatal };
+    } // namespace detail
+
+    inline bool is_log_enabled(log_level::severity_level sev)
+    {
+        return sev >= MIN_LOG_LEVEL && sev >= detail::log_level_threshold.load(std::memory_order_relaxed);
+    }
+
+    // Set the runtime log level, and unless running on Android, start an
+    // asynchronous sink to write log messages to std::clog. Called by GA_init.
+    void init_logging(log_level::severity_level level);
+
+    // Write any queued log messages. Called automatically at exit
+    void flush_logging();
+
+// Messages below the log level are rejected without formatting them or
+// involving the logging core. Below MIN_LOG_LEVEL they are compiled out.
+#define GDK_LOG_SEV(sev)                                                                                               \
+    for (bool gdk_log_enabled_ = ::ga::sdk::is_log_enabled(sev); gdk_log_enabled_; gdk_log_enabled_ = false)          \
+    BOOST_LOG_SEV(::ga::sdk::gdk_logger::get(), sev)
 
 } // namespace sdk
 } // namespace ga
@@ -1,4 +1,5 @@
 #include <boost/algorithm/string/predicate.hpp>
+#include <functional>
 #include <mutex>
 
 #include "assertion.hpp"
@@ -163,9 +164,15 @@ static std::vector<std::string> wamp_cert_pins = {
     "64e286b76063602a372efd60cde8db2656a49ee15e84254b3d6eb5fe38f4288b",
 };
 
-static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_networks = {
+// A registered network. Built in networks are only constructed when first used
+struct network_entry {
+    std::function<nlohmann::json()> make_details;
+    std::shared_ptr<nlohmann::json> details;
+};
+
+static std::map<std::string, network_entry> registered_networks = {
     { "localtest",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", std::string() },
             { "bech32_prefix", "bcrt" },
             { "bip21_prefix", "bitcoin" },
@@ -199,10 +206,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", std::string() },
             { "wamp_url", "ws://localhost:8080/v2/ws" },
-        })) },
+        }); } } },
 
     { "liquid",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", "https://blockstream.info/liquid/address/" },
             { "asset_registry_onion_url", "http://lhquhzzpzg5tyymcqep24fynpzzqqg3m3rlh7ascnw5cpqsro35bfxyd.onion" },
             { "asset_registry_url", "https://assets.blockstream.info" },
@@ -241,10 +248,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", "ws://liquidbtcgecscpokecnr5uwg2de55shdq7dnvlpzeju7tnefbekicqd.onion/v2/ws" },
             { "wamp_url", "wss://green-liquid-mainnet.blockstream.com/v2/ws" },
-        })) },
+        }); } } },
 
     { "localtest-liquid",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", std::string() },
             { "asset_registry_onion_url", "http://lhquhzzpzg5tyymcqep24fynpzzqqg3m3rlh7ascnw5cpqsro35bfxyd.onion" },
             { "asset_registry_url", "https://assets.blockstream.info" },
@@ -283,10 +290,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", std::string() },
             { "wamp_url", "ws://localhost:8080/v2/ws" },
-        })) },
+        }); } } },
 
     { "testnet-liquid",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", "https://esplora.blockstream.com/liquidtestnet/address/" },
             { "asset_registry_onion_url", "http://lhquhzzpzg5tyymcqep24fynpzzqqg3m3rlh7ascnw5cpqsro35bfxyd.onion/testnet/" },
             { "asset_registry_url", "https://assets-testnet.blockstream.info/" },
@@ -325,10 +332,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", "ws://liqtestulh46kwla3mgenugrcogvjjvzr2qdto663hujwnbaewzpkoad.onion/v2/ws" },
             { "wamp_url", "wss://green-liquid-testnet.blockstream.com/v2/ws" },
-        })) },
+        }); } } },
 
     { "mainnet",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", "https://blockstream.info/address/" },
             { "bech32_prefix", "bc" },
             { "bip21_prefix", "bitcoin" },
@@ -362,10 +369,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", "ws://greenv32e5p4rax6dmfgb4zzl7kq2fbmizd7miyava2actplmipyx2qd.onion:80/v2/ws" },
             { "wamp_url", "wss://green-bitcoin-mainnet.blockstream.com/v2/ws" },
-        })) },
+        }); } } },
 
     { "testnet",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", "https://blockstream.info/testnet/address/" },
             { "bech32_prefix", "tb" },
             { "bip21_prefix", "bitcoin" },
@@ -399,10 +406,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", "ws://greent5yfxruca52pkqjtgo2qdxijscqlastnv3jwzpmavvffdldm2yd.onion:80/v2/ws" },
             { "wamp_url", "wss://green-bitcoin-testnet.blockstream.com/v2/ws" },
-        })) },
+        }); } } },
 
     { "electrum-liquid",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", "https://blockstream.info/liquid/address/" },
             { "asset_registry_onion_url", "http://lhquhzzpzg5tyymcqep24fynpzzqqg3m3rlh7ascnw5cpqsro35bfxyd.onion" },
             { "asset_registry_url", "https://assets.blockstream.info" },
@@ -441,10 +448,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", std::string() },
             { "wamp_url", std::string() },
-        })) },
+        }); } } },
 
     { "electrum-localtest-liquid",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", std::string() },
             { "asset_registry_onion_url", "http://lhquhzzpzg5tyymcqep24fynpzzqqg3m3rlh7ascnw5cpqsro35bfxyd.onion" },
             { "asset_registry_url", "https://assets.blockstream.info" },
@@ -483,10 +490,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", std::string() },
             { "wamp_url", std::string() },
-        })) },
+        }); } } },
 
     { "electrum-mainnet",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", "https://blockstream.info/address/" },
             { "bech32_prefix", "bc" },
             { "bip21_prefix", "bitcoin" },
@@ -520,10 +527,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", std::string() },
             { "wamp_url", std::string() },
-        })) },
+        }); } } },
 
     { "electrum-testnet",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", "https://blockstream.info/testnet/address/" },
             { "bech32_prefix", "tb" },
             { "bip21_prefix", "bitcoin" },
@@ -557,10 +564,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", std::string() },
             { "wamp_url", std::string() },
-        })) },
+        }); } } },
 
     { "electrum-localtest",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", "http://127.0.0.1:8080/address/" },
             { "bech32_prefix", "bcrt" },
             { "bip21_prefix", "bitcoin" },
@@ -594,10 +601,10 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", std::string() },
             { "wamp_url", std::string() },
-        })) },
+        }); } } },
 
     { "electrum-testnet-liquid",
-        std::make_shared<nlohmann::json>(nlohmann::json({
+        network_entry{ [] { return nlohmann::json({
             { "address_explorer_url", "https://blockstream.info/liquidtestnet/address/" },
             { "asset_registry_onion_url", "http://lhquhzzpzg5tyymcqep24fynpzzqqg3m3rlh7ascnw5cpqsro35bfxyd.onion/testnet/" },
             { "asset_registry_url", "https://assets-testnet.blockstream.info/" },
@@ -636,7 +643,7 @@ static std::map<std::string, std::shared_ptr<nlohmann::json>> registered_network
             { "wamp_cert_roots", wamp_cert_roots },
             { "wamp_onion_url", std::string() },
             { "wamp_url", std::string() },
-        })) },
+        }); } } },
 };
 // clang-format on
 
@@ -646,16 +653,37 @@ static std::mutex registered_networks_mutex;
 namespace ga {
 namespace sdk {
     namespace {
-        static std::string get_url(
-            const nlohmann::json& details, const char* url_key, const char* onion_key, bool use_tor)
+        // Get a registered network's details, constructing them if needed.
+        // The caller must hold registered_networks_mutex
+        static const nlohmann::json& get_details(network_entry& entry)
+        {
+            if (!entry.details) {
+                entry.details = std::make_shared<nlohmann::json>(entry.make_details());
+            }
+            return *entry.details;
+        }
+
+        template <typename T> static T get_value(const nlohmann::json& details, const char* key, const T& default_)
+        {
+            return json_get_value(details, key, default_);
+        }
+        static std::string get_value(const nlohmann::json& details, const char* key)
+        {
+            return json_get_value(details, key, std::string());
+        }
+
+        static std::string get_url(const nlohmann::json& details, const char* url_key, const char* onion_key,
+            bool use_tor, bool is_required = true)
         {
+            // Required urls must be given, although their onion urls may be empty
+            std::string onion;
             if (use_tor) {
-                std::string onion = details.at(onion_key);
-                if (!onion.empty()) {
-                    return onion;
-                }
+                onion = is_required ? details.at(onion_key).get<std::string>() : get_value(details, onion_key);
             }
-            return details.at(url_key);
+            if (!onion.empty()) {
+                return onion;
+            }
+            return is_required ? details.at(url_key).get<std::string>() : get_value(details, url_key);
         }
 
         template <typename T>
@@ -670,8 +698,13 @@ namespace sdk {
         {
             const std::string empty;
             // Set override-able settings from the users parameters
+            set_override(defaults, "address_pool_size", user_overrides, 0);
             set_override(defaults, "asset_registry_onion_url", user_overrides, empty);
             set_override(defaults, "asset_registry_url", user_overrides, empty);
+            set_override(defaults, "background_tx_sync", user_overrides, false);
+            set_override(defaults, "cache_page_size", user_overrides, 0);
+            set_override(defaults, "cache_memory_kb", user_overrides, 0);
+            set_override(defaults, "cache_temp_store", user_overrides, 0);
             set_override(defaults, "cert_expiry_threshold", user_overrides, 1);
             set_override(defaults, "electrum_onion_url", user_overrides, empty);
             set_override(defaults, "electrum_tls", user_overrides, false);
@@ -686,6 +719,7 @@ namespace sdk {
             set_override(defaults, "spv_servers", user_overrides, nlohmann::json::array());
             set_override(defaults, "use_tor", user_overrides, false);
             set_override(defaults, "user_agent", user_overrides, empty);
+            set_override(defaults, "warm_login", user_overrides, false);
             set_override(defaults, "blob_server_onion_url", user_overrides, empty);
             set_override(defaults, "blob_server_url", user_overrides, empty);
 
@@ -694,13 +728,110 @@ namespace sdk {
         }
     } // namespace
 
+    struct network_parameters::parsed_details {
+        explicit parsed_details(const nlohmann::json& details)
+            : network(details.at("network"))
+            , wamp_url(details.at("wamp_url"))
+            , wamp_onion_url(details.at("wamp_onion_url"))
+            , wamp_cert_pins(details.at("wamp_cert_pins").get<std::vector<std::string>>())
+            , wamp_cert_roots(details.at("wamp_cert_roots").get<std::vector<std::string>>())
+            , address_explorer_url(details.at("address_explorer_url"))
+            , tx_explorer_url(details.at("tx_explorer_url"))
+            , service_chain_code(details.at("service_chain_code"))
+            , service_pubkey(details.at("service_pubkey"))
+            , pin_server_public_key(details.at("pin_server_public_key"))
+            , policy_asset(get_value(details, "policy_asset", std::string("btc")))
+            , bip21_prefix(details.at("bip21_prefix"))
+            , bech32_prefix(details.at("bech32_prefix"))
+            , blech32_prefix(get_value(details, "blech32_prefix"))
+            , user_agent(get_value(details, "user_agent"))
+            , csv_buckets(details.at("csv_buckets").get<std::vector<uint32_t>>())
+            , p2pkh_version(details.at("p2pkh_version"))
+            , p2sh_version(details.at("p2sh_version"))
+            // Only required for Liquid networks
+            , blinded_prefix(get_value(details, "liquid", false) ? details.at("blinded_prefix").get<uint32_t>() : 0)
+            // Not given by the built in networks: set by get_network_overrides
+            , cert_expiry_threshold(get_value<uint32_t>(details, "cert_expiry_threshold", 0))
+            , max_reorg_blocks(details.at("max_reorg_blocks"))
+            , address_pool_size(get_value<uint32_t>(details, "address_pool_size", 0))
+            , cache_page_size(get_value<uint32_t>(details, "cache_page_size", 0))
+            , cache_memory_kb(get_value<uint32_t>(details, "cache_memory_kb", 0))
+            , cache_temp_store(get_value<uint32_t>(details, "cache_temp_store", 0))
+            , is_main_net(details.at("mainnet"))
+            , is_liquid(get_value(details, "liquid", false))
+            , is_development(details.at("development"))
+            , is_electrum(get_value(details, "server_type") == "electrum")
+            , use_tor(get_value(details, "use_tor", false))
+            , is_spv_enabled(details.at("spv_enabled"))
+            , is_background_tx_sync_enabled(get_value(details, "background_tx_sync", false))
+            , is_warm_login_enabled(get_value(details, "warm_login", false))
+            , electrum_tls(details.at("electrum_tls"))
+            , electrum_url(get_url(details, "electrum_url", "electrum_onion_url", use_tor))
+            , pin_server_url(get_url(details, "pin_server_url", "pin_server_onion_url", use_tor))
+            , blob_server_url(get_url(details, "blob_server_url", "blob_server_onion_url", use_tor))
+            // Only given for Liquid networks
+            , registry_connection_string(
+                  get_url(details, "asset_registry_url", "asset_registry_onion_url", use_tor, false))
+            , price_url(get_url(details, "price_url", "price_onion_url", use_tor))
+            , connection_string(use_tor ? wamp_onion_url : wamp_url)
+            , is_tls_connection(boost::algorithm::starts_with(connection_string, "wss://"))
+        {
+        }
+
+        // Note that members are initialized in declaration order
+        const std::string network;
+        const std::string wamp_url;
+        const std::string wamp_onion_url;
+        const std::vector<std::string> wamp_cert_pins;
+        const std::vector<std::string> wamp_cert_roots;
+        const std::string address_explorer_url;
+        const std::string tx_explorer_url;
+        const std::string service_chain_code;
+        const std::string service_pubkey;
+        const std::string pin_server_public_key;
+        const std::string policy_asset;
+        const std::string bip21_prefix;
+        const std::string bech32_prefix;
+        const std::string blech32_prefix;
+        const std::string user_agent;
+        const std::vector<uint32_t> csv_buckets;
+        const unsigned char p2pkh_version;
+        const unsigned char p2sh_version;
+        const uint32_t blinded_prefix;
+        const uint32_t cert_expiry_threshold;
+        const uint32_t max_reorg_blocks;
+        const uint32_t address_pool_size;
+        const uint32_t cache_page_size;
+        const uint32_t cache_memory_kb;
+        const uint32_t cache_temp_store;
+        const bool is_main_net;
+        const bool is_liquid;
+        const bool is_development;
+        const bool is_electrum;
+        const bool use_tor;
+        const bool is_spv_enabled;
+        const bool is_background_tx_sync_enabled;
+        const bool is_warm_login_enabled;
+        const bool electrum_tls;
+        // Values depending on whether tor is used
+        const std::string electrum_url;
+        const std::string pin_server_url;
+        const std::string blob_server_url;
+        const std::string registry_connection_string;
+        const std::string price_url;
+        const std::string connection_string;
+        const bool is_tls_connection;
+    };
+
     network_parameters::network_parameters(const nlohmann::json& details)
         : m_details(details)
+        , m_parsed(std::make_shared<const parsed_details>(m_details))
     {
     }
 
     network_parameters::network_parameters(const nlohmann::json& user_overrides, nlohmann::json& defaults)
         : m_details(get_network_overrides(user_overrides, defaults))
+        , m_parsed(std::make_shared<const parsed_details>(m_details))
     {
     }
 
@@ -720,7 +851,7 @@ namespace sdk {
         } else {
             // Validate and add, overwriting any existing entry
             auto np = std::make_shared<nlohmann::json>(network_parameters(details).get_json());
-            registered_networks[name] = np;
+            registered_networks[name] = network_entry{ nullptr, np };
         }
     }
 
@@ -732,8 +863,8 @@ namespace sdk {
 
         std::unique_lock<std::mutex> l{ registered_networks_mutex };
         all_networks.reserve(registered_networks.size());
-        for (const auto& p : registered_networks) {
-            ret[p.first] = *p.second;
+        for (auto& p : registered_networks) {
+            ret[p.first] = get_details(p.second);
             if (std::find(all_networks.begin(), all_networks.end(), p.first) == all_networks.end()) {
                 all_networks.emplace_back(p.first);
             }
@@ -750,60 +881,59 @@ namespace sdk {
         if (p == registered_networks.end()) {
             throw user_error("Unknown network");
         }
-        return *p->second;
+        return get_details(p->second);
     }
 
-    std::string network_parameters::network() const { return m_details.at("network"); }
-    std::string network_parameters::gait_wamp_url() const { return m_details.at("wamp_url"); }
-    std::vector<std::string> network_parameters::gait_wamp_cert_pins() const { return m_details.at("wamp_cert_pins"); }
-    std::vector<std::string> network_parameters::gait_wamp_cert_roots() const
+    const std::string& network_parameters::network() const { return m_parsed->network; }
+    const std::string& network_parameters::gait_wamp_url() const { return m_parsed->wamp_url; }
+    const std::vector<std::string>& network_parameters::gait_wamp_cert_pins() const
     {
-        return m_details.at("wamp_cert_roots");
+        return m_parsed->wamp_cert_pins;
     }
-    std::string network_parameters::block_explorer_address() const { return m_details.at("address_explorer_url"); }
-    std::string network_parameters::block_explorer_tx() const { return m_details.at("tx_explorer_url"); }
-    std::string network_parameters::chain_code() const { return m_details.at("service_chain_code"); }
-    bool network_parameters::electrum_tls() const { return m_details.at("electrum_tls"); }
-    std::string network_parameters::electrum_url() const
+    const std::vector<std::string>& network_parameters::gait_wamp_cert_roots() const
     {
-        return get_url(m_details, "electrum_url", "electrum_onion_url", use_tor());
+        return m_parsed->wamp_cert_roots;
     }
-    std::string network_parameters::get_pin_server_url() const
+    const std::string& network_parameters::block_explorer_address() const { return m_parsed->address_explorer_url; }
+    const std::string& network_parameters::block_explorer_tx() const { return m_parsed->tx_explorer_url; }
+    const std::string& network_parameters::chain_code() const { return m_parsed->service_chain_code; }
+    bool network_parameters::electrum_tls() const { return m_parsed->electrum_tls; }
+    const std::string& network_parameters::electrum_url() const { return m_parsed->electrum_url; }
+    const std::string& network_parameters::get_pin_server_url() const { return m_parsed->pin_server_url; }
+    const std::string& network_parameters::get_pin_server_public_key() const
     {
-        return get_url(m_details, "pin_server_url", "pin_server_onion_url", use_tor());
+        return m_parsed->pin_server_public_key;
     }
-    std::string network_parameters::get_pin_server_public_key() const { return m_details.at("pin_server_public_key"); }
-    std::string network_parameters::get_blob_server_url() const
+    const std::string& network_parameters::get_blob_server_url() const { return m_parsed->blob_server_url; }
+    const std::string& network_parameters::pub_key() const { return m_parsed->service_pubkey; }
+    const std::string& network_parameters::gait_onion() const { return m_parsed->wamp_onion_url; }
+    const std::string& network_parameters::get_policy_asset() const { return m_parsed->policy_asset; }
+    const std::string& network_parameters::bip21_prefix() const { return m_parsed->bip21_prefix; }
+    const std::string& network_parameters::bech32_prefix() const { return m_parsed->bech32_prefix; }
+    const std::string& network_parameters::blech32_prefix() const { return m_parsed->blech32_prefix; }
+    unsigned char network_parameters::btc_version() const { return m_parsed->p2pkh_version; }
+    unsigned char network_parameters::btc_p2sh_version() const { return m_parsed->p2sh_version; }
+    uint32_t network_parameters::blinded_prefix() const { return m_parsed->blinded_prefix; }
+    bool network_parameters::is_main_net() const { return m_parsed->is_main_net; }
+    bool network_parameters::is_liquid() const { return m_parsed->is_liquid; }
+    bool network_parameters::is_development() const { return m_parsed->is_development; }
+    bool network_parameters::is_electrum() const { return m_parsed->is_electrum; }
+    bool network_parameters::use_tor() const { return m_parsed->use_tor; }
+    bool network_parameters::is_spv_enabled() const { return m_parsed->is_spv_enabled; }
+    bool network_parameters::is_background_tx_sync_enabled() const { return m_parsed->is_background_tx_sync_enabled; }
+    bool network_parameters::is_warm_login_enabled() const { return m_parsed->is_warm_login_enabled; }
+    const std::string& network_parameters::user_agent() const { return m_parsed->user_agent; }
+    const std::string& network_parameters::get_connection_string() const { return m_parsed->connection_string; }
+    const std::string& network_parameters::get_registry_connection_string() const
     {
-        return get_url(m_details, "blob_server_url", "blob_server_onion_url", use_tor());
+        return m_parsed->registry_connection_string;
     }
-    std::string network_parameters::pub_key() const { return m_details.at("service_pubkey"); }
-    std::string network_parameters::gait_onion() const { return m_details.at("wamp_onion_url"); }
-    std::string network_parameters::get_policy_asset() const { return m_details.value("policy_asset", "btc"); }
-    std::string network_parameters::bip21_prefix() const { return m_details.at("bip21_prefix"); }
-    std::string network_parameters::bech32_prefix() const { return m_details.at("bech32_prefix"); }
-    std::string network_parameters::blech32_prefix() const { return m_details.value("blech32_prefix", std::string()); }
-    unsigned char network_parameters::btc_version() const { return m_details.at("p2pkh_version"); }
-    unsigned char network_parameters::btc_p2sh_version() const { return m_details.at("p2sh_version"); }
-    uint32_t network_parameters::blinded_prefix() const { return m_details.at("blinded_prefix"); }
-    bool network_parameters::is_main_net() const { return m_details.at("mainnet"); }
-    bool network_parameters::is_liquid() const { return m_details.value("liquid", false); }
-    bool network_parameters::is_development() const { return m_details.at("development"); }
-    bool network_parameters::is_electrum() const { return m_details.value("server_type", std::string()) == "electrum"; }
-    bool network_parameters::use_tor() const { return m_details.value("use_tor", false); }
-    bool network_parameters::is_spv_enabled() const { return m_details.at("spv_enabled"); }
-    std::string network_parameters::user_agent() const { return m_details.value("user_agent", std::string()); }
-    std::string network_parameters::get_connection_string() const { return use_tor() ? gait_onion() : gait_wamp_url(); }
-    std::string network_parameters::get_registry_connection_string() const
-    {
-        return get_url(m_details, "asset_registry_url", "asset_registry_onion_url", use_tor());
-    }
-    bool network_parameters::is_tls_connection() const
-    {
-        return boost::algorithm::starts_with(get_connection_string(), "wss://");
-    }
-    std::vector<uint32_t> network_parameters::csv_buckets() const { return m_details.at("csv_buckets"); }
-    uint32_t network_parameters::cert_expiry_threshold() const { return m_details.at("cert_expiry_threshold"); }
+    bool network_parameters::is_tls_connection() const { return m_parsed->is_tls_connection; }
+    const std::vector<uint32_t>& network_parameters::csv_buckets() const { return m_parsed->csv_buckets; }
+    uint32_t network_parameters::cert_expiry_threshold() const { return m_parsed->cert_expiry_threshold; }
+    uint32_t network_parameters::get_cache_page_size() const { return m_parsed->cache_page_size; }
+    uint32_t network_parameters::get_cache_memory_kb() const { return m_parsed->cache_memory_kb; }
+    uint32_t network_parameters::get_cache_temp_store() const { return m_parsed->cache_temp_store; }
     // max_reorg_blocks indicates the maximum number of blocks that gdk will expect to re-org on-chain.
     // In the event that a re-org is larger than this value, AND the user has a tx re-orged in a block
     // older than the current tip minus max_reorg_blocks, cached data may become out of date and will
@@ -813,10 +943,8 @@ namespace sdk {
     // BTC testnet/regtest are set to one week (7 * 144 blocks), this allows regtest test runs under
     // a weeks worth of blocks without cache deletion, and for testnet still allows cache finalization
     // testing while being unnaffected by normal chain operation.
-    uint32_t network_parameters::get_max_reorg_blocks() const { return m_details.at("max_reorg_blocks"); }
-    std::string network_parameters::get_price_url() const
-    {
-        return get_url(m_details, "price_url", "price_onion_url", use_tor());
-    }
+    uint32_t network_parameters::get_max_reorg_blocks() const { return m_parsed->max_reorg_blocks; }
+    uint32_t network_parameters::get_address_pool_size() const { return m_parsed->address_pool_size; }
+    const std::string& network_parameters::get_price_url() const { return m_parsed->price_url; }
 } // namespace sdk
 } // namespace ga
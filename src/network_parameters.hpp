@@ -34,22 +34,22 @@ namespace sdk {
 
         const nlohmann::json& get_json() const { return m_details; }
 
-        std::string network() const;
-        std::string gait_wamp_url() const;
-        std::vector<std::string> gait_wamp_cert_pins() const;
-        std::vector<std::string> gait_wamp_cert_roots() const;
-        std::string block_explorer_address() const;
-        std::string block_explorer_tx() const;
-        std::string chain_code() const;
-        std::string electrum_url() const;
-        std::string get_pin_server_url() const;
-        std::string get_pin_server_public_key() const;
-        std::string pub_key() const;
-        std::string gait_onion() const;
-        std::string get_policy_asset() const;
-        std::string bip21_prefix() const;
-        std::string bech32_prefix() const;
-        std::string blech32_prefix() const;
+        const std::string& network() const;
+        const std::string& gait_wamp_url() const;
+        const std::vector<std::string>& gait_wamp_cert_pins() const;
+        const std::vector<std::string>& gait_wamp_cert_roots() const;
+        const std::string& block_explorer_address() const;
+        const std::string& block_explorer_tx() const;
+        const std::string& chain_code() const;
+        const std::string& electrum_url() const;
+        const std::string& get_pin_server_url() const;
+        const std::string& get_pin_server_public_key() const;
+        const std::string& pub_key() const;
+        const std::string& gait_onion() const;
+        const std::string& get_policy_asset() const;
+        const std::string& bip21_prefix() const;
+        const std::string& bech32_prefix() const;
+        const std::string& blech32_prefix() const;
         unsigned char btc_version() const;
         unsigned char btc_p2sh_version() const;
         uint32_t blinded_prefix() const;
@@ -59,19 +59,30 @@ namespace sdk {
         bool is_electrum() const;
         bool use_tor() const;
         bool is_spv_enabled() const;
+        bool is_background_tx_sync_enabled() const;
+        bool is_warm_login_enabled() const;
         bool electrum_tls() const;
-        std::string user_agent() const;
-        std::string get_connection_string() const;
-        std::string get_blob_server_url() const;
-        std::string get_registry_connection_string() const;
+        const std::string& user_agent() const;
+        const std::string& get_connection_string() const;
+        const std::string& get_blob_server_url() const;
+        const std::string& get_registry_connection_string() const;
         bool is_tls_connection() const;
-        std::vector<uint32_t> csv_buckets() const;
+        const std::vector<uint32_t>& csv_buckets() const;
         uint32_t cert_expiry_threshold() const;
+        // SQLite settings for the local cache, 0 for the SQLite defaults
+        uint32_t get_cache_page_size() const;
+        uint32_t get_cache_memory_kb() const;
+        uint32_t get_cache_temp_store() const;
         uint32_t get_max_reorg_blocks() const;
-        std::string get_price_url() const;
+        uint32_t get_address_pool_size() const;
+        const std::string& get_price_url() const;
 
     private:
+        // Typed values parsed once from m_details, shared between copies
+        struct parsed_details;
+
         nlohmann::json m_details;
+        std::shared_ptr<const parsed_details> m_parsed;
     };
 } // namespace sdk
 } // namespace ga
@@ -0,0 +1,66 @@
+#include "network_state.hpp"
+
+namespace ga {
+namespace sdk {
+
+    namespace {
+        std::mutex g_network_states_mutex;
+        std::map<std::string, std::weak_ptr<network_state>> g_network_states;
+    } // namespace
+
+    std::shared_ptr<network_state> network_state::get(const std::string& network)
+    {
+        std::unique_lock<std::mutex> locker(g_network_states_mutex);
+        auto& weak_state = g_network_states[network];
+        auto state = weak_state.lock();
+        if (!state) {
+            state = std::make_shared<network_state>(network);
+            weak_state = state;
+        }
+        // Remove the entries of networks no longer in use
+        for (auto p = g_network_states.begin(); p != g_network_states.end();) {
+            if (p->second.expired()) {
+                p = g_network_states.erase(p);
+            } else {
+                ++p;
+            }
+        }
+        return state;
+    }
+
+    network_state::network_state(const std::string& network)
+        : m_network(network)
+    {
+    }
+
+    void network_state::set(const std::string& key, nlohmann::json value)
+    {
+        auto new_value = std::make_shared<const nlohmann::json>(std::move(value));
+        const auto now = clock::now();
+        std::unique_lock<std::mutex> locker(m_mutex);
+        auto& v = m_values[key];
+        std::swap(v.value, new_value);
+        v.updated = now;
+        locker.unlock(); // Destroy any previous value outside of the lock
+    }
+
+    network_state::value_t network_state::get_value(const std::string& key) const
+    {
+        std::unique_lock<std::mutex> locker(m_mutex);
+        const auto p = m_values.find(key);
+        return p == m_values.end() ? value_t() : p->second;
+    }
+
+    network_state::value_t network_state::get_current(
+        const std::string& key, clock::time_point since, clock::duration max_age) const
+    {
+        const auto v = get_value(key);
+        const auto now = clock::now();
+        if (v.value && v.updated > since && now >= v.updated && now - v.updated <= max_age) {
+            return v;
+        }
+        return value_t();
+    }
+
+} // namespace sdk
+} // namespace ga
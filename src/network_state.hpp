@@ -0,0 +1,60 @@
+#ifndef GDK_NETWORK_STATE_HPP
+#define GDK_NETWORK_STATE_HPP
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace ga {
+namespace sdk {
+
+    // Global data about a network, such as its latest block, fee estimates
+    // and fiat tickers, shared between all sessions connected to it.
+    //
+    // Each value is stored once per process, as received by whichever
+    // session most recently fetched or was notified of it. Sessions can
+    // then use a current value instead of fetching it again themselves.
+    // Instances are reference counted and destroyed when the last session
+    // for the network releases it. Thread safe.
+    class network_state final {
+    public:
+        using clock = std::chrono::system_clock;
+
+        struct value_t {
+            std::shared_ptr<const nlohmann::json> value; // Null if never set
+            clock::time_point updated;
+        };
+
+        // Return the shared state for a network, creating it if required
+        static std::shared_ptr<network_state> get(const std::string& network);
+
+        explicit network_state(const std::string& network);
+        network_state(const network_state&) = delete;
+        network_state& operator=(const network_state&) = delete;
+        network_state(network_state&&) = delete;
+        network_state& operator=(network_state&&) = delete;
+
+        const std::string& get_network() const { return m_network; }
+
+        // Store a new value for key
+        void set(const std::string& key, nlohmann::json value);
+        // Get the value for key
+        value_t get_value(const std::string& key) const;
+        // Get the value for key if it was updated after 'since' and is no
+        // older than max_age, otherwise a null value
+        value_t get_current(const std::string& key, clock::time_point since, clock::duration max_age) const;
+
+    private:
+        const std::string m_network;
+        mutable std::mutex m_mutex;
+        std::map<std::string, value_t> m_values;
+    };
+
+} // namespace sdk
+} // namespace ga
+
+#endif
@@ -0,0 +1,134 @@
+#include <algorithm>
+
+#include "assertion.hpp"
+#include "containers.hpp"
+#include "notification_queue.hpp"
+#include "threading.hpp"
+#include "utils.hpp"
+
+namespace ga {
+namespace sdk {
+
+    namespace {
+        // Whether a notification for an event supersedes any prior one
+        static bool is_coalescable(const nlohmann::json& details)
+        {
+            const auto event_p = details.find("event");
+            if (event_p == details.end() || !event_p->is_string()) {
+                return false;
+            }
+            const auto& event = event_p->get_ref<const std::string&>();
+            return event == "block" || event == "fees" || event == "ticker";
+        }
+    } // namespace
+
+    notification_queue::notification_queue(handler_t handler, size_t max_size)
+        : m_handler(std::move(handler))
+        , m_max_size(max_size)
+        , m_stopped(false)
+        , m_num_queued(0)
+        , m_num_delivered(0)
+        , m_num_coalesced(0)
+        , m_num_dropped(0)
+        , m_num_backpressure_waits(0)
+        , m_max_depth(0)
+        , m_strand(get_notification_pool())
+    {
+        GDK_RUNTIME_ASSERT(m_handler && m_max_size);
+    }
+
+    notification_queue::~notification_queue()
+    {
+        no_std_exception_escape([this] { stop(); }, "notification_queue dtor");
+    }
+
+    void notification_queue::push(nlohmann::json details, bool can_wait)
+    {
+        locker_t locker(m_mutex);
+        if (m_stopped) {
+            ++m_num_dropped;
+            return;
+        }
+        if (is_coalescable(details)) {
+            const auto& event = details["event"];
+            const auto p = std::find_if(m_queue.begin(), m_queue.end(),
+                [&event](const nlohmann::json& queued) { return queued.value("event", nlohmann::json()) == event; });
+            if (p != m_queue.end()) {
+                // Remove the superseded notification. The new notification
+                // is appended so it is ordered after those queued before it.
+                m_queue.erase(p);
+                ++m_num_coalesced;
+            }
+        }
+        if (m_queue.size() >= m_max_size && can_wait && !m_strand.running_in_this_thread()) {
+            // Apply backpressure, unless we are being called from the
+            // handler, in which case waiting would deadlock
+            ++m_num_backpressure_waits;
+            m_cv.wait(locker, [this] { return m_stopped || m_queue.size() < m_max_size; });
+            if (m_stopped) {
+                ++m_num_dropped;
+                return;
+            }
+        }
+        if (m_queue.size() >= m_max_size) {
+            // We can't wait for space: drop the oldest notification
+            m_queue.pop_front();
+            ++m_num_dropped;
+        }
+        m_queue.emplace_back(std::move(details));
+        ++m_num_queued;
+        m_max_depth = std::max(m_max_depth, m_queue.size());
+        // Each push schedules one delivery. Deliveries of notifications that
+        // have since been coalesced or dropped find nothing more to deliver
+        m_strand.post([this] { dispatch(); });
+    }
+
+    void notification_queue::stop()
+    {
+        {
+            locker_t locker(m_mutex);
+            m_stopped = true;
+            m_num_dropped += m_queue.size();
+            m_queue.clear();
+        }
+        m_cv.notify_all();
+        // Wait for any in-progress delivery to finish
+        m_strand.stop();
+    }
+
+    nlohmann::json notification_queue::get_metrics() const
+    {
+        locker_t locker(m_mutex);
+        return { { "queued", m_num_queued }, { "delivered", m_num_delivered }, { "coalesced", m_num_coalesced },
+            { "dropped", m_num_dropped }, { "backpressure_waits", m_num_backpressure_waits },
+            { "depth", m_queue.size() }, { "max_depth", m_max_depth }, { "capacity", m_max_size } };
+    }
+
+    size_t notification_queue::get_memory_usage() const
+    {
+        locker_t locker(m_mutex);
+        size_t total = 0;
+        for (const auto& details : m_queue) {
+            total += json_get_memory_usage(details);
+        }
+        return total;
+    }
+
+    void notification_queue::dispatch()
+    {
+        locker_t locker(m_mutex);
+        if (m_stopped || m_queue.empty()) {
+            return;
+        }
+        nlohmann::json details = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_cv.notify_all(); // Wake any producers waiting for space
+        {
+            unique_unlock unlocker(locker);
+            no_std_exception_escape([this, &details] { m_handler(std::move(details)); }, "notification handler");
+        }
+        ++m_num_delivered;
+    }
+
+} // namespace sdk
+} // namespace ga
@@ -0,0 +1,79 @@
+#ifndef GDK_NOTIFICATION_QUEUE_HPP
+#define GDK_NOTIFICATION_QUEUE_HPP
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <nlohmann/json.hpp>
+
+#include "thread_pool.hpp"
+
+namespace ga {
+namespace sdk {
+
+    // A bounded queue of notifications delivered to a handler from the
+    // shared notification pool, so that a slow handler does not stall the
+    // threads producing notifications. Notifications are delivered one at a time,
+    // in order, through a strand.
+    //
+    // Notifications for events that supersede earlier ones of the same
+    // type ("block", "fees" and "ticker") replace any queued but not yet
+    // delivered notification for that event. When the queue is full,
+    // producers that are able to wait do so until the handler has made
+    // space. Producers that can't wait instead discard the oldest queued
+    // notification.
+    class notification_queue final {
+    public:
+        using handler_t = std::function<void(nlohmann::json&&)>;
+
+        notification_queue(handler_t handler, size_t max_size);
+        ~notification_queue();
+
+        notification_queue(const notification_queue&) = delete;
+        notification_queue& operator=(const notification_queue&) = delete;
+        notification_queue(notification_queue&&) = delete;
+        notification_queue& operator=(notification_queue&&) = delete;
+
+        // Queue a notification for delivery. If the queue is full and
+        // can_wait is false, the oldest queued notification is dropped.
+        void push(nlohmann::json details, bool can_wait = true);
+
+        // Discard any queued notifications and wait for any notification
+        // currently being delivered to complete. Subsequent notifications
+        // are discarded.
+        void stop();
+
+        // Return counters describing the queue's behaviour
+        nlohmann::json get_metrics() const;
+
+        // Return the approximate memory used by queued notifications
+        size_t get_memory_usage() const;
+
+    private:
+        using locker_t = std::unique_lock<std::mutex>;
+
+        void dispatch();
+
+        const handler_t m_handler;
+        const size_t m_max_size;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<nlohmann::json> m_queue;
+        bool m_stopped;
+
+        uint64_t m_num_queued;
+        uint64_t m_num_delivered;
+        uint64_t m_num_coalesced;
+        uint64_t m_num_dropped;
+        uint64_t m_num_backpressure_waits;
+        size_t m_max_depth;
+        strand m_strand;
+    };
+
+} // namespace sdk
+} // namespace ga
+
+#endif
@@ -13,9 +13,14 @@
 #include "exception.hpp"
 #include "ga_rust.hpp"
 #include "ga_session.hpp"
+#include "ga_tor.hpp"
+#include "io_context_pool.hpp"
 #include "logging.hpp"
 #include "network_parameters.hpp"
 #include "signer.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include "traffic_capture.hpp"
 #include "utils.hpp"
 
 using namespace std::literals;
@@ -76,7 +81,26 @@ namespace sdk {
         } else if (level == "error") {
             global_log_level = log_level::severity_level::error;
         }
-        boost::log::core::get()->set_filter(log_level::severity >= global_log_level);
+        init_logging(global_log_level);
+
+        if (global_config.contains("worker_threads")) {
+            init_thread_pool(global_config["worker_threads"].get<size_t>());
+        }
+        if (global_config.contains("call_threads")) {
+            init_call_pool(global_config["call_threads"].get<size_t>());
+        }
+        if (global_config.contains("io_threads")) {
+            init_io_context_pool(global_config["io_threads"].get<size_t>());
+        }
+        if (global_config.contains("trace_file")) {
+            init_tracing(global_config["trace_file"]);
+        }
+        if (global_config.contains("capture_file")) {
+            const auto mode = json_get_value(global_config, "capture_mode", std::string("record"));
+            GDK_RUNTIME_ASSERT_MSG(mode == "record" || mode == "replay", "unknown capture_mode " + mode);
+            init_capture(global_config["capture_file"], mode == "record" ? capture_mode::record : capture_mode::replay,
+                json_get_value(global_config, "capture_latency_ms", 0u));
+        }
 
         GDK_VERIFY(wally_init(0));
         auto entropy = get_random_bytes<WALLY_SECP_RANDOMIZE_LEN>();
@@ -90,6 +114,10 @@ namespace sdk {
         init_rust(global_config);
         init_done = true;
 
+        if (json_get_value(global_config, "tor_prebootstrap", false)) {
+            tor_controller::prebootstrap();
+        }
+
         return GA_OK;
     }
 
@@ -147,10 +175,11 @@ namespace sdk {
         }
     }
 
-    template <typename F, typename... Args> auto session::exception_wrapper(F&& f, Args&&... args)
+    template <typename F> auto session::exception_wrapper(const char* method_name, F&& f)
     {
+        call_metrics::timer timer(m_api_metrics, method_name);
         try {
-            return f(std::forward<Args>(args)...);
+            return f();
         } catch (...) {
             exception_handler(std::current_exception());
         }
@@ -192,6 +221,7 @@ namespace sdk {
                     << "destroying " << (is_electrum ? "single" : "multi") << "sig session " << (void*)this;
                 p->disconnect();
             }
+            dump_trace();
         });
     }
 
@@ -209,7 +239,7 @@ namespace sdk {
 
     void session::reconnect_hint(const nlohmann::json& hint)
     {
-        exception_wrapper([&] {
+        exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             p->reconnect_hint(hint);
         });
@@ -217,15 +247,58 @@ namespace sdk {
 
     nlohmann::json session::get_proxy_settings()
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_proxy_settings();
         });
     }
 
+    nlohmann::json session::get_notification_metrics()
+    {
+        return exception_wrapper(__func__, [&] {
+            auto p = get_nonnull_impl();
+            return p->get_notification_metrics();
+        });
+    }
+
+    nlohmann::json session::get_metrics()
+    {
+        return exception_wrapper(__func__, [&] {
+            auto p = get_impl();
+            nlohmann::json result = p ? p->get_metrics() : nlohmann::json::object();
+            result["api"] = m_api_metrics.get_json();
+            return result;
+        });
+    }
+
+    nlohmann::json session::get_memory_usage()
+    {
+        return exception_wrapper(__func__, [&] {
+            auto p = get_impl();
+            nlohmann::json result = p ? p->get_memory_usage() : nlohmann::json::object();
+            size_t total = 0;
+            for (const auto& item : result.items()) {
+                total += item.value().get<size_t>();
+            }
+            result["total"] = total;
+            return result;
+        });
+    }
+
+    void session::trim_memory()
+    {
+        exception_wrapper(__func__, [&] {
+            if (auto p = get_impl()) {
+                p->trim_memory();
+            }
+        });
+    }
+
+    call_metrics& session::get_api_metrics() { return m_api_metrics; }
+
     nlohmann::json session::http_request(const nlohmann::json& params)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->http_request(params);
         });
@@ -233,7 +306,7 @@ namespace sdk {
 
     void session::refresh_assets(const nlohmann::json& params)
     {
-        exception_wrapper([&] {
+        exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             p->refresh_assets(params);
         });
@@ -241,7 +314,7 @@ namespace sdk {
 
     nlohmann::json session::get_assets(const nlohmann::json& params)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_assets(params);
         });
@@ -249,7 +322,7 @@ namespace sdk {
 
     nlohmann::json session::validate_asset_domain_name(const nlohmann::json& params)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->validate_asset_domain_name(params);
         });
@@ -257,7 +330,7 @@ namespace sdk {
 
     bool session::set_wo_credentials(const std::string& username, const std::string& password)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->set_wo_credentials(username, password);
         });
@@ -265,7 +338,7 @@ namespace sdk {
 
     std::string session::get_wo_username()
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_wo_username();
         });
@@ -273,7 +346,7 @@ namespace sdk {
 
     void session::rename_subaccount(uint32_t subaccount, const std::string& new_name)
     {
-        exception_wrapper([&] {
+        exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             p->rename_subaccount(subaccount, new_name);
         });
@@ -281,7 +354,7 @@ namespace sdk {
 
     nlohmann::json session::get_settings()
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_settings();
         });
@@ -307,7 +380,7 @@ namespace sdk {
 
     nlohmann::json session::get_available_currencies()
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_available_currencies();
         });
@@ -315,7 +388,7 @@ namespace sdk {
 
     nlohmann::json session::get_twofactor_config(bool reset_cached)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_twofactor_config(reset_cached);
         });
@@ -323,7 +396,7 @@ namespace sdk {
 
     nlohmann::json session::encrypt_with_pin(const nlohmann::json& details)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->encrypt_with_pin(details);
         });
@@ -331,7 +404,7 @@ namespace sdk {
 
     nlohmann::json session::decrypt_with_pin(const nlohmann::json& details)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->decrypt_with_pin(details);
         });
@@ -339,7 +412,7 @@ namespace sdk {
 
     void session::disable_all_pin_logins()
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->disable_all_pin_logins();
         });
@@ -348,15 +421,23 @@ namespace sdk {
     nlohmann::json session::get_unspent_outputs_for_private_key(
         const std::string& private_key, const std::string& password, uint32_t unused)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_unspent_outputs_for_private_key(private_key, password, unused);
         });
     }
 
+    nlohmann::json session::get_unspent_outputs_for_private_keys(const nlohmann::json& details)
+    {
+        return exception_wrapper(__func__, [&] {
+            auto p = get_nonnull_impl();
+            return p->get_unspent_outputs_for_private_keys(details);
+        });
+    }
+
     std::string session::broadcast_transaction(const std::string& tx_hex)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->broadcast_transaction(tx_hex);
         });
@@ -364,7 +445,7 @@ namespace sdk {
 
     void session::send_nlocktimes()
     {
-        exception_wrapper([&] {
+        exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             p->send_nlocktimes();
         });
@@ -372,7 +453,7 @@ namespace sdk {
 
     void session::set_transaction_memo(const std::string& txhash_hex, const std::string& memo)
     {
-        exception_wrapper([&] {
+        exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             p->set_transaction_memo(txhash_hex, memo);
         });
@@ -380,7 +461,7 @@ namespace sdk {
 
     nlohmann::json session::get_transaction_details(const std::string& txhash_hex)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_transaction_details(txhash_hex);
         });
@@ -388,7 +469,7 @@ namespace sdk {
 
     std::string session::get_system_message()
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_system_message();
         });
@@ -396,7 +477,7 @@ namespace sdk {
 
     nlohmann::json session::get_fee_estimates()
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_nonnull_impl();
             return p->get_fee_estimates();
         });
@@ -404,7 +485,7 @@ namespace sdk {
 
     nlohmann::json session::convert_amount(const nlohmann::json& amount_json)
     {
-        return exception_wrapper([&] {
+        return exception_wrapper(__func__, [&] {
             auto p = get_impl();
             if (p) {
                 return p->convert_amount(amount_json);
@@ -415,6 +496,26 @@ namespace sdk {
         });
     }
 
+    void session::convert_amounts(
+        const int64_t* satoshi, size_t num_values, const std::string& denomination, char* output)
+    {
+        exception_wrapper(__func__, [&] {
+            std::string fiat_rate;
+            if (denomination == "fiat") {
+                // Fetch the current rate once for all of the values
+                auto p = get_impl();
+                if (p) {
+                    const auto converted = p->convert_amount({ { "satoshi", 0 } });
+                    const auto& rate = converted.at("fiat_rate");
+                    if (rate.is_string()) {
+                        fiat_rate = rate;
+                    }
+                }
+            }
+            amount::convert(satoshi, num_values, denomination, fiat_rate, output);
+        });
+    }
+
     const network_parameters& session::get_network_parameters() const
     {
         auto p = get_nonnull_impl();
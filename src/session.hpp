@@ -8,6 +8,7 @@
 
 #include "gdk.h"
 
+#include "call_metrics.hpp"
 #include "ga_wally.hpp"
 
 namespace ga {
@@ -35,6 +36,11 @@ namespace sdk {
         void reconnect_hint(const nlohmann::json& hint);
 
         nlohmann::json get_proxy_settings();
+        nlohmann::json get_notification_metrics();
+        nlohmann::json get_metrics();
+        nlohmann::json get_memory_usage();
+        void trim_memory();
+        call_metrics& get_api_metrics();
 
         nlohmann::json http_request(const nlohmann::json& params);
         void refresh_assets(const nlohmann::json& params);
@@ -59,6 +65,7 @@ namespace sdk {
 
         nlohmann::json get_unspent_outputs_for_private_key(
             const std::string& private_key, const std::string& password, uint32_t unused);
+        nlohmann::json get_unspent_outputs_for_private_keys(const nlohmann::json& details);
 
         nlohmann::json get_transaction_details(const std::string& txhash_hex);
 
@@ -73,6 +80,8 @@ namespace sdk {
         std::string get_system_message();
 
         nlohmann::json convert_amount(const nlohmann::json& amount_json);
+        void convert_amounts(
+            const int64_t* satoshi, size_t num_values, const std::string& denomination, char* output);
 
         const network_parameters& get_network_parameters() const;
 
@@ -83,7 +92,7 @@ namespace sdk {
     private:
         using locker_t = std::unique_lock<std::mutex>;
 
-        template <typename F, typename... Args> auto exception_wrapper(F&& f, Args&&... args);
+        template <typename F> auto exception_wrapper(const char* method_name, F&& f);
 
         void signal_reconnect_and_throw();
 
@@ -94,6 +103,8 @@ namespace sdk {
 
         GA_notification_handler m_notification_handler;
         void* m_notification_context;
+
+        call_metrics m_api_metrics;
     };
 } // namespace sdk
 } // namespace ga
@@ -3,11 +3,15 @@
 #include "exception.hpp"
 #include "ga_rust.hpp"
 #include "ga_session.hpp"
+#include "ga_strings.hpp"
 #include "ga_tor.hpp"
 #include "ga_tx.hpp"
 #include "http_client.hpp"
+#include "io_context_pool.hpp"
 #include "logging.hpp"
+#include "notification_queue.hpp"
 #include "signer.hpp"
+#include "traffic_capture.hpp"
 #include "transaction_utils.hpp"
 #include "utils.hpp"
 #include "xpub_hdkey.hpp"
@@ -16,6 +20,12 @@ namespace ga {
 namespace sdk {
 
     namespace {
+        // Maximum number of undelivered notifications before producers wait
+        static constexpr size_t NOTIFICATION_QUEUE_SIZE = 1024;
+
+        // UTXO user_status value from the Green server for frozen UTXOs
+        static constexpr uint32_t USER_STATUS_FROZEN = 1;
+
         static void check_hint(const std::string& hint, const char* hint_type)
         {
             if (hint != "connect" && hint != "disconnect") {
@@ -24,17 +34,111 @@ namespace sdk {
             GDK_LOG_SEV(log_level::info) << "reconnect_hint: " << hint_type << ":" << hint;
         }
 
+        // Wallet UTXOs keyed by "txhash:pt_idx", for matching PSBT inputs
+        using utxo_index_t = std::unordered_map<std::string, const nlohmann::json*>;
+
+        static std::string get_outpoint_key(const std::string& txhash_hex, uint32_t pt_idx)
+        {
+            return txhash_hex + ":" + std::to_string(pt_idx);
+        }
+
+        static utxo_index_t index_utxos(const nlohmann::json& utxos)
+        {
+            utxo_index_t index;
+            index.reserve(utxos.size());
+            for (const auto& utxo : utxos) {
+                const std::string txhash_hex = json_get_value(utxo, "txhash");
+                if (!txhash_hex.empty() && utxo.contains("pt_idx")) {
+                    // The first matching UTXO is used if any are repeated
+                    index.emplace(get_outpoint_key(txhash_hex, utxo.at("pt_idx")), &utxo);
+                }
+            }
+            return index;
+        }
+
+        static const nlohmann::json* find_input_utxo(const utxo_index_t& index, const wally_tx_input& txin)
+        {
+            const auto p = index.find(get_outpoint_key(b2h_rev(txin.txhash), txin.index));
+            return p == index.end() ? nullptr : p->second;
+        }
     } // namespace
 
-    struct io_context_and_guard {
-        io_context_and_guard()
-            : m_io()
-            , m_work_guard(boost::asio::make_work_guard(m_io))
+    // Idle keep-alive HTTP connections, along with the SSL contexts and TLS
+    // sessions used to create and resume connections to each host
+    struct http_connection_pool {
+        // How long an idle connection is kept before being discarded
+        static constexpr auto IDLE_TIMEOUT = std::chrono::seconds(30);
+        // The maximum number of idle connections kept per endpoint
+        static constexpr size_t MAX_IDLE_PER_KEY = 2;
+
+        using clock = std::chrono::steady_clock;
+        using idle_entry_t = std::pair<std::shared_ptr<http_client>, clock::time_point>;
+
+        std::shared_ptr<boost::asio::ssl::context> get_ssl_context(
+            const std::string& host, const std::vector<std::string>& roots, uint32_t cert_expiry_threshold)
+        {
+            std::string key = host;
+            for (const auto& root : roots) {
+                key.append("\n").append(root);
+            }
+            std::lock_guard<std::mutex> locker(m_mutex);
+            auto& ctx = m_ssl_contexts[key];
+            if (!ctx) {
+                ctx = get_shared_tls_context(host, roots, {}, cert_expiry_threshold);
+            }
+            return ctx;
+        }
+
+        std::shared_ptr<SSL_SESSION> get_tls_session(const std::string& key)
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            const auto p = m_tls_sessions.find(key);
+            return p == m_tls_sessions.end() ? std::shared_ptr<SSL_SESSION>() : p->second;
+        }
+
+        void set_tls_session(const std::string& key, std::shared_ptr<SSL_SESSION> session)
+        {
+            if (session) {
+                std::lock_guard<std::mutex> locker(m_mutex);
+                m_tls_sessions[key] = std::move(session);
+            }
+        }
+
+        // Remove and return an idle connection for key, if one is available
+        std::shared_ptr<http_client> take(const std::string& key)
         {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            const auto now = clock::now();
+            auto range = m_idle.equal_range(key);
+            for (auto it = range.first; it != range.second;) {
+                auto client = std::move(it->second.first);
+                const bool is_fresh = now - it->second.second < IDLE_TIMEOUT;
+                it = m_idle.erase(it);
+                if (is_fresh && client->is_connected()) {
+                    return client;
+                }
+            }
+            return {};
         }
 
-        boost::asio::io_context m_io;
-        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_work_guard;
+        // Return a connection to the pool for reuse
+        void put(const std::string& key, std::shared_ptr<http_client> client)
+        {
+            if (!client->is_connected()) {
+                return;
+            }
+            std::lock_guard<std::mutex> locker(m_mutex);
+            if (m_idle.count(key) < MAX_IDLE_PER_KEY) {
+                m_idle.emplace(key, idle_entry_t{ std::move(client), clock::now() });
+            }
+        }
+
+    private:
+        std::mutex m_mutex;
+        // SSL contexts must outlive the connections using them
+        std::map<std::string, std::shared_ptr<boost::asio::ssl::context>> m_ssl_contexts;
+        std::map<std::string, std::shared_ptr<SSL_SESSION>> m_tls_sessions;
+        std::multimap<std::string, idle_entry_t> m_idle;
     };
 
     std::shared_ptr<session_impl> session_impl::create(const nlohmann::json& net_params)
@@ -50,8 +154,9 @@ namespace sdk {
 
     session_impl::session_impl(network_parameters&& net_params)
         : m_net_params(net_params)
-        , m_io(std::make_unique<io_context_and_guard>())
+        , m_io(std::make_unique<io_context_handle>())
         , m_user_proxy(socksify(m_net_params.get_json().value("proxy", std::string())))
+        , m_http_pool(std::make_unique<http_connection_pool>())
         , m_notification_handler(nullptr)
         , m_notification_context(nullptr)
         , m_notify(true)
@@ -60,19 +165,28 @@ namespace sdk {
             // Enable internal tor controller
             m_tor_ctrl = tor_controller::get_shared_ref();
         }
-        m_run_thread = std::thread([this] { m_io->m_io.run(); });
     }
 
     session_impl::~session_impl()
     {
-        no_std_exception_escape([this] { m_io->m_work_guard.reset(); }, "session_impl dtor(1)");
-        no_std_exception_escape([this] { m_run_thread.join(); }, "session_impl dtor(2)");
+        no_std_exception_escape([this] { m_notification_queue.reset(); }, "session_impl dtor(0)");
+        no_std_exception_escape([this] { m_io->shutdown(); }, "session_impl dtor(1)");
     }
 
     void session_impl::set_notification_handler(GA_notification_handler handler, void* context)
     {
         m_notification_handler = handler;
         m_notification_context = context;
+        m_notification_queue.reset();
+        if (m_notification_handler) {
+            m_notification_queue = std::make_unique<notification_queue>(
+                [this](nlohmann::json&& details) {
+                    // We use 'new' here as it is the handlers responsibility to 'delete'
+                    const auto details_p = reinterpret_cast<GA_json*>(new nlohmann::json(std::move(details)));
+                    m_notification_handler(m_notification_context, details_p);
+                },
+                NOTIFICATION_QUEUE_SIZE);
+        }
     }
 
     bool session_impl::set_signer(std::shared_ptr<signer> signer)
@@ -89,15 +203,76 @@ namespace sdk {
         return is_initial_login;
     }
 
-    void session_impl::disable_notifications() { m_notify = false; }
+    void session_impl::disable_notifications()
+    {
+        m_notify = false;
+        if (m_notification_queue) {
+            // Discard any pending notifications and wait until the handler
+            // is no longer being called, so the caller can safely release it
+            m_notification_queue->stop();
+        }
+    }
+
+    void session_impl::emit_notification(nlohmann::json details, bool async)
+    {
+        // Notifications are always delivered asynchronously. Callers passing
+        // async may hold locks, so must not wait for the queue to drain.
+        // Nor may I/O threads, which a handler may be waiting on
+        if (m_notify && m_notification_queue) {
+            m_notification_queue->push(std::move(details), !async && !is_io_context_thread());
+        }
+    }
+
+    nlohmann::json session_impl::get_notification_metrics() const
+    {
+        if (!m_notification_queue) {
+            return nlohmann::json::object();
+        }
+        return m_notification_queue->get_metrics();
+    }
+
+    nlohmann::json session_impl::get_metrics() const
+    {
+        return { { "notifications", get_notification_metrics() } };
+    }
+
+    nlohmann::json session_impl::get_memory_usage()
+    {
+        nlohmann::json result;
+        result["notifications"] = m_notification_queue ? m_notification_queue->get_memory_usage() : 0;
+        {
+            size_t utxos_size = 0;
+            locker_t locker(m_utxo_cache_mutex);
+            for (const auto& entry : m_utxo_cache) {
+                utxos_size += entry.second.utxos ? json_get_memory_usage(*entry.second.utxos) : 0;
+            }
+            result["utxos"] = utxos_size;
+        }
+        {
+            size_t icons_size = 0;
+            locker_t locker(m_icons_mutex);
+            for (const auto& icon : m_icons) {
+                icons_size += icon.first.capacity() + icon.second.capacity();
+            }
+            result["asset_icons"] = icons_size;
+        }
+        locker_t locker(m_mutex);
+        result["derived_keys"] = m_user_pubkeys ? m_user_pubkeys->get_memory_usage() : 0;
+        return result;
+    }
 
-    void session_impl::emit_notification(nlohmann::json details, bool /*async*/)
+    void session_impl::trim_memory()
     {
-        // By default, ignore the async flag
-        if (m_notify && m_notification_handler) {
-            // We use 'new' here as it is the handlers responsibility to 'delete'
-            const auto details_p = reinterpret_cast<GA_json*>(new nlohmann::json(std::move(details)));
-            m_notification_handler(m_notification_context, details_p);
+        remove_cached_utxos(std::vector<uint32_t>());
+        {
+            std::map<std::string, std::string> tmp_icons; // Delete outside of lock
+            locker_t locker(m_icons_mutex);
+            std::swap(m_icons, tmp_icons);
+            m_missing_icons.clear();
+        }
+        locker_t locker(m_mutex);
+        if (m_user_pubkeys) {
+            m_user_pubkeys->trim();
         }
     }
 
@@ -121,24 +296,78 @@ namespace sdk {
                 }
             }
 
-            const bool is_secure = params["is_secure"];
-            std::shared_ptr<boost::asio::ssl::context> ssl_ctx;
-            if (is_secure) {
-                ssl_ctx = tls_init(params["host"], root_certificates, {}, m_net_params.cert_expiry_threshold());
-            }
+            const uint32_t cert_expiry_threshold = m_net_params.cert_expiry_threshold();
 
-            std::shared_ptr<http_client> client;
+            constexpr bool keep_alive = true;
             auto&& get = [&] {
-                client = make_http_client(m_io->m_io, ssl_ctx.get());
+                const bool is_secure = params["is_secure"];
+                const std::string host = params["host"];
+                const std::string port = params["port"];
+                std::string key = std::string(is_secure ? "https://" : "http://") + host + ":" + port + " via "
+                    + params["proxy"].get<std::string>();
+                std::shared_ptr<boost::asio::ssl::context> ssl_ctx;
+                if (is_secure) {
+                    ssl_ctx = m_http_pool->get_ssl_context(host, root_certificates, cert_expiry_threshold);
+                    // Only share connections and TLS sessions between requests
+                    // verified against the same roots. Each set of roots has
+                    // its own context, which lives as long as the pool
+                    key += " ctx " + std::to_string(reinterpret_cast<uintptr_t>(ssl_ctx.get()));
+                }
+                const auto verb = boost::beast::http::string_to_verb(params["method"]);
+
+                // Only retry idempotent requests on a fresh connection if an
+                // idle pooled connection has been closed by the server
+                const bool is_idempotent
+                    = verb == boost::beast::http::verb::get || verb == boost::beast::http::verb::head;
+                if (is_idempotent) {
+                    if (auto client = m_http_pool->take(key)) {
+                        try {
+                            auto ret = client->request(verb, params, keep_alive).get();
+                            m_http_pool->put(key, std::move(client));
+                            return ret;
+                        } catch (const std::exception& ex) {
+                            if (client->has_response()) {
+                                throw; // The server responded with an error: don't resend
+                            }
+                            GDK_LOG_SEV(log_level::debug) << "http_request: pooled connection failed: " << ex.what();
+                        }
+                    }
+                }
+
+                auto client = make_http_client(m_io->get_io_context(), ssl_ctx.get());
                 GDK_RUNTIME_ASSERT(client != nullptr);
+                client->set_tls_session(m_http_pool->get_tls_session(key));
 
-                const auto verb = boost::beast::http::string_to_verb(params["method"]);
-                return client->request(verb, params).get();
+                auto ret = client->request(verb, params, keep_alive).get();
+                m_http_pool->set_tls_session(key, client->get_tls_session());
+                m_http_pool->put(key, std::move(client));
+                return ret;
+            };
+
+            // Record or replay the request when capturing traffic. Downloads
+            // to files are not captured
+            auto&& captured_get = [&]() -> nlohmann::json {
+                const bool is_replaying = is_capture_replaying();
+                if ((!is_replaying && !is_capture_recording()) || params.contains("output_file")) {
+                    return get();
+                }
+                const std::string name = params["method"].get<std::string>() + " " + params["host"].get<std::string>()
+                    + params.value("target", std::string());
+                const nlohmann::json request = { { "method", params["method"] }, { "host", params["host"] },
+                    { "port", params["port"] }, { "target", params.value("target", std::string()) },
+                    { "data", params.value("data", nlohmann::json()) } };
+                const std::string key = request.dump();
+                if (is_replaying) {
+                    return nlohmann::json::parse(capture_replay("http", name, key));
+                }
+                auto ret = get();
+                capture_record("http", name, key, ret.dump());
+                return ret;
             };
 
             constexpr uint8_t num_redirects = 5;
             for (uint8_t i = 0; i < num_redirects; ++i) {
-                result = get();
+                result = captured_get();
                 if (!result.value("location", std::string{}).empty()) {
                     GDK_RUNTIME_ASSERT_MSG(!m_net_params.use_tor(), "redirection over Tor is not supported");
                     params.update(parse_url(result["location"]));
@@ -173,6 +402,17 @@ namespace sdk {
         GDK_RUNTIME_ASSERT(m_net_params.is_liquid());
 
         nlohmann::json p = params;
+        const bool wallet_icons = json_get_value(p, "wallet_icons", false);
+        p.erase("wallet_icons");
+        if (wallet_icons) {
+            // Fetch only the icons of assets the wallet holds, rather than
+            // every icon in the registry
+            nlohmann::json icons = nlohmann::json::object();
+            add_asset_icons(get_utxo_asset_ids(), icons);
+            if (!json_get_value(p, "assets", false) && !json_get_value(p, "icons", false)) {
+                return;
+            }
+        }
 
         auto session_signer = get_signer();
         if (session_signer != nullptr) {
@@ -194,6 +434,8 @@ namespace sdk {
         GDK_RUNTIME_ASSERT(m_net_params.is_liquid());
 
         nlohmann::json p = params;
+        const bool fetch_icons = json_get_value(p, "fetch_icons", false);
+        p.erase("fetch_icons");
 
         // We only need to set the xpub if we're accessing the registry cache,
         // which in turn only happens if we're querying via asset ids.
@@ -207,7 +449,11 @@ namespace sdk {
         p["config"] = get_registry_config();
 
         try {
-            return rust_call("get_assets", p);
+            auto result = rust_call("get_assets", p);
+            if (fetch_icons && p.contains("assets_id")) {
+                add_asset_icons(p["assets_id"], result["icons"]);
+            }
+            return result;
         } catch (const std::exception& ex) {
             GDK_LOG_SEV(log_level::error) << "error fetching assets: " << ex.what();
             return { { "assets", nlohmann::json::object() }, { "icons", nlohmann::json::object() },
@@ -215,6 +461,89 @@ namespace sdk {
         }
     }
 
+    nlohmann::json session_impl::load_asset_icons(const std::vector<std::string>& /*asset_ids*/)
+    {
+        return nlohmann::json::object();
+    }
+
+    void session_impl::store_asset_icons(const nlohmann::json& /*icons*/) {}
+
+    void session_impl::add_asset_icons(const std::vector<std::string>& asset_ids, nlohmann::json& icons)
+    {
+        std::vector<std::string> wanted;
+        {
+            locker_t locker(m_icons_mutex);
+            for (const auto& asset_id : asset_ids) {
+                if (icons.contains(asset_id) || m_missing_icons.count(asset_id)) {
+                    continue;
+                }
+                auto p = m_icons.find(asset_id);
+                if (p != m_icons.end()) {
+                    icons[asset_id] = p->second;
+                } else if (validate_hex(asset_id, SHA256_LEN)) {
+                    wanted.push_back(asset_id);
+                }
+            }
+        }
+        if (wanted.empty()) {
+            return;
+        }
+
+        // Load any icons persisted by the derived session
+        auto loaded = load_asset_icons(wanted);
+        nlohmann::json fetched = nlohmann::json::object();
+        std::vector<std::string> missing;
+        const auto registry_url = m_net_params.get_registry_connection_string();
+
+        for (const auto& asset_id : wanted) {
+            if (loaded.contains(asset_id)) {
+                continue;
+            }
+            // Note this reveals interest in the asset to the registry,
+            // callers must opt in to fetching icons individually
+            auto result = http_request({ { "method", "GET" }, { "accept", "base64" },
+                { "urls", { registry_url + "/icons/" + asset_id + ".png" } } });
+            const auto error = json_get_value(result, "error");
+            if (error.empty() && result.contains("body")) {
+                fetched[asset_id] = std::move(result["body"]);
+            } else if (error == "Not Found") {
+                missing.push_back(asset_id); // Don't ask again this session
+            } else {
+                GDK_LOG_SEV(log_level::info) << "error fetching icon for " << asset_id << ": " << error;
+            }
+        }
+        if (!fetched.empty()) {
+            store_asset_icons(fetched);
+        }
+        loaded.update(fetched);
+
+        locker_t locker(m_icons_mutex);
+        for (auto& item : loaded.items()) {
+            m_icons[item.key()] = item.value();
+            icons[item.key()] = std::move(item.value());
+        }
+        m_missing_icons.insert(missing.begin(), missing.end());
+    }
+
+    std::vector<std::string> session_impl::get_utxo_asset_ids() const
+    {
+        std::set<std::string> asset_ids;
+        {
+            locker_t locker(m_utxo_cache_mutex);
+            for (const auto& entry : m_utxo_cache) {
+                if (!entry.second.utxos) {
+                    continue;
+                }
+                for (const auto& item : entry.second.utxos->items()) {
+                    if (validate_hex(item.key(), SHA256_LEN)) {
+                        asset_ids.insert(item.key());
+                    }
+                }
+            }
+        }
+        return { asset_ids.begin(), asset_ids.end() };
+    }
+
     std::string session_impl::connect_tor()
     {
         // Our built in tor implementation creates a socks5 proxy, which we
@@ -294,7 +623,13 @@ namespace sdk {
 
     void session_impl::start_sync_threads()
     {
-        // Overriden for ga_rust
+        // Overriden for ga_rust and ga_session
+    }
+
+    nlohmann::json session_impl::warm_login(std::shared_ptr<signer> /*signer*/,
+        const std::string& /*root_bip32_xpub*/, sign_challenge_fn_t /*sign_fn*/)
+    {
+        return {}; // Overriden for ga_session
     }
 
     std::string session_impl::get_subaccount_type(uint32_t subaccount) { return get_subaccount(subaccount).at("type"); }
@@ -305,6 +640,16 @@ namespace sdk {
         return false;
     }
 
+    std::vector<bool> session_impl::discover_subaccounts(const nlohmann::json& subaccounts)
+    {
+        std::vector<bool> found;
+        found.reserve(subaccounts.size());
+        for (const auto& subaccount : subaccounts) {
+            found.push_back(discover_subaccount(subaccount.at("xpub"), subaccount.at("type")));
+        }
+        return found;
+    }
+
     bool session_impl::encache_blinding_data(const std::string& /*pubkey_hex*/, const std::string& /*script_hex*/,
         const std::string& /*nonce_hex*/, const std::string& /*blinding_pubkey_hex*/)
     {
@@ -325,6 +670,16 @@ namespace sdk {
 
     nlohmann::json session_impl::get_scriptpubkey_data(byte_span_t /*scriptpubkey*/) { return nlohmann::json(); }
 
+    std::vector<nlohmann::json> session_impl::get_scriptpubkeys_data(const std::vector<byte_span_t>& scriptpubkeys)
+    {
+        std::vector<nlohmann::json> ret;
+        ret.reserve(scriptpubkeys.size());
+        for (const auto& scriptpubkey : scriptpubkeys) {
+            ret.emplace_back(get_scriptpubkey_data(scriptpubkey));
+        }
+        return ret;
+    }
+
     nlohmann::json session_impl::get_address_data(const nlohmann::json& /*details*/)
     {
         GDK_RUNTIME_ASSERT(false); // Only used by rust
@@ -337,18 +692,33 @@ namespace sdk {
         const auto psbt = psbt_from_base64(details.at("psbt"));
         const auto tx = psbt_extract_tx(psbt);
 
+        const auto utxo_index = index_utxos(details.at("utxos"));
         nlohmann::json::array_t inputs;
         inputs.reserve(tx->num_inputs);
         for (size_t i = 0; i < tx->num_inputs; ++i) {
-            const std::string txhash_hex = b2h_rev(tx->inputs[i].txhash);
-            const uint32_t vout = tx->inputs[i].index;
-            for (const auto& utxo : details.at("utxos")) {
-                if (utxo.value("txhash", std::string()) == txhash_hex && utxo.at("pt_idx") == vout) {
-                    inputs.emplace_back(std::move(utxo));
-                    break;
+            if (const auto utxo = find_input_utxo(utxo_index, tx->inputs[i])) {
+                inputs.emplace_back(*utxo);
+            }
+        }
+
+        // Look up the scriptpubkeys of all outputs at once, querying
+        // scriptpubkeys that are paid more than once only once
+        std::vector<byte_span_t> scriptpubkeys;
+        std::unordered_map<std::string, size_t> scriptpubkey_indices;
+        std::vector<size_t> output_indices(tx->num_outputs);
+        for (size_t i = 0; i < tx->num_outputs; ++i) {
+            const auto& o = tx->outputs[i];
+            if (o.script_len) {
+                const auto scriptpubkey = gsl::make_span(o.script, o.script_len);
+                const auto p = scriptpubkey_indices.emplace(b2h(scriptpubkey), scriptpubkeys.size());
+                if (p.second) {
+                    scriptpubkeys.emplace_back(scriptpubkey);
                 }
+                output_indices[i] = p.first->second;
             }
         }
+        const auto scriptpubkeys_data = get_scriptpubkeys_data(scriptpubkeys);
+        GDK_RUNTIME_ASSERT(scriptpubkeys_data.size() == scriptpubkeys.size());
 
         nlohmann::json::array_t outputs;
         outputs.reserve(tx->num_outputs);
@@ -357,8 +727,7 @@ namespace sdk {
             if (!o.script_len) {
                 continue; // Liquid fee
             }
-            const auto scriptpubkey = gsl::make_span(o.script, o.script_len);
-            auto output_data = get_scriptpubkey_data(scriptpubkey);
+            auto output_data = scriptpubkeys_data.at(output_indices[i]);
             if (output_data.empty()) {
                 continue; // Scriptpubkey does not belong the wallet
             }
@@ -387,23 +756,19 @@ namespace sdk {
 
         // Get our inputs in order, with UTXO details for signing,
         // or a "skip_signing" indicator if they aren't ours.
+        const auto utxo_index = index_utxos(details.at("utxos"));
         std::vector<nlohmann::json> inputs;
         inputs.reserve(tx->num_inputs);
         size_t num_sigs_required = 0;
         for (size_t i = 0; i < tx->num_inputs; ++i) {
-            const std::string txhash_hex = b2h_rev(tx->inputs[i].txhash);
-            const uint32_t vout = tx->inputs[i].index;
-            nlohmann::json input_utxo({ { "skip_signing", true } });
-            for (const auto& utxo : details.at("utxos")) {
-                if (!utxo.empty() && utxo.at("txhash") == txhash_hex && utxo.at("pt_idx") == vout) {
-                    input_utxo = utxo;
-                    const uint32_t sighash = psbt->inputs[i].sighash;
-                    input_utxo["user_sighash"] = sighash ? sighash : WALLY_SIGHASH_ALL;
-                    ++num_sigs_required;
-                    break;
-                }
+            if (const auto utxo = find_input_utxo(utxo_index, tx->inputs[i])) {
+                auto& input_utxo = inputs.emplace_back(*utxo);
+                const uint32_t sighash = psbt->inputs[i].sighash;
+                input_utxo["user_sighash"] = sighash ? sighash : WALLY_SIGHASH_ALL;
+                ++num_sigs_required;
+            } else {
+                inputs.push_back({ { "skip_signing", true } });
             }
-            inputs.emplace_back(input_utxo);
         }
 
         nlohmann::json::array_t utxos;
@@ -534,13 +899,89 @@ namespace sdk {
         }
     }
 
-    session_impl::utxo_cache_value_t session_impl::get_cached_utxos(uint32_t subaccount, uint32_t num_confs) const
+    session_impl::utxo_cache_value_t session_impl::get_cached_utxos(uint32_t subaccount, uint32_t num_confs)
     {
-        locker_t locker(m_utxo_cache_mutex);
-        // FIXME: If we have no unconfirmed txs, 0 and 1 conf results are
-        // identical, so we could share 0 & 1 conf storage
-        auto p = m_utxo_cache.find({ subaccount, num_confs });
-        return p == m_utxo_cache.end() ? utxo_cache_value_t() : p->second;
+        const utxo_cache_key_t key{ subaccount, num_confs };
+        for (;;) {
+            utxo_cache_value_t cached;
+            std::shared_ptr<const utxo_totals_t> cached_totals;
+            std::vector<std::string> pending_txhashes;
+            {
+                locker_t locker(m_utxo_cache_mutex);
+                // FIXME: If we have no unconfirmed txs, 0 and 1 conf results are
+                // identical, so we could share 0 & 1 conf storage
+                auto p = m_utxo_cache.find(key);
+                if (p == m_utxo_cache.end()) {
+                    return utxo_cache_value_t();
+                }
+                if (p->second.pending_txhashes.empty()) {
+                    return p->second.utxos;
+                }
+                cached = p->second.utxos;
+                cached_totals = p->second.totals;
+                pending_txhashes = p->second.pending_txhashes;
+            }
+
+            // Remove the outputs spent by any new txs from the cached UTXOs
+            std::set<std::pair<std::string, uint32_t>> spent;
+            try {
+                for (const auto& txhash_hex : pending_txhashes) {
+                    const auto tx = get_raw_transaction_details(txhash_hex);
+                    for (size_t i = 0; i < tx->num_inputs; ++i) {
+                        const auto& input = tx->inputs[i];
+                        spent.emplace(b2h_rev(input.txhash), input.index);
+                    }
+                }
+            } catch (const std::exception& e) {
+                // Couldn't fetch a tx; fall back to re-fetching the UTXOs
+                GDK_LOG_SEV(log_level::warning) << "Failed to apply UTXO spends: " << e.what();
+                remove_cached_utxos({ subaccount });
+                return utxo_cache_value_t();
+            }
+            auto updated = std::make_shared<nlohmann::json>(*cached);
+            // Update any computed totals for the spent outputs as we remove them
+            std::shared_ptr<utxo_totals_t> updated_totals;
+            if (cached_totals) {
+                updated_totals = std::make_shared<utxo_totals_t>(*cached_totals);
+            }
+            for (auto& asset : updated->at("unspent_outputs").items()) {
+                if (asset.key() != "error") {
+                    auto& utxos = asset.value();
+                    auto&& is_spent = [&spent, &updated_totals, &asset](const auto& u) {
+                        const std::string txhash = u.at("txhash");
+                        const uint32_t pt_idx = u.at("pt_idx");
+                        if (!spent.count({ txhash, pt_idx })) {
+                            return false;
+                        }
+                        if (updated_totals) {
+                            update_utxo_totals(*updated_totals, asset.key(), u, false);
+                        }
+                        return true;
+                    };
+                    utxos.erase(std::remove_if(utxos.begin(), utxos.end(), is_spent), utxos.end());
+                }
+            }
+
+            locker_t locker(m_utxo_cache_mutex);
+            auto p = m_utxo_cache.find(key);
+            if (p == m_utxo_cache.end() || p->second.utxos != cached) {
+                // The cache was changed while we were updating, try again
+                continue;
+            }
+            auto& pending = p->second.pending_txhashes;
+            GDK_RUNTIME_ASSERT(pending.size() >= pending_txhashes.size());
+            pending.erase(pending.begin(), pending.begin() + pending_txhashes.size());
+            p->second.utxos = updated;
+            if (p->second.totals == cached_totals) {
+                p->second.totals = std::move(updated_totals);
+            } else {
+                p->second.totals.reset(); // Totals were computed meanwhile, recompute
+            }
+            if (pending.empty()) {
+                return p->second.utxos;
+            }
+            // More txs arrived while we were updating, apply them too
+        }
     }
 
     session_impl::utxo_cache_value_t session_impl::set_cached_utxos(
@@ -554,10 +995,71 @@ namespace sdk {
         // Encache
         locker_t locker(m_utxo_cache_mutex);
         auto entry = std::make_shared<const nlohmann::json>(std::move(utxos));
-        m_utxo_cache[std::make_pair(subaccount, num_confs)] = entry;
+        m_utxo_cache[std::make_pair(subaccount, num_confs)] = { entry, {} };
         return entry;
     }
 
+    void session_impl::update_utxo_totals(
+        utxo_totals_t& totals, const std::string& asset_id, const nlohmann::json& utxo, bool is_add)
+    {
+        auto& total = totals[asset_id];
+        const amount::value_type satoshi = utxo.at("satoshi");
+        const bool is_frozen = utxo.value("user_status", 0u) == USER_STATUS_FROZEN;
+        auto& total_satoshi = is_frozen ? total.frozen_satoshi : total.satoshi;
+        auto& total_utxos = is_frozen ? total.num_frozen_utxos : total.num_utxos;
+        if (is_add) {
+            total_satoshi += satoshi;
+            ++total_utxos;
+        } else {
+            GDK_RUNTIME_ASSERT(total_utxos && total_satoshi >= satoshi);
+            total_satoshi -= satoshi;
+            --total_utxos;
+        }
+    }
+
+    nlohmann::json session_impl::get_cached_balance(uint32_t subaccount, uint32_t num_confs, bool all_coins)
+    {
+        // Apply any pending spends, which also updates the totals if computed
+        const auto cached = get_cached_utxos(subaccount, num_confs);
+        if (!cached) {
+            return nlohmann::json();
+        }
+        std::shared_ptr<const utxo_totals_t> totals;
+        {
+            locker_t locker(m_utxo_cache_mutex);
+            auto p = m_utxo_cache.find({ subaccount, num_confs });
+            if (p != m_utxo_cache.end() && p->second.utxos == cached) {
+                totals = p->second.totals;
+            }
+        }
+        if (!totals) {
+            // Compute the totals for this result the first time they are needed
+            auto computed = std::make_shared<utxo_totals_t>();
+            for (const auto& asset : cached->at("unspent_outputs").items()) {
+                if (asset.key() != "error") {
+                    for (const auto& utxo : asset.value()) {
+                        update_utxo_totals(*computed, asset.key(), utxo, true);
+                    }
+                }
+            }
+            totals = computed;
+            locker_t locker(m_utxo_cache_mutex);
+            auto p = m_utxo_cache.find({ subaccount, num_confs });
+            if (p != m_utxo_cache.end() && p->second.utxos == cached && !p->second.totals) {
+                p->second.totals = totals;
+            }
+        }
+
+        nlohmann::json balance({ { m_net_params.get_policy_asset(), 0 } });
+        for (const auto& total : *totals) {
+            const auto& t = total.second;
+            if (t.num_utxos || (all_coins && t.num_frozen_utxos)) {
+                balance[total.first] = t.satoshi + (all_coins ? t.frozen_satoshi : 0);
+            }
+        }
+        return balance;
+    }
+
     void session_impl::remove_cached_utxos(const std::vector<uint32_t>& subaccounts)
     {
         std::vector<utxo_cache_value_t> tmp_values; // Delete outside of lock
@@ -571,7 +1073,7 @@ namespace sdk {
                 // Remove all entries for affected subaccounts
                 for (auto p = m_utxo_cache.begin(); p != m_utxo_cache.end(); /* no-op */) {
                     if (std::find(subaccounts.begin(), subaccounts.end(), p->first.first) != subaccounts.end()) {
-                        tmp_values.push_back(p->second);
+                        tmp_values.push_back(p->second.utxos);
                         m_utxo_cache.erase(p++);
                     } else {
                         ++p;
@@ -581,11 +1083,53 @@ namespace sdk {
         }
     }
 
+    void session_impl::update_cached_utxos(const std::vector<uint32_t>& subaccounts, const std::string& txhash_hex)
+    {
+        std::vector<utxo_cache_value_t> tmp_values; // Delete outside of lock
+        {
+            locker_t locker(m_utxo_cache_mutex);
+            for (auto p = m_utxo_cache.begin(); p != m_utxo_cache.end(); /* no-op */) {
+                if (std::find(subaccounts.begin(), subaccounts.end(), p->first.first) == subaccounts.end()) {
+                    ++p;
+                } else if (p->first.second == 0) {
+                    // Unconfirmed UTXOs may include outputs of the new tx,
+                    // which we don't know until it is fetched: remove them
+                    tmp_values.push_back(p->second.utxos);
+                    m_utxo_cache.erase(p++);
+                } else {
+                    // Confirmed UTXOs can only change by being spent until a
+                    // new block arrives: remove its spent outputs on lookup
+                    auto& pending = p->second.pending_txhashes;
+                    if (std::find(pending.begin(), pending.end(), txhash_hex) == pending.end()) {
+                        pending.push_back(txhash_hex);
+                    }
+                    ++p;
+                }
+            }
+        }
+    }
+
     void session_impl::process_unspent_outputs(nlohmann::json& /*utxos*/)
     {
         // Only needed for multisig until singlesig supports HWW
     }
 
+    nlohmann::json session_impl::get_unspent_outputs_for_private_keys(const nlohmann::json& details)
+    {
+        // Overriden for ga_session to sweep all keys at once
+        auto results = nlohmann::json::array();
+        for (const auto& key : details.at("private_keys")) {
+            try {
+                const std::string password = json_get_value(key, "password");
+                auto utxos = get_unspent_outputs_for_private_key(key.at("private_key"), password, 0);
+                results.push_back({ { "utxos", std::move(utxos) } });
+            } catch (const assertion_error&) {
+                results.push_back({ { "error", std::string(res::id_invalid_private_key) } });
+            }
+        }
+        return { { "results", std::move(results) } };
+    }
+
     std::shared_ptr<signer> session_impl::get_nonnull_signer()
     {
         auto signer = get_signer();
@@ -629,6 +1173,18 @@ namespace sdk {
         return nlohmann::json();
     }
 
+    nlohmann::json session_impl::sync_transactions(
+        uint32_t /*subaccount*/, uint64_t /*timestamp*/, unique_pubkeys_and_scripts_t& /*missing*/)
+    {
+        // Overriden for multisig
+        return nlohmann::json();
+    }
+
+    void session_impl::prefetch_transactions(uint32_t /*subaccount*/, uint64_t /*timestamp*/)
+    {
+        // Overriden for multisig
+    }
+
     void session_impl::store_transactions(uint32_t /*subaccount*/, nlohmann::json& /*txs*/)
     {
         // Overriden for multisig
@@ -3,6 +3,7 @@
 
 #pragma once
 #include <atomic>
+#include <functional>
 #include <mutex>
 #include <set>
 #include <thread>
@@ -20,7 +21,9 @@ namespace sdk {
     class user_pubkeys;
     class signer;
     struct tor_controller;
-    struct io_context_and_guard;
+    class io_context_handle;
+    struct http_connection_pool;
+    class notification_queue;
 
     class session_impl {
     public:
@@ -41,11 +44,19 @@ namespace sdk {
         using utxo_cache_value_t = std::shared_ptr<const nlohmann::json>;
 
         // Lookup cached UTXOs
-        utxo_cache_value_t get_cached_utxos(uint32_t subaccount, uint32_t num_confs) const;
+        utxo_cache_value_t get_cached_utxos(uint32_t subaccount, uint32_t num_confs);
         // Encache UTXOs. Takes ownership of utxos, returns the encached value
         utxo_cache_value_t set_cached_utxos(uint32_t subaccount, uint32_t num_confs, nlohmann::json& utxos);
+        // Lookup the per-asset balance of cached UTXOs, or null if not cached.
+        // Totals are computed once per cached result and then kept up to date
+        // as new txs spend from it. Frozen UTXOs are included if all_coins is set
+        nlohmann::json get_cached_balance(uint32_t subaccount, uint32_t num_confs, bool all_coins);
         // Un-encache UTXOs
         void remove_cached_utxos(const std::vector<uint32_t>& subaccounts);
+        // Update cached UTXOs for a new tx affecting the given subaccounts.
+        // Unconfirmed UTXOs are un-encached, while the outputs the tx spends
+        // are removed from confirmed UTXOs when they are next looked up.
+        void update_cached_utxos(const std::vector<uint32_t>& subaccounts, const std::string& txhash_hex);
 
         virtual nlohmann::json get_unspent_outputs(const nlohmann::json& details, unique_pubkeys_and_scripts_t& missing)
             = 0;
@@ -53,6 +64,7 @@ namespace sdk {
         virtual nlohmann::json get_unspent_outputs_for_private_key(
             const std::string& private_key, const std::string& password, uint32_t unused)
             = 0;
+        virtual nlohmann::json get_unspent_outputs_for_private_keys(const nlohmann::json& details);
         virtual nlohmann::json set_unspent_outputs_status(
             const nlohmann::json& details, const nlohmann::json& twofactor_data)
             = 0;
@@ -62,8 +74,20 @@ namespace sdk {
 
         // Disable notifications from being delivered
         void disable_notifications();
-        // Call the users registered notification handler. Must be called without any locks held.
+        // Queue a notification for delivery to the users registered notification
+        // handler. The handler is called from the shared notification pool.
+        // Unless async is true, must be called without any locks held, as the
+        // caller may have to wait for the handler if too many notifications are
+        // pending. Callers on network I/O threads never wait.
         virtual void emit_notification(nlohmann::json details, bool async);
+        // Get metrics describing notification delivery
+        nlohmann::json get_notification_metrics() const;
+        // Get metrics describing the session's internal operations
+        virtual nlohmann::json get_metrics() const;
+        // Get the approximate memory in bytes held by each of the session's caches
+        virtual nlohmann::json get_memory_usage();
+        // Release cached data that can be recreated on demand
+        virtual void trim_memory();
         std::string connect_tor();
         virtual void reconnect() = 0;
         virtual void reconnect_hint(const nlohmann::json& hint);
@@ -90,6 +114,13 @@ namespace sdk {
         virtual void register_subaccount_xpubs(
             const std::vector<uint32_t>& pointers, const std::vector<std::string>& bip32_xpubs)
             = 0;
+        // Log in from a snapshot of a previous login stored in the local
+        // cache, authenticating with the server in the background using
+        // sign_fn to sign the login challenge. Returns the post-login data,
+        // or an empty object if the caller must log in normally.
+        using sign_challenge_fn_t = std::function<std::string(const std::string& challenge)>;
+        virtual nlohmann::json warm_login(
+            std::shared_ptr<signer> signer, const std::string& root_bip32_xpub, sign_challenge_fn_t sign_fn);
         virtual nlohmann::json login(std::shared_ptr<signer> signer);
         virtual nlohmann::json credentials_from_pin_data(const nlohmann::json& pin_data) = 0;
         virtual nlohmann::json login_wo(std::shared_ptr<signer> signer) = 0;
@@ -99,6 +130,8 @@ namespace sdk {
 
         // Returns true if the subaccount was discovered
         virtual bool discover_subaccount(const std::string& xpub, const std::string& type);
+        // Returns whether each of an array of {"xpub", "type"} subaccounts was discovered
+        virtual std::vector<bool> discover_subaccounts(const nlohmann::json& subaccounts);
         virtual uint32_t get_next_subaccount(const std::string& type) = 0;
         virtual nlohmann::json create_subaccount(
             const nlohmann::json& details, uint32_t subaccount, const std::string& xpub)
@@ -108,6 +141,13 @@ namespace sdk {
             = 0;
         virtual nlohmann::json get_transactions(const nlohmann::json& details) = 0;
         virtual nlohmann::json sync_transactions(uint32_t subaccount, unique_pubkeys_and_scripts_t& missing);
+        // Sync the page of txs newer than 'timestamp', rather than those newer
+        // than the latest cached tx. Allows syncing pages ahead of storing them
+        virtual nlohmann::json sync_transactions(
+            uint32_t subaccount, uint64_t timestamp, unique_pubkeys_and_scripts_t& missing);
+        // Start fetching the page of txs newer than 'timestamp' in the background,
+        // for use by the next sync_transactions call from that timestamp
+        virtual void prefetch_transactions(uint32_t subaccount, uint64_t timestamp);
         virtual void store_transactions(uint32_t subaccount, nlohmann::json& txs);
         virtual void postprocess_transactions(nlohmann::json& tx_list);
 
@@ -172,6 +212,7 @@ namespace sdk {
             const uint32_t branch, const uint32_t pointer, const uint32_t subtype, const uint32_t script_type);
         virtual void encache_new_scriptpubkeys(const uint32_t subaccount);
         virtual nlohmann::json get_scriptpubkey_data(byte_span_t scriptpubkey);
+        virtual std::vector<nlohmann::json> get_scriptpubkeys_data(const std::vector<byte_span_t>& scriptpubkeys);
         virtual nlohmann::json get_address_data(const nlohmann::json& details);
         virtual nlohmann::json psbt_get_details(const nlohmann::json& details);
         virtual void upload_confidential_addresses(
@@ -228,6 +269,10 @@ namespace sdk {
 
         // Cached data
         virtual std::pair<std::string, bool> get_cached_master_blinding_key() = 0;
+        // Persisted per-asset icons, as an object of asset id to base64 icon.
+        // By default icons fetched individually are kept in memory only
+        virtual nlohmann::json load_asset_icons(const std::vector<std::string>& asset_ids);
+        virtual void store_asset_icons(const nlohmann::json& icons);
         virtual void set_cached_master_blinding_key(const std::string& master_blinding_key_hex);
 
         virtual bool has_recovery_pubkeys_subaccount(uint32_t subaccount);
@@ -260,15 +305,17 @@ namespace sdk {
 
         // Immutable upon construction
         const network_parameters m_net_params;
-        std::unique_ptr<io_context_and_guard> m_io;
-
-        std::thread m_run_thread; // Runs the asio context
+        std::unique_ptr<io_context_handle> m_io; // Owned or shared with other sessions
         const std::string m_user_proxy;
         std::shared_ptr<tor_controller> m_tor_ctrl;
+        // Keep-alive HTTP connections and TLS state. Internally locked
+        std::unique_ptr<http_connection_pool> m_http_pool;
 
         // Immutable once set by the caller (prior to connect)
         GA_notification_handler m_notification_handler;
         void* m_notification_context;
+        // Delivers notifications to the handler. Internally locked
+        std::unique_ptr<notification_queue> m_notification_queue;
 
         // Immutable post-login
         std::shared_ptr<signer> m_signer;
@@ -282,9 +329,30 @@ namespace sdk {
         // Cached UTXOs are unfiltered; if using the cached values you
         // may need to filter them first (e.g. to removed expired or frozen UTXOS)
         using utxo_cache_key_t = std::pair<uint32_t, uint32_t>; // subaccount, num_confs
-        using utxo_cache_t = std::map<utxo_cache_key_t, utxo_cache_value_t>;
+        struct utxo_asset_total_t {
+            amount::value_type satoshi = 0;
+            size_t num_utxos = 0;
+            amount::value_type frozen_satoshi = 0;
+            size_t num_frozen_utxos = 0;
+        };
+        using utxo_totals_t = std::map<std::string, utxo_asset_total_t>; // asset id -> total
+        struct utxo_cache_entry_t {
+            utxo_cache_value_t utxos;
+            std::vector<std::string> pending_txhashes; // New txs whose spends are not yet applied
+            std::shared_ptr<const utxo_totals_t> totals; // Totals of utxos, once computed
+        };
+        using utxo_cache_t = std::map<utxo_cache_key_t, utxo_cache_entry_t>;
+        static void update_utxo_totals(
+            utxo_totals_t& totals, const std::string& asset_id, const nlohmann::json& utxo, bool is_add);
         mutable std::mutex m_utxo_cache_mutex;
         utxo_cache_t m_utxo_cache;
+
+        // Asset icons fetched individually from the registry
+        void add_asset_icons(const std::vector<std::string>& asset_ids, nlohmann::json& icons);
+        std::vector<std::string> get_utxo_asset_ids() const;
+        std::mutex m_icons_mutex;
+        std::map<std::string, std::string> m_icons; // Asset id -> base64 icon
+        std::set<std::string> m_missing_icons; // Asset ids the registry has no icon for
     };
 
 } // namespace sdk
@@ -116,6 +116,7 @@ namespace sdk {
         cache_t get_cached_bip32_xpubs();
 
         // Return the ECDSA signature for a hash using the bip32 key 'm/<path>'
+        // Does not lock; may be called concurrently as the master key is immutable
         ecdsa_sig_t sign_hash(uint32_span_t path, byte_span_t hash);
 
         // Return the recoverable ECDSA signature for a hash using the bip32 key 'm/<path>'
@@ -136,7 +137,7 @@ namespace sdk {
         const unsigned char m_btc_version;
         const nlohmann::json m_credentials;
         const nlohmann::json m_device;
-        wally_ext_key_ptr m_master_key;
+        wally_ext_key_ptr m_master_key; // Set only in the constructor
         // Mutable post construction
         mutable std::mutex m_mutex;
         std::optional<blinding_key_t> m_master_blinding_key;
@@ -11,6 +11,7 @@
 #include "session.hpp"
 #include "session_impl.hpp"
 #include "signer.hpp"
+#include "threading.hpp"
 #include "transaction_utils.hpp"
 #include "utils.hpp"
 #include "validate.hpp"
@@ -21,6 +22,10 @@ namespace sdk {
     namespace {
         static const std::string LIQUIDEX_STR("liquidex_v1");
         static constexpr uint32_t LIQUIDEX_VERSION = 1;
+        // Minimum number of proposals to verify per thread when batch validating
+        static constexpr size_t MIN_PROPOSALS_PER_THREAD = 4;
+        // Maximum number of threads to verify proposals with
+        static constexpr size_t MAX_VALIDATION_THREADS = 8;
 
         static nlohmann::json get_tx_input_fields(const wally_tx_ptr& tx, size_t index)
         {
@@ -356,8 +361,44 @@ namespace sdk {
     bool validate_call::is_liquidex() const { return m_details.contains(LIQUIDEX_STR); }
     void validate_call::liquidex_impl()
     {
-        const auto& proposal = m_details.at(LIQUIDEX_STR).at("proposal");
-        liquidex_validate_proposal(proposal);
+        const auto& liquidex = m_details.at(LIQUIDEX_STR);
+        if (!liquidex.contains("proposals")) {
+            liquidex_validate_proposal(liquidex.at("proposal"));
+            return;
+        }
+
+        // Batch mode: verify each proposal independently, in parallel
+        const auto& proposals = liquidex.at("proposals");
+        GDK_RUNTIME_ASSERT_MSG(proposals.is_array(), "proposals must be an array");
+        const size_t num_proposals = proposals.size();
+        std::vector<std::string> proposal_errors(num_proposals);
+        parallel_for_chunks(num_proposals, MIN_PROPOSALS_PER_THREAD, MAX_VALIDATION_THREADS, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                try {
+                    liquidex_validate_proposal(proposals[i]);
+                } catch (const std::exception& ex) {
+                    proposal_errors[i] = ex.what();
+                    if (proposal_errors[i].empty()) {
+                        proposal_errors[i] = "invalid proposal";
+                    }
+                }
+            }
+        });
+
+        nlohmann::json::array_t results, errors;
+        results.reserve(proposal_errors.size());
+        for (size_t i = 0; i < proposal_errors.size(); ++i) {
+            auto& error = proposal_errors[i];
+            nlohmann::json::array_t result_errors;
+            if (!error.empty()) {
+                errors.emplace_back("proposal " + std::to_string(i) + ": " + error);
+                result_errors.emplace_back(std::move(error));
+            }
+            const bool is_valid = result_errors.empty();
+            results.push_back({ { "is_valid", is_valid }, { "errors", std::move(result_errors) } });
+        }
+        m_result["errors"] = std::move(errors);
+        m_result["proposals"] = std::move(results);
     }
 } // namespace sdk
 } // namespace ga
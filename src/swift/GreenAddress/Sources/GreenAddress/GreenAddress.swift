@@ -257,6 +257,16 @@ public class Session {
         return try convertOpaqueJsonToDict(o: result!)
     }
 
+    public func getMemoryUsage() throws -> [String: Any]? {
+        var result: OpaquePointer? = nil
+        try callWrapper(fun: GA_get_memory_usage(session, &result))
+        return try convertOpaqueJsonToDict(o: result!)
+    }
+
+    public func trimMemory() throws -> Void {
+        try callWrapper(fun: GA_trim_memory(session))
+    }
+
     public func registerUser(details: [String: Any], hw_device: [String: Any] = [:]) throws -> TwoFactorCall {
         var optr: OpaquePointer? = nil;
         var hw_device_json: OpaquePointer = try convertDictToJSON(dict: hw_device)
@@ -336,6 +346,10 @@ public class Session {
         return try convertOpaqueJsonToDict(o: result!)
     }
 
+    public func getUnspentOutputsForPrivateKeys(details: [String: Any]) throws -> [String: Any]? {
+        return try jsonFuncToJsonWrapper(input: details, fun: GA_get_unspent_outputs_for_private_keys)
+    }
+
     public func setUnspentOutputsStatus(details: [String: Any]) throws -> TwoFactorCall {
         return try jsonFuncToCallHandlerWrapper(input: details, fun: GA_set_unspent_outputs_status)
     }
@@ -272,6 +272,66 @@ LOCALFUNC jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t l
     return ret;
 }
 
+/* The last encoded status that did not fit in the caller's buffer. It is
+ * kept so that the retry with a larger buffer does not encode it again */
+static __thread struct GA_auth_handler* g_pending_status_call = NULL;
+static __thread unsigned char* g_pending_status = NULL;
+static __thread size_t g_pending_status_len = 0;
+
+/* Write the msgpack encoded status of an auth handler into a direct
+ * ByteBuffer, avoiding conversion to a Java string and re-parsing it.
+ * The encoded length is returned in written. If this exceeds the capacity
+ * of the buffer nothing is written, and the caller should retry with a
+ * larger buffer */
+LOCALFUNC int _java_auth_handler_get_status_msgpack(struct GA_auth_handler* call, jobject buffer, uint32_t* written) {
+    JNIEnv *jenv;
+    GA_json* status = NULL;
+    unsigned char* bytes = NULL;
+    unsigned char* dest;
+    jlong capacity;
+    size_t len = 0;
+    int ret = GA_OK;
+
+    *written = 0;
+    if (!g_jvm || (*g_jvm)->GetEnv(g_jvm, (void**) &jenv, JNI_VERSION_1_6))
+        return GA_ERROR;
+
+    dest = buffer ? (unsigned char*)(*jenv)->GetDirectBufferAddress(jenv, buffer) : NULL;
+    capacity = dest ? (*jenv)->GetDirectBufferCapacity(jenv, buffer) : 0;
+
+    if (g_pending_status && g_pending_status_call == call && capacity >= (jlong)g_pending_status_len) {
+        /* Retrying with a buffer large enough for the status we encoded */
+        bytes = g_pending_status;
+        len = g_pending_status_len;
+    } else {
+        GA_destroy_bytes(g_pending_status);
+        ret = GA_auth_handler_get_status(call, &status);
+        if (ret == GA_OK)
+            ret = GA_convert_json_to_msgpack(status, &bytes, &len);
+        GA_destroy_json(status);
+    }
+    g_pending_status_call = NULL;
+    g_pending_status = NULL;
+    g_pending_status_len = 0;
+
+    if (ret == GA_OK && len > INT_MAX) {
+        ret = GA_ERROR; /* Too large for a ByteBuffer */
+    } else if (ret == GA_OK) {
+        if (capacity >= (jlong)len) {
+            memcpy(dest, bytes, len);
+        } else {
+            /* Keep the status for the retry */
+            g_pending_status_call = call;
+            g_pending_status = bytes;
+            g_pending_status_len = len;
+            bytes = NULL;
+        }
+        *written = (uint32_t)len;
+    }
+    GA_destroy_bytes(bytes);
+    return ret;
+}
+
 %}
 
 %javaconst(1);
@@ -513,6 +573,8 @@ LOCALFUNC jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t l
 %returns_struct(GA_encrypt_with_pin, GA_auth_handler)
 %returns_void__(GA_reconnect_hint)
 %returns_struct(GA_get_proxy_settings, GA_json)
+%returns_struct(GA_get_memory_usage, GA_json)
+%returns_void__(GA_trim_memory)
 %returns_struct(GA_get_wallet_identifier, GA_json)
 %returns_struct(GA_http_request, GA_json)
 %returns_void__(GA_refresh_assets)
@@ -538,6 +600,7 @@ LOCALFUNC jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t l
 %returns_struct(GA_get_twofactor_config, GA_json)
 %returns_struct(GA_get_unspent_outputs, GA_auth_handler)
 %returns_struct(GA_get_unspent_outputs_for_private_key, GA_json)
+%returns_struct(GA_get_unspent_outputs_for_private_keys, GA_json)
 %returns_struct(GA_set_unspent_outputs_status, GA_auth_handler)
 %returns_struct(GA_get_receive_address, GA_auth_handler)
 %returns_struct(GA_login_user, GA_auth_handler)
@@ -565,6 +628,7 @@ LOCALFUNC jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t l
 %returns_struct(GA_bcur_decode, GA_auth_handler)
 %returns_struct(GA_change_settings_twofactor, GA_auth_handler)
 %returns_struct(GA_auth_handler_get_status, GA_json)
+%returns_uint32(_java_auth_handler_get_status_msgpack)
 %returns_struct(GA_change_settings, GA_auth_handler)
 %returns_struct(GA_get_settings, GA_json)
 %returns_void__(GA_auth_handler_request_code)
@@ -581,3 +645,5 @@ GA_subscribe_to_topic_as_json
 */
 
 %include "gdk.h"
+
+int _java_auth_handler_get_status_msgpack(struct GA_auth_handler* call, jobject buffer, uint32_t* written);
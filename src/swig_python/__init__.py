@@ -2,6 +2,7 @@ import atexit
 import json
 from ._greenaddress import *
 from ._greenaddress import _python_set_callback_handler, _python_destroy_session
+from ._greenaddress import _python_auth_handler_get_status, _python_auth_handler_get_status_msgpack
 try:
     import queue
 except:
@@ -30,7 +31,11 @@ class Call(object):
         self.call_obj = call_obj
 
     def status(self):
-        return json.loads(auth_handler_get_status(self.call_obj))
+        return _python_auth_handler_get_status(self.call_obj)
+
+    def status_msgpack(self):
+        """Return the status as msgpack encoded bytes."""
+        return _python_auth_handler_get_status_msgpack(self.call_obj)
 
     def _select_method(self, methods):
         # Default implementation just uses the first method provided
@@ -151,6 +156,12 @@ class Session(object):
     def get_proxy_settings(self):
         return json.loads(get_proxy_settings(self.session_obj))
 
+    def get_memory_usage(self):
+        return json.loads(get_memory_usage(self.session_obj))
+
+    def trim_memory(self):
+        return trim_memory(self.session_obj)
+
     @staticmethod
     def get_wallet_identifier(net_params, params):
         return json.loads(get_wallet_identifier(Session._to_json(net_params), Session._to_json(params)))
@@ -201,6 +212,18 @@ class Session(object):
     def get_transactions(self, details={'subaccount': 0, 'first': 0, 'count': 30}):
         return Call(get_transactions(self.session_obj, self._to_json(details)))
 
+    def iter_transactions(self, details={'subaccount': 0}, page_size=30):
+        """Iterate over transactions, fetching them a page at a time."""
+        details = dict(details)
+        first = details.get('first', 0)
+        while True:
+            details.update({'first': first, 'count': page_size})
+            txs = self.get_transactions(details).resolve()['transactions']
+            yield from txs
+            if len(txs) < page_size:
+                return
+            first += len(txs)
+
     def get_receive_address(self, details=None):
         details = details or {}
         return Call(get_receive_address(self.session_obj, self._to_json(details)))
@@ -216,6 +239,11 @@ class Session(object):
             get_unspent_outputs_for_private_key(self.session_obj, private_key, password, unused)
         )
 
+    def get_unspent_outputs_for_private_keys(self, details):
+        return json.loads(
+            get_unspent_outputs_for_private_keys(self.session_obj, self._to_json(details))
+        )
+
     def set_unspent_outputs_status(self, details):
         return Call(set_unspent_outputs_status(self.session_obj, self._to_json(details)))
 
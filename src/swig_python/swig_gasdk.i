@@ -215,6 +215,219 @@ static void _python_destroy_GA_auth_handler(PyObject* obj)
     if (p)
         GA_destroy_auth_handler(p);
 }
+
+/* Decoding of msgpack as produced by GA_convert_json_to_msgpack into python
+ * objects, avoiding the cost of serialising and parsing results as text */
+static int msgpack_read_uint(const unsigned char** p, const unsigned char* end, size_t n, uint64_t* out)
+{
+    size_t i;
+    if ((size_t)(end - *p) < n) {
+        PyErr_SetString(PyExc_ValueError, "Truncated msgpack data");
+        return GA_ERROR;
+    }
+    *out = 0;
+    for (i = 0; i < n; ++i)
+        *out = (*out << 8) | (*p)[i];
+    *p += n;
+    return GA_OK;
+}
+
+static PyObject* msgpack_to_python(const unsigned char** p, const unsigned char* end);
+
+static PyObject* msgpack_str_to_python(const unsigned char** p, const unsigned char* end, uint64_t len, int is_str)
+{
+    const char* data = (const char*)*p;
+    if ((uint64_t)(end - *p) < len) {
+        PyErr_SetString(PyExc_ValueError, "Truncated msgpack data");
+        return NULL;
+    }
+    *p += len;
+    if (is_str)
+        return PyUnicode_DecodeUTF8(data, (Py_ssize_t)len, "strict");
+    return PyBytes_FromStringAndSize(data, (Py_ssize_t)len);
+}
+
+static PyObject* msgpack_array_to_python(const unsigned char** p, const unsigned char* end, uint64_t len)
+{
+    PyObject* list;
+    uint64_t i;
+    if ((uint64_t)(end - *p) < len) {
+        /* Each element takes at least one byte */
+        PyErr_SetString(PyExc_ValueError, "Truncated msgpack data");
+        return NULL;
+    }
+    list = PyList_New((Py_ssize_t)len);
+    for (i = 0; list && i < len; ++i) {
+        PyObject* item = msgpack_to_python(p, end);
+        if (!item) {
+            Py_DecRef(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+    }
+    return list;
+}
+
+static PyObject* msgpack_map_to_python(const unsigned char** p, const unsigned char* end, uint64_t len)
+{
+    PyObject* dict = PyDict_New();
+    uint64_t i;
+    for (i = 0; dict && i < len; ++i) {
+        PyObject* key = msgpack_to_python(p, end);
+        PyObject* value = key ? msgpack_to_python(p, end) : NULL;
+        if (!value || PyDict_SetItem(dict, key, value)) {
+            Py_DecRef(key);
+            Py_DecRef(value);
+            Py_DecRef(dict);
+            return NULL;
+        }
+        Py_DecRef(key);
+        Py_DecRef(value);
+    }
+    return dict;
+}
+
+static PyObject* msgpack_to_python_impl(const unsigned char** p, const unsigned char* end)
+{
+    uint64_t v;
+    unsigned char b;
+    double d;
+    float f;
+
+    if (*p >= end) {
+        PyErr_SetString(PyExc_ValueError, "Truncated msgpack data");
+        return NULL;
+    }
+    b = *(*p)++;
+    if (b <= 0x7f)
+        return PyLong_FromLong(b); /* positive fixint */
+    if (b >= 0xe0)
+        return PyLong_FromLong((signed char)b); /* negative fixint */
+    if ((b & 0xf0) == 0x80)
+        return msgpack_map_to_python(p, end, b & 0x0f);
+    if ((b & 0xf0) == 0x90)
+        return msgpack_array_to_python(p, end, b & 0x0f);
+    if ((b & 0xe0) == 0xa0)
+        return msgpack_str_to_python(p, end, b & 0x1f, 1);
+
+    switch (b) {
+    case 0xc0:
+        Py_RETURN_NONE;
+    case 0xc2:
+        Py_RETURN_FALSE;
+    case 0xc3:
+        Py_RETURN_TRUE;
+    case 0xc4: case 0xc5: case 0xc6: /* bin 8/16/32 */
+        if (msgpack_read_uint(p, end, (size_t)1 << (b - 0xc4), &v) != GA_OK)
+            return NULL;
+        return msgpack_str_to_python(p, end, v, 0);
+    case 0xca: /* float 32 */
+        if (msgpack_read_uint(p, end, 4, &v) != GA_OK)
+            return NULL;
+        {
+            const uint32_t bits = (uint32_t)v;
+            memcpy(&f, &bits, sizeof(f));
+        }
+        return PyFloat_FromDouble(f);
+    case 0xcb: /* float 64 */
+        if (msgpack_read_uint(p, end, 8, &v) != GA_OK)
+            return NULL;
+        memcpy(&d, &v, sizeof(d));
+        return PyFloat_FromDouble(d);
+    case 0xcc: case 0xcd: case 0xce: case 0xcf: /* uint 8/16/32/64 */
+        if (msgpack_read_uint(p, end, (size_t)1 << (b - 0xcc), &v) != GA_OK)
+            return NULL;
+        return PyLong_FromUnsignedLongLong(v);
+    case 0xd0: case 0xd1: case 0xd2: case 0xd3: /* int 8/16/32/64 */
+        {
+            const unsigned shift = 64 - 8 * (1u << (b - 0xd0));
+            if (msgpack_read_uint(p, end, (size_t)1 << (b - 0xd0), &v) != GA_OK)
+                return NULL;
+            return PyLong_FromLongLong((long long)(int64_t)(v << shift) >> shift);
+        }
+    case 0xd9: case 0xda: case 0xdb: /* str 8/16/32 */
+        if (msgpack_read_uint(p, end, (size_t)1 << (b - 0xd9), &v) != GA_OK)
+            return NULL;
+        return msgpack_str_to_python(p, end, v, 1);
+    case 0xdc: case 0xdd: /* array 16/32 */
+        if (msgpack_read_uint(p, end, (size_t)2 << (b - 0xdc), &v) != GA_OK)
+            return NULL;
+        return msgpack_array_to_python(p, end, v);
+    case 0xde: case 0xdf: /* map 16/32 */
+        if (msgpack_read_uint(p, end, (size_t)2 << (b - 0xde), &v) != GA_OK)
+            return NULL;
+        return msgpack_map_to_python(p, end, v);
+    default:
+        break;
+    }
+    PyErr_SetString(PyExc_ValueError, "Unsupported msgpack type");
+    return NULL;
+}
+
+static PyObject* msgpack_to_python(const unsigned char** p, const unsigned char* end)
+{
+    PyObject* result;
+    if (Py_EnterRecursiveCall(" while decoding msgpack"))
+        return NULL;
+    result = msgpack_to_python_impl(p, end);
+    Py_LeaveRecursiveCall();
+    return result;
+}
+
+/* Return an auth handlers status as a python dict, or as msgpack bytes */
+static PyObject* auth_handler_status_to_python(PyObject* obj, int as_bytes)
+{
+    struct GA_auth_handler* call;
+    GA_json* status = NULL;
+    unsigned char* bytes = NULL;
+    size_t len = 0;
+    int ret = GA_ERROR;
+    PyObject* result = NULL;
+
+    {
+        SWIG_PYTHON_THREAD_BEGIN_BLOCK;
+        call = (struct GA_auth_handler*)get_from_capsule(obj, "struct GA_auth_handler *");
+        SWIG_PYTHON_THREAD_END_BLOCK;
+    }
+    if (call) {
+        /* Fetch and serialise the status without holding the GIL */
+        ret = GA_auth_handler_get_status(call, &status);
+        if (ret == GA_OK)
+            ret = GA_convert_json_to_msgpack(status, &bytes, &len);
+        GA_destroy_json(status);
+    }
+
+    SWIG_PYTHON_THREAD_BEGIN_BLOCK;
+    if (!call)
+        PyErr_SetString(PyExc_TypeError, "Expected GA_auth_handler");
+    else if (check_result(ret) == GA_OK) {
+        if (as_bytes)
+            result = PyBytes_FromStringAndSize((const char*)bytes, (Py_ssize_t)len);
+        else {
+            const unsigned char* p = bytes;
+            result = msgpack_to_python(&p, bytes + len);
+            if (result && p != bytes + len) {
+                Py_DecRef(result);
+                result = NULL;
+                PyErr_SetString(PyExc_ValueError, "Trailing msgpack data");
+            }
+        }
+    }
+    SWIG_PYTHON_THREAD_END_BLOCK;
+
+    GA_destroy_bytes(bytes);
+    return result;
+}
+
+static PyObject* _python_auth_handler_get_status(PyObject* obj)
+{
+    return auth_handler_status_to_python(obj, 0);
+}
+
+static PyObject* _python_auth_handler_get_status_msgpack(PyObject* obj)
+{
+    return auth_handler_status_to_python(obj, 1);
+}
 %}
 
 %include pybuffer.i
@@ -227,6 +440,18 @@ static void _python_destroy_GA_auth_handler(PyObject* obj)
         SWIG_fail;
 };
 
+/* Functions returning python objects return NULL with an exception set on failure */
+%exception _python_auth_handler_get_status {
+    $action
+    if (!result)
+        SWIG_fail;
+};
+%exception _python_auth_handler_get_status_msgpack {
+    $action
+    if (!result)
+        SWIG_fail;
+};
+
 /* Return None if we didn't throw instead of 0 */
 %typemap(out) int %{
     Py_IncRef(Py_None);
@@ -326,3 +551,5 @@ typedef unsigned int uint32_t;
 
 static int _python_set_callback_handler(PyObject* obj, PyObject* arg);
 static int _python_destroy_session(PyObject* obj);
+static PyObject* _python_auth_handler_get_status(PyObject* obj);
+static PyObject* _python_auth_handler_get_status_msgpack(PyObject* obj);
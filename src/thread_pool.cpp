@@ -0,0 +1,288 @@
+#include "thread_pool.hpp"
+#include "assertion.hpp"
+#include "utils.hpp"
+
+namespace ga {
+namespace sdk {
+
+    namespace {
+        // The pool and worker index of the current thread, if it is a worker
+        static thread_local const thread_pool* tl_pool = nullptr;
+        static thread_local size_t tl_worker_index = 0;
+
+        static std::mutex g_pool_mutex;
+        static thread_pool* g_pool = nullptr; // Never deleted, to avoid destruction order issues at exit
+        static thread_pool* g_call_pool = nullptr; // As above
+        static thread_pool* g_notification_pool = nullptr; // As above
+
+        // Calls mostly wait on the network, so allow several to be in flight
+        constexpr size_t DEFAULT_NUM_CALL_THREADS = 4;
+        // Allow one slow notification handler without delaying other sessions
+        constexpr size_t NUM_NOTIFICATION_THREADS = 2;
+
+        static size_t get_default_num_threads()
+        {
+            // The thread waiting for a result also does work, so leave a core for it
+            const size_t num_cores = std::thread::hardware_concurrency();
+            return num_cores > 1 ? num_cores - 1 : 1;
+        }
+    } // namespace
+
+    thread_pool::thread_pool(size_t num_threads)
+        : m_next_queue(0)
+        , m_num_pending(0)
+        , m_stop(false)
+    {
+        m_queues.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            m_queues.emplace_back(std::make_unique<worker_queue>());
+        }
+        m_workers.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            m_workers.emplace_back([this, i] { worker_fn(i); });
+        }
+    }
+
+    thread_pool::~thread_pool()
+    {
+        {
+            std::unique_lock<std::mutex> locker(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    void thread_pool::post(task_t task)
+    {
+        GDK_RUNTIME_ASSERT(!m_queues.empty());
+        const size_t index = tl_pool == this ? tl_worker_index : m_next_queue++ % m_queues.size();
+        {
+            auto& queue = *m_queues[index];
+            std::unique_lock<std::mutex> locker(queue.mutex);
+            queue.tasks.emplace_back(std::move(task));
+        }
+        {
+            std::unique_lock<std::mutex> locker(m_mutex);
+            ++m_num_pending;
+        }
+        m_cv.notify_one();
+    }
+
+    void thread_pool::post_at(time_point_t when, task_t task)
+    {
+        GDK_RUNTIME_ASSERT(!m_queues.empty());
+        {
+            std::unique_lock<std::mutex> locker(m_mutex);
+            m_delayed.emplace(when, std::move(task));
+        }
+        // Wake all idle workers so that one waits for the new deadline
+        m_cv.notify_all();
+    }
+
+    size_t thread_pool::size() const { return m_workers.size(); }
+
+    bool thread_pool::try_get_task(size_t index, task_t& task)
+    {
+        const size_t num_queues = m_queues.size();
+        for (size_t i = 0; i < num_queues; ++i) {
+            auto& queue = *m_queues[(index + i) % num_queues];
+            std::unique_lock<std::mutex> locker(queue.mutex);
+            if (!queue.tasks.empty()) {
+                if (!i) {
+                    // Our own queue: take the most recently queued task
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    // Steal the oldest task from another worker
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool thread_pool::try_get_due_task(task_t& task)
+    {
+        // Caller must hold m_mutex
+        const auto p = m_delayed.begin();
+        if (p == m_delayed.end() || p->first > std::chrono::steady_clock::now()) {
+            return false;
+        }
+        task = std::move(p->second);
+        m_delayed.erase(p);
+        return true;
+    }
+
+    void thread_pool::worker_fn(size_t index)
+    {
+        tl_pool = this;
+        tl_worker_index = index;
+        for (;;) {
+            task_t task;
+            if (try_get_task(index, task)) {
+                {
+                    std::unique_lock<std::mutex> locker(m_mutex);
+                    --m_num_pending;
+                }
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> locker(m_mutex);
+            if (m_stop && !m_num_pending) {
+                break;
+            }
+            if (m_num_pending) {
+                continue; // A task was posted since we looked
+            }
+            if (try_get_due_task(task)) {
+                locker.unlock();
+                task();
+                continue;
+            }
+            // Wake when a task is posted, or the earliest delayed task is due
+            if (m_delayed.empty()) {
+                m_cv.wait(locker);
+            } else {
+                const auto deadline = m_delayed.begin()->first; // Copied as the task may be taken while we wait
+                m_cv.wait_until(locker, deadline);
+            }
+        }
+    }
+
+    struct strand_state {
+        explicit strand_state(thread_pool& pool)
+            : m_pool(pool)
+        {
+        }
+
+        thread_pool& m_pool;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        // Protected by m_mutex
+        std::deque<strand::task_t> m_tasks;
+        bool m_is_scheduled = false; // True while a task is posted to run our queue
+        bool m_is_stopped = false;
+        std::thread::id m_running_id; // The thread running one of our tasks, if any
+    };
+
+    namespace {
+        static void strand_run(const std::shared_ptr<strand_state>& state)
+        {
+            std::unique_lock<std::mutex> locker(state->m_mutex);
+            while (!state->m_is_stopped && !state->m_tasks.empty()) {
+                auto task = std::move(state->m_tasks.front());
+                state->m_tasks.pop_front();
+                state->m_running_id = std::this_thread::get_id();
+                locker.unlock();
+                no_std_exception_escape(task, "strand");
+                locker.lock();
+                state->m_running_id = std::thread::id();
+                state->m_cv.notify_all();
+            }
+            state->m_is_scheduled = false;
+        }
+
+        static void strand_post(const std::shared_ptr<strand_state>& state, strand::task_t task)
+        {
+            {
+                std::unique_lock<std::mutex> locker(state->m_mutex);
+                if (state->m_is_stopped) {
+                    return;
+                }
+                state->m_tasks.emplace_back(std::move(task));
+                if (state->m_is_scheduled) {
+                    return; // Will be run after the tasks ahead of it
+                }
+                state->m_is_scheduled = true;
+            }
+            state->m_pool.post([state] { strand_run(state); });
+        }
+    } // namespace
+
+    strand::strand(thread_pool& pool)
+        : m_state(std::make_shared<strand_state>(pool))
+    {
+    }
+
+    strand::~strand()
+    {
+        no_std_exception_escape([this] { stop(); }, "strand dtor");
+    }
+
+    void strand::post(task_t task) { strand_post(m_state, std::move(task)); }
+
+    void strand::post_at(thread_pool::time_point_t when, task_t task)
+    {
+        // Our state is kept alive until the task is due, but the
+        // task itself is discarded if we have been stopped
+        m_state->m_pool.post_at(when, [state = m_state, task = std::move(task)]() mutable {
+            no_std_exception_escape([&state, &task] { strand_post(state, std::move(task)); }, "strand post_at");
+        });
+    }
+
+    void strand::stop()
+    {
+        std::unique_lock<std::mutex> locker(m_state->m_mutex);
+        m_state->m_is_stopped = true;
+        m_state->m_tasks.clear();
+        const auto this_id = std::this_thread::get_id();
+        if (m_state->m_running_id != this_id) {
+            m_state->m_cv.wait(locker, [this] { return m_state->m_running_id == std::thread::id(); });
+        }
+    }
+
+    bool strand::running_in_this_thread() const
+    {
+        std::unique_lock<std::mutex> locker(m_state->m_mutex);
+        return m_state->m_running_id == std::this_thread::get_id();
+    }
+
+    void init_thread_pool(size_t num_threads)
+    {
+        std::unique_lock<std::mutex> locker(g_pool_mutex);
+        GDK_RUNTIME_ASSERT_MSG(!g_pool, "thread pool already initialized");
+        g_pool = new thread_pool(num_threads);
+    }
+
+    thread_pool& get_thread_pool()
+    {
+        std::unique_lock<std::mutex> locker(g_pool_mutex);
+        if (!g_pool) {
+            g_pool = new thread_pool(get_default_num_threads());
+        }
+        return *g_pool;
+    }
+
+    void init_call_pool(size_t num_threads)
+    {
+        GDK_RUNTIME_ASSERT_MSG(num_threads, "call pool requires at least one thread");
+        std::unique_lock<std::mutex> locker(g_pool_mutex);
+        GDK_RUNTIME_ASSERT_MSG(!g_call_pool, "call pool already initialized");
+        g_call_pool = new thread_pool(num_threads);
+    }
+
+    thread_pool& get_call_pool()
+    {
+        std::unique_lock<std::mutex> locker(g_pool_mutex);
+        if (!g_call_pool) {
+            g_call_pool = new thread_pool(DEFAULT_NUM_CALL_THREADS);
+        }
+        return *g_call_pool;
+    }
+
+    thread_pool& get_notification_pool()
+    {
+        std::unique_lock<std::mutex> locker(g_pool_mutex);
+        if (!g_notification_pool) {
+            g_notification_pool = new thread_pool(NUM_NOTIFICATION_THREADS);
+        }
+        return *g_notification_pool;
+    }
+
+} // namespace sdk
+} // namespace ga
@@ -0,0 +1,129 @@
+#ifndef GDK_THREAD_POOL_HPP
+#define GDK_THREAD_POOL_HPP
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ga {
+namespace sdk {
+
+    // A work-stealing pool of threads for CPU bound tasks, shared by all
+    // sessions in the process. Each worker has its own queue of tasks.
+    // Tasks posted from a worker are queued on that worker, other tasks are
+    // distributed between the workers. Idle workers steal tasks from the
+    // queues of busy workers, and run delayed tasks once they are due.
+    class thread_pool final {
+    public:
+        using task_t = std::function<void()>;
+        using time_point_t = std::chrono::steady_clock::time_point;
+
+        explicit thread_pool(size_t num_threads);
+        ~thread_pool();
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        thread_pool(thread_pool&&) = delete;
+        thread_pool& operator=(thread_pool&&) = delete;
+
+        // Queue a task for execution. Tasks must not throw.
+        void post(task_t task);
+
+        // Queue a task for execution once the given time is reached.
+        // Tasks must not throw. Delayed tasks are discarded if the pool is
+        // destroyed before they are due.
+        void post_at(time_point_t when, task_t task);
+
+        // The number of worker threads
+        size_t size() const;
+
+    private:
+        struct worker_queue {
+            std::mutex mutex;
+            std::deque<task_t> tasks;
+        };
+
+        bool try_get_task(size_t index, task_t& task);
+        bool try_get_due_task(task_t& task);
+        void worker_fn(size_t index);
+
+        std::vector<std::unique_ptr<worker_queue>> m_queues;
+        std::vector<std::thread> m_workers;
+        std::atomic<size_t> m_next_queue; // Queue for the next task posted by a non-worker
+        std::mutex m_mutex; // Protects sleeping/waking of idle workers
+        std::condition_variable m_cv;
+        size_t m_num_pending; // Protected by m_mutex
+        std::multimap<time_point_t, task_t> m_delayed; // Protected by m_mutex
+        bool m_stop; // Protected by m_mutex
+    };
+
+    struct strand_state;
+
+    // Runs the tasks posted through it on a pool one at a time, in the
+    // order they were posted (or became due, for delayed tasks). Lets
+    // objects such as sessions run background work on the shared pools
+    // without a thread of their own.
+    class strand final {
+    public:
+        using task_t = thread_pool::task_t;
+
+        explicit strand(thread_pool& pool);
+        ~strand();
+
+        strand(const strand&) = delete;
+        strand& operator=(const strand&) = delete;
+        strand(strand&&) = delete;
+        strand& operator=(strand&&) = delete;
+
+        // Queue a task for execution. Tasks must not throw.
+        void post(task_t task);
+
+        // Queue a task for execution once the given time is reached
+        void post_at(thread_pool::time_point_t when, task_t task);
+
+        // Discard any tasks not yet run and wait for any running task to
+        // complete, unless called from that task. Tasks posted afterwards
+        // are discarded.
+        void stop();
+
+        // Whether the calling thread is running a task of this strand
+        bool running_in_this_thread() const;
+
+    private:
+        std::shared_ptr<strand_state> m_state;
+    };
+
+    // Set the number of threads in the process-wide pool. Must be called
+    // before the pool is first used; GA_init calls this from its config.
+    void init_thread_pool(size_t num_threads);
+
+    // Get the process-wide pool
+    thread_pool& get_thread_pool();
+
+    // Set the number of threads in the process-wide pool for running calls
+    // on behalf of the caller, such as GA_auth_handler_call_async. Calls may
+    // block on the network, so they are kept apart from the CPU bound pool.
+    // Must be called before the pool is first used; GA_init calls this from
+    // its config.
+    void init_call_pool(size_t num_threads);
+
+    // Get the process-wide pool for calls
+    thread_pool& get_call_pool();
+
+    // Get the process-wide pool for delivering notifications. Only
+    // notification handlers run on it, so delivery is never held up behind
+    // calls blocked on the network.
+    thread_pool& get_notification_pool();
+
+} // namespace sdk
+} // namespace ga
+
+#endif
@@ -2,7 +2,17 @@
 #define GDK_THREADING_HPP
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.hpp"
 
 namespace ga {
 namespace sdk {
@@ -38,6 +48,73 @@ namespace sdk {
         std::unique_lock<std::mutex>& m_locker;
     };
 
+    // Call fn(begin, end) over disjoint chunks of [0, num_items), spreading
+    // the chunks over up to max_threads threads from the shared thread pool,
+    // including the calling thread. Chunks hold at least min_items_per_thread
+    // items. Any exception thrown by fn is re-thrown once all chunks have
+    // completed. The calling thread processes chunks until none remain, so
+    // this may safely be called from tasks running on the pool.
+    template <typename F>
+    void parallel_for_chunks(size_t num_items, size_t min_items_per_thread, size_t max_threads, F&& fn)
+    {
+        auto& pool = get_thread_pool();
+        const size_t num_cores = pool.size() + 1; // Pool threads plus this thread
+        const size_t num_threads = std::max(
+            std::min({ num_cores, max_threads, num_items / std::max(min_items_per_thread, size_t(1)) }), size_t(1));
+        if (num_threads == 1) {
+            fn(size_t(0), num_items);
+            return;
+        }
+        const size_t per_thread = (num_items + num_threads - 1) / num_threads;
+        const size_t num_chunks = (num_items + per_thread - 1) / per_thread;
+
+        // Shared with pool tasks, which may start after we have returned
+        struct state_t {
+            std::atomic<size_t> next_chunk{ 0 };
+            std::mutex mutex;
+            std::condition_variable cv;
+            size_t num_done = 0;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<state_t>();
+        auto* fn_p = &fn;
+
+        // Process chunks until none remain. fn_p is only dereferenced for
+        // a claimed chunk, which we wait for before returning
+        auto run_chunks = [state, fn_p, per_thread, num_chunks, num_items] {
+            for (;;) {
+                const size_t chunk = state->next_chunk++;
+                if (chunk >= num_chunks) {
+                    return;
+                }
+                const size_t begin = chunk * per_thread;
+                std::exception_ptr error;
+                try {
+                    (*fn_p)(begin, std::min(begin + per_thread, num_items));
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                std::unique_lock<std::mutex> locker(state->mutex);
+                if (error && !state->error) {
+                    state->error = error;
+                }
+                if (++state->num_done == num_chunks) {
+                    state->cv.notify_all();
+                }
+            }
+        };
+        for (size_t i = 1; i < num_threads; ++i) {
+            pool.post(run_chunks);
+        }
+        run_chunks();
+
+        std::unique_lock<std::mutex> locker(state->mutex);
+        state->cv.wait(locker, [&state, num_chunks] { return state->num_done == num_chunks; });
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+
 } // namespace sdk
 } // namespace ga
 
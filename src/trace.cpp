@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <vector>
+
+#include "assertion.hpp"
+#include "logging.hpp"
+#include "trace.hpp"
+
+namespace ga {
+namespace sdk {
+
+    namespace detail {
+        std::atomic_bool tracing_enabled{ false };
+    } // namespace detail
+
+    namespace {
+        using clock = std::chrono::steady_clock;
+
+        // The number of most recent spans kept for each thread
+        constexpr size_t RING_SIZE = 8192;
+
+        // A recorded span, written by its owning thread only. The sequence
+        // number is odd while the span is being written, and 2 * (n + 1)
+        // once the thread's nth span has been written, allowing readers to
+        // detect slots that are overwritten while being read.
+        struct span_slot {
+            std::atomic<uint64_t> seq{ 0 };
+            std::atomic<const char*> name{ nullptr };
+            std::atomic<int64_t> start_ns{ 0 };
+            std::atomic<int64_t> duration_ns{ 0 };
+        };
+
+        struct span_ring {
+            explicit span_ring(size_t id)
+                : tid(id)
+            {
+            }
+
+            const size_t tid;
+            std::atomic<uint64_t> num_written{ 0 };
+            std::atomic_bool is_in_use{ true };
+            std::array<span_slot, RING_SIZE> slots;
+        };
+
+        // Releases the current thread's ring for reuse when the thread exits
+        struct thread_ring_holder {
+            ~thread_ring_holder()
+            {
+                if (ring) {
+                    ring->is_in_use.store(false);
+                }
+            }
+            span_ring* ring = nullptr;
+        };
+
+        static std::mutex g_trace_mutex;
+        // These are never deleted, to avoid destruction order issues at exit
+        static std::vector<std::unique_ptr<span_ring>>* g_rings = nullptr;
+        static std::set<std::string, std::less<>>* g_span_names = nullptr;
+        static std::string g_trace_file;
+        static clock::time_point g_epoch;
+
+        static thread_local thread_ring_holder t_ring;
+
+        static span_ring* get_thread_ring()
+        {
+            if (!t_ring.ring) {
+                std::unique_lock<std::mutex> locker(g_trace_mutex);
+                // Reuse the ring of an exited thread, if any
+                for (auto& ring : *g_rings) {
+                    bool expected = false;
+                    if (ring->is_in_use.compare_exchange_strong(expected, true)) {
+                        t_ring.ring = ring.get();
+                        return t_ring.ring;
+                    }
+                }
+                g_rings->emplace_back(std::make_unique<span_ring>(g_rings->size() + 1));
+                t_ring.ring = g_rings->back().get();
+            }
+            return t_ring.ring;
+        }
+
+        static int64_t get_epoch_ns(clock::time_point t)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(t - g_epoch).count();
+        }
+    } // namespace
+
+    namespace detail {
+        void record_span(const char* name, clock::time_point start)
+        {
+            const auto end = clock::now();
+            auto ring = get_thread_ring();
+            const uint64_t n = ring->num_written.load(std::memory_order_relaxed);
+            auto& slot = ring->slots[n % RING_SIZE];
+            slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.name.store(name, std::memory_order_relaxed);
+            slot.start_ns.store(get_epoch_ns(start), std::memory_order_relaxed);
+            slot.duration_ns.store(get_epoch_ns(end) - get_epoch_ns(start), std::memory_order_relaxed);
+            slot.seq.store(2 * (n + 1), std::memory_order_release);
+            ring->num_written.store(n + 1, std::memory_order_release);
+        }
+
+        const char* intern_span_name(std::string_view name)
+        {
+            std::unique_lock<std::mutex> locker(g_trace_mutex);
+            auto p = g_span_names->find(name);
+            if (p == g_span_names->end()) {
+                p = g_span_names->emplace(name).first;
+            }
+            return p->c_str();
+        }
+    } // namespace detail
+
+    void init_tracing(const std::string& trace_file)
+    {
+        GDK_RUNTIME_ASSERT(!trace_file.empty());
+        std::unique_lock<std::mutex> locker(g_trace_mutex);
+        GDK_RUNTIME_ASSERT_MSG(!detail::tracing_enabled, "tracing already initialized");
+        g_rings = new std::vector<std::unique_ptr<span_ring>>();
+        g_span_names = new std::set<std::string, std::less<>>();
+        g_trace_file = trace_file;
+        g_epoch = clock::now();
+        detail::tracing_enabled = true;
+    }
+
+    void dump_trace()
+    {
+        if (!is_tracing_enabled()) {
+            return;
+        }
+        nlohmann::json events = nlohmann::json::array();
+        std::unique_lock<std::mutex> locker(g_trace_mutex);
+        for (const auto& ring : *g_rings) {
+            const uint64_t num_written = ring->num_written.load(std::memory_order_acquire);
+            const uint64_t first = num_written > RING_SIZE ? num_written - RING_SIZE : 0;
+            for (uint64_t n = first; n < num_written; ++n) {
+                const auto& slot = ring->slots[n % RING_SIZE];
+                const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+                const char* name = slot.name.load(std::memory_order_relaxed);
+                const int64_t start_ns = slot.start_ns.load(std::memory_order_relaxed);
+                const int64_t duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq != 2 * (n + 1) || slot.seq.load(std::memory_order_relaxed) != seq) {
+                    continue; // Overwritten while reading
+                }
+                // Chrome trace timestamps are in (fractional) microseconds
+                events.push_back({ { "name", name }, { "ph", "X" }, { "pid", 1 }, { "tid", ring->tid },
+                    { "ts", start_ns / 1000.0 }, { "dur", duration_ns / 1000.0 } });
+            }
+        }
+        const std::string trace_file = g_trace_file;
+        locker.unlock();
+
+        std::sort(events.begin(), events.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs["ts"].template get<double>() < rhs["ts"]; });
+        std::ofstream f(trace_file, std::ios::out | std::ios::trunc);
+        f << nlohmann::json({ { "traceEvents", std::move(events) }, { "displayTimeUnit", "ms" } }).dump();
+        if (!f) {
+            GDK_LOG_SEV(log_level::warning) << "failed to write trace file " << trace_file;
+        }
+    }
+
+} // namespace sdk
+} // namespace ga
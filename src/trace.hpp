@@ -0,0 +1,85 @@
+#ifndef GDK_TRACE_HPP
+#define GDK_TRACE_HPP
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace ga {
+namespace sdk {
+
+    // Lightweight scoped tracing spans.
+    //
+    // When tracing is enabled, each span records its name, start time and
+    // duration into a fixed size ring buffer owned by the current thread,
+    // without taking locks. The most recent spans from all threads can then
+    // be written out in Chrome trace JSON format, for viewing in
+    // chrome://tracing or Perfetto.
+    //
+    // Spans are created with GDK_TRACE_SPAN, and cost a single atomic load
+    // when tracing is disabled at runtime. Building with GDK_DISABLE_TRACING
+    // defined removes them entirely.
+    namespace detail {
+        extern std::atomic_bool tracing_enabled;
+        void record_span(const char* name, std::chrono::steady_clock::time_point start);
+        const char* intern_span_name(std::string_view name);
+    } // namespace detail
+
+    inline bool is_tracing_enabled() { return detail::tracing_enabled.load(std::memory_order_relaxed); }
+
+    // Start recording spans, to be written to trace_file by dump_trace().
+    // GA_init calls this when given a "trace_file" in its config.
+    void init_tracing(const std::string& trace_file);
+
+    // Write the recorded spans to the trace file. Does nothing if tracing
+    // is not enabled.
+    void dump_trace();
+
+    class trace_span final {
+    public:
+        // name must outlive the span, i.e. usually be a string literal
+        explicit trace_span(const char* name)
+            : m_name(is_tracing_enabled() ? name : nullptr)
+        {
+            if (m_name) {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        // A span with a dynamic name, which started at the given time
+        trace_span(std::string_view name, std::chrono::steady_clock::time_point start)
+            : m_name(is_tracing_enabled() ? detail::intern_span_name(name) : nullptr)
+            , m_start(start)
+        {
+        }
+
+        ~trace_span()
+        {
+            if (m_name) {
+                detail::record_span(m_name, m_start);
+            }
+        }
+
+        trace_span(const trace_span&) = delete;
+        trace_span& operator=(const trace_span&) = delete;
+
+    private:
+        const char* m_name;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+} // namespace sdk
+} // namespace ga
+
+#define GDK_TRACE_CONCAT_IMPL(a, b) a##b
+#define GDK_TRACE_CONCAT(a, b) GDK_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef GDK_DISABLE_TRACING
+#define GDK_TRACE_SPAN(...)
+#else
+#define GDK_TRACE_SPAN(...) ::ga::sdk::trace_span GDK_TRACE_CONCAT(gdk_trace_span_, __LINE__)(__VA_ARGS__)
+#endif
+
+#endif
@@ -0,0 +1,186 @@
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "assertion.hpp"
+#include "logging.hpp"
+#include "traffic_capture.hpp"
+
+namespace ga {
+namespace sdk {
+
+    namespace detail {
+        std::atomic<capture_mode> g_capture_mode{ capture_mode::none };
+    } // namespace detail
+
+    namespace {
+        // The capture file is a sequence of records, each a 4 byte little
+        // endian length followed by a msgpack map of that length holding the
+        // "kind", "name", binary "key" and binary "result" of a call
+        constexpr size_t RECORD_PREFIX_LEN = 4;
+
+        struct capture_entry {
+            std::string result;
+            bool is_used = false;
+        };
+
+        struct capture_state {
+            std::mutex mutex;
+            std::chrono::milliseconds latency{ 0 };
+            std::ofstream out;
+            std::vector<capture_entry> entries;
+            // Indices of entries in recorded order, by kind and name, and by
+            // kind, name and key
+            std::unordered_map<std::string, std::vector<size_t>> by_name;
+            std::unordered_map<std::string, std::vector<size_t>> by_key;
+        };
+
+        // Never deleted, to avoid destruction order issues at exit
+        static capture_state& get_capture_state()
+        {
+            static capture_state* state = new capture_state();
+            return *state;
+        }
+
+        static std::string get_name_key(const std::string& kind, const std::string& name)
+        {
+            return kind + '\0' + name;
+        }
+
+        static nlohmann::json::binary_t to_binary(const std::string& s)
+        {
+            return nlohmann::json::binary_t(std::vector<uint8_t>(s.begin(), s.end()));
+        }
+
+        static std::string from_binary(const nlohmann::json& j)
+        {
+            const auto& bin = j.get_binary();
+            return std::string(bin.begin(), bin.end());
+        }
+
+        static void load_capture_file(capture_state& state, const std::string& capture_file)
+        {
+            std::ifstream in(capture_file, std::ios::binary);
+            GDK_RUNTIME_ASSERT_MSG(in.is_open(), "unable to open capture file " + capture_file);
+            const std::vector<uint8_t> data{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+
+            for (size_t offset = 0; offset < data.size();) {
+                GDK_RUNTIME_ASSERT_MSG(data.size() - offset >= RECORD_PREFIX_LEN, "truncated capture file");
+                size_t len = 0;
+                for (size_t i = 0; i < RECORD_PREFIX_LEN; ++i) {
+                    len |= static_cast<size_t>(data[offset + i]) << (i * 8);
+                }
+                offset += RECORD_PREFIX_LEN;
+                GDK_RUNTIME_ASSERT_MSG(data.size() - offset >= len, "truncated capture file");
+                const auto begin = data.begin() + offset;
+                const auto record = nlohmann::json::from_msgpack(begin, begin + len);
+                offset += len;
+
+                const auto name_key = get_name_key(record.at("kind"), record.at("name"));
+                const size_t index = state.entries.size();
+                state.entries.push_back({ from_binary(record.at("result")) });
+                state.by_name[name_key].push_back(index);
+                state.by_key[name_key + '\0' + from_binary(record.at("key"))].push_back(index);
+            }
+            GDK_LOG_SEV(log_level::info) << "capture: loaded " << state.entries.size() << " records";
+        }
+
+        // Return the first unused entry of indices, or nullptr if all are used
+        static capture_entry* get_unused_entry(capture_state& state, const std::vector<size_t>* indices)
+        {
+            if (indices) {
+                for (const auto i : *indices) {
+                    if (!state.entries[i].is_used) {
+                        return &state.entries[i];
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        static const std::vector<size_t>* find_indices(
+            const std::unordered_map<std::string, std::vector<size_t>>& map, const std::string& key)
+        {
+            const auto p = map.find(key);
+            return p == map.end() ? nullptr : &p->second;
+        }
+    } // namespace
+
+    void init_capture(const std::string& capture_file, capture_mode mode, uint32_t latency_ms)
+    {
+        auto& state = get_capture_state();
+        std::unique_lock<std::mutex> locker(state.mutex);
+        detail::g_capture_mode = capture_mode::none;
+        state.latency = std::chrono::milliseconds(latency_ms);
+        state.out = std::ofstream();
+        state.entries.clear();
+        state.by_name.clear();
+        state.by_key.clear();
+
+        if (mode == capture_mode::record) {
+            state.out.open(capture_file, std::ios::binary | std::ios::trunc);
+            GDK_RUNTIME_ASSERT_MSG(state.out.is_open(), "unable to create capture file " + capture_file);
+        } else if (mode == capture_mode::replay) {
+            load_capture_file(state, capture_file);
+        }
+        detail::g_capture_mode = mode;
+    }
+
+    void capture_record(
+        const std::string& kind, const std::string& name, const std::string& key, const std::string& result)
+    {
+        const nlohmann::json record = { { "kind", kind }, { "name", name }, { "key", to_binary(key) },
+            { "result", to_binary(result) } };
+        const auto bytes = nlohmann::json::to_msgpack(record);
+        GDK_RUNTIME_ASSERT(bytes.size() <= UINT32_MAX);
+        char prefix[RECORD_PREFIX_LEN];
+        for (size_t i = 0; i < RECORD_PREFIX_LEN; ++i) {
+            prefix[i] = static_cast<char>((bytes.size() >> (i * 8)) & 0xff);
+        }
+
+        auto& state = get_capture_state();
+        std::unique_lock<std::mutex> locker(state.mutex);
+        if (state.out.is_open()) {
+            state.out.write(prefix, sizeof(prefix));
+            state.out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            state.out.flush();
+        }
+    }
+
+    std::string capture_replay(const std::string& kind, const std::string& name, const std::string& key,
+        std::chrono::steady_clock::time_point start)
+    {
+        auto& state = get_capture_state();
+        std::string result;
+        std::chrono::milliseconds latency;
+        {
+            std::unique_lock<std::mutex> locker(state.mutex);
+            const auto name_key = get_name_key(kind, name);
+            const auto by_name = find_indices(state.by_name, name_key);
+            GDK_RUNTIME_ASSERT_MSG(by_name, "capture: no recorded result for " + kind + " " + name);
+            const auto by_key = find_indices(state.by_key, name_key + '\0' + key);
+
+            // Use the next result recorded for these arguments if they were
+            // recorded, otherwise the next for the name. Once all are used,
+            // repeat the last one.
+            const auto indices = by_key ? by_key : by_name;
+            auto entry = get_unused_entry(state, indices);
+            if (entry) {
+                entry->is_used = true;
+            } else {
+                entry = &state.entries[indices->back()];
+            }
+            result = entry->result;
+            latency = state.latency;
+        }
+        std::this_thread::sleep_until(start + latency);
+        return result;
+    }
+
+} // namespace sdk
+} // namespace ga
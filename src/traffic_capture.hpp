@@ -0,0 +1,53 @@
+#ifndef GDK_TRAFFIC_CAPTURE_HPP
+#define GDK_TRAFFIC_CAPTURE_HPP
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace ga {
+namespace sdk {
+
+    // Record and replay of server traffic, for running sessions offline.
+    //
+    // When recording, the results of WAMP calls and HTTP requests are
+    // appended to a capture file along with the name and arguments of the
+    // call that returned them. When replaying, no connections are made and
+    // calls are answered from the capture file, each after an optional
+    // injected latency, so that scenarios such as login, tx syncing and
+    // tx creation can be benchmarked deterministically without a backend.
+    //
+    // Replayed calls are matched by name and arguments. A call whose
+    // arguments were not recorded (e.g. because they contain random data)
+    // gets the next unused result recorded for its name. A call made more
+    // times than it was recorded repeats its last result.
+    enum class capture_mode : uint32_t { none = 0, record = 1, replay = 2 };
+
+    namespace detail {
+        extern std::atomic<capture_mode> g_capture_mode;
+    } // namespace detail
+
+    inline bool is_capture_recording() { return detail::g_capture_mode.load() == capture_mode::record; }
+    inline bool is_capture_replaying() { return detail::g_capture_mode.load() == capture_mode::replay; }
+
+    // Start recording to, or replaying from, capture_file. Replayed calls
+    // return no sooner than latency_ms after they were made. GA_init calls
+    // this when given a "capture_file" in its config.
+    void init_capture(const std::string& capture_file, capture_mode mode, uint32_t latency_ms = 0);
+
+    // Record the result of a call. kind identifies the transport, e.g.
+    // "wamp", and key the call's name and arguments in serialized form.
+    void capture_record(const std::string& kind, const std::string& name, const std::string& key,
+        const std::string& result);
+
+    // Return the recorded result of a call made at start, waiting for any
+    // injected latency. Throws if nothing was recorded for the call's name.
+    std::string capture_replay(const std::string& kind, const std::string& name, const std::string& key,
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now());
+
+} // namespace sdk
+} // namespace ga
+
+#endif
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstring>
+
+#include "assertion.hpp"
+#include "transaction_list.hpp"
+
+namespace ga {
+namespace sdk {
+
+    namespace {
+        static uint32_t intern_string(std::vector<std::string>& strings, const std::string& value)
+        {
+            // The number of distinct types, spv states and assets in
+            // a page is small, so a linear search is sufficient
+            const auto p = std::find(strings.begin(), strings.end(), value);
+            if (p != strings.end()) {
+                return static_cast<uint32_t>(p - strings.begin());
+            }
+            strings.push_back(value);
+            return static_cast<uint32_t>(strings.size() - 1);
+        }
+    } // namespace
+
+    transaction_list::transaction_list(const nlohmann::json& transactions)
+    {
+        const auto& txs = transactions.is_object() ? transactions.at("transactions") : transactions;
+        GDK_RUNTIME_ASSERT(txs.is_array());
+
+        const size_t num_txs = txs.size();
+        m_txhashes.reserve(num_txs);
+        m_types.reserve(num_txs);
+        m_spv_states.reserve(num_txs);
+        m_created_at_ts.reserve(num_txs);
+        m_block_heights.reserve(num_txs);
+        m_fees.reserve(num_txs);
+        m_amount_offsets.reserve(num_txs + 1);
+        m_amount_offsets.push_back(0);
+
+        for (const auto& tx : txs) {
+            m_txhashes.push_back(tx.at("txhash"));
+            m_types.push_back(intern_string(m_strings, tx.value("type", std::string())));
+            m_spv_states.push_back(intern_string(m_strings, tx.value("spv_verified", std::string())));
+            m_created_at_ts.push_back(tx.value("created_at_ts", uint64_t(0)));
+            m_block_heights.push_back(tx.value("block_height", uint32_t(0)));
+            m_fees.push_back(tx.value("fee", uint64_t(0)));
+            if (const auto satoshi_p = tx.find("satoshi"); satoshi_p != tx.end()) {
+                for (const auto& item : satoshi_p->items()) {
+                    m_amounts.emplace_back(intern_string(m_strings, item.key()), item.value().get<int64_t>());
+                }
+            }
+            m_amount_offsets.push_back(m_amounts.size());
+        }
+    }
+
+    size_t transaction_list::size() const { return m_txhashes.size(); }
+
+    const char* transaction_list::get_txhash(size_t i) const { return m_txhashes.at(i).c_str(); }
+
+    const char* transaction_list::get_type(size_t i) const { return m_strings.at(m_types.at(i)).c_str(); }
+
+    const char* transaction_list::get_spv_verified(size_t i) const
+    {
+        return m_strings.at(m_spv_states.at(i)).c_str();
+    }
+
+    uint64_t transaction_list::get_created_at_ts(size_t i) const { return m_created_at_ts.at(i); }
+
+    uint32_t transaction_list::get_block_height(size_t i) const { return m_block_heights.at(i); }
+
+    uint64_t transaction_list::get_fee(size_t i) const { return m_fees.at(i); }
+
+    size_t transaction_list::get_num_assets(size_t i) const
+    {
+        GDK_RUNTIME_ASSERT(i < size());
+        return m_amount_offsets[i + 1] - m_amount_offsets[i];
+    }
+
+    size_t transaction_list::get_asset_offset(size_t i, size_t asset_index) const
+    {
+        GDK_RUNTIME_ASSERT(asset_index < get_num_assets(i));
+        return m_amount_offsets[i] + asset_index;
+    }
+
+    const char* transaction_list::get_asset_id(size_t i, size_t asset_index) const
+    {
+        return m_strings[m_amounts[get_asset_offset(i, asset_index)].first].c_str();
+    }
+
+    int64_t transaction_list::get_satoshi(size_t i, size_t asset_index) const
+    {
+        return m_amounts[get_asset_offset(i, asset_index)].second;
+    }
+
+    int64_t transaction_list::get_satoshi(size_t i, const char* asset_id) const
+    {
+        GDK_RUNTIME_ASSERT(asset_id);
+        const size_t num_assets = get_num_assets(i);
+        for (size_t j = 0; j < num_assets; ++j) {
+            const auto& amount = m_amounts[m_amount_offsets[i] + j];
+            if (!strcmp(m_strings[amount.first].c_str(), asset_id)) {
+                return amount.second;
+            }
+        }
+        return 0;
+    }
+
+} // namespace sdk
+} // namespace ga
@@ -0,0 +1,67 @@
+#ifndef GDK_TRANSACTION_LIST_HPP
+#define GDK_TRANSACTION_LIST_HPP
+#pragma once
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ga {
+namespace sdk {
+
+    // A read-only, columnar view of a page of transactions as returned
+    // from get_transactions. Allows callers to access the commonly
+    // displayed fields of each transaction by index without walking
+    // or serializing the JSON representation.
+    class transaction_list {
+    public:
+        // Construct from either a get_transactions result containing
+        // "transactions", or the array of transactions itself
+        explicit transaction_list(const nlohmann::json& transactions);
+
+        transaction_list(const transaction_list&) = delete;
+        transaction_list& operator=(const transaction_list&) = delete;
+        transaction_list(transaction_list&&) = delete;
+        transaction_list& operator=(transaction_list&&) = delete;
+
+        size_t size() const;
+
+        // The returned pointers remain valid for the lifetime of the list
+        const char* get_txhash(size_t i) const;
+        const char* get_type(size_t i) const;
+        const char* get_spv_verified(size_t i) const;
+
+        uint64_t get_created_at_ts(size_t i) const;
+        uint32_t get_block_height(size_t i) const;
+        uint64_t get_fee(size_t i) const;
+
+        // Per-asset net amounts. Assets are indexed from 0 to get_num_assets(i)
+        size_t get_num_assets(size_t i) const;
+        const char* get_asset_id(size_t i, size_t asset_index) const;
+        int64_t get_satoshi(size_t i, size_t asset_index) const;
+        // Returns the net amount for the given asset, or 0 if the tx doesn't involve it
+        int64_t get_satoshi(size_t i, const char* asset_id) const;
+
+    private:
+        size_t get_asset_offset(size_t i, size_t asset_index) const;
+
+        std::vector<std::string> m_txhashes;
+        std::vector<uint32_t> m_types; // Indices into m_strings
+        std::vector<uint32_t> m_spv_states; // Indices into m_strings
+        std::vector<uint64_t> m_created_at_ts;
+        std::vector<uint32_t> m_block_heights;
+        std::vector<uint64_t> m_fees;
+        // Per-tx amounts are stored contiguously; the amounts for tx i
+        // are at [m_amount_offsets[i], m_amount_offsets[i + 1])
+        std::vector<size_t> m_amount_offsets;
+        std::vector<std::pair<uint32_t, int64_t>> m_amounts; // Asset id index into m_strings, satoshi
+        // Interned values for low-cardinality string columns
+        std::vector<std::string> m_strings;
+    };
+
+} // namespace sdk
+} // namespace ga
+
+#endif
@@ -7,11 +7,13 @@
 #include "memory.hpp"
 #include "session_impl.hpp"
 #include "signer.hpp"
+#include "threading.hpp"
 #include "transaction_utils.hpp"
 #include "utils.hpp"
 #include "xpub_hdkey.hpp"
 
 #include <cctype>
+#include <cerrno>
 
 namespace {
 static bool isupper(const std::string& s)
@@ -108,6 +110,37 @@ namespace sdk {
         const std::string csv("csv");
     } // namespace address_type
 
+    void utxo_set::reserve(size_t n)
+    {
+        coins.reserve(n);
+        utxos.reserve(n);
+    }
+
+    void utxo_set::add(nlohmann::json& utxo)
+    {
+        const bool is_external = !json_get_value(utxo, "private_key").empty();
+        const auto addr_type = is_external ? address_type::p2pkh : json_get_value(utxo, "address_type");
+        const amount::value_type satoshi = utxo.at("satoshi");
+        coins.push_back({ satoshi, get_utxo_input_weight(addr_type) });
+        utxos.push_back(&utxo);
+    }
+
+    void utxo_set::append(const utxo_set& other)
+    {
+        coins.insert(coins.end(), other.coins.begin(), other.coins.end());
+        utxos.insert(utxos.end(), other.utxos.begin(), other.utxos.end());
+    }
+
+    nlohmann::json utxo_set::to_json() const
+    {
+        nlohmann::json::array_t ret;
+        ret.reserve(utxos.size());
+        for (const auto* utxo : utxos) {
+            ret.push_back(*utxo);
+        }
+        return ret;
+    }
+
     // Dummy signatures are needed for correctly sizing transactions. If our signer supports
     // low-R signatures, we estimate on a 71 byte signature, and occasionally produce 70 byte
     // signatures. Otherwise, we estimate on 72 bytes and occasionally produce 70 or 71 byte
@@ -401,11 +434,46 @@ namespace sdk {
         return weight;
     }
 
-    amount get_tx_fee(
-        const network_parameters& net_params, const wally_tx_ptr& tx, amount min_fee_rate, amount fee_rate)
+    static size_t get_varint_length(size_t n) { return n < 0xfd ? 1 : n <= 0xffff ? 3 : n <= 0xffffffff ? 5 : 9; }
+
+    size_t tx_weight_tracker::get_weight(const network_parameters& net_params, const wally_tx_ptr& tx)
+    {
+        if (net_params.is_liquid() || tx->num_inputs < m_num_inputs) {
+            // Liquid weights depend on blinding data, and removed inputs
+            // invalidate our totals: compute the weight from scratch
+            *this = tx_weight_tracker();
+            return get_tx_adjusted_weight(net_params, tx);
+        }
+        for (; m_num_inputs < tx->num_inputs; ++m_num_inputs) {
+            const auto& input = tx->inputs[m_num_inputs];
+            m_inputs_size += WALLY_TXHASH_LEN + sizeof(uint32_t) * 2 + varbuff_get_length(input.script_len);
+            if (input.witness && input.witness->num_items) {
+                m_has_witness = true;
+                m_witness_size += get_varint_length(input.witness->num_items);
+                for (size_t i = 0; i < input.witness->num_items; ++i) {
+                    m_witness_size += varbuff_get_length(input.witness->items[i].witness_len);
+                }
+            } else {
+                m_witness_size += 1; // Empty witness stack
+            }
+        }
+        size_t outputs_size = 0;
+        for (size_t i = 0; i < tx->num_outputs; ++i) {
+            outputs_size += sizeof(uint64_t) + varbuff_get_length(tx->outputs[i].script_len);
+        }
+        // version + locktime + inputs + outputs
+        const size_t base_size = sizeof(uint32_t) * 2 + get_varint_length(tx->num_inputs) + m_inputs_size
+            + get_varint_length(tx->num_outputs) + outputs_size;
+        // Segwit marker and flag + witnesses
+        const size_t witness_size = m_has_witness ? 2 + m_witness_size : 0;
+        return base_size * 4 + witness_size;
+    }
+
+    amount get_tx_fee(const network_parameters& net_params, const wally_tx_ptr& tx, amount min_fee_rate,
+        amount fee_rate, tx_weight_tracker* tracker)
     {
         const amount rate = fee_rate < min_fee_rate ? min_fee_rate : fee_rate;
-        const size_t weight = get_tx_adjusted_weight(net_params, tx);
+        const size_t weight = tracker ? tracker->get_weight(net_params, tx) : get_tx_adjusted_weight(net_params, tx);
         const size_t vsize = (weight + 3) / 4;
         const auto fee = static_cast<double>(vsize) * rate.value() / 1000.0;
         const auto rounded_fee = static_cast<amount::value_type>(std::ceil(fee));
@@ -421,11 +489,11 @@ namespace sdk {
         return script;
     }
 
-    void set_tx_error(nlohmann::json& result, const std::string& error, bool overwrite)
+    void set_tx_error(nlohmann::json& result, std::string_view error, bool overwrite)
     {
         auto& e = result["error"];
         if (overwrite || e.empty() || e.get<std::string>().empty()) {
-            e = error;
+            e = std::string(error);
         }
     }
 
@@ -437,10 +505,48 @@ namespace sdk {
         tx_elements_output_commitment_set(tx, index, asset_bytes, ct_value, {}, {}, {});
     }
 
-    // TODO: Merge this validation with add_tx_addressee_output to avoid re-parsing?
-    std::string validate_tx_addressee(session_impl& session, nlohmann::json& addressee)
+    namespace {
+        // Minimum number of addressees to parse per thread when validating in parallel
+        constexpr size_t MIN_ADDRESSEES_PER_THREAD = 32;
+        // Maximum number of threads to parse addressees with
+        constexpr size_t MAX_ADDRESSEE_THREADS = 8;
+
+        // Check the parts of an addressee that depend on the session's signer
+        static std::string check_tx_addressee_signer(session_impl& session, const nlohmann::json& addressee)
+        {
+            try {
+                const std::string address = json_get_value(addressee, "address");
+                if (address.empty()) {
+                    throw user_error(res::id_invalid_address);
+                }
+                const bool is_liquid = session.get_network_parameters().is_liquid();
+                const bool is_blinded = is_liquid && addressee.value("is_blinded", false);
+                if (is_blinded && !session.get_nonnull_signer()->supports_external_blinding()) {
+                    throw user_error("Signing device does not support externally blinded transactions");
+                }
+            } catch (const std::exception& e) {
+                return e.what();
+            }
+            return std::string();
+        }
+
+        // Validate and convert the amount of an addressee to satoshi
+        static std::string convert_tx_addressee_amount(session_impl& session, nlohmann::json& addressee)
+        {
+            try {
+                addressee["satoshi"] = session.convert_amount(addressee)["satoshi"].get<amount::value_type>();
+                amount::strip_non_satoshi_keys(addressee);
+            } catch (const user_error& ex) {
+                return ex.what();
+            } catch (const std::exception& ex) {
+                return std::string(res::id_invalid_amount);
+            }
+            return std::string();
+        }
+    } // namespace
+
+    std::string parse_tx_addressee(const network_parameters& net_params, nlohmann::json& addressee)
     {
-        const auto& net_params = session.get_network_parameters();
         const bool is_liquid = net_params.is_liquid();
         const auto blech32_prefix = net_params.blech32_prefix();
 
@@ -450,9 +556,6 @@ namespace sdk {
                 throw user_error(res::id_invalid_address);
             }
             const bool is_blinded = is_liquid && addressee.value("is_blinded", false);
-            if (is_blinded && !session.get_nonnull_signer()->supports_external_blinding()) {
-                throw user_error("Signing device does not support externally blinded transactions");
-            }
 
             // BIP21
             auto uri = parse_bitcoin_uri(net_params, address);
@@ -499,16 +602,6 @@ namespace sdk {
             // Validate the asset (or lack of it)
             asset_id_from_json(net_params, addressee);
 
-            // Validate and convert the amount to satoshi
-            try {
-                addressee["satoshi"] = session.convert_amount(addressee)["satoshi"].get<amount::value_type>();
-                amount::strip_non_satoshi_keys(addressee);
-            } catch (const user_error& ex) {
-                return ex.what();
-            } catch (const std::exception& ex) {
-                return res::id_invalid_amount;
-            }
-
             if (is_liquid && !is_blinded) {
                 // Fetch the blinding key from the confidential address
                 std::string blinding_key;
@@ -525,6 +618,46 @@ namespace sdk {
         return std::string();
     }
 
+    std::string validate_tx_addressee(session_impl& session, nlohmann::json& addressee)
+    {
+        std::string error = check_tx_addressee_signer(session, addressee);
+        if (error.empty()) {
+            error = parse_tx_addressee(session.get_network_parameters(), addressee);
+        }
+        if (error.empty()) {
+            error = convert_tx_addressee_amount(session, addressee);
+        }
+        return error;
+    }
+
+    std::vector<std::string> validate_tx_addressees(session_impl& session, nlohmann::json& addressees)
+    {
+        GDK_RUNTIME_ASSERT_MSG(addressees.is_array() || addressees.is_null(), "addressees must be an array");
+        const size_t num_addressees = addressees.size();
+        std::vector<std::string> errors(num_addressees);
+        for (size_t i = 0; i < num_addressees; ++i) {
+            errors[i] = check_tx_addressee_signer(session, addressees[i]);
+        }
+
+        // Parsing addresses and URIs is the bulk of the work and does not
+        // touch the session, so is done in parallel for large batches
+        const auto& net_params = session.get_network_parameters();
+        parallel_for_chunks(num_addressees, MIN_ADDRESSEES_PER_THREAD, MAX_ADDRESSEE_THREADS, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                if (errors[i].empty()) {
+                    errors[i] = parse_tx_addressee(net_params, addressees[i]);
+                }
+            }
+        });
+
+        for (size_t i = 0; i < num_addressees; ++i) {
+            if (errors[i].empty()) {
+                errors[i] = convert_tx_addressee_amount(session, addressees[i]);
+            }
+        }
+        return errors;
+    }
+
     static amount add_tx_output(
         const network_parameters& net_params, nlohmann::json& result, wally_tx_ptr& tx, const nlohmann::json& output)
     {
@@ -819,5 +952,24 @@ namespace sdk {
         }
     }
 
+    std::string get_transactions_cursor(const nlohmann::json& tx_details)
+    {
+        // Cached txs are keyed by their timestamp, which is unique per subaccount
+        return std::to_string(tx_details.at("created_at_ts").get<uint64_t>());
+    }
+
+    std::optional<uint64_t> parse_transactions_cursor(const std::string& cursor)
+    {
+        if (cursor.empty() || !std::all_of(cursor.begin(), cursor.end(), [](int c) { return std::isdigit(c) != 0; })) {
+            return std::nullopt;
+        }
+        errno = 0;
+        const uint64_t timestamp = std::strtoull(cursor.c_str(), nullptr, 10);
+        if (errno || !timestamp) {
+            return std::nullopt;
+        }
+        return timestamp;
+    }
+
 } // namespace sdk
 } // namespace ga
@@ -4,10 +4,13 @@
 
 #include <array>
 #include <memory>
+#include <optional>
 #include <set>
+#include <string_view>
 #include <utility>
 
 #include "amount.hpp"
+#include "coin_selection.hpp"
 
 namespace ga {
 namespace sdk {
@@ -37,6 +40,21 @@ namespace sdk {
 
     const uint32_t NO_CHANGE_INDEX = 0xffffffff;
 
+    // A compact set of UTXOs used while building a transaction. Holds the
+    // values needed for coin selection in a flat array alongside references
+    // to each UTXOs JSON, which is only copied when returned to the caller.
+    struct utxo_set {
+        void reserve(size_t n);
+        void add(nlohmann::json& utxo);
+        void append(const utxo_set& other);
+        size_t size() const { return utxos.size(); }
+        bool empty() const { return utxos.empty(); }
+        nlohmann::json to_json() const;
+
+        std::vector<coin_selection_utxo> coins; // Value and input weight of each UTXO
+        std::vector<nlohmann::json*> utxos; // The (non-owned) JSON of each UTXO
+    };
+
     bool is_segwit_address_type(const nlohmann::json& utxo);
 
     std::string get_address_from_public_key(
@@ -65,22 +83,49 @@ namespace sdk {
 
     std::vector<unsigned char> witness_script(byte_span_t script, uint32_t witness_ver);
 
-    // Compute the fee for a tx
-    amount get_tx_fee(
-        const network_parameters& net_params, const wally_tx_ptr& tx, amount min_fee_rate, amount fee_rate);
+    // Tracks the weight of a tx under construction. Inputs must only be
+    // appended while the tracker is in use; their sizes are accumulated
+    // once, so repeated fee estimates only re-measure the outputs.
+    class tx_weight_tracker {
+    public:
+        size_t get_weight(const network_parameters& net_params, const wally_tx_ptr& tx);
+
+    private:
+        size_t m_num_inputs = 0; // Number of inputs accounted for
+        size_t m_inputs_size = 0; // Non-witness size of accounted inputs
+        size_t m_witness_size = 0; // Witness size of accounted inputs
+        bool m_has_witness = false; // Whether any accounted input has a witness
+    };
+
+    // Compute the fee for a tx. If tracker is given, it is used to avoid
+    // re-measuring inputs that have not changed since the last call.
+    amount get_tx_fee(const network_parameters& net_params, const wally_tx_ptr& tx, amount min_fee_rate,
+        amount fee_rate, tx_weight_tracker* tracker = nullptr);
 
     // Get scriptpubkey from address (address is expected to be valid)
     std::vector<unsigned char> scriptpubkey_from_address(
         const network_parameters& net_params, const std::string& address, bool allow_unconfidential);
 
     // Set the error in a transaction, if it hasn't been set already
-    void set_tx_error(nlohmann::json& result, const std::string& error, bool overwrite = false);
+    void set_tx_error(nlohmann::json& result, std::string_view error, bool overwrite = false);
 
     void set_tx_output_commitment(
         wally_tx_ptr& tx, uint32_t index, const std::string& asset_id, amount::value_type satoshi);
 
+    // Parse and validate the address, BIP21 URI and asset of an addressee,
+    // setting its "scriptpubkey" and any "blinding_key". Does not use the
+    // session, so may be called concurrently for different addressees.
+    // Returns an error, or an empty string if the addressee is valid.
+    std::string parse_tx_addressee(const network_parameters& net_params, nlohmann::json& addressee);
+
+    // Validate an addressee, converting its amount to satoshi.
+    // Returns an error, or an empty string if the addressee is valid.
     std::string validate_tx_addressee(session_impl& session, nlohmann::json& addressee);
 
+    // As validate_tx_addressee, for an array of addressees, parsing them
+    // in parallel. Returns the error for each addressee.
+    std::vector<std::string> validate_tx_addressees(session_impl& session, nlohmann::json& addressees);
+
     // Add an output from a JSON addressee
     amount add_tx_addressee_output(
         session_impl& session, nlohmann::json& result, wally_tx_ptr& tx, nlohmann::json& addressee);
@@ -113,6 +158,12 @@ namespace sdk {
 
     // Set the locktime on tx to avoid fee sniping
     void set_anti_snipe_locktime(const wally_tx_ptr& tx, uint32_t current_block_height);
+
+    // Return the cursor to fetch the transactions following tx_details
+    std::string get_transactions_cursor(const nlohmann::json& tx_details);
+
+    // Return the timestamp encoded in a transactions cursor, or nullopt if invalid
+    std::optional<uint64_t> parse_transactions_cursor(const std::string& cursor);
 } // namespace sdk
 } // namespace ga
 
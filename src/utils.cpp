@@ -10,6 +10,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <functional>
@@ -174,8 +175,44 @@ namespace sdk {
             }
         }
 
+        // Session methods returning large results, which cross the FFI
+        // boundary as CBOR rather than as JSON strings to avoid the cost of
+        // formatting, copying and re-parsing text on every call.
+        static const std::array<const char*, 6> RUST_CBOR_METHODS = { "get_transactions", "get_unspent_outputs",
+            "get_previous_addresses", "get_transaction_details", "get_scriptpubkey_data", "get_address_data" };
+
+        static bool is_rust_cbor_method(const std::string& method)
+        {
+            return std::find(RUST_CBOR_METHODS.begin(), RUST_CBOR_METHODS.end(), method) != RUST_CBOR_METHODS.end();
+        }
+
+        static nlohmann::json rust_call_cbor_impl(const std::string& method, const nlohmann::json& input, void* session)
+        {
+            const auto input_cbor = nlohmann::json::to_cbor(input);
+            unsigned char* output = nullptr;
+            size_t output_len = 0;
+            const int ret = GDKRUST_call_session_cbor(
+                session, method.c_str(), input_cbor.data(), input_cbor.size(), &output, &output_len);
+            // output was set by calling `Box::into_raw` on a byte slice;
+            // destroy it with GDKRUST_destroy_buffer even if decoding throws.
+            const auto _{ gsl::finally([output, output_len] {
+                if (output) {
+                    GDKRUST_destroy_buffer(output, output_len);
+                }
+            }) };
+            nlohmann::json cppjson = nlohmann::json();
+            if (output) {
+                cppjson = nlohmann::json::from_cbor(output, output + output_len);
+            }
+            check_rust_return_code(ret, cppjson);
+            return cppjson;
+        }
+
         static nlohmann::json rust_call_impl(const std::string& method, const nlohmann::json& input, void* session)
         {
+            if (session && is_rust_cbor_method(method)) {
+                return rust_call_cbor_impl(method, input, session);
+            }
             char* output = nullptr;
             int ret;
             if (session) {
@@ -272,6 +309,20 @@ namespace sdk {
         }
     }
 
+    std::vector<uint32_t> spv_verify_txs(const nlohmann::json& details)
+    {
+        const size_t num_txs = details.at("txs").size();
+        try {
+            std::vector<uint32_t> spv_statuses = rust_call("spv_verify_txs", details);
+            GDK_RUNTIME_ASSERT(spv_statuses.size() == num_txs);
+            GDK_LOG_SEV(log_level::debug) << "spv_verify_txs: verified " << num_txs << " txs";
+            return spv_statuses;
+        } catch (const std::exception& e) {
+            GDK_LOG_SEV(log_level::warning) << "spv_verify_txs exception:" << e.what();
+            return std::vector<uint32_t>(num_txs, SPV_STATUS_DISABLED);
+        }
+    }
+
     std::string spv_get_status_string(uint32_t spv_status)
     {
         GDK_RUNTIME_ASSERT_MSG(spv_status < SPV_STATUS_NAMES.size(), "Unknown SPV status");
@@ -625,8 +676,71 @@ namespace sdk {
         }
     }
 
-    std::vector<unsigned char> compress(byte_span_t prefix, byte_span_t bytes)
+    namespace {
+        // The smallest valid zlib stream, holding no data
+        constexpr size_t MIN_COMPRESSED_SIZE = 11;
+        // Decompressed data is produced this many bytes at a time when streaming
+        constexpr size_t INFLATE_CHUNK_SIZE = 16384;
+
+        static uint32_t read_length32(byte_span_t bytes)
+        {
+            const size_t bytes_len = bytes.size();
+            GDK_RUNTIME_ASSERT(bytes_len >= sizeof(uint32_t) + MIN_COMPRESSED_SIZE);
+            return (uint32_t)bytes[0] << 0 | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16
+                | (uint32_t)bytes[3] << 24;
+        }
+
+        // A read-only stream buffer that decompresses zlib data on demand
+        class inflate_streambuf final : public std::streambuf {
+        public:
+            explicit inflate_streambuf(byte_span_t compressed)
+                : m_buffer(INFLATE_CHUNK_SIZE)
+            {
+                m_stream.next_in = const_cast<Bytef*>(compressed.data());
+                m_stream.avail_in = compressed.size();
+                GDK_RUNTIME_ASSERT(inflateInit(&m_stream) == Z_OK);
+            }
+
+            ~inflate_streambuf() override
+            {
+                inflateEnd(&m_stream);
+                bzero_and_free(m_buffer);
+            }
+
+            inflate_streambuf(const inflate_streambuf&) = delete;
+            inflate_streambuf& operator=(const inflate_streambuf&) = delete;
+
+            // Whether the entire input was decompressed, producing total_len bytes
+            bool is_complete(size_t total_len) const
+            {
+                return m_finished && !m_stream.avail_in && m_stream.total_out == total_len;
+            }
+
+        protected:
+            int_type underflow() override
+            {
+                if (gptr() == egptr() && !m_finished) {
+                    m_stream.next_out = reinterpret_cast<Bytef*>(m_buffer.data());
+                    m_stream.avail_out = m_buffer.size();
+                    const int z_result = inflate(&m_stream, Z_NO_FLUSH);
+                    GDK_RUNTIME_ASSERT(z_result == Z_OK || z_result == Z_STREAM_END);
+                    m_finished = z_result == Z_STREAM_END;
+                    const size_t produced = m_buffer.size() - m_stream.avail_out;
+                    setg(m_buffer.data(), m_buffer.data(), m_buffer.data() + produced);
+                }
+                return gptr() == egptr() ? traits_type::eof() : traits_type::to_int_type(*gptr());
+            }
+
+        private:
+            z_stream m_stream{};
+            std::vector<char> m_buffer;
+            bool m_finished = false;
+        };
+    } // namespace
+
+    std::vector<unsigned char> compress(byte_span_t prefix, byte_span_t bytes, int level)
     {
+        GDK_RUNTIME_ASSERT(level >= Z_BEST_SPEED && level <= Z_BEST_COMPRESSION);
         const size_t prefix_len = prefix.size();
         const size_t bytes_len = bytes.size();
         uLongf compressed_len = compressBound(bytes_len);
@@ -637,8 +751,8 @@ namespace sdk {
         std::copy(prefix.begin(), prefix.end(), result.begin());
         write_length32(bytes_len, result.begin() + prefix_len);
         // Add the compressed data
-        int z_result = compress2(result.data() + prefix_len + sizeof(uint32_t), &compressed_len, bytes.data(),
-            bytes_len, Z_BEST_COMPRESSION);
+        int z_result
+            = compress2(result.data() + prefix_len + sizeof(uint32_t), &compressed_len, bytes.data(), bytes_len, level);
         if (z_result != Z_OK) {
             GDK_RUNTIME_ASSERT(false);
         }
@@ -649,12 +763,9 @@ namespace sdk {
 
     std::vector<unsigned char> decompress(byte_span_t bytes)
     {
-        constexpr size_t minimum_compressed_size = 11;
         const size_t bytes_len = bytes.size();
-        GDK_RUNTIME_ASSERT(bytes_len >= sizeof(uint32_t) + minimum_compressed_size);
         uLong compressed_len = bytes_len - sizeof(uint32_t);
-        uLongf decompressed_len
-            = (uint32_t)bytes[0] << 0 | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+        uLongf decompressed_len = read_length32(bytes);
 
         std::vector<unsigned char> result;
         result.resize(decompressed_len);
@@ -665,6 +776,17 @@ namespace sdk {
         return result;
     }
 
+    nlohmann::json decompress_msgpack(byte_span_t bytes)
+    {
+        const uint32_t decompressed_len = read_length32(bytes);
+        inflate_streambuf buf(bytes.subspan(sizeof(uint32_t)));
+        std::istream stream(&buf);
+        // Parsing is strict, so consumes the stream until its end
+        auto result = nlohmann::json::from_msgpack(stream);
+        GDK_RUNTIME_ASSERT(buf.is_complete(decompressed_len));
+        return result;
+    }
+
 #define OPENSSL_VERIFY(x) GDK_RUNTIME_ASSERT((x) == 1)
 
     namespace {
@@ -673,10 +795,12 @@ namespace sdk {
     } // namespace
     using evp_ctx_ptr = const std::unique_ptr<EVP_CIPHER_CTX, decltype(&::EVP_CIPHER_CTX_free)>;
 
-    size_t aes_gcm_encrypt_get_length(byte_span_t plaintext)
+    size_t aes_gcm_encrypt_get_length(byte_span_t plaintext) { return aes_gcm_encrypt_get_length(plaintext.size()); }
+
+    size_t aes_gcm_encrypt_get_length(size_t plaintext_len)
     {
-        GDK_RUNTIME_ASSERT(!plaintext.empty());
-        return AES_GCM_IV_SIZE + AES_GCM_TAG_SIZE + plaintext.size();
+        GDK_RUNTIME_ASSERT(plaintext_len != 0);
+        return AES_GCM_IV_SIZE + AES_GCM_TAG_SIZE + plaintext_len;
     }
 
     size_t aes_gcm_encrypt(byte_span_t key, byte_span_t plaintext, gsl::span<unsigned char> cyphertext)
@@ -863,3 +987,5 @@ extern "C" int GA_validate_mnemonic(const char* mnemonic, uint32_t* valid)
 }
 
 void GA_destroy_string(char* str) { free(str); }
+
+void GA_destroy_bytes(unsigned char* bytes) { free(bytes); }
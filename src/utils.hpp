@@ -123,12 +123,17 @@ namespace sdk {
     size_t aes_gcm_decrypt_get_length(byte_span_t cyphertext);
     size_t aes_gcm_decrypt(byte_span_t key, byte_span_t cyphertext, gsl::span<unsigned char> plaintext);
     size_t aes_gcm_encrypt_get_length(byte_span_t plaintext);
+    size_t aes_gcm_encrypt_get_length(size_t plaintext_len);
     size_t aes_gcm_encrypt(byte_span_t key, byte_span_t plaintext, gsl::span<unsigned char> cyphertext);
 
-    // Return prefix followed by compressed `bytes`
-    std::vector<unsigned char> compress(byte_span_t prefix, byte_span_t bytes);
+    // Return prefix followed by compressed `bytes`, compressed at the given
+    // zlib level from 1 (fastest) to 9 (smallest)
+    std::vector<unsigned char> compress(byte_span_t prefix, byte_span_t bytes, int level = 9);
     // Return decompressed `bytes` (prefix is assumed removed by the caller)
     std::vector<unsigned char> decompress(byte_span_t bytes);
+    // Return the msgpack document in compressed `bytes`, decompressing it as
+    // it is parsed rather than into a separate buffer first
+    nlohmann::json decompress_msgpack(byte_span_t bytes);
 
     std::string get_wallet_hash_id(const std::string& chain_code_hex, const std::string& public_key_hex,
         bool is_mainnet, const std::string& network);
@@ -146,6 +151,10 @@ namespace sdk {
     // Return the SPV verification status of a tx
     uint32_t spv_verify_tx(const nlohmann::json& details);
 
+    // Return the SPV verification status of each tx in details["txs"],
+    // an array of {"txid", "height"} elements
+    std::vector<uint32_t> spv_verify_txs(const nlohmann::json& details);
+
     // Convert an SPV status into one of:
     // "in_progress", "verified", "not_verified", "disabled", "not_longest", "unconfirmed"
     std::string spv_get_status_string(uint32_t spv_status);
@@ -41,9 +41,7 @@ namespace sdk {
     {
         nlohmann::json::array_t errors;
 
-        for (auto& addressee : m_details["addressees"]) {
-            nlohmann::json result;
-            std::string error = validate_tx_addressee(*m_session, addressee);
+        for (auto& error : validate_tx_addressees(*m_session, m_details["addressees"])) {
             if (!error.empty()) {
                 errors.emplace_back(std::move(error));
             }
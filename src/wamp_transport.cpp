@@ -18,6 +18,7 @@
 #include "http_client.hpp"
 #include "logging.hpp"
 #include "network_parameters.hpp"
+#include "trace.hpp"
 #include "utils.hpp"
 #include "version.h"
 #include "wamp_transport.hpp"
@@ -93,7 +94,7 @@ namespace sdk {
         }
 
         bool static_test(wlog::level l) const { return (m_level & l) != 0; }
-        bool dynamic_test(wlog::level l) { return (m_level & l) != 0; }
+        bool dynamic_test(wlog::level l) { return (m_level & l) != 0 && is_log_enabled(get_severity_level(l)); }
 
         wlog::level m_level;
     };
@@ -250,10 +251,7 @@ namespace sdk {
             if (!result.number_of_arguments()) {
                 return nlohmann::json();
             }
-            const auto obj = result.template argument<msgpack::object>(0);
-            msgpack::sbuffer sbuf;
-            msgpack::pack(sbuf, obj);
-            return nlohmann::json::from_msgpack(sbuf.data(), sbuf.data() + sbuf.size());
+            return wamp_cast_json(result.template argument<msgpack::object>(0));
         }
 
         template <typename T>
@@ -306,6 +304,55 @@ namespace sdk {
         std::chrono::seconds m_waiting;
     };
 
+    nlohmann::json wamp_cast_json(const msgpack::object& obj)
+    {
+        // Build the json directly from the unpacked object, instead of
+        // re-packing it and parsing the packed bytes. Values are converted
+        // as nlohmann::json::from_msgpack would convert them
+        switch (obj.type) {
+        case msgpack::type::NIL:
+            return nullptr;
+        case msgpack::type::BOOLEAN:
+            return obj.via.boolean;
+        case msgpack::type::POSITIVE_INTEGER:
+            return obj.via.u64;
+        case msgpack::type::NEGATIVE_INTEGER:
+            return obj.via.i64;
+        case msgpack::type::FLOAT32:
+        case msgpack::type::FLOAT64:
+            return obj.via.f64;
+        case msgpack::type::STR:
+            return std::string(obj.via.str.ptr, obj.via.str.size);
+        case msgpack::type::BIN: {
+            const auto p = reinterpret_cast<const uint8_t*>(obj.via.bin.ptr);
+            return nlohmann::json::binary(std::vector<uint8_t>(p, p + obj.via.bin.size));
+        }
+        case msgpack::type::EXT: {
+            const auto p = reinterpret_cast<const uint8_t*>(obj.via.ext.data());
+            const auto subtype = static_cast<uint8_t>(obj.via.ext.type());
+            return nlohmann::json::binary(std::vector<uint8_t>(p, p + obj.via.ext.size), subtype);
+        }
+        case msgpack::type::ARRAY: {
+            nlohmann::json::array_t array;
+            array.reserve(obj.via.array.size);
+            for (const auto& item : gsl::make_span(obj.via.array.ptr, obj.via.array.size)) {
+                array.emplace_back(wamp_cast_json(item));
+            }
+            return array;
+        }
+        case msgpack::type::MAP: {
+            nlohmann::json::object_t object;
+            for (const auto& kv : gsl::make_span(obj.via.map.ptr, obj.via.map.size)) {
+                GDK_RUNTIME_ASSERT_MSG(kv.key.type == msgpack::type::STR, "non-string msgpack map key");
+                object[std::string(kv.key.via.str.ptr, kv.key.via.str.size)] = wamp_cast_json(kv.val);
+            }
+            return object;
+        }
+        }
+        GDK_RUNTIME_ASSERT_MSG(false, "unknown msgpack type");
+        __builtin_unreachable();
+    }
+
     nlohmann::json wamp_cast_json(const autobahn::wamp_event& event) { return wamp_cast_json_impl(*event); }
 
     nlohmann::json wamp_cast_json(const autobahn::wamp_call_result& result) { return wamp_cast_json_impl(result); }
@@ -313,7 +360,6 @@ namespace sdk {
     wamp_transport::wamp_transport(const network_parameters& net_params, wamp_transport::notify_fn_t fn)
         : m_net_params(net_params)
         , m_io()
-        , m_work_guard(asio::make_work_guard(m_io))
         , m_server(m_net_params.get_connection_string())
         , m_wamp_host_name(websocketpp::uri(m_net_params.gait_wamp_url()).get_host())
         , m_wamp_call_prefix("com.greenaddress.")
@@ -328,39 +374,50 @@ namespace sdk {
 
         m_wamp_call_options.set_timeout(std::chrono::seconds(WAMP_CALL_TIMEOUT_SECS));
 
-        m_run_thread = std::thread([this] { m_io.run(); });
         m_reconnect_thread = std::thread([this] { reconnect_handler(); });
 
         if (!m_net_params.is_tls_connection()) {
             m_client = std::make_unique<client>();
             m_client->set_pong_timeout_handler(std::bind(&wamp_transport::heartbeat_timeout_cb, this, _1, _2));
-            m_client->init_asio(&m_io);
+            m_client->init_asio(&m_io.get_io_context());
             return;
         }
 
         m_client_tls = std::make_unique<client_tls>();
         m_client_tls->set_pong_timeout_handler(std::bind(&wamp_transport::heartbeat_timeout_cb, this, _1, _2));
         m_client_tls->set_tls_init_handler([this](const websocketpp::connection_hdl) {
-            return tls_init(m_wamp_host_name, m_net_params.gait_wamp_cert_roots(), m_net_params.gait_wamp_cert_pins(),
-                m_net_params.cert_expiry_threshold());
+            return get_shared_tls_context(m_wamp_host_name, m_net_params.gait_wamp_cert_roots(),
+                m_net_params.gait_wamp_cert_pins(), m_net_params.cert_expiry_threshold());
         });
-        m_client_tls->init_asio(&m_io);
+        m_client_tls->init_asio(&m_io.get_io_context());
     }
 
     wamp_transport::~wamp_transport()
     {
         no_std_exception_escape([this] { change_state_to(state_t::exited, std::string(), false); }, "wamp dtor(1)");
         no_std_exception_escape([this] { m_reconnect_thread.join(); }, "wamp dtor(2)");
-        no_std_exception_escape([this] { m_work_guard.reset(); }, "wamp dtor(2)");
-        no_std_exception_escape([this] { m_run_thread.join(); }, "wamp dtor(3)");
+        no_std_exception_escape([this] { m_io.shutdown(); }, "wamp dtor(3)");
     }
 
-    void wamp_transport::connect(const std::string& proxy) { change_state_to(state_t::connected, proxy, true); }
+    void wamp_transport::connect(const std::string& proxy)
+    {
+        if (!is_capture_replaying()) {
+            change_state_to(state_t::connected, proxy, true);
+        }
+    }
 
-    void wamp_transport::disconnect() { change_state_to(state_t::disconnected, std::string(), true); }
+    void wamp_transport::disconnect()
+    {
+        if (!is_capture_replaying()) {
+            change_state_to(state_t::disconnected, std::string(), true);
+        }
+    }
 
     void wamp_transport::reconnect()
     {
+        if (is_capture_replaying()) {
+            return; // Never connected
+        }
         // Only called by the top level session class in response to
         // exceptions from wamp_call. As such, just increment the
         // failure count and let the reconnect thread reconnect us.
@@ -374,7 +431,7 @@ namespace sdk {
     void wamp_transport::reconnect_hint(const nlohmann::json& hint, const std::string& proxy)
     {
         const auto hint_p = hint.find("hint");
-        if (hint_p != hint.end()) {
+        if (hint_p != hint.end() && !is_capture_replaying()) {
             change_state_to(*hint_p == "connect" ? state_t::connected : state_t::disconnected, proxy, true);
         }
     }
@@ -451,6 +508,32 @@ namespace sdk {
         }
     }
 
+    void wamp_transport::hold_calls(std::thread::id owner)
+    {
+        locker_t locker(m_mutex);
+        m_held_calls_owner = owner;
+    }
+
+    void wamp_transport::release_calls()
+    {
+        {
+            locker_t locker(m_mutex);
+            m_held_calls_owner.reset();
+        }
+        m_held_calls_condition.notify_all();
+    }
+
+    void wamp_transport::wait_for_held_calls()
+    {
+        const auto this_id = std::this_thread::get_id();
+        locker_t locker(m_mutex);
+        if (m_held_calls_owner.has_value() && *m_held_calls_owner != this_id
+            && !m_io.get_io_context().get_executor().running_in_this_thread()) {
+            GDK_LOG_SEV(log_level::debug) << "waiting for held calls to be released";
+            m_held_calls_condition.wait(locker, [this] { return !m_held_calls_owner.has_value(); });
+        }
+    }
+
     std::pair<wamp_transport::session_ptr, autobahn::wamp_websocket_transport*>
     wamp_transport::get_session_and_transport()
     {
@@ -458,9 +541,14 @@ namespace sdk {
         return std::make_pair(m_session, m_transport.get());
     }
 
-    autobahn::wamp_call_result wamp_transport::wamp_process_call(
-        autobahn::wamp_websocket_transport* t, boost::future<autobahn::wamp_call_result>& fn)
+    autobahn::wamp_call_result wamp_transport::wamp_process_call(autobahn::wamp_websocket_transport* t,
+        boost::future<autobahn::wamp_call_result>& fn, const std::string& method_name,
+        call_metrics::clock::time_point start)
     {
+        GDK_TRACE_SPAN(method_name, start);
+        bool is_error = true;
+        const auto record = gsl::finally(
+            [&] { m_metrics.record(method_name, call_metrics::clock::now() - start, is_error); });
         for (;;) {
             const auto status = fn.wait_for(boost::chrono::seconds(1));
             if (status == boost::future_status::ready) {
@@ -476,6 +564,7 @@ namespace sdk {
         }
         try {
             auto ret = fn.get();
+            is_error = false;
             locker_t locker(m_mutex);
             m_last_ping_ts = std::chrono::system_clock::now();
             locker.unlock();
@@ -486,11 +575,38 @@ namespace sdk {
         }
     }
 
+    void wamp_transport::record_call(
+        const std::string& method_name, const std::string& key, const autobahn::wamp_call_result& result)
+    {
+        msgpack::sbuffer buffer;
+        msgpack::packer<msgpack::sbuffer> packer(buffer);
+        const size_t num_arguments = result.number_of_arguments();
+        packer.pack_array(num_arguments);
+        for (size_t i = 0; i < num_arguments; ++i) {
+            packer.pack(result.argument<msgpack::object>(i));
+        }
+        capture_record("wamp", method_name, key, std::string(buffer.data(), buffer.size()));
+    }
+
+    std::future<autobahn::wamp_call_result> wamp_transport::replay_call(const std::string& method_name, std::string key)
+    {
+        const auto start = call_metrics::clock::now();
+        return std::async(std::launch::deferred, [this, method_name, key = std::move(key), start] {
+            GDK_TRACE_SPAN(method_name, start);
+            const auto packed = capture_replay("wamp", method_name, key, start);
+            auto handle = msgpack::unpack(packed.data(), packed.size());
+            autobahn::wamp_call_result result(std::move(*handle.zone()));
+            result.set_arguments(handle.get());
+            m_metrics.record(method_name, call_metrics::clock::now() - start, false);
+            return result;
+        });
+    }
+
     void wamp_transport::reconnect_handler()
     {
         const bool is_tls = m_net_params.is_tls_connection();
         const bool is_debug = gdk_config()["log_level"] == "debug";
-        const auto& executor = m_io.get_executor();
+        const auto& executor = m_io.get_io_context().get_executor();
 
         // The last failure number that we handled
         auto last_handled_failure_count = m_failure_count.load();
@@ -578,8 +694,11 @@ namespace sdk {
                 } else {
                     t = std::make_shared<transport>(*m_client, m_server, proxy, is_debug);
                 }
-                s = std::make_shared<autobahn::wamp_session>(m_io, is_debug);
+                s = std::make_shared<autobahn::wamp_session>(m_io.get_io_context(), is_debug);
                 t->attach(std::static_pointer_cast<autobahn::wamp_transport_handler>(s));
+                // Their handlers reference our client, which must outlive them
+                m_io.track(t);
+                m_io.track(s);
                 bool failed = false;
                 if (no_std_exception_escape(
                         [&t] { future_wait(t->connect(), "transport connect"); }, "transport connect")) {
@@ -645,6 +764,15 @@ namespace sdk {
 
     void wamp_transport::subscribe(const std::string& topic, wamp_transport::subscribe_fn_t fn, bool is_initial)
     {
+        subscribe({ { topic, std::move(fn) } }, is_initial);
+    }
+
+    void wamp_transport::subscribe(
+        const std::vector<std::pair<std::string, wamp_transport::subscribe_fn_t>>& topics, bool is_initial)
+    {
+        if (is_capture_replaying()) {
+            return; // Notifications are not captured
+        }
         decltype(m_subscriptions) subscriptions;
 
         locker_t locker(m_mutex);
@@ -654,17 +782,28 @@ namespace sdk {
         }
         decltype(m_session) s{ m_session };
         GDK_RUNTIME_ASSERT(s.get());
-        autobahn::wamp_subscription sub;
+        std::vector<autobahn::wamp_subscription> subs;
         {
             // TODO: Set m_last_ping_ts whenever we receive a subscription
             unique_unlock unlocker(locker);
+            // Send all subscription requests before waiting for any of them
             const autobahn::wamp_subscribe_options options("exact");
-            sub = s->subscribe(
-                       topic, [fn](const autobahn::wamp_event& e) { fn(wamp_cast_json(e)); }, options)
-                      .get();
+            std::vector<boost::future<autobahn::wamp_subscription>> pending;
+            pending.reserve(topics.size());
+            for (const auto& topic : topics) {
+                auto fn = topic.second;
+                pending.emplace_back(s->subscribe(
+                    topic.first, [fn](const autobahn::wamp_event& e) { fn(wamp_cast_json(e)); }, options));
+            }
+            subs.reserve(pending.size());
+            for (auto& f : pending) {
+                subs.emplace_back(f.get());
+            }
+        }
+        for (size_t i = 0; i < subs.size(); ++i) {
+            GDK_LOG_SEV(log_level::debug) << "subscribed to " << topics[i].first << ":" << subs[i].id();
+            m_subscriptions.emplace_back(subs[i]);
         }
-        GDK_LOG_SEV(log_level::debug) << "subscribed to " << topic << ":" << sub.id();
-        m_subscriptions.emplace_back(sub);
     }
 
 } // namespace sdk
@@ -2,13 +2,18 @@
 #define GDK_WAMP_TRANSPORT_HPP
 #pragma once
 
+#include <future>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "autobahn_wrapper.hpp"
+#include "call_metrics.hpp"
+#include "io_context_pool.hpp"
 #include "logging.hpp"
 #include "threading.hpp"
+#include "traffic_capture.hpp"
 
 namespace ga {
 namespace sdk {
@@ -16,6 +21,7 @@ namespace sdk {
     struct websocketpp_gdk_config;
     struct websocketpp_gdk_tls_config;
 
+    nlohmann::json wamp_cast_json(const msgpack::object& obj);
     nlohmann::json wamp_cast_json(const autobahn::wamp_event& event);
     nlohmann::json wamp_cast_json(const autobahn::wamp_call_result& result);
 
@@ -67,17 +73,47 @@ namespace sdk {
         // subscription after reconnecting
         void subscribe(const std::string& topic, subscribe_fn_t fn, bool is_initial = false);
 
+        // Subscribe to several topics, sending all subscription requests
+        // before waiting for their results
+        void subscribe(const std::vector<std::pair<std::string, subscribe_fn_t>>& topics, bool is_initial = false);
+
         // Make a background WAMP call and return its result to the current thread.
         // The session mutex must not be held when calling this function.
         template <typename... Args> autobahn::wamp_call_result call(const std::string& method_name, Args&&... args)
         {
+            return call_async(method_name, std::forward<Args>(args)...).get();
+        }
+
+        // Make a background WAMP call, returning a future for its result.
+        // The call is sent immediately, so several calls can be in flight on
+        // the connection at once; the result is processed when the future is
+        // waited on. The session mutex must not be held when waiting.
+        template <typename... Args>
+        std::future<autobahn::wamp_call_result> call_async(const std::string& method_name, Args&&... args)
+        {
+            if (is_capture_replaying()) {
+                return replay_call(method_name, get_capture_key(args...));
+            }
+            std::string capture_key;
+            if (is_capture_recording()) {
+                capture_key = get_capture_key(args...);
+            }
             const std::string method{ m_wamp_call_prefix + method_name };
+            wait_for_held_calls();
             auto st = get_session_and_transport();
             if (!st.first || !st.second) {
                 throw reconnect_error{};
             }
+            const auto start = call_metrics::clock::now();
             auto fn = st.first->call(method, std::make_tuple(std::forward<Args>(args)...), m_wamp_call_options);
-            return wamp_process_call(st.second, fn);
+            return std::async(std::launch::deferred,
+                [this, st, fn = std::move(fn), method_name, start, capture_key = std::move(capture_key)]() mutable {
+                    auto result = wamp_process_call(st.second, fn, method_name, start);
+                    if (!capture_key.empty()) {
+                        record_call(method_name, capture_key, result);
+                    }
+                    return result;
+                });
         }
 
         // Make a WAMP call on a currently locked session.
@@ -88,8 +124,27 @@ namespace sdk {
             return call(method_name, std::forward<Args>(args)...);
         }
 
+        // Make calls from threads other than owner and the asio executor
+        // thread wait until release_calls() is called. Used to hold calls
+        // until a background login has authenticated the connection.
+        // A default constructed owner holds calls from all threads, until
+        // the owner is set by a further call.
+        void hold_calls(std::thread::id owner);
+        void release_calls();
+
+        // Call counts and latencies of server calls, keyed by method name.
+        // Latency is measured from sending a call until its result is
+        // waited for and received.
+        const call_metrics& get_metrics() const { return m_metrics; }
+
         // Post a function to run on the asio executor thread
-        template <typename FN> void post(FN&& fn) { boost::asio::post(m_io.get_executor(), fn); }
+        template <typename FN> void post(FN&& fn) { m_io.post(std::forward<FN>(fn)); }
+
+        // Post a function to run on the asio executor thread after a delay
+        template <typename FN> void post_after(std::chrono::milliseconds delay, FN&& fn)
+        {
+            m_io.post_after(delay, std::forward<FN>(fn));
+        }
 
     private:
         using session_ptr = std::shared_ptr<autobahn::wamp_session>;
@@ -115,15 +170,27 @@ namespace sdk {
         // NOTE: this overload unlocks the passed in locker.
         void notify_failure(locker_t& locker, const std::string& reason, bool notify_condition = true);
 
+        void wait_for_held_calls();
         std::pair<session_ptr, autobahn::wamp_websocket_transport*> get_session_and_transport();
-        autobahn::wamp_call_result wamp_process_call(
-            autobahn::wamp_websocket_transport* t, boost::future<autobahn::wamp_call_result>& fn);
+        autobahn::wamp_call_result wamp_process_call(autobahn::wamp_websocket_transport* t,
+            boost::future<autobahn::wamp_call_result>& fn, const std::string& method_name,
+            call_metrics::clock::time_point start);
+
+        // Record and replay of calls when capturing traffic, see traffic_capture.hpp.
+        // Calls are keyed by their msgpack encoded arguments.
+        template <typename... Args> static std::string get_capture_key(const Args&... args)
+        {
+            msgpack::sbuffer buffer;
+            msgpack::pack(buffer, std::make_tuple(args...));
+            return std::string(buffer.data(), buffer.size());
+        }
+        void record_call(
+            const std::string& method_name, const std::string& key, const autobahn::wamp_call_result& result);
+        std::future<autobahn::wamp_call_result> replay_call(const std::string& method_name, std::string key);
 
         // These members are immutable after construction
         const network_parameters& m_net_params;
-        boost::asio::io_context m_io;
-        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_work_guard;
-        std::thread m_run_thread; // Runs the asio context
+        io_context_handle m_io; // Owned or shared with other sessions
         std::thread m_reconnect_thread; // Runs the reconnection logic
         const std::string m_server;
         const std::string m_wamp_host_name;
@@ -132,6 +199,7 @@ namespace sdk {
         notify_fn_t m_notify_fn;
         std::unique_ptr<client> m_client;
         std::unique_ptr<client_tls> m_client_tls;
+        call_metrics m_metrics;
 
         // This mutex protects the following members
         std::mutex m_mutex;
@@ -150,6 +218,9 @@ namespace sdk {
         std::shared_ptr<autobahn::wamp_websocket_transport> m_transport;
         session_ptr m_session;
         std::vector<autobahn::wamp_subscription> m_subscriptions;
+        // The thread allowed to make calls while calls are held, if held
+        std::optional<std::thread::id> m_held_calls_owner;
+        std::condition_variable m_held_calls_condition;
     };
 
 } // namespace sdk
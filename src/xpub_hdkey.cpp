@@ -1,6 +1,7 @@
 #include <cstring>
 
 #include "memory.hpp"
+#include "threading.hpp"
 #include "utils.hpp"
 #include "xpub_hdkey.hpp"
 
@@ -10,6 +11,14 @@ namespace sdk {
         static const uint32_t GAIT_GENERATION_PATH = harden(0x4741); // 'GA'
         static const unsigned char GAIT_GENERATION_NONCE[30] = { 'G', 'r', 'e', 'e', 'n', 'A', 'd', 'd', 'r', 'e', 's',
             's', '.', 'i', 't', ' ', 'H', 'D', ' ', 'w', 'a', 'l', 'l', 'e', 't', ' ', 'p', 'a', 't', 'h' };
+
+        // Maximum number of derived pubkeys to cache per collection of xpubs
+        static constexpr size_t DERIVED_PUBKEY_CACHE_SIZE = 8192;
+        // Branch value used in cache keys for Green (non-BIP44) derivation
+        static constexpr uint32_t NO_BRANCH = 0xffffffff;
+        // Minimum number of keys to derive per worker thread in derive_range
+        static constexpr size_t MIN_DERIVATIONS_PER_THREAD = 64;
+        static constexpr size_t MAX_DERIVATION_THREADS = 8;
     } // namespace
 
     xpub_hdkey::xpub_hdkey(bool is_main_net, const xpub_t& xpub, uint32_span_t path)
@@ -52,28 +61,185 @@ namespace sdk {
     }
 
     namespace detail {
+        derived_pubkey_cache::derived_pubkey_cache(size_t capacity)
+            : m_capacity(capacity)
+        {
+            GDK_RUNTIME_ASSERT(m_capacity != 0);
+        }
+
+        derived_pubkey_cache::derived_pubkey_cache(const derived_pubkey_cache& rhs)
+            : m_capacity(rhs.m_capacity)
+        {
+            *this = rhs;
+        }
+
+        derived_pubkey_cache& derived_pubkey_cache::operator=(const derived_pubkey_cache& rhs)
+        {
+            if (this != &rhs) {
+                // Copy the entries, then rebuild our index to point at them
+                std::scoped_lock locker(m_mutex, rhs.m_mutex);
+                m_capacity = rhs.m_capacity;
+                m_entries = rhs.m_entries;
+                m_index.clear();
+                for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+                    m_index.emplace(it->first, it);
+                }
+            }
+            return *this;
+        }
+
+        bool derived_pubkey_cache::get(const key_t& key, pub_key_t& pubkey)
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            const auto p = m_index.find(key);
+            if (p == m_index.end()) {
+                return false;
+            }
+            // Move the entry to the front as the most recently used
+            m_entries.splice(m_entries.begin(), m_entries, p->second);
+            pubkey = p->second->second;
+            return true;
+        }
+
+        void derived_pubkey_cache::insert(const key_t& key, const pub_key_t& pubkey)
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            insert_impl(key, pubkey);
+        }
+
+        size_t derived_pubkey_cache::get_memory_usage() const
+        {
+            // Each entry has a list node plus an index tree node
+            constexpr size_t NODE_OVERHEAD = 6 * sizeof(void*);
+            constexpr size_t ENTRY_SIZE = sizeof(entries_t::value_type) + sizeof(key_t) + sizeof(entries_t::iterator);
+            std::lock_guard<std::mutex> locker(m_mutex);
+            return m_entries.size() * (ENTRY_SIZE + NODE_OVERHEAD);
+        }
+
+        void derived_pubkey_cache::clear()
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_index.clear();
+            m_entries.clear();
+        }
+
+        void derived_pubkey_cache::insert_impl(const key_t& key, const pub_key_t& pubkey)
+        {
+            const auto p = m_index.find(key);
+            if (p != m_index.end()) {
+                m_entries.splice(m_entries.begin(), m_entries, p->second);
+                return; // Already present
+            }
+            m_entries.emplace_front(key, pubkey);
+            m_index.emplace(key, m_entries.begin());
+            if (m_entries.size() > m_capacity) {
+                // Evict the least recently used entry
+                m_index.erase(m_entries.back().first);
+                m_entries.pop_back();
+            }
+        }
+
         xpub_hdkeys_base::xpub_hdkeys_base(const network_parameters& net_params)
             : m_is_main_net(net_params.is_main_net())
             , m_is_liquid(net_params.is_liquid())
+            , m_cache(DERIVED_PUBKEY_CACHE_SIZE)
         {
         }
 
         xpub_hdkeys_base::xpub_hdkeys_base(const network_parameters& net_params, const xpub_t& xpub)
             : m_is_main_net(net_params.is_main_net())
             , m_xpub(xpub)
+            , m_cache(DERIVED_PUBKEY_CACHE_SIZE)
         {
         }
 
         pub_key_t xpub_hdkeys_base::derive(uint32_t subaccount, uint32_t pointer)
         {
-            std::array<uint32_t, 1> path{ { pointer } };
-            return get_subaccount(subaccount).derive(path);
+            return derive_impl(subaccount, NO_BRANCH, pointer);
         }
 
         pub_key_t xpub_hdkeys_base::derive(uint32_t subaccount, uint32_t pointer, bool is_internal)
         {
-            std::array<uint32_t, 2> path{ { is_internal ? 1u : 0u, pointer } };
-            return get_subaccount(subaccount).derive(path);
+            return derive_impl(subaccount, is_internal ? 1u : 0u, pointer);
+        }
+
+        std::vector<pub_key_t> xpub_hdkeys_base::derive_range(
+            uint32_t subaccount, uint32_t first_pointer, uint32_t count)
+        {
+            return derive_range_impl(subaccount, NO_BRANCH, first_pointer, count);
+        }
+
+        std::vector<pub_key_t> xpub_hdkeys_base::derive_range(
+            uint32_t subaccount, uint32_t first_pointer, uint32_t count, bool is_internal)
+        {
+            return derive_range_impl(subaccount, is_internal ? 1u : 0u, first_pointer, count);
+        }
+
+        size_t xpub_hdkeys_base::get_memory_usage() const
+        {
+            constexpr size_t NODE_OVERHEAD = 4 * sizeof(void*);
+            constexpr size_t SUBACCOUNT_SIZE = sizeof(uint32_t) + sizeof(xpub_hdkey) + NODE_OVERHEAD;
+            return m_subaccounts.size() * SUBACCOUNT_SIZE + m_cache.get_memory_usage();
+        }
+
+        void xpub_hdkeys_base::trim() { m_cache.clear(); }
+
+        pub_key_t xpub_hdkeys_base::derive_impl(uint32_t subaccount, uint32_t branch, uint32_t pointer)
+        {
+            const derived_pubkey_cache::key_t key{ subaccount, branch, pointer };
+            pub_key_t ret;
+            if (!m_cache.get(key, ret)) {
+                if (branch == NO_BRANCH) {
+                    std::array<uint32_t, 1> path{ { pointer } };
+                    ret = get_subaccount(subaccount).derive(path);
+                } else {
+                    std::array<uint32_t, 2> path{ { branch, pointer } };
+                    ret = get_subaccount(subaccount).derive(path);
+                }
+                m_cache.insert(key, ret);
+            }
+            return ret;
+        }
+
+        std::vector<pub_key_t> xpub_hdkeys_base::derive_range_impl(
+            uint32_t subaccount, uint32_t branch, uint32_t first_pointer, uint32_t count)
+        {
+            GDK_RUNTIME_ASSERT(first_pointer + count >= first_pointer); // Overflow
+            std::vector<pub_key_t> ret(count);
+            std::vector<uint32_t> missing; // Indices of keys not in the cache
+            for (uint32_t i = 0; i < count; ++i) {
+                const derived_pubkey_cache::key_t key{ subaccount, branch, first_pointer + i };
+                if (!m_cache.get(key, ret[i])) {
+                    missing.push_back(i);
+                }
+            }
+            if (missing.empty()) {
+                return ret;
+            }
+
+            const xpub_hdkey parent = get_subaccount(subaccount);
+            // Each worker derives from its own copy of the parent key into
+            // distinct elements of ret, so no further locking is required
+            auto&& derive_fn = [&](size_t begin, size_t end) {
+                xpub_hdkey key = parent;
+                for (size_t i = begin; i < end; ++i) {
+                    const uint32_t pointer = first_pointer + missing[i];
+                    if (branch == NO_BRANCH) {
+                        std::array<uint32_t, 1> path{ { pointer } };
+                        ret[missing[i]] = key.derive(path);
+                    } else {
+                        std::array<uint32_t, 2> path{ { branch, pointer } };
+                        ret[missing[i]] = key.derive(path);
+                    }
+                }
+            };
+
+            parallel_for_chunks(missing.size(), MIN_DERIVATIONS_PER_THREAD, MAX_DERIVATION_THREADS, derive_fn);
+
+            for (const auto i : missing) {
+                m_cache.insert({ subaccount, branch, first_pointer + i }, ret[i]);
+            }
+            return ret;
         }
     } // namespace detail
 
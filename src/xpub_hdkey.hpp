@@ -2,7 +2,10 @@
 #define GDK_XPUB_HDKEY_HPP
 #pragma once
 
+#include <list>
 #include <map>
+#include <mutex>
+#include <tuple>
 
 #include "ga_wally.hpp"
 #include "network_parameters.hpp"
@@ -36,6 +39,38 @@ namespace sdk {
 
     namespace detail {
 
+        //
+        // A bounded, least recently used cache of derived pubkeys, keyed by
+        // (subaccount, branch, pointer). Thread safe.
+        //
+        class derived_pubkey_cache final {
+        public:
+            using key_t = std::tuple<uint32_t, uint32_t, uint32_t>;
+
+            explicit derived_pubkey_cache(size_t capacity);
+
+            derived_pubkey_cache(const derived_pubkey_cache& rhs);
+            derived_pubkey_cache& operator=(const derived_pubkey_cache& rhs);
+            ~derived_pubkey_cache() = default;
+
+            bool get(const key_t& key, pub_key_t& pubkey);
+            void insert(const key_t& key, const pub_key_t& pubkey);
+
+            // Return the approximate memory used by the cached pubkeys
+            size_t get_memory_usage() const;
+            // Remove all cached pubkeys
+            void clear();
+
+        private:
+            void insert_impl(const key_t& key, const pub_key_t& pubkey);
+
+            using entries_t = std::list<std::pair<key_t, pub_key_t>>;
+            mutable std::mutex m_mutex;
+            size_t m_capacity;
+            entries_t m_entries; // Most recently used first
+            std::map<key_t, entries_t::iterator> m_index;
+        };
+
         //
         // Base class for collections of xpubs
         //
@@ -55,13 +90,31 @@ namespace sdk {
             // Derive a BIP44 pubkey for a subaccount and pointer, internal or not
             pub_key_t derive(uint32_t subaccount, uint32_t pointer, bool is_internal);
 
+            // Derive Green pubkeys for count consecutive pointers from first_pointer
+            std::vector<pub_key_t> derive_range(uint32_t subaccount, uint32_t first_pointer, uint32_t count);
+            // Derive BIP44 pubkeys for count consecutive pointers from first_pointer
+            std::vector<pub_key_t> derive_range(
+                uint32_t subaccount, uint32_t first_pointer, uint32_t count, bool is_internal);
+
             virtual xpub_hdkey get_subaccount(uint32_t subaccount) = 0;
 
+            // Return the approximate memory used by subaccount xpubs and derived pubkeys
+            size_t get_memory_usage() const;
+            // Release the derived pubkey cache, which is repopulated as keys are derived
+            void trim();
+
         protected:
             bool m_is_main_net;
             bool m_is_liquid;
             xpub_t m_xpub;
             std::map<uint32_t, xpub_hdkey> m_subaccounts;
+
+        private:
+            pub_key_t derive_impl(uint32_t subaccount, uint32_t branch, uint32_t pointer);
+            std::vector<pub_key_t> derive_range_impl(
+                uint32_t subaccount, uint32_t branch, uint32_t first_pointer, uint32_t count);
+
+            derived_pubkey_cache m_cache;
         };
     } // namespace detail
 
@@ -227,6 +227,11 @@ pub struct DiscoverAccountOpt {
     pub xpub: ExtendedPubKey,
 }
 
+#[derive(Serialize, Deserialize, Debug, Clone)]
+pub struct DiscoverAccountsOpt {
+    pub subaccounts: Vec<DiscoverAccountOpt>,
+}
+
 #[derive(Serialize, Deserialize, Debug, Clone)]
 pub struct GetAccountPathOpt {
     pub subaccount: u32,
@@ -285,6 +290,24 @@ pub struct SPVVerifyTxParams {
     pub height: u32,
 }
 
+#[derive(Serialize, Deserialize, Debug, Clone, Default)]
+pub struct SPVVerifyTxsEntry {
+    /// The `txid` of the transaction to verify
+    pub txid: String,
+
+    /// The `height` of the block containing the transaction to be verified
+    pub height: u32,
+}
+
+#[derive(Serialize, Deserialize, Debug, Clone, Default)]
+pub struct SPVVerifyTxsParams {
+    #[serde(flatten)]
+    pub params: SPVCommonParams,
+
+    /// The transactions to verify
+    pub txs: Vec<SPVVerifyTxsEntry>,
+}
+
 #[derive(Serialize, Deserialize, Debug, Clone, Default)]
 pub struct SPVDownloadHeadersParams {
     #[serde(flatten)]
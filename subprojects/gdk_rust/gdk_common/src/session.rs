@@ -54,6 +54,12 @@ impl From<serde_json::Error> for JsonError {
     }
 }
 
+impl From<serde_cbor::Error> for JsonError {
+    fn from(e: serde_cbor::Error) -> Self {
+        JsonError::new(e.to_string())
+    }
+}
+
 impl From<JsonError> for Value {
     fn from(e: JsonError) -> Self {
         serde_json::to_value(&e).expect("standard serialize without maps")
@@ -26,9 +26,9 @@ use gdk_common::be::{
 use gdk_common::error::fn_err;
 use gdk_common::model::{
     parse_path, AccountInfo, AddressAmount, AddressDataResult, AddressPointer, CreateTransaction,
-    GetPreviousAddressesOpt, GetTransactionsOpt, GetTxInOut, PreviousAddress, PreviousAddresses,
-    SPVVerifyTxResult, TransactionMeta, TransactionOutput, TxListItem, Txo, UnspentOutput,
-    UpdateAccountOpt, UtxoStrategy,
+    DiscoverAccountOpt, GetPreviousAddressesOpt, GetTransactionsOpt, GetTxInOut, PreviousAddress,
+    PreviousAddresses, SPVVerifyTxResult, TransactionMeta, TransactionOutput, TxListItem, Txo,
+    UnspentOutput, UpdateAccountOpt, UtxoStrategy,
 };
 use gdk_common::scripts::{p2pkh_script, p2shwpkh_script_sig, ScriptType};
 use gdk_common::slip132::slip132_version;
@@ -1143,30 +1143,58 @@ fn elements_address(
     address.to_confidential(blinding_pub)
 }
 
+/// The maximum number of scripts to subscribe to in a single batch request
+/// when discovering accounts.
+const MAX_DISCOVERY_SCRIPTS_PER_BATCH: usize = 200;
+
 pub fn discover_account(
     electrum_url: &ElectrumUrl,
     proxy: Option<&str>,
     account_xpub: &ExtendedPubKey,
     script_type: ScriptType,
 ) -> Result<bool, Error> {
+    let opt = DiscoverAccountOpt {
+        script_type,
+        xpub: *account_xpub,
+    };
+    Ok(discover_accounts(electrum_url, proxy, &[opt])?[0])
+}
+
+/// Returns whether each of `accounts` has a transaction in the first
+/// `GAP_LIMIT` external scripts, checking the scripts of all accounts
+/// using batched requests.
+pub fn discover_accounts(
+    electrum_url: &ElectrumUrl,
+    proxy: Option<&str>,
+    accounts: &[DiscoverAccountOpt],
+) -> Result<Vec<bool>, Error> {
     use gdk_common::electrum_client::ElectrumApi;
 
+    let mut scripts = Vec::with_capacity(accounts.len() * GAP_LIMIT as usize);
+    for account in accounts {
+        let external_xpub = account.xpub.ckd_pub(&crate::EC, 0.into())?;
+        for index in 0..GAP_LIMIT {
+            let child_key = external_xpub.ckd_pub(&crate::EC, index.into())?;
+            // Every network has the same scriptpubkey
+            let script = bitcoin_address(
+                &child_key.to_pub(),
+                account.script_type,
+                bitcoin::Network::Bitcoin,
+            )
+            .script_pubkey();
+            scripts.push(script);
+        }
+    }
+
     // build our own client so that the subscriptions are dropped at the end
     let client = electrum_url.build_client(proxy, None)?;
 
-    let external_xpub = account_xpub.ckd_pub(&crate::EC, 0.into())?;
-    for index in 0..GAP_LIMIT {
-        let child_key = external_xpub.ckd_pub(&crate::EC, index.into())?;
-        // Every network has the same scriptpubkey
-        let script = bitcoin_address(&child_key.to_pub(), script_type, bitcoin::Network::Bitcoin)
-            .script_pubkey();
-
-        if client.script_subscribe(&script)?.is_some() {
-            return Ok(true);
-        }
+    let mut statuses = Vec::with_capacity(scripts.len());
+    for batch in scripts.chunks(MAX_DISCOVERY_SCRIPTS_PER_BATCH) {
+        statuses.extend(client.batch_script_subscribe(batch.iter())?);
     }
 
-    Ok(false)
+    Ok(statuses.chunks(GAP_LIMIT as usize).map(|s| s.iter().any(Option::is_some)).collect())
 }
 
 #[allow(clippy::cognitive_complexity)]
@@ -13,7 +13,7 @@ use gdk_common::elements;
 use gdk_common::log::{debug, info, warn};
 use gdk_common::model::{
     SPVCommonParams, SPVDownloadHeadersParams, SPVDownloadHeadersResult, SPVVerifyTxParams,
-    SPVVerifyTxResult,
+    SPVVerifyTxResult, SPVVerifyTxsEntry, SPVVerifyTxsParams,
 };
 use gdk_common::store::{Decryptable, Encryptable};
 use gdk_common::NetworkId;
@@ -127,6 +127,25 @@ pub fn download_headers(
 ///
 /// used to expose SPV functionality through C interface
 pub fn spv_verify_tx(input: &SPVVerifyTxParams) -> Result<SPVVerifyTxResult, Error> {
+    let params = SPVVerifyTxsParams {
+        params: input.params.clone(),
+        txs: vec![SPVVerifyTxsEntry {
+            txid: input.txid.clone(),
+            height: input.height,
+        }],
+    };
+    Ok(spv_verify_txs(&params)?.remove(0))
+}
+
+/// Verify multiple transactions as per `spv_verify_tx`.
+///
+/// The server connection, headers chain and verified cache are shared between all of the
+/// transactions, and the verified cache is persisted once at the end. Each transaction is
+/// verified independently: one that fails to verify, e.g. because its header or proof can't be
+/// fetched, is returned as `Disabled` without affecting the results of the others.
+///
+/// used to expose SPV functionality through C interface
+pub fn spv_verify_txs(input: &SPVVerifyTxsParams) -> Result<Vec<SPVVerifyTxResult>, Error> {
     let mut _lock;
     if let NetworkId::Bitcoin(network) = input.params.network.id() {
         // Liquid hasn't a shared headers chain file
@@ -135,33 +154,92 @@ pub fn spv_verify_tx(input: &SPVVerifyTxParams) -> Result<SPVVerifyTxResult, Err
             .expect("unreachable because map populate with every enum variants")
             .lock()?;
     }
-    debug!("spv_verify_tx {:?}", input);
-    let txid = BETxid::from_hex(&input.txid, input.params.network.id())?;
+    debug!("spv_verify_txs {:?}", input);
 
     let mut cache = input.params.verified_cache()?;
-    if cache.contains(&txid, input.height)? {
+    let mut client = None;
+    let mut chain = None;
+    let mut cache_updated = false;
+    let mut results = Vec::with_capacity(input.txs.len());
+
+    for tx in input.txs.iter() {
+        let result = verify_batch_tx(
+            &input.params,
+            &mut cache,
+            &mut client,
+            &mut chain,
+            tx,
+            &mut cache_updated,
+        )
+        .unwrap_or_else(|e| {
+            warn!("failed verifying {} at height {}: {:?}", tx.txid, tx.height, e);
+            SPVVerifyTxResult::Disabled
+        });
+        results.push(result);
+    }
+
+    if cache_updated {
+        // The results are valid even if they can't be persisted
+        if let Err(e) = cache.flush() {
+            warn!("failed persisting verified cache: {:?}", e);
+        }
+    }
+    Ok(results)
+}
+
+/// Verify one transaction of a `spv_verify_txs` batch, connecting to the server if needed
+fn verify_batch_tx(
+    params: &SPVCommonParams,
+    cache: &mut VerifiedCache,
+    client: &mut Option<Client>,
+    chain: &mut Option<HeadersChain>,
+    tx: &SPVVerifyTxsEntry,
+    cache_updated: &mut bool,
+) -> Result<SPVVerifyTxResult, Error> {
+    let txid = BETxid::from_hex(&tx.txid, params.network.id())?;
+    if cache.contains(&txid, tx.height)? {
         info!("verified cache hit for {}", txid);
         return Ok(SPVVerifyTxResult::Verified);
     }
+    if client.is_none() {
+        *client = Some(params.build_client()?);
+    }
+    let client = client.as_ref().expect("set above");
+    let result = verify_tx_proof(params, client, chain, &txid, tx.height)?;
+    if let SPVVerifyTxResult::Verified = result {
+        cache.insert(&txid, tx.height);
+        *cache_updated = true;
+    }
+    Ok(result)
+}
 
-    let client = input.params.build_client()?;
-
-    match input.params.network.id() {
+/// Download and check the inclusion proof of a tx, loading the headers chain into `chain` if
+/// needed
+fn verify_tx_proof(
+    params: &SPVCommonParams,
+    client: &Client,
+    chain: &mut Option<HeadersChain>,
+    txid: &BETxid,
+    height: u32,
+) -> Result<SPVVerifyTxResult, Error> {
+    match params.network.id() {
         NetworkId::Bitcoin(_bitcoin_network) => {
-            let chain = input.params.headers_chain().expect("match verified we are bitcoin type");
+            if chain.is_none() {
+                *chain = Some(params.headers_chain()?);
+            }
+            let chain = chain.as_ref().expect("set above");
 
-            if input.height <= chain.height() {
+            if height <= chain.height() {
                 let btxid = txid.ref_bitcoin().unwrap();
                 info!("chain height ({}) enough to verify, downloading proof", chain.height());
-                let proof = match client.transaction_get_merkle(btxid, input.height as usize) {
+                let proof = match client.transaction_get_merkle(btxid, height as usize) {
                     Ok(proof) => proof,
                     Err(e) => {
                         warn!("failed fetching merkle inclusion proof for {}: {:?}", txid, e);
                         return Ok(SPVVerifyTxResult::NotVerified);
                     }
                 };
-                if chain.verify_tx_proof(btxid, input.height, proof).is_ok() {
-                    cache.write(&txid, input.height)?;
+                if chain.verify_tx_proof(btxid, height, proof).is_ok() {
                     Ok(SPVVerifyTxResult::Verified)
                 } else {
                     Ok(SPVVerifyTxResult::NotVerified)
@@ -170,26 +248,24 @@ pub fn spv_verify_tx(input: &SPVVerifyTxParams) -> Result<SPVVerifyTxResult, Err
                 info!(
                     "chain height ({}) not enough to verify tx at height {}",
                     chain.height(),
-                    input.height
+                    height
                 );
 
                 Ok(SPVVerifyTxResult::InProgress)
             }
         }
         NetworkId::Elements(elements_network) => {
-            let proof =
-                match client.transaction_get_merkle(&txid.into_bitcoin(), input.height as usize) {
-                    Ok(proof) => proof,
-                    Err(e) => {
-                        warn!("failed fetching merkle inclusion proof for {}: {:?}", txid, e);
-                        return Ok(SPVVerifyTxResult::NotVerified);
-                    }
-                };
+            let proof = match client.transaction_get_merkle(&txid.into_bitcoin(), height as usize) {
+                Ok(proof) => proof,
+                Err(e) => {
+                    warn!("failed fetching merkle inclusion proof for {}: {:?}", txid, e);
+                    return Ok(SPVVerifyTxResult::NotVerified);
+                }
+            };
             let verifier = Verifier::new(elements_network);
-            let header_bytes = client.block_header_raw(input.height as usize)?;
+            let header_bytes = client.block_header_raw(height as usize)?;
             let header: elements::BlockHeader = elements::encode::deserialize(&header_bytes)?;
             if verifier.verify_tx_proof(txid.ref_elements().unwrap(), proof, &header).is_ok() {
-                cache.write(&txid, input.height)?;
                 Ok(SPVVerifyTxResult::Verified)
             } else {
                 Ok(SPVVerifyTxResult::NotVerified)
@@ -254,9 +330,8 @@ impl VerifiedCache {
         Ok(self.set.contains(&(txid.clone(), height)))
     }
 
-    fn write(&mut self, txid: &BETxid, height: u32) -> Result<(), Error> {
+    fn insert(&mut self, txid: &BETxid, height: u32) {
         self.set.insert((txid.clone(), height));
-        self.flush()
     }
 
     /// remove all verified txid with height greater than given height
@@ -20,7 +20,7 @@ pub mod session;
 pub mod spv;
 
 use crate::account::{
-    discover_account, get_account_derivation, get_account_script_purpose,
+    discover_account, discover_accounts, get_account_derivation, get_account_script_purpose,
     get_last_next_account_nums, Account,
 };
 use crate::error::Error;
@@ -935,6 +935,10 @@ impl ElectrumSession {
         discover_account(&self.url, self.proxy.as_deref(), &opt.xpub, opt.script_type)
     }
 
+    pub fn discover_subaccount_batch(&self, opt: DiscoverAccountsOpt) -> Result<Vec<bool>, Error> {
+        discover_accounts(&self.url, self.proxy.as_deref(), &opt.subaccounts)
+    }
+
     pub fn get_next_subaccount(&self, opt: GetNextAccountOpt) -> Result<u32, Error> {
         let (_, next_account) = get_last_next_account_nums(
             self.accounts.read()?.keys().copied().collect(),
@@ -87,6 +87,9 @@ impl Session for ElectrumSession {
             "discover_subaccount" => {
                 self.discover_subaccount(serde_json::from_value(input)?).to_json()
             }
+            "discover_subaccounts" => {
+                self.discover_subaccount_batch(serde_json::from_value(input)?).to_json()
+            }
             "get_subaccount_root_path" => {
                 self.get_subaccount_root_path(serde_json::from_value(input)?).to_json()
             }
@@ -5,6 +5,7 @@ use std::time::{Duration, Instant};
 use gdk_common::log::info;
 use gdk_common::ureq;
 
+use crate::last_modified::Validators;
 use crate::Result;
 use serde_json::Value;
 
@@ -12,13 +13,18 @@ use serde_json::Value;
 pub(crate) fn call(
     url: &str,
     agent: &ureq::Agent,
-    last_modified: &str,
+    validators: &Validators,
     custom_params: &HashMap<String, String>,
-) -> Result<Option<(Value, String)>> {
+) -> Result<Option<(Value, Validators)>> {
     let start = Instant::now();
 
-    let mut request =
-        agent.get(url).timeout(Duration::from_secs(30)).set("If-Modified-Since", last_modified);
+    let mut request = agent
+        .get(url)
+        .timeout(Duration::from_secs(30))
+        .set("If-Modified-Since", &validators.last_modified);
+    if !validators.etag.is_empty() {
+        request = request.set("If-None-Match", &validators.etag);
+    }
     for param in custom_params {
         request = request.set(param.0, param.1);
     }
@@ -38,6 +44,9 @@ pub(crate) fn call(
         .unwrap_or_default()
         .to_string();
 
+    let etag =
+        response.header("ETag").or_else(|| response.header("etag")).unwrap_or_default().to_string();
+
     // `respone.into_json()` is slow because of many syscalls. See:
     // https://github.com/algesten/ureq/pull/506.
     let buffered_reader = BufReader::new(response.into_reader());
@@ -45,7 +54,13 @@ pub(crate) fn call(
 
     info!("END call {} {} took: {:?}", &url, status, start.elapsed());
 
-    Ok(Some((value, last_modified)))
+    Ok(Some((
+        value,
+        Validators {
+            last_modified,
+            etag,
+        },
+    )))
 }
 
 #[cfg(test)]
@@ -63,6 +78,7 @@ mod test {
         for what in AssetsOrIcons::iter() {
             let server = Server::run();
             let expected_last_modified = "date";
+            let expected_etag = "\"abc\"";
             server.expect(
                 Expectation::matching(all_of![
                     request::method_path("GET", what.endpoint()),
@@ -72,16 +88,38 @@ mod test {
                 .respond_with(
                     status_code(200)
                         .body("{}")
-                        .append_header("last-modified", expected_last_modified),
+                        .append_header("last-modified", expected_last_modified)
+                        .append_header("etag", expected_etag),
                 ),
             );
 
-            let (_, last_modified) =
-                call(&server.url_str(what.endpoint()), &agent, "", &HashMap::new())
-                    .unwrap()
+            let (_, validators) = call(
+                &server.url_str(what.endpoint()),
+                &agent,
+                &Validators::default(),
+                &HashMap::new(),
+            )
+            .unwrap()
+            .unwrap();
+
+            assert_eq!(expected_last_modified, validators.last_modified);
+            assert_eq!(expected_etag, validators.etag);
+
+            // A stored ETag is sent back to the server.
+            let server = Server::run();
+            server.expect(
+                Expectation::matching(all_of![
+                    request::method_path("GET", what.endpoint()),
+                    request::headers(contains(("if-none-match", expected_etag))),
+                ])
+                .respond_with(status_code(304)),
+            );
+
+            let not_modified =
+                call(&server.url_str(what.endpoint()), &agent, &validators, &HashMap::new())
                     .unwrap();
 
-            assert_eq!(expected_last_modified, last_modified);
+            assert!(not_modified.is_none());
         }
     }
 }
@@ -0,0 +1,195 @@
+//! A sorted on-disk index of a local registry file, so that single assets or
+//! icons can be looked up without reading the whole registry into memory.
+//!
+//! The index starts with a header of `MAGIC`, the [`Stamp`] of the registry
+//! file it was built from, the number of entries and the offset of the
+//! records. The CBOR encoded entries follow, then one record per entry sorted
+//! by asset id, each holding the id, the entry offset and the entry length.
+//! Lookups binary search the records, reading only the pages they touch.
+
+use std::cmp::Ordering;
+use std::collections::{BTreeMap, HashMap};
+use std::convert::TryInto;
+use std::fs::File;
+use std::io::{BufWriter, Read, Seek, SeekFrom, Write};
+use std::time::UNIX_EPOCH;
+
+use gdk_common::elements::AssetId;
+use serde::{de::DeserializeOwned, Serialize};
+
+use crate::Result;
+
+const MAGIC: &[u8; 8] = b"GDKRIDX1";
+
+const HEADER_LEN: usize = 40;
+
+const RECORD_LEN: usize = 44;
+
+/// Identifies the contents of the registry file an index was built from, so
+/// that indexes made stale by writes from other gdk versions are rebuilt.
+#[derive(Copy, Clone, Debug, Eq, PartialEq)]
+pub(crate) struct Stamp {
+    len: u64,
+    modified: u64,
+}
+
+impl Stamp {
+    pub(crate) fn of(file: &File) -> Result<Self> {
+        let metadata = file.metadata()?;
+        let modified = metadata
+            .modified()
+            .ok()
+            .and_then(|time| time.duration_since(UNIX_EPOCH).ok())
+            .map(|elapsed| elapsed.as_nanos() as u64)
+            .unwrap_or(0);
+        Ok(Self {
+            len: metadata.len(),
+            modified,
+        })
+    }
+}
+
+fn id_bytes(id: &AssetId) -> [u8; 32] {
+    id.clone().into_inner().0
+}
+
+fn read_u64(bytes: &[u8]) -> u64 {
+    u64::from_le_bytes(bytes[..8].try_into().expect("8 bytes"))
+}
+
+/// Replaces the contents of `file` with an index of `entries`. When an asset
+/// id appears more than once, its last entry is indexed.
+pub(crate) fn write<'a, V: Serialize + 'a>(
+    file: &mut File,
+    stamp: Stamp,
+    entries: impl IntoIterator<Item = (&'a AssetId, &'a V)>,
+) -> Result<()> {
+    let sorted = entries.into_iter().map(|(id, v)| (id_bytes(id), v)).collect::<BTreeMap<_, _>>();
+
+    file.set_len(0)?;
+    file.seek(SeekFrom::Start(0))?;
+    let mut writer = BufWriter::new(&mut *file);
+
+    // The header is written last, so that a partially written index is
+    // never considered valid.
+    writer.write_all(&[0u8; HEADER_LEN])?;
+
+    let mut records = Vec::with_capacity(sorted.len() * RECORD_LEN);
+    let mut offset = 0u64;
+    for (id, value) in &sorted {
+        let entry = serde_cbor::to_vec(value)?;
+        writer.write_all(&entry)?;
+        records.extend_from_slice(id);
+        records.extend_from_slice(&offset.to_le_bytes());
+        records.extend_from_slice(&(entry.len() as u32).to_le_bytes());
+        offset += entry.len() as u64;
+    }
+    writer.write_all(&records)?;
+
+    writer.seek(SeekFrom::Start(0))?;
+    writer.write_all(MAGIC)?;
+    for field in [stamp.len, stamp.modified, sorted.len() as u64, HEADER_LEN as u64 + offset] {
+        writer.write_all(&field.to_le_bytes())?;
+    }
+    writer.flush()?;
+    Ok(())
+}
+
+/// Marks the index in `file` as invalid, so that it is rebuilt on next use.
+pub(crate) fn invalidate(file: &mut File) -> Result<()> {
+    file.set_len(0).map_err(Into::into)
+}
+
+/// Returns the indexed entries for `ids`, skipping ids that aren't indexed.
+/// Returns `None` if the index is missing or wasn't built from a registry
+/// file with the given `stamp`.
+pub(crate) fn lookup<V: DeserializeOwned>(
+    file: &mut File,
+    stamp: Stamp,
+    ids: &[AssetId],
+) -> Result<Option<HashMap<AssetId, V>>> {
+    let mut header = [0u8; HEADER_LEN];
+    file.seek(SeekFrom::Start(0))?;
+    if file.read_exact(&mut header).is_err() || &header[..8] != MAGIC {
+        return Ok(None);
+    }
+    let indexed = Stamp {
+        len: read_u64(&header[8..]),
+        modified: read_u64(&header[16..]),
+    };
+    if indexed != stamp {
+        return Ok(None);
+    }
+    let num_records = read_u64(&header[24..]);
+    let records_offset = read_u64(&header[32..]);
+
+    let mut found = HashMap::with_capacity(ids.len());
+    let mut record = [0u8; RECORD_LEN];
+
+    for id in ids {
+        let key = id_bytes(id);
+        let (mut lo, mut hi) = (0, num_records);
+
+        while lo < hi {
+            let mid = lo + (hi - lo) / 2;
+            file.seek(SeekFrom::Start(records_offset + mid * RECORD_LEN as u64))?;
+            file.read_exact(&mut record)?;
+
+            match record[..32].cmp(&key[..]) {
+                Ordering::Less => lo = mid + 1,
+                Ordering::Greater => hi = mid,
+                Ordering::Equal => {
+                    let offset = read_u64(&record[32..]);
+                    let len = u32::from_le_bytes(record[40..].try_into().expect("4 bytes"));
+                    let mut entry = vec![0u8; len as usize];
+                    file.seek(SeekFrom::Start(HEADER_LEN as u64 + offset))?;
+                    file.read_exact(&mut entry)?;
+                    found.insert(id.clone(), serde_cbor::from_slice(&entry)?);
+                    break;
+                }
+            }
+        }
+    }
+
+    Ok(Some(found))
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use gdk_common::elements::hashes::hex::FromHex;
+
+    fn asset_id(i: u8) -> AssetId {
+        AssetId::from_hex(&format!("{:02x}", i).repeat(32)).unwrap()
+    }
+
+    #[test]
+    fn test_lookup() {
+        let mut tempfile = tempfile::tempfile().unwrap();
+        let stamp = Stamp::of(&tempfile).unwrap();
+        assert!(lookup::<String>(&mut tempfile, stamp, &[asset_id(1)]).unwrap().is_none());
+
+        let entries =
+            (0..200u8).step_by(2).map(|i| (asset_id(i), i.to_string())).collect::<Vec<_>>();
+        let overridden = (asset_id(4), "four".to_owned());
+        let all = entries.iter().chain(std::iter::once(&overridden)).map(|(id, v)| (id, v));
+        write(&mut tempfile, stamp, all).unwrap();
+
+        let ids = (0..200u8).map(asset_id).collect::<Vec<_>>();
+        let found = lookup::<String>(&mut tempfile, stamp, &ids).unwrap().unwrap();
+        assert_eq!(found.len(), 100);
+        assert_eq!(found[&asset_id(0)], "0");
+        assert_eq!(found[&asset_id(4)], "four");
+        assert_eq!(found[&asset_id(198)], "198");
+        assert!(!found.contains_key(&asset_id(1)));
+
+        let other = Stamp {
+            len: stamp.len + 1,
+            ..stamp
+        };
+        assert!(lookup::<String>(&mut tempfile, other, &ids).unwrap().is_none());
+
+        invalidate(&mut tempfile).unwrap();
+        assert!(lookup::<String>(&mut tempfile, stamp, &ids).unwrap().is_none());
+    }
+}
@@ -3,10 +3,53 @@ use std::ops::{Index, IndexMut};
 use crate::AssetsOrIcons;
 use serde::{Deserialize, Serialize};
 
+/// The HTTP validators of the locally stored assets and icons, sent with
+/// refresh requests so that an unchanged registry returns `304 Not Modified`.
 #[derive(Clone, Debug, Default, PartialEq, Eq, Serialize, Deserialize)]
 pub(crate) struct LastModified {
     assets: String,
     icons: String,
+
+    // Files written before ETags were stored don't have these fields.
+    #[serde(default)]
+    assets_etag: String,
+    #[serde(default)]
+    icons_etag: String,
+}
+
+/// The validators returned with a single registry response.
+#[derive(Clone, Debug, Default, PartialEq, Eq)]
+pub(crate) struct Validators {
+    pub(crate) last_modified: String,
+    pub(crate) etag: String,
+}
+
+impl LastModified {
+    pub(crate) fn validators(&self, what: AssetsOrIcons) -> Validators {
+        Validators {
+            last_modified: self[what].clone(),
+            etag: self.etag(what).clone(),
+        }
+    }
+
+    pub(crate) fn set_validators(&mut self, what: AssetsOrIcons, validators: Validators) {
+        self[what] = validators.last_modified;
+        *self.etag_mut(what) = validators.etag;
+    }
+
+    fn etag(&self, what: AssetsOrIcons) -> &String {
+        match what {
+            AssetsOrIcons::Assets => &self.assets_etag,
+            AssetsOrIcons::Icons => &self.icons_etag,
+        }
+    }
+
+    fn etag_mut(&mut self, what: AssetsOrIcons) -> &mut String {
+        match what {
+            AssetsOrIcons::Assets => &mut self.assets_etag,
+            AssetsOrIcons::Icons => &mut self.icons_etag,
+        }
+    }
 }
 
 impl Index<AssetsOrIcons> for LastModified {
@@ -30,6 +30,7 @@ mod error;
 mod file;
 mod hard_coded;
 mod http;
+mod index;
 mod last_modified;
 mod params;
 mod registry;
@@ -97,7 +98,7 @@ pub fn get_assets(params: GetAssetsParams) -> Result<RegistryInfos> {
 
     log::debug!("{:?} are not already cached", not_cached);
 
-    let registry = registry::get_full(network)?;
+    let registry = registry::get_by_ids(network, &not_cached)?;
 
     // The returned infos are marked as being from the registry if at least one
     // of the returned assets is from the full asset registry.
@@ -3,13 +3,15 @@ use std::fs::{self, File, OpenOptions};
 use std::path::Path;
 use std::sync::{Mutex, MutexGuard};
 
+use gdk_common::elements::AssetId;
 use gdk_common::log::{debug, warn};
 use gdk_common::once_cell::sync::OnceCell;
 use serde::{de::DeserializeOwned, Serialize};
 
+use crate::last_modified::Validators;
 use crate::params::{ElementsNetwork, RefreshAssetsParams};
 use crate::registry_infos::{RegistryAssets, RegistryIcons, RegistrySource};
-use crate::{cache, file, hard_coded, http};
+use crate::{cache, file, hard_coded, http, index};
 use crate::{AssetEntry, AssetsOrIcons, Error, LastModified, RegistryInfos, Result};
 
 type LastModifiedFiles = HashMap<ElementsNetwork, Mutex<File>>;
@@ -17,6 +19,12 @@ type RegistryFiles = HashMap<(ElementsNetwork, AssetsOrIcons), Mutex<File>>;
 
 static LAST_MODIFIED_FILES: OnceCell<LastModifiedFiles> = OnceCell::new();
 static REGISTRY_FILES: OnceCell<RegistryFiles> = OnceCell::new();
+static INDEX_FILES: OnceCell<RegistryFiles> = OnceCell::new();
+
+/// Returns the index file at `path`, creating it empty if it doesn't exist.
+fn get_index_file_at(path: &Path) -> Result<File> {
+    OpenOptions::new().write(true).read(true).create(true).open(&path).map_err(Into::into)
+}
 
 /// Returns the file at `path`, using `initializer` to initialize the file's
 /// contents if it doesn't already exist.
@@ -39,6 +47,9 @@ pub(crate) fn init(registry_dir: impl AsRef<Path>) -> Result<()> {
     let mut registry_files: RegistryFiles =
         HashMap::with_capacity(ElementsNetwork::len() * AssetsOrIcons::len());
 
+    let mut index_files: RegistryFiles =
+        HashMap::with_capacity(ElementsNetwork::len() * AssetsOrIcons::len());
+
     let mut path = registry_dir.as_ref().to_owned();
 
     for network in ElementsNetwork::iter() {
@@ -54,6 +65,8 @@ pub(crate) fn init(registry_dir: impl AsRef<Path>) -> Result<()> {
             let file = get_file(&path, || hard_coded::assets(network))?;
             registry_files.insert((network, assets), Mutex::new(file));
             path.pop();
+            let file = get_index_file_at(&path.join(format!("{}.index", assets)))?;
+            index_files.insert((network, assets), Mutex::new(file));
         }
 
         {
@@ -62,6 +75,8 @@ pub(crate) fn init(registry_dir: impl AsRef<Path>) -> Result<()> {
             let file = get_file(&path, || hard_coded::icons(network))?;
             registry_files.insert((network, iconss), Mutex::new(file));
             path.pop();
+            let file = get_index_file_at(&path.join(format!("{}.index", iconss)))?;
+            index_files.insert((network, iconss), Mutex::new(file));
         }
 
         path.pop();
@@ -71,6 +86,8 @@ pub(crate) fn init(registry_dir: impl AsRef<Path>) -> Result<()> {
 
     REGISTRY_FILES.set(registry_files).map_err(|_err| Error::AlreadyInitialized)?;
 
+    INDEX_FILES.set(index_files).map_err(|_err| Error::AlreadyInitialized)?;
+
     Ok(())
 }
 
@@ -124,6 +141,14 @@ pub(crate) fn get_full(network: ElementsNetwork) -> Result<RegistryInfos> {
     Ok(RegistryInfos::new(assets, icons))
 }
 
+/// Returns the local assets and icons with the given ids. Unlike
+/// [`get_full`], only the requested entries are read from disk.
+pub(crate) fn get_by_ids(network: ElementsNetwork, ids: &[AssetId]) -> Result<RegistryInfos> {
+    let assets = lookup::<AssetEntry>(network, AssetsOrIcons::Assets, ids)?;
+    let icons = lookup::<String>(network, AssetsOrIcons::Icons, ids)?;
+    Ok(RegistryInfos::new(assets, icons))
+}
+
 pub(crate) fn filter_full(
     network: ElementsNetwork,
     matcher: &dyn Fn(&AssetEntry, Option<&str>) -> bool,
@@ -169,32 +194,81 @@ fn fetch<T: Default + Serialize + DeserializeOwned>(
 
         Err(err) => {
             warn!("couldn't deserialize local {} due to {}", what, err);
-            let hard_coded = hard_coded::value(network, what);
-            file::write(&hard_coded, file)?;
+            let hard_coded = reset_registry_file(network, what, file)?;
+            index::invalidate(&mut *get_index_file(network, what)?)?;
             serde_json::from_value(hard_coded).map_err(Into::into)
         }
     }
 }
 
+/// Overwrites the registry `file` with the hard coded values, returning them.
+fn reset_registry_file(
+    network: ElementsNetwork,
+    what: AssetsOrIcons,
+    file: &mut File,
+) -> Result<serde_json::Value> {
+    let hard_coded = hard_coded::value(network, what);
+    file::write(&hard_coded, file)?;
+    Ok(hard_coded)
+}
+
+/// Returns the local entries with the given ids, from the registry index.
+/// The index is rebuilt from the whole registry if it's missing, or if the
+/// registry file changed since the index was written.
+fn lookup<V: Serialize + DeserializeOwned>(
+    network: ElementsNetwork,
+    what: AssetsOrIcons,
+    ids: &[AssetId],
+) -> Result<HashMap<AssetId, V>> {
+    // Lock the registry file first, as `refresh` does.
+    let file = &mut *get_registry_file(network, what)?;
+    let stamp = index::Stamp::of(file)?;
+    let index_file = &mut *get_index_file(network, what)?;
+
+    match index::lookup(index_file, stamp, ids) {
+        Ok(Some(found)) => return Ok(found),
+        Ok(None) => debug!("rebuilding local {} index", what),
+        Err(err) => warn!("rebuilding local {} index due to {}", what, err),
+    }
+
+    let mut values = match file::read::<HashMap<AssetId, V>>(file) {
+        Ok(values) => values,
+        Err(err) => {
+            warn!("couldn't deserialize local {} due to {}", what, err);
+            reset_registry_file(network, what, file)?;
+            HashMap::new()
+        }
+    };
+    let hard_coded: HashMap<AssetId, V> = serde_json::from_value(hard_coded::value(network, what))?;
+    index::write(index_file, index::Stamp::of(file)?, values.iter().chain(hard_coded.iter()))?;
+
+    values.extend(hard_coded);
+    values.retain(|id, _| ids.contains(id));
+    Ok(values)
+}
+
 fn refresh<T: Serialize + DeserializeOwned>(
     what: AssetsOrIcons,
     params: &RefreshAssetsParams,
 ) -> Result<Option<T>> {
     let file = &mut *get_registry_file(params.network(), what)?;
 
-    let last_modified = if file::read::<T>(file).is_ok() {
-        get_last_modified(params.network(), what)?
+    let validators = if file::read::<T>(file).is_ok() {
+        get_validators(params.network(), what)?
     } else {
-        String::new()
+        Validators::default()
     };
 
-    match http::call(&params.url(what), &params.agent()?, &last_modified, &params.custom_headers())?
-    {
-        Some((value, new_modified)) => {
-            debug!("fetched {} were last modified {}", what, new_modified);
+    match http::call(&params.url(what), &params.agent()?, &validators, &params.custom_headers())? {
+        Some((value, new_validators)) => {
+            debug!(
+                "fetched {} were last modified {} (etag {})",
+                what, new_validators.last_modified, new_validators.etag
+            );
             let downloaded = serde_json::from_value::<T>(value)?;
             file::write(&downloaded, file)?;
-            set_last_modified(new_modified, params.network(), what)?;
+            index::invalidate(&mut *get_index_file(params.network(), what)?)?;
+            set_validators(new_validators, params.network(), what)?;
             Ok(Some(downloaded))
         }
 
@@ -220,6 +294,21 @@ fn get_registry_file(
         .map_err(Into::into)
 }
 
+/// Returns the index file of the registry file corresponding to a given
+/// network and type, behind a Mutex guard. Fails if the Mutex is poisoned.
+fn get_index_file(
+    network: ElementsNetwork,
+    ty: AssetsOrIcons,
+) -> Result<MutexGuard<'static, File>> {
+    INDEX_FILES
+        .get()
+        .ok_or(Error::RegistryUninitialized)?
+        .get(&(network, ty))
+        .expect("all (network, {assets|icons}) combinations are initialized")
+        .lock()
+        .map_err(Into::into)
+}
+
 fn get_last_modified_file(network: ElementsNetwork) -> Result<MutexGuard<'static, File>> {
     LAST_MODIFIED_FILES
         .get()
@@ -230,18 +319,17 @@ fn get_last_modified_file(network: ElementsNetwork) -> Result<MutexGuard<'static
         .map_err(Into::into)
 }
 
-fn get_last_modified(network: ElementsNetwork, what: AssetsOrIcons) -> Result<String> {
+fn get_validators(network: ElementsNetwork, what: AssetsOrIcons) -> Result<Validators> {
     get_last_modified_file(network)
         //
         .and_then(|mut file| crate::file::read::<LastModified>(&mut *file))
-        .map(|last_modified| last_modified[what].to_owned())
+        .map(|last_modified| last_modified.validators(what))
 }
 
-fn set_last_modified(new: String, network: ElementsNetwork, what: AssetsOrIcons) -> Result<()> {
+fn set_validators(new: Validators, network: ElementsNetwork, what: AssetsOrIcons) -> Result<()> {
     get_last_modified_file(network).and_then(|mut file| {
         let mut last_modified = crate::file::read::<LastModified>(&mut *file)?;
-        let old = &mut last_modified[what];
-        *old = new;
+        last_modified.set_validators(what, new);
         crate::file::write(&last_modified, &mut *file)
     })
 }
@@ -14,7 +14,9 @@ use std::str::FromStr;
 use std::sync::{Arc, Once};
 use std::time::{Instant, SystemTime, UNIX_EPOCH};
 
-use gdk_common::model::{InitParam, SPVDownloadHeadersParams, SPVVerifyTxParams};
+use gdk_common::model::{
+    InitParam, SPVDownloadHeadersParams, SPVVerifyTxParams, SPVVerifyTxResult, SPVVerifyTxsParams,
+};
 
 use crate::error::Error;
 use gdk_common::exchange_rates::{ExchangeRatesCache, ExchangeRatesCacher};
@@ -182,7 +184,10 @@ pub extern "C" fn GDKRUST_call_session(
     let method = read_str(method);
     let input = read_str(input);
 
-    match call_session(sess, &method, &input) {
+    let res = serde_json::from_str(&input)
+        .map_err(Into::into)
+        .and_then(|input| call_session(sess, &method, input));
+    match res {
         Ok(value) => {
             unsafe { *output = make_str(value.to_string()) };
             GA_OK
@@ -203,9 +208,51 @@ pub extern "C" fn GDKRUST_call_session(
     }
 }
 
-fn call_session(sess: &mut GdkSession, method: &str, input: &str) -> Result<Value, JsonError> {
-    let input = serde_json::from_str(input)?;
+/// Binary variant of `GDKRUST_call_session`: input and output are CBOR
+/// encoded rather than JSON strings, which avoids formatting and re-parsing
+/// large results such as transaction and utxo lists.
+/// The output buffer must be freed using `GDKRUST_destroy_buffer`.
+#[no_mangle]
+pub extern "C" fn GDKRUST_call_session_cbor(
+    ptr: *mut libc::c_void,
+    method: *const c_char,
+    input: *const u8,
+    input_len: usize,
+    output: *mut *mut u8,
+    output_len: *mut usize,
+) -> i32 {
+    if ptr.is_null() || input.is_null() {
+        return GA_ERROR;
+    }
+    let sess: &mut GdkSession = unsafe { &mut *(ptr as *mut GdkSession) };
+    let method = read_str(method);
+    let input = unsafe { std::slice::from_raw_parts(input, input_len) };
 
+    let res = serde_cbor::from_slice(input)
+        .map_err(Into::into)
+        .and_then(|input| call_session(sess, &method, input));
+    let (retv, bytes) = match res {
+        Ok(value) => (GA_OK, serde_cbor::to_vec(&value)),
+        Err(err) => {
+            log::error!("error: {:?}", err);
+
+            let retv = if "id_invalid_pin" == err.error {
+                GA_NOT_AUTHORIZED
+            } else {
+                GA_ERROR
+            };
+            (retv, serde_cbor::to_vec(&err))
+        }
+    };
+    let bytes = bytes.expect("Default Serialize impl with maps containing only string keys");
+    unsafe {
+        *output_len = bytes.len();
+        *output = Box::into_raw(bytes.into_boxed_slice()) as *mut u8;
+    }
+    retv
+}
+
+fn call_session(sess: &mut GdkSession, method: &str, input: Value) -> Result<Value, JsonError> {
     if method == "exchange_rates" {
         let params = serde_json::from_value(input)?;
 
@@ -290,6 +337,14 @@ pub extern "C" fn GDKRUST_destroy_string(ptr: *mut c_char) {
     }
 }
 
+#[no_mangle]
+pub extern "C" fn GDKRUST_destroy_buffer(ptr: *mut u8, len: usize) {
+    unsafe {
+        // retake pointer and drop
+        let _ = Box::from_raw(std::ptr::slice_from_raw_parts_mut(ptr, len));
+    }
+}
+
 #[no_mangle]
 pub extern "C" fn GDKRUST_destroy_session(ptr: *mut libc::c_void) {
     unsafe {
@@ -350,6 +405,11 @@ fn handle_call(method: &str, input: &str) -> Result<String, Error> {
             let param: SPVVerifyTxParams = serde_json::from_str(input)?;
             to_string(&headers::spv_verify_tx(&param)?.as_i32())
         }
+        "spv_verify_txs" => {
+            let param: SPVVerifyTxsParams = serde_json::from_str(input)?;
+            let results = headers::spv_verify_txs(&param)?;
+            to_string(&results.iter().map(SPVVerifyTxResult::as_i32).collect::<Vec<_>>())
+        }
         "spv_download_headers" => {
             let param: SPVDownloadHeadersParams = serde_json::from_str(input)?;
             to_string(&headers::download_headers(&param)?)
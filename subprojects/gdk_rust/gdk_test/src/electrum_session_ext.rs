@@ -73,34 +73,59 @@ impl ElectrumSessionExt for ElectrumSession {
         let signer =
             TestSigner::new(credentials, self.network.bip32_network(), self.network.liquid);
 
-        for script_type in ScriptType::types() {
-            loop {
+        // Check the next few accounts of every script type at once, until
+        // an unused account is found for each type
+        const ACCOUNTS_PER_DISCOVERY: u32 = 4;
+        let mut script_types = ScriptType::types().to_vec();
+        while !script_types.is_empty() {
+            let mut candidates = vec![];
+            for script_type in &script_types {
                 let opt = GetNextAccountOpt {
                     script_type: *script_type,
                 };
-                let account_num = self.get_next_subaccount(opt).unwrap();
-                let opt = GetAccountPathOpt {
-                    subaccount: account_num,
-                };
-                let path = self.get_subaccount_root_path(opt).unwrap().path;
-                let xpub = signer.account_xpub(&path.into());
-                let opt = DiscoverAccountOpt {
-                    script_type: *script_type,
-                    xpub,
-                };
-                if self.discover_subaccount(opt).unwrap() {
-                    let opt = CreateAccountOpt {
+                let next_account_num = self.get_next_subaccount(opt).unwrap();
+                for i in 0..ACCOUNTS_PER_DISCOVERY {
+                    // Account numbers of the same script type are 16 apart
+                    let account_num = next_account_num + i * 16;
+                    let opt = GetAccountPathOpt {
                         subaccount: account_num,
-                        xpub: Some(xpub),
+                    };
+                    let path = self.get_subaccount_root_path(opt).unwrap().path;
+                    let xpub = signer.account_xpub(&path.into());
+                    candidates.push((account_num, *script_type, xpub));
+                }
+            }
+            let opt = DiscoverAccountsOpt {
+                subaccounts: candidates
+                    .iter()
+                    .map(|(_, script_type, xpub)| DiscoverAccountOpt {
+                        script_type: *script_type,
+                        xpub: *xpub,
+                    })
+                    .collect(),
+            };
+            let found = self.discover_subaccount_batch(opt).unwrap();
+
+            let mut remaining = vec![];
+            let chunk_len = ACCOUNTS_PER_DISCOVERY as usize;
+            let chunks = candidates.chunks(chunk_len).zip(found.chunks(chunk_len));
+            for (script_type, (candidates, found)) in script_types.iter().zip(chunks) {
+                let num_found = found.iter().take_while(|f| **f).count();
+                for (account_num, _, xpub) in &candidates[..num_found] {
+                    let opt = CreateAccountOpt {
+                        subaccount: *account_num,
+                        xpub: Some(*xpub),
                         discovered: true,
                         ..Default::default()
                     };
                     self.create_subaccount(opt).unwrap();
-                } else {
-                    // Empty subaccount
-                    break;
+                }
+                if num_found == found.len() {
+                    // All candidates were used, check the next ones
+                    remaining.push(*script_type);
                 }
             }
+            script_types = remaining;
         }
     }
 
@@ -0,0 +1,564 @@
+// Offline microbenchmarks for gdk hot paths.
+//
+// Usage: gdk_bench [--txs N] [--utxos N] [--cache-mb N] [--sessions N] [--min-time-ms N] [--filter NAME]
+//
+// Synthetic wallet data of the given size is generated up front, then each
+// benchmark is run repeatedly for at least --min-time-ms. Results are written
+// to stdout as a single JSON document for regression tracking, containing the
+// time, throughput and heap allocations per operation for each benchmark.
+// The cost of keeping --sessions idle sessions open is also reported.
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "src/amount.hpp"
+#include "src/assertion.hpp"
+#include "src/coin_selection.hpp"
+#include "src/containers.hpp"
+#include "src/ga_cache.hpp"
+#include "src/ga_wally.hpp"
+#include "src/io_context_pool.hpp"
+#include "src/network_parameters.hpp"
+#include "src/session.hpp"
+#include "src/session_impl.hpp"
+#include "src/signer.hpp"
+#include "src/threading.hpp"
+#include "src/transaction_utils.hpp"
+#include "src/utils.hpp"
+#include "src/wamp_transport.hpp"
+#include "src/xpub_hdkey.hpp"
+
+using namespace ga::sdk;
+
+// Count heap allocations made by the whole process
+static std::atomic<uint64_t> g_num_allocs{ 0 };
+static std::atomic<uint64_t> g_alloc_bytes{ 0 };
+
+void* operator new(std::size_t size)
+{
+    g_num_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+    struct options {
+        size_t num_txs = 1000;
+        size_t num_utxos = 1000;
+        size_t cache_mb = 50;
+        size_t num_sessions = 10;
+        std::chrono::milliseconds min_time{ 200 };
+        std::string filter;
+    };
+
+    static size_t get_size_arg(int argc, char** argv, int i)
+    {
+        GDK_RUNTIME_ASSERT_MSG(i < argc, std::string("missing value for ") + argv[i - 1]);
+        return std::strtoul(argv[i], nullptr, 10);
+    }
+
+    static options parse_options(int argc, char** argv)
+    {
+        options opts;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--txs") {
+                opts.num_txs = get_size_arg(argc, argv, ++i);
+            } else if (arg == "--utxos") {
+                opts.num_utxos = get_size_arg(argc, argv, ++i);
+            } else if (arg == "--cache-mb") {
+                opts.cache_mb = get_size_arg(argc, argv, ++i);
+            } else if (arg == "--sessions") {
+                opts.num_sessions = get_size_arg(argc, argv, ++i);
+            } else if (arg == "--min-time-ms") {
+                opts.min_time = std::chrono::milliseconds(get_size_arg(argc, argv, ++i));
+            } else if (arg == "--filter") {
+                GDK_RUNTIME_ASSERT_MSG(++i < argc, "missing value for --filter");
+                opts.filter = argv[i];
+            } else {
+                GDK_RUNTIME_ASSERT_MSG(false, "unknown argument " + arg);
+            }
+        }
+        GDK_RUNTIME_ASSERT_MSG(
+            opts.num_txs && opts.num_utxos && opts.cache_mb && opts.num_sessions, "sizes must be non-zero");
+        return opts;
+    }
+
+    // Run fn, which performs ops_per_call operations, until at least
+    // min_time has elapsed, and record the per-operation costs
+    template <typename FN>
+    static void run_bench(const options& opts, nlohmann::json& results, const std::string& name, size_t ops_per_call,
+        FN&& fn)
+    {
+        if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos) {
+            return;
+        }
+        fn(); // Warm up
+        const uint64_t allocs_start = g_num_allocs.load();
+        const uint64_t bytes_start = g_alloc_bytes.load();
+        const auto start = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::steady_clock::duration::zero();
+        size_t calls = 0;
+        do {
+            fn();
+            ++calls;
+            elapsed = std::chrono::steady_clock::now() - start;
+        } while (elapsed < opts.min_time);
+
+        const double ops = static_cast<double>(calls * ops_per_call);
+        const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        results.push_back({ { "name", name }, { "ops", calls * ops_per_call }, { "ns_per_op", ns / ops },
+            { "ops_per_sec", ops * 1e9 / ns }, { "allocs_per_op", (g_num_allocs.load() - allocs_start) / ops },
+            { "alloc_bytes_per_op", (g_alloc_bytes.load() - bytes_start) / ops } });
+    }
+
+    // Return a value in kB or a count from /proc/self/status, or 0 if unavailable
+    static size_t get_process_status(const std::string& name)
+    {
+        std::ifstream f("/proc/self/status");
+        std::string line;
+        while (std::getline(f, line)) {
+            if (line.compare(0, name.size(), name) == 0 && line.size() > name.size() && line[name.size()] == ':') {
+                return std::strtoul(line.c_str() + name.size() + 1, nullptr, 10);
+            }
+        }
+        return 0;
+    }
+
+    // Record the threads, resident memory and heap allocations added by
+    // opening sessions which are never connected
+    static void run_idle_session_bench(const options& opts, nlohmann::json& results, const std::string& name)
+    {
+        if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos) {
+            return;
+        }
+        const nlohmann::json net_params = { { "name", "testnet" } };
+        const size_t threads_start = get_process_status("Threads");
+        const size_t rss_start = get_process_status("VmRSS");
+        const uint64_t bytes_start = g_alloc_bytes.load();
+        std::vector<std::shared_ptr<session_impl>> sessions;
+        for (size_t i = 0; i < opts.num_sessions; ++i) {
+            sessions.emplace_back(session_impl::create(net_params));
+        }
+        const double num_sessions = static_cast<double>(opts.num_sessions);
+        results.push_back({ { "name", name }, { "sessions", opts.num_sessions },
+            { "threads_per_session", (get_process_status("Threads") - threads_start) / num_sessions },
+            { "rss_kb_per_session", (get_process_status("VmRSS") - rss_start) / num_sessions },
+            { "alloc_bytes_per_session", (g_alloc_bytes.load() - bytes_start) / num_sessions } });
+        for (auto& session : sessions) {
+            session->disconnect();
+        }
+    }
+
+    static std::string random_hex(size_t len)
+    {
+        std::vector<unsigned char> bytes(len);
+        get_random_bytes(len, bytes.data(), bytes.size());
+        return b2h(bytes);
+    }
+
+    // A synthetic cached transaction, shaped like those the server returns
+    static nlohmann::json make_tx(size_t i)
+    {
+        const std::string address = "2N" + random_hex(16);
+        nlohmann::json input = { { "address", address }, { "is_relevant", false }, { "satoshi", 20000 + i },
+            { "pt_idx", 0 }, { "script_type", 14 } };
+        nlohmann::json output = { { "address", address }, { "is_relevant", true }, { "satoshi", 10000 + i },
+            { "pt_idx", i % 2 }, { "pointer", i }, { "subaccount", 0 }, { "script_type", 14 } };
+        return { { "block_height", 100000 + i }, { "created_at_ts", 1600000000000000ull + i * 1000000 },
+            { "fee", 226 }, { "fee_rate", 1000 }, { "inputs", { input } }, { "memo", std::string() },
+            { "outputs", { output, output } }, { "transaction_vsize", 226 }, { "transaction_weight", 904 },
+            { "txhash", random_hex(32) }, { "type", "incoming" } };
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const options opts = parse_options(argc, argv);
+
+    nlohmann::json init_config;
+    init_config["datadir"] = ".";
+    init_config["log_level"] = "none";
+    init(init_config);
+
+    nlohmann::json results = nlohmann::json::array();
+
+    // Transaction cache
+    {
+        auto defaults = network_parameters::get("testnet");
+        network_parameters net_params{ nlohmann::json::object(), defaults };
+        cache c(net_params, "testnet");
+
+        std::vector<nlohmann::json> txs;
+        txs.reserve(opts.num_txs);
+        for (size_t i = 0; i < opts.num_txs; ++i) {
+            txs.emplace_back(make_tx(i));
+        }
+        std::vector<cache::transaction_row> rows;
+        for (const auto& tx : txs) {
+            rows.push_back({ tx.at("created_at_ts"), tx.at("txhash"), &tx });
+        }
+
+        run_bench(opts, results, "cache_insert_transactions", rows.size(), [&] { c.insert_transactions(0, rows); });
+
+        constexpr size_t PAGE_SIZE = 30;
+        size_t num_fetched = 0;
+        auto&& count_tx
+            = [&num_fetched](uint64_t, const std::string&, uint32_t, uint32_t, uint32_t, nlohmann::json&) {
+                  ++num_fetched;
+              };
+        run_bench(opts, results, "cache_get_transactions_first_page", PAGE_SIZE,
+            [&] { c.get_transactions(0, 0, PAGE_SIZE, count_tx); });
+        run_bench(opts, results, "cache_get_transactions_all_pages", opts.num_txs, [&] {
+            num_fetched = 0;
+            for (size_t start = 0; start < opts.num_txs; start += PAGE_SIZE) {
+                c.get_transactions(0, start, PAGE_SIZE, count_tx);
+            }
+            GDK_RUNTIME_ASSERT(num_fetched == opts.num_txs);
+        });
+
+        // Decoding the cached rows as stored previously (JSON text) and now
+        // (msgpack), the per-row cost that get_transactions pays
+        std::vector<std::string> text_rows;
+        std::vector<std::vector<uint8_t>> msgpack_rows;
+        for (const auto& tx : txs) {
+            text_rows.emplace_back(tx.dump());
+            msgpack_rows.emplace_back(nlohmann::json::to_msgpack(tx));
+        }
+        run_bench(opts, results, "cache_tx_rows_parse_text", text_rows.size(), [&] {
+            for (const auto& row : text_rows) {
+                num_fetched += nlohmann::json::parse(row).size();
+            }
+        });
+        run_bench(opts, results, "cache_tx_rows_parse_msgpack", msgpack_rows.size(), [&] {
+            for (const auto& row : msgpack_rows) {
+                num_fetched += nlohmann::json::from_msgpack(row).size();
+            }
+        });
+
+        // JSON field access over the tx list, by key and by pre-parsed path
+        const json_path height_path("/block_height");
+        const json_path satoshi_path("/outputs/0/satoshi");
+        uint64_t total = 0;
+        run_bench(opts, results, "json_at_tx_fields", txs.size(), [&] {
+            for (const auto& tx : txs) {
+                total += tx.at("block_height").get<uint64_t>();
+                total += tx.at("outputs").at(0).at("satoshi").get<uint64_t>();
+            }
+        });
+        run_bench(opts, results, "json_path_tx_fields", txs.size(), [&] {
+            for (const auto& tx : txs) {
+                total += height_path.get_value<uint64_t>(tx, 0);
+                total += satoshi_path.get_value<uint64_t>(tx, 0);
+            }
+        });
+        GDK_RUNTIME_ASSERT(total != 0);
+    }
+
+    // Startup time for loading a cache of --cache-mb from disk
+    {
+        auto defaults = network_parameters::get("testnet");
+        network_parameters net_params{ nlohmann::json::object(), defaults };
+        const nlohmann::json credentials = { { "username", "gdk_bench" }, { "password", "gdk_bench" } };
+        auto wo_signer = std::make_shared<signer>(net_params, nlohmann::json::object(), credentials);
+        const auto key = get_random_bytes<32>();
+        {
+            cache c(net_params, "testnet");
+            c.load_db(key, wo_signer);
+            constexpr size_t TX_DATA_LEN = 16 * 1024;
+            std::vector<unsigned char> tx_data(TX_DATA_LEN);
+            for (size_t i = 0; i < opts.cache_mb * 1024 * 1024 / TX_DATA_LEN; ++i) {
+                get_random_bytes(tx_data.size(), tx_data.data(), tx_data.size());
+                c.insert_transaction_data(random_hex(32), tx_data);
+            }
+            c.flush();
+        }
+        run_bench(opts, results, "cache_load_db", 1, [&] {
+            cache c(net_params, "testnet");
+            c.load_db(key, wo_signer);
+        });
+    }
+
+    // Export of a tx list result, as done by the language bindings.
+    // Run with e.g. --txs 5000 for a large wallet
+    {
+        nlohmann::json result = { { "transactions", nlohmann::json::array() } };
+        for (size_t i = 0; i < opts.num_txs; ++i) {
+            result["transactions"].push_back(make_tx(i));
+        }
+        run_bench(opts, results, "export_tx_list_string", opts.num_txs, [&] { result.dump(); });
+        run_bench(opts, results, "export_tx_list_msgpack", opts.num_txs, [&] { nlohmann::json::to_msgpack(result); });
+    }
+
+    // Returning singlesig results from the Rust session, as a JSON string
+    // or as the CBOR envelope used for large results. Each round trip
+    // encodes the result as the Rust side does, then decodes it
+    {
+        nlohmann::json txs_result = { { "transactions", nlohmann::json::array() } };
+        for (size_t i = 0; i < opts.num_txs; ++i) {
+            txs_result["transactions"].push_back(make_tx(i));
+        }
+        nlohmann::json utxos_result = { { "unspent_outputs", { { "btc", nlohmann::json::array() } } } };
+        for (size_t i = 0; i < opts.num_utxos; ++i) {
+            utxos_result["unspent_outputs"]["btc"].push_back({ { "txhash", random_hex(32) }, { "pt_idx", i % 4 },
+                { "satoshi", 1000 + i }, { "block_height", 100000 + i }, { "address_type", "p2wpkh" },
+                { "subaccount", 0 }, { "pointer", i }, { "is_internal", false }, { "user_status", 0 },
+                { "public_key", random_hex(33) }, { "prevout_script", "0014" + random_hex(20) } });
+        }
+        auto&& bench_envelopes = [&](const std::string& method, const nlohmann::json& result, size_t num_items) {
+            run_bench(opts, results, "rust_" + method + "_json_string", num_items,
+                [&] { nlohmann::json::parse(result.dump()); });
+            run_bench(opts, results, "rust_" + method + "_cbor", num_items,
+                [&] { nlohmann::json::from_cbor(nlohmann::json::to_cbor(result)); });
+        };
+        bench_envelopes("get_transactions", txs_result, opts.num_txs);
+        bench_envelopes("get_unspent_outputs", utxos_result, opts.num_utxos);
+    }
+
+    // Decoding a page of transactions from a WAMP call result
+    {
+        nlohmann::json page = { { "list", nlohmann::json::array() }, { "more", true } };
+        for (size_t i = 0; i < opts.num_txs; ++i) {
+            page["list"].push_back(make_tx(i));
+        }
+        const auto packed = nlohmann::json::to_msgpack(page);
+        const auto handle = msgpack::unpack(reinterpret_cast<const char*>(packed.data()), packed.size());
+        const msgpack::object& obj = handle.get();
+        run_bench(opts, results, "wamp_cast_json_repack", opts.num_txs, [&] {
+            msgpack::sbuffer sbuf;
+            msgpack::pack(sbuf, obj);
+            nlohmann::json::from_msgpack(sbuf.data(), sbuf.data() + sbuf.size());
+        });
+        run_bench(opts, results, "wamp_cast_json", opts.num_txs, [&] { wamp_cast_json(obj); });
+    }
+
+    // Addressee parsing for a 1000 output payout, done serially and spread
+    // over the thread pool as create_transaction does. Half the addressees
+    // are BIP21 URIs. Each run parses a fresh copy of the addressees
+    {
+        constexpr size_t NUM_ADDRESSEES = 1000;
+        auto defaults = network_parameters::get("testnet");
+        network_parameters net_params{ nlohmann::json::object(), defaults };
+        nlohmann::json addressees = nlohmann::json::array();
+        for (size_t i = 0; i < NUM_ADDRESSEES; ++i) {
+            auto address = get_address_from_scriptpubkey(net_params, h2b("0014" + random_hex(20)));
+            if (i % 2) {
+                address = net_params.bip21_prefix() + ":" + address + "?amount=0.001";
+            }
+            addressees.push_back({ { "address", std::move(address) }, { "satoshi", 1000 + i } });
+        }
+        auto&& parse_addressees = [&](nlohmann::json& batch, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                GDK_RUNTIME_ASSERT(parse_tx_addressee(net_params, batch[i]).empty());
+            }
+        };
+        run_bench(opts, results, "parse_tx_addressees_serial", NUM_ADDRESSEES, [&] {
+            nlohmann::json batch = addressees;
+            parse_addressees(batch, 0, NUM_ADDRESSEES);
+        });
+        run_bench(opts, results, "parse_tx_addressees_parallel", NUM_ADDRESSEES, [&] {
+            nlohmann::json batch = addressees;
+            parallel_for_chunks(
+                NUM_ADDRESSEES, 32, 8, [&](size_t begin, size_t end) { parse_addressees(batch, begin, end); });
+        });
+    }
+
+    // Coin selection, the variable cost of building a transaction
+    {
+        std::vector<coin_selection_utxo> utxos;
+        amount::value_type total = 0;
+        for (size_t i = 0; i < opts.num_utxos; ++i) {
+            const amount::value_type value = 1000 + (i * 7919) % 1000000;
+            utxos.push_back({ value, 272 });
+            total += value;
+        }
+        const amount::value_type target = total / 3;
+        run_bench(opts, results, "select_coins_bnb", 1, [&] { select_coins_bnb(utxos, target, 2000, 1000); });
+        run_bench(opts, results, "select_coins_knapsack", 1, [&] { select_coins_knapsack(utxos, target, 1000); });
+    }
+
+    // Footprint of cached Liquid UTXOs, measured as the bytes allocated
+    // to copy them. UTXOs we fail to unblind have their proofs removed
+    {
+        nlohmann::json utxos = nlohmann::json::array();
+        for (size_t i = 0; i < opts.num_utxos; ++i) {
+            utxos.push_back({ { "txhash", random_hex(32) }, { "pt_idx", i % 4 }, { "error", "failed to unblind utxo" },
+                { "commitment", random_hex(33) }, { "nonce_commitment", random_hex(33) },
+                { "asset_tag", random_hex(33) }, { "script", "0014" + random_hex(20) },
+                { "range_proof", random_hex(4174) }, { "surj_proof", random_hex(67) } });
+        }
+        run_bench(opts, results, "liquid_utxos_copy_with_proofs", utxos.size(), [&] { nlohmann::json copy(utxos); });
+        for (auto& utxo : utxos) {
+            utxo.erase("range_proof");
+            utxo.erase("surj_proof");
+        }
+        run_bench(opts, results, "liquid_utxos_copy_stripped", utxos.size(), [&] { nlohmann::json copy(utxos); });
+    }
+
+    // Public key derivation
+    {
+        const auto private_key = get_random_bytes<EC_PRIVATE_KEY_LEN>();
+        const auto public_key = ec_public_key_from_private_key(private_key);
+        xpub_hdkey hdkey(false, make_xpub(random_hex(32), b2h(public_key)));
+        constexpr uint32_t NUM_DERIVES = 100;
+        run_bench(opts, results, "xpub_hdkey_derive", NUM_DERIVES, [&] {
+            for (uint32_t i = 0; i < NUM_DERIVES; ++i) {
+                const std::array<uint32_t, 2> path{ { 1, i } };
+                hdkey.derive(path);
+            }
+        });
+    }
+
+    // Encryption, as used for the cache and client blob
+    {
+        const auto key = get_random_bytes<32>();
+        for (const size_t size : { 64u, 16384u, 1048576u }) {
+            std::vector<unsigned char> plaintext(size);
+            get_random_bytes(size, plaintext.data(), plaintext.size());
+            std::vector<unsigned char> cyphertext(aes_gcm_encrypt_get_length(plaintext));
+            const auto suffix = "_" + std::to_string(size);
+            run_bench(opts, results, "aes_gcm_encrypt" + suffix, 1,
+                [&] { aes_gcm_encrypt(key, plaintext, cyphertext); });
+            std::vector<unsigned char> decrypted(aes_gcm_decrypt_get_length(cyphertext));
+            run_bench(opts, results, "aes_gcm_decrypt" + suffix, 1,
+                [&] { aes_gcm_decrypt(key, cyphertext, decrypted); });
+        }
+    }
+
+    // Compression of msgpack data shaped like a client blob holding tx memos
+    {
+        nlohmann::json blob = nlohmann::json::array({ 1, nlohmann::json::object(), nlohmann::json::object() });
+        for (size_t i = 0; i < opts.num_txs; ++i) {
+            blob[2][random_hex(32)] = "memo " + std::to_string(i);
+        }
+        const auto msgpack_data = nlohmann::json::to_msgpack(blob);
+        const std::array<unsigned char, 4> prefix{ 1, 0, 0, 0 };
+        for (const int level : { 9, 6, 1 }) {
+            run_bench(opts, results, "compress_level_" + std::to_string(level), 1,
+                [&] { compress(prefix, msgpack_data, level); });
+        }
+        const auto compressed = compress(prefix, msgpack_data);
+        const auto compressed_data = gsl::make_span(compressed).subspan(prefix.size());
+        run_bench(opts, results, "decompress_then_parse_msgpack", 1, [&] {
+            const auto decompressed = decompress(compressed_data);
+            nlohmann::json::from_msgpack(decompressed.begin(), decompressed.end());
+        });
+        run_bench(opts, results, "decompress_msgpack", 1, [&] { decompress_msgpack(compressed_data); });
+    }
+
+    // Hex conversion: txids and raw transactions
+    {
+        const auto txid = get_random_bytes<32>();
+        const auto txid_hex = b2h_rev(txid);
+        std::vector<unsigned char> raw_tx(1000);
+        get_random_bytes(raw_tx.size(), raw_tx.data(), raw_tx.size());
+        const auto raw_tx_hex = b2h(raw_tx);
+        std::vector<char> hex_out(raw_tx.size() * 2);
+        std::vector<unsigned char> bytes_out(raw_tx.size());
+
+        run_bench(opts, results, "b2h_rev_txid", 1, [&] { b2h_rev(txid); });
+        run_bench(opts, results, "h2b_rev_txid", 1, [&] { h2b_rev<32>(txid_hex); });
+        run_bench(opts, results, "b2h_1000", 1, [&] { b2h(raw_tx); });
+        run_bench(opts, results, "b2h_1000_into", 1, [&] { b2h(raw_tx, hex_out); });
+        run_bench(opts, results, "b2h_1000_wally", 1, [&] {
+            char* hex;
+            GDK_VERIFY(wally_hex_from_bytes(raw_tx.data(), raw_tx.size(), &hex));
+            wally_free_string(hex);
+        });
+        run_bench(opts, results, "h2b_1000", 1, [&] { h2b(raw_tx_hex); });
+        run_bench(opts, results, "h2b_1000_into", 1, [&] { h2b(raw_tx_hex, bytes_out); });
+        run_bench(opts, results, "h2b_1000_wally", 1, [&] {
+            size_t written;
+            GDK_VERIFY(wally_hex_to_bytes(raw_tx_hex.c_str(), bytes_out.data(), bytes_out.size(), &written));
+        });
+    }
+
+    // Amount conversion
+    {
+        const nlohmann::json satoshi = { { "satoshi", 123456789 } };
+        const nlohmann::json fiat = { { "fiat", "1234.56" } };
+        run_bench(opts, results, "amount_convert_satoshi", 1, [&] { amount::convert(satoshi, "USD", "25000.12"); });
+        run_bench(opts, results, "amount_convert_fiat", 1, [&] { amount::convert(fiat, "USD", "25000.12"); });
+
+        constexpr size_t NUM_AMOUNTS = 1000;
+        std::vector<amount::signed_value_type> values(NUM_AMOUNTS);
+        for (size_t i = 0; i < NUM_AMOUNTS; ++i) {
+            values[i] = static_cast<amount::signed_value_type>(i * 123457);
+        }
+        std::vector<char> output(NUM_AMOUNTS * amount::str_len);
+        run_bench(opts, results, "amount_convert_btc_json_x1000", 1, [&] {
+            for (const auto v : values) {
+                amount::convert({ { "satoshi", v } }, "USD", "25000.12");
+            }
+        });
+        run_bench(opts, results, "amount_convert_btc_bulk_x1000", 1,
+            [&] { amount::convert(values.data(), values.size(), "btc", std::string(), output.data()); });
+        run_bench(opts, results, "amount_convert_fiat_bulk_x1000", 1,
+            [&] { amount::convert(values.data(), values.size(), "fiat", "25000.12", output.data()); });
+    }
+
+    // Liquid output unblinding
+    {
+        const auto blinding_key = get_random_bytes<EC_PRIVATE_KEY_LEN>();
+        const auto blinding_pubkey = ec_public_key_from_private_key(blinding_key);
+        const auto ephemeral_key = get_random_bytes<EC_PRIVATE_KEY_LEN>();
+        const auto ephemeral_pubkey = ec_public_key_from_private_key(ephemeral_key);
+        const auto asset = get_random_bytes<ASSET_TAG_LEN>();
+        const auto abf = get_random_bytes<32>();
+        const auto vbf = get_random_bytes<32>();
+        const auto script = h2b("0014" + random_hex(20));
+        const uint64_t value = 123456789;
+        const auto generator = asset_generator_from_bytes(asset, abf);
+        const auto commitment = asset_value_commitment(value, vbf, generator);
+        const auto rangeproof = asset_rangeproof(
+            value, blinding_pubkey, ephemeral_key, asset, abf, vbf, commitment, script, generator);
+        run_bench(opts, results, "asset_unblind", 1, [&] {
+            const auto unblinded
+                = asset_unblind(blinding_key, rangeproof, commitment, ephemeral_pubkey, script, generator);
+            GDK_RUNTIME_ASSERT(std::get<3>(unblinded) == value);
+        });
+
+        // Blinding proofs for a multi-output payout, generated serially
+        // and spread over the thread pool as blind_ga_transaction does
+        constexpr size_t NUM_OUTPUTS = 20;
+        const std::vector<unsigned char> assets(asset.begin(), asset.end());
+        const std::vector<unsigned char> abfs(abf.begin(), abf.end());
+        const std::vector<unsigned char> generators(generator.begin(), generator.end());
+        const auto entropy = get_random_bytes<32>();
+        auto&& make_proofs = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                asset_rangeproof(value, blinding_pubkey, ephemeral_key, asset, abf, vbf, commitment, script, generator);
+                asset_surjectionproof(asset, abf, generator, entropy, assets, abfs, generators);
+            }
+        };
+        run_bench(opts, results, "asset_blind_outputs_serial", NUM_OUTPUTS, [&] { make_proofs(0, NUM_OUTPUTS); });
+        run_bench(opts, results, "asset_blind_outputs_parallel", NUM_OUTPUTS,
+            [&] { parallel_for_chunks(NUM_OUTPUTS, 1, 8, make_proofs); });
+    }
+
+    // Idle sessions, each with its own I/O threads and then sharing two
+    run_idle_session_bench(opts, results, "idle_session");
+    init_io_context_pool(2);
+    run_idle_session_bench(opts, results, "idle_session_shared_io");
+
+    const nlohmann::json output = { { "config",
+                                        { { "txs", opts.num_txs }, { "utxos", opts.num_utxos },
+                                            { "sessions", opts.num_sessions },
+                                            { "min_time_ms", opts.min_time.count() } } },
+        { "benchmarks", std::move(results) } };
+    std::cout << output.dump(4) << std::endl;
+    return 0;
+}
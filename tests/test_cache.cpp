@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "sqlite3.h"
+#include "src/assertion.hpp"
+#include "src/ga_cache.hpp"
+#include "src/memory.hpp"
+#include "src/network_parameters.hpp"
+#include "src/session.hpp"
+#include "src/signer.hpp"
+#include "src/utils.hpp"
+
+using namespace ga::sdk;
+
+// Verify the tx cache is saved to and loaded from disk correctly
+
+namespace {
+    namespace fs = std::filesystem;
+
+    const std::string DATA_DIR = "test_cache_data";
+    // Magic, page size, page count and HMAC
+    constexpr size_t CACHE_HEADER_LEN = 8 + 4 + 4 + 32;
+
+    static fs::path get_cache_file()
+    {
+        for (const auto& entry : fs::directory_iterator(DATA_DIR)) {
+            if (entry.path().extension() == ".sqliteaesgcm") {
+                return entry.path();
+            }
+        }
+        GDK_RUNTIME_ASSERT_MSG(false, "cache file not found");
+        return fs::path();
+    }
+
+    static std::vector<char> read_file(const fs::path& path)
+    {
+        std::ifstream f(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+
+    static void write_file(const fs::path& path, const std::vector<char>& data)
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f.write(data.data(), data.size());
+    }
+
+    static std::string get_txhash(size_t i) { return std::string(64, "0123456789abcdef"[i]); }
+
+    static bool has_tx_data(cache& c, size_t i)
+    {
+        bool found = false;
+        c.get_transaction_data(get_txhash(i), { [&found, i](const auto& db_blob) {
+            found = db_blob && db_blob->size() == 8192 && (*db_blob)[0] == i;
+        } });
+        return found;
+    }
+
+    static uint32_t get_spv_status(cache& c, size_t i)
+    {
+        uint32_t status = 0;
+        c.get_transaction(0, get_txhash(i),
+            { [&status](uint64_t, const std::string&, uint32_t, uint32_t, uint32_t spv_status, nlohmann::json&) {
+                status = spv_status;
+            } });
+        return status;
+    }
+
+    static void insert_tx_data(cache& c, size_t i)
+    {
+        const std::vector<unsigned char> tx_data(8192, static_cast<unsigned char>(i));
+        c.insert_transaction_data(get_txhash(i), tx_data);
+        c.flush();
+    }
+
+    // A tx with an output to address_<i> and a balance change of i * 1000
+    static nlohmann::json make_tx_json(size_t i)
+    {
+        return { { "block_height", 100 + i }, { "satoshi", { { "btc", i * 1000 } } },
+            { "outputs", { { { "address", "address_" + std::to_string(i) } } } } };
+    }
+
+    static std::vector<std::string> search(cache& c, const cache::transaction_search& criteria)
+    {
+        std::vector<std::string> txhashes;
+        c.search_transactions(0, criteria, std::nullopt, 0, 100,
+            { [&txhashes](uint64_t, const std::string& txhash, uint32_t, uint32_t, uint32_t, nlohmann::json&) {
+                txhashes.push_back(txhash);
+            } });
+        return txhashes;
+    }
+
+    // The schema of the current cache version, in the order it is created
+    const std::vector<std::string> SCHEMA = {
+        "CREATE TABLE LiquidOutput(txid BLOB NOT NULL, vout INTEGER NOT NULL, assetid BLOB NOT NULL, "
+        "satoshi INTEGER NOT NULL, abf BLOB NOT NULL, vbf BLOB NOT NULL, PRIMARY KEY (txid, vout));",
+        "CREATE TABLE KeyValue(key BLOB NOT NULL, value BLOB NOT NULL, PRIMARY KEY(key));",
+        "CREATE TABLE LiquidBlindingPubKey(script BLOB NOT NULL, pubkey BLOB NOT NULL, PRIMARY KEY(script));",
+        "CREATE TABLE LiquidBlindingNonce(pubkey BLOB NOT NULL, script BLOB NOT NULL, nonce BLOB NOT NULL, "
+        "PRIMARY KEY(pubkey, script));",
+        "CREATE TABLE Tx(subaccount INTEGER NOT NULL, timestamp INTEGER NOT NULL, txid BLOB NOT NULL, "
+        "block INTEGER NOT NULL, spent INTEGER NOT NULL, spv_status INTEGER NOT NULL, data BLOB NOT NULL, "
+        "PRIMARY KEY(subaccount, timestamp));",
+        "CREATE TABLE TxData(txid BLOB NOT NULL, rawtx BLOB NOT NULL, PRIMARY KEY(txid));",
+        "CREATE TABLE TxAsset(subaccount INTEGER NOT NULL, timestamp INTEGER NOT NULL, asset BLOB NOT NULL, "
+        "satoshi INTEGER NOT NULL, PRIMARY KEY(subaccount, timestamp, asset));",
+        "CREATE INDEX TxAssetSatoshi ON TxAsset(subaccount, asset, satoshi);",
+        "CREATE TABLE TxAddress(subaccount INTEGER NOT NULL, timestamp INTEGER NOT NULL, address BLOB NOT NULL, "
+        "PRIMARY KEY(subaccount, address, timestamp));",
+        "CREATE TABLE ScriptPubKey(scriptpubkey BLOB NOT NULL, subaccount INTEGER NOT NULL, branch INTEGER NOT NULL, "
+        "pointer INTEGER NOT NULL, subtype INTEGER NOT NULL, script_type INTEGER NOT NULL, "
+        "PRIMARY KEY(scriptpubkey), UNIQUE(subaccount, pointer DESC));",
+    };
+
+    // Write a cache file in the legacy single blob format, holding a DB
+    // created by executing 'sql'. txs are inserted without search data
+    static void write_legacy_cache_file(const fs::path& path, byte_span_t encryption_key,
+        const std::vector<std::string>& sql, uint32_t minor_version, const std::vector<size_t>& txs)
+    {
+        sqlite3* db = nullptr;
+        GDK_RUNTIME_ASSERT(sqlite3_open(":memory:", &db) == SQLITE_OK);
+        const auto _close_db = gsl::finally([db] { sqlite3_close(db); });
+        auto statements = sql;
+        const std::string version_hex = b2h(std::vector<unsigned char>{ 0, static_cast<unsigned char>(minor_version) });
+        statements.push_back("INSERT INTO KeyValue VALUES (X'" + b2h(ustring_span("minor_version")) + "', X'"
+            + version_hex + "');");
+        for (const auto i : txs) {
+            const auto tx_json = make_tx_json(i);
+            statements.push_back("INSERT INTO Tx VALUES (0, " + std::to_string(1000 + i) + ", X'" + get_txhash(i)
+                + "', " + std::to_string(100 + i) + ", 0, 3, X'" + b2h(nlohmann::json::to_msgpack(tx_json)) + "');");
+        }
+        for (const auto& statement : statements) {
+            GDK_RUNTIME_ASSERT_MSG(sqlite3_exec(db, statement.c_str(), 0, 0, 0) == SQLITE_OK, statement);
+        }
+        sqlite3_int64 db_size;
+        unsigned char* db_data = sqlite3_serialize(db, "main", &db_size, 0);
+        GDK_RUNTIME_ASSERT(db_data != nullptr);
+        const auto _free_data = gsl::finally([db_data] { sqlite3_free(db_data); });
+        const auto plaintext = gsl::make_span(db_data, db_size);
+        std::vector<unsigned char> cyphertext(aes_gcm_encrypt_get_length(plaintext));
+        aes_gcm_encrypt(sha256(encryption_key), plaintext, cyphertext);
+        write_file(path, std::vector<char>(cyphertext.begin(), cyphertext.end()));
+    }
+
+    // Create a cache file for encryption_key, then replace it with a
+    // cache in the legacy format, ready to be loaded
+    static void write_legacy_cache(const network_parameters& net_params, byte_span_t encryption_key,
+        std::shared_ptr<signer> signer, const std::vector<std::string>& sql, uint32_t minor_version,
+        const std::vector<size_t>& txs)
+    {
+        fs::path path;
+        {
+            cache c(net_params, "testnet");
+            c.load_db(encryption_key, signer);
+            insert_tx_data(c, 0);
+            path = get_cache_file();
+        }
+        write_legacy_cache_file(path, encryption_key, sql, minor_version, txs);
+    }
+
+    static uint32_t get_minor_version(cache& c)
+    {
+        uint32_t ver = 0;
+        c.get_key_value("minor_version", { [&ver](const auto& db_blob) {
+            if (db_blob) {
+                ver = ((*db_blob)[0] << 8) | (*db_blob)[1];
+            }
+        } });
+        return ver;
+    }
+} // namespace
+
+int main()
+{
+    fs::remove_all(DATA_DIR);
+    fs::create_directories(DATA_DIR);
+
+    nlohmann::json init_config;
+    init_config["datadir"] = DATA_DIR;
+    init_config["log_level"] = "none";
+    init_config["cache_flush_interval_ms"] = 0;
+    init(init_config);
+
+    auto defaults = network_parameters::get("testnet");
+    network_parameters net_params{ nlohmann::json::object(), defaults };
+    const nlohmann::json credentials = { { "username", "test_cache" }, { "password", "test_cache" } };
+    auto wo_signer = std::make_shared<signer>(net_params, nlohmann::json::object(), credentials);
+    const auto key = get_random_bytes<32>();
+
+    {
+        // Re-upserting a tx keeps its SPV status unless its block changes
+        cache c(net_params, "testnet");
+        nlohmann::json tx_json = { { "block_height", 100 } };
+        c.insert_transaction(0, 1000, get_txhash(3), tx_json);
+        GDK_RUNTIME_ASSERT(get_spv_status(c, 3) == 3); // SPV_STATUS_DISABLED
+        c.set_transaction_spv_verified(get_txhash(3));
+        GDK_RUNTIME_ASSERT(get_spv_status(c, 3) == 1); // SPV_STATUS_VERIFIED
+        c.insert_transaction(0, 1000, get_txhash(3), tx_json);
+        GDK_RUNTIME_ASSERT(get_spv_status(c, 3) == 1);
+        tx_json["block_height"] = 101;
+        c.insert_transaction(0, 1000, get_txhash(3), tx_json);
+        GDK_RUNTIME_ASSERT(get_spv_status(c, 3) == 3);
+    }
+
+    {
+        cache c(net_params, "testnet");
+        c.load_db(key, wo_signer);
+        insert_tx_data(c, 1);
+    }
+    const auto cache_file = get_cache_file();
+    const auto saved = read_file(cache_file);
+
+    // Changes are saved in place, and loaded back
+    {
+        cache c(net_params, "testnet");
+        c.load_db(key, wo_signer);
+        GDK_RUNTIME_ASSERT(has_tx_data(c, 1));
+        insert_tx_data(c, 2);
+    }
+    const auto updated = read_file(cache_file);
+    GDK_RUNTIME_ASSERT(updated.size() > saved.size());
+    {
+        cache c(net_params, "testnet");
+        c.load_db(key, wo_signer);
+        GDK_RUNTIME_ASSERT(has_tx_data(c, 1) && has_tx_data(c, 2));
+    }
+
+    // A save interrupted before writing its header leaves new pages with
+    // the previous header. The file must be rejected and the cache reset
+    auto torn = updated;
+    std::copy(saved.begin(), saved.begin() + CACHE_HEADER_LEN, torn.begin());
+    write_file(cache_file, torn);
+    {
+        cache c(net_params, "testnet");
+        c.load_db(key, wo_signer);
+        GDK_RUNTIME_ASSERT(!has_tx_data(c, 1) && !has_tx_data(c, 2));
+    }
+
+    {
+        // Search by address, balance change and block height
+        cache c(net_params, "testnet");
+        for (size_t i = 1; i <= 5; ++i) {
+            c.insert_transaction(0, 1000 + i, get_txhash(i), make_tx_json(i));
+        }
+        cache::transaction_search criteria;
+        criteria.address = "address_2";
+        GDK_RUNTIME_ASSERT(search(c, criteria) == std::vector<std::string>{ get_txhash(2) });
+        criteria = {};
+        criteria.asset_id = "btc";
+        criteria.min_satoshi = 4000;
+        GDK_RUNTIME_ASSERT(search(c, criteria) == (std::vector<std::string>{ get_txhash(5), get_txhash(4) }));
+        criteria = {};
+        criteria.min_block = 102;
+        criteria.max_block = 103;
+        GDK_RUNTIME_ASSERT(search(c, criteria) == (std::vector<std::string>{ get_txhash(3), get_txhash(2) }));
+
+        // Searching more txids than sqlite allows as bound parameters
+        criteria = {};
+        criteria.txhashes = std::vector<std::string>();
+        for (size_t i = 0; i < 40000; ++i) {
+            criteria.txhashes->push_back(b2h(get_random_bytes<32>()));
+        }
+        criteria.txhashes->push_back(get_txhash(3));
+        GDK_RUNTIME_ASSERT(search(c, criteria) == std::vector<std::string>{ get_txhash(3) });
+        // The searched txids are not retained between searches
+        criteria.txhashes = std::vector<std::string>{ get_txhash(4) };
+        GDK_RUNTIME_ASSERT(search(c, criteria) == std::vector<std::string>{ get_txhash(4) });
+    }
+
+    {
+        // Updating a v4 cache populates the search data of its txs
+        fs::remove_all(DATA_DIR);
+        fs::create_directories(DATA_DIR);
+        const auto v4_key = get_random_bytes<32>();
+        write_legacy_cache(net_params, v4_key, wo_signer, SCHEMA, 4, { 1, 2 });
+        cache c(net_params, "testnet");
+        c.load_db(v4_key, wo_signer);
+        cache::transaction_search criteria;
+        criteria.address = "address_2";
+        GDK_RUNTIME_ASSERT(search(c, criteria).empty());
+        c.update_to_latest_minor_version();
+        GDK_RUNTIME_ASSERT(get_minor_version(c) == 5);
+        GDK_RUNTIME_ASSERT(search(c, criteria) == std::vector<std::string>{ get_txhash(2) });
+        criteria = {};
+        criteria.asset_id = "btc";
+        criteria.max_satoshi = 1000;
+        GDK_RUNTIME_ASSERT(search(c, criteria) == std::vector<std::string>{ get_txhash(1) });
+    }
+
+    {
+        // Load a cache upgraded from before TxAsset and TxAddress existed,
+        // so that they were created after ScriptPubKey
+        auto upgraded_schema = SCHEMA;
+        std::rotate(upgraded_schema.begin() + 6, upgraded_schema.end() - 1, upgraded_schema.end());
+        fs::remove_all(DATA_DIR);
+        fs::create_directories(DATA_DIR);
+        const auto upgraded_key = get_random_bytes<32>();
+        write_legacy_cache(net_params, upgraded_key, wo_signer, upgraded_schema, 5, { 1 });
+        cache c(net_params, "testnet");
+        c.load_db(upgraded_key, wo_signer);
+        GDK_RUNTIME_ASSERT(get_spv_status(c, 1) == 3);
+        // Searches must find txs inserted through the cache's own statements
+        c.insert_transaction(0, 1000 + 3, get_txhash(3), make_tx_json(3));
+        cache::transaction_search criteria;
+        criteria.address = "address_3";
+        GDK_RUNTIME_ASSERT(search(c, criteria) == std::vector<std::string>{ get_txhash(3) });
+        criteria = {};
+        criteria.asset_id = "btc";
+        criteria.min_satoshi = 3000;
+        GDK_RUNTIME_ASSERT(search(c, criteria) == std::vector<std::string>{ get_txhash(3) });
+    }
+
+    fs::remove_all(DATA_DIR);
+    return 0;
+}
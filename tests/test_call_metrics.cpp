@@ -0,0 +1,50 @@
+#include <stdexcept>
+
+#include "src/assertion.hpp"
+#include "src/call_metrics.hpp"
+
+using namespace ga::sdk;
+
+// Verify call metrics and latency percentiles
+
+int main()
+{
+    using std::chrono::microseconds;
+
+    call_metrics metrics;
+    GDK_RUNTIME_ASSERT(metrics.get_json().empty());
+
+    // 98 fast calls, one slow call and one failed slow call
+    for (size_t i = 0; i < 98; ++i) {
+        metrics.record("fast", microseconds(3), false);
+    }
+    metrics.record("fast", microseconds(1000), false);
+    metrics.record("fast", microseconds(5000), true);
+    metrics.record("slow", microseconds(0), false);
+
+    const auto json = metrics.get_json();
+    const auto& fast = json.at("fast");
+    GDK_RUNTIME_ASSERT(fast.at("calls") == 100);
+    GDK_RUNTIME_ASSERT(fast.at("errors") == 1);
+    GDK_RUNTIME_ASSERT(fast.at("max_us") == 5000);
+    GDK_RUNTIME_ASSERT(fast.at("mean_us") == (98 * 3 + 1000 + 5000) / 100);
+    // Percentiles are reported as the upper bound of their bucket
+    GDK_RUNTIME_ASSERT(fast.at("p50_us") == 4);
+    GDK_RUNTIME_ASSERT(fast.at("p99_us") == 1024);
+    GDK_RUNTIME_ASSERT(json.at("slow").at("p99_us") == 0);
+
+    // Timers record exceptions as errors
+    try {
+        call_metrics::timer timer(metrics, "timed");
+        throw std::runtime_error("failed");
+    } catch (const std::exception&) {
+    }
+    {
+        call_metrics::timer timer(metrics, "timed");
+    }
+    const auto timed = metrics.get_json().at("timed");
+    GDK_RUNTIME_ASSERT(timed.at("calls") == 2);
+    GDK_RUNTIME_ASSERT(timed.at("errors") == 1);
+
+    return 0;
+}
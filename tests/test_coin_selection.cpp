@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <vector>
+
+#include "src/assertion.hpp"
+#include "src/coin_selection.hpp"
+
+using namespace ga::sdk;
+
+// Verify coin selection strategies
+
+static std::vector<coin_selection_utxo> make_utxos(const std::vector<amount::value_type>& values, uint32_t weight)
+{
+    std::vector<coin_selection_utxo> utxos;
+    for (const auto v : values) {
+        utxos.push_back({ v, weight });
+    }
+    return utxos;
+}
+
+static std::vector<amount::value_type> selected_values(
+    const std::vector<coin_selection_utxo>& utxos, const std::vector<size_t>& selected)
+{
+    std::vector<amount::value_type> values;
+    for (const auto i : selected) {
+        values.push_back(utxos.at(i).satoshi);
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+int main()
+{
+    using values_t = std::vector<amount::value_type>;
+
+    // Branch and Bound
+    {
+        const auto utxos = make_utxos({ 1000, 2000, 5000, 10000 }, 0);
+        // Exact match
+        GDK_RUNTIME_ASSERT(selected_values(utxos, select_coins_bnb(utxos, 7000, 0, 0)) == values_t({ 2000, 5000 }));
+        GDK_RUNTIME_ASSERT(selected_values(utxos, select_coins_bnb(utxos, 18000, 0, 0))
+            == values_t({ 1000, 2000, 5000, 10000 }));
+        // Match within the cost of change
+        GDK_RUNTIME_ASSERT(selected_values(utxos, select_coins_bnb(utxos, 7900, 200, 0)) == values_t({ 1000, 2000, 5000 }));
+        // No changeless solution
+        GDK_RUNTIME_ASSERT(select_coins_bnb(utxos, 7500, 100, 0).empty());
+        // Insufficient funds
+        GDK_RUNTIME_ASSERT(select_coins_bnb(utxos, 18001, 1000, 0).empty());
+    }
+    {
+        // Each input costs 100 satoshi at 1000 satoshi/kb
+        const auto utxos = make_utxos({ 1100, 2100, 90 }, 400);
+        GDK_RUNTIME_ASSERT(selected_values(utxos, select_coins_bnb(utxos, 3000, 0, 1000)) == values_t({ 1100, 2100 }));
+        // UTXOs that cost more than they are worth are never selected
+        GDK_RUNTIME_ASSERT(select_coins_bnb(utxos, 3001, 1000, 1000).empty());
+    }
+
+    // Knapsack
+    {
+        const auto utxos = make_utxos({ 1000, 2000, 5000, 10000 }, 0);
+        // Exact single match
+        GDK_RUNTIME_ASSERT(selected_values(utxos, select_coins_knapsack(utxos, 5000, 0)) == values_t({ 5000 }));
+        // All smaller UTXOs are an exact match
+        GDK_RUNTIME_ASSERT(selected_values(utxos, select_coins_knapsack(utxos, 8000, 0)) == values_t({ 1000, 2000, 5000 }));
+        // Smaller UTXOs are insufficient, use the smallest larger one
+        GDK_RUNTIME_ASSERT(selected_values(utxos, select_coins_knapsack(utxos, 9000, 0)) == values_t({ 10000 }));
+        // Best subset of the smaller UTXOs
+        GDK_RUNTIME_ASSERT(selected_values(utxos, select_coins_knapsack(utxos, 2500, 0)) == values_t({ 1000, 2000 }));
+        // Insufficient funds
+        GDK_RUNTIME_ASSERT(select_coins_knapsack(utxos, 18001, 0).empty());
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "src/assertion.hpp"
+#include "src/ga_wally.hpp"
+#include "src/utils.hpp"
+
+using namespace ga::sdk;
+
+// Verify hex encoding/decoding against libwally for all lengths and alignments
+
+static bool h2b_fails(const std::string& hex)
+{
+    try {
+        h2b(hex);
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    unsigned char buff[256 + 16];
+    get_random_bytes(sizeof(buff), buff, sizeof(buff));
+
+    for (size_t offset = 0; offset < 16; ++offset) {
+        for (size_t len = 1; len <= 256; ++len) {
+            const auto data = gsl::make_span(buff + offset, len);
+            const std::vector<unsigned char> reversed(data.rbegin(), data.rend());
+
+            char* wally_hex;
+            GDK_VERIFY(wally_hex_from_bytes(data.data(), data.size(), &wally_hex));
+            const std::string expected = wally_hex;
+            wally_free_string(wally_hex);
+
+            const auto hex = b2h(data);
+            GDK_RUNTIME_ASSERT(hex == expected);
+            GDK_RUNTIME_ASSERT(b2h_rev(reversed) == expected);
+
+            std::vector<char> out(len * 2);
+            b2h(data, out);
+            GDK_RUNTIME_ASSERT(std::string(out.begin(), out.end()) == expected);
+            b2h_rev(reversed, out);
+            GDK_RUNTIME_ASSERT(std::string(out.begin(), out.end()) == expected);
+
+            // Decoding is case insensitive
+            std::string upper = hex;
+            std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+            for (const auto& h : { hex, upper }) {
+                const auto decoded = h2b(h);
+                GDK_RUNTIME_ASSERT(decoded.size() == len && std::equal(decoded.begin(), decoded.end(), data.begin()));
+                GDK_RUNTIME_ASSERT(h2b_rev(h) == reversed);
+                std::vector<unsigned char> decoded_out(len);
+                h2b(h, decoded_out);
+                GDK_RUNTIME_ASSERT(decoded_out == decoded);
+                h2b_rev(h, decoded_out);
+                GDK_RUNTIME_ASSERT(decoded_out == reversed);
+            }
+
+            // An invalid character anywhere is rejected
+            for (const char bad : { 'g', 'G', ' ', '/', ':', '@', '`', '\0', '\xff' }) {
+                std::string invalid = hex;
+                invalid[(len * 7) % invalid.size()] = bad;
+                GDK_RUNTIME_ASSERT(h2b_fails(invalid));
+            }
+            GDK_RUNTIME_ASSERT(h2b_fails(hex.substr(1)));
+        }
+    }
+    GDK_RUNTIME_ASSERT(b2h(byte_span_t()).empty());
+    GDK_RUNTIME_ASSERT(h2b_fails(std::string()));
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include "include/gdk.h"
 #include "src/assertion.hpp"
+#include "src/containers.hpp"
 #include "src/utils.hpp"
 #include <nlohmann/json.hpp>
 #include <string.h>
@@ -9,6 +10,15 @@ static const char* SAMPLE_JSON = "{"
                                  "    \"string_key\": \"string value\""
                                  "}";
 
+static const char* PATH_JSON = "{"
+                               "    \"string_key\": \"string value\","
+                               "    \"items\": ["
+                               "        { \"satoshi\": { \"a\": 1 } },"
+                               "        { \"satoshi\": { \"a\": 2, \"b/c\": 3 } },"
+                               "        { \"satoshi\": {} }"
+                               "    ]"
+                               "}";
+
 int main()
 {
     GA_json* json = NULL;
@@ -28,6 +38,45 @@ int main()
 
     GDK_RUNTIME_ASSERT(GA_destroy_json(json) == GA_OK);
 
+    // Pre-parsed paths
+    GDK_RUNTIME_ASSERT(GA_convert_string_to_json(PATH_JSON, &json) == GA_OK);
+    struct GA_json_path* path = nullptr;
+    uint64_t u64_out = 0;
+
+    GDK_RUNTIME_ASSERT(GA_create_json_path("string_key", &path) == GA_OK);
+    str_out = nullptr;
+    GDK_RUNTIME_ASSERT(GA_convert_json_path_value_to_string(json, path, &str_out) == GA_OK);
+    GDK_RUNTIME_ASSERT(str_out && !strcmp(str_out, "string value"));
+    GA_destroy_string(str_out);
+    GDK_RUNTIME_ASSERT(GA_destroy_json_path(path) == GA_OK);
+
+    GDK_RUNTIME_ASSERT(GA_create_json_path("/items/1/satoshi/b~1c", &path) == GA_OK);
+    GDK_RUNTIME_ASSERT(GA_convert_json_path_value_to_uint64(json, path, &u64_out) == GA_OK);
+    GDK_RUNTIME_ASSERT(u64_out == 3);
+    GDK_RUNTIME_ASSERT(GA_destroy_json_path(path) == GA_OK);
+
+    GDK_RUNTIME_ASSERT(GA_create_json_path("/items/5/satoshi", &path) == GA_OK);
+    GDK_RUNTIME_ASSERT(GA_convert_json_path_value_to_uint64(json, path, &u64_out) == GA_OK);
+    GDK_RUNTIME_ASSERT(u64_out == 0); // Missing values return a default value
+    GDK_RUNTIME_ASSERT(GA_destroy_json_path(path) == GA_OK);
+
+    // Bulk access
+    struct GA_json_path* array_path = nullptr;
+    uint64_t u64_values[3] = { 0, 0, 0 };
+    size_t written = 0;
+    GDK_RUNTIME_ASSERT(GA_create_json_path("items", &array_path) == GA_OK);
+    GDK_RUNTIME_ASSERT(GA_create_json_path("/satoshi/a", &path) == GA_OK);
+    GDK_RUNTIME_ASSERT(
+        GA_convert_json_path_values_to_uint64(json, array_path, path, u64_values, 3, &written) == GA_OK);
+    GDK_RUNTIME_ASSERT(written == 3 && u64_values[0] == 1 && u64_values[1] == 2 && u64_values[2] == 0);
+    GDK_RUNTIME_ASSERT(
+        GA_convert_json_path_values_to_uint64(json, array_path, path, u64_values, 1, &written) == GA_OK);
+    GDK_RUNTIME_ASSERT(written == 3);
+    GDK_RUNTIME_ASSERT(GA_destroy_json_path(path) == GA_OK);
+    GDK_RUNTIME_ASSERT(GA_destroy_json_path(array_path) == GA_OK);
+
+    GDK_RUNTIME_ASSERT(GA_destroy_json(json) == GA_OK);
+
     // Default-constructed JSON is both empty and null, and not an object
     GDK_RUNTIME_ASSERT(nlohmann::json().empty());
     GDK_RUNTIME_ASSERT(nlohmann::json().is_null());
@@ -95,5 +144,12 @@ int main()
     GDK_RUNTIME_ASSERT(ga::sdk::is_valid_utf8("Բարեւ աշխարհ") == true);
     GDK_RUNTIME_ASSERT(ga::sdk::is_valid_utf8("\xa0\xa1") == false);
 
+    // Memory usage estimates grow with the heap data held
+    const nlohmann::json small = { { "k", "v" } };
+    const nlohmann::json large = { { "k", std::string(1000, 'v') }, { "items", { 1, 2, 3 } } };
+    const size_t small_usage = ga::sdk::json_get_memory_usage(small);
+    GDK_RUNTIME_ASSERT(small_usage > sizeof(nlohmann::json));
+    GDK_RUNTIME_ASSERT(ga::sdk::json_get_memory_usage(large) > small_usage + 1000);
+
     return 0;
 }
@@ -0,0 +1,46 @@
+#include <chrono>
+
+#include "src/assertion.hpp"
+#include "src/network_state.hpp"
+
+using namespace ga::sdk;
+
+// Verify network state is shared per network and released when unused
+
+int main()
+{
+    using namespace std::chrono_literals;
+
+    auto mainnet = network_state::get("mainnet");
+    auto mainnet2 = network_state::get("mainnet");
+    auto testnet = network_state::get("testnet");
+    GDK_RUNTIME_ASSERT(mainnet == mainnet2);
+    GDK_RUNTIME_ASSERT(mainnet != testnet);
+    GDK_RUNTIME_ASSERT(mainnet->get_network() == "mainnet");
+
+    // Values are shared between sessions, and not between networks
+    GDK_RUNTIME_ASSERT(!mainnet->get_value("block").value);
+    const auto before = network_state::clock::now() - 1s;
+    mainnet->set("block", { { "block_height", 100 } });
+    const auto block = mainnet2->get_value("block");
+    GDK_RUNTIME_ASSERT(block.value && block.value->at("block_height") == 100);
+    GDK_RUNTIME_ASSERT(!testnet->get_value("block").value);
+
+    // Only values updated since a given time and not too old are current
+    GDK_RUNTIME_ASSERT(mainnet->get_current("block", before, 1min).value);
+    GDK_RUNTIME_ASSERT(!mainnet->get_current("block", block.updated, 1min).value);
+    GDK_RUNTIME_ASSERT(!mainnet->get_current("fees", before, 1min).value);
+
+    // Readers keep the value they were given after it is replaced
+    mainnet->set("block", { { "block_height", 101 } });
+    GDK_RUNTIME_ASSERT(block.value->at("block_height") == 100);
+    GDK_RUNTIME_ASSERT(mainnet->get_value("block").value->at("block_height") == 101);
+
+    // State is released once no sessions refer to it
+    std::weak_ptr<network_state> weak_mainnet = mainnet;
+    mainnet.reset();
+    mainnet2.reset();
+    GDK_RUNTIME_ASSERT(weak_mainnet.expired());
+    GDK_RUNTIME_ASSERT(!network_state::get("mainnet")->get_value("block").value);
+    return 0;
+}
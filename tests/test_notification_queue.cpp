@@ -0,0 +1,105 @@
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/assertion.hpp"
+#include "src/notification_queue.hpp"
+
+using namespace ga::sdk;
+
+// Verify notification queue ordering, coalescing and shutdown
+
+int main()
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool blocked = true;
+    std::vector<nlohmann::json> delivered;
+
+    {
+        notification_queue queue(
+            [&](nlohmann::json&& details) {
+                std::unique_lock<std::mutex> locker(mutex);
+                cv.wait(locker, [&] { return !blocked || details.value("event", std::string()) != "first"; });
+                delivered.emplace_back(std::move(details));
+                cv.notify_all();
+            },
+            4);
+
+        // The first notification blocks the handler while we queue more
+        queue.push({ { "event", "first" } });
+        queue.push({ { "event", "block" }, { "block", 1 } });
+        queue.push({ { "event", "transaction" }, { "transaction", 1 } });
+        queue.push({ { "event", "block" }, { "block", 2 } });
+        {
+            std::unique_lock<std::mutex> locker(mutex);
+            blocked = false;
+            cv.notify_all();
+            cv.wait(locker, [&] { return delivered.size() == 3; });
+        }
+        // Superseded block notifications are coalesced into the latest,
+        // which is ordered after notifications queued before it
+        GDK_RUNTIME_ASSERT(delivered[0]["event"] == "first");
+        GDK_RUNTIME_ASSERT(delivered[1]["event"] == "transaction");
+        GDK_RUNTIME_ASSERT(delivered[2]["block"] == 2);
+
+        // Wait for the handler to return so the metrics are final
+        for (size_t i = 0; i < 100 && queue.get_metrics()["delivered"] != 3; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        const auto metrics = queue.get_metrics();
+        GDK_RUNTIME_ASSERT(metrics["queued"] == 4);
+        GDK_RUNTIME_ASSERT(metrics["delivered"] == 3);
+        GDK_RUNTIME_ASSERT(metrics["coalesced"] == 1);
+        GDK_RUNTIME_ASSERT(metrics["depth"] == 0);
+
+        // Notifications are discarded once stopped
+        queue.stop();
+        queue.push({ { "event", "transaction" }, { "transaction", 2 } });
+        GDK_RUNTIME_ASSERT(queue.get_metrics()["dropped"] == 1);
+    }
+    GDK_RUNTIME_ASSERT(delivered.size() == 3);
+
+    // Producers that can't wait for space drop the oldest notification
+    blocked = true;
+    delivered.clear();
+    {
+        bool started = false;
+        notification_queue queue(
+            [&](nlohmann::json&& details) {
+                std::unique_lock<std::mutex> locker(mutex);
+                started = true;
+                cv.notify_all();
+                cv.wait(locker, [&] { return !blocked || details.value("event", std::string()) != "first"; });
+                delivered.emplace_back(std::move(details));
+                cv.notify_all();
+            },
+            2);
+
+        queue.push({ { "event", "first" } });
+        {
+            std::unique_lock<std::mutex> locker(mutex);
+            cv.wait(locker, [&] { return started; });
+        }
+        for (int i = 1; i <= 3; ++i) {
+            queue.push({ { "event", "transaction" }, { "transaction", i } }, false);
+        }
+        auto metrics = queue.get_metrics();
+        GDK_RUNTIME_ASSERT(metrics["depth"] == 2);
+        GDK_RUNTIME_ASSERT(metrics["dropped"] == 1);
+        GDK_RUNTIME_ASSERT(metrics["backpressure_waits"] == 0);
+        {
+            std::unique_lock<std::mutex> locker(mutex);
+            blocked = false;
+            cv.notify_all();
+            cv.wait(locker, [&] { return delivered.size() == 3; });
+        }
+        GDK_RUNTIME_ASSERT(delivered[0]["event"] == "first");
+        GDK_RUNTIME_ASSERT(delivered[1]["transaction"] == 2);
+        GDK_RUNTIME_ASSERT(delivered[2]["transaction"] == 3);
+    }
+
+    return 0;
+}
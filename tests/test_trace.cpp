@@ -0,0 +1,60 @@
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <thread>
+#include <vector>
+
+#include "src/assertion.hpp"
+#include "src/trace.hpp"
+
+using namespace ga::sdk;
+
+// Verify tracing spans are recorded and written as Chrome trace JSON
+
+int main()
+{
+    const std::string trace_file = "test_trace.json";
+
+    GDK_RUNTIME_ASSERT(!is_tracing_enabled());
+    {
+        GDK_TRACE_SPAN("ignored"); // Not recorded: tracing is not enabled
+    }
+    init_tracing(trace_file);
+    GDK_RUNTIME_ASSERT(is_tracing_enabled());
+
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_SPANS = 10000; // Overflows each thread's ring
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([] {
+            for (size_t j = 0; j < NUM_SPANS; ++j) {
+                GDK_TRACE_SPAN("inner");
+            }
+        });
+    }
+    {
+        GDK_TRACE_SPAN(std::string("dynamic"), std::chrono::steady_clock::now());
+        dump_trace(); // Concurrently with recording
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    dump_trace();
+
+    std::ifstream f(trace_file);
+    const auto trace = nlohmann::json::parse(f);
+    const auto& events = trace.at("traceEvents");
+    size_t num_inner = 0, num_dynamic = 0;
+    for (const auto& event : events) {
+        GDK_RUNTIME_ASSERT(event.at("ph") == "X");
+        GDK_RUNTIME_ASSERT(event.at("dur").get<double>() >= 0);
+        const std::string name = event.at("name");
+        GDK_RUNTIME_ASSERT(name != "ignored");
+        num_inner += name == "inner";
+        num_dynamic += name == "dynamic";
+    }
+    // Threads may reuse the rings of exited threads, so between one and
+    // NUM_THREADS rings of the most recent spans may have been written
+    GDK_RUNTIME_ASSERT(num_inner >= 8192 && num_inner <= NUM_THREADS * 8192);
+    GDK_RUNTIME_ASSERT(num_dynamic == 1);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "src/assertion.hpp"
+#include "src/traffic_capture.hpp"
+
+using namespace ga::sdk;
+
+// Verify recorded calls are replayed by name and arguments
+
+int main()
+{
+    const std::string capture_file = "test_traffic_capture.bin";
+
+    GDK_RUNTIME_ASSERT(!is_capture_recording() && !is_capture_replaying());
+    init_capture(capture_file, capture_mode::record);
+    GDK_RUNTIME_ASSERT(is_capture_recording());
+    capture_record("wamp", "login", "args1", "first");
+    capture_record("wamp", "login", "args2", "second");
+    capture_record("wamp", "get_tx", std::string("a\0b", 3), std::string("tx\0data", 7));
+    capture_record("http", "get_tx", "args1", "http");
+
+    init_capture(capture_file, capture_mode::replay);
+    GDK_RUNTIME_ASSERT(is_capture_replaying());
+    // Matched by arguments, out of recorded order
+    GDK_RUNTIME_ASSERT(capture_replay("wamp", "login", "args2") == "second");
+    // Unrecorded arguments get the next unused result for the name
+    GDK_RUNTIME_ASSERT(capture_replay("wamp", "login", "random") == "first");
+    // Once all are used, the last result for the arguments is repeated
+    GDK_RUNTIME_ASSERT(capture_replay("wamp", "login", "args1") == "first");
+    GDK_RUNTIME_ASSERT(capture_replay("wamp", "login", "random") == "second");
+    // Binary keys and results, and kinds are distinct
+    GDK_RUNTIME_ASSERT(capture_replay("wamp", "get_tx", std::string("a\0b", 3)) == std::string("tx\0data", 7));
+    GDK_RUNTIME_ASSERT(capture_replay("http", "get_tx", "args1") == "http");
+    bool threw = false;
+    try {
+        capture_replay("http", "login", "args1");
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    GDK_RUNTIME_ASSERT(threw);
+
+    // Injected latency is measured from the start of the call
+    constexpr uint32_t latency_ms = 50;
+    init_capture(capture_file, capture_mode::replay, latency_ms);
+    const auto start = std::chrono::steady_clock::now();
+    capture_replay("http", "get_tx", "args1", start);
+    GDK_RUNTIME_ASSERT(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(latency_ms));
+
+    init_capture(capture_file, capture_mode::none);
+    GDK_RUNTIME_ASSERT(!is_capture_recording() && !is_capture_replaying());
+    std::remove(capture_file.c_str());
+    return 0;
+}
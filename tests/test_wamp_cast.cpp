@@ -0,0 +1,67 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "src/assertion.hpp"
+#include "src/wamp_transport.hpp"
+
+using namespace ga::sdk;
+
+// Verify that WAMP results decode to the same json as nlohmann::json::from_msgpack
+
+static nlohmann::json decode(const std::vector<uint8_t>& packed)
+{
+    const auto handle = msgpack::unpack(reinterpret_cast<const char*>(packed.data()), packed.size());
+    return wamp_cast_json(handle.get());
+}
+
+static bool decode_fails(const std::vector<uint8_t>& packed)
+{
+    try {
+        decode(packed);
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+static void check(const nlohmann::json& value)
+{
+    const auto packed = nlohmann::json::to_msgpack(value);
+    const auto decoded = decode(packed);
+    GDK_RUNTIME_ASSERT(decoded == nlohmann::json::from_msgpack(packed));
+    GDK_RUNTIME_ASSERT(nlohmann::json::to_msgpack(decoded) == packed);
+}
+
+int main()
+{
+    for (const auto& value : { nlohmann::json(), nlohmann::json(true), nlohmann::json(false), nlohmann::json(0),
+             nlohmann::json(127), nlohmann::json(-1), nlohmann::json(-33), nlohmann::json(UINT64_MAX),
+             nlohmann::json(INT64_MIN), nlohmann::json(1.5), nlohmann::json(""), nlohmann::json(std::string(300, 'x')),
+             nlohmann::json::array(), nlohmann::json::object() }) {
+        check(value);
+    }
+
+    const std::vector<uint8_t> bytes{ 0, 1, 2, 0xff };
+    check(nlohmann::json::binary(bytes));
+    check(nlohmann::json::binary(bytes, 7));
+
+    // A page of transactions, shaped like those the server returns
+    nlohmann::json txs = nlohmann::json::array();
+    for (size_t i = 0; i < 30; ++i) {
+        nlohmann::json output = { { "address", "2N" + std::to_string(i) }, { "is_relevant", i % 2 == 0 },
+            { "satoshi", 10000 + i }, { "pt_idx", i }, { "script_type", 14 }, { "subaccount", nullptr } };
+        txs.push_back({ { "block_height", 100000 + i }, { "fee", 226 }, { "fee_rate", 1000.5 },
+            { "inputs", { output } }, { "outputs", { output, output } }, { "memo", "" },
+            { "txhash", std::string(64, 'a') }, { "data", nlohmann::json::binary(bytes) } });
+    }
+    check({ { "list", txs }, { "more", false }, { "cur_block", 100030 } });
+
+    // Float32 values decode as doubles
+    const std::vector<uint8_t> float32{ 0xca, 0x3f, 0xc0, 0x00, 0x00 };
+    GDK_RUNTIME_ASSERT(decode(float32) == nlohmann::json(1.5));
+
+    // Map keys must be strings
+    GDK_RUNTIME_ASSERT(decode_fails({ 0x81, 0x01, 0x02 }));
+    return 0;
+}